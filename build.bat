@@ -1,43 +1,60 @@
-@echo off
-
-where /q cl || (
-  echo ERROR: could not find "cl" - run the "build.bat" from the MSVC x64 native tools command prompt.
-  exit /b 1
-)
-
-set warnings=/WX /W4 /wd4201 /wd4100 /wd4189 /wd4505 /wd4101 /wd4324 /wd4244
-set includes=/I ../my_lib/ /I ../external/raylib/
-set linkerFlags=/OUT:Main.exe /INCREMENTAL /CGTHREADS:6 /STACK:0x100000,0x100000 
-set linkerLibs=winmm.lib user32.lib shell32.lib gdi32.lib opengl32.lib
-set compilerFlags=/std:c++20 /MP /arch:AVX2 /Oi /Ob3 /EHsc /fp:fast /fp:except- /nologo /GS- /Gs999999 /GR- /FC /Z7 
-
-if "%~1"=="-Debug" (
-	echo [[ debug build ]]
-	set compilerFlags=%compilerFlags% /Od /MTd /D_DEBUG
-	set rayname=d_raylib
-)
-if "%~1"=="" (
-	echo [[ debug build ]]
-	set compilerFlags=%compilerFlags% /Od /MTd /D_DEBUG
-	set rayname=d_raylib
-)
-if "%~1"=="-Release" (
-	echo [[ release build ]]
-	set compilerFlags=%compilerFlags% /O2 /MT 
-	set rayname=raylib
-)
-
-IF NOT EXIST .\build mkdir .\build
-pushd .\build
-del *.pdb > NUL 2> NUL
-
-IF NOT EXIST %rayname%.lib (
-echo building raylib
-REM Had to go to platforms directory and change path for GLFW include headers
-cl.exe /w /c /D PLATFORM_DESKTOP /D GRAPHICS_API_OPENGL_33 %compilerFlags% ../external/raylib/*.c
-lib /OUT:%rayname%.lib rcore.obj raudio.obj rglfw.obj rmodels.obj rshapes.obj rtext.obj rtextures.obj utils.obj
-del /Q *.obj
-)
-
-cl.exe %compilerFlags% %warnings% %includes% ../source/Main.cpp /link %linkerFlags% %rayname%.lib %linkerLibs%
-popd
\ No newline at end of file
+@echo off
+
+where /q cl || (
+  echo ERROR: could not find "cl" - run the "build.bat" from the MSVC x64 native tools command prompt.
+  exit /b 1
+)
+
+set warnings=/WX /W4 /wd4201 /wd4100 /wd4189 /wd4505 /wd4101 /wd4324 /wd4244
+set includes=/I ../my_lib/ /I ../external/raylib/
+set linkerFlags=/INCREMENTAL /CGTHREADS:6 /STACK:0x100000,0x100000 
+set linkerLibs=winmm.lib user32.lib shell32.lib gdi32.lib opengl32.lib ws2_32.lib
+set compilerFlags=/std:c++20 /MP /arch:AVX2 /Oi /Ob3 /EHsc /fp:fast /fp:except- /nologo /GS- /Gs999999 /GR- /FC /Z7 
+
+if "%~1"=="-Debug" (
+	echo [[ debug build ]]
+	set compilerFlags=%compilerFlags% /Od /MTd /D_DEBUG
+	set rayname=d_raylib
+)
+if "%~1"=="" (
+	echo [[ debug build ]]
+	set compilerFlags=%compilerFlags% /Od /MTd /D_DEBUG
+	set rayname=d_raylib
+)
+if "%~1"=="-Release" (
+	echo [[ release build ]]
+	set compilerFlags=%compilerFlags% /O2 /MT 
+	set rayname=raylib
+)
+REM "-GL43" after the build type builds raylib (as its own library) and the game for OpenGL 4.3,
+REM which turns on rlgl's compute shaders and storage buffers for Main.exe --gpu-swarm (gpu_swarm.h)
+set glapi=GRAPHICS_API_OPENGL_33
+if "%~2"=="-GL43" (
+	echo [[ OpenGL 4.3 ]]
+	set glapi=GRAPHICS_API_OPENGL_43
+	set rayname=gl43_%rayname%
+)
+set compilerFlags=%compilerFlags% /D %glapi%
+
+IF NOT EXIST .\build mkdir .\build
+pushd .\build
+del *.pdb > NUL 2> NUL
+
+IF NOT EXIST %rayname%.lib (
+echo building raylib
+REM Had to go to platforms directory and change path for GLFW include headers
+cl.exe /w /c /D PLATFORM_DESKTOP %compilerFlags% ../external/raylib/*.c
+lib /OUT:%rayname%.lib rcore.obj raudio.obj rglfw.obj rmodels.obj rshapes.obj rtext.obj rtextures.obj utils.obj
+del /Q *.obj
+)
+
+REM telemetry_socket.cpp holds the OS socket code raylib.h can't be compiled next to (telemetry.h)
+cl.exe %compilerFlags% %warnings% %includes% ../source/Main.cpp ../source/telemetry_socket.cpp /link /OUT:Main.exe %linkerFlags% %rayname%.lib %linkerLibs%
+REM Headless simulation benchmark, shares Main.cpp through an include
+cl.exe %compilerFlags% %warnings% %includes% ../source/bench.cpp ../source/telemetry_socket.cpp /link /OUT:Bench.exe %linkerFlags% %rayname%.lib %linkerLibs%
+REM Per-kernel micro-benchmarks in ns/entity (see microbench.cpp), also built on Main.cpp
+cl.exe %compilerFlags% %warnings% %includes% ../source/microbench.cpp ../source/telemetry_socket.cpp /link /OUT:MicroBench.exe %linkerFlags% %rayname%.lib %linkerLibs%
+REM Packs ../resources into resources.pak, which Main.exe mounts at start (--loose skips it)
+cl.exe %compilerFlags% %warnings% %includes% ../source/pack.cpp /link /OUT:Pack.exe %linkerFlags% %rayname%.lib %linkerLibs%
+Pack.exe ../resources resources.pak
+popd
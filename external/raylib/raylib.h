@@ -80,6 +80,7 @@
 #define RAYLIB_H
 
 #include <stdarg.h>     // Required for: va_list - Only used by TraceLogCallback
+#include <stddef.h>     // Required for: size_t - Only used by memory callbacks
 
 #define RAYLIB_VERSION_MAJOR 5
 #define RAYLIB_VERSION_MINOR 0
@@ -118,17 +119,19 @@
 
 // Allow custom memory allocators
 // NOTE: Require recompiling raylib sources
+// NOTE: By default they go through the callbacks set with SetMemoryCallbacks(),
+// standard malloc()/calloc()/realloc()/free() while none are set
 #ifndef RL_MALLOC
-    #define RL_MALLOC(sz)       malloc(sz)
+    #define RL_MALLOC(sz)       MemHookMalloc(sz)
 #endif
 #ifndef RL_CALLOC
-    #define RL_CALLOC(n,sz)     calloc(n,sz)
+    #define RL_CALLOC(n,sz)     MemHookCalloc(n,sz)
 #endif
 #ifndef RL_REALLOC
-    #define RL_REALLOC(ptr,sz)  realloc(ptr,sz)
+    #define RL_REALLOC(ptr,sz)  MemHookRealloc(ptr,sz)
 #endif
 #ifndef RL_FREE
-    #define RL_FREE(ptr)        free(ptr)
+    #define RL_FREE(ptr)        MemHookFree(ptr)
 #endif
 
 // NOTE: MSVC C++ compiler does not support compound literals (C99 feature)
@@ -936,6 +939,9 @@ typedef unsigned char *(*LoadFileDataCallback)(const char *fileName, int *dataSi
 typedef bool (*SaveFileDataCallback)(const char *fileName, void *data, int dataSize);   // FileIO: Save binary data
 typedef char *(*LoadFileTextCallback)(const char *fileName);            // FileIO: Load text data
 typedef bool (*SaveFileTextCallback)(const char *fileName, char *text); // FileIO: Save text data
+typedef void *(*MemAllocCallback)(size_t size);                         // Memory: Allocate size bytes
+typedef void *(*MemReallocCallback)(void *ptr, size_t size);            // Memory: Resize an allocation
+typedef void (*MemFreeCallback)(void *ptr);                             // Memory: Free an allocation
 
 //------------------------------------------------------------------------------------
 // Global Variables Definition
@@ -1093,10 +1099,19 @@ RLAPI void SetLoadFileDataCallback(LoadFileDataCallback callback); // Set custom
 RLAPI void SetSaveFileDataCallback(SaveFileDataCallback callback); // Set custom file binary data saver
 RLAPI void SetLoadFileTextCallback(LoadFileTextCallback callback); // Set custom file text data loader
 RLAPI void SetSaveFileTextCallback(SaveFileTextCallback callback); // Set custom file text data saver
+RLAPI void SetMemoryCallbacks(MemAllocCallback allocCallback, MemReallocCallback reallocCallback, MemFreeCallback freeCallback); // Set custom memory allocator, before any allocation
+
+// Memory allocation through the callbacks above (RL_MALLOC, RL_CALLOC, RL_REALLOC, RL_FREE)
+RLAPI void *MemHookMalloc(size_t size);
+RLAPI void *MemHookCalloc(size_t count, size_t size);
+RLAPI void *MemHookRealloc(void *ptr, size_t size);
+RLAPI void MemHookFree(void *ptr);
 
 // Files management functions
 RLAPI unsigned char *LoadFileData(const char *fileName, int *dataSize); // Load file data as byte array (read)
 RLAPI void UnloadFileData(unsigned char *data);                   // Unload file data allocated by LoadFileData()
+RLAPI unsigned char *MapFileData(const char *fileName, int *dataSize); // Map file data from disk as byte array (read, private pages), NULL if it can't be mapped
+RLAPI void UnmapFileData(unsigned char *data, int dataSize);      // Unmap file data mapped by MapFileData()
 RLAPI bool SaveFileData(const char *fileName, void *data, int dataSize); // Save data to file from byte array (write), returns true on success
 RLAPI bool ExportDataAsCode(const unsigned char *data, int dataSize, const char *fileName); // Export data to code (.h), returns true on success
 RLAPI char *LoadFileText(const char *fileName);                   // Load text data from file (read), returns a '\0' terminated string
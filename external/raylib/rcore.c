@@ -47,6 +47,9 @@
 *       #define SUPPORT_GIF_RECORDING
 *           Allow automatic gif recording of current screen pressing CTRL+F12, defined in KeyCallback()
 *
+*       #define SUPPORT_GIF_ENCODER
+*           Compile the msf_gif encoder (msf_gif_begin/frame/end) without the recorder, for the application to use
+*
 *       #define SUPPORT_COMPRESSION_API
 *           Support CompressData() and DecompressData() functions, those functions use zlib implementation
 *           provided by stb_image and stb_image_write libraries, so, those libraries must be enabled on textures module
@@ -113,7 +116,7 @@
     #include "rcamera.h"             // Camera system functionality
 #endif
 
-#if defined(SUPPORT_GIF_RECORDING)
+#if defined(SUPPORT_GIF_RECORDING) || defined(SUPPORT_GIF_ENCODER)
     #define MSF_GIF_MALLOC(contextPointer, newSize) RL_MALLOC(newSize)
     #define MSF_GIF_REALLOC(contextPointer, oldMemory, oldSize, newSize) RL_REALLOC(oldMemory, newSize)
     #define MSF_GIF_FREE(contextPointer, oldMemory, oldSize) RL_FREE(oldMemory)
@@ -336,6 +339,7 @@ typedef struct CoreData {
         double draw;                        // Time measure for frame draw
         double frame;                       // Time measure for one frame
         double target;                      // Desired time for one frame, if 0 not applied
+        double deadline;                    // End of the current frame period (SUPPORT_PRECISE_SLEEP_WAIT)
         unsigned long long int base;        // Base time measure for hi-res timer (PLATFORM_ANDROID, PLATFORM_DRM)
         unsigned int frameCounter;          // Frame counter
 
@@ -349,7 +353,7 @@ RLAPI const char *raylib_version = RAYLIB_VERSION;  // raylib version exported s
 
 CoreData CORE = { 0 };               // Global CORE state context
 
-#if defined(SUPPORT_SCREEN_CAPTURE)
+#if defined(SUPPORT_SCREEN_CAPTURE) || defined(SUPPORT_AUTOMATION_EVENTS)
 static int screenshotCounter = 0;    // Screenshots counter
 #endif
 
@@ -474,6 +478,16 @@ static void RecordAutomationEvent(void); // Record frame events (to internal eve
 #if defined(_WIN32)
 // NOTE: We declare Sleep() function symbol to avoid including windows.h (kernel32.lib linkage required)
 void __stdcall Sleep(unsigned long msTimeout);              // Required for: WaitTime()
+#if defined(SUPPORT_PRECISE_SLEEP_WAIT)
+// NOTE: Waitable timer symbols, declared for the same reason (kernel32.lib)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION   0x00000002
+#define TIMER_ALL_ACCESS                        0x001F0003
+__declspec(dllimport) void *__stdcall CreateWaitableTimerExW(void *lpTimerAttributes, const void *lpTimerName, unsigned long dwFlags, unsigned long dwDesiredAccess);
+__declspec(dllimport) int __stdcall SetWaitableTimer(void *hTimer, const long long *lpDueTime, long lPeriod, void *pfnCompletionRoutine, void *lpArgToCompletionRoutine, int fResume);
+__declspec(dllimport) unsigned long __stdcall WaitForSingleObject(void *hHandle, unsigned long dwMilliseconds);
+#endif
+#elif defined(SUPPORT_PRECISE_SLEEP_WAIT) && (defined(__linux__) || defined(__FreeBSD__))
+    #include <errno.h>              // Required for: EINTR [Used in WaitTime()]
 #endif
 
 #if !defined(SUPPORT_MODULE_RTEXT)
@@ -869,6 +883,8 @@ void EndDrawing(void)
     if (automationEventRecording) RecordAutomationEvent();    // Event recording
 #endif
 
+    rlResetFrameStats();                // Everything of this frame is drawn: its counters become rlGetFrameStats()
+
 #if !defined(SUPPORT_CUSTOM_FRAME_CONTROL)
     SwapScreenBuffer();                  // Copy back buffer to front buffer (screen)
 
@@ -879,10 +895,25 @@ void EndDrawing(void)
 
     CORE.Time.frame = CORE.Time.update + CORE.Time.draw;
 
+#if defined(SUPPORT_PRECISE_SLEEP_WAIT)
+    // Wait until a deadline that advances by whole frame periods, so oversleeping one frame
+    // shortens the next wait instead of slowing the frame rate: the average holds the target
+    // exactly. After falling more than a frame behind (a hitch), the deadline restarts from now
+    if (CORE.Time.target > 0.0)
+    {
+        CORE.Time.deadline += CORE.Time.target;
+        if (CORE.Time.deadline < CORE.Time.current - CORE.Time.target) CORE.Time.deadline = CORE.Time.current;
+    }
+
+    if (CORE.Time.current < CORE.Time.deadline)
+    {
+        WaitTime(CORE.Time.deadline - CORE.Time.current);
+#else
     // Wait for some milliseconds...
     if (CORE.Time.frame < CORE.Time.target)
     {
         WaitTime(CORE.Time.target - CORE.Time.frame);
+#endif
 
         CORE.Time.current = GetTime();
         double waitTime = CORE.Time.current - CORE.Time.previous;
@@ -924,6 +955,8 @@ void EndDrawing(void)
             }
         }
         else
+#elif defined(SUPPORT_GIF_ENCODER)
+        if (!IsKeyDown(KEY_LEFT_CONTROL))   // CTRL+F12 is left to the application's recorder
 #endif  // SUPPORT_GIF_RECORDING
         {
             TakeScreenshot(TextFormat("screenshot%03i.png", screenshotCounter));
@@ -1563,6 +1596,7 @@ void SetTargetFPS(int fps)
 {
     if (fps < 1) CORE.Time.target = 0.0;
     else CORE.Time.target = 1.0/(double)fps;
+    CORE.Time.deadline = 0.0;       // Restarts frame pacing from the next frame
 
     TRACELOG(LOG_INFO, "TIMER: Target time per frame: %02.03f milliseconds", (float)CORE.Time.target*1000.0f);
 }
@@ -1647,10 +1681,29 @@ void WaitTime(double seconds)
     #endif
 
     // System halt functions
-    #if defined(_WIN32)
+    #if defined(_WIN32) && defined(SUPPORT_PRECISE_SLEEP_WAIT)
+        // NOTE: A high-resolution waitable timer (Windows 10 1803+) wakes within a fraction of
+        // a millisecond without timeBeginPeriod(); older systems get a timer of its granularity
+        static void *timer = NULL;
+        if (timer == NULL) timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (timer == NULL) timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+
+        long long dueTime = -(long long)(sleepSeconds*10000000.0);     // Relative, in 100 ns units
+        if ((timer != NULL) && SetWaitableTimer(timer, &dueTime, 0, NULL, NULL, 0)) WaitForSingleObject(timer, 0xFFFFFFFF);
+        else Sleep((unsigned long)(sleepSeconds*1000.0));
+    #elif defined(_WIN32)
         Sleep((unsigned long)(sleepSeconds*1000.0));
     #endif
-    #if defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__EMSCRIPTEN__)
+    #if (defined(__linux__) || defined(__FreeBSD__)) && defined(SUPPORT_PRECISE_SLEEP_WAIT)
+        // NOTE: Sleeping to an absolute time, a signal that interrupts the sleep does not stretch it
+        struct timespec deadline = { 0 };
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        long long nsec = deadline.tv_nsec + (long long)(sleepSeconds*1000000000.0);
+        deadline.tv_sec += (time_t)(nsec/1000000000LL);
+        deadline.tv_nsec = (long)(nsec%1000000000LL);
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) continue;
+    #elif defined(__linux__) || defined(__FreeBSD__) || defined(__OpenBSD__) || defined(__EMSCRIPTEN__)
         struct timespec req = { 0 };
         time_t sec = sleepSeconds;
         long nsec = (sleepSeconds - sec)*1000000000L;
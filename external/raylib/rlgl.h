@@ -355,6 +355,9 @@ typedef struct rlVertexBuffer {
 #endif
     unsigned int vaoId;         // OpenGL Vertex Array Object id
     unsigned int vboId[4];      // OpenGL Vertex Buffer Objects id (4 types of vertex data)
+#if defined(GRAPHICS_API_OPENGL_33)
+    void *fence;                // GLsync: signalled once the GPU has finished the last draw from this buffer (NULL if none pending)
+#endif
 } rlVertexBuffer;
 
 // Draw call type
@@ -365,6 +368,7 @@ typedef struct rlDrawCall {
     int mode;                   // Drawing mode: LINES, TRIANGLES, QUADS
     int vertexCount;            // Number of vertex of the draw
     int vertexAlignment;        // Number of vertex required for index alignment (LINES, TRIANGLES)
+    int layer;                  // Batch layer, texture buckets never reorder draws across layers
     //unsigned int vaoId;       // Vertex array id to be used on the draw -> Using RLGL.currentBatch->vertexBuffer.vaoId
     //unsigned int shaderId;    // Shader id to be used on the draw -> Using RLGL.currentShaderId
     unsigned int textureId;     // Texture id to be used on the draw -> Use to create new draw call if changes
@@ -373,6 +377,17 @@ typedef struct rlDrawCall {
     //Matrix modelview;         // Modelview matrix for this draw -> Using RLGL.modelview by default
 } rlDrawCall;
 
+// Frame statistics type
+// NOTE: Counts what goes through rlgl only, GL calls made around it are not seen
+typedef struct rlFrameStats {
+    int batchFlushes;           // Render batch draws with vertices to draw
+    int batchFlushVertices;     // Vertices the batches held when they were drawn
+    int drawCalls;              // Draw calls: batch draws plus rlDrawVertexArray*(), rlLoadDrawQuad(), rlLoadDrawCube()
+    int textureBinds;           // Textures bound by batch draws and rlEnableTexture*()
+    int shaderSwitches;         // Shader programs bound by batch draws and rlEnableShader()
+    int uploadBytes;            // Bytes sent to buffers: batch vertices, vertex/index/shader buffer loads and updates
+} rlFrameStats;
+
 // rlRenderBatch type
 typedef struct rlRenderBatch {
     int bufferCount;            // Number of vertex buffers (multi-buffering support)
@@ -679,6 +694,11 @@ RLAPI void rlDrawRenderBatchActive(void);                                   // U
 RLAPI bool rlCheckRenderBatchLimit(int vCount);                             // Check internal buffer overflow for a given number of vertex
 
 RLAPI void rlSetTexture(unsigned int id);               // Set current texture for render batch and check buffers limits
+RLAPI void rlEnableTextureBuckets(void);                // Enable texture buckets: draws regrouped by texture within a batch layer
+RLAPI void rlDisableTextureBuckets(void);               // Disable texture buckets (default)
+RLAPI void rlNextBatchLayer(void);                      // Start a new batch layer, drawn over everything submitted before it
+RLAPI rlFrameStats rlGetFrameStats(void);               // Get rlgl counters of the last frame
+RLAPI void rlResetFrameStats(void);                     // End the frame's counters: they become rlGetFrameStats(), counting starts over (EndDrawing() calls it)
 
 //------------------------------------------------------------------------------------------------------------------------
 
@@ -1010,6 +1030,15 @@ typedef struct rlglData {
         int framebufferWidth;               // Current framebuffer width
         int framebufferHeight;              // Current framebuffer height
 
+        bool textureBuckets;                // Texture buckets enabled: draws regrouped by texture per batch layer
+        int batchLayer;                     // Current batch layer, reset on every batch draw
+        rlFrameStats frameStats;            // Counters of the frame being drawn
+        rlFrameStats lastFrameStats;        // Counters of the last frame, from rlResetFrameStats()
+        float *bucketVertices;              // Scratch vertex positions for the regrouping (shared by all batches)
+        float *bucketTexcoords;             // Scratch vertex texture coordinates
+        unsigned char *bucketColors;        // Scratch vertex colors
+        int bucketCapacity;                 // Scratch capacity, in vertices
+
     } State;            // Renderer state
     struct {
         bool vao;                           // VAO support (OpenGL ES2 could not support VAO extension) (GL_ARB_vertex_array_object)
@@ -1064,6 +1093,8 @@ static PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor = NULL;
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
 static void rlLoadShaderDefault(void);      // Load default shader
 static void rlUnloadShaderDefault(void);    // Unload default shader
+static int rlBucketDrawCalls(rlRenderBatch *batch, int count);  // Regroup the first draws of a batch by texture, per layer
+static bool rlBucketRenderBatch(rlRenderBatch *batch);          // Free a draw call slot by regrouping, instead of a batch draw
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 static const char *rlGetCompressedFormatName(int format); // Get compressed format official GL identifier name
 #endif  // RLGL_SHOW_GL_DETAILS_INFO
@@ -1369,11 +1400,12 @@ void rlBegin(int mode)
             }
         }
 
-        if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+        if ((RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) && !rlBucketRenderBatch(RLGL.currentBatch)) rlDrawRenderBatch(RLGL.currentBatch);
 
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode = mode;
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount = 0;
         RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = RLGL.State.defaultTextureId;
+        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].layer = RLGL.State.batchLayer;
     }
 }
 
@@ -1546,15 +1578,91 @@ void rlSetTexture(unsigned int id)
                 }
             }
 
-            if (RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) rlDrawRenderBatch(RLGL.currentBatch);
+            if ((RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) && !rlBucketRenderBatch(RLGL.currentBatch)) rlDrawRenderBatch(RLGL.currentBatch);
 
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = id;
             RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount = 0;
+            RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].layer = RLGL.State.batchLayer;
         }
 #endif
     }
 }
 
+// Enable texture buckets
+// NOTE: Draws of a batch layer are regrouped by texture (and mode) when the batch is drawn, or
+// when its draw calls run out, so interleaved textures cost one draw call per texture instead of
+// one per switch; only valid if ordering within a layer does not matter (no overlapping blended
+// primitives of different textures), use rlNextBatchLayer() where it does
+void rlEnableTextureBuckets(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.textureBuckets = true;
+#endif
+}
+
+// Disable texture buckets
+void rlDisableTextureBuckets(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.textureBuckets = false;
+#endif
+}
+
+// Start a new batch layer
+// NOTE: Draws submitted from now on are kept after all the previous ones, whatever their texture
+void rlNextBatchLayer(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.batchLayer++;
+
+    if (RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount > 0)
+    {
+        // Close current draw, aligned as rlBegin() does, and continue its mode and texture on a new one
+        int currentMode = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode;
+        unsigned int currentTexture = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId;
+        int vertexCount = RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount;
+
+        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexAlignment = (currentMode == RL_QUADS)? 0 : (4 - vertexCount%4)%4;
+
+        if (!rlCheckRenderBatchLimit(RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexAlignment))
+        {
+            RLGL.State.vertexCounter += RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexAlignment;
+            RLGL.currentBatch->drawCounter++;
+        }
+
+        if ((RLGL.currentBatch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) && !rlBucketRenderBatch(RLGL.currentBatch)) rlDrawRenderBatch(RLGL.currentBatch);
+
+        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].mode = currentMode;
+        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].textureId = currentTexture;
+        RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].vertexCount = 0;
+    }
+
+    RLGL.currentBatch->draws[RLGL.currentBatch->drawCounter - 1].layer = RLGL.State.batchLayer;
+#endif
+}
+
+// Get rlgl counters of the last frame
+rlFrameStats rlGetFrameStats(void)
+{
+    rlFrameStats stats = { 0 };
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    stats = RLGL.State.lastFrameStats;
+#endif
+
+    return stats;
+}
+
+// End the frame's counters
+// NOTE: Called by EndDrawing() once the last batch of the frame is drawn
+void rlResetFrameStats(void)
+{
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.lastFrameStats = RLGL.State.frameStats;
+    RLGL.State.frameStats = (rlFrameStats){ 0 };
+#endif
+}
+
 // Select and active a texture slot
 void rlActiveTextureSlot(int slot)
 {
@@ -1570,6 +1678,9 @@ void rlEnableTexture(unsigned int id)
     glEnable(GL_TEXTURE_2D);
 #endif
     glBindTexture(GL_TEXTURE_2D, id);
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.frameStats.textureBinds++;
+#endif
 }
 
 // Disable texture
@@ -1586,6 +1697,7 @@ void rlEnableTextureCubemap(unsigned int id)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glBindTexture(GL_TEXTURE_CUBE_MAP, id);
+    RLGL.State.frameStats.textureBinds++;
 #endif
 }
 
@@ -1694,6 +1806,7 @@ void rlEnableShader(unsigned int id)
 {
 #if (defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2))
     glUseProgram(id);
+    RLGL.State.frameStats.shaderSwitches++;
 #endif
 }
 
@@ -2183,6 +2296,12 @@ void rlglClose(void)
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     rlUnloadRenderBatch(RLGL.defaultBatch);
 
+    // Unload texture buckets scratch arrays
+    RL_FREE(RLGL.State.bucketVertices);
+    RL_FREE(RLGL.State.bucketTexcoords);
+    RL_FREE(RLGL.State.bucketColors);
+    RLGL.State.bucketCapacity = 0;
+
     rlUnloadShaderDefault();          // Unload default shader
 
     glDeleteTextures(1, &RLGL.State.defaultTextureId); // Unload default texture
@@ -2569,6 +2688,7 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         batch.vertexBuffer[i].texcoords = (float *)RL_MALLOC(bufferElements*2*4*sizeof(float));       // 2 float by texcoord, 4 texcoord by quad
         batch.vertexBuffer[i].colors = (unsigned char *)RL_MALLOC(bufferElements*4*4*sizeof(unsigned char));   // 4 float by color, 4 colors by quad
 #if defined(GRAPHICS_API_OPENGL_33)
+        batch.vertexBuffer[i].fence = NULL;
         batch.vertexBuffer[i].indices = (unsigned int *)RL_MALLOC(bufferElements*6*sizeof(unsigned int));      // 6 int by quad (indices)
 #endif
 #if defined(GRAPHICS_API_OPENGL_ES2)
@@ -2645,6 +2765,9 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
     }
 
     TRACELOG(RL_LOG_INFO, "RLGL: Render batch vertex buffers loaded successfully in VRAM (GPU)");
+#if defined(GRAPHICS_API_OPENGL_33)
+    TRACELOG(RL_LOG_INFO, "RLGL: Render batch: %i buffer(s) x %i quads, fenced, orphaned while the GPU still reads them", numBuffers, bufferElements);
+#endif
 
     // Unbind the current VAO
     if (RLGL.ExtSupported.vao) glBindVertexArray(0);
@@ -2662,6 +2785,7 @@ rlRenderBatch rlLoadRenderBatch(int numBuffers, int bufferElements)
         //batch.draws[i].vaoId = 0;
         //batch.draws[i].shaderId = 0;
         batch.draws[i].textureId = RLGL.State.defaultTextureId;
+        batch.draws[i].layer = 0;
         //batch.draws[i].RLGL.State.projection = rlMatrixIdentity();
         //batch.draws[i].RLGL.State.modelview = rlMatrixIdentity();
     }
@@ -2706,6 +2830,10 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
         // Delete VAOs from GPU (VRAM)
         if (RLGL.ExtSupported.vao) glDeleteVertexArrays(1, &batch.vertexBuffer[i].vaoId);
 
+#if defined(GRAPHICS_API_OPENGL_33)
+        if (batch.vertexBuffer[i].fence != NULL) glDeleteSync((GLsync)batch.vertexBuffer[i].fence);
+#endif
+
         // Free vertex arrays memory from CPU (RAM)
         RL_FREE(batch.vertexBuffer[i].vertices);
         RL_FREE(batch.vertexBuffer[i].texcoords);
@@ -2724,15 +2852,51 @@ void rlUnloadRenderBatch(rlRenderBatch batch)
 void rlDrawRenderBatch(rlRenderBatch *batch)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    // Regroup draws by texture before upload, keeping at least the one draw a batch always has
+    if (RLGL.State.textureBuckets)
+    {
+        batch->drawCounter = rlBucketDrawCalls(batch, batch->drawCounter);
+        if (batch->drawCounter == 0)
+        {
+            batch->drawCounter = 1;
+            batch->draws[0].vertexCount = 0;
+        }
+    }
+
     // Update batch vertex buffers
     //------------------------------------------------------------------------------------------------------------
     // NOTE: If there is not vertex data, buffers doesn't need to be updated (vertexCount > 0)
     // TODO: If no data changed on the CPU arrays --> No need to re-update GPU arrays (use a change detector flag?)
     if (RLGL.State.vertexCounter > 0)
     {
+        RLGL.State.frameStats.batchFlushes++;
+        RLGL.State.frameStats.batchFlushVertices += RLGL.State.vertexCounter;
+        RLGL.State.frameStats.uploadBytes += RLGL.State.vertexCounter*(int)(5*sizeof(float) + 4*sizeof(unsigned char));
+
         // Activate elements VAO
         if (RLGL.ExtSupported.vao) glBindVertexArray(batch->vertexBuffer[batch->currentBuffer].vaoId);
 
+#if defined(GRAPHICS_API_OPENGL_33)
+        // Buffers are used round-robin, but a frame can flush the batch more times than there
+        // are buffers: if the GPU may still be reading this one, orphan its storage (the driver
+        // hands out a fresh one) so glBufferSubData() never has to wait for the GPU
+        rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+        if (buffer->fence != NULL)
+        {
+            if (glClientWaitSync((GLsync)buffer->fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, buffer->vboId[0]);
+                glBufferData(GL_ARRAY_BUFFER, buffer->elementCount*3*4*sizeof(float), NULL, GL_DYNAMIC_DRAW);
+                glBindBuffer(GL_ARRAY_BUFFER, buffer->vboId[1]);
+                glBufferData(GL_ARRAY_BUFFER, buffer->elementCount*2*4*sizeof(float), NULL, GL_DYNAMIC_DRAW);
+                glBindBuffer(GL_ARRAY_BUFFER, buffer->vboId[2]);
+                glBufferData(GL_ARRAY_BUFFER, buffer->elementCount*4*4*sizeof(unsigned char), NULL, GL_DYNAMIC_DRAW);
+            }
+            glDeleteSync((GLsync)buffer->fence);
+            buffer->fence = NULL;
+        }
+#endif
+
         // Vertex positions buffer
         glBindBuffer(GL_ARRAY_BUFFER, batch->vertexBuffer[batch->currentBuffer].vboId[0]);
         glBufferSubData(GL_ARRAY_BUFFER, 0, RLGL.State.vertexCounter*3*sizeof(float), batch->vertexBuffer[batch->currentBuffer].vertices);
@@ -2794,6 +2958,7 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
         {
             // Set current shader and upload current MVP matrix
             glUseProgram(RLGL.State.currentShaderId);
+            RLGL.State.frameStats.shaderSwitches++;
 
             // Create modelview-projection matrix and upload to shader
             Matrix matMVP = rlMatrixMultiply(RLGL.State.modelview, RLGL.State.projection);
@@ -2838,6 +3003,7 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
                 {
                     glActiveTexture(GL_TEXTURE0 + 1 + i);
                     glBindTexture(GL_TEXTURE_2D, RLGL.State.activeTextureId[i]);
+                    RLGL.State.frameStats.textureBinds++;
                 }
             }
 
@@ -2849,6 +3015,11 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
             {
                 // Bind current draw call texture, activated as GL_TEXTURE0 and Bound to sampler2D texture0 by default
                 glBindTexture(GL_TEXTURE_2D, batch->draws[i].textureId);
+                RLGL.State.frameStats.textureBinds++;
+                if (batch->draws[i].vertexCount > 0)
+                {
+                    RLGL.State.frameStats.drawCalls++;
+                }
 
                 if ((batch->draws[i].mode == RL_LINES) || (batch->draws[i].mode == RL_TRIANGLES)) glDrawArrays(batch->draws[i].mode, vertexOffset, batch->draws[i].vertexCount);
                 else
@@ -2883,6 +3054,11 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
 
     // Restore viewport to default measures
     if (eyeCount == 2) rlViewport(0, 0, RLGL.State.framebufferWidth, RLGL.State.framebufferHeight);
+
+#if defined(GRAPHICS_API_OPENGL_33)
+    // Mark the point after which the GPU is done with this buffer, checked on its next upload
+    if (RLGL.State.vertexCounter > 0) batch->vertexBuffer[batch->currentBuffer].fence = (void *)glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
     //------------------------------------------------------------------------------------------------------------
 
     // Reset batch buffers
@@ -2903,8 +3079,12 @@ void rlDrawRenderBatch(rlRenderBatch *batch)
         batch->draws[i].mode = RL_QUADS;
         batch->draws[i].vertexCount = 0;
         batch->draws[i].textureId = RLGL.State.defaultTextureId;
+        batch->draws[i].layer = 0;
     }
 
+    // Reset batch layers, a batch draw is a layer boundary itself
+    RLGL.State.batchLayer = 0;
+
     // Reset active texture units for next batch
     for (int i = 0; i < RL_DEFAULT_BATCH_MAX_TEXTURE_UNITS; i++) RLGL.State.activeTextureId[i] = 0;
 
@@ -3602,6 +3782,7 @@ unsigned int rlLoadVertexBuffer(const void *buffer, int size, bool dynamic)
     glGenBuffers(1, &id);
     glBindBuffer(GL_ARRAY_BUFFER, id);
     glBufferData(GL_ARRAY_BUFFER, size, buffer, dynamic? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    if (buffer != NULL) RLGL.State.frameStats.uploadBytes += size;
 #endif
 
     return id;
@@ -3616,6 +3797,7 @@ unsigned int rlLoadVertexBufferElement(const void *buffer, int size, bool dynami
     glGenBuffers(1, &id);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, buffer, dynamic? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+    if (buffer != NULL) RLGL.State.frameStats.uploadBytes += size;
 #endif
 
     return id;
@@ -3660,6 +3842,7 @@ void rlUpdateVertexBuffer(unsigned int id, const void *data, int dataSize, int o
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glBindBuffer(GL_ARRAY_BUFFER, id);
     glBufferSubData(GL_ARRAY_BUFFER, offset, dataSize, data);
+    RLGL.State.frameStats.uploadBytes += dataSize;
 #endif
 }
 
@@ -3670,6 +3853,7 @@ void rlUpdateVertexBufferElements(unsigned int id, const void *data, int dataSiz
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, id);
     glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset, dataSize, data);
+    RLGL.State.frameStats.uploadBytes += dataSize;
 #endif
 }
 
@@ -3715,6 +3899,9 @@ void rlDisableVertexAttribute(unsigned int index)
 void rlDrawVertexArray(int offset, int count)
 {
     glDrawArrays(GL_TRIANGLES, offset, count);
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.frameStats.drawCalls++;
+#endif
 }
 
 // Draw vertex array elements
@@ -3725,6 +3912,9 @@ void rlDrawVertexArrayElements(int offset, int count, const void *buffer)
     if (offset > 0) bufferPtr += offset;
 
     glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (const unsigned short *)bufferPtr);
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
+    RLGL.State.frameStats.drawCalls++;
+#endif
 }
 
 // Draw vertex array instanced
@@ -3732,6 +3922,7 @@ void rlDrawVertexArrayInstanced(int offset, int count, int instances)
 {
 #if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_ES2)
     glDrawArraysInstanced(GL_TRIANGLES, 0, count, instances);
+    RLGL.State.frameStats.drawCalls++;
 #endif
 }
 
@@ -3744,6 +3935,7 @@ void rlDrawVertexArrayElementsInstanced(int offset, int count, const void *buffe
     if (offset > 0) bufferPtr += offset;
 
     glDrawElementsInstanced(GL_TRIANGLES, count, GL_UNSIGNED_SHORT, (const unsigned short *)bufferPtr, instances);
+    RLGL.State.frameStats.drawCalls++;
 #endif
 }
 
@@ -3979,6 +4171,11 @@ unsigned int rlLoadShaderProgram(unsigned int vShaderId, unsigned int fShaderId)
 
     // NOTE: If some attrib name is no found on the shader, it locations becomes -1
 
+#if defined(GRAPHICS_API_OPENGL_33)
+    // Keep the linked program retrievable with glGetProgramBinary(), so it can be cached on disk
+    if (glProgramParameteri != NULL) glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
     glLinkProgram(program);
 
     // NOTE: All uniform variables are intitialised to 0 when a program links
@@ -4204,6 +4401,7 @@ unsigned int rlLoadShaderBuffer(unsigned int size, const void *data, int usageHi
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssbo);
     glBufferData(GL_SHADER_STORAGE_BUFFER, size, data, usageHint? usageHint : RL_STREAM_COPY);
     if (data == NULL) glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R8UI, GL_RED_INTEGER, GL_UNSIGNED_BYTE, NULL);    // Clear buffer data to 0
+    else RLGL.State.frameStats.uploadBytes += (int)size;
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 #endif
 
@@ -4224,6 +4422,7 @@ void rlUpdateShaderBuffer(unsigned int id, const void *data, unsigned int dataSi
 #if defined(GRAPHICS_API_OPENGL_43)
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, id);
     glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, dataSize, data);
+    RLGL.State.frameStats.uploadBytes += (int)dataSize;
 #endif
 }
 
@@ -4439,6 +4638,7 @@ void rlLoadDrawQuad(void)
     // Draw quad
     glBindVertexArray(quadVAO);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    RLGL.State.frameStats.drawCalls++;
     glBindVertexArray(0);
 
     // Delete buffers (VBO and VAO)
@@ -4517,6 +4717,7 @@ void rlLoadDrawCube(void)
     // Draw cube
     glBindVertexArray(cubeVAO);
     glDrawArrays(GL_TRIANGLES, 0, 36);
+    RLGL.State.frameStats.drawCalls++;
     glBindVertexArray(0);
 
     // Delete VBO and VAO
@@ -4688,6 +4889,98 @@ static void rlUnloadShaderDefault(void)
     TRACELOG(RL_LOG_INFO, "SHADER: [ID %i] Default shader unloaded successfully", RLGL.State.defaultShaderId);
 }
 
+// Regroup the first count draws of a batch by texture (and mode) within each batch layer
+// NOTE: Every group keeps the submission order of its draws and takes the place of its first one,
+// vertex data is moved so each group is contiguous and a single draw; draws without vertex are
+// dropped. Returns the new number of draws, RLGL.State.vertexCounter is set to the end of the
+// last one, unaligned (its vertexAlignment tells how many vertex would align it)
+static int rlBucketDrawCalls(rlRenderBatch *batch, int count)
+{
+    rlVertexBuffer *buffer = &batch->vertexBuffer[batch->currentBuffer];
+    int offsets[RL_DEFAULT_BATCH_DRAWCALLS] = { 0 };
+    bool placed[RL_DEFAULT_BATCH_DRAWCALLS] = { 0 };
+    int merged = 0;
+    int vertexCounter = 0;
+
+    if (RLGL.State.bucketCapacity < buffer->elementCount*4)
+    {
+        RLGL.State.bucketCapacity = buffer->elementCount*4;
+        RLGL.State.bucketVertices = (float *)RL_REALLOC(RLGL.State.bucketVertices, RLGL.State.bucketCapacity*3*sizeof(float));
+        RLGL.State.bucketTexcoords = (float *)RL_REALLOC(RLGL.State.bucketTexcoords, RLGL.State.bucketCapacity*2*sizeof(float));
+        RLGL.State.bucketColors = (unsigned char *)RL_REALLOC(RLGL.State.bucketColors, RLGL.State.bucketCapacity*4*sizeof(unsigned char));
+    }
+
+    for (int i = 0, vertexOffset = 0; i < count; i++)
+    {
+        offsets[i] = vertexOffset;
+        placed[i] = (batch->draws[i].vertexCount == 0);
+        vertexOffset += (batch->draws[i].vertexCount + batch->draws[i].vertexAlignment);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (placed[i]) continue;
+
+        rlDrawCall group = batch->draws[i];
+        group.vertexCount = 0;
+
+        // Draws of a layer are contiguous, so the group's other members all follow its first one
+        for (int j = i; (j < count) && (batch->draws[j].layer == group.layer); j++)
+        {
+            if (placed[j] || (batch->draws[j].mode != group.mode) || (batch->draws[j].textureId != group.textureId)) continue;
+
+            int first = vertexCounter + group.vertexCount;
+            int vertexCount = batch->draws[j].vertexCount;
+            memcpy(RLGL.State.bucketVertices + first*3, buffer->vertices + offsets[j]*3, vertexCount*3*sizeof(float));
+            memcpy(RLGL.State.bucketTexcoords + first*2, buffer->texcoords + offsets[j]*2, vertexCount*2*sizeof(float));
+            memcpy(RLGL.State.bucketColors + first*4, buffer->colors + offsets[j]*4, vertexCount*4*sizeof(unsigned char));
+
+            group.vertexCount += vertexCount;
+            placed[j] = true;
+        }
+
+        // Align every group to a multiple of 4 vertex, so QUADS ones keep aligned with index processing
+        group.vertexAlignment = (4 - group.vertexCount%4)%4;
+        vertexCounter += (group.vertexCount + group.vertexAlignment);
+        batch->draws[merged] = group;   // Never ahead of i, the draws still to be read are untouched
+        merged++;
+    }
+
+    if (merged > 0) vertexCounter -= batch->draws[merged - 1].vertexAlignment;
+
+    memcpy(buffer->vertices, RLGL.State.bucketVertices, vertexCounter*3*sizeof(float));
+    memcpy(buffer->texcoords, RLGL.State.bucketTexcoords, vertexCounter*2*sizeof(float));
+    memcpy(buffer->colors, RLGL.State.bucketColors, vertexCounter*4*sizeof(unsigned char));
+    RLGL.State.vertexCounter = vertexCounter;
+
+    return merged;
+}
+
+// Free a draw call slot by regrouping the closed draws of a batch by texture, instead of drawing it
+// NOTE: Called when drawCounter reaches RL_DEFAULT_BATCH_DRAWCALLS, the last draw being the new one;
+// returns false when texture buckets are disabled or nothing could be merged, then the caller
+// draws the batch (still valid, regrouped or not)
+static bool rlBucketRenderBatch(rlRenderBatch *batch)
+{
+    if (!RLGL.State.textureBuckets) return false;
+
+    rlDrawCall next = batch->draws[batch->drawCounter - 1];
+    int merged = rlBucketDrawCalls(batch, batch->drawCounter - 1);
+    int alignment = (merged > 0)? batch->draws[merged - 1].vertexAlignment : 0;
+
+    batch->drawCounter = merged + 1;
+    batch->draws[merged] = next;
+    batch->draws[merged].vertexCount = 0;
+    batch->draws[merged].vertexAlignment = 0;
+
+    if ((batch->drawCounter >= RL_DEFAULT_BATCH_DRAWCALLS) ||
+        ((RLGL.State.vertexCounter + alignment) >= (batch->vertexBuffer[batch->currentBuffer].elementCount*4))) return false;
+
+    RLGL.State.vertexCounter += alignment;
+
+    return true;
+}
+
 #if defined(RLGL_SHOW_GL_DETAILS_INFO)
 // Get compressed format official GL identifier name
 static const char *rlGetCompressedFormatName(int format)
@@ -49,7 +49,7 @@
 
 #if defined(SUPPORT_MODULE_RMODELS)
 
-#include "utils.h"          // Required for: TRACELOG(), LoadFileData(), LoadFileText(), SaveFileText()
+#include "utils.h"          // Required for: TRACELOG(), MapOrLoadFileData(), LoadFileText(), SaveFileText()
 #include "rlgl.h"           // OpenGL abstraction layer to OpenGL 1.1, 2.1, 3.3+ or ES2
 #include "raymath.h"        // Required for: Vector3, Quaternion and Matrix functionality
 
@@ -4053,7 +4053,8 @@ static Model LoadIQM(const char *fileName)
     #define MATERIAL_NAME_LENGTH 32         // Material name string length
 
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
     unsigned char *fileDataPtr = fileData;
 
     // IQM file structs
@@ -4397,7 +4398,7 @@ static Model LoadIQM(const char *fileName)
 
     BuildPoseFromParentJoints(model.bones, model.boneCount, model.bindPose);
 
-    RL_FREE(fileData);
+    UnmapOrUnloadFileData(fileData, dataSize, mapped);
 
     RL_FREE(imesh);
     RL_FREE(tri);
@@ -4420,7 +4421,8 @@ static ModelAnimation *LoadModelAnimationsIQM(const char *fileName, int *animCou
     #define IQM_VERSION     2                   // only IQM version 2 supported
 
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
     unsigned char *fileDataPtr = fileData;
 
     typedef struct IQMHeader {
@@ -4629,7 +4631,7 @@ static ModelAnimation *LoadModelAnimationsIQM(const char *fileName, int *animCou
         }
     }
 
-    RL_FREE(fileData);
+    UnmapOrUnloadFileData(fileData, dataSize, mapped);
 
     RL_FREE(joints);
     RL_FREE(framedata);
@@ -4787,7 +4789,8 @@ static Model LoadGLTF(const char *fileName)
 
     // glTF file loading
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     if (fileData == NULL) return model;
 
@@ -5204,7 +5207,7 @@ static Model LoadGLTF(const char *fileName)
     else TRACELOG(LOG_WARNING, "MODEL: [%s] Failed to load glTF data", fileName);
 
     // WARNING: cgltf requires the file pointer available while reading data
-    UnloadFileData(fileData);
+    UnmapOrUnloadFileData(fileData, dataSize, mapped);
 
     return model;
 }
@@ -5270,7 +5273,8 @@ static ModelAnimation *LoadModelAnimationsGLTF(const char *fileName, int *animCo
 {
     // glTF file loading
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     ModelAnimation *animations = NULL;
 
@@ -5424,7 +5428,7 @@ static ModelAnimation *LoadModelAnimationsGLTF(const char *fileName, int *animCo
 
         cgltf_free(data);
     }
-    UnloadFileData(fileData);
+    UnmapOrUnloadFileData(fileData, dataSize, mapped);
     return animations;
 }
 #endif
@@ -5440,7 +5444,8 @@ static Model LoadVOX(const char *fileName)
 
     // Read vox file into buffer
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     if (fileData == 0)
     {
@@ -5455,7 +5460,7 @@ static Model LoadVOX(const char *fileName)
     if (ret != VOX_SUCCESS)
     {
         // Error
-        UnloadFileData(fileData);
+        UnmapOrUnloadFileData(fileData, dataSize, mapped);
 
         TRACELOG(LOG_WARNING, "MODEL: [%s] Failed to load VOX data", fileName);
         return model;
@@ -5527,7 +5532,7 @@ static Model LoadVOX(const char *fileName)
 
     // Free buffers
     Vox_FreeArrays(&voxarray);
-    UnloadFileData(fileData);
+    UnmapOrUnloadFileData(fileData, dataSize, mapped);
 
     return model;
 }
@@ -5548,7 +5553,8 @@ static Model LoadM3D(const char *fileName)
     int i, j, k, l, n, mi = -2, vcolor = 0;
 
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     if (fileData != NULL)
     {
@@ -5558,7 +5564,7 @@ static Model LoadM3D(const char *fileName)
         {
             TRACELOG(LOG_WARNING, "MODEL: [%s] Failed to load M3D data, error code %d", fileName, m3d? m3d->errcode : -2);
             if (m3d) m3d_free(m3d);
-            UnloadFileData(fileData);
+            UnmapOrUnloadFileData(fileData, dataSize, mapped);
             return model;
         }
         else TRACELOG(LOG_INFO, "MODEL: [%s] M3D data loaded successfully: %i faces/%i materials", fileName, m3d->numface, m3d->nummaterial);
@@ -5567,7 +5573,7 @@ static Model LoadM3D(const char *fileName)
         if (!m3d->numface)
         {
             m3d_free(m3d);
-            UnloadFileData(fileData);
+            UnmapOrUnloadFileData(fileData, dataSize, mapped);
             return model;
         }
 
@@ -5864,7 +5870,7 @@ static Model LoadM3D(const char *fileName)
         }
 
         m3d_free(m3d);
-        UnloadFileData(fileData);
+        UnmapOrUnloadFileData(fileData, dataSize, mapped);
     }
 
     return model;
@@ -5882,7 +5888,8 @@ static ModelAnimation *LoadModelAnimationsM3D(const char *fileName, int *animCou
     *animCount = 0;
 
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     if (fileData != NULL)
     {
@@ -5891,7 +5898,7 @@ static ModelAnimation *LoadModelAnimationsM3D(const char *fileName, int *animCou
         if (!m3d || M3D_ERR_ISFATAL(m3d->errcode))
         {
             TRACELOG(LOG_WARNING, "MODEL: [%s] Failed to load M3D data, error code %d", fileName, m3d? m3d->errcode : -2);
-            UnloadFileData(fileData);
+            UnmapOrUnloadFileData(fileData, dataSize, mapped);
             return NULL;
         }
         else TRACELOG(LOG_INFO, "MODEL: [%s] M3D data loaded successfully: %i animations, %i bones, %i skins", fileName,
@@ -5901,7 +5908,7 @@ static ModelAnimation *LoadModelAnimationsM3D(const char *fileName, int *animCou
         if (!m3d->numaction || !m3d->numbone || !m3d->numskin)
         {
             m3d_free(m3d);
-            UnloadFileData(fileData);
+            UnmapOrUnloadFileData(fileData, dataSize, mapped);
             return NULL;
         }
 
@@ -5974,7 +5981,7 @@ static ModelAnimation *LoadModelAnimationsM3D(const char *fileName, int *animCou
         }
 
         m3d_free(m3d);
-        UnloadFileData(fileData);
+        UnmapOrUnloadFileData(fileData, dataSize, mapped);
     }
 
     return animations;
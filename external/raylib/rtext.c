@@ -79,6 +79,9 @@
     #define STB_RECT_PACK_IMPLEMENTATION
     #include "external/stb_rect_pack.h"     // Required for: ttf font rectangles packaging
 
+    #define STBTT_malloc(x,u)  ((void)(u), RL_MALLOC(x))  // Glyph bitmaps end up in images freed with RL_FREE()
+    #define STBTT_free(x,u)    ((void)(u), RL_FREE(x))
+
     #define STBTT_STATIC
     #define STB_TRUETYPE_IMPLEMENTATION
     #include "external/stb_truetype.h"      // Required for: ttf font data reading
@@ -364,14 +367,15 @@ Font LoadFontEx(const char *fileName, int fontSize, int *codepoints, int codepoi
 
     // Loading file to memory
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     if (fileData != NULL)
     {
         // Loading font from memory data
         font = LoadFontFromMemory(GetFileExtension(fileName), fileData, dataSize, fontSize, codepoints, codepointCount);
 
-        UnloadFileData(fileData);
+        UnmapOrUnloadFileData(fileData, dataSize, mapped);
     }
     else font = GetFontDefault();
 
@@ -70,7 +70,7 @@
 
 #if defined(SUPPORT_MODULE_RTEXTURES)
 
-#include "utils.h"              // Required for: TRACELOG()
+#include "utils.h"              // Required for: TRACELOG(), MapOrLoadFileData()
 #include "rlgl.h"               // OpenGL abstraction layer to OpenGL 1.1, 3.3 or ES2
 
 #include <stdlib.h>             // Required for: malloc(), free()
@@ -280,12 +280,13 @@ Image LoadImage(const char *fileName)
 
     // Loading file to memory
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     // Loading image from memory data
     if (fileData != NULL) image = LoadImageFromMemory(GetFileExtension(fileName), fileData, dataSize);
 
-    RL_FREE(fileData);
+    UnmapOrUnloadFileData(fileData, dataSize, mapped);
 
     return image;
 }
@@ -296,7 +297,8 @@ Image LoadImageRaw(const char *fileName, int width, int height, int format, int
     Image image = { 0 };
 
     int dataSize = 0;
-    unsigned char *fileData = LoadFileData(fileName, &dataSize);
+    int mapped = 0;
+    unsigned char *fileData = MapOrLoadFileData(fileName, &dataSize, &mapped);
 
     if (fileData != NULL)
     {
@@ -312,7 +314,7 @@ Image LoadImageRaw(const char *fileName, int width, int height, int format, int
         image.mipmaps = 1;
         image.format = format;
 
-        RL_FREE(fileData);
+        UnmapOrUnloadFileData(fileData, dataSize, mapped);
     }
 
     return image;
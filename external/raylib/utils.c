@@ -44,10 +44,32 @@
     #include <android/asset_manager.h>  // Required for: Android assets manager: AAsset, AAssetManager_open(), ...
 #endif
 
-#include <stdlib.h>                     // Required for: exit()
+#include <stdlib.h>                     // Required for: exit(), malloc(), calloc(), realloc(), free()
 #include <stdio.h>                      // Required for: FILE, fopen(), fseek(), ftell(), fread(), fwrite(), fprintf(), vprintf(), fclose()
 #include <stdarg.h>                     // Required for: va_list, va_start(), va_end()
-#include <string.h>                     // Required for: strcpy(), strcat()
+#include <string.h>                     // Required for: strcpy(), strcat(), memset()
+
+// File mapping is available with standard file io on desktop systems (not Android assets or the web)
+#if defined(SUPPORT_STANDARD_FILEIO) && !defined(PLATFORM_ANDROID) && !defined(PLATFORM_WEB) && !defined(__EMSCRIPTEN__)
+    #define SUPPORT_FILE_MAPPING
+#endif
+
+#if defined(SUPPORT_FILE_MAPPING)
+    #if defined(_WIN32)
+// NOTE: We declare the few kernel32 symbols required to avoid including windows.h
+__declspec(dllimport) void *__stdcall CreateFileA(const char *lpFileName, unsigned long dwDesiredAccess, unsigned long dwShareMode, void *lpSecurityAttributes, unsigned long dwCreationDisposition, unsigned long dwFlagsAndAttributes, void *hTemplateFile);
+__declspec(dllimport) int __stdcall GetFileSizeEx(void *hFile, long long *lpFileSize);
+__declspec(dllimport) void *__stdcall CreateFileMappingA(void *hFile, void *lpFileMappingAttributes, unsigned long flProtect, unsigned long dwMaximumSizeHigh, unsigned long dwMaximumSizeLow, const char *lpName);
+__declspec(dllimport) void *__stdcall MapViewOfFile(void *hFileMappingObject, unsigned long dwDesiredAccess, unsigned long dwFileOffsetHigh, unsigned long dwFileOffsetLow, size_t dwNumberOfBytesToMap);
+__declspec(dllimport) int __stdcall UnmapViewOfFile(const void *lpBaseAddress);
+__declspec(dllimport) int __stdcall CloseHandle(void *hObject);
+    #else
+        #include <fcntl.h>              // Required for: open(), O_RDONLY
+        #include <sys/mman.h>           // Required for: mmap(), munmap()
+        #include <sys/stat.h>           // Required for: fstat()
+        #include <unistd.h>             // Required for: close()
+    #endif
+#endif
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
@@ -66,6 +88,9 @@ static LoadFileDataCallback loadFileData = NULL;    // LoadFileData callback fun
 static SaveFileDataCallback saveFileData = NULL;    // SaveFileText callback function pointer
 static LoadFileTextCallback loadFileText = NULL;    // LoadFileText callback function pointer
 static SaveFileTextCallback saveFileText = NULL;    // SaveFileText callback function pointer
+static MemAllocCallback memAlloc = NULL;            // RL_MALLOC/RL_CALLOC callback function pointer
+static MemReallocCallback memRealloc = NULL;        // RL_REALLOC callback function pointer
+static MemFreeCallback memFree = NULL;              // RL_FREE callback function pointer
 
 //----------------------------------------------------------------------------------
 // Functions to set internal callbacks
@@ -76,6 +101,16 @@ void SetSaveFileDataCallback(SaveFileDataCallback callback) { saveFileData = cal
 void SetLoadFileTextCallback(LoadFileTextCallback callback) { loadFileText = callback; }  // Set custom file text loader
 void SetSaveFileTextCallback(SaveFileTextCallback callback) { saveFileText = callback; }  // Set custom file text saver
 
+// Set custom memory allocator
+// NOTE: Memory allocated before can't be freed after, so they must be set before raylib
+// allocates anything (first thing in main()), all three or none
+void SetMemoryCallbacks(MemAllocCallback allocCallback, MemReallocCallback reallocCallback, MemFreeCallback freeCallback)
+{
+    memAlloc = allocCallback;
+    memRealloc = reallocCallback;
+    memFree = freeCallback;
+}
+
 
 #if defined(PLATFORM_ANDROID)
 static AAssetManager *assetManager = NULL;          // Android assets manager pointer
@@ -179,6 +214,38 @@ void MemFree(void *ptr)
     RL_FREE(ptr);
 }
 
+// Allocate memory, through the memory callbacks if set
+void *MemHookMalloc(size_t size)
+{
+    if (memAlloc) return memAlloc(size);
+    return malloc(size);
+}
+
+// Allocate zeroed memory, through the memory callbacks if set
+void *MemHookCalloc(size_t count, size_t size)
+{
+    if (!memAlloc) return calloc(count, size);
+    if ((size != 0) && (count > ((size_t)-1)/size)) return NULL;   // count*size overflows
+
+    void *ptr = memAlloc(count*size);
+    if (ptr != NULL) memset(ptr, 0, count*size);
+    return ptr;
+}
+
+// Resize memory, through the memory callbacks if set
+void *MemHookRealloc(void *ptr, size_t size)
+{
+    if (memRealloc) return memRealloc(ptr, size);
+    return realloc(ptr, size);
+}
+
+// Free memory, through the memory callbacks if set
+void MemHookFree(void *ptr)
+{
+    if (memFree) memFree(ptr);
+    else free(ptr);
+}
+
 // Load data from file into a buffer
 unsigned char *LoadFileData(const char *fileName, int *dataSize)
 {
@@ -251,6 +318,100 @@ void UnloadFileData(unsigned char *data)
     RL_FREE(data);
 }
 
+// Map file data into memory, backed by the system page cache instead of a copy
+// NOTE: Pages are private (copy-on-write): writes through the pointer never reach the file.
+// NOTE: It always maps the file on disk, a custom LoadFileData() callback is not used.
+// Returns NULL, without logging, if the file can't be mapped: platform without file mapping,
+// missing or empty file; LoadFileData() is the fallback then
+unsigned char *MapFileData(const char *fileName, int *dataSize)
+{
+    unsigned char *data = NULL;
+    *dataSize = 0;
+
+#if defined(SUPPORT_FILE_MAPPING)
+    if (fileName == NULL) return NULL;
+
+    #if defined(_WIN32)
+    void *file = CreateFileA(fileName, 0x80000000ul /* GENERIC_READ */, 0x1ul /* FILE_SHARE_READ */, NULL, 3ul /* OPEN_EXISTING */, 0x80ul /* FILE_ATTRIBUTE_NORMAL */, NULL);
+    if (file == (void *)(size_t)-1) return NULL;        // INVALID_HANDLE_VALUE
+
+    long long size = 0;
+    if (GetFileSizeEx(file, &size) && (size > 0) && (size <= 2147483647))
+    {
+        void *mapping = CreateFileMappingA(file, NULL, 0x08ul /* PAGE_WRITECOPY */, 0, 0, NULL);
+        if (mapping != NULL)
+        {
+            data = (unsigned char *)MapViewOfFile(mapping, 0x1ul /* FILE_MAP_COPY */, 0, 0, 0);
+            CloseHandle(mapping);       // The view keeps the mapping alive
+        }
+    }
+    CloseHandle(file);
+    #else
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return NULL;
+
+    struct stat info;
+    long long size = 0;
+    if (fstat(file, &info) == 0) size = (long long)info.st_size;
+    if ((size > 0) && (size <= 2147483647))
+    {
+        void *view = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+        if (view != MAP_FAILED) data = (unsigned char *)view;
+    }
+    close(file);                        // The mapping keeps the file alive
+    #endif
+
+    if (data != NULL)
+    {
+        *dataSize = (int)size;
+        TRACELOG(LOG_INFO, "FILEIO: [%s] File mapped successfully", fileName);
+    }
+#else
+    (void)fileName;
+#endif
+
+    return data;
+}
+
+// Unmap file data mapped by MapFileData()
+void UnmapFileData(unsigned char *data, int dataSize)
+{
+#if defined(SUPPORT_FILE_MAPPING)
+    if (data == NULL) return;
+    #if defined(_WIN32)
+    (void)dataSize;
+    UnmapViewOfFile(data);
+    #else
+    munmap(data, (size_t)dataSize);
+    #endif
+#else
+    (void)data;
+    (void)dataSize;
+#endif
+}
+
+// File data for the loaders: mapped when possible, else a LoadFileData() copy
+// NOTE: A custom LoadFileData() callback (a virtual file system) takes precedence over mapping
+unsigned char *MapOrLoadFileData(const char *fileName, int *dataSize, int *mapped)
+{
+    unsigned char *data = NULL;
+    *dataSize = 0;
+
+    if (loadFileData == NULL) data = MapFileData(fileName, dataSize);
+
+    *mapped = (data != NULL);
+    if (data == NULL) data = LoadFileData(fileName, dataSize);
+
+    return data;
+}
+
+// Release file data returned by MapOrLoadFileData()
+void UnmapOrUnloadFileData(unsigned char *data, int dataSize, int mapped)
+{
+    if (mapped) UnmapFileData(data, dataSize);
+    else UnloadFileData(data);
+}
+
 // Save data to file from buffer
 bool SaveFileData(const char *fileName, void *data, int dataSize)
 {
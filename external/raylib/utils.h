@@ -74,6 +74,10 @@ void InitAssetManager(AAssetManager *manager, const char *dataPath);   // Initia
 FILE *android_fopen(const char *fileName, const char *mode);           // Replacement for fopen() -> Read-only!
 #endif
 
+// File data for the loaders: mapped when possible, else a LoadFileData() copy; *mapped tells which
+unsigned char *MapOrLoadFileData(const char *fileName, int *dataSize, int *mapped);
+void UnmapOrUnloadFileData(unsigned char *data, int dataSize, int mapped);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,35 @@
+#version 330
+
+// Input instance attributes
+layout(location = 0) in vec2 instancePosition;
+layout(location = 1) in vec2 instanceShape;  // rotation in degrees, radius
+layout(location = 2) in vec4 instanceStyle;  // sides (1 for a dot), red, green, blue in 0..255
+
+// Input uniform values
+uniform mat4 mvp;
+uniform float pixel;  // world units per screen pixel
+
+// Output vertex attributes (to fragment shader)
+out vec4 fragColor;
+
+void main()
+{
+    // The index buffer walks corners 0..4 as five line segments. Corners past the last
+    // one fold back onto corner 0, so a triangle or a square keeps its closing segment
+    // and the trailing ones shrink to nothing.
+    int sides = int(instanceStyle.x + 0.5);
+    int k = (gl_VertexID < sides) ? gl_VertexID : 0;
+    fragColor = vec4(instanceStyle.yzw/255.0, 1.0);
+
+    if (sides == 1)
+    {
+        // One pixel long, like the old per-vertex dots
+        gl_Position = mvp*vec4(instancePosition + vec2((gl_VertexID > 0) ? pixel : 0.0, 0.0), 0.0, 1.0);
+        return;
+    }
+
+    // Same placement as DrawPolyLines: corner k at rotation + 2*pi*k/sides
+    float angle = radians(instanceShape.x) + 6.2831853*float(k)/float(sides);
+
+    gl_Position = mvp*vec4(instancePosition + vec2(cos(angle), sin(angle))*instanceShape.y, 0.0, 1.0);
+}
@@ -0,0 +1,49 @@
+#version 330
+
+// Input instance attributes: the asteroid's course as of time0
+layout(location = 0) in vec2 instanceOrigin;
+layout(location = 1) in vec2 instanceVelocity;
+layout(location = 2) in vec2 instanceRotation;  // degrees at time0, degrees per second
+layout(location = 3) in vec3 instanceShape;     // radius, sides, time0
+
+// Input uniform values
+uniform mat4 mvp;
+uniform float time;
+uniform vec4 view;  // visible world rectangle: min x, min y, max x, max y
+uniform vec3 lod;   // pixels per world unit, screen radius below which to draw a triangle, a dot
+
+void main()
+{
+    float t = time - instanceShape.z;
+    vec2 centre = instanceOrigin + instanceVelocity*t;
+    float radius = instanceShape.x;
+
+    // Each instance is 5 line segments, two vertices each; a triangle or a square
+    // leaves the trailing segments outside the clip volume, and so does an asteroid
+    // out of view. Small ones drop to a triangle, tiny ones to a single dot.
+    int sides = int(instanceShape.y + 0.5);
+    float pixels = radius*lod.x;
+    if (pixels < lod.z) sides = 1;
+    else if (pixels < lod.y) sides = 3;
+
+    int segment = gl_VertexID/2;
+    bool visible = all(greaterThanEqual(centre + radius, view.xy)) && all(lessThanEqual(centre - radius, view.zw));
+    if (!visible || segment >= sides)
+    {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+
+    if (sides == 1)
+    {
+        // One pixel long, like AsteroidBatch's dots
+        gl_Position = mvp*vec4(centre + vec2(float(gl_VertexID%2)/lod.x, 0.0), 0.0, 1.0);
+        return;
+    }
+
+    // Same placement as DrawPolyLines: vertex k at rotation + 2*pi*k/sides
+    int k = (segment + gl_VertexID%2)%sides;
+    float angle = radians(instanceRotation.x + instanceRotation.y*t) + 6.2831853*float(k)/float(sides);
+
+    gl_Position = mvp*vec4(centre + vec2(cos(angle), sin(angle))*radius, 0.0, 1.0);
+}
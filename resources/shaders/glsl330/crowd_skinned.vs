@@ -0,0 +1,73 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec3 vertexNormal;
+layout(location = 6) in vec4 vertexBoneIds;       // Bound by GpuSkinning, see gpu_skinning.h
+layout(location = 7) in vec4 vertexBoneWeights;
+
+layout(location = 8) in mat4 instanceTransform;   // Clip and time offset in the bottom row, see animation_bake.h
+
+// Input uniform values
+uniform mat4 mvp;
+
+#define     MAX_CLIPS               16
+
+// Every clip's frames, one row per frame, three texels per bone
+uniform sampler2D animationTexture;
+uniform int clipStart[MAX_CLIPS];
+uniform int clipFrames[MAX_CLIPS];
+uniform float frameRate;
+uniform float animationTime;
+
+// Output vertex attributes (to fragment shader)
+out vec3 fragPosition;
+out vec2 fragTexCoord;
+out vec4 fragColor;
+out vec3 fragNormal;
+
+mat4 bone(int id, int row)
+{
+    vec4 r0 = texelFetch(animationTexture, ivec2(id*3, row), 0);
+    vec4 r1 = texelFetch(animationTexture, ivec2(id*3 + 1, row), 0);
+    vec4 r2 = texelFetch(animationTexture, ivec2(id*3 + 2, row), 0);
+    return transpose(mat4(r0, r1, r2, vec4(0.0, 0.0, 0.0, 1.0)));
+}
+
+mat4 skin(int row)
+{
+    return vertexBoneWeights.x*bone(int(vertexBoneIds.x), row) +
+           vertexBoneWeights.y*bone(int(vertexBoneIds.y), row) +
+           vertexBoneWeights.z*bone(int(vertexBoneIds.z), row) +
+           vertexBoneWeights.w*bone(int(vertexBoneIds.w), row);
+}
+
+void main()
+{
+    int clip = int(instanceTransform[0][3]);
+    float offset = instanceTransform[1][3];
+    mat4 transform = instanceTransform;
+    transform[0][3] = 0.0;
+    transform[1][3] = 0.0;
+
+    // Blend the two frames this instance's time falls between, looping the clip
+    float frame = (animationTime + offset)*frameRate;
+    int frames = clipFrames[clip];
+    int f0 = int(mod(floor(frame), float(frames)));
+    int f1 = (f0 + 1)%frames;
+    float t = fract(frame);
+    mat4 pose = skin(clipStart[clip] + f0)*(1.0 - t) + skin(clipStart[clip] + f1)*t;
+
+    vec4 worldPosition = transform*(pose*vec4(vertexPosition, 1.0));
+
+    // Send vertex attributes to fragment shader
+    // World space, as lighting.fs expects; mvp carries no model transform here
+    fragPosition = worldPosition.xyz;
+    fragTexCoord = vertexTexCoord;
+    fragColor = vec4(1.0);
+    fragNormal = normalize(mat3(transform)*(mat3(pose)*vertexNormal));
+
+    // Calculate final vertex position
+    gl_Position = mvp*worldPosition;
+}
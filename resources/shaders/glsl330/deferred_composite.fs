@@ -0,0 +1,26 @@
+#version 330
+
+// Input vertex attributes (from deferred_shading.vs)
+in vec2 texCoord;
+
+// Output fragment color
+out vec4 finalColor;
+
+uniform sampler2D lightAccumulation;
+uniform sampler2D gNormal;
+uniform vec4 background;
+
+void main()
+{
+    // Nothing was drawn where the G-buffer normal is still zero
+    vec3 normal = texture(gNormal, texCoord).rgb;
+    if (dot(normal, normal) == 0.0)
+    {
+        finalColor = background;
+        return;
+    }
+
+    // Gamma correction
+    vec3 color = texture(lightAccumulation, texCoord).rgb;
+    finalColor = vec4(pow(color, vec3(1.0/2.2)), 1.0);
+}
@@ -0,0 +1,43 @@
+#version 330
+
+// Output fragment color, added to the light accumulation target
+out vec4 finalColor;
+
+// G-buffer
+uniform sampler2D gPosition;
+uniform sampler2D gNormal;
+uniform sampler2D gAlbedoSpec;
+
+uniform vec2 screenSize;
+uniform vec3 viewPosition;
+
+// The light this volume belongs to
+uniform vec4 lightPositionRadius;
+uniform vec3 lightColor;
+
+void main()
+{
+    vec2 texCoord = gl_FragCoord.xy/screenSize;
+    vec3 normal = texture(gNormal, texCoord).rgb;
+    if (dot(normal, normal) == 0.0) discard;    // background
+
+    vec3 fragPosition = texture(gPosition, texCoord).rgb;
+    vec3 albedo = texture(gAlbedoSpec, texCoord).rgb;
+    float specularStrength = texture(gAlbedoSpec, texCoord).a;
+
+    vec3 toLight = lightPositionRadius.xyz - fragPosition;
+    float dist = length(toLight);
+    float fade = clamp(1.0 - (dist*dist)/(lightPositionRadius.w*lightPositionRadius.w), 0.0, 1.0);
+    fade *= fade;   // zero at the radius, so nothing is lost outside the volume
+    if (fade <= 0.0) discard;
+
+    vec3 lightDirection = toLight/dist;
+    vec3 viewDirection = normalize(viewPosition - fragPosition);
+    vec3 diffuse = max(dot(normal, lightDirection), 0.0)*albedo*lightColor;
+
+    vec3 halfwayDirection = normalize(lightDirection + viewDirection);
+    float spec = pow(max(dot(normal, halfwayDirection), 0.0), 32.0);
+    vec3 specular = specularStrength*spec*lightColor;
+
+    finalColor = vec4((diffuse + specular)*fade, 0.0);
+}
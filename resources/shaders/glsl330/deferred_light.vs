@@ -0,0 +1,13 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+
+// Input uniform values
+uniform mat4 mvp;
+
+void main()
+{
+    // Light volume: a unit sphere scaled and placed on the light by the model transform
+    gl_Position = mvp*vec4(vertexPosition, 1.0);
+}
@@ -17,7 +17,12 @@ struct Light {
 };
 
 const int NR_LIGHTS = 4;
-uniform Light lights[NR_LIGHTS];
+
+// Shared with every other lit shader through rlights.h's light buffer
+layout(std140) uniform LightBlock
+{
+    Light lights[NR_LIGHTS];
+};
 uniform vec3 viewPosition;
 
 const float QUADRATIC = 0.032;
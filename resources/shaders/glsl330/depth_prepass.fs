@@ -0,0 +1,9 @@
+#version 330
+
+// Depth pre-pass: colour writes are masked off and nothing is computed, so the only work per
+// fragment is the fixed-function depth test and write
+// NOTE: Leaving gl_FragDepth alone (unlike write_depth.fs) keeps early depth testing on
+
+void main()
+{
+}
@@ -0,0 +1,35 @@
+#version 330
+
+// Input vertex attributes: the shape's unit mesh
+layout(location = 0) in vec3 vertexPosition;
+
+// Input instance attributes
+layout(location = 1) in vec3 instancePosition;
+layout(location = 2) in vec3 instanceExtent;    // per-axis scale; for arrows, the span
+layout(location = 3) in vec4 instanceColor;
+
+// Input uniform values
+uniform mat4 mvp;
+uniform int arrow;
+
+// Output vertex attributes (to fragment shader)
+out vec4 fragColor;
+
+void main()
+{
+    vec3 local = vertexPosition*instanceExtent;
+
+    // The unit arrow points along +Z: turn it onto the span and stretch it to its length
+    if (arrow == 1)
+    {
+        float len = length(instanceExtent);
+        vec3 z = instanceExtent/max(len, 1e-6);
+        vec3 up = (abs(z.y) < 0.99)? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0);
+        vec3 x = normalize(cross(up, z));
+        vec3 y = cross(z, x);
+        local = mat3(x, y, z)*(vertexPosition*len);
+    }
+
+    fragColor = instanceColor;
+    gl_Position = mvp*vec4(instancePosition + local, 1.0);
+}
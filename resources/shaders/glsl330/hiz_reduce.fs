@@ -0,0 +1,29 @@
+#version 330
+
+// Input uniform values
+uniform sampler2D source;       // The level below (the depth texture for level 0), as its only level
+uniform ivec2 sourceSize;
+
+// Output fragment color
+out vec4 finalColor;
+
+float Fetch(ivec2 p)
+{
+    return texelFetch(source, min(p, sourceSize - 1), 0).r;
+}
+
+void main()
+{
+    // Farthest of the 2x2 source texels under this one; an odd source has one texel more than
+    // twice this level, so every texel takes the next row and column too and none is missed
+    ivec2 p = ivec2(gl_FragCoord.xy)*2;
+    float farthest = max(max(Fetch(p), Fetch(p + ivec2(1, 0))), max(Fetch(p + ivec2(0, 1)), Fetch(p + ivec2(1, 1))));
+
+    bool oddX = (sourceSize.x & 1) != 0;
+    bool oddY = (sourceSize.y & 1) != 0;
+    if (oddX) farthest = max(farthest, max(Fetch(p + ivec2(2, 0)), Fetch(p + ivec2(2, 1))));
+    if (oddY) farthest = max(farthest, max(Fetch(p + ivec2(0, 2)), Fetch(p + ivec2(1, 2))));
+    if (oddX && oddY) farthest = max(farthest, Fetch(p + ivec2(2, 2)));
+
+    finalColor = vec4(farthest, 0.0, 0.0, 1.0);
+}
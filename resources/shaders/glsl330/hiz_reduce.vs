@@ -0,0 +1,9 @@
+#version 330
+
+// One triangle over the whole target, from gl_VertexID alone: no vertex buffers are bound
+
+void main()
+{
+    vec2 corner = vec2(float((gl_VertexID << 1) & 2), float(gl_VertexID & 2));
+    gl_Position = vec4(corner*2.0 - 1.0, 0.0, 1.0);
+}
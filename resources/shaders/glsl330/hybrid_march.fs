@@ -0,0 +1,170 @@
+#version 330
+
+// Raymarched half of the hybrid path, drawn at 1/scale resolution over the rasterised scene's
+// depth: each texel marches the SDF scene of hybrid_raymarch.fs (no floor or sky, the raster
+// scene has those) from the camera and stops at the farthest raster depth under its
+// footprint, where a hit would be hidden anyway
+
+// Input uniform values
+uniform sampler2D sceneDepth;       // full-resolution window depth of the raster pass
+uniform int scale;                  // full-resolution pixels per texel, each way
+uniform vec3 camPos;
+uniform vec3 camForward;
+uniform mat4 invViewProj;
+uniform vec2 clipPlanes;            // near, far
+
+// Output: colour and distance along the ray (MISS if nothing was hit), and the guide the
+// upsample matches full-resolution pixels against, the farthest raster view depth
+layout(location = 0) out vec4 marched;
+layout(location = 1) out float guide;
+
+#define MISS 1e6
+#define MAX_DISTANCE 20.0
+
+float ViewDepth(float depth)
+{
+    float n = clipPlanes.x, f = clipPlanes.y;
+    return n*f/(f - depth*(f - n));
+}
+
+// https://iquilezles.org/articles/distfunctions/
+float sdHorseshoe( in vec3 p, in vec2 c, in float r, in float le, vec2 w )
+{
+    p.x = abs(p.x);
+    float l = length(p.xy);
+    p.xy = mat2(-c.x, c.y, 
+              c.y, c.x)*p.xy;
+    p.xy = vec2((p.y>0.0 || p.x>0.0)?p.x:l*sign(-c.x),
+                (p.x>0.0)?p.y:l );
+    p.xy = vec2(p.x,abs(p.y-r))-vec2(le,0.0);
+    
+    vec2 q = vec2(length(max(p.xy,0.0)) + min(0.0,max(p.x,p.y)),p.z);
+    vec2 d = abs(q) - w;
+    return min(max(d.x,d.y),0.0) + length(max(d,0.0));
+}
+
+// r = sphere's radius
+// h = cutting's plane's position
+// t = thickness
+float sdSixWayCutHollowSphere( vec3 p, float r, float h, float t )
+{
+    // Six way symetry Transformation
+    vec3 ap = abs(p);
+    if(ap.x < max(ap.y, ap.z)){
+        if(ap.y < ap.z) ap.xz = ap.zx;
+        else ap.xy = ap.yx;
+    }
+
+    vec2 q = vec2( length(ap.yz), ap.x );
+    
+    float w = sqrt(r*r-h*h);
+    
+    return ((h*q.x<w*q.y) ? length(q-vec2(w,h)) : 
+                            abs(length(q)-r) ) - t;
+}
+
+vec2 map(in vec3 pos)
+{
+    vec2 res = vec2(sdHorseshoe(pos - vec3(-1.0, 0.08, 1.0), vec2(cos(1.3), sin(1.3)), 0.2, 0.3, vec2(0.03, 0.5)), 11.5);
+    float shell = sdSixWayCutHollowSphere(pos - vec3(0.0, 1.0, 0.0), 4.0, 3.5, 0.5);
+    return (shell < res.x)? vec2(shell, 4.5) : res;
+}
+
+// https://iquilezles.org/articles/rmshadows
+float calcSoftshadow(in vec3 ro, in vec3 rd, in float mint, in float tmax)
+{
+    float res = 1.0;
+    float t = mint;
+    for (int i = 0; i < 24; i++)
+    {
+        float h = map(ro + rd*t).x;
+        float s = clamp(8.0*h/t, 0.0, 1.0);
+        res = min(res, s);
+        t += clamp(h, 0.01, 0.2);
+        if ((res < 0.004) || (t > tmax)) break;
+    }
+    res = clamp(res, 0.0, 1.0);
+    return res*res*(3.0 - 2.0*res);
+}
+
+// https://iquilezles.org/articles/normalsSDF
+vec3 calcNormal(in vec3 pos)
+{
+    vec2 e = vec2(1.0, -1.0)*0.5773*0.0005;
+    return normalize(e.xyy*map(pos + e.xyy).x + e.yyx*map(pos + e.yyx).x + e.yxy*map(pos + e.yxy).x + e.xxx*map(pos + e.xxx).x);
+}
+
+// https://iquilezles.org/articles/nvscene2008/rwwtt.pdf
+float calcAO(in vec3 pos, in vec3 nor)
+{
+    float occ = 0.0;
+    float sca = 1.0;
+    for (int i = 0; i < 5; i++)
+    {
+        float h = 0.01 + 0.12*float(i)/4.0;
+        float d = map(pos + h*nor).x;
+        occ += (h - d)*sca;
+        sca *= 0.95;
+        if (occ > 0.35) break;
+    }
+    return clamp(1.0 - 3.0*occ, 0.0, 1.0)*(0.5 + 0.5*nor.y);
+}
+
+// The lighting of hybrid_raymarch.fs's render(), sun and sky
+vec3 shade(in vec3 pos, in vec3 rd, in float m)
+{
+    vec3 nor = calcNormal(pos);
+    vec3 ref = reflect(rd, nor);
+    vec3 col = 0.2 + 0.2*sin(m*2.0 + vec3(0.0, 1.0, 2.0));
+    float occ = calcAO(pos, nor);
+    vec3 lin = vec3(0.0);
+
+    vec3 lig = normalize(vec3(-0.5, 0.4, -0.6));
+    vec3 hal = normalize(lig - rd);
+    float dif = clamp(dot(nor, lig), 0.0, 1.0)*calcSoftshadow(pos, lig, 0.02, 2.5);
+    float spe = pow(clamp(dot(nor, hal), 0.0, 1.0), 16.0)*dif;
+    spe *= 0.04 + 0.96*pow(clamp(1.0 - dot(hal, lig), 0.0, 1.0), 5.0);
+    lin += col*2.20*dif*vec3(1.30, 1.00, 0.70);
+    lin += 5.00*spe*vec3(1.30, 1.00, 0.70);
+
+    dif = sqrt(clamp(0.5 + 0.5*nor.y, 0.0, 1.0))*occ;
+    spe = smoothstep(-0.2, 0.2, ref.y)*dif;
+    spe *= 0.04 + 0.96*pow(clamp(1.0 + dot(nor, rd), 0.0, 1.0), 5.0);
+    lin += col*0.60*dif*vec3(0.40, 0.60, 1.15);
+    lin += 2.00*spe*vec3(0.40, 0.60, 1.30);
+
+    return clamp(lin, 0.0, 1.0);
+}
+
+void main()
+{
+    ivec2 full = textureSize(sceneDepth, 0);
+    ivec2 first = ivec2(gl_FragCoord.xy)*scale;
+    float farthest = 0.0;
+    for (int y = 0; y < scale; y++)
+    {
+        for (int x = 0; x < scale; x++) farthest = max(farthest, texelFetch(sceneDepth, min(first + ivec2(x, y), full - 1), 0).r);
+    }
+    guide = ViewDepth(farthest);
+
+    // The ray through the footprint's centre
+    vec2 uv = (vec2(first) + 0.5*float(scale))/vec2(full);
+    vec4 far = invViewProj*vec4(uv*2.0 - 1.0, 1.0, 1.0);
+    vec3 rd = normalize(far.xyz/far.w - camPos);
+
+    // Raster depth ends the march early: nothing past it can be seen here
+    float tmax = min(MAX_DISTANCE, guide/dot(rd, camForward));
+    float t = clipPlanes.x;
+    marched = vec4(0.0, 0.0, 0.0, MISS);
+    for (int i = 0; i < 70; i++)
+    {
+        if (t > tmax) break;
+        vec2 h = map(camPos + rd*t);
+        if (abs(h.x) < 0.0001*t)
+        {
+            marched = vec4(shade(camPos + rd*t, rd, h.y), t);
+            break;
+        }
+        t += h.x;
+    }
+}
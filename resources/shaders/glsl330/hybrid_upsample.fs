@@ -0,0 +1,79 @@
+#version 330
+
+// Full-resolution composite of the hybrid path: the raster scene, with the raymarched texels
+// upsampled over it, each of the four nearest weighted by how close its guide depth is to
+// this pixel's raster depth, so marched colour doesn't bleed across raster silhouettes.
+// Weighted coverage of the texels whose hit is in front of this pixel's raster surface
+// blends the two, and the depth written is the nearer one's
+
+// Input uniform values
+uniform sampler2D sceneColor;
+uniform sampler2D sceneDepth;
+uniform sampler2D marched;          // rgb colour, a distance along the ray
+uniform sampler2D guide;            // farthest raster view depth under each texel
+uniform int scale;
+uniform ivec2 marchedSize;          // texels in use
+uniform vec3 camPos;
+uniform vec3 camForward;
+uniform mat4 invViewProj;
+uniform vec2 clipPlanes;            // near, far
+
+// Output fragment color
+out vec4 finalColor;
+
+float ViewDepth(float depth)
+{
+    float n = clipPlanes.x, f = clipPlanes.y;
+    return n*f/(f - depth*(f - n));
+}
+
+float WindowDepth(float viewDepth)
+{
+    float n = clipPlanes.x, f = clipPlanes.y;
+    return (f - n*f/viewDepth)/(f - n);
+}
+
+void main()
+{
+    ivec2 pixel = ivec2(gl_FragCoord.xy);
+    ivec2 full = textureSize(sceneDepth, 0);
+    vec4 raster = texelFetch(sceneColor, pixel, 0);
+    float rasterDepth = texelFetch(sceneDepth, pixel, 0).r;
+    float rasterView = ViewDepth(rasterDepth);
+
+    vec4 far = invViewProj*vec4(gl_FragCoord.xy/vec2(full)*2.0 - 1.0, 1.0, 1.0);
+    vec3 rd = normalize(far.xyz/far.w - camPos);
+    float along = dot(rd, camForward);
+    float rasterT = rasterView/along;
+
+    vec2 at = gl_FragCoord.xy/float(scale) - 0.5;
+    ivec2 base = ivec2(floor(at));
+    vec2 f = at - floor(at);
+    float total = 0.0, covered = 0.0, t = 0.0;
+    vec3 color = vec3(0.0);
+    for (int i = 0; i < 4; i++)
+    {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        ivec2 texel = clamp(base + offset, ivec2(0), marchedSize - 1);
+        float bilinear = ((offset.x == 1)? f.x : 1.0 - f.x)*((offset.y == 1)? f.y : 1.0 - f.y);
+        float similar = 1.0/(1e-3 + abs(texelFetch(guide, texel, 0).r - rasterView)/rasterView);
+        float w = bilinear*similar + 1e-6;
+        vec4 hit = texelFetch(marched, texel, 0);
+        total += w;
+        if (hit.a < rasterT)
+        {
+            covered += w;
+            color += hit.rgb*w;
+            t += hit.a*w;
+        }
+    }
+
+    float coverage = covered/total;
+    if (covered > 0.0)
+    {
+        color /= covered;
+        t /= covered;
+    }
+    finalColor = vec4(mix(raster.rgb, color, coverage), 1.0);
+    gl_FragDepth = (coverage > 0.5)? WindowDepth(t*along) : rasterDepth;
+}
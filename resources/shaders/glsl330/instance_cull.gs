@@ -0,0 +1,26 @@
+#version 330
+
+// Passes on the instances the vertex shader kept; transform feedback packs them tightly
+layout(points) in;
+layout(points, max_vertices = 1) out;
+
+in mat4 cullTransform[];
+flat in int cullKeep[];
+
+// Captured, interleaved, as the mat4 instance attribute of the draw that follows
+out vec4 column0;
+out vec4 column1;
+out vec4 column2;
+out vec4 column3;
+
+void main()
+{
+    if (cullKeep[0] == 0) return;
+
+    column0 = cullTransform[0][0];
+    column1 = cullTransform[0][1];
+    column2 = cullTransform[0][2];
+    column3 = cullTransform[0][3];
+    EmitVertex();
+    EndPrimitive();
+}
@@ -0,0 +1,66 @@
+#version 330
+
+// Input vertex attributes: one point per instance
+in mat4 instanceTransform;
+
+// Input uniform values
+uniform vec4 frustumPlanes[6];      // xyz unit normal pointing inwards, w distance
+uniform vec4 boundingSphere;        // Mesh-space centre and radius of the prop
+uniform vec3 viewPos;
+uniform vec2 lodRange;              // This pass keeps instances at distances [x, y)
+uniform int occlusion;              // 0: no depth pyramid to test against
+uniform mat4 viewProjection;
+uniform sampler2D depthPyramid;     // Farthest depth per texel, level 0 at half the window
+uniform vec2 pyramidSize;           // Level 0, in texels
+uniform int pyramidLevels;
+
+// Output to the geometry shader
+out mat4 cullTransform;
+flat out int cullKeep;
+
+// True when the sphere's bounding cube lies behind the depth pyramid's occluders over the
+// whole of its screen rectangle. Anything reaching past the near plane counts as visible
+bool Occluded(vec3 centre, float radius)
+{
+    vec3 lo = vec3(1.0);
+    vec3 hi = vec3(-1.0);
+    for (int i = 0; i < 8; i++)
+    {
+        vec3 corner = centre + radius*vec3(((i & 1) != 0)? 1.0 : -1.0, ((i & 2) != 0)? 1.0 : -1.0, ((i & 4) != 0)? 1.0 : -1.0);
+        vec4 clip = viewProjection*vec4(corner, 1.0);
+        if (clip.w <= 0.0) return false;
+        vec3 ndc = clip.xyz/clip.w;
+        lo = min(lo, ndc);
+        hi = max(hi, ndc);
+    }
+    if (lo.z < -1.0) return false;
+
+    vec2 uvLo = clamp(lo.xy*0.5 + 0.5, 0.0, 1.0);
+    vec2 uvHi = clamp(hi.xy*0.5 + 0.5, 0.0, 1.0);
+    vec2 extent = (uvHi - uvLo)*pyramidSize;
+    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, pyramidLevels - 1);
+
+    // At that level the rectangle spans at most 2x2 texels
+    ivec2 size = textureSize(depthPyramid, level);
+    ivec2 a = clamp(ivec2(uvLo*vec2(size)), ivec2(0), size - 1);
+    ivec2 b = clamp(ivec2(uvHi*vec2(size)), ivec2(0), size - 1);
+    float farthest = max(max(texelFetch(depthPyramid, a, level).r, texelFetch(depthPyramid, ivec2(b.x, a.y), level).r),
+                         max(texelFetch(depthPyramid, ivec2(a.x, b.y), level).r, texelFetch(depthPyramid, b, level).r));
+
+    return lo.z*0.5 + 0.5 > farthest;
+}
+
+void main()
+{
+    vec3 centre = vec3(instanceTransform*vec4(boundingSphere.xyz, 1.0));
+    float scale = max(length(instanceTransform[0].xyz), max(length(instanceTransform[1].xyz), length(instanceTransform[2].xyz)));
+    float radius = boundingSphere.w*scale;
+
+    bool inside = true;
+    for (int i = 0; i < 6; i++) inside = inside && (dot(frustumPlanes[i].xyz, centre) + frustumPlanes[i].w >= -radius);
+
+    float dist = distance(centre, viewPos);
+    bool inRange = inside && (dist >= lodRange.x) && (dist < lodRange.y);
+    cullKeep = (inRange && !((occlusion != 0) && Occluded(centre, radius)))? 1 : 0;
+    cullTransform = instanceTransform;
+}
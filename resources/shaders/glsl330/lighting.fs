@@ -27,11 +27,38 @@ struct Light {
     vec4 color;
 };
 
-// Input lighting values
-uniform Light lights[MAX_LIGHTS];
+// Input lighting values, shared by every shader bound to the light buffer (see rlights.h)
+layout(std140) uniform LightBlock
+{
+    Light lights[MAX_LIGHTS];
+};
 uniform vec4 ambient;
 uniform vec3 viewPos;
 
+// Variants (see ShaderVariants) define LIGHTS_ENABLED and LIGHTS_POINT, bit i for light i,
+// so which lights are lit and how are known here; a plain load reads both from the block.
+void AddLight(int i, int type, vec3 normal, vec3 viewD, inout vec3 lightDot, inout vec3 specular)
+{
+    vec3 light = vec3(0.0);
+
+    if (type == LIGHT_DIRECTIONAL)
+    {
+        light = -normalize(lights[i].target - lights[i].position);
+    }
+
+    if (type == LIGHT_POINT)
+    {
+        light = normalize(lights[i].position - fragPosition);
+    }
+
+    float NdotL = max(dot(normal, light), 0.0);
+    lightDot += lights[i].color.rgb*NdotL;
+
+    float specCo = 0.0;
+    if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 16.0); // 16 refers to shine
+    specular += specCo;
+}
+
 void main()
 {
     // Texel color fetching from texture sampler
@@ -43,30 +70,25 @@ void main()
 
     // NOTE: Implement here your fragment shader code
 
+#ifdef LIGHTS_ENABLED
+#if (LIGHTS_ENABLED & 1) != 0
+    AddLight(0, (LIGHTS_POINT >> 0) & 1, normal, viewD, lightDot, specular);
+#endif
+#if (LIGHTS_ENABLED & 2) != 0
+    AddLight(1, (LIGHTS_POINT >> 1) & 1, normal, viewD, lightDot, specular);
+#endif
+#if (LIGHTS_ENABLED & 4) != 0
+    AddLight(2, (LIGHTS_POINT >> 2) & 1, normal, viewD, lightDot, specular);
+#endif
+#if (LIGHTS_ENABLED & 8) != 0
+    AddLight(3, (LIGHTS_POINT >> 3) & 1, normal, viewD, lightDot, specular);
+#endif
+#else
     for (int i = 0; i < MAX_LIGHTS; i++)
     {
-        if (lights[i].enabled == 1)
-        {
-            vec3 light = vec3(0.0);
-
-            if (lights[i].type == LIGHT_DIRECTIONAL)
-            {
-                light = -normalize(lights[i].target - lights[i].position);
-            }
-
-            if (lights[i].type == LIGHT_POINT)
-            {
-                light = normalize(lights[i].position - fragPosition);
-            }
-
-            float NdotL = max(dot(normal, light), 0.0);
-            lightDot += lights[i].color.rgb*NdotL;
-
-            float specCo = 0.0;
-            if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 16.0); // 16 refers to shine
-            specular += specCo;
-        }
+        if (lights[i].enabled == 1) AddLight(i, lights[i].type, normal, viewD, lightDot, specular);
     }
+#endif
 
     finalColor = (texelColor*((colDiffuse + vec4(specular, 1.0))*vec4(lightDot, 1.0)));
     finalColor += texelColor*(ambient/10.0)*colDiffuse;
@@ -1,10 +1,11 @@
 #version 330
 
 // Input vertex attributes
-in vec3 vertexPosition;
+in vec4 vertexPosition;     // w is 0 for vertex_compress.h's compact layout, 1 for floats
 in vec2 vertexTexCoord;
-in vec3 vertexNormal;
+in vec4 vertexNormal;       // compact: octahedral in xy
 in vec4 vertexColor;
+layout(location = 8) in vec4 vertexDecode;  // compact: bounding cube corner and size, else (0, 0, 0, 1)
 
 // Input uniform values
 uniform mat4 mvp;
@@ -19,14 +20,26 @@ out vec3 fragNormal;
 
 // NOTE: Add here your custom variables
 
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main()
 {
+    bool compact = (vertexPosition.w == 0.0);
+    vec3 position = vertexDecode.xyz + vertexPosition.xyz*vertexDecode.w;
+    vec3 normal = compact? OctDecode(vertexNormal.xy) : vertexNormal.xyz;
+
     // Send vertex attributes to fragment shader
-    fragPosition = vec3(matModel*vec4(vertexPosition, 1.0));
+    fragPosition = vec3(matModel*vec4(position, 1.0));
     fragTexCoord = vertexTexCoord;
     fragColor = vertexColor;
-    fragNormal = normalize(vec3(matNormal*vec4(vertexNormal, 1.0)));
+    fragNormal = normalize(vec3(matNormal*vec4(normal, 1.0)));
 
     // Calculate final vertex position
-    gl_Position = mvp*vec4(vertexPosition, 1.0);
+    gl_Position = mvp*vec4(position, 1.0);
 }
@@ -0,0 +1,60 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec3 fragPosition;
+in vec2 fragTexCoord;
+in vec3 fragNormal;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+// Lights reaching this draw, listed on the CPU per object (see LightAssignment)
+#define     MAX_PER_DRAW            16
+uniform sampler2D assignedLights;   // two texels per light: (position, radius), (color, 0)
+uniform int lightIndices[MAX_PER_DRAW];
+uniform int lightCount;
+
+uniform vec4 ambient;
+uniform vec3 viewPos;
+
+void main()
+{
+    // Texel color fetching from texture sampler
+    vec4 texelColor = texture(texture0, fragTexCoord);
+    vec3 lightDot = vec3(0.0);
+    vec3 normal = normalize(fragNormal);
+    vec3 viewD = normalize(viewPos - fragPosition);
+    vec3 specular = vec3(0.0);
+
+    // Shade only the draw's own lights
+    for (int i = 0; i < lightCount; i++)
+    {
+        int index = lightIndices[i];
+        vec4 positionRadius = texelFetch(assignedLights, ivec2(2*index, 0), 0);
+        vec3 color = texelFetch(assignedLights, ivec2(2*index + 1, 0), 0).rgb;
+
+        vec3 toLight = positionRadius.xyz - fragPosition;
+        float dist = length(toLight);
+        float fade = clamp(1.0 - (dist*dist)/(positionRadius.w*positionRadius.w), 0.0, 1.0);
+        fade *= fade;   // reaches zero at the radius, so assigning by radius is exact
+        if (fade <= 0.0) continue;
+
+        vec3 light = toLight/dist;
+        float NdotL = max(dot(normal, light), 0.0);
+        lightDot += color*NdotL*fade;
+
+        float specCo = 0.0;
+        if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 16.0); // 16 refers to shine
+        specular += specCo*fade;
+    }
+
+    finalColor = (texelColor*((colDiffuse + vec4(specular, 1.0))*vec4(lightDot, 1.0)));
+    finalColor += texelColor*(ambient/10.0)*colDiffuse;
+
+    // Gamma correction
+    finalColor = pow(finalColor, vec4(1.0/2.2));
+}
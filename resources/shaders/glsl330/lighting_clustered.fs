@@ -0,0 +1,72 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec3 fragPosition;
+in vec2 fragTexCoord;
+in vec3 fragNormal;
+in float fragDepth;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+// Cluster data, built on the CPU every frame (see ClusteredLights)
+uniform sampler2D clusterLights;    // two texels per light: (position, radius), (color, 0)
+uniform sampler2D clusterGrid;      // one texel per cluster: (first index, count); one row per slice
+uniform sampler2D clusterIndices;   // light indices, cluster lists back to back
+uniform vec2 clusterTile;           // tile size in pixels
+uniform ivec2 clusterTiles;         // tiles across and down
+uniform vec2 clusterDepth;          // slice = log(depth)*x + y
+
+uniform vec4 ambient;
+uniform vec3 viewPos;
+
+void main()
+{
+    // Texel color fetching from texture sampler
+    vec4 texelColor = texture(texture0, fragTexCoord);
+    vec3 lightDot = vec3(0.0);
+    vec3 normal = normalize(fragNormal);
+    vec3 viewD = normalize(viewPos - fragPosition);
+    vec3 specular = vec3(0.0);
+
+    // Find this fragment's cluster
+    int slices = textureSize(clusterGrid, 0).y;
+    int indexWidth = textureSize(clusterIndices, 0).x;
+    ivec2 tile = clamp(ivec2(gl_FragCoord.xy/clusterTile), ivec2(0), clusterTiles - 1);
+    int slice = int(clamp(log(max(fragDepth, 1e-4))*clusterDepth.x + clusterDepth.y, 0.0, float(slices - 1)));
+    vec2 cell = texelFetch(clusterGrid, ivec2(tile.x + tile.y*clusterTiles.x, slice), 0).xy;
+    int first = int(cell.x);
+    int count = int(cell.y);
+
+    // Shade only the lights that reach it
+    for (int i = first; i < first + count; i++)
+    {
+        int index = int(texelFetch(clusterIndices, ivec2(i%indexWidth, i/indexWidth), 0).r);
+        vec4 positionRadius = texelFetch(clusterLights, ivec2(2*index, 0), 0);
+        vec3 color = texelFetch(clusterLights, ivec2(2*index + 1, 0), 0).rgb;
+
+        vec3 toLight = positionRadius.xyz - fragPosition;
+        float dist = length(toLight);
+        float fade = clamp(1.0 - (dist*dist)/(positionRadius.w*positionRadius.w), 0.0, 1.0);
+        fade *= fade;   // reaches zero at the radius, so culling by radius is exact
+        if (fade <= 0.0) continue;
+
+        vec3 light = toLight/dist;
+        float NdotL = max(dot(normal, light), 0.0);
+        lightDot += color*NdotL*fade;
+
+        float specCo = 0.0;
+        if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(light), normal))), 16.0); // 16 refers to shine
+        specular += specCo*fade;
+    }
+
+    finalColor = (texelColor*((colDiffuse + vec4(specular, 1.0))*vec4(lightDot, 1.0)));
+    finalColor += texelColor*(ambient/10.0)*colDiffuse;
+
+    // Gamma correction
+    finalColor = pow(finalColor, vec4(1.0/2.2));
+}
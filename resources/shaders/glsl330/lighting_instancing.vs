@@ -26,10 +26,11 @@ void main()
     mat4 mvpi = mvp*instanceTransform;
 
     // Send vertex attributes to fragment shader
-    fragPosition = vec3(mvpi*vec4(vertexPosition, 1.0));
+    // World space, as lighting.fs expects; mvp carries no model transform here
+    fragPosition = vec3(instanceTransform*vec4(vertexPosition, 1.0));
     fragTexCoord = vertexTexCoord;
     //fragColor = vertexColor;
-    fragNormal = normalize(vec3(matNormal*vec4(vertexNormal, 1.0)));
+    fragNormal = normalize(mat3(instanceTransform)*vertexNormal);
 
     // Calculate final vertex position
     gl_Position = mvpi*vec4(vertexPosition, 1.0);
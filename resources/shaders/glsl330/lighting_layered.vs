@@ -0,0 +1,40 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec3 vertexNormal;
+//in vec4 vertexColor;      // Not required
+
+in mat4 instanceTransform;
+layout(location = 9) in float instanceLayer;  // its material's layer in texture0 (MaterialBatch::C_LAYER_LOCATION)
+
+// Input uniform values
+uniform mat4 mvp;
+uniform mat4 matNormal;
+
+// Output vertex attributes (to fragment shader)
+out vec3 fragPosition;
+out vec2 fragTexCoord;
+out vec4 fragColor;
+out vec3 fragNormal;
+out float fragLayer;
+
+// NOTE: Add here your custom variables
+
+void main()
+{
+    // Compute MVP for current instance
+    mat4 mvpi = mvp*instanceTransform;
+
+    // Send vertex attributes to fragment shader
+    // World space, as lighting.fs expects; mvp carries no model transform here
+    fragPosition = vec3(instanceTransform*vec4(vertexPosition, 1.0));
+    fragTexCoord = vertexTexCoord;
+    //fragColor = vertexColor;
+    fragNormal = normalize(mat3(instanceTransform)*vertexNormal);
+    fragLayer = instanceLayer;
+
+    // Calculate final vertex position
+    gl_Position = mvpi*vec4(vertexPosition, 1.0);
+}
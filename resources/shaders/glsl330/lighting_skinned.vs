@@ -0,0 +1,47 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec3 vertexNormal;
+in vec4 vertexColor;
+layout(location = 6) in vec4 vertexBoneIds;       // Bound by GpuSkinning, see gpu_skinning.h
+layout(location = 7) in vec4 vertexBoneWeights;
+
+// Input uniform values
+uniform mat4 mvp;
+uniform mat4 matModel;
+uniform mat4 matNormal;
+
+#define     MAX_BONES               128
+
+// This frame's pose, one matrix per bone from bind pose to posed model space
+layout(std140) uniform BoneBlock
+{
+    mat4 boneMatrices[MAX_BONES];
+};
+
+// Output vertex attributes (to fragment shader)
+out vec3 fragPosition;
+out vec2 fragTexCoord;
+out vec4 fragColor;
+out vec3 fragNormal;
+
+void main()
+{
+    mat4 skin = vertexBoneWeights.x*boneMatrices[int(vertexBoneIds.x)] +
+                vertexBoneWeights.y*boneMatrices[int(vertexBoneIds.y)] +
+                vertexBoneWeights.z*boneMatrices[int(vertexBoneIds.z)] +
+                vertexBoneWeights.w*boneMatrices[int(vertexBoneIds.w)];
+    vec4 skinnedPosition = skin*vec4(vertexPosition, 1.0);
+    vec3 skinnedNormal = mat3(skin)*vertexNormal;
+
+    // Send vertex attributes to fragment shader
+    fragPosition = vec3(matModel*skinnedPosition);
+    fragTexCoord = vertexTexCoord;
+    fragColor = vertexColor;
+    fragNormal = normalize(vec3(matNormal*vec4(skinnedNormal, 0.0)));
+
+    // Calculate final vertex position
+    gl_Position = mvp*skinnedPosition;
+}
@@ -0,0 +1,35 @@
+#version 330
+
+// Input vertex attributes: unit quad corner in [0, 1]
+layout(location = 0) in vec2 vertexPosition;
+
+// Input instance attributes, written when the orbiter tree changes
+layout(location = 1) in vec4 instanceOrbit;   // offset from the player at angle 0, rotation in degrees, scale
+layout(location = 2) in vec4 instanceSource;  // atlas rectangle in texture coordinates: u, v, width, height
+
+// Input uniform values
+uniform mat4 mvp;
+uniform vec3 centre;      // the player's position, how far the tree has turned since the offsets (radians)
+uniform vec2 spriteSize;  // unscaled
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+
+void main()
+{
+    // Every orbit turns at the same rate, so the whole tree turns rigidly about the player
+    float c = cos(centre.z);
+    float s = sin(centre.z);
+    vec2 offset = instanceOrbit.xy;
+    vec2 position = centre.xy + vec2(c*offset.x - s*offset.y, s*offset.x + c*offset.y);
+
+    // Same quad as SpriteBatch: the sprite's centre on the ship, rotated about it
+    vec2 corner = (vertexPosition - 0.5)*spriteSize*instanceOrbit.w;
+    float r = radians(instanceOrbit.z);
+    float rc = cos(r);
+    float rs = sin(r);
+    corner = vec2(rc*corner.x - rs*corner.y, rs*corner.x + rc*corner.y);
+
+    fragTexCoord = instanceSource.xy + vertexPosition*instanceSource.zw;
+    gl_Position = mvp*vec4(position + corner, 0.0, 1.0);
+}
@@ -0,0 +1,23 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+
+// Input uniform values
+uniform sampler2D texture0;     // Float target overdraw.fs was added into
+uniform float layerValue;       // Red added per fragment
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // Fragments shaded at this pixel: 0 black, 1 blue, 2 green, 3 yellow, 4 orange, 5+ red to white
+    float layers = floor(texture(texture0, fragTexCoord).r/layerValue + 0.5);
+
+    const vec3 ramp[7] = vec3[7](vec3(0.0), vec3(0.1, 0.2, 0.9), vec3(0.1, 0.8, 0.2), vec3(0.95, 0.9, 0.1),
+                                 vec3(1.0, 0.5, 0.0), vec3(0.9, 0.1, 0.1), vec3(1.0));
+    vec3 color = (layers < 5.0)? ramp[int(layers)] : mix(ramp[5], ramp[6], clamp((layers - 5.0)/5.0, 0.0, 1.0));
+
+    finalColor = vec4(color, 1.0);
+}
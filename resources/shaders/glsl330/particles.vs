@@ -0,0 +1,60 @@
+#version 330
+
+// Input vertex attributes: unit quad corner in [0, 1]
+layout(location = 0) in vec2 vertexPosition;
+
+// Input instance attributes, written once when the particle is emitted
+layout(location = 1) in vec2 instanceOrigin;
+layout(location = 2) in vec2 instanceVelocity;
+layout(location = 3) in float instanceSpawnTime;
+layout(location = 4) in float instanceSpread;   // max extra speed in px/s
+
+// Input uniform values
+uniform mat4 mvp;
+uniform float time;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+const float DRAG = 2.0;
+
+// Integer hash to [0, 1)
+float Hash(uint x)
+{
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return float(x)*(1.0/4294967296.0);
+}
+
+void main()
+{
+    uint id = uint(gl_InstanceID)*4u ^ floatBitsToUint(instanceSpawnTime);
+    float lifetime = mix(0.4, 1.2, Hash(id));
+    float age = time - instanceSpawnTime;
+
+    // Not born yet or burnt out: collapse the quad outside the clip volume
+    if ((age < 0.0) || (age > lifetime))
+    {
+        fragTexCoord = vec2(0.0);
+        fragColor = vec4(0.0);
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+
+    float angle = Hash(id + 1u)*6.2831853;
+    float speed = instanceSpread*sqrt(Hash(id + 2u));
+    vec2 velocity = instanceVelocity + vec2(cos(angle), sin(angle))*speed;
+
+    // Closed-form flight under linear drag: x(t) = x0 + v*(1 - e^(-k*t))/k
+    vec2 position = instanceOrigin + velocity*(1.0 - exp(-DRAG*age))/DRAG;
+
+    float t = age/lifetime;
+    float size = mix(mix(6.0, 14.0, Hash(id + 3u)), 2.0, t);
+
+    fragTexCoord = vertexPosition;
+    fragColor = vec4(mix(vec3(1.0, 0.9, 0.6), vec3(1.0, 0.3, 0.05), t), 1.0 - t);
+
+    gl_Position = mvp*vec4(position + (vertexPosition - 0.5)*size, 0.0, 1.0);
+}
@@ -1,11 +1,12 @@
 #version 330
 
 // Input vertex attributes
-in vec3 vertexPosition;
+in vec4 vertexPosition;     // w is 0 for vertex_compress.h's compact layout, 1 for floats
 in vec2 vertexTexCoord;
-in vec3 vertexNormal;
+in vec4 vertexNormal;       // compact: octahedral normal in xy, tangent in zw
 in vec3 vertexTangent;
 in vec4 vertexColor;
+layout(location = 8) in vec4 vertexDecode;  // compact: bounding cube corner and size, else (0, 0, 0, 1)
 
 // Input uniform values
 uniform mat4 mvp;
@@ -23,20 +24,33 @@ out mat3 TBN;
 
 const float normalOffset = 0.1;
 
+vec3 OctDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
+
 void main()
 {
+    bool compact = (vertexPosition.w == 0.0);
+    vec3 position = vertexDecode.xyz + vertexPosition.xyz*vertexDecode.w;
+    vec3 normal = compact? OctDecode(vertexNormal.xy) : vertexNormal.xyz;
+    vec3 tangent = compact? OctDecode(vertexNormal.zw) : vertexTangent;
+
     // Compute binormal from vertex normal and tangent
-    vec3 vertexBinormal = cross(vertexNormal, vertexTangent);
+    vec3 vertexBinormal = cross(normal, tangent);
     
     // Compute fragment normal based on normal transformations
     mat3 normalMatrix = transpose(inverse(mat3(matModel)));
     
     // Compute fragment position based on model transformations
-    fragPosition = vec3(matModel*vec4(vertexPosition, 1.0f));
+    fragPosition = vec3(matModel*vec4(position, 1.0f));
 
     fragTexCoord = vertexTexCoord*2.0;
-    fragNormal = normalize(normalMatrix*vertexNormal);
-    vec3 fragTangent = normalize(normalMatrix*vertexTangent);
+    fragNormal = normalize(normalMatrix*normal);
+    vec3 fragTangent = normalize(normalMatrix*tangent);
     fragTangent = normalize(fragTangent - dot(fragTangent, fragNormal)*fragNormal);
     vec3 fragBinormal = normalize(normalMatrix*vertexBinormal);
     fragBinormal = cross(fragNormal, fragTangent);
@@ -44,5 +58,5 @@ void main()
     TBN = transpose(mat3(fragTangent, fragBinormal, fragNormal));
 
     // Calculate final vertex position
-    gl_Position = mvp*vec4(vertexPosition, 1.0);
+    gl_Position = mvp*vec4(position, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,182 @@
+#version 330
+
+#define MAX_LIGHTS              4
+#define LIGHT_DIRECTIONAL       0
+#define LIGHT_POINT             1
+#define PI 3.14159265358979323846
+#define RGBM_RANGE              8.0     // IblCache::C_RGBM_RANGE
+#define MAX_PREFILTER_LOD       4.0     // IblCache::C_PREFILTER_LEVELS - 1
+
+struct Light {
+    int enabled;
+    int type;
+    vec3 position;
+    vec3 target;
+    vec4 color;
+};
+
+// Input vertex attributes (from vertex shader)
+in vec3 fragPosition;
+in vec2 fragTexCoord;
+in vec4 fragColor;
+in vec3 fragNormal;
+in mat3 TBN;
+
+// Output fragment color
+out vec4 finalColor;
+
+// Input uniform values
+uniform sampler2D albedoMap;
+uniform sampler2D mraMap;
+uniform sampler2D normalMap;
+uniform sampler2D emissiveMap; // r: Hight g:emissive
+
+// Precomputed image-based lighting (see ibl_cache.h)
+uniform samplerCube irradianceMap;
+uniform samplerCube prefilterMap;
+uniform sampler2D brdfLUT;
+
+uniform vec2 tiling;
+uniform vec2 offset;
+
+uniform int useTexAlbedo;
+uniform int useTexNormal;
+uniform int useTexMRA;
+uniform int useTexEmissive;
+
+uniform vec4  albedoColor;
+uniform vec4  emissiveColor;
+uniform float normalValue;
+uniform float metallicValue;
+uniform float roughnessValue;
+uniform float aoValue;
+uniform float emissivePower;
+
+// Input lighting values, shared by every shader bound to the light buffer (see rlights.h)
+layout(std140) uniform LightBlock
+{
+    Light lights[MAX_LIGHTS];
+};
+uniform float lightIntensity;
+uniform vec3 viewPos;
+
+vec3 DecodeRGBM(vec4 rgbm)
+{
+    return rgbm.rgb*rgbm.a*RGBM_RANGE;
+}
+
+// Reflectivity in range 0.0 to 1.0
+// NOTE: Reflectivity is increased when surface view at larger angle
+vec3 SchlickFresnel(float hDotV,vec3 refl)
+{
+    return refl + (1.0 - refl)*pow(1.0 - hDotV, 5.0);
+}
+
+// The same, with the grazing gain held back on rough surfaces (the environment has no H)
+vec3 SchlickFresnelRoughness(float nDotV, vec3 refl, float roughness)
+{
+    return refl + (max(vec3(1.0 - roughness), refl) - refl)*pow(1.0 - nDotV, 5.0);
+}
+
+float GgxDistribution(float nDotH,float roughness)
+{
+    float a = roughness * roughness * roughness * roughness;
+    float d = nDotH * nDotH * (a - 1.0) + 1.0;
+    d = PI * d * d;
+    return a / max(d,0.0000001);
+}
+
+float GeomSmith(float nDotV,float nDotL,float roughness)
+{
+    float r = roughness + 1.0;
+    float k = r*r / 8.0;
+    float ik = 1.0 - k;
+    float ggx1 = nDotV/(nDotV*ik + k);
+    float ggx2 = nDotL/(nDotL*ik + k);
+    return ggx1*ggx2;
+}
+
+vec3 ComputePBR()
+{
+    vec2 uv = vec2(fragTexCoord.x*tiling.x + offset.x, fragTexCoord.y*tiling.y + offset.y);
+    vec3 albedo = albedoColor.rgb;
+    if (useTexAlbedo == 1) albedo *= texture(albedoMap, uv).rgb;
+
+    float metallic = clamp(metallicValue, 0.0, 1.0);
+    float roughness = clamp(roughnessValue, 0.0, 1.0);
+    float ao = clamp(aoValue, 0.0, 1.0);
+
+    if (useTexMRA == 1)
+    {
+        vec4 mra = texture(mraMap, uv);
+        metallic = clamp(mra.r + metallicValue, 0.04, 1.0);
+        roughness = clamp(mra.g + roughnessValue, 0.04, 1.0);
+        ao = (mra.b + aoValue)*0.5;
+    }
+
+    vec3 N = normalize(fragNormal);
+    if (useTexNormal == 1)
+    {
+        // X and Y only, Z rebuilt: BC5 normal maps store nothing else
+        N.xy = texture(normalMap, uv).rg*2.0 - 1.0;
+        N.z = sqrt(max(1.0 - dot(N.xy, N.xy), 0.0));
+        N = normalize(N*TBN);
+    }
+
+    vec3 V = normalize(viewPos - fragPosition);
+    float nDotV = max(dot(N,V), 0.0000001);
+
+    vec3 emissive = texture(emissiveMap, uv).g*emissiveColor.rgb*emissivePower*float(useTexEmissive);
+
+    // if dia-electric use base reflectivity of 0.04 otherwise ut is a metal use albedo as base reflectivity
+    vec3 baseRefl = mix(vec3(0.04), albedo.rgb, metallic);
+    vec3 lightAccum = vec3(0.0);  // Acumulate lighting lum
+
+    for (int i = 0; i < MAX_LIGHTS; i++)
+    {
+        vec3 L = normalize(lights[i].position - fragPosition);      // Compute light vector
+        vec3 H = normalize(V + L);                                  // Compute halfway bisecting vector
+        float dist = length(lights[i].position - fragPosition);     // Compute distance to light
+        float attenuation = 1.0/(dist*dist*0.23);                   // Compute attenuation
+        vec3 radiance = lights[i].color.rgb*lightIntensity*attenuation; // Compute input radiance, light energy comming in
+
+        // Cook-Torrance BRDF distribution function
+        float nDotL = max(dot(N,L), 0.0000001);
+        float hDotV = max(dot(H,V), 0.0);
+        float nDotH = max(dot(N,H), 0.0);
+        float D = GgxDistribution(nDotH, roughness);    // Larger the more micro-facets aligned to H
+        float G = GeomSmith(nDotV, nDotL, roughness);   // Smaller the more micro-facets shadow
+        vec3 F = SchlickFresnel(hDotV, baseRefl);       // Fresnel proportion of specular reflectance
+
+        vec3 spec = (D*G*F)/(4.0*nDotV*nDotL);
+
+        // Mult kD by the inverse of metallnes, only non-metals should have diffuse light
+        vec3 kD = (vec3(1.0) - F)*(1.0 - metallic);
+        lightAccum += ((kD*albedo.rgb/PI + spec)*radiance*nDotL)*float(lights[i].enabled);
+    }
+
+    // Environment: split-sum specular from the prefiltered map and the BRDF LUT, diffuse
+    // from the irradiance map (already divided by PI)
+    vec3 F = SchlickFresnelRoughness(nDotV, baseRefl, roughness);
+    vec3 kD = (vec3(1.0) - F)*(1.0 - metallic);
+    vec3 irradiance = DecodeRGBM(texture(irradianceMap, N));
+    vec3 R = reflect(-V, N);
+    vec3 prefiltered = DecodeRGBM(textureLod(prefilterMap, R, roughness*MAX_PREFILTER_LOD));
+    vec2 brdf = texture(brdfLUT, vec2(nDotV, roughness)).rg;
+    vec3 ambientFinal = (kD*irradiance*albedo + prefiltered*(F*brdf.x + brdf.y))*ao;
+
+    return ambientFinal + lightAccum*ao + emissive;
+}
+
+void main()
+{
+    vec3 color = ComputePBR();
+
+    // HDR tonemapping
+    color = color/(color + vec3(1.0));
+
+    // Gamma correction
+    color = pow(color, vec3(1.0/2.2));
+
+    finalColor = vec4(color, 1.0);
+}
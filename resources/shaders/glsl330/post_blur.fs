@@ -0,0 +1,31 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform vec2 direction;     // one texel along the blur axis, in texture coordinates
+
+// Output fragment color
+out vec4 finalColor;
+
+// 9-tap Gaussian folded into 5 bilinear fetches, weights and offsets as in blur.fs
+float offset[3] = float[](0.0, 1.3846153846, 3.2307692308);
+float weight[3] = float[](0.2270270270, 0.3162162162, 0.0702702703);
+
+void main()
+{
+    // One axis per pass: a horizontal then a vertical pass make the full 2D blur
+    vec3 texelColor = texture(texture0, fragTexCoord).rgb*weight[0];
+
+    for (int i = 1; i < 3; i++)
+    {
+        texelColor += texture(texture0, fragTexCoord + direction*offset[i]).rgb*weight[i];
+        texelColor += texture(texture0, fragTexCoord - direction*offset[i]).rgb*weight[i];
+    }
+
+    finalColor = vec4(texelColor, 1.0);
+}
@@ -0,0 +1,23 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+uniform float threshold;    // luminance below which nothing glows
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // Keeps only what is brighter than the threshold, fading in over a small knee
+    vec3 texelColor = texture(texture0, fragTexCoord).rgb;
+    float lum = max(texelColor.r, max(texelColor.g, texelColor.b));
+    float keep = smoothstep(threshold, threshold + 0.1, lum);
+
+    finalColor = vec4(texelColor*keep, 1.0);
+}
@@ -0,0 +1,7 @@
+// Post-process effect, fused into the post-process pass (see PostStack in main.cpp)
+// Grayscale: NTSC conversion weights, as grayscale.fs
+vec3 Grayscale(vec3 color, vec2 pixel)
+{
+    float gray = dot(color, vec3(0.299, 0.587, 0.114));
+    return vec3(gray);
+}
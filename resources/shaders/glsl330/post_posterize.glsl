@@ -0,0 +1,11 @@
+// Post-process effect, fused into the post-process pass (see PostStack in main.cpp)
+// Posterize: 8 levels per channel in gamma 0.6 space, as posterization.fs
+vec3 Posterize(vec3 color, vec2 pixel)
+{
+    const float gamma = 0.6;
+    const float numColors = 8.0;
+
+    color = pow(color, vec3(gamma));
+    color = floor(color*numColors)/numColors;
+    return pow(color, vec3(1.0/gamma));
+}
@@ -0,0 +1,14 @@
+// Post-process effect, fused into the post-process pass (see PostStack in main.cpp)
+// Predator: luminance mapped onto a blue-yellow-red heat palette, as predator.fs
+vec3 Predator(vec3 color, vec2 pixel)
+{
+    vec3 colors[3];
+    colors[0] = vec3(0.0, 0.0, 1.0);
+    colors[1] = vec3(1.0, 1.0, 0.0);
+    colors[2] = vec3(1.0, 0.0, 0.0);
+
+    float lum = (color.r + color.g + color.b)/3.0;
+    int ix = (lum < 0.5)? 0:1;
+
+    return mix(colors[ix], colors[ix + 1], (lum - float(ix)*0.5)/0.5);
+}
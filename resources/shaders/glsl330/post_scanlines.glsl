@@ -0,0 +1,8 @@
+// Post-process effect, fused into the post-process pass (see PostStack in main.cpp)
+// Scanlines: one dark green line every 3 window pixels, as method 2 of scanlines.fs
+vec3 Scanlines(vec3 color, vec2 pixel)
+{
+    float wavePos = cos((fract(pixel.y/3.0) - 0.5)*3.14);
+
+    return mix(vec3(0.0, 0.3, 0.0), color, wavePos);
+}
@@ -0,0 +1,17 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragLocal;
+in vec4 fragColor;
+flat in int fragRound;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // Bullets are drawn as the disc inscribed in their quad
+    if ((fragRound == 1) && (dot(fragLocal, fragLocal) > 1.0)) discard;
+
+    finalColor = fragColor;
+}
@@ -0,0 +1,37 @@
+#version 330
+
+// Input vertex attributes: unit quad corner in [0, 1]
+layout(location = 0) in vec2 vertexPosition;
+
+// Input instance attributes
+layout(location = 1) in vec2 instancePosition;
+layout(location = 2) in float instanceType;     // 0: laser, 1: bullet (WeaponType)
+layout(location = 3) in vec4 instanceColor;
+
+// Input uniform values
+uniform mat4 mvp;
+
+// Output vertex attributes (to fragment shader)
+out vec2 fragLocal;
+out vec4 fragColor;
+flat out int fragRound;
+
+void main()
+{
+    // Same footprint as the old DrawRectangleRec/DrawCircleV calls
+    vec2 size = vec2(4.0, 30.0);
+    vec2 offset = vec2(-2.0, -30.0);
+    fragRound = 0;
+
+    if (instanceType > 0.5)
+    {
+        size = vec2(10.0);
+        offset = vec2(-5.0);
+        fragRound = 1;
+    }
+
+    fragLocal = vertexPosition*2.0 - 1.0;
+    fragColor = instanceColor;
+
+    gl_Position = mvp*vec4(instancePosition + offset + vertexPosition*size, 0.0, 1.0);
+}
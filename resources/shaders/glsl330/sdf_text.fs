@@ -0,0 +1,22 @@
+#version 330
+
+// Input vertex attributes (from vertex shader)
+in vec2 fragTexCoord;
+in vec4 fragColor;
+
+// Input uniform values
+uniform sampler2D texture0;     // distance field in alpha: 0.5 on the outline, more inside
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    float distance = texture(texture0, fragTexCoord).a - 0.5;
+
+    // The distance's change to the next pixel sets the ramp: one pixel wide at any scale
+    float ramp = max(length(vec2(dFdx(distance), dFdy(distance))), 1e-4);
+    float alpha = smoothstep(-ramp, ramp, distance);
+
+    finalColor = vec4(fragColor.rgb, fragColor.a*alpha);
+}
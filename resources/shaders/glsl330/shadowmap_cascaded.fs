@@ -0,0 +1,103 @@
+#version 330
+
+// Cascaded version of shadowmap.fs: one directional light, shadows from one of several
+// shadow map pages chosen by view depth (see CascadedShadows)
+
+// Input vertex attributes (from vertex shader)
+in vec3 fragPosition;
+in vec2 fragTexCoord;
+//in vec4 fragColor;
+in vec3 fragNormal;
+
+// Input uniform values
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Output fragment color
+out vec4 finalColor;
+
+// Input lighting values
+uniform vec3 lightDir;
+uniform vec4 lightColor;
+uniform vec4 ambient;
+uniform vec3 viewPos;
+uniform vec3 viewDir;               // Camera forward, for view depth
+
+// Input shadowmapping values
+#define CASCADES 3
+uniform mat4 lightVP[CASCADES];     // Light view-projection matrix of each page
+uniform vec3 cascadeSplits;         // View depth where each cascade ends
+uniform vec3 cascadeTexel;          // World size of a shadow map texel in each cascade
+uniform float shadowDepthRange;     // World depth covered by a page's [0, 1]
+uniform sampler2D shadowMap;        // Pages side by side
+
+uniform int shadowMapResolution;    // One page
+
+void main()
+{
+    // Texel color fetching from texture sampler
+    vec4 texelColor = texture(texture0, fragTexCoord);
+    vec3 lightDot = vec3(0.0);
+    vec3 normal = normalize(fragNormal);
+    vec3 viewD = normalize(viewPos - fragPosition);
+    vec3 specular = vec3(0.0);
+
+    vec3 l = -lightDir;
+
+    float NdotL = max(dot(normal, l), 0.0);
+    lightDot += lightColor.rgb*NdotL;
+
+    float specCo = 0.0;
+    if (NdotL > 0.0) specCo = pow(max(0.0, dot(viewD, reflect(-(l), normal))), 16.0); // 16 refers to shine
+    specular += specCo;
+
+    finalColor = (texelColor*((colDiffuse + vec4(specular, 1.0))*vec4(lightDot, 1.0)));
+
+    // Pick the first cascade that reaches this far; beyond the last there are no shadows
+    float depth = dot(fragPosition - viewPos, viewDir);
+    int cascade = CASCADES;
+    for (int i = CASCADES - 1; i >= 0; i--)
+    {
+        if (depth < cascadeSplits[i]) cascade = i;
+    }
+
+    if (cascade < CASCADES)
+    {
+        vec4 fragPosLightSpace = lightVP[cascade]*vec4(fragPosition, 1);
+        fragPosLightSpace.xyz /= fragPosLightSpace.w; // Perform the perspective division
+        fragPosLightSpace.xyz = (fragPosLightSpace.xyz + 1.0f)/2.0f; // Transform from [-1, 1] range to [0, 1] range
+        float curDepth = fragPosLightSpace.z;
+
+        // Slope-scaled bias in world units, since a far cascade's texels cover more ground
+        float bias = cascadeTexel[cascade]*(1.0 + 2.0*(1.0 - NdotL))/shadowDepthRange;
+
+        // Page coordinates into the atlas, kept a texel inside the page so PCF never reads a neighbor
+        float pageWidth = 1.0/float(CASCADES);
+        float texelWidth = pageWidth/float(shadowMapResolution);
+        vec2 texelSize = vec2(texelWidth, 1.0/float(shadowMapResolution));
+        vec2 sampleCoords = vec2((float(cascade) + fragPosLightSpace.x)*pageWidth, fragPosLightSpace.y);
+        float pageMin = float(cascade)*pageWidth + texelWidth;
+        float pageMax = float(cascade + 1)*pageWidth - texelWidth;
+
+        // PCF (percentage-closer filtering), as in shadowmap.fs
+        int shadowCounter = 0;
+        const int numSamples = 9;
+        for (int x = -1; x <= 1; x++)
+        {
+            for (int y = -1; y <= 1; y++)
+            {
+                vec2 coords = sampleCoords + texelSize*vec2(x, y);
+                coords.x = clamp(coords.x, pageMin, pageMax);
+                float sampleDepth = texture(shadowMap, coords).r;
+                if (curDepth - bias > sampleDepth) shadowCounter++;
+            }
+        }
+        finalColor = mix(finalColor, vec4(0, 0, 0, 1), float(shadowCounter)/float(numSamples));
+    }
+
+    // Add ambient lighting whether in shadow or not
+    finalColor += texelColor*(ambient/10.0)*colDiffuse;
+
+    // Gamma correction
+    finalColor = pow(finalColor, vec4(1.0/2.2));
+}
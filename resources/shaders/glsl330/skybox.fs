@@ -0,0 +1,24 @@
+#version 330
+
+#define RGBM_RANGE              8.0     // IblCache::C_RGBM_RANGE
+
+// Input vertex attributes (from vertex shader)
+in vec3 fragDirection;
+
+// Input uniform values
+uniform samplerCube environmentMap;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    vec4 rgbm = textureLod(environmentMap, fragDirection, 0.0);
+    vec3 color = rgbm.rgb*rgbm.a*RGBM_RANGE;
+
+    // Same tonemapping and gamma as pbr_ibl.fs
+    color = color/(color + vec3(1.0));
+    color = pow(color, vec3(1.0/2.2));
+
+    finalColor = vec4(color, 1.0);
+}
@@ -0,0 +1,20 @@
+#version 330
+
+// Input vertex attributes
+in vec3 vertexPosition;
+
+// Input uniform values
+uniform mat4 matProjection;
+uniform mat4 matView;
+
+// Output vertex attributes (to fragment shader)
+out vec3 fragDirection;
+
+void main()
+{
+    fragDirection = vertexPosition;
+
+    // The view's rotation only, and depth at the far plane
+    vec4 clipPos = matProjection*mat4(mat3(matView))*vec4(vertexPosition, 1.0);
+    gl_Position = clipPos.xyww;
+}
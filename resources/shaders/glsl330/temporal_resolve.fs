@@ -0,0 +1,68 @@
+#version 330
+
+// Temporal accumulation: this frame's jittered, reduced-resolution samples reconstructed at
+// the window pixel, blended into the history reprojected from where the same surface was
+// last frame. The history is clamped to the colour range of the samples around the pixel,
+// so what no longer belongs there (disocclusion, moving objects) can't linger
+
+// Input uniform values
+uniform sampler2D current;          // this frame, in the lower-left renderSize texels
+uniform sampler2D sceneDepth;
+uniform sampler2D history;          // window-size, last frame's result
+uniform ivec2 renderSize;
+uniform vec2 jitter;                // of this frame's samples, in render pixels
+uniform mat4 invViewProj;           // this frame's, jittered
+uniform mat4 viewProj;              // this frame's, unjittered
+uniform mat4 prevViewProj;          // last frame's, unjittered
+uniform float feedback;             // of the history kept; 0 drops it
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    vec2 outputUV = gl_FragCoord.xy/vec2(textureSize(history, 0));
+    vec2 renderPos = outputUV*vec2(renderSize);       // in render pixels
+    ivec2 centre = ivec2(floor(renderPos - jitter));
+
+    vec3 sum = vec3(0.0);
+    float weights = 0.0;
+    vec3 lo = vec3(1e9);
+    vec3 hi = vec3(-1e9);
+    float nearest = 1.0;
+    ivec2 nearestAt = centre;
+    for (int y = -1; y <= 1; y++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            ivec2 p = clamp(centre + ivec2(x, y), ivec2(0), renderSize - 1);
+            vec3 c = texelFetch(current, p, 0).rgb;
+            // Gaussian in the distance to where the sample was really taken
+            vec2 d = vec2(p) + 0.5 + jitter - renderPos;
+            float w = exp(-2.29*dot(d, d));
+            sum += c*w;
+            weights += w;
+            lo = min(lo, c);
+            hi = max(hi, c);
+
+            float z = texelFetch(sceneDepth, p, 0).r;
+            if (z < nearest) { nearest = z; nearestAt = p; }
+        }
+    }
+    vec3 color = sum/weights;
+
+    // The nearest surface around the pixel, back to the world and into both frames
+    vec2 ndc = (vec2(nearestAt) + 0.5)/vec2(renderSize)*2.0 - 1.0;
+    vec4 world = invViewProj*vec4(ndc, nearest*2.0 - 1.0, 1.0);
+    world /= world.w;
+    vec4 now = viewProj*world;
+    vec4 prev = prevViewProj*world;
+    vec2 historyUV = outputUV + (prev.xy/prev.w - now.xy/now.w)*0.5;
+
+    // Off screen last frame, or no history yet (whose texels may hold anything, NaN included)
+    bool outside = any(lessThan(historyUV, vec2(0.0))) || any(greaterThan(historyUV, vec2(1.0)));
+    if (outside || feedback <= 0.0) { finalColor = vec4(color, 1.0); return; }
+    vec3 past = clamp(texture(history, historyUV).rgb, lo, hi);
+
+    finalColor = vec4(mix(color, past, feedback), 1.0);
+}
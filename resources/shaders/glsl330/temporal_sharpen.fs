@@ -0,0 +1,27 @@
+#version 330
+
+// The accumulated history to the window, with a light unsharp mask over the four neighbours
+// for the detail the accumulation softens; clamped to their range so edges don't ring
+
+// Input uniform values
+uniform sampler2D resolved;
+uniform float sharpness;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    ivec2 last = textureSize(resolved, 0) - 1;
+    vec3 c = texelFetch(resolved, p, 0).rgb;
+    vec3 n = texelFetch(resolved, min(p + ivec2(0, 1), last), 0).rgb;
+    vec3 s = texelFetch(resolved, max(p - ivec2(0, 1), ivec2(0)), 0).rgb;
+    vec3 e = texelFetch(resolved, min(p + ivec2(1, 0), last), 0).rgb;
+    vec3 w = texelFetch(resolved, max(p - ivec2(1, 0), ivec2(0)), 0).rgb;
+
+    vec3 sharpened = c + sharpness*(4.0*c - n - s - e - w);
+    vec3 lo = min(c, min(min(n, s), min(e, w)));
+    vec3 hi = max(c, max(max(n, s), max(e, w)));
+    finalColor = vec4(clamp(sharpened, lo, hi), 1.0);
+}
@@ -0,0 +1,16 @@
+#version 430
+
+// Input vertex attributes (from vertex shader)
+in vec4 fragColor;
+
+// Output fragment color
+out vec4 finalColor;
+
+void main()
+{
+    // Points wider than a pixel are drawn as the disc inscribed in them
+    vec2 local = gl_PointCoord*2.0 - 1.0;
+    if (dot(local, local) > 1.0) discard;
+
+    finalColor = fragColor;
+}
@@ -0,0 +1,51 @@
+#version 430
+
+// GpuSwarm's bodies, straight from its storage buffers: one point per vertex, the
+// asteroids first, then the projectiles. No vertex attributes.
+struct Asteroid
+{
+    vec2 position;
+    vec2 velocity;
+    float radius;
+    uint hitBy;
+};
+
+struct Projectile
+{
+    vec2 position;
+    vec2 velocity;
+    float life;
+    uint pad;
+};
+
+layout(std430, binding = 0) readonly buffer Asteroids { Asteroid asteroids[]; };
+layout(std430, binding = 1) readonly buffer Projectiles { Projectile projectiles[]; };
+
+// Input uniform values
+uniform mat4 mvp;
+uniform int asteroidCount;
+uniform float pixelsPerUnit;
+uniform vec4 asteroidColor;
+uniform vec4 projectileColor;
+
+// Output vertex attributes (to fragment shader)
+out vec4 fragColor;
+
+void main()
+{
+    int i = gl_VertexID;
+    if (i < asteroidCount)
+    {
+        Asteroid a = asteroids[i];
+        gl_Position = mvp*vec4(a.position, 0.0, 1.0);
+        gl_PointSize = max(a.radius*2.0*pixelsPerUnit, 1.0);
+        fragColor = asteroidColor;
+    }
+    else
+    {
+        Projectile p = projectiles[i - asteroidCount];
+        gl_Position = mvp*vec4(p.position, 0.0, 1.0);
+        gl_PointSize = max(2.0*pixelsPerUnit, 1.0);
+        fragColor = projectileColor;
+    }
+}
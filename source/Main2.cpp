@@ -1,110 +1,1308 @@
-#include "raylib.h"
-#define RLIGHTS_IMPLEMENTATION
-#include "rlights.h"
-#include "raymath.h"
-
-#define GLSL_VERSION            330
-
-int main(void)
-{
-	const int screenWidth = 1280;
-	const int screenHeight = 720;
-
-	SetConfigFlags(FLAG_MSAA_4X_HINT);      // Enable Multi Sampling Anti Aliasing 4x (if available)
-
-	InitWindow(screenWidth, screenHeight, "raylib [shaders] example - model shader");
-
-	// Define the camera to look into our 3d world
-	Camera camera = { 0 };
-	camera.position = { 4.0f, 4.0f, 4.0f };    // Camera position
-	camera.target = { 0.0f, 1.0f, -1.0f };     // Camera looking at point
-	camera.up = { 0.0f, 1.0f, 0.0f };          // Camera up vector (rotation towards target)
-	camera.fovy = 45.0f;                                // Camera field-of-view Y
-	camera.projection = CAMERA_PERSPECTIVE;             // Camera projection type
-
-	Model model = LoadModel("../resources/models/watermill.obj"); // Load OBJ model
-	Texture2D texture = LoadTexture("../resources/models/watermill_diffuse.png"); // Load model texture
-
-	// Load shader for model
-	// NOTE: Defining 0 (NULL) for vertex shader forces usage of internal default vertex shader
-	Shader shader = LoadShader(TextFormat("../resources/shaders/glsl330/lighting.vs", GLSL_VERSION),
-														 TextFormat("../resources/shaders/glsl330/lighting.fs", GLSL_VERSION));
-
-	model.materials[0].shader = shader;                     // Set shader effect to 3d model
-	model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture; // Bind texture to model
-
-	Vector3 position = { 0.0f, 0.0f, 0.0f };    // Set model position
-	
-	// Ambient light level (some basic lighting)
-	int ambientLoc = GetShaderLocation(shader, "ambient");
-	float val_t[] { 0.1f, 0.1f, 0.1f, 1.0f };
-	SetShaderValue(shader, ambientLoc, val_t, SHADER_UNIFORM_VEC4);
-	
-	// Create lights
-	Light lights[MAX_LIGHTS] = { 0 };
-	lights[0] = CreateLight(LIGHT_POINT, { -4, 1, -4 }, Vector3Zero(), YELLOW, shader);
-	lights[1] = CreateLight(LIGHT_POINT, { 4, 1, 4 }, Vector3Zero(), RED, shader);
-	lights[2] = CreateLight(LIGHT_POINT, { -4, 1, 4 }, Vector3Zero(), GREEN, shader);
-	lights[3] = CreateLight(LIGHT_POINT, { 4, 1, -4 }, Vector3Zero(), BLUE, shader);
-
-	DisableCursor();                    // Limit cursor to relative movement inside the window
-	SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
-	//--------------------------------------------------------------------------------------
-
-	// Main game loop
-	while (!WindowShouldClose())        // Detect window close button or ESC key
-	{
-		// Update
-		//----------------------------------------------------------------------------------
-		UpdateCamera(&camera, CAMERA_FREE);
-		float cameraPos[3] = { camera.position.x, camera.position.y, camera.position.z };
-		SetShaderValue(shader, shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
-		
-		if (IsKeyPressed(KEY_Y)) { lights[0].enabled = !lights[0].enabled; }
-		if (IsKeyPressed(KEY_R)) { lights[1].enabled = !lights[1].enabled; }
-		if (IsKeyPressed(KEY_G)) { lights[2].enabled = !lights[2].enabled; }
-		if (IsKeyPressed(KEY_B)) { lights[3].enabled = !lights[3].enabled; }
-		
-		for (int i = 0; i < MAX_LIGHTS; i++) UpdateLightValues(shader, lights[i]);
-		//----------------------------------------------------------------------------------
-
-		// Draw
-		//----------------------------------------------------------------------------------
-		BeginDrawing();
-
-		ClearBackground(RAYWHITE);
-
-		BeginMode3D(camera);
-
-		DrawModel(model, position, 0.2f, WHITE);   // Draw 3d model with texture
-		
-		// Draw spheres to show where the lights are
-		for (int i = 0; i < MAX_LIGHTS; i++)
-		{
-			if (lights[i].enabled) DrawSphereEx(lights[i].position, 0.2f, 8, 8, lights[i].color);
-			else DrawSphereWires(lights[i].position, 0.2f, 8, 8, ColorAlpha(lights[i].color, 0.3f));
-		}
-
-		DrawGrid(10, 1.0f);     // Draw a grid
-
-		EndMode3D();
-
-		DrawText("(c) Watermill 3D model by Alberto Cano", screenWidth - 210, screenHeight - 20, 10, GRAY);
-
-		DrawFPS(10, 10);
-
-		EndDrawing();
-		//----------------------------------------------------------------------------------
-	}
-
-	// De-Initialization
-	//--------------------------------------------------------------------------------------
-	UnloadShader(shader);       // Unload shader
-	UnloadTexture(texture);     // Unload texture
-	UnloadModel(model);         // Unload model
-
-	CloseWindow();              // Close window and OpenGL context
-	//--------------------------------------------------------------------------------------
-
-	return 0;
-}
+#include "raylib.h"
+#define RLIGHTS_IMPLEMENTATION
+#include "rlights.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "shader_cache.h"
+#include "shader_reload.h"
+#include "shader_variants.h"
+#include "sampler_presets.h"
+#include "clustered_lights.h"
+#include "tiled_lights.h"
+#include "deferred_renderer.h"
+#include "cascaded_shadows.h"
+#include "instancing.h"
+#include "instance_culling.h"
+#include "render_queue.h"
+#include "asset_cache.h"
+#include "async_loader.h"
+#include "texture_streaming.h"
+#include "gpu_skinning.h"
+#include "animation_bake.h"
+#include "ibl_cache.h"
+#include "lightmap_baker.h"
+#include "depth_prepass.h"
+#include "gpu_profiler.h"
+#include "debug_gizmos.h"
+#include "static_batch.h"
+#include "hybrid_raymarch.h"
+#include "temporal_upsample.h"
+#include "light_assignment.h"
+#include "scene_traversal.h"
+#include "mesh_bvh.h"
+#include "vertex_compress.h"
+#include "meshlets.h"
+#include "material_batch.h"
+#include "sdf_text.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#define GLSL_VERSION            330
+#define FIREFLIES               256     // Extra point lights drawn by the clustered, tiled and deferred paths
+#define DISTRICT_TILES          24      // Ground tiles each way on the district path, 4 units apiece
+#define DISTRICT_LIGHTS         512     // Small point lights wandering over the district
+#define PROP_GRID               60      // Instanced path: one prop per cell of a PROP_GRID x PROP_GRID field
+#define PROP_SPACING            3.0f
+#define PROP_BLOCK              6       // Props per side of a block, the traversal's parent nodes
+#define PROP_KINDS              3       // Watermill, barracks, church
+#define ROBOTS                  8       // Skinned path: animated robots in a ring
+#define CROWD_GRID              32      // Crowd path: CROWD_GRID x CROWD_GRID robots
+
+// Lighting paths, cycled with TAB
+typedef enum {
+	PATH_FORWARD = 0,       // lighting.fs, the four lights only
+	PATH_CLUSTERED,         // lighting_clustered.fs, per-cluster light lists
+	PATH_TILED,             // lighting_tiled.fs, per-screen-tile light lists culled on worker threads
+	PATH_DEFERRED,          // G-buffer, light volumes, composite
+	PATH_SHADOWED,          // A sun with cascaded shadows over the watermill, barracks and church
+	PATH_INSTANCED,         // Thousands of props, culled and LOD-picked on the GPU (C toggles culling, H occlusion)
+	PATH_SKINNED,           // Animated robots skinned in the vertex shader (K toggles CPU skinning)
+	PATH_CROWD,             // A crowd of robots playing baked animations, one instanced draw per mesh
+	PATH_PBR,               // The old car under image-based lighting from cached IBL maps
+	PATH_LIGHTMAPPED,       // The village with its lighting baked into a lightmap, one fetch per pixel
+	PATH_HYBRID,            // Raymarched SDF shapes over the raster watermill, marched at an adaptive fraction of the resolution (U: adaptive/full)
+	PATH_DISTRICT,          // A wide district of tiles and crates under many small lights, each draw shading only the lights reaching it
+	PATH_COUNT
+} RenderPath;
+
+int main(void)
+{
+	const int screenWidth = 1280;
+	const int screenHeight = 720;
+
+	SetConfigFlags(FLAG_MSAA_4X_HINT);      // Enable Multi Sampling Anti Aliasing 4x (if available)
+
+	InitWindow(screenWidth, screenHeight, "raylib [shaders] example - model shader");
+
+	// Define the camera to look into our 3d world
+	Camera camera = { 0 };
+	camera.position = { 4.0f, 4.0f, 4.0f };    // Camera position
+	camera.target = { 0.0f, 1.0f, -1.0f };     // Camera looking at point
+	camera.up = { 0.0f, 1.0f, 0.0f };          // Camera up vector (rotation towards target)
+	camera.fovy = 45.0f;                                // Camera field-of-view Y
+	camera.projection = CAMERA_PERSPECTIVE;             // Camera projection type
+
+	// Models and textures stream in from the asset cache on worker threads, uploaded a few MB
+	// per frame; placeholder cubes and the default texture stand in until they arrive
+	// NOTE: Cooked (and mesh-optimized) on the first run, memory-mapped after that
+	Texture2D placeholderTexture = { rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+	Model model = LoadModelFromMesh(GenMeshCube(10.0f, 10.0f, 10.0f));
+	Texture2D texture = placeholderTexture;
+	Model barracks = LoadModelFromMesh(GenMeshCube(10.0f, 10.0f, 10.0f));
+	Texture2D barracksTexture = placeholderTexture;
+	Model church = LoadModelFromMesh(GenMeshCube(10.0f, 10.0f, 10.0f));
+	Texture2D churchTexture = placeholderTexture;
+
+	double loadStart = GetTime();
+	bool assetsChanged = false;
+	AsyncLoader loader;
+	loader.Start();
+	auto swapModel = [&](Model& slot, Model& loaded)
+	{
+		UnloadModel(slot);      // Frees the placeholder's meshes and maps, none of the textures bound to it
+		slot = loaded;
+		assetsChanged = true;
+	};
+	auto swapTexture = [&](Texture2D& slot, Texture2D& loaded)
+	{
+		slot = loaded;
+		assetsChanged = true;
+	};
+	loader.LoadModel("../resources/models/watermill.obj", [&](Model& m) { swapModel(model, m); });
+	loader.LoadTexture("../resources/models/watermill_diffuse.png", [&](Texture2D& t) { swapTexture(texture, t); });
+	loader.LoadModel("../resources/models/barracks.obj", [&](Model& m) { swapModel(barracks, m); });
+	loader.LoadTexture("../resources/models/barracks_diffuse.png", [&](Texture2D& t) { swapTexture(barracksTexture, t); });
+	loader.LoadModel("../resources/models/church.obj", [&](Model& m) { swapModel(church, m); });
+	loader.LoadTexture("../resources/models/church_diffuse.png", [&](Texture2D& t) { swapTexture(churchTexture, t); });
+
+	// Load shader for model, from the on-disk program cache when it has a binary for this driver
+	// NOTE: Defining 0 (NULL) for vertex shader forces usage of internal default vertex shader
+	Shader shader = ShaderCache::Load(TextFormat("../resources/shaders/glsl330/lighting.vs", GLSL_VERSION),
+														 TextFormat("../resources/shaders/glsl330/lighting.fs", GLSL_VERSION));
+
+	model.materials[0].shader = shader;                     // Set shader effect to 3d model
+	model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture; // Bind texture to model
+
+	Vector3 position = { 0.0f, 0.0f, 0.0f };    // Set model position
+	
+	// Ambient light level (some basic lighting)
+	int ambientLoc = GetShaderLocation(shader, "ambient");
+	float val_t[] { 0.1f, 0.1f, 0.1f, 1.0f };
+	SetShaderValue(shader, ambientLoc, val_t, SHADER_UNIFORM_VEC4);
+	
+	// Create lights
+	Light lights[MAX_LIGHTS] = { 0 };
+	lights[0] = CreateLight(LIGHT_POINT, { -4, 1, -4 }, Vector3Zero(), YELLOW, shader);
+	lights[1] = CreateLight(LIGHT_POINT, { 4, 1, 4 }, Vector3Zero(), RED, shader);
+	lights[2] = CreateLight(LIGHT_POINT, { -4, 1, 4 }, Vector3Zero(), GREEN, shader);
+	lights[3] = CreateLight(LIGHT_POINT, { 4, 1, -4 }, Vector3Zero(), BLUE, shader);
+
+	// Light values live in one uniform buffer for every shader, uploaded only when they change
+	InitLightBuffer();
+	BindLightBuffer(shader);
+	int lightUploads = 0;
+
+	// Swap in lighting.vs/fs whenever they are saved; compiled without stalling the frame
+	// NOTE: A new program starts with fresh locations and values, so fetch and send them again
+	ShaderWatcher watcher;
+	watcher.Watch(&shader, "../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting.fs", [&](Shader& fresh)
+	{
+		ambientLoc = GetShaderLocation(fresh, "ambient");
+		SetShaderValue(fresh, ambientLoc, val_t, SHADER_UNIFORM_VEC4);
+		BindLightBuffer(fresh);
+	});
+
+	// The forward path draws with a variant of lighting.fs built for the lights that are on,
+	// so no fragment tests a light's enabled flag or type (see ShaderVariants)
+	ShaderVariants forwardVariants;
+	forwardVariants.Init("../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting.fs", [&](Shader& s)
+	{
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), val_t, SHADER_UNIFORM_VEC4);
+		BindLightBuffer(s);
+	});
+	uint32_t forwardKey = 0;
+
+	// Clustered forward path: the same four lights plus FIREFLIES small ones, each fragment
+	// shading only the lights in its cluster
+	Shader clusteredShader = ShaderCache::Load("../resources/shaders/glsl330/lighting_clustered.vs", "../resources/shaders/glsl330/lighting_clustered.fs");
+	ClusteredLights clusters;
+	clusters.Init();
+	clusters.Attach(model.materials[0]);
+	auto bindClustered = [&](Shader& s)
+	{
+		clusters.Bind(s);
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), val_t, SHADER_UNIFORM_VEC4);
+	};
+	bindClustered(clusteredShader);
+	watcher.Watch(&clusteredShader, "../resources/shaders/glsl330/lighting_clustered.vs", "../resources/shaders/glsl330/lighting_clustered.fs", bindClustered);
+
+	// Tiled forward path: the same lights, listed per 16x16 pixel tile with no depth slices
+	Shader tiledShader = ShaderCache::Load("../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting_tiled.fs");
+	TiledLights tiles;
+	tiles.Init(screenWidth, screenHeight);
+	tiles.Attach(model.materials[0]);
+	auto bindTiled = [&](Shader& s)
+	{
+		tiles.Bind(s);
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), val_t, SHADER_UNIFORM_VEC4);
+	};
+	bindTiled(tiledShader);
+	watcher.Watch(&tiledShader, "../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting_tiled.fs", bindTiled);
+
+	struct Firefly { Vector3 center; float phase; float speed; Color color; };
+	std::vector<Firefly> fireflies(FIREFLIES);
+	for (Firefly& f : fireflies)
+	{
+		f.center = { (float)GetRandomValue(-500, 500)/100.0f, (float)GetRandomValue(20, 250)/100.0f, (float)GetRandomValue(-500, 500)/100.0f };
+		f.phase = (float)GetRandomValue(0, 628)/100.0f;
+		f.speed = (float)GetRandomValue(20, 100)/100.0f;
+		f.color = ColorFromHSV((float)GetRandomValue(0, 360), 0.8f, 1.0f);
+	}
+	std::vector<PointLight> pointLights;       // Fireflies
+	std::vector<PointLight> clusteredLights;   // Fireflies and the four lights, for the clustered and tiled paths
+
+	// Deferred path: the four lights read from the light buffer, fireflies as light volumes
+	DeferredRenderer deferred;
+	deferred.Init(GetRenderWidth(), GetRenderHeight());
+
+	// Hybrid path: the watermill rasterised, the SDF shapes raymarched at 1/scale resolution up
+	// to its depth and upsampled by it; the scale follows the march's GPU time unless U pins it at 1
+	HybridRaymarch hybrid;
+	hybrid.Init(GetRenderWidth(), GetRenderHeight());
+
+	// District path: ground tiles and crates spread over a wide area, lit by DISTRICT_LIGHTS
+	// small lights; each draw gets the list of lights reaching its bounding sphere
+	Shader assignedShader = ShaderCache::Load("../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting_assigned.fs");
+	LightAssignment assignment;
+	assignment.Init();
+	Model districtTile = LoadModelFromMesh(GenMeshPlane(4.0f, 4.0f, 1, 1));
+	Model districtCrate = LoadModelFromMesh(GenMeshCube(1.2f, 1.6f, 1.2f));
+	for (Model* m : { &districtTile, &districtCrate }) assignment.Attach(m->materials[0]);
+	auto bindAssigned = [&](Shader& s)
+	{
+		assignment.Bind(s);
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), val_t, SHADER_UNIFORM_VEC4);
+		districtTile.materials[0].shader = s;
+		districtCrate.materials[0].shader = s;
+	};
+	bindAssigned(assignedShader);
+	watcher.Watch(&assignedShader, "../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting_assigned.fs", bindAssigned);
+	const float districtHalf = DISTRICT_TILES*2.0f;
+	std::vector<Firefly> districtFlies(DISTRICT_LIGHTS);
+	for (Firefly& f : districtFlies)
+	{
+		f.center = { (float)GetRandomValue(-1000, 1000)/1000.0f*districtHalf, (float)GetRandomValue(30, 150)/100.0f, (float)GetRandomValue(-1000, 1000)/1000.0f*districtHalf };
+		f.phase = (float)GetRandomValue(0, 628)/100.0f;
+		f.speed = (float)GetRandomValue(20, 100)/100.0f;
+		f.color = ColorFromHSV((float)GetRandomValue(0, 360), 0.8f, 1.0f);
+	}
+	std::vector<PointLight> districtLights;
+	double assignMs = 0.0;
+
+	// Shadowed path: static buildings on a ground plane under one directional light
+	Model ground = LoadModelFromMesh(GenMeshPlane(40.0f, 40.0f, 1, 1));
+	barracks.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = barracksTexture;
+	church.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = churchTexture;
+
+	Shader shadowShader = ShaderCache::Load("../resources/shaders/glsl330/shadowmap.vs", "../resources/shaders/glsl330/shadowmap_cascaded.fs");
+	CascadedShadows sun;
+	sun.Init();
+	auto bindShadowed = [&](Shader& s)
+	{
+		sun.Bind(s);
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		float sunColor[4] = { 1.0f, 0.95f, 0.85f, 1.0f };
+		float sunAmbient[4] = { 2.0f, 2.0f, 2.2f, 1.0f };
+		SetShaderValue(s, GetShaderLocation(s, "lightColor"), sunColor, SHADER_UNIFORM_VEC4);
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), sunAmbient, SHADER_UNIFORM_VEC4);
+		barracks.materials[0].shader = s;
+		church.materials[0].shader = s;
+		ground.materials[0].shader = s;
+	};
+	bindShadowed(shadowShader);
+	watcher.Watch(&shadowShader, "../resources/shaders/glsl330/shadowmap.vs", "../resources/shaders/glsl330/shadowmap_cascaded.fs", bindShadowed);
+
+	// Shadow casters, drawn into the pages that need redrawing
+	// NOTE: Nothing here moves; a moving caster would call sun.MarkDirty()
+	auto drawVillage = [&]()
+	{
+		DrawModel(model, position, 0.2f, WHITE);
+		DrawModel(barracks, { 9.0f, 0.0f, -3.0f }, 0.2f, WHITE);
+		DrawModel(church, { -8.0f, 0.0f, -4.0f }, 0.2f, WHITE);
+	};
+	float sunAngle = 0.8f;
+
+	// Instanced path: a field of props, each kind's transforms contiguous in the ring so that
+	// every mesh is one draw call
+	Model* propModels[PROP_KINDS] = { &model, &barracks, &church };
+	std::vector<Matrix> props[PROP_KINDS];
+	for (int z = 0; z < PROP_GRID; z++)
+	{
+		for (int x = 0; x < PROP_GRID; x++)
+		{
+			Vector3 at = { (x - PROP_GRID/2)*PROP_SPACING + (float)GetRandomValue(-50, 50)/100.0f, 0.0f,
+						   (z - PROP_GRID/2)*PROP_SPACING + (float)GetRandomValue(-50, 50)/100.0f };
+			float yaw = (float)GetRandomValue(0, 628)/100.0f;
+			float scale = (float)GetRandomValue(15, 22)/100.0f;
+			Matrix transform = MatrixMultiply(MatrixMultiply(MatrixScale(scale, scale, scale), MatrixRotateY(yaw)), MatrixTranslate(at.x, at.y, at.z));
+			props[GetRandomValue(0, PROP_KINDS - 1)].push_back(transform);
+		}
+	}
+	InstanceRing propRing;
+	propRing.Init(PROP_GRID*PROP_GRID);
+	int propFirst[PROP_KINDS] = { 0 };
+	int propCount[PROP_KINDS] = { 0 };
+	for (int k = 0; k < PROP_KINDS; k++)
+	{
+		propCount[k] = (int)props[k].size();
+		if (k > 0) propFirst[k] = propFirst[k - 1] + propCount[k - 1];
+	}
+	InstanceCuller culler;     // Built once every model has loaded; it keeps pointers to them
+	bool culling = true;
+	bool propsReady = false;
+
+	Shader instancedShader = ShaderCache::Load("../resources/shaders/glsl330/lighting_instancing.vs", "../resources/shaders/glsl330/lighting.fs");
+	float propAmbient[4] = { 0.35f, 0.35f, 0.35f, 1.0f };  // Most of the field is out of the four lights' reach
+	auto bindInstanced = [&](Shader& s)
+	{
+		s.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(s, "instanceTransform");
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), propAmbient, SHADER_UNIFORM_VEC4);
+		BindLightBuffer(s);
+	};
+	bindInstanced(instancedShader);
+	watcher.Watch(&instancedShader, "../resources/shaders/glsl330/lighting_instancing.vs", "../resources/shaders/glsl330/lighting.fs", bindInstanced);
+
+	// Unculled, the three kinds can also go as one batch (Z): one vertex array, their diffuse
+	// maps as layers of one texture array, a layer per instance, one draw for the whole field
+	MaterialBatch propBatch;   // Built with the culler
+	bool batchOn = true;
+	Shader layeredShader = ShaderCache::Load("../resources/shaders/glsl330/lighting_layered.vs", "../resources/shaders/glsl330/lighting_layered.fs");
+	bindInstanced(layeredShader);
+	watcher.Watch(&layeredShader, "../resources/shaders/glsl330/lighting_layered.vs", "../resources/shaders/glsl330/lighting_layered.fs", bindInstanced);
+
+	// Or (I) the same field as a hierarchy, blocks of props, traversed on the job system's
+	// threads: transforms, frustum culling and LOD choice per prop, recorded into the render
+	// queue, which sorts and draws it; built with the culler, once the props have loaded
+	SceneGraph town;
+	Model townLods[PROP_KINDS][SceneGraph::C_LODS] = {};
+	bool traversalOn = false;
+	Shader traversedShader = ShaderCache::Load("../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting.fs");
+	auto bindTraversed = [&](Shader& s)
+	{
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), propAmbient, SHADER_UNIFORM_VEC4);
+		BindLightBuffer(s);
+		for (int k = 0; k < PROP_KINDS; k++)
+		{
+			for (Model& lod : townLods[k])
+			{
+				for (int m = 0; m < lod.materialCount; m++) lod.materials[m].shader = s;     // The LODs hold copies
+			}
+		}
+	};
+	bindTraversed(traversedShader);
+	watcher.Watch(&traversedShader, "../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/lighting.fs", bindTraversed);
+
+	// Skinned path: one robot model drawn ROBOTS times, each in its own animation and frame
+	// NOTE: Skinned models aren't cooked, so this is raylib's loader as it is
+	Model robot = LoadModel("../resources/models/robot.glb");
+	int robotAnimCount = 0;
+	ModelAnimation *robotAnims = LoadModelAnimations("../resources/models/robot.glb", &robotAnimCount);
+	GpuSkinning skin;
+	bool gpuSkinningReady = skin.Init(robot);
+	bool gpuSkinning = gpuSkinningReady;
+	Shader skinnedShader = ShaderCache::Load("../resources/shaders/glsl330/lighting_skinned.vs", "../resources/shaders/glsl330/lighting.fs");
+	auto bindSkinned = [&](Shader& s)
+	{
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), propAmbient, SHADER_UNIFORM_VEC4);
+		BindLightBuffer(s);
+		GpuSkinning::Bind(s);
+	};
+	bindSkinned(skinnedShader);
+	watcher.Watch(&skinnedShader, "../resources/shaders/glsl330/lighting_skinned.vs", "../resources/shaders/glsl330/lighting.fs", bindSkinned);
+	double skinningMs = 0.0;
+	int skinningBytes = 0;
+
+	// Crowd path: every clip baked into a texture, each robot picking a clip and time offset
+	BakedAnimations baked;
+	bool crowdReady = gpuSkinningReady && baked.Bake(robot, robotAnims, robotAnimCount);
+	std::vector<Matrix> crowd;
+	for (int z = 0; z < CROWD_GRID; z++)
+	{
+		for (int x = 0; x < CROWD_GRID; x++)
+		{
+			Matrix transform = MatrixMultiply(MatrixMultiply(MatrixScale(0.3f, 0.3f, 0.3f), MatrixRotateY((float)GetRandomValue(0, 628)/100.0f)),
+											  MatrixTranslate((x - CROWD_GRID/2)*1.5f, 0.0f, (z - CROWD_GRID/2)*1.5f));
+			crowd.push_back(BakedAnimations::Tag(transform, GetRandomValue(0, (baked.Clips() > 0)? baked.Clips() - 1 : 0), (float)GetRandomValue(0, 500)/100.0f));
+		}
+	}
+	InstanceRing crowdRing;
+	crowdRing.Init(CROWD_GRID*CROWD_GRID);
+	for (int m = 0; m < robot.materialCount && crowdReady; m++) baked.Attach(robot.materials[m]);
+	Shader crowdShader = ShaderCache::Load("../resources/shaders/glsl330/crowd_skinned.vs", "../resources/shaders/glsl330/lighting.fs");
+	int crowdTimeLoc = -1;
+	auto bindCrowd = [&](Shader& s)
+	{
+		s.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(s, "instanceTransform");
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		SetShaderValue(s, GetShaderLocation(s, "ambient"), propAmbient, SHADER_UNIFORM_VEC4);
+		BindLightBuffer(s);
+		baked.Bind(s);
+		crowdTimeLoc = GetShaderLocation(s, "animationTime");
+	};
+	bindCrowd(crowdShader);
+	watcher.Watch(&crowdShader, "../resources/shaders/glsl330/crowd_skinned.vs", "../resources/shaders/glsl330/lighting.fs", bindCrowd);
+
+	// PBR path: the car's albedo/MRA/normal/emissive maps, the four lights and an environment
+	// from the IBL cache (generated and saved as DDS on the first run, only loaded after that)
+	IblCache::Maps ibl = IblCache::Load();
+	Model car = AssetCache::LoadModel("../resources/models/old_car_new.glb");
+
+	// The maps stream in: their 64x64 levels first, then as much detail as the car's size on
+	// screen asks for, within TEXTURE_BUDGET bytes. They are block-compressed where the driver
+	// allows, cooked to DDS on the first run (the four full chains take about 22 MB as RGBA8, a
+	// quarter of that as BC7/BC5)
+	const size_t TEXTURE_BUDGET = 12u << 20;
+	TextureStreamer streamer;
+	streamer.Init(TEXTURE_BUDGET);
+	const char* carTextureFiles[4] = { "../resources/old_car_d.png", "../resources/old_car_mra.png", "../resources/old_car_n.png", "../resources/old_car_e.png" };
+	const int carMaps[4] = { MATERIAL_MAP_ALBEDO, MATERIAL_MAP_METALNESS, MATERIAL_MAP_NORMAL, MATERIAL_MAP_EMISSION };
+	const TextureCompress::Usage carUsages[4] = { TextureCompress::C_COLOR, TextureCompress::C_COLOR, TextureCompress::C_NORMAL, TextureCompress::C_COLOR };
+	TextureStreamer::Handle carTextures[4] = { 0 };
+	for (int i = 0; i < 4; i++) carTextures[i] = streamer.Load(loader, carTextureFiles[i], carUsages[i]);
+	BoundingBox carBounds = GetModelBoundingBox(car);
+
+	// Its meshes in the compact vertex layout pbr.vs and the pre-pass decode; N puts the floats back
+	VertexCompression compactVertices;
+	bool compactOn = compactVertices.Compact(car);
+
+	// Its triangles clustered into meshlets (cooked into the asset cache), those outside the view
+	// or facing wholly away culled each frame before the draw; X draws every triangle again
+	MeshletCuller carMeshlets;
+	carMeshlets.Init("../resources/models/old_car_new.glb", car);
+	bool meshletsOn = true;
+	Vector3 carCentre = Vector3Scale(Vector3Lerp(carBounds.min, carBounds.max, 0.5f), 0.25f);
+	float carRadius = Vector3Distance(carBounds.min, carBounds.max)*0.5f*0.25f;
+	for (int m = 0; m < car.materialCount; m++)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			car.materials[m].maps[carMaps[i]].texture = placeholderTexture;
+			streamer.Bind(carTextures[i], &car.materials[m].maps[carMaps[i]].texture);
+		}
+		car.materials[m].maps[MATERIAL_MAP_IRRADIANCE].texture = ibl.irradiance;
+		car.materials[m].maps[MATERIAL_MAP_PREFILTER].texture = ibl.prefiltered;
+		car.materials[m].maps[MATERIAL_MAP_BRDF].texture = ibl.brdf;
+	}
+	Shader pbrShader = ShaderCache::Load("../resources/shaders/glsl330/pbr.vs", "../resources/shaders/glsl330/pbr_ibl.fs");
+	auto bindPbr = [&](Shader& s)
+	{
+		s.locs[SHADER_LOC_MAP_ALBEDO] = GetShaderLocation(s, "albedoMap");
+		s.locs[SHADER_LOC_MAP_METALNESS] = GetShaderLocation(s, "mraMap");
+		s.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(s, "normalMap");
+		s.locs[SHADER_LOC_MAP_EMISSION] = GetShaderLocation(s, "emissiveMap");
+		s.locs[SHADER_LOC_MAP_IRRADIANCE] = GetShaderLocation(s, "irradianceMap");
+		s.locs[SHADER_LOC_MAP_PREFILTER] = GetShaderLocation(s, "prefilterMap");
+		s.locs[SHADER_LOC_MAP_BRDF] = GetShaderLocation(s, "brdfLUT");
+		s.locs[SHADER_LOC_VECTOR_VIEW] = GetShaderLocation(s, "viewPos");
+		int on = 1;
+		for (const char *name : { "useTexAlbedo", "useTexNormal", "useTexMRA", "useTexEmissive" }) SetShaderValue(s, GetShaderLocation(s, name), &on, SHADER_UNIFORM_INT);
+		float tiling[2] = { 0.5f, 0.5f };   // pbr.vs doubles the texture coordinates
+		float offset[2] = { 0.0f, 0.0f };
+		float albedoColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		float emissiveColor[4] = { 1.0f, 0.64f, 0.0f, 1.0f };
+		float values[5] = { 0.0f, 0.0f, 1.0f, 0.01f, 4.0f };  // Metallic, roughness, ao, emissive power, light intensity
+		SetShaderValue(s, GetShaderLocation(s, "tiling"), tiling, SHADER_UNIFORM_VEC2);
+		SetShaderValue(s, GetShaderLocation(s, "offset"), offset, SHADER_UNIFORM_VEC2);
+		SetShaderValue(s, GetShaderLocation(s, "albedoColor"), albedoColor, SHADER_UNIFORM_VEC4);
+		SetShaderValue(s, GetShaderLocation(s, "emissiveColor"), emissiveColor, SHADER_UNIFORM_VEC4);
+		SetShaderValue(s, GetShaderLocation(s, "metallicValue"), &values[0], SHADER_UNIFORM_FLOAT);
+		SetShaderValue(s, GetShaderLocation(s, "roughnessValue"), &values[1], SHADER_UNIFORM_FLOAT);
+		SetShaderValue(s, GetShaderLocation(s, "aoValue"), &values[2], SHADER_UNIFORM_FLOAT);
+		SetShaderValue(s, GetShaderLocation(s, "emissivePower"), &values[3], SHADER_UNIFORM_FLOAT);
+		SetShaderValue(s, GetShaderLocation(s, "lightIntensity"), &values[4], SHADER_UNIFORM_FLOAT);
+		BindLightBuffer(s);
+		for (int m = 0; m < car.materialCount; m++) car.materials[m].shader = s;
+	};
+	bindPbr(pbrShader);
+	watcher.Watch(&pbrShader, "../resources/shaders/glsl330/pbr.vs", "../resources/shaders/glsl330/pbr_ibl.fs", bindPbr);
+
+	// The environment itself behind the car, from the prefiltered map's sharpest level
+	Model skybox = LoadModelFromMesh(GenMeshCube(1.0f, 1.0f, 1.0f));
+	Shader skyboxShader = ShaderCache::Load("../resources/shaders/glsl330/skybox.vs", "../resources/shaders/glsl330/skybox.fs");
+	auto bindSkybox = [&](Shader& s)
+	{
+		s.locs[SHADER_LOC_MAP_CUBEMAP] = GetShaderLocation(s, "environmentMap");
+		skybox.materials[0].shader = s;
+	};
+	bindSkybox(skyboxShader);
+	watcher.Watch(&skyboxShader, "../resources/shaders/glsl330/skybox.vs", "../resources/shaders/glsl330/skybox.fs", bindSkybox);
+	skybox.materials[0].maps[MATERIAL_MAP_CUBEMAP].texture = ibl.prefiltered;
+
+	// Lightmapped path: the village, ground included, baked under the four lights and a sun once
+	// every model has loaded (mapped from the asset cache after the first run)
+	// NOTE: Baked light doesn't follow the light toggles; a changed scene bakes again on the next run
+	Model* villageModels[4] = { &model, &barracks, &church, &ground };
+	Texture2D* villageTextures[4] = { &texture, &barracksTexture, &churchTexture, &placeholderTexture };
+	Matrix villageTransforms[4] = {
+		MatrixMultiply(MatrixScale(0.2f, 0.2f, 0.2f), MatrixTranslate(position.x, position.y, position.z)),
+		MatrixMultiply(MatrixScale(0.2f, 0.2f, 0.2f), MatrixTranslate(9.0f, 0.0f, -3.0f)),
+		MatrixMultiply(MatrixScale(0.2f, 0.2f, 0.2f), MatrixTranslate(-8.0f, 0.0f, -4.0f)),
+		MatrixIdentity()
+	};
+	Lightmap::Scene village;
+	Shader lightmapShader = ShaderCache::Load("../resources/shaders/glsl330/lightmap.vs", "../resources/shaders/glsl330/lightmap.fs");
+	auto bindLightmapped = [&](Shader& s)
+	{
+		for (Model& m : village.models)
+		{
+			for (int i = 0; i < m.materialCount; i++) m.materials[i].shader = s;
+		}
+	};
+	watcher.Watch(&lightmapShader, "../resources/shaders/glsl330/lightmap.vs", "../resources/shaders/glsl330/lightmap.fs", bindLightmapped);
+
+	// Shadowed path: the screen centre picked against BVHs over the watermill, barracks and church,
+	// built once they have loaded; V times the same ray against every triangle once
+	const char* pickNames[3] = { "watermill", "barracks", "church" };
+	ModelBvh pickBvhs[3];
+	SceneBvh pickScene;
+	SceneBvh::Hit pick = {};
+	bool pickSunlit = false;
+	float pickMs = 0.0f;
+	float bruteMs = -1.0f;
+
+	RenderPath path = PATH_CLUSTERED;
+
+	// Light positions, drawn over the lit scene by every path as instanced gizmos; L adds
+	// each light's range, the sun's direction and the car's streaming bounds
+	GizmoBatch gizmos;
+	gizmos.Init();
+	bool gizmoView = false;
+	StaticBatch grid;       // DrawGrid's lines, captured the first time and replayed after that
+	auto drawMarkers = [&]()
+	{
+		for (int i = 0; i < MAX_LIGHTS; i++)
+		{
+			if (lights[i].enabled) gizmos.Sphere(lights[i].position, 0.2f, lights[i].color);
+			else gizmos.WireSphere(lights[i].position, 0.2f, ColorAlpha(lights[i].color, 0.3f));
+			if (gizmoView && lights[i].enabled) gizmos.WireSphere(lights[i].position, 12.0f, ColorAlpha(lights[i].color, 0.3f));
+		}
+		if (path != PATH_FORWARD)
+		{
+			for (const PointLight& l : pointLights)
+			{
+				gizmos.Sphere(l.position, 0.03f, l.color);
+				if (gizmoView) gizmos.WireSphere(l.position, l.radius, ColorAlpha(l.color, 0.3f));
+			}
+		}
+		if (gizmoView && path == PATH_SHADOWED) gizmos.Arrow({ 0.0f, 6.0f, 0.0f }, { cosf(sunAngle)*1.2f, 4.0f, sinf(sunAngle)*1.2f }, ORANGE);
+		if (path == PATH_SHADOWED && pick.collision.hit)
+		{
+			gizmos.Sphere(pick.collision.point, 0.08f, pickSunlit? YELLOW : DARKBLUE);
+			gizmos.Arrow(pick.collision.point, Vector3Add(pick.collision.point, pick.collision.normal), MAGENTA);
+		}
+		if (gizmoView && path == PATH_PBR) gizmos.WireBox({ Vector3Subtract(carCentre, { carRadius, carRadius, carRadius }), Vector3Add(carCentre, { carRadius, carRadius, carRadius }) }, SKYBLUE);
+		gizmos.Flush();
+
+		if (grid.Captured()) grid.Draw();
+		else grid.Capture(64, []() { DrawGrid(10, 1.0f); });     // Draw a grid
+	};
+
+	// The opaque geometry of the paths drawn plainly with DrawModel, through `draw`: DrawModel
+	// itself for the lit pass, or the depth pre-pass's stand-in for its passes
+	auto plainPath = [&]()
+	{
+		return path == PATH_FORWARD || path == PATH_CLUSTERED || path == PATH_TILED || path == PATH_SHADOWED || path == PATH_PBR || path == PATH_LIGHTMAPPED;
+	};
+	auto drawOpaque = [&](auto draw)
+	{
+		if (path == PATH_SHADOWED || (path == PATH_LIGHTMAPPED && village.models.empty()))
+		{
+			if (path == PATH_SHADOWED) draw(ground, Vector3Zero(), 1.0f, LIGHTGRAY);
+			draw(model, position, 0.2f, WHITE);
+			draw(barracks, { 9.0f, 0.0f, -3.0f }, 0.2f, WHITE);
+			draw(church, { -8.0f, 0.0f, -4.0f }, 0.2f, WHITE);
+		}
+		else if (path == PATH_LIGHTMAPPED)
+		{
+			// Nothing is lit per frame; each model carries the transform it was baked with
+			for (const Model& m : village.models) draw(m, Vector3Zero(), 1.0f, WHITE);
+		}
+		else if (path == PATH_PBR)
+		{
+			draw(car, Vector3Zero(), 0.25f, WHITE);     // Culled by drawPlainScene's carMeshlets.Begin
+		}
+		else draw(model, position, 0.2f, WHITE);    // Draw 3d model with texture
+	};
+
+	// Depth pre-pass (P) so the lit pass shades each pixel once, and an overdraw heatmap (O) of
+	// the fragments it shades, for the plain paths; the lit pass's cost is counted either way
+	DepthPrepass prepass;
+	prepass.Init(GetRenderWidth(), GetRenderHeight());
+	bool prepassOn = false;
+	bool overdrawView = false;
+
+	// The plain paths' lit pass goes through a render queue, sorted by shader, material and mesh
+	// so each changes only when it must (J draws them in submission order instead)
+	RenderQueue queue;
+	bool queueOn = true;
+	auto drawStandIns = [&]()
+	{
+		drawOpaque([&](const Model& m, Vector3 at, float scale, Color tint) { prepass.Draw(m, at, scale, tint); });
+	};
+
+	// GPU time per pass, read back a few frames late and shown beside the frame rate
+	GpuProfiler& gpu = GpuProfiler::Instance();
+	gpu.Init();
+
+	// The overlay's text (font texture) and lines (shapes texture) regrouped by texture inside the
+	// rlgl batch, a draw call each instead of one per switch; F keeps submission order
+	bool bucketsOn = true;
+	rlFrameStats frameStats = { 0 };    // rlgl counters of the last frame
+
+	// The overlay's lines as cached runs of distance field text: only a line that changed is
+	// rebuilt, and all of them draw at once; F1 goes back to DrawText
+	SdfText overlayText;
+	bool sdfTextOn = overlayText.LoadDefault();
+	auto overlayLine = [&](const char* text, int x, int y, int size, Color color)
+	{
+		if (sdfTextOn) overlayText.Draw(text, Vector2{ (float)x, (float)y }, (float)size, (float)(size/10), color);    // DrawText's spacing
+		else DrawText(text, x, y, size, color);
+	};
+
+	// The plain paths' whole 3D scene, inside BeginMode3D: the PBR skybox, the pre-pass, the lit
+	// pass and the markers
+	auto drawPlainScene = [&]()
+	{
+		if (path == PATH_PBR)
+		{
+			// Depth is written at the far plane, where LEQUAL still lets the scene over it
+			rlDisableBackfaceCulling();
+			rlDisableDepthMask();
+			DrawModel(skybox, Vector3Zero(), 1.0f, WHITE);
+			rlEnableBackfaceCulling();
+			rlEnableDepthMask();
+		}
+
+		// The car's meshes report the culled triangle counts from here to End, so a queued draw
+		// still has them when the queue flushes
+		const bool culledCar = path == PATH_PBR && meshletsOn;
+		if (culledCar) carMeshlets.Begin(car);
+
+		if (prepassOn)
+		{
+			gpu.Begin("pre-pass");
+			prepass.BeginPrepass();
+			drawStandIns();
+			prepass.EndPrepass();
+			gpu.End();
+		}
+		prepass.BeginCount();
+		if (queueOn)
+		{
+			drawOpaque([&](const Model& m, Vector3 at, float scale, Color tint) { queue.Add(m, at, scale, tint); });
+			queue.Flush();
+		}
+		else drawOpaque(DrawModel);
+		prepass.EndCount();
+		if (prepassOn) prepass.EndShading();
+		if (culledCar) carMeshlets.End(car);
+
+		if ((path != PATH_SHADOWED && path != PATH_LIGHTMAPPED) || gizmoView) drawMarkers();      // Draw spheres to show where the lights are
+	};
+
+	// The PBR path's scene at a share of the window's resolution (LEFT/RIGHT BRACKET), jittered
+	// and accumulated into a full-resolution history each frame, then sharpened (T turns it off)
+	TemporalUpsampler temporal;
+	temporal.Init(GetRenderWidth(), GetRenderHeight());
+	bool temporalOn = true;
+
+	DisableCursor();                    // Limit cursor to relative movement inside the window
+	SetTargetFPS(60);                   // Set our game to run at 60 frames-per-second
+	//--------------------------------------------------------------------------------------
+
+	// Main game loop
+	while (!WindowShouldClose())        // Detect window close button or ESC key
+	{
+		// Update
+		//----------------------------------------------------------------------------------
+		gpu.BeginFrame();
+		watcher.Poll();
+		forwardVariants.Poll();
+		loader.Pump();
+		if (path == PATH_PBR && meshletsOn)
+		{
+			Matrix viewProjection = MatrixMultiply(GetCameraMatrix(camera), MatrixPerspective(camera.fovy*DEG2RAD, (double)GetRenderWidth()/(double)GetRenderHeight(), RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR));
+			carMeshlets.Cull(car, MatrixMultiply(car.transform, MatrixScale(0.25f, 0.25f, 0.25f)), viewProjection, camera.position);
+		}
+		if (path == PATH_PBR)
+		{
+			for (int i = 0; i < 4; i++) streamer.Request(carTextures[i], TextureStreamer::ScreenPixels(camera, carCentre, carRadius, screenHeight));
+		}
+		streamer.Update();
+		if (assetsChanged)
+		{
+			// Rebind whatever the swapped-in assets need
+			model.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = texture;
+			clusters.Attach(model.materials[0]);
+			tiles.Attach(model.materials[0]);
+			barracks.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = barracksTexture;
+			church.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = churchTexture;
+			for (Texture2D t : { texture, barracksTexture, churchTexture })
+			{
+				if (t.id != placeholderTexture.id) SamplerPresets::Instance().Register(t, SamplerPresets::Class::SURFACE);
+			}
+			barracks.materials[0].shader = shadowShader;
+			church.materials[0].shader = shadowShader;
+			sun.MarkDirty();
+			assetsChanged = false;
+		}
+		if (!propsReady && loader.Outstanding() == 0)
+		{
+			culler.Init(propModels, PROP_KINDS, propRing.Capacity());
+			culler.InitOcclusion(screenWidth, screenHeight);
+			culler.SetOcclusion(true);
+			propBatch.Init(propModels, PROP_KINDS, propRing.Capacity());
+			const float blockSize = PROP_BLOCK*PROP_SPACING;
+			const int blocks = (PROP_GRID + PROP_BLOCK - 1)/PROP_BLOCK;
+			for (int b = 0; b < blocks*blocks; b++)
+			{
+				Vector3 centre = { ((b%blocks) + 0.5f)*blockSize - PROP_GRID/2*PROP_SPACING, 0.0f, ((b/blocks) + 0.5f)*blockSize - PROP_GRID/2*PROP_SPACING };
+				town.Add(-1, MatrixTranslate(centre.x, centre.y, centre.z));   // Blocks are nodes 0 to blocks*blocks - 1
+			}
+			for (int k = 0; k < PROP_KINDS; k++)
+			{
+				const Model* lods[SceneGraph::C_LODS];
+				for (int l = 0; l < SceneGraph::C_LODS; l++)
+				{
+					townLods[k][l] = LoadLodModel(*propModels[k], InstanceCuller::C_LOD_CELLS[l], traversedShader);
+					lods[l] = &townLods[k][l];
+				}
+				BoundingBox bounds = GetModelBoundingBox(*propModels[k]);
+				Vector4 sphere = { (bounds.min.x + bounds.max.x)*0.5f, (bounds.min.y + bounds.max.y)*0.5f, (bounds.min.z + bounds.max.z)*0.5f, Vector3Distance(bounds.min, bounds.max)*0.5f };
+				for (const Matrix& transform : props[k])
+				{
+					int bx = Clamp((int)((transform.m12 + PROP_GRID/2*PROP_SPACING)/blockSize), 0, blocks - 1);
+					int bz = Clamp((int)((transform.m14 + PROP_GRID/2*PROP_SPACING)/blockSize), 0, blocks - 1);
+					Matrix parent = town.World(bz*blocks + bx);
+					town.Add(bz*blocks + bx, MatrixMultiply(transform, MatrixInvert(parent)), lods, sphere);
+				}
+			}
+			for (int k = 0; k < 3; k++)
+			{
+				pickBvhs[k].Build(*villageModels[k]);
+				pickScene.Add(pickBvhs[k], *villageModels[k], villageTransforms[k], k);
+			}
+			pickScene.Build();
+			propsReady = true;
+			TraceLog(LOG_INFO, "ASYNC: 6 assets in %.1f ms, %i cache hit(s), %i miss(es)", (GetTime() - loadStart)*1000.0, AssetCache::Counters().hits.load(), AssetCache::Counters().misses.load());
+
+			Light bakedLights[MAX_LIGHTS + 1] = { 0 };
+			for (int i = 0; i < MAX_LIGHTS; i++) bakedLights[i] = lights[i];
+			bakedLights[MAX_LIGHTS] = { LIGHT_DIRECTIONAL, true, { cosf(sunAngle)*-0.6f, 1.0f, sinf(sunAngle)*-0.6f }, Vector3Zero(), { 200, 190, 170, 255 } };
+			village = Lightmap::Bake(villageModels, villageTransforms, 4, bakedLights, MAX_LIGHTS + 1);
+			for (int k = 0; k < (int)village.models.size(); k++)
+			{
+				Model& m = village.models[k];
+				m.transform = villageTransforms[k];
+				for (int i = 0; i < m.materialCount; i++)
+				{
+					m.materials[i].maps[MATERIAL_MAP_DIFFUSE].texture = *villageTextures[k];
+					m.materials[i].maps[MATERIAL_MAP_SPECULAR].texture = village.lightmap;     // texture1 in lightmap.fs
+				}
+			}
+			bindLightmapped(lightmapShader);
+		}
+		UpdateCamera(&camera, CAMERA_FREE);
+		float cameraPos[3] = { camera.position.x, camera.position.y, camera.position.z };
+		SetShaderValue(shader, shader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+		SetShaderValue(clusteredShader, clusteredShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+		SetShaderValue(tiledShader, tiledShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+		
+		if (IsKeyPressed(KEY_TAB))
+		{
+			path = (RenderPath)((path + 1)%PATH_COUNT);
+			temporal.Reset();       // Its history is of another scene
+		}
+		if (IsKeyPressed(KEY_Y)) { lights[0].enabled = !lights[0].enabled; }
+		if (IsKeyPressed(KEY_R)) { lights[1].enabled = !lights[1].enabled; }
+		if (IsKeyPressed(KEY_G)) { lights[2].enabled = !lights[2].enabled; }
+		if (IsKeyPressed(KEY_B)) { lights[3].enabled = !lights[3].enabled; }
+		if (IsKeyPressed(KEY_C)) culling = !culling;
+		if (IsKeyPressed(KEY_I)) traversalOn = !traversalOn;
+		if (IsKeyPressed(KEY_Z)) batchOn = !batchOn;
+		if (IsKeyDown(KEY_M) && traversalOn && propsReady)
+		{
+			// Spins the middle block: only it and its props are recomputed
+			const int blocks = (PROP_GRID + PROP_BLOCK - 1)/PROP_BLOCK;
+			const int middle = (blocks/2)*blocks + blocks/2;
+			town.SetLocal(middle, MatrixMultiply(MatrixRotateY(GetFrameTime()), town.Local(middle)));
+		}
+		if (IsKeyPressed(KEY_H) && propsReady) culler.SetOcclusion(!culler.Occlusion());
+		if (IsKeyPressed(KEY_P)) prepassOn = !prepassOn;
+		if (IsKeyPressed(KEY_O)) overdrawView = !overdrawView;
+		if (IsKeyPressed(KEY_J)) queueOn = !queueOn;
+		if (IsKeyPressed(KEY_L)) gizmoView = !gizmoView;
+		if (IsKeyPressed(KEY_U)) hybrid.SetAdaptive(!hybrid.Adaptive());
+		if (IsKeyPressed(KEY_N))
+		{
+			if (compactOn) compactVertices.Expand(car);
+			else compactVertices.Compact(car);
+			compactOn = !compactOn;
+		}
+		if (IsKeyPressed(KEY_X))
+		{
+			meshletsOn = !meshletsOn;
+			if (!meshletsOn) carMeshlets.Uncull(car);
+		}
+		if (IsKeyPressed(KEY_T)) { temporalOn = !temporalOn; temporal.Reset(); }
+		if (IsKeyPressed(KEY_F)) bucketsOn = !bucketsOn;
+		if (IsKeyPressed(KEY_F1) && overlayText.Ready()) sdfTextOn = !sdfTextOn;
+		if (IsKeyPressed(KEY_F2)) SamplerPresets::Instance().SetTier((SamplerPresets::Instance().Tier() + 1)%SamplerPresets::C_TIERS);
+		if (IsKeyPressed(KEY_LEFT_BRACKET)) temporal.SetScale(temporal.Scale() - 0.1f);
+		if (IsKeyPressed(KEY_RIGHT_BRACKET)) temporal.SetScale(temporal.Scale() + 0.1f);
+		if (IsKeyPressed(KEY_K) && gpuSkinningReady)
+		{
+			gpuSkinning = !gpuSkinning;
+			if (gpuSkinning) GpuSkinning::RestoreBindPose(robot);     // Undo the CPU's last pose
+		}
+		if (IsKeyDown(KEY_COMMA)) sunAngle -= GetFrameTime();
+		if (IsKeyDown(KEY_PERIOD)) sunAngle += GetFrameTime();
+		
+		pointLights.clear();
+		float time = (float)GetTime();
+		for (Firefly& f : fireflies)
+		{
+			float t = f.phase + time*f.speed;
+			Vector3 drift = { cosf(t)*0.6f, sinf(t*1.7f)*0.2f, sinf(t)*0.6f };
+			pointLights.push_back({ Vector3Add(f.center, drift), 1.2f, f.color });
+		}
+
+		if (path == PATH_DISTRICT)
+		{
+			districtLights.clear();
+			for (Firefly& f : districtFlies)
+			{
+				float t = f.phase + time*f.speed;
+				districtLights.push_back({ Vector3Add(f.center, { cosf(t)*1.5f, sinf(t*1.7f)*0.3f, sinf(t)*1.5f }), 2.5f, f.color });
+			}
+			assignment.Update(districtLights);
+			SetShaderValue(assignedShader, assignedShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+		}
+
+		if (path == PATH_CLUSTERED || path == PATH_TILED)
+		{
+			clusteredLights.clear();
+			for (int i = 0; i < MAX_LIGHTS; i++)
+			{
+				if (lights[i].enabled) clusteredLights.push_back({ lights[i].position, 12.0f, lights[i].color });
+			}
+			clusteredLights.insert(clusteredLights.end(), pointLights.begin(), pointLights.end());
+			if (path == PATH_CLUSTERED)
+			{
+				clusters.Update(clusteredLights, camera, GetRenderWidth(), GetRenderHeight(), clusteredShader);
+				model.materials[0].shader = clusteredShader;
+			}
+			else
+			{
+				tiles.Update(clusteredLights, camera, GetRenderWidth(), GetRenderHeight(), tiledShader);
+				model.materials[0].shader = tiledShader;
+			}
+		}
+		else
+		{
+			lightUploads = UpdateLightBuffer(lights, MAX_LIGHTS);
+			if (path == PATH_FORWARD)
+			{
+				ShaderVariants::Features features;
+				for (int i = 0; i < MAX_LIGHTS; i++) features.SetLight(i, lights[i].enabled, lights[i].type == LIGHT_POINT);
+				Shader variant = forwardVariants.Get(features);
+				SetShaderValue(variant, variant.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+				model.materials[0].shader = variant;
+				forwardKey = features.Key();
+			}
+			else model.materials[0].shader = (path == PATH_DEFERRED)? deferred.GeometryShader() : shader;
+		}
+
+		if (path == PATH_SHADOWED)
+		{
+			model.materials[0].shader = shadowShader;
+			SetShaderValue(shadowShader, shadowShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+			sun.SetLight({ cosf(sunAngle)*0.6f, -1.0f, sinf(sunAngle)*0.6f });
+			gpu.Begin("shadows");
+			sun.Update(camera, (float)GetRenderWidth()/(float)GetRenderHeight(), drawVillage);
+			gpu.End();
+			sun.Apply(shadowShader, camera);
+
+			// Picks what is under the crosshair, then whether the sun reaches it
+			Ray ray = GetMouseRay({ screenWidth/2.0f, screenHeight/2.0f }, camera);
+			double pickStart = GetTime();
+			pick = pickScene.Raycast(ray);
+			Vector3 toSun = Vector3Normalize({ cosf(sunAngle)*-0.6f, 1.0f, sinf(sunAngle)*-0.6f });
+			Vector3 lifted = Vector3Add(pick.collision.point, Vector3Scale(pick.collision.normal, 0.01f));
+			pickSunlit = pick.collision.hit && !pickScene.Occluded(lifted, Vector3Add(lifted, Vector3Scale(toSun, 100.0f)));
+			pickMs = (float)((GetTime() - pickStart)*1000.0);
+			if (IsKeyPressed(KEY_V) && propsReady)
+			{
+				double bruteStart = GetTime();
+				for (int k = 0; k < 3; k++)
+				{
+					Matrix transform = MatrixMultiply(villageModels[k]->transform, villageTransforms[k]);
+					for (int m = 0; m < villageModels[k]->meshCount; m++) GetRayCollisionMesh(ray, villageModels[k]->meshes[m], transform);
+				}
+				bruteMs = (float)((GetTime() - bruteStart)*1000.0);
+			}
+		}
+
+		if (path == PATH_SKINNED) SetShaderValue(skinnedShader, skinnedShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+
+		if (path == PATH_PBR) SetShaderValue(pbrShader, pbrShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+
+		if (path == PATH_CROWD && crowdReady)
+		{
+			SetShaderValue(crowdShader, crowdShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+			SetShaderValue(crowdShader, crowdTimeLoc, &time, SHADER_UNIFORM_FLOAT);
+			crowdRing.Begin();
+			for (int i = 0; i < (int)crowd.size(); i++) crowdRing.Set(i, crowd[i]);
+		}
+
+		if (path == PATH_INSTANCED)
+		{
+			SetShaderValue(instancedShader, instancedShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+			SetShaderValue(layeredShader, layeredShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+			SetShaderValue(traversedShader, traversedShader.locs[SHADER_LOC_VECTOR_VIEW], cameraPos, SHADER_UNIFORM_VEC3);
+			propRing.Begin();
+			for (int k = 0; k < PROP_KINDS; k++)
+			{
+				for (int i = 0; i < propCount[k]; i++) propRing.Set(propFirst[k] + i, props[k][i]);
+			}
+		}
+		//----------------------------------------------------------------------------------
+
+		// Draw
+		//----------------------------------------------------------------------------------
+		if (path == PATH_DEFERRED)
+		{
+			gpu.Begin("g-buffer");
+			deferred.BeginGeometry(camera);
+			DrawModel(model, position, 0.2f, WHITE);
+			deferred.EndGeometry();
+
+			gpu.End();
+
+			gpu.Begin("lighting");
+			deferred.Shade(camera, pointLights, RAYWHITE);
+			gpu.End();
+
+			deferred.BeginOverlay(camera);
+			drawMarkers();
+			deferred.EndOverlay();
+		}
+		else if (path == PATH_HYBRID)
+		{
+			for (const GpuProfiler::Pass& p : gpu.Passes())
+			{
+				if (p.seen && strcmp(p.name, "raymarch") == 0) hybrid.Adapt(p.last);
+			}
+
+			gpu.Begin("raster");
+			hybrid.BeginRaster(camera, RAYWHITE);
+			DrawModel(model, position, 0.2f, WHITE);
+			hybrid.EndRaster();
+			gpu.End();
+
+			gpu.Begin("raymarch");
+			hybrid.March();
+			gpu.End();
+		}
+		else if (overdrawView && plainPath())
+		{
+			gpu.Begin("overdraw");
+			prepass.RenderOverdraw(camera, prepassOn, drawStandIns);
+			gpu.End();
+		}
+		else if (path == PATH_PBR && temporalOn)
+		{
+			gpu.Begin("reduced scene");
+			temporal.BeginScene(camera, RAYWHITE);
+			drawPlainScene();
+			temporal.EndScene();
+			gpu.End();
+
+			gpu.Begin("temporal");
+			temporal.Resolve();
+			gpu.End();
+		}
+
+		frameStats = rlGetFrameStats();
+		BeginDrawing();
+
+		ClearBackground(RAYWHITE);
+
+		gpu.Begin("scene");
+
+		if (path == PATH_DEFERRED) deferred.Present();
+		else if (path == PATH_HYBRID)
+		{
+			hybrid.Present();
+			BeginMode3D(camera);
+			drawMarkers();
+			EndMode3D();
+		}
+		else if (overdrawView && plainPath()) prepass.Present();
+		else if (path == PATH_DISTRICT)
+		{
+			BeginMode3D(camera);
+
+			// Assigning is timed on its own: the grid lookup and the per-draw uniform uploads
+			assignMs = 0.0;
+			for (int z = 0; z < DISTRICT_TILES; z++)
+			{
+				for (int x = 0; x < DISTRICT_TILES; x++)
+				{
+					Vector3 at = { -districtHalf + 2.0f + x*4.0f, 0.0f, -districtHalf + 2.0f + z*4.0f };
+					double assignStart = GetTime();
+					assignment.Assign(assignedShader, at, 2.83f);      // Half the tile's diagonal
+					assignMs += (GetTime() - assignStart)*1000.0;
+					DrawModel(districtTile, at, 1.0f, LIGHTGRAY);
+					if ((x*7 + z*3)%5 == 0)
+					{
+						Vector3 crate = { at.x, 0.8f, at.z };
+						assignStart = GetTime();
+						assignment.Assign(assignedShader, crate, 1.2f);
+						assignMs += (GetTime() - assignStart)*1000.0;
+						DrawModel(districtCrate, crate, 1.0f, BEIGE);
+					}
+				}
+			}
+			for (const PointLight& l : districtLights)
+			{
+				gizmos.Sphere(l.position, 0.05f, l.color);
+				if (gizmoView) gizmos.WireSphere(l.position, l.radius, ColorAlpha(l.color, 0.3f));
+			}
+			gizmos.Flush();
+
+			EndMode3D();
+		}
+		else if (path == PATH_INSTANCED)
+		{
+			BeginMode3D(camera);
+
+			if (traversalOn && propsReady)
+			{
+				gpu.Begin("traversed");
+				town.Traverse(MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()), camera.position, queue);
+				queue.Flush();
+				gpu.End();
+			}
+			else if (culling && propsReady)
+			{
+				culler.Cull(propRing, propFirst, propCount);
+				culler.Draw(instancedShader);
+			}
+			else if (batchOn && propBatch.Ready()) propBatch.Draw(propRing, layeredShader, propFirst, propCount);
+			else
+			{
+				for (int k = 0; k < PROP_KINDS; k++)
+				{
+					const Model& prop = *propModels[k];
+					for (int m = 0; m < prop.meshCount; m++)
+					{
+						Material material = prop.materials[prop.meshMaterial[m]];
+						material.shader = instancedShader;
+						propRing.DrawInstanced(prop.meshes[m], material, propFirst[k], propCount[k]);
+					}
+				}
+			}
+			drawMarkers();
+
+			EndMode3D();
+			propRing.End();
+		}
+		else if (path == PATH_SKINNED)
+		{
+			BeginMode3D(camera);
+
+			// Posing is timed on its own: on the GPU path it is a bone upload per robot, on
+			// the CPU path every vertex is skinned and re-uploaded per robot
+			skinningMs = 0.0;
+			skinningBytes = 0;
+			for (int i = 0; i < ROBOTS && robotAnimCount > 0; i++)
+			{
+				const ModelAnimation &anim = robotAnims[i%robotAnimCount];
+				int frame = (int)(time*30.0f) + i*11;
+				double poseStart = GetTime();
+				if (gpuSkinning) skin.Pose(robot, anim, frame);
+				else
+				{
+					UpdateModelAnimation(robot, anim, frame);
+					for (int m = 0; m < robot.meshCount; m++) skinningBytes += robot.meshes[m].vertexCount*3*(int)sizeof(float)*((robot.meshes[m].animNormals != NULL)? 2 : 1);
+				}
+				skinningMs += (GetTime() - poseStart)*1000.0;
+				for (int m = 0; m < robot.materialCount; m++) robot.materials[m].shader = gpuSkinning? skinnedShader : shader;
+
+				float angle = 360.0f*(float)i/ROBOTS;
+				Vector3 at = { sinf(angle*DEG2RAD)*3.0f, 0.0f, cosf(angle*DEG2RAD)*3.0f };
+				DrawModelEx(robot, at, { 0.0f, 1.0f, 0.0f }, angle, { 0.5f, 0.5f, 0.5f }, WHITE);
+			}
+			if (gpuSkinning) skinningBytes = skin.TakeUploaded();
+			drawMarkers();
+
+			EndMode3D();
+		}
+		else if (path == PATH_CROWD)
+		{
+			BeginMode3D(camera);
+
+			for (int m = 0; m < robot.meshCount && crowdReady; m++)
+			{
+				Material material = robot.materials[robot.meshMaterial[m]];
+				material.shader = crowdShader;
+				crowdRing.DrawInstanced(robot.meshes[m], material, 0, (int)crowd.size());
+			}
+			drawMarkers();
+
+			EndMode3D();
+			if (crowdReady) crowdRing.End();
+		}
+		else if (path == PATH_PBR && temporalOn) temporal.Present();
+		else    // Forward, clustered, shadowed, PBR and lightmapped
+		{
+			BeginMode3D(camera);
+			drawPlainScene();
+			EndMode3D();
+		}
+
+		gpu.End();
+
+		gpu.Begin("ui");
+		if (bucketsOn) rlEnableTextureBuckets();
+		SdfText::Stats textStats = overlayText.LastStats();
+		overlayText.Begin();
+		overlayLine("(c) Watermill 3D model by Alberto Cano", screenWidth - 210, screenHeight - 20, 10, GRAY);
+
+		DrawFPS(10, 10);
+		char gpuLine[256] = "gpu ms:";
+		int used = (int)strlen(gpuLine);
+		for (const GpuProfiler::Pass& p : gpu.Passes())
+		{
+			if (p.seen && used < (int)sizeof(gpuLine)) used += snprintf(gpuLine + used, sizeof(gpuLine) - used, "  %s %.2f", p.name, p.average);
+		}
+		overlayLine(gpuLine, 100, 15, 10, DARKGRAY);
+		if (path == PATH_FORWARD)
+		{
+			overlayLine(TextFormat("forward: lighting.fs variant %04x, %i compiled (Y/R/G/B toggle the lights)", forwardKey, forwardVariants.Count()), 10, 35, 10, DARKGRAY);
+		}
+		else if (path == PATH_CLUSTERED)
+		{
+			const ClusteredLights::Stats& stats = clusters.LastStats();
+			overlayLine(TextFormat("clustered: %i lights, %i visible, %i refs, busiest cluster %i, dropped %i", stats.lights, stats.visible, stats.references, stats.busiest, stats.dropped), 10, 35, 10, DARKGRAY);
+		}
+		else if (path == PATH_TILED)
+		{
+			const TiledLights::Stats& stats = tiles.LastStats();
+			overlayLine(TextFormat("tiled: %i lights, %i visible, %i refs, busiest tile %i, dropped %i", stats.lights, stats.visible, stats.references, stats.busiest, stats.dropped), 10, 35, 10, DARKGRAY);
+		}
+		else if (path == PATH_SHADOWED)
+		{
+			overlayLine(TextFormat("shadowed: %i of %i cascade page(s) rendered this frame (COMMA/PERIOD turn the sun)", sun.PagesRendered(), CascadedShadows::C_CASCADES), 10, 35, 10, DARKGRAY);
+			DrawLine(screenWidth/2 - 6, screenHeight/2, screenWidth/2 + 6, screenHeight/2, MAROON);
+			DrawLine(screenWidth/2, screenHeight/2 - 6, screenWidth/2, screenHeight/2 + 6, MAROON);
+			if (!propsReady) overlayLine("pick: once the models have loaded", 10, 80, 10, DARKGRAY);
+			else if (!pick.collision.hit) overlayLine(TextFormat("pick: nothing, %.3f ms over %i instance(s)%s", pickMs, pickScene.Instances(), bruteMs >= 0.0f? TextFormat(", every triangle %.3f ms (V)", bruteMs) : " (V times every triangle)"), 10, 80, 10, DARKGRAY);
+			else overlayLine(TextFormat("pick: %s triangle %i at %.1f, %s, %.3f ms with the sun ray%s", pickNames[pick.id], pick.triangle, pick.collision.distance, pickSunlit? "sunlit" : "in shadow", pickMs,
+				bruteMs >= 0.0f? TextFormat(", every triangle %.3f ms (V)", bruteMs) : " (V times every triangle)"), 10, 80, 10, DARKGRAY);
+		}
+		else if (path == PATH_INSTANCED)
+		{
+			overlayLine(TextFormat("instanced: %i props, transforms %s, %i stall(s)", propRing.Capacity(), propRing.Persistent()? "persistently mapped" : "mapped per frame", propRing.Stalls()), 10, 35, 10, DARKGRAY);
+			if (traversalOn && propsReady)
+			{
+				const SceneGraph::Stats& t = town.LastStats();
+				overlayLine(TextFormat("CPU traversal (I): %i of %i props visible, LODs %i / %i / %i, cull/record %.2f ms on %i thread(s), %i chunk(s), %i draw(s)", t.visible, t.drawables, t.lod[0], t.lod[1], t.lod[2],
+					t.gatherMs, (int)JobSystem::Instance().ThreadCount(), queue.LastStats().chunks, queue.LastStats().items), 10, 50, 10, DARKGRAY);
+				overlayLine(TextFormat("transforms: %i of %i nodes recomputed in %.2f ms (hold M to spin a block)", t.recomputed, t.nodes, t.propagateMs), 10, 65, 10, DARKGRAY);
+			}
+			else if ((!culling || !propsReady) && batchOn && propBatch.Ready()) overlayLine(TextFormat("culling off, batched (Z): %i draw(s) of every instance, %i texture layer(s)%s", propBatch.Draws(), propBatch.Layers(),
+				propBatch.MultiDraw()? " and one multi-draw" : ", a draw per mesh"), 10, 50, 10, DARKGRAY);
+			else if (!culling || !propsReady) overlayLine(TextFormat("culling off: %i draw(s) of every instance", propRing.Draws()), 10, 50, 10, DARKGRAY);
+			else if (culler.Indirect()) overlayLine(TextFormat("GPU culling: %i pass(es), %i indirect draw(s), counts stay on the GPU, hi-z %s", culler.Passes(), culler.Draws(), culler.Occlusion()? "on" : "off"), 10, 50, 10, DARKGRAY);
+			else overlayLine(TextFormat("GPU culling: %i pass(es), %i draw(s), LODs %i / %i / %i (counts read back), hi-z %s", culler.Passes(), culler.Draws(), culler.Visible(0), culler.Visible(1), culler.Visible(2), culler.Occlusion()? "on" : "off"), 10, 50, 10, DARKGRAY);
+		}
+		else if (path == PATH_SKINNED) overlayLine(TextFormat("skinned on the %s: %i robots x %i bones, %i KB uploaded, %.2f ms posing", gpuSkinning? "GPU" : "CPU", ROBOTS, robot.boneCount, skinningBytes/1024, skinningMs), 10, 35, 10, DARKGRAY);
+		else if (path == PATH_CROWD) overlayLine(TextFormat("crowd: %i robots in %i instanced draw(s), %i clip(s) / %i frame(s) baked (%i KB), no CPU animation", (int)crowd.size(), crowdRing.Draws(), baked.Clips(), baked.Frames(), baked.Bytes()/1024), 10, 35, 10, DARKGRAY);
+		else if (path == PATH_PBR)
+		{
+			const TextureStreamer::Stats& t = streamer.LastStats();
+			overlayLine(TextFormat("pbr: 4 lights + image-based lighting, maps %s", ibl.cached? "loaded from the DDS cache" : "generated and cached this run"), 10, 35, 10, DARKGRAY);
+			overlayLine(TextFormat("textures: %.1f of %.1f MB resident (%.1f MB wanted), %i streaming, %s colour / %s normals", t.resident/1048576.0f, streamer.Budget()/1048576.0f, t.wanted/1048576.0f, t.pending,
+				TextureCompress::Name(streamer.Codec(carTextures[0])), TextureCompress::Name(streamer.Codec(carTextures[2]))), 10, 80, 10, DARKGRAY);
+			if (temporalOn && !overdrawView) overlayLine(TextFormat("temporal (T): %ix%i (%i%%, [ and ]) upsampled to %ix%i", temporal.RenderWidth(), temporal.RenderHeight(), (int)(temporal.Scale()*100.0f + 0.5f), GetRenderWidth(), GetRenderHeight()), 10, 95, 10, DARKGRAY);
+			else overlayLine("temporal off (T): native resolution", 10, 95, 10, DARKGRAY);
+			VertexCompression::Stats v = compactVertices.Totals();
+			if (compactOn) overlayLine(TextFormat("vertices (N): %i mesh(es) compact, %i KB instead of %i KB as floats", v.meshes, v.compactBytes/1024, v.floatBytes/1024), 10, 110, 10, DARKGRAY);
+			else overlayLine("vertices (N): floats", 10, 110, 10, DARKGRAY);
+			const MeshletCuller::Stats& c = carMeshlets.LastStats();
+			if (meshletsOn) overlayLine(TextFormat("meshlets (X): %i of %i drawn (%i outside, %i back-facing), %i of %i triangles, culled in %.2f ms", c.visible, c.meshlets, c.outside, c.backFacing, c.drawn, c.triangles, c.cullMs), 10, 125, 10, DARKGRAY);
+			else overlayLine(TextFormat("meshlets off (X): all %i triangles drawn", c.triangles), 10, 125, 10, DARKGRAY);
+		}
+		else if (path == PATH_LIGHTMAPPED)
+		{
+			if (!propsReady) overlayLine("lightmapped: baking once the village has loaded", 10, 35, 10, DARKGRAY);
+			else if (village.models.empty()) overlayLine("lightmapped: the bake failed, drawing the village unlit", 10, 35, 10, DARKGRAY);
+			else if (village.cached) overlayLine(TextFormat("lightmapped: %ix%i lightmap mapped from the asset cache", village.lightmap.width, village.lightmap.height), 10, 35, 10, DARKGRAY);
+			else overlayLine(TextFormat("lightmapped: %i chart(s), %i texel(s) at %.1f per unit, baked this run", village.charts, village.texels, village.texelsPerUnit), 10, 35, 10, DARKGRAY);
+		}
+		else if (path == PATH_DEFERRED) overlayLine(TextFormat("deferred: 4 lights + %i light volumes, %i light buffer upload(s) this frame", deferred.VolumesShaded(), lightUploads), 10, 35, 10, DARKGRAY);
+		else if (path == PATH_DISTRICT)
+		{
+			const LightAssignment::Stats& a = assignment.LastStats();
+			overlayLine(TextFormat("district: %i lights, %i draws, %.1f lights per draw (busiest %i, %i dropped), assigned in %.2f ms", a.lights, a.draws, a.draws > 0? (float)a.assigned/a.draws : 0.0f, a.busiest, a.dropped, assignMs), 10, 35, 10, DARKGRAY);
+		}
+		else if (path == PATH_HYBRID) overlayLine(TextFormat("hybrid: raymarched at 1/%i resolution (%ix%i) in %.2f ms, budget %.1f ms, %s (U)", hybrid.Scale(), hybrid.MarchedWidth(), hybrid.MarchedHeight(), hybrid.MarchMs(), HybridRaymarch::C_BUDGET_MS, hybrid.Adaptive()? "adaptive" : "full resolution"), 10, 35, 10, DARKGRAY);
+		else overlayLine(TextFormat("forward: 4 lights, %i light buffer upload(s) this frame", lightUploads), 10, 35, 10, DARKGRAY);
+		if (plainPath()) overlayLine(TextFormat("fragments: %.2f shaded per pixel, pre-pass %s (P), overdraw view %s (O)", prepass.ShadedPerPixel(), prepassOn? "on" : "off", overdrawView? "on" : "off"), 10, 50, 10, DARKGRAY);
+		if (plainPath() && queueOn)
+		{
+			const RenderQueue::Stats& q = queue.LastStats();
+			overlayLine(TextFormat("render queue (J): %i draw(s), binds shader/material/mesh %i/%i/%i sorted vs %i/%i/%i unsorted", q.items, q.shaders, q.materials, q.meshes, q.unsortedShaders, q.unsortedMaterials, q.unsortedMeshes), 10, 65, 10, DARKGRAY);
+		}
+		else if (plainPath()) overlayLine("render queue off (J): submission order", 10, 65, 10, DARKGRAY);
+		overlayLine(TextFormat("samplers (F2): tier %i of %i over %i texture(s)", SamplerPresets::Instance().Tier(), SamplerPresets::C_TIERS - 1, SamplerPresets::Instance().Registered()), 10, screenHeight - 95, 10, DARKGRAY);
+		overlayLine(TextFormat("gizmos (L): %i in %i instanced draw(s)", gizmos.Instances(), gizmos.Draws()), 10, screenHeight - 35, 10, DARKGRAY);
+		if (loader.Outstanding() > 0) overlayLine(TextFormat("loading: %i asset(s) to go, %i KB uploaded this frame", loader.Outstanding(), (int)(loader.Uploaded()/1024)), 10, screenHeight - 20, 10, DARKGRAY);
+		overlayLine(TextFormat("rlgl: overlay %s (F)", bucketsOn? "grouped by texture" : "in submission order"), 10, screenHeight - 50, 10, DARKGRAY);
+		overlayLine(TextFormat("rlgl last frame: %i flush(es) of %i vertices, %i draw(s), %i texture bind(s), %i shader switch(es), %i KB uploaded", frameStats.batchFlushes, frameStats.batchFlushVertices,
+			frameStats.drawCalls, frameStats.textureBinds, frameStats.shaderSwitches, frameStats.uploadBytes/1024), 10, screenHeight - 80, 10, DARKGRAY);
+		if (sdfTextOn) overlayLine(TextFormat("text (F1): %i line(s), %i rebuilt (%i bytes), %i glyph(s) in one draw", textStats.runs, textStats.rebuilt, textStats.uploaded, textStats.glyphs), 10, screenHeight - 65, 10, DARKGRAY);
+		else overlayLine("text (F1): DrawText, a quad per character per frame", 10, screenHeight - 65, 10, DARKGRAY);
+		overlayText.End();
+
+		rlDrawRenderBatchActive();      // Regrouped while buckets are still on
+		rlDisableTextureBuckets();
+		gpu.End();
+
+		EndDrawing();
+		//----------------------------------------------------------------------------------
+	}
+
+	// De-Initialization
+	//--------------------------------------------------------------------------------------
+	loader.Stop();              // Drops anything still in flight
+	UnloadShader(shader);       // Unload shader
+	forwardVariants.Unload();
+	overlayText.Unload();
+	UnloadShader(clusteredShader);
+	UnloadLightBuffer();
+	clusters.Detach(model.materials[0]);
+	clusters.Unload();
+	UnloadShader(tiledShader);
+	tiles.Detach(model.materials[0]);
+	tiles.Unload();
+	deferred.Unload();
+	hybrid.Unload();
+	temporal.Unload();
+	districtTile.materials[0].shader = districtCrate.materials[0].shader = Shader{};     // Unloaded once, below
+	assignment.Detach(districtTile.materials[0]);
+	assignment.Detach(districtCrate.materials[0]);
+	UnloadModel(districtTile);
+	UnloadModel(districtCrate);
+	assignment.Unload();
+	UnloadShader(assignedShader);
+	sun.Unload();
+	UnloadShader(shadowShader);
+	if (propsReady) culler.Unload();
+	propBatch.Unload();
+	UnloadShader(layeredShader);
+	UnloadShader(pbrShader);
+	UnloadShader(skyboxShader);
+	UnloadModel(skybox);
+	compactVertices.Unload();
+	UnloadModel(car);           // The car's textures aren't the model's to unload
+	streamer.Unload();
+	IblCache::Unload(ibl);
+	prepass.Unload();
+	gizmos.Unload();
+	grid.Unload();
+	gpu.Unload();
+	Lightmap::Unload(village);      // Its models' diffuse textures are the village's own
+	UnloadShader(lightmapShader);
+	skin.Unload();
+	for (int m = 0; m < robot.materialCount; m++) baked.Detach(robot.materials[m]);
+	baked.Unload();
+	crowdRing.Unload();
+	UnloadShader(crowdShader);
+	UnloadShader(skinnedShader);
+	UnloadModelAnimations(robotAnims, robotAnimCount);
+	UnloadModel(robot);
+	propRing.Unload();
+	for (int k = 0; k < PROP_KINDS && propsReady; k++)
+	{
+		for (Model& lod : townLods[k]) UnloadLodModel(lod, *propModels[k]);
+	}
+	UnloadShader(traversedShader);
+	UnloadShader(instancedShader);
+	for (Texture2D t : { texture, barracksTexture, churchTexture })
+	{
+		if (t.id == placeholderTexture.id) continue;
+		SamplerPresets::Instance().Forget(t.id);
+		UnloadTexture(t);
+	}
+	UnloadModel(barracks);
+	UnloadModel(church);
+	UnloadModel(ground);
+	UnloadModel(model);         // Unload model
+
+	CloseWindow();              // Close window and OpenGL context
+	//--------------------------------------------------------------------------------------
+
+	return 0;
+}
@@ -0,0 +1,116 @@
+#ifndef ANIMATION_BAKE_H
+#define ANIMATION_BAKE_H
+
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "gpu_skinning.h"
+
+// --- BAKED ANIMATIONS ---
+// Every frame of every clip of a skeletal model, baked once into a float texture of bone
+// matrices so that a crowd can be skinned with no per-instance palette: each instance picks a
+// clip and a time offset, and crowd_skinned.vs fetches (and blends between) the two frames
+// it falls between. One row per frame, clips one after another; each bone is the top three
+// rows of its GpuSkinning::BoneMatrix, three RGBA32F texels.
+//
+// The meshes need GpuSkinning's bone attributes; draw them instanced through InstanceRing,
+// with each transform passed through Tag(). Attach() puts the texture in the material's
+// C_SLOT, Bind() points a shader at it and at the clip table.
+class BakedAnimations {
+public:
+	static constexpr int   C_MAX_CLIPS = 16;               // MAX_CLIPS in crowd_skinned.vs
+	static constexpr float C_FRAME_SECONDS = 0.017f;       // raylib's glTF sampling step (GLTF_ANIMDELAY)
+	static constexpr int   C_SLOT = MATERIAL_MAP_HEIGHT;
+
+	// False, and nothing to unload, if there's nothing to bake. Clips past C_MAX_CLIPS or the
+	// driver's texture height, or not matching the model's skeleton, are left out.
+	bool Bake(const Model& model, const ModelAnimation* anims, int count) {
+		if (model.boneCount <= 0 || model.bindPose == nullptr) return false;
+		int maxSize = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+		width = model.boneCount * 3;
+		if (width > maxSize) return false;
+
+		std::vector<float> texels;
+		rows = 0;
+		clips = 0;
+		for (int c = 0; c < count && clips < C_MAX_CLIPS; ++c) {
+			const ModelAnimation& anim = anims[c];
+			if (anim.boneCount != model.boneCount || anim.frameCount <= 0 || rows + anim.frameCount > maxSize) continue;
+			clipStart[clips] = rows;
+			clipFrames[clips] = anim.frameCount;
+			++clips;
+			for (int f = 0; f < anim.frameCount; ++f, ++rows) {
+				for (int b = 0; b < model.boneCount; ++b) {
+					const Matrix m = GpuSkinning::BoneMatrix(model.bindPose[b], anim.framePoses[f][b]);
+					const float top[12] = { m.m0, m.m4, m.m8, m.m12, m.m1, m.m5, m.m9, m.m13, m.m2, m.m6, m.m10, m.m14 };
+					texels.insert(texels.end(), top, top + 12);
+				}
+			}
+		}
+		if (rows == 0) return false;
+
+		texture.id = rlLoadTexture(texels.data(), width, rows, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+		texture.width = width;
+		texture.height = rows;
+		texture.mipmaps = 1;
+		texture.format = PIXELFORMAT_UNCOMPRESSED_R32G32B32A32;
+		TraceLog(LOG_INFO, "ANIMATION: [ID %u] %i clip(s), %i frame(s) x %i bone(s) baked, %i KB", texture.id, clips, rows, model.boneCount, Bytes() / 1024);
+		return true;
+	}
+
+	void Unload() {
+		if (texture.id) rlUnloadTexture(texture.id);
+		texture = Texture2D{};
+	}
+
+	// Remember to Detach before UnloadModel touches the material.
+	void Attach(Material& material) const {
+		material.maps[C_SLOT].texture = texture;
+	}
+
+	void Detach(Material& material) const {
+		material.maps[C_SLOT].texture = Texture2D{};
+	}
+
+	// Sampler and clip table; needed again for any program that replaces this one.
+	void Bind(Shader& shader) const {
+		shader.locs[SHADER_LOC_MAP_DIFFUSE + C_SLOT] = GetShaderLocation(shader, "animationTexture");
+		SetShaderValueV(shader, GetShaderLocation(shader, "clipStart"), clipStart, SHADER_UNIFORM_INT, C_MAX_CLIPS);
+		SetShaderValueV(shader, GetShaderLocation(shader, "clipFrames"), clipFrames, SHADER_UNIFORM_INT, C_MAX_CLIPS);
+		const float rate = 1.0f / C_FRAME_SECONDS;
+		SetShaderValue(shader, GetShaderLocation(shader, "frameRate"), &rate, SHADER_UNIFORM_FLOAT);
+	}
+
+	// The instance transform with its clip and time offset (seconds) in the bottom row,
+	// which an affine transform leaves as 0 0 0 1; the shader reads them and puts it back.
+	static Matrix Tag(Matrix transform, int clip, float offset) {
+		transform.m3 = static_cast<float>(clip);
+		transform.m7 = offset;
+		return transform;
+	}
+
+	int Clips() const {
+		return clips;
+	}
+
+	int Frames() const {
+		return rows;
+	}
+
+	int Bytes() const {
+		return width * rows * 4 * static_cast<int>(sizeof(float));
+	}
+
+private:
+	Texture2D texture{};
+	int       width = 0;
+	int       rows = 0;
+	int       clips = 0;
+	int       clipStart[C_MAX_CLIPS] = {};
+	int       clipFrames[C_MAX_CLIPS] = {};
+};
+
+#endif // ANIMATION_BAKE_H
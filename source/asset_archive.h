@@ -0,0 +1,311 @@
+#ifndef ASSET_ARCHIVE_H
+#define ASSET_ARCHIVE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "external/sdefl.h"  // sdeflate, compiled into rcore with SUPPORT_COMPRESSION_API
+#include "external/sinfl.h"  // sinflate, likewise
+
+// --- ASSET ARCHIVE ---
+// resources/ packed into one file (Pack.exe in build.bat writes it), mapped whole at start
+// so a cold start opens one file instead of one per texture, model and shader. Mount()
+// puts it behind raylib's LoadFileData and LoadFileText callbacks: every loader asking for
+// a path under the mount prefix, "../resources/models/watermill.obj" say, is served from
+// the archive, and any other path (the shader and asset caches, a file the archive lacks)
+// still comes from disk. Entries are stored as they are or DEFLATE-compressed, whichever
+// is smaller by C_MIN_SAVING; View() hands out stored entries in place, with no copy.
+// Mount before anything loads, and before worker threads do: lookups are read-only.
+//
+// File format: Header, `count` Entry records sorted by name hash, the names, then the
+// entries' bytes, each C_ALIGN-aligned.
+namespace AssetArchive {
+	struct Stats {
+		int              entries = 0;
+		int              compressed = 0;
+		std::atomic<int> reads{ 0 };  // files served from the archive, from any thread
+		std::atomic<int> misses{ 0 }; // paths under the prefix it doesn't have
+	};
+
+	namespace Detail {
+		constexpr uint32_t C_VERSION = 1;
+		constexpr size_t   C_ALIGN = 64;
+		constexpr int      C_LEVEL = 8;           // sdeflate level, as raylib's CompressData
+		constexpr uint32_t C_MIN_SAVING = 8;      // compressed when it saves 1/8 of the entry
+		constexpr uint32_t C_COMPRESSED = 1;
+		constexpr int      C_INFLATE_PAD = 8;     // zeros after a compressed entry, see Build
+		inline constexpr char C_MAGIC[8] = { 'P', 'O', 'I', 'G', 'P', 'A', 'K', '1' };
+
+		struct Header {
+			char     magic[8];
+			uint32_t version;
+			uint32_t count;
+		};
+
+		struct Entry {
+			uint64_t hash;
+			uint64_t offset;
+			uint32_t storedSize;
+			uint32_t size;
+			uint32_t nameOffset;  // into the names, which follow the records
+			uint32_t nameLength;
+			uint32_t flags;
+			uint32_t reserved;
+		};
+
+		// FNV-1a over the archive-relative name.
+		inline uint64_t Hash(const char* name, size_t length) {
+			uint64_t h = 14695981039346656037ull;
+			for (size_t i = 0; i < length; ++i) h = (h ^ static_cast<unsigned char>(name[i])) * 1099511628211ull;
+			return h;
+		}
+
+		// "models\\watermill.obj" and "./models/watermill.obj" both name models/watermill.obj.
+		inline std::string Normalize(const char* path) {
+			std::string name(path);
+			std::replace(name.begin(), name.end(), '\\', '/');
+			while (name.compare(0, 2, "./") == 0) name.erase(0, 2);
+			return name;
+		}
+
+		struct Mounted {
+			unsigned char* data = nullptr;
+			int            size = 0;
+			const Entry*   entries = nullptr;
+			const char*    names = nullptr;
+			uint32_t       count = 0;
+			std::string    prefix;  // normalised
+			Stats          stats;
+		};
+
+		inline Mounted& Archive() {
+			static Mounted archive;
+			return archive;
+		}
+
+		// A file on disk copied into MemAlloc memory (`text` adds a terminating zero), for the
+		// callbacks, which can't call back into LoadFileData. MapFileData always reads the disk.
+		inline unsigned char* ReadDisk(const char* fileName, int* dataSize, bool text) {
+			*dataSize = 0;
+			int mappedSize = 0;
+			unsigned char* mapped = MapFileData(fileName, &mappedSize);
+			if (mapped == nullptr) {
+				TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", fileName);
+				return nullptr;
+			}
+			unsigned char* data = static_cast<unsigned char*>(MemAlloc(static_cast<unsigned int>(mappedSize + (text ? 1 : 0))));
+			memcpy(data, mapped, static_cast<size_t>(mappedSize));
+			UnmapFileData(mapped, mappedSize);
+			*dataSize = mappedSize;
+			return data;
+		}
+	}
+
+	inline Stats& Counters() {
+		return Detail::Archive().stats;
+	}
+
+	// The record for an archive-relative name, or nullptr.
+	inline const Detail::Entry* Find(const char* name) {
+		const Detail::Mounted& a = Detail::Archive();
+		if (a.entries == nullptr) return nullptr;
+		const std::string key = Detail::Normalize(name);
+		const uint64_t hash = Detail::Hash(key.data(), key.size());
+		const Detail::Entry* end = a.entries + a.count;
+		const Detail::Entry* e = std::lower_bound(a.entries, end, hash, [](const Detail::Entry& x, uint64_t h) { return x.hash < h; });
+		for (; e != end && e->hash == hash; ++e) {
+			if (e->nameLength == key.size() && memcmp(a.names + e->nameOffset, key.data(), key.size()) == 0) return e;
+		}
+		return nullptr;
+	}
+
+	// A stored entry's bytes inside the mapping, valid until Unmount; nullptr for a
+	// compressed one (Read it instead).
+	inline const unsigned char* View(const Detail::Entry& e) {
+		return (e.flags & Detail::C_COMPRESSED) ? nullptr : Detail::Archive().data + e.offset;
+	}
+
+	// An entry's bytes in MemAlloc memory, decompressed, with a terminating zero past `size`
+	// so text can use them as they are. Free with MemFree; nullptr if the entry is damaged.
+	inline unsigned char* Read(const Detail::Entry& e) {
+		const unsigned char* stored = Detail::Archive().data + e.offset;
+		unsigned char* data = static_cast<unsigned char*>(MemAlloc(e.size + 1));
+		if (!(e.flags & Detail::C_COMPRESSED)) {
+			memcpy(data, stored, e.size);
+		}
+		else if (sinflate(data, static_cast<int>(e.size), stored, static_cast<int>(e.storedSize)) != static_cast<int>(e.size)) {
+			MemFree(data);
+			return nullptr;
+		}
+		data[e.size] = 0;
+		++Counters().reads;
+		return data;
+	}
+
+	namespace Detail {
+		// The archive's entry for a path under the mount prefix, or nullptr.
+		inline const Entry* Lookup(const char* fileName) {
+			const Mounted& a = Archive();
+			const std::string path = Normalize(fileName);
+			if (path.compare(0, a.prefix.size(), a.prefix) != 0) return nullptr;
+			const Entry* e = Find(path.c_str() + a.prefix.size());
+			if (e == nullptr) ++Archive().stats.misses;
+			return e;
+		}
+
+		inline unsigned char* LoadData(const char* fileName, int* dataSize) {
+			const Entry* e = Lookup(fileName);
+			if (e == nullptr) return ReadDisk(fileName, dataSize, false);
+			unsigned char* data = Read(*e);
+			*dataSize = data ? static_cast<int>(e->size) : 0;
+			return data;
+		}
+
+		inline char* LoadText(const char* fileName) {
+			const Entry* e = Lookup(fileName);
+			if (e != nullptr) return reinterpret_cast<char*>(Read(*e));
+			int size = 0;
+			char* text = reinterpret_cast<char*>(ReadDisk(fileName, &size, true));
+			if (text != nullptr) text[size] = 0;
+			return text;
+		}
+	}
+
+	// Maps `archivePath` and serves the paths under `prefix` from it. False, with the loose
+	// files left in use, if it is missing or not an archive of this version, or if any entry
+	// points outside the file or a stored entry's sizes disagree: reads never leave the map.
+	inline bool Mount(const char* archivePath, const char* prefix) {
+		using namespace Detail;
+		Mounted& a = Archive();
+		int size = 0;
+		unsigned char* data = MapFileData(archivePath, &size);
+		Header h{};
+		if (data != nullptr && static_cast<size_t>(size) >= sizeof(Header)) memcpy(&h, data, sizeof(Header));
+		const uint64_t names = sizeof(Header) + sizeof(Entry) * static_cast<uint64_t>(h.count);
+		bool valid = memcmp(h.magic, C_MAGIC, sizeof(C_MAGIC)) == 0 && h.version == C_VERSION && names <= static_cast<uint64_t>(size);
+		for (uint32_t i = 0; valid && i < h.count; ++i) {
+			Entry e;
+			memcpy(&e, data + sizeof(Header) + sizeof(Entry) * i, sizeof(Entry));
+			valid = e.offset <= static_cast<uint64_t>(size) && e.storedSize <= static_cast<uint64_t>(size) - e.offset
+				&& names + e.nameOffset + e.nameLength <= e.offset && ((e.flags & C_COMPRESSED) || e.size == e.storedSize);
+		}
+		if (!valid) {
+			if (data != nullptr) TraceLog(LOG_WARNING, "ARCHIVE: %s is damaged or not a version %u archive, using loose files", archivePath, C_VERSION);
+			UnmapFileData(data, size);
+			return false;
+		}
+
+		a.data = data;
+		a.size = size;
+		a.entries = reinterpret_cast<const Entry*>(data + sizeof(Header));
+		a.count = h.count;
+		a.names = reinterpret_cast<const char*>(a.entries + a.count);
+		a.prefix = Normalize(prefix);
+		a.stats.entries = static_cast<int>(h.count);
+		for (uint32_t i = 0; i < a.count; ++i) a.stats.compressed += (a.entries[i].flags & C_COMPRESSED) ? 1 : 0;
+		SetLoadFileDataCallback(LoadData);
+		SetLoadFileTextCallback(LoadText);
+		TraceLog(LOG_INFO, "ARCHIVE: %s mounted at %s: %i entries (%i compressed), %i bytes", archivePath, prefix, a.stats.entries, a.stats.compressed, size);
+		return true;
+	}
+
+	inline void Unmount() {
+		Detail::Mounted& a = Detail::Archive();
+		if (a.data == nullptr) return;
+		SetLoadFileDataCallback(nullptr);
+		SetLoadFileTextCallback(nullptr);
+		UnmapFileData(a.data, a.size);
+		a.data = nullptr;
+		a.entries = nullptr;
+		a.names = nullptr;
+		a.count = 0;
+	}
+
+	// Packs every file under `root` into `archivePath` (the build step). False if a file
+	// can't be read or the archive written.
+	inline bool Build(const char* root, const char* archivePath) {
+		using namespace Detail;
+		namespace fs = std::filesystem;
+		std::error_code error;
+		std::vector<std::string> names;
+		for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+			if (it->is_regular_file()) names.push_back(it->path().lexically_relative(root).generic_string());
+		}
+		if (error) {
+			TraceLog(LOG_WARNING, "ARCHIVE: can't list %s", root);
+			return false;
+		}
+
+		struct Packed {
+			std::string                name;
+			std::vector<unsigned char> bytes;
+			Entry                      entry{};
+		};
+		std::vector<Packed> packed(names.size());
+		std::vector<unsigned char> scratch;
+		sdefl* deflater = static_cast<sdefl*>(MemAlloc(sizeof(sdefl)));  // close to 1 MB, off the stack
+		for (size_t i = 0; i < names.size(); ++i) {
+			Packed& p = packed[i];
+			p.name = names[i];
+			const std::string path = (fs::path(root) / names[i]).string();
+			int size = 0;
+			unsigned char* data = MapFileData(path.c_str(), &size);
+			if (data == nullptr && fs::file_size(path, error) != 0) {
+				TraceLog(LOG_WARNING, "ARCHIVE: can't read %s", path.c_str());
+				MemFree(deflater);
+				return false;
+			}
+			p.entry.hash = Hash(p.name.data(), p.name.size());
+			p.entry.size = static_cast<uint32_t>(size);
+			p.entry.nameLength = static_cast<uint32_t>(p.name.size());
+			scratch.resize(static_cast<size_t>(sdefl_bound(size)));
+			const int deflated = size > 0 ? sdeflate(deflater, scratch.data(), data, size, C_LEVEL) : 0;
+			if (deflated > 0 && static_cast<uint32_t>(deflated + C_INFLATE_PAD) <= p.entry.size - p.entry.size / C_MIN_SAVING) {
+				// sinflate refills its bit buffer a word at a time and can read past the end
+				// of the stream; the zeros are stored as part of the entry to give it room.
+				p.bytes.assign(scratch.begin(), scratch.begin() + deflated);
+				p.bytes.resize(p.bytes.size() + C_INFLATE_PAD, 0);
+				p.entry.flags = C_COMPRESSED;
+			}
+			else {
+				p.bytes.assign(data, data + size);
+			}
+			p.entry.storedSize = static_cast<uint32_t>(p.bytes.size());
+			UnmapFileData(data, size);
+		}
+		MemFree(deflater);
+		std::sort(packed.begin(), packed.end(), [](const Packed& x, const Packed& y) { return x.entry.hash < y.entry.hash; });
+
+		std::vector<unsigned char> out(sizeof(Header) + sizeof(Entry) * packed.size());
+		for (Packed& p : packed) {
+			p.entry.nameOffset = static_cast<uint32_t>(out.size() - sizeof(Header) - sizeof(Entry) * packed.size());
+			out.insert(out.end(), p.name.begin(), p.name.end());
+		}
+		int compressed = 0;
+		for (size_t i = 0; i < packed.size(); ++i) {
+			Entry& e = packed[i].entry;
+			out.resize((out.size() + C_ALIGN - 1) / C_ALIGN * C_ALIGN);
+			e.offset = out.size();
+			out.insert(out.end(), packed[i].bytes.begin(), packed[i].bytes.end());
+			memcpy(out.data() + sizeof(Header) + sizeof(Entry) * i, &e, sizeof(Entry));
+			compressed += (e.flags & C_COMPRESSED) ? 1 : 0;
+		}
+		Header h{};
+		memcpy(h.magic, C_MAGIC, sizeof(C_MAGIC));
+		h.version = C_VERSION;
+		h.count = static_cast<uint32_t>(packed.size());
+		memcpy(out.data(), &h, sizeof(Header));
+
+		if (!SaveFileData(archivePath, out.data(), static_cast<int>(out.size()))) return false;
+		TraceLog(LOG_INFO, "ARCHIVE: packed %i files from %s into %s (%i compressed), %i bytes", static_cast<int>(packed.size()), root, archivePath, compressed, static_cast<int>(out.size()));
+		return true;
+	}
+}
+
+#endif // ASSET_ARCHIVE_H
@@ -0,0 +1,441 @@
+#ifndef ASSET_CACHE_H
+#define ASSET_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "image_jobs.h"
+#include "mesh_optimize.h"
+
+// --- ASSET CACHE ---
+// Drop-in replacements for LoadModel and LoadTexture that cook what they load into
+// GPU-ready blobs on disk, the way ShaderCache keeps programs. A miss parses the source as
+// raylib does (for models, then runs MeshOptimize) and writes the result; a hit maps the
+// blob and hands the mapped vertex, index and pixel data straight to the upload, with
+// nothing decoded. The key hashes the file name, its modification time and C_VERSION, so
+// editing a source or changing the layout simply misses.
+//
+// Blob format: Header, then for a model `materialCount` colours and one MeshRecord per
+// mesh, for a texture one TextureRecord; then the streams each record points at, every
+// one C_ALIGN-aligned. One file per key in Directory().
+namespace AssetCache {
+	// Bumped by worker threads too (see AsyncLoader).
+	struct Stats {
+		std::atomic<int> hits{ 0 };
+		std::atomic<int> misses{ 0 };
+	};
+
+	inline Stats& Counters() {
+		static Stats stats;
+		return stats;
+	}
+
+	inline const char* Directory() {
+		return "asset_cache";
+	}
+
+	namespace Detail {
+		constexpr uint32_t C_VERSION = 1;
+		constexpr size_t   C_ALIGN = 64;
+		constexpr int      C_STREAMS = 7;
+		inline constexpr char C_MAGIC[8] = { 'P', 'O', 'I', 'G', 'K', 'A', 'C', '1' };
+
+		enum Kind : uint32_t { C_MODEL = 1, C_TEXTURE = 2, C_MIPMAPPED = 3 };  // C_MIPMAPPED: a key only, for a texture blob with its mip chain
+		enum Stream { C_VERTICES, C_TEXCOORDS, C_NORMALS, C_COLORS, C_TANGENTS, C_TEXCOORDS2, C_INDICES };
+
+		struct Header {
+			char     magic[8];
+			uint64_t key;
+			uint32_t kind;
+			uint32_t count;          // meshes, or 1 for a texture
+			uint32_t materialCount;  // models only
+			uint32_t reserved;
+		};
+
+		// A stream's offset is 0 when the mesh doesn't have it.
+		struct MeshRecord {
+			int32_t  vertexCount;
+			int32_t  triangleCount;
+			int32_t  material;
+			int32_t  reserved;
+			uint64_t offsets[C_STREAMS];
+		};
+
+		struct TextureRecord {
+			int32_t  width;
+			int32_t  height;
+			int32_t  format;
+			int32_t  mipmaps;
+			uint64_t offset;
+			uint64_t size;
+		};
+
+		// Bytes per vertex of each stream; indices are per triangle corner.
+		constexpr size_t C_STRIDES[C_STREAMS] = { 3 * sizeof(float), 2 * sizeof(float), 3 * sizeof(float), 4, 4 * sizeof(float), 2 * sizeof(float), sizeof(unsigned short) };
+
+		inline size_t StreamBytes(const MeshRecord& r, int stream) {
+			const size_t elements = (stream == C_INDICES) ? static_cast<size_t>(r.triangleCount) * 3 : static_cast<size_t>(r.vertexCount);
+			return elements * C_STRIDES[stream];
+		}
+
+		inline void* StreamOf(const Mesh& mesh, int stream) {
+			switch (stream) {
+				case C_VERTICES:   return mesh.vertices;
+				case C_TEXCOORDS:  return mesh.texcoords;
+				case C_NORMALS:    return mesh.normals;
+				case C_COLORS:     return mesh.colors;
+				case C_TANGENTS:   return mesh.tangents;
+				case C_TEXCOORDS2: return mesh.texcoords2;
+				default:           return mesh.indices;
+			}
+		}
+
+		inline void SetStream(Mesh& mesh, int stream, void* data) {
+			switch (stream) {
+				case C_VERTICES:   mesh.vertices = static_cast<float*>(data); break;
+				case C_TEXCOORDS:  mesh.texcoords = static_cast<float*>(data); break;
+				case C_NORMALS:    mesh.normals = static_cast<float*>(data); break;
+				case C_COLORS:     mesh.colors = static_cast<unsigned char*>(data); break;
+				case C_TANGENTS:   mesh.tangents = static_cast<float*>(data); break;
+				case C_TEXCOORDS2: mesh.texcoords2 = static_cast<float*>(data); break;
+				default:           mesh.indices = static_cast<unsigned short*>(data); break;
+			}
+		}
+
+		// FNV-1a over the name, the source's modification time and the format version.
+		inline uint64_t Key(const char* fileName, uint32_t kind) {
+			uint64_t h = 14695981039346656037ull;
+			auto mix = [&h](const void* data, size_t bytes) {
+				const unsigned char* p = static_cast<const unsigned char*>(data);
+				for (size_t i = 0; i < bytes; ++i) h = (h ^ p[i]) * 1099511628211ull;
+			};
+			const long modified = GetFileModTime(fileName);
+			mix(fileName, strlen(fileName));
+			mix(&modified, sizeof(modified));
+			mix(&kind, sizeof(kind));
+			mix(&C_VERSION, sizeof(C_VERSION));
+			return h;
+		}
+
+		// Not TextFormat: its buffers are shared, and this runs on worker threads.
+		inline std::string PathOf(uint64_t key) {
+			char name[32];
+			snprintf(name, sizeof(name), "/%016llx.blob", static_cast<unsigned long long>(key));
+			return std::string(Directory()) + name;
+		}
+
+		// A view of a whole file (MapFileData), unmapped when it goes out of scope.
+		class MappedFile {
+		public:
+			explicit MappedFile(const char* path) {
+				int bytes = 0;
+				data = MapFileData(path, &bytes);
+				size = static_cast<size_t>(bytes);
+			}
+
+			~MappedFile() {
+				UnmapFileData(data, static_cast<int>(size));
+			}
+
+			MappedFile(const MappedFile&) = delete;
+			MappedFile& operator=(const MappedFile&) = delete;
+
+			const unsigned char* Data() const {
+				return data;
+			}
+
+			size_t Size() const {
+				return size;
+			}
+
+			// `bytes` at `offset` lie inside the file.
+			bool Contains(uint64_t offset, uint64_t bytes) const {
+				return offset <= size && bytes <= size - offset;
+			}
+
+		private:
+			unsigned char* data = nullptr;
+			size_t         size = 0;
+		};
+
+		// Blob under construction: records first, streams appended behind them, aligned.
+		struct Writer {
+			std::vector<unsigned char> bytes;
+
+			template<typename T>
+			size_t Put(const T& value) {
+				return Append(&value, sizeof(T));
+			}
+
+			size_t Append(const void* data, size_t count) {
+				const size_t at = bytes.size();
+				bytes.resize(at + count);
+				if (count) memcpy(bytes.data() + at, data, count);
+				return at;
+			}
+
+			size_t AppendAligned(const void* data, size_t count) {
+				bytes.resize((bytes.size() + C_ALIGN - 1) / C_ALIGN * C_ALIGN);
+				return Append(data, count);
+			}
+
+			bool Save(uint64_t key) {
+				std::error_code ignored;
+				std::filesystem::create_directories(Directory(), ignored);
+				return SaveFileData(PathOf(key).c_str(), bytes.data(), static_cast<int>(bytes.size()));
+			}
+		};
+
+		inline Header MakeHeader(uint64_t key, Kind kind, uint32_t count, uint32_t materialCount) {
+			Header h{};
+			memcpy(h.magic, C_MAGIC, sizeof(C_MAGIC));
+			h.key = key;
+			h.kind = kind;
+			h.count = count;
+			h.materialCount = materialCount;
+			return h;
+		}
+
+		// The mapped header, if it is one of ours for `key`.
+		inline const Header* Check(const MappedFile& file, uint64_t key, Kind kind) {
+			if (!file.Data() || file.Size() < sizeof(Header)) return nullptr;
+			const Header* h = reinterpret_cast<const Header*>(file.Data());
+			const bool valid = memcmp(h->magic, C_MAGIC, sizeof(C_MAGIC)) == 0 && h->key == key && h->kind == kind;
+			return valid ? h : nullptr;
+		}
+
+		inline void CookModel(uint64_t key, const Model& model) {
+			Writer w;
+			w.Put(MakeHeader(key, C_MODEL, static_cast<uint32_t>(model.meshCount), static_cast<uint32_t>(model.materialCount)));
+			for (int i = 0; i < model.materialCount; ++i) w.Put(model.materials[i].maps[MATERIAL_MAP_DIFFUSE].color);
+			const size_t records = w.AppendAligned(nullptr, 0);
+			w.bytes.resize(records + sizeof(MeshRecord) * model.meshCount);
+			for (int m = 0; m < model.meshCount; ++m) {
+				const Mesh& mesh = model.meshes[m];
+				MeshRecord r{};
+				r.vertexCount = mesh.vertexCount;
+				r.triangleCount = mesh.triangleCount;
+				r.material = model.meshMaterial ? model.meshMaterial[m] : 0;
+				for (int s = 0; s < C_STREAMS; ++s) {
+					const void* stream = StreamOf(mesh, s);
+					if (stream) r.offsets[s] = w.AppendAligned(stream, StreamBytes(r, s));
+				}
+				memcpy(w.bytes.data() + records + sizeof(MeshRecord) * m, &r, sizeof(MeshRecord));
+			}
+			if (w.Save(key)) TraceLog(LOG_INFO, "ASSET CACHE: cooked %i mesh(es) into %s (%i bytes)", model.meshCount, PathOf(key).c_str(), static_cast<int>(w.bytes.size()));
+		}
+
+		inline void CookTexture(uint64_t key, const Image& image) {
+			Writer w;
+			w.Put(MakeHeader(key, C_TEXTURE, 1, 0));
+			const size_t record = w.AppendAligned(nullptr, 0);
+			w.bytes.resize(record + sizeof(TextureRecord));
+			TextureRecord r{};
+			r.width = image.width;
+			r.height = image.height;
+			r.format = image.format;
+			r.mipmaps = image.mipmaps;
+			r.size = static_cast<uint64_t>(GetPixelDataSize(image.width, image.height, image.format));
+			for (int level = 1, w2 = image.width, h2 = image.height; level < image.mipmaps; ++level) {
+				w2 = w2 > 1 ? w2 / 2 : 1;
+				h2 = h2 > 1 ? h2 / 2 : 1;
+				r.size += static_cast<uint64_t>(GetPixelDataSize(w2, h2, image.format));
+			}
+			r.offset = w.AppendAligned(image.data, static_cast<size_t>(r.size));
+			memcpy(w.bytes.data() + record, &r, sizeof(TextureRecord));
+			if (w.Save(key)) TraceLog(LOG_INFO, "ASSET CACHE: cooked %ix%i texture into %s", image.width, image.height, PathOf(key).c_str());
+		}
+
+		inline size_t RecordsOffset(size_t afterHeader) {
+			return (afterHeader + C_ALIGN - 1) / C_ALIGN * C_ALIGN;
+		}
+
+		// The model in the blob for `key`, uploaded from the mapping; meshCount 0 on a miss.
+		// Without `upload` nothing touches GL, and the meshes hold their CPU data only.
+		inline Model ReadModel(uint64_t key, bool keepCpuData, bool upload = true) {
+			Model model{};
+			MappedFile file(PathOf(key).c_str());
+			const Header* h = Check(file, key, C_MODEL);
+			if (!h || h->count == 0) return model;
+
+			const size_t colors = sizeof(Header);
+			const size_t records = RecordsOffset(colors + sizeof(Color) * h->materialCount);
+			if (!file.Contains(records, sizeof(MeshRecord) * static_cast<uint64_t>(h->count))) return model;
+			std::vector<MeshRecord> meshes(h->count);
+			memcpy(meshes.data(), file.Data() + records, sizeof(MeshRecord) * h->count);
+			for (const MeshRecord& r : meshes) {
+				if (r.vertexCount <= 0 || r.offsets[C_VERTICES] == 0 || r.material < 0 || static_cast<uint32_t>(r.material) >= h->materialCount) return model;
+				for (int s = 0; s < C_STREAMS; ++s) {
+					if (r.offsets[s] && !file.Contains(r.offsets[s], StreamBytes(r, s))) return model;
+				}
+			}
+
+			model.transform = MatrixIdentity();
+			model.materialCount = static_cast<int>(h->materialCount);
+			model.materials = static_cast<Material*>(MemAlloc(static_cast<unsigned int>(sizeof(Material) * model.materialCount)));
+			for (int i = 0; i < model.materialCount; ++i) {
+				model.materials[i] = LoadMaterialDefault();
+				memcpy(&model.materials[i].maps[MATERIAL_MAP_DIFFUSE].color, file.Data() + colors + sizeof(Color) * i, sizeof(Color));
+			}
+			model.meshCount = static_cast<int>(h->count);
+			model.meshes = static_cast<Mesh*>(MemAlloc(static_cast<unsigned int>(sizeof(Mesh) * model.meshCount)));
+			model.meshMaterial = static_cast<int*>(MemAlloc(static_cast<unsigned int>(sizeof(int) * model.meshCount)));
+			for (int m = 0; m < model.meshCount; ++m) {
+				const MeshRecord& r = meshes[m];
+				Mesh mesh{};
+				mesh.vertexCount = r.vertexCount;
+				mesh.triangleCount = r.triangleCount;
+				// Uploaded from the mapping itself; UploadMesh only reads the arrays.
+				for (int s = 0; s < C_STREAMS; ++s) {
+					if (r.offsets[s]) SetStream(mesh, s, const_cast<unsigned char*>(file.Data() + r.offsets[s]));
+				}
+				if (upload) UploadMesh(&mesh, false);
+				// The mapping goes away; the model owns whatever CPU copies it keeps.
+				for (int s = 0; s < C_STREAMS; ++s) {
+					void* copy = nullptr;
+					if (r.offsets[s] && (keepCpuData || !upload)) {
+						copy = MemAlloc(static_cast<unsigned int>(StreamBytes(r, s)));
+						memcpy(copy, file.Data() + r.offsets[s], StreamBytes(r, s));
+					}
+					SetStream(mesh, s, copy);
+				}
+				model.meshes[m] = mesh;
+				model.meshMaterial[m] = r.material;
+			}
+			return model;
+		}
+
+		// The checked texture record of a mapped blob.
+		inline bool TextureRecordOf(const MappedFile& file, uint64_t key, TextureRecord& r) {
+			const size_t record = RecordsOffset(sizeof(Header));
+			if (!Check(file, key, C_TEXTURE) || !file.Contains(record, sizeof(TextureRecord))) return false;
+			memcpy(&r, file.Data() + record, sizeof(TextureRecord));
+			return r.width > 0 && r.height > 0 && r.mipmaps > 0 && file.Contains(r.offset, r.size);
+		}
+
+		// The pixels in the blob for `key`, copied out; data nullptr on a miss. No GL.
+		inline Image ReadImage(uint64_t key) {
+			Image image{};
+			MappedFile file(PathOf(key).c_str());
+			TextureRecord r;
+			if (!TextureRecordOf(file, key, r)) return image;
+			image.data = MemAlloc(static_cast<unsigned int>(r.size));
+			memcpy(image.data, file.Data() + r.offset, static_cast<size_t>(r.size));
+			image.width = r.width;
+			image.height = r.height;
+			image.mipmaps = r.mipmaps;
+			image.format = r.format;
+			return image;
+		}
+
+		// The texture in the blob for `key`, uploaded from the mapping; id 0 on a miss.
+		inline Texture2D ReadTexture(uint64_t key) {
+			Texture2D texture{};
+			MappedFile file(PathOf(key).c_str());
+			TextureRecord r;
+			if (!TextureRecordOf(file, key, r)) return texture;
+
+			texture.id = rlLoadTexture(file.Data() + r.offset, r.width, r.height, r.format, r.mipmaps);
+			texture.width = r.width;
+			texture.height = r.height;
+			texture.mipmaps = r.mipmaps;
+			texture.format = r.format;
+			return texture;
+		}
+	}
+
+	// LoadModel through the cache. Misses are welded, indexed and reordered (MeshOptimize)
+	// before cooking, so hits come back that way too. Materials keep only their diffuse
+	// colour; load their textures with LoadTexture below. Without `keepCpuData` the meshes hold
+	// GPU buffers only, and anything reading mesh.vertices and friends won't work on them.
+	// Skinned or animated models aren't cooked.
+	inline Model LoadModel(const char* fileName, bool keepCpuData = true) {
+		const uint64_t key = Detail::Key(fileName, Detail::C_MODEL);
+		Model model = Detail::ReadModel(key, keepCpuData);
+		if (model.meshCount > 0) {
+			++Counters().hits;
+			TraceLog(LOG_INFO, "ASSET CACHE: %s mapped from %s", fileName, Detail::PathOf(key).c_str());
+			return model;
+		}
+
+		++Counters().misses;
+		model = ::LoadModel(fileName);
+		if (model.meshCount == 0 || model.boneCount > 0) return model;
+		const MeshOptimize::Stats stats = MeshOptimize::Optimize(model);
+		TraceLog(LOG_INFO, "ASSET CACHE: %s: %i -> %i vertices, %.2f -> %.2f cache misses per triangle", fileName, stats.verticesBefore, stats.verticesAfter, stats.acmrBefore, stats.acmrAfter);
+		Detail::CookModel(key, model);
+		return model;
+	}
+
+	// LoadTexture through the cache: the decoded pixels are cooked as they are.
+	inline Texture2D LoadTexture(const char* fileName) {
+		const uint64_t key = Detail::Key(fileName, Detail::C_TEXTURE);
+		Texture2D texture = Detail::ReadTexture(key);
+		if (texture.id != 0) {
+			++Counters().hits;
+			TraceLog(LOG_INFO, "ASSET CACHE: [ID %u] %s mapped from %s", texture.id, fileName, Detail::PathOf(key).c_str());
+			return texture;
+		}
+
+		++Counters().misses;
+		Image image = LoadImage(fileName);
+		if (image.data == nullptr) return texture;
+		Detail::CookTexture(key, image);
+		texture = LoadTextureFromImage(image);
+		UnloadImage(image);
+		return texture;
+	}
+
+	// The CPU half of LoadModel, safe off the main thread: a cooked model with its mesh data
+	// and no GPU buffers (UploadMesh each mesh), or meshCount 0 if it isn't cooked yet. A
+	// model can't be cooked here, since raylib uploads inside LoadModel.
+	inline Model LoadModelData(const char* fileName) {
+		const uint64_t key = Detail::Key(fileName, Detail::C_MODEL);
+		Model model = Detail::ReadModel(key, true, false);
+		if (model.meshCount > 0) ++Counters().hits;
+		return model;
+	}
+
+	// The CPU half of LoadTexture, safe off the main thread: decodes and cooks on a miss.
+	inline Image LoadImageData(const char* fileName) {
+		const uint64_t key = Detail::Key(fileName, Detail::C_TEXTURE);
+		Image image = Detail::ReadImage(key);
+		if (image.data != nullptr) {
+			++Counters().hits;
+			return image;
+		}
+
+		++Counters().misses;
+		image = LoadImage(fileName);
+		if (image.data != nullptr) Detail::CookTexture(key, image);
+		return image;
+	}
+
+	// LoadImageData with the full mip chain, generated before cooking on a miss, so a hit maps
+	// every level as it is (see TextureStreamer). Compressed sources keep the levels they have.
+	inline Image LoadMipmappedImageData(const char* fileName) {
+		const uint64_t key = Detail::Key(fileName, Detail::C_MIPMAPPED);
+		Image image = Detail::ReadImage(key);
+		if (image.data != nullptr) {
+			++Counters().hits;
+			return image;
+		}
+
+		++Counters().misses;
+		image = LoadImage(fileName);
+		if (image.data == nullptr) return image;
+		if (image.format < PIXELFORMAT_COMPRESSED_DXT1_RGB) ImageJobs::Mipmaps(&image);
+		Detail::CookTexture(key, image);
+		return image;
+	}
+}
+
+#endif // ASSET_CACHE_H
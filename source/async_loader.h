@@ -0,0 +1,295 @@
+#ifndef ASYNC_LOADER_H
+#define ASYNC_LOADER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "asset_cache.h"
+#include "jobs.h"
+
+// --- ASYNC LOADING ---
+// Models, textures and images read and decoded on the JobSystem's workers, then handed to
+// the GPU on the main thread, which owns the GL context. Jobs do the file I/O, cache lookups
+// and image decoding (AssetCache::LoadModelData / LoadImageData), at most `threads` of them
+// (Start()) at a time so loading never takes over the pool; Pump() uploads what they've
+// finished, a budget of bytes at a time so a frame doesn't hitch on a big asset, mesh by mesh
+// for models. Each asset's callback runs on the main thread inside Pump() once it is fully
+// on the GPU, so until then the caller keeps drawing whatever placeholder it had.
+//
+// A model that isn't cooked yet can't be loaded off the main thread: raylib uploads inside
+// LoadModel. Its worker only finds that out, and Pump() loads and cooks it in one go, so the
+// first run after a change still has that hitch and later runs don't.
+class AsyncLoader {
+public:
+	using ModelReady = std::function<void(Model&)>;
+	using TextureReady = std::function<void(Texture2D&)>;
+	using ImageReady = std::function<void(Image&)>;
+	using Task = std::function<bool()>;
+	using TaskDone = std::function<void(bool)>;
+
+	static constexpr int    C_THREADS = 2;
+	static constexpr size_t C_UPLOAD_BUDGET = 8u << 20;  // bytes per Pump()
+
+	~AsyncLoader() {
+		Stop();
+	}
+
+	// Requests made before Start() wait for it.
+	void Start(int threads = C_THREADS) {
+		int drains = 0;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = false;
+			limit = threads;
+			for (size_t queued = requests.size(); running < limit && queued > 0; --queued, ++drains) ++running;
+		}
+		for (; drains > 0; --drains) JobSystem::Instance().Run([this] { Drain(); }, &draining);
+	}
+
+	// Waits for the loads in progress. Anything not yet delivered is dropped; call before
+	// CloseWindow.
+	void Stop() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		JobSystem::Instance().Wait(draining);
+
+		if (current) decoded.push_front(std::move(current));
+		for (auto* queue : { &requests, &decoded }) {
+			for (auto& item : *queue) Discard(*item);
+			queue->clear();
+		}
+		outstanding = 0;
+	}
+
+	// `ready` gets the model with its meshes uploaded and their CPU data kept, and owns it.
+	void LoadModel(const char* fileName, ModelReady ready) {
+		auto item = std::make_unique<Item>(C_MODEL, fileName);
+		item->onModel = std::move(ready);
+		Request(std::move(item));
+	}
+
+	// `ready` gets the texture, and owns it. Files that fail to load are logged and dropped.
+	void LoadTexture(const char* fileName, TextureReady ready) {
+		auto item = std::make_unique<Item>(C_TEXTURE, fileName);
+		item->onTexture = std::move(ready);
+		Request(std::move(item));
+	}
+
+	// Decode only: `ready` gets the image in CPU memory, and owns it.
+	void LoadImage(const char* fileName, ImageReady ready) {
+		auto item = std::make_unique<Item>(C_IMAGE, fileName);
+		item->onImage = std::move(ready);
+		Request(std::move(item));
+	}
+
+	// LoadImage with every mip level, made on the worker (AssetCache::LoadMipmappedImageData).
+	void LoadMipmappedImage(const char* fileName, ImageReady ready) {
+		auto item = std::make_unique<Item>(C_MIPMAPPED_IMAGE, fileName);
+		item->onImage = std::move(ready);
+		Request(std::move(item));
+	}
+
+	// Runs `work` on a worker, for file work that needs no GL (cooking, say); `done` gets what
+	// it returned, in Pump().
+	void Run(Task work, TaskDone done) {
+		auto item = std::make_unique<Item>(C_TASK, "");
+		item->task = std::move(work);
+		item->onTask = std::move(done);
+		Request(std::move(item));
+	}
+
+	// Uploads finished assets until `budget` bytes have gone to the GPU, always at least one
+	// mesh or texture if there is one, and delivers those that are complete. Once a frame.
+	void Pump(size_t budget = C_UPLOAD_BUDGET) {
+		size_t spent = 0;
+		for (;;) {
+			if (!current) {
+				std::lock_guard<std::mutex> lock(mutex);
+				if (decoded.empty()) break;
+				current = std::move(decoded.front());
+				decoded.pop_front();
+			}
+			if (!Upload(*current, budget, spent)) break;
+			Deliver(*current);
+			current.reset();
+			--outstanding;
+		}
+		lastUploaded = spent;
+	}
+
+	// Blocks until every request so far has been delivered.
+	void Finish() {
+		while (outstanding > 0) {
+			Pump(SIZE_MAX);
+			if (outstanding == 0) break;
+			std::unique_lock<std::mutex> lock(mutex);
+			ready.wait(lock, [this] { return !decoded.empty(); });
+		}
+	}
+
+	// Requests not yet delivered.
+	int Outstanding() const {
+		return outstanding;
+	}
+
+	// Bytes uploaded by the last Pump().
+	size_t Uploaded() const {
+		return lastUploaded;
+	}
+
+private:
+	enum Kind { C_MODEL, C_TEXTURE, C_IMAGE, C_MIPMAPPED_IMAGE, C_TASK };
+
+	struct Item {
+		Item(Kind k, const char* name) : kind(k), fileName(name) {}
+
+		Kind         kind;
+		std::string  fileName;
+		Model        model{};
+		Image        image{};
+		int          nextMesh = 0;  // meshes uploaded so far
+		ModelReady   onModel;
+		TextureReady onTexture;
+		ImageReady   onImage;
+		Task         task;
+		bool         succeeded = false;
+		TaskDone     onTask;
+	};
+
+	void Request(std::unique_ptr<Item> item) {
+		bool drain = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			requests.push_back(std::move(item));
+			if (running < limit) {
+				++running;
+				drain = true;
+			}
+		}
+		++outstanding;
+		if (drain) JobSystem::Instance().Run([this] { Drain(); }, &draining);
+	}
+
+	// A job on the pool: loads requests, oldest first, until there are none left.
+	void Drain() {
+		for (;;) {
+			std::unique_ptr<Item> item;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (quit || requests.empty()) {
+					--running;
+					return;
+				}
+				item = std::move(requests.front());
+				requests.pop_front();
+			}
+			if (item->kind == C_MODEL) item->model = AssetCache::LoadModelData(item->fileName.c_str());
+			else if (item->kind == C_TASK) item->succeeded = item->task();
+			else if (item->kind == C_MIPMAPPED_IMAGE) item->image = AssetCache::LoadMipmappedImageData(item->fileName.c_str());
+			else item->image = AssetCache::LoadImageData(item->fileName.c_str());
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				decoded.push_back(std::move(item));
+			}
+			ready.notify_one();
+		}
+	}
+
+	static size_t MeshBytes(const Mesh& mesh) {
+		const size_t v = static_cast<size_t>(mesh.vertexCount);
+		size_t bytes = v * 3 * sizeof(float);
+		if (mesh.texcoords) bytes += v * 2 * sizeof(float);
+		if (mesh.texcoords2) bytes += v * 2 * sizeof(float);
+		if (mesh.normals) bytes += v * 3 * sizeof(float);
+		if (mesh.tangents) bytes += v * 4 * sizeof(float);
+		if (mesh.colors) bytes += v * 4;
+		if (mesh.indices) bytes += static_cast<size_t>(mesh.triangleCount) * 3 * sizeof(unsigned short);
+		return bytes;
+	}
+
+	// Uploads as much of `item` as the budget allows; true once it is all on the GPU.
+	bool Upload(Item& item, size_t budget, size_t& spent) {
+		switch (item.kind) {
+		case C_MODEL:
+			if (item.model.meshCount == 0) {
+				// Not cooked: raylib's loader has to run here (see above).
+				item.model = AssetCache::LoadModel(item.fileName.c_str());
+				for (int m = 0; m < item.model.meshCount; ++m) spent += MeshBytes(item.model.meshes[m]);
+				item.nextMesh = item.model.meshCount;
+			}
+			for (; item.nextMesh < item.model.meshCount; ++item.nextMesh) {
+				Mesh& mesh = item.model.meshes[item.nextMesh];
+				const size_t bytes = MeshBytes(mesh);
+				if (spent > 0 && spent + bytes > budget) return false;
+				UploadMesh(&mesh, false);
+				spent += bytes;
+			}
+			return true;
+		case C_TEXTURE: {
+			if (item.image.data == nullptr) return true;
+			const size_t bytes = static_cast<size_t>(GetPixelDataSize(item.image.width, item.image.height, item.image.format));
+			if (spent > 0 && spent + bytes > budget) return false;
+			spent += bytes;
+			return true;
+		}
+		default:
+			return true;
+		}
+	}
+
+	void Deliver(Item& item) {
+		switch (item.kind) {
+		case C_MODEL:
+			item.onModel(item.model);
+			break;
+		case C_TEXTURE: {
+			if (item.image.data == nullptr) {
+				TraceLog(LOG_WARNING, "ASYNC: %s failed to load", item.fileName.c_str());
+				break;
+			}
+			Texture2D texture = LoadTextureFromImage(item.image);
+			UnloadImage(item.image);
+			item.onTexture(texture);
+			break;
+		}
+		case C_IMAGE:
+		case C_MIPMAPPED_IMAGE:
+			item.onImage(item.image);
+			break;
+		case C_TASK:
+			item.onTask(item.succeeded);
+			break;
+		}
+	}
+
+	// Frees an undelivered item. Models may be part uploaded; UnloadModel handles both kinds
+	// of mesh.
+	static void Discard(Item& item) {
+		if (item.model.meshCount > 0) UnloadModel(item.model);
+		if (item.image.data != nullptr) UnloadImage(item.image);
+	}
+
+	JobCounter                         draining;  // Drain() jobs on the pool
+	std::mutex                         mutex;
+	std::condition_variable            ready;  // decoded items for Finish()
+	int                                limit = 0;    // Drain() jobs at once, from Start()
+	int                                running = 0;  // Drain() jobs on the pool now
+	std::deque<std::unique_ptr<Item>>  requests;
+	std::deque<std::unique_ptr<Item>>  decoded;
+	std::unique_ptr<Item>              current;  // being uploaded across Pump() calls
+	bool                               quit = false;
+	int                                outstanding = 0;  // main thread only
+	size_t                             lastUploaded = 0;
+};
+
+#endif // ASYNC_LOADER_H
@@ -0,0 +1,61 @@
+// Headless simulation throughput benchmark (Bench.exe in build.bat).
+// Reports ticks per second of Application's fixed tick at several entity counts, then
+// compares the broadphases across densities, with no window or GL context, so it can run
+// on CI machines without a GPU.
+#define POIGK_NO_MAIN
+#include "main.cpp"
+
+#include <cstdio>
+
+int main(int argc, char** argv) {
+	MemoryTracker::Install();
+	SetTraceLogLevel(LOG_WARNING);
+	int ticks = (argc > 1) ? TextToInteger(argv[1]) : 240;
+	if (ticks <= 0) {
+		fprintf(stderr, "usage: Bench.exe [ticks]  (ticks per run, a positive integer; 240 by default)\n");
+		return 1;
+	}
+	const size_t counts[] = { 1'000, 10'000, 100'000 };
+
+	Application& app = Application::Instance();
+	app.Seed(1234);
+	app.InitHeadless();
+
+	printf("%-10s %-12s %-12s %-12s %-12s\n", "entities", "ticks", "ms/tick", "ticks/s", "ns/entity");
+	for (size_t n : counts) {
+		app.ResetWorld();
+		auto stats = app.RunHeadless(ticks, n, n);
+		double msPerTick = stats.seconds * 1000.0 / stats.ticks;
+		printf("%-10zu %-12d %-12.3f %-12.0f %-12.1f\n",
+			n, stats.ticks, msPerTick, stats.ticks / stats.seconds, msPerTick * 1e6 / (2.0 * n));
+	}
+
+	// Same entity count in worlds of different size: a small world is a dense brawl where
+	// every grid cell is crowded, a large one a sparse field where most cells are empty.
+	// Brute force is quadratic, so it only runs on the smaller counts. So does kinetic: the
+	// top-up gives every tick a field full of new entities, its worst case.
+	const int worlds[] = { 800, 1600, 4000 };
+	const size_t broadCounts[] = { 2'000, 8'000 };
+	const Broadphase modes[] = { Broadphase::GRID, Broadphase::INCREMENTAL, Broadphase::SWEEP, Broadphase::BRUTE, Broadphase::KINETIC };
+	const int broadTicks = ticks / 4 > 0 ? ticks / 4 : 1;
+
+	printf("\n%-10s %-10s %-10s %-12s %-12s\n", "world", "entities", "broadphase", "ms/tick", "ticks/s");
+	for (int world : worlds) {
+		for (size_t n : broadCounts) {
+			for (Broadphase mode : modes) {
+				if ((mode == Broadphase::BRUTE || mode == Broadphase::KINETIC) && n > 2'000) continue;
+				Scenario scenario;
+				scenario.width = world;
+				scenario.height = world;
+				app.Configure(scenario);
+				app.SetBroadphase(mode);
+				app.ResetWorld();
+				auto stats = app.RunHeadless(broadTicks, n, n);
+				double msPerTick = stats.seconds * 1000.0 / stats.ticks;
+				printf("%-10d %-10zu %-10s %-12.3f %-12.0f\n",
+					world, n, BroadphaseName(mode), msPerTick, stats.ticks / stats.seconds);
+			}
+		}
+	}
+	return 0;
+}
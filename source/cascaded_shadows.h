@@ -0,0 +1,219 @@
+#ifndef CASCADED_SHADOWS_H
+#define CASCADED_SHADOWS_H
+
+#include <algorithm>
+#include <cmath>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // glDrawBuffer, which rlgl doesn't wrap
+
+// --- CASCADED SHADOWS ---
+// Shadow maps for one directional light. The view up to C_DISTANCE is split into
+// C_CASCADES slices (a blend of even and logarithmic splits) and each slice gets its own
+// C_RESOLUTION page, side by side in one depth atlas. A page covers its slice's bounding
+// sphere, which keeps the same size however the camera turns, and its centre is snapped
+// to whole texels in light space, so edges don't crawl as the camera moves.
+//
+// Pages are caches. Each one covers C_MARGIN times its slice, and is drawn again only
+// once its slice leaves that window, the light turns, or MarkDirty() says a caster moved.
+// A still scene renders no shadow pages at all.
+class CascadedShadows {
+public:
+	static constexpr int   C_CASCADES = 3;
+	static constexpr int   C_RESOLUTION = 2048;
+	static constexpr float C_DISTANCE = 40.0f;      // shadows end here
+	static constexpr float C_SPLIT_LAMBDA = 0.75f;  // 0 = even splits, 1 = logarithmic
+	static constexpr float C_MARGIN = 1.3f;         // page size over slice size
+	static constexpr float C_DEPTH_RANGE = 200.0f;  // casters this far towards the light still count
+	static constexpr int   C_SHADOW_UNIT = 15;      // texture unit for the atlas, clear of material maps and the batch
+
+	void Init() {
+		fbo = rlLoadFramebuffer(C_RESOLUTION * C_CASCADES, C_RESOLUTION);
+		atlas = rlLoadTextureDepth(C_RESOLUTION * C_CASCADES, C_RESOLUTION, false);
+		rlFramebufferAttach(fbo, atlas, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+		rlEnableFramebuffer(fbo);
+		glDrawBuffer(GL_NONE);  // depth only
+		glReadBuffer(GL_NONE);
+		rlDisableFramebuffer();
+		if (!rlFramebufferComplete(fbo)) TraceLog(LOG_WARNING, "SHADOWS: atlas framebuffer is incomplete");
+		MarkDirty();
+	}
+
+	void Unload() {
+		rlUnloadFramebuffer(fbo);  // takes the depth texture with it
+		fbo = atlas = 0;
+	}
+
+	// Normalised here. Any change invalidates every page.
+	void SetLight(Vector3 direction) {
+		direction = Vector3Normalize(direction);
+		if (Vector3Equals(direction, lightDir)) return;
+		lightDir = direction;
+		MarkDirty();
+	}
+
+	Vector3 LightDirection() const {
+		return lightDir;
+	}
+
+	// Shadow casters moved: redraw every page on the next Update.
+	void MarkDirty() {
+		for (Page& p : pages) p.valid = false;
+	}
+
+	// Fits the cascades to this view and redraws the pages that need it, calling
+	// drawCasters() once per page with the light's matrices current. `aspect` is the
+	// viewport's width over height.
+	template<typename DrawCasters>
+	void Update(const Camera3D& camera, float aspect, DrawCasters&& drawCasters) {
+		const Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+		const float tanY = tanf(camera.fovy * DEG2RAD * 0.5f);
+		const float tanX = tanY * aspect;
+		const Matrix rotation = LightRotation();
+
+		rendered = 0;
+		float nearDistance = C_NEAR;
+		for (int i = 0; i < C_CASCADES; ++i) {
+			const float t = static_cast<float>(i + 1) / C_CASCADES;
+			const float farDistance = C_SPLIT_LAMBDA * C_NEAR * powf(C_DISTANCE / C_NEAR, t)
+				+ (1.0f - C_SPLIT_LAMBDA) * (C_NEAR + (C_DISTANCE - C_NEAR) * t);
+			splits[i] = farDistance;
+
+			// Bounding sphere of the slice: centred on the view axis, through its far corners.
+			const float nearDiagonal2 = nearDistance * nearDistance * (tanX * tanX + tanY * tanY);
+			const float farDiagonal2 = farDistance * farDistance * (tanX * tanX + tanY * tanY);
+			float along = 0.5f * (nearDistance + farDistance + (farDiagonal2 - nearDiagonal2) / (farDistance - nearDistance));
+			along = std::min(along, farDistance);
+			const float radius = sqrtf((farDistance - along) * (farDistance - along) + farDiagonal2);
+			const Vector3 center = Vector3Add(camera.position, Vector3Scale(forward, along));
+
+			Page& page = pages[i];
+			const Vector3 local = Vector3Transform(center, rotation);
+			const bool fits = page.valid
+				&& fabsf(local.x - page.center.x) + radius <= page.halfSize
+				&& fabsf(local.y - page.center.y) + radius <= page.halfSize
+				&& fabsf(local.z - page.center.z) + radius <= C_DEPTH_RANGE * 0.5f;
+			if (!fits) {
+				Refit(page, local, radius * C_MARGIN, rotation);
+				Render(i, drawCasters);
+				++rendered;
+			}
+			nearDistance = farDistance;
+		}
+	}
+
+	// Fetches the shadow uniforms; needed again for every program that replaces this one.
+	void Bind(Shader& shader) {
+		for (int i = 0; i < C_CASCADES; ++i) lightVPLocs[i] = GetShaderLocation(shader, TextFormat("lightVP[%i]", i));
+		splitsLoc = GetShaderLocation(shader, "cascadeSplits");
+		texelLoc = GetShaderLocation(shader, "cascadeTexel");
+		lightDirLoc = GetShaderLocation(shader, "lightDir");
+		viewDirLoc = GetShaderLocation(shader, "viewDir");
+		const int unit = C_SHADOW_UNIT;
+		const int resolution = C_RESOLUTION;
+		const float depthRange = C_DEPTH_RANGE;
+		SetShaderValue(shader, GetShaderLocation(shader, "shadowMap"), &unit, SHADER_UNIFORM_INT);
+		SetShaderValue(shader, GetShaderLocation(shader, "shadowMapResolution"), &resolution, SHADER_UNIFORM_INT);
+		SetShaderValue(shader, GetShaderLocation(shader, "shadowDepthRange"), &depthRange, SHADER_UNIFORM_FLOAT);
+	}
+
+	// Sends this frame's cascades and binds the atlas; call before drawing receivers.
+	void Apply(Shader& shader, const Camera3D& camera) const {
+		float texel[C_CASCADES];
+		for (int i = 0; i < C_CASCADES; ++i) {
+			SetShaderValueMatrix(shader, lightVPLocs[i], MatrixMultiply(pages[i].view, pages[i].projection));
+			texel[i] = 2.0f * pages[i].halfSize / C_RESOLUTION;
+		}
+		const Vector3 viewDir = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+		SetShaderValue(shader, splitsLoc, splits, SHADER_UNIFORM_VEC3);
+		SetShaderValue(shader, texelLoc, texel, SHADER_UNIFORM_VEC3);
+		SetShaderValue(shader, lightDirLoc, &lightDir, SHADER_UNIFORM_VEC3);
+		SetShaderValue(shader, viewDirLoc, &viewDir, SHADER_UNIFORM_VEC3);
+
+		rlActiveTextureSlot(C_SHADOW_UNIT);
+		rlEnableTexture(atlas);
+		rlActiveTextureSlot(0);
+	}
+
+	// Pages redrawn by the last Update.
+	int PagesRendered() const {
+		return rendered;
+	}
+
+private:
+	static_assert(C_CASCADES == 3, "cascadeSplits and cascadeTexel are vec3 in the shaders");
+
+	static constexpr float C_NEAR = 0.1f;
+
+	struct Page {
+		Vector3 center{};  // light space, snapped
+		float   halfSize = 0.0f;
+		Matrix  view = MatrixIdentity();
+		Matrix  projection = MatrixIdentity();
+		bool    valid = false;
+	};
+
+	Matrix LightRotation() const {
+		const Vector3 up = fabsf(lightDir.y) > 0.99f ? Vector3{ 0.0f, 0.0f, 1.0f } : Vector3{ 0.0f, 1.0f, 0.0f };
+		return MatrixLookAt(Vector3Zero(), lightDir, up);
+	}
+
+	// Centres the page on `local` to the nearest texel and rebuilds its matrices.
+	static void Refit(Page& page, Vector3 local, float halfSize, const Matrix& rotation) {
+		const float texel = 2.0f * halfSize / C_RESOLUTION;
+		page.center = { floorf(local.x / texel) * texel, floorf(local.y / texel) * texel, local.z };
+		page.halfSize = halfSize;
+		// Light space looks down -z: put the eye half the depth range in front of the centre.
+		page.view = MatrixMultiply(rotation, MatrixTranslate(-page.center.x, -page.center.y, -(page.center.z + C_DEPTH_RANGE * 0.5f)));
+		page.projection = MatrixOrtho(-halfSize, halfSize, -halfSize, halfSize, 0.0, C_DEPTH_RANGE);
+		page.valid = true;
+	}
+
+	template<typename DrawCasters>
+	void Render(int index, DrawCasters& drawCasters) {
+		rlDrawRenderBatchActive();
+		const Matrix savedView = rlGetMatrixModelview();
+		const Matrix savedProjection = rlGetMatrixProjection();
+
+		rlEnableFramebuffer(fbo);
+		rlViewport(index * C_RESOLUTION, 0, C_RESOLUTION, C_RESOLUTION);
+		rlEnableScissorTest();
+		rlScissor(index * C_RESOLUTION, 0, C_RESOLUTION, C_RESOLUTION);
+		rlClearScreenBuffers();
+		rlDisableScissorTest();
+		rlEnableDepthTest();
+		rlDisableColorBlend();
+
+		rlSetMatrixModelview(pages[index].view);
+		rlSetMatrixProjection(pages[index].projection);
+		// Casters may use the receiving shader; it must not sample the atlas being written.
+		rlActiveTextureSlot(C_SHADOW_UNIT);
+		rlDisableTexture();
+		rlActiveTextureSlot(0);
+		drawCasters();
+		rlDrawRenderBatchActive();
+
+		rlSetMatrixModelview(savedView);
+		rlSetMatrixProjection(savedProjection);
+		rlEnableColorBlend();
+		rlDisableDepthTest();
+		rlDisableFramebuffer();
+		rlViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+	}
+
+	unsigned int fbo = 0;
+	unsigned int atlas = 0;
+	Vector3      lightDir{ 0.0f, -1.0f, 0.0f };
+	Page         pages[C_CASCADES];
+	float        splits[C_CASCADES] = {};
+	int          rendered = 0;
+	int          lightVPLocs[C_CASCADES] = { -1, -1, -1 };
+	int          splitsLoc = -1;
+	int          texelLoc = -1;
+	int          lightDirLoc = -1;
+	int          viewDirLoc = -1;
+};
+
+#endif // CASCADED_SHADOWS_H
@@ -0,0 +1,239 @@
+#ifndef CLUSTERED_LIGHTS_H
+#define CLUSTERED_LIGHTS_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+// --- CLUSTERED LIGHTING ---
+// Forward shading for hundreds of point lights. The view frustum is cut into a grid of
+// C_TILES_X x C_TILES_Y screen tiles by C_SLICES depth slices (exponential, so near slices
+// are thin), and every frame the CPU lists which lights reach each cluster. A fragment
+// looks up its own cluster and shades only that list, so its cost follows how many lights
+// overlap it rather than how many exist.
+//
+// GL 3.3 has no storage buffers, so everything travels in float textures read with
+// texelFetch: the lights (two texels each), the grid (offset and count per cluster) and
+// the flattened index lists. They ride in material map slots 1-3, which DrawMesh already
+// binds, so no draw call needs changing. Point lights only; each fades to zero at its
+// radius, which is what makes dropping it outside that radius exact.
+struct PointLight {
+	Vector3 position;
+	float   radius;
+	Color   color;
+};
+
+// Points a material map slot at a light texture without handing it over: the light list
+// still unloads it. UnloadModel leaves material textures alone, but UnloadMaterial unloads
+// every map texture, so a material headed there needs its slots cleared first.
+inline void SetLightSlot(Material& material, int slot, unsigned int id, int width, int height, int format) {
+	Texture2D& t = material.maps[slot].texture;
+	t.id = id;
+	t.width = width;
+	t.height = height;
+	t.mipmaps = 1;
+	t.format = format;
+}
+
+inline void ClearLightSlot(Material& material, int slot) {
+	material.maps[slot].texture = Texture2D{};
+}
+
+class ClusteredLights {
+public:
+	static constexpr int   C_TILES_X = 16;
+	static constexpr int   C_TILES_Y = 9;
+	static constexpr int   C_SLICES = 24;
+	static constexpr int   C_CLUSTERS = C_TILES_X * C_TILES_Y * C_SLICES;
+	static constexpr int   C_MAX_LIGHTS = 2048;
+	static constexpr int   C_MAX_PER_CLUSTER = 128;  // further lights in a cluster are dropped
+	static constexpr int   C_INDEX_WIDTH = 1024;
+	static constexpr int   C_INDEX_ROWS = C_CLUSTERS * C_MAX_PER_CLUSTER / C_INDEX_WIDTH;
+	static constexpr float C_NEAR = 0.1f;   // depth range the slices span; anything outside
+	static constexpr float C_FAR = 100.0f;  // lands in the first or last slice
+
+	struct Stats {
+		int lights = 0;      // lights submitted
+		int visible = 0;     // reached at least one cluster
+		int references = 0;  // light-cluster pairs written
+		int busiest = 0;     // longest cluster list
+		int dropped = 0;     // pairs lost to C_MAX_PER_CLUSTER
+	};
+
+	void Init() {
+		lightData = rlLoadTexture(nullptr, 2 * C_MAX_LIGHTS, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+		gridData = rlLoadTexture(nullptr, C_TILES_X * C_TILES_Y, C_SLICES, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+		indexData = rlLoadTexture(nullptr, C_INDEX_WIDTH, C_INDEX_ROWS, PIXELFORMAT_UNCOMPRESSED_R32, 1);
+		lightTexels.resize(2 * C_MAX_LIGHTS * 4);
+		grid.resize(C_CLUSTERS * 4);
+		counts.resize(C_CLUSTERS);
+		indices.resize(C_CLUSTERS * C_MAX_PER_CLUSTER);
+	}
+
+	void Unload() {
+		rlUnloadTexture(lightData);
+		rlUnloadTexture(gridData);
+		rlUnloadTexture(indexData);
+		lightData = gridData = indexData = 0;
+	}
+
+	// Fetches the cluster uniforms and points the map slots at the cluster samplers. Needed
+	// again for every program that replaces this one.
+	void Bind(Shader& shader) {
+		shader.locs[SHADER_LOC_MAP_SPECULAR] = GetShaderLocation(shader, "clusterLights");
+		shader.locs[SHADER_LOC_MAP_NORMAL] = GetShaderLocation(shader, "clusterGrid");
+		shader.locs[SHADER_LOC_MAP_ROUGHNESS] = GetShaderLocation(shader, "clusterIndices");
+		tileLoc = GetShaderLocation(shader, "clusterTile");
+		tilesLoc = GetShaderLocation(shader, "clusterTiles");
+		depthLoc = GetShaderLocation(shader, "clusterDepth");
+	}
+
+	void Attach(Material& material) const {
+		SetLightSlot(material, MATERIAL_MAP_SPECULAR, lightData, 2 * C_MAX_LIGHTS, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+		SetLightSlot(material, MATERIAL_MAP_NORMAL, gridData, C_TILES_X * C_TILES_Y, C_SLICES, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+		SetLightSlot(material, MATERIAL_MAP_ROUGHNESS, indexData, C_INDEX_WIDTH, C_INDEX_ROWS, PIXELFORMAT_UNCOMPRESSED_R32);
+	}
+
+	void Detach(Material& material) const {
+		for (int slot : { MATERIAL_MAP_SPECULAR, MATERIAL_MAP_NORMAL, MATERIAL_MAP_ROUGHNESS }) ClearLightSlot(material, slot);
+	}
+
+	// Rebuilds the clusters for this view and uploads them. `width` and `height` are the
+	// size of the target being drawn to. Lights past C_MAX_LIGHTS are ignored.
+	void Update(const std::vector<PointLight>& lights, const Camera3D& camera, int width, int height, Shader& shader) {
+		const int n = std::min(static_cast<int>(lights.size()), C_MAX_LIGHTS);
+		const Matrix view = GetCameraMatrix(camera);
+		const float tanY = tanf(camera.fovy * DEG2RAD * 0.5f);
+		const float tanX = tanY * static_cast<float>(width) / static_cast<float>(height);
+		const float sliceScale = static_cast<float>(C_SLICES) / logf(C_FAR / C_NEAR);
+		const float sliceBias = -logf(C_NEAR) * sliceScale;
+
+		stats = Stats{};
+		stats.lights = n;
+		ranges.clear();
+		std::fill(counts.begin(), counts.end(), 0);
+
+		for (int i = 0; i < n; ++i) {
+			const PointLight& l = lights[i];
+			float* texel = &lightTexels[i * 8];
+			texel[0] = l.position.x;
+			texel[1] = l.position.y;
+			texel[2] = l.position.z;
+			texel[3] = l.radius;
+			texel[4] = static_cast<float>(l.color.r) / 255.0f;
+			texel[5] = static_cast<float>(l.color.g) / 255.0f;
+			texel[6] = static_cast<float>(l.color.b) / 255.0f;
+			texel[7] = 0.0f;
+
+			Range range;
+			if (!Cover(Vector3Transform(l.position, view), l.radius, tanX, tanY, sliceScale, sliceBias, range)) continue;
+			range.light = i;
+			ranges.push_back(range);
+			++stats.visible;
+			ForEachCluster(range, [&](int c) { ++counts[c]; });
+		}
+
+		int offset = 0;
+		for (int c = 0; c < C_CLUSTERS; ++c) {
+			const int count = std::min(counts[c], C_MAX_PER_CLUSTER);
+			stats.dropped += counts[c] - count;
+			stats.busiest = std::max(stats.busiest, count);
+			grid[c * 4 + 0] = static_cast<float>(offset);
+			grid[c * 4 + 1] = static_cast<float>(count);
+			counts[c] = offset;  // reused as the write cursor
+			offset += count;
+		}
+		stats.references = offset;
+
+		for (const Range& range : ranges) {
+			ForEachCluster(range, [&](int c) {
+				const int end = static_cast<int>(grid[c * 4 + 0] + grid[c * 4 + 1]);
+				if (counts[c] < end) indices[counts[c]++] = static_cast<float>(range.light);
+			});
+		}
+
+		if (n > 0) rlUpdateTexture(lightData, 0, 0, 2 * n, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, lightTexels.data());
+		rlUpdateTexture(gridData, 0, 0, C_TILES_X * C_TILES_Y, C_SLICES, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, grid.data());
+		const int rows = (offset + C_INDEX_WIDTH - 1) / C_INDEX_WIDTH;
+		if (rows > 0) rlUpdateTexture(indexData, 0, 0, C_INDEX_WIDTH, rows, PIXELFORMAT_UNCOMPRESSED_R32, indices.data());
+
+		const float tile[2] = { static_cast<float>(width) / C_TILES_X, static_cast<float>(height) / C_TILES_Y };
+		const int tiles[2] = { C_TILES_X, C_TILES_Y };
+		const float depth[2] = { sliceScale, sliceBias };
+		SetShaderValue(shader, tileLoc, tile, SHADER_UNIFORM_VEC2);
+		SetShaderValue(shader, tilesLoc, tiles, SHADER_UNIFORM_IVEC2);
+		SetShaderValue(shader, depthLoc, depth, SHADER_UNIFORM_VEC2);
+	}
+
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+private:
+	// Clusters a light reaches, as inclusive tile and slice bounds.
+	struct Range {
+		int light;
+		int x0, x1, y0, y1, z0, z1;
+	};
+
+	// Conservative bounds of a view-space sphere. Each screen edge of its box is taken at
+	// whichever depth pushes it furthest out, clamped to C_NEAR in front of the camera.
+	static bool Cover(Vector3 v, float r, float tanX, float tanY, float sliceScale, float sliceBias, Range& out) {
+		const float depth = -v.z;
+		if (depth + r < C_NEAR) return false;
+		const float dNear = std::max(depth - r, C_NEAR);
+		const float dFar = std::max(depth + r, C_NEAR);
+
+		auto lowEdge = [&](float lo) { return lo < 0.0f ? lo / dNear : lo / dFar; };
+		auto highEdge = [&](float hi) { return hi > 0.0f ? hi / dNear : hi / dFar; };
+		const float left = lowEdge(v.x - r) / tanX;
+		const float right = highEdge(v.x + r) / tanX;
+		const float bottom = lowEdge(v.y - r) / tanY;
+		const float top = highEdge(v.y + r) / tanY;
+		if (left > 1.0f || right < -1.0f || bottom > 1.0f || top < -1.0f) return false;
+
+		auto tile = [](float ndc, int tiles) {
+			return std::clamp(static_cast<int>(floorf((ndc * 0.5f + 0.5f) * static_cast<float>(tiles))), 0, tiles - 1);
+		};
+		auto slice = [&](float d) {
+			return std::clamp(static_cast<int>(floorf(logf(d) * sliceScale + sliceBias)), 0, C_SLICES - 1);
+		};
+		out.x0 = tile(left, C_TILES_X);
+		out.x1 = tile(right, C_TILES_X);
+		out.y0 = tile(bottom, C_TILES_Y);
+		out.y1 = tile(top, C_TILES_Y);
+		out.z0 = slice(dNear);
+		out.z1 = slice(dFar);
+		return true;
+	}
+
+	// Clusters are laid out as the grid texture is: x + y*C_TILES_X along a row, one row per slice.
+	template<typename F>
+	static void ForEachCluster(const Range& r, F&& visit) {
+		for (int z = r.z0; z <= r.z1; ++z) {
+			for (int y = r.y0; y <= r.y1; ++y) {
+				for (int x = r.x0; x <= r.x1; ++x) visit((z * C_TILES_Y + y) * C_TILES_X + x);
+			}
+		}
+	}
+
+	unsigned int lightData = 0;
+	unsigned int gridData = 0;
+	unsigned int indexData = 0;
+	int          tileLoc = -1;
+	int          tilesLoc = -1;
+	int          depthLoc = -1;
+
+	std::vector<float> lightTexels;
+	std::vector<float> grid;
+	std::vector<float> indices;
+	std::vector<int>   counts;
+	std::vector<Range> ranges;
+	Stats              stats;
+};
+
+#endif // CLUSTERED_LIGHTS_H
@@ -0,0 +1,87 @@
+#ifndef COLLISION_EVENTS_H
+#define COLLISION_EVENTS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "frame_arena.h"
+
+// --- COLLISION EVENTS ---
+// What the detection passes hand to the resolve pass. Detection runs in ParallelFor chunks
+// against a world nobody is changing and only appends events, each chunk to a buffer of its
+// own; ForEach() then walks them in pass order, chunk order and append order, which is the
+// order a single-threaded loop would have found them in however the chunks were scheduled.
+// Nothing is applied until then, so damage, scoring and removal stay on one thread. The
+// buffers' storage comes from the tick's arena (FrameArena): Clear() them before it is reset.
+struct CollisionEvent {
+	enum class Kind : uint8_t { PROJECTILE_ASTEROID, SHIP_ASTEROID };
+
+	uint32_t a;     // the projectile's slot or the ship's index
+	uint32_t b;     // the asteroid's index
+	Kind     kind;
+};
+
+class CollisionEvents {
+public:
+	using Buffer = ArenaVector<CollisionEvent>;
+
+	explicit CollisionEvents(std::pmr::memory_resource* storage) : arena(storage) {}
+
+	// Drops last tick's events along with their buffers.
+	void Clear() {
+		buffers.clear();
+		used = 0;
+	}
+
+	// Makes room for a pass that will ParallelFor over `count` items with `minChunk` and
+	// returns its first buffer. Every chunk begins on a multiple of its size, which is at
+	// least minChunk, so begin / minChunk gives each chunk a buffer of its own, in order.
+	size_t AddPass(size_t count, size_t minChunk) {
+		const size_t base = used;
+		used += (count + minChunk - 1) / minChunk;
+		while (buffers.size() < used) buffers.emplace_back(arena);
+		return base;
+	}
+
+	// The buffer of the chunk starting at `begin` in the pass at `base`. One chunk's only.
+	Buffer& Chunk(size_t base, size_t begin, size_t minChunk) {
+		return buffers[base + begin / minChunk];
+	}
+
+	// Moves a pass's events into its first buffer in asteroid order, the order a loop over
+	// the asteroids would have found them in, for a pass that finds them from the other side.
+	void SortByAsteroid(size_t base, size_t count, size_t minChunk) {
+		const size_t end = base + (count + minChunk - 1) / minChunk;
+		if (end == base) return;
+		Buffer& first = buffers[base];
+		for (size_t i = base + 1; i < end; ++i) {
+			first.insert(first.end(), buffers[i].begin(), buffers[i].end());
+			buffers[i].clear();
+		}
+		std::stable_sort(first.begin(), first.end(), [](const CollisionEvent& x, const CollisionEvent& y) { return x.b < y.b; });
+	}
+
+	// fn(event) for every event, in the order described above.
+	template<typename Fn>
+	void ForEach(Fn&& fn) const {
+		for (size_t i = 0; i < used; ++i) {
+			for (const CollisionEvent& e : buffers[i]) fn(e);
+		}
+	}
+
+	size_t Count() const {
+		size_t n = 0;
+		for (size_t i = 0; i < used; ++i) n += buffers[i].size();
+		return n;
+	}
+
+private:
+	std::pmr::memory_resource* arena;
+	std::vector<Buffer>        buffers;  // keeps its capacity, the buffers' is the arena's
+	size_t                     used = 0;
+};
+
+#endif // COLLISION_EVENTS_H
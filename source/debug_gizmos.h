@@ -0,0 +1,201 @@
+#ifndef DEBUG_GIZMOS_H
+#define DEBUG_GIZMOS_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "shader_cache.h"
+#include "external/glad.h"  // instanced line draws, which rlgl doesn't wrap
+
+// --- DEBUG GIZMOS ---
+// Debug shapes drawn instanced, one draw per shape whatever the count, in place of
+// DrawSphereEx and company, which build every sphere's triangles in the immediate-mode
+// batch each frame. Each shape is a unit mesh built once (C_SPHERE_RINGS x C_SPHERE_SLICES
+// for spheres), and an instance is a position, a per-axis extent and a colour, all of a
+// frame's instances in one buffer re-specified by Flush(). Shapes:
+//   - Sphere, WireSphere: at `centre`, of `radius` (wire spheres are three great circles);
+//   - WireBox: a bounding box's edges;
+//   - Arrow: a line from `from` to `to` with a four-line head, gizmo.vs turning the unit
+//     arrow onto the span.
+// Gizmos are unlit. Call Flush() inside BeginMode3D, once the frame's shapes are added.
+class GizmoBatch {
+public:
+	static constexpr int C_SPHERE_RINGS = 8;
+	static constexpr int C_SPHERE_SLICES = 8;
+	static constexpr int C_CIRCLE_SEGMENTS = 24;
+
+	void Init() {
+		shader = ShaderCache::Load("../resources/shaders/glsl330/gizmo.vs", "../resources/shaders/glsl330/gizmo.fs");
+		arrowLoc = GetShaderLocation(shader, "arrow");
+		glGenBuffers(1, &instanceVbo);
+
+		std::vector<Vector3> v;
+		// Solid sphere: two triangles per ring and slice, as DrawSphereEx.
+		for (int ring = 0; ring < C_SPHERE_RINGS; ++ring) {
+			for (int slice = 0; slice < C_SPHERE_SLICES; ++slice) {
+				const Vector3 a = SpherePoint(ring, slice), b = SpherePoint(ring + 1, slice);
+				const Vector3 c = SpherePoint(ring + 1, slice + 1), d = SpherePoint(ring, slice + 1);
+				v.insert(v.end(), { a, c, b, a, d, c });  // counter-clockwise from outside
+			}
+		}
+		Build(shapes[C_SPHERE], GL_TRIANGLES, v);
+
+		v.clear();
+		for (int s = 0; s < C_CIRCLE_SEGMENTS; ++s) {
+			const float t0 = 2.0f * PI * s / C_CIRCLE_SEGMENTS, t1 = 2.0f * PI * (s + 1) / C_CIRCLE_SEGMENTS;
+			v.insert(v.end(), { { cosf(t0), sinf(t0), 0 }, { cosf(t1), sinf(t1), 0 } });
+			v.insert(v.end(), { { cosf(t0), 0, sinf(t0) }, { cosf(t1), 0, sinf(t1) } });
+			v.insert(v.end(), { { 0, cosf(t0), sinf(t0) }, { 0, cosf(t1), sinf(t1) } });
+		}
+		Build(shapes[C_WIRE_SPHERE], GL_LINES, v);
+
+		v.clear();
+		for (int axis = 0; axis < 3; ++axis) {
+			for (int corner = 0; corner < 4; ++corner) {
+				float lo[3], hi[3];
+				const int u = (axis + 1) % 3, w = (axis + 2) % 3;
+				lo[axis] = -0.5f;
+				hi[axis] = 0.5f;
+				lo[u] = hi[u] = (corner & 1) ? 0.5f : -0.5f;
+				lo[w] = hi[w] = (corner & 2) ? 0.5f : -0.5f;
+				v.insert(v.end(), { { lo[0], lo[1], lo[2] }, { hi[0], hi[1], hi[2] } });
+			}
+		}
+		Build(shapes[C_WIRE_BOX], GL_LINES, v);
+
+		// Unit arrow along +Z: the shaft, then the head's four barbs.
+		v.assign({ { 0, 0, 0 }, { 0, 0, 1 } });
+		for (const Vector3 side : { Vector3{ 1, 0, 0 }, Vector3{ -1, 0, 0 }, Vector3{ 0, 1, 0 }, Vector3{ 0, -1, 0 } }) {
+			v.insert(v.end(), { { 0, 0, 1 }, { side.x * 0.08f, side.y * 0.08f, 0.8f } });
+		}
+		Build(shapes[C_ARROW], GL_LINES, v);
+	}
+
+	void Unload() {
+		for (Shape& s : shapes) {
+			glDeleteVertexArrays(1, &s.vao);
+			glDeleteBuffers(1, &s.vbo);
+			s = Shape{};
+		}
+		glDeleteBuffers(1, &instanceVbo);
+		instanceVbo = 0;
+		UnloadShader(shader);
+	}
+
+	void Sphere(Vector3 centre, float radius, Color color) {
+		shapes[C_SPHERE].instances.push_back({ centre, { radius, radius, radius }, color });
+	}
+
+	void WireSphere(Vector3 centre, float radius, Color color) {
+		shapes[C_WIRE_SPHERE].instances.push_back({ centre, { radius, radius, radius }, color });
+	}
+
+	void WireBox(BoundingBox box, Color color) {
+		shapes[C_WIRE_BOX].instances.push_back({ Vector3Lerp(box.min, box.max, 0.5f), Vector3Subtract(box.max, box.min), color });
+	}
+
+	void Arrow(Vector3 from, Vector3 to, Color color) {
+		shapes[C_ARROW].instances.push_back({ from, Vector3Subtract(to, from), color });
+	}
+
+	// Draws everything added since the last Flush, then forgets it.
+	void Flush() {
+		lastInstances = 0;
+		lastDraws = 0;
+		std::vector<Instance>& all = scratch;
+		all.clear();
+		for (const Shape& s : shapes) all.insert(all.end(), s.instances.begin(), s.instances.end());
+		if (all.empty()) return;
+
+		rlDrawRenderBatchActive();
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(all.size() * sizeof(Instance)), all.data(), GL_STREAM_DRAW);
+		rlEnableShader(shader.id);
+		rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection()));
+		size_t first = 0;
+		for (int kind = 0; kind < C_SHAPES; ++kind) {
+			Shape& s = shapes[kind];
+			if (s.instances.empty()) continue;
+			const int arrow = (kind == C_ARROW) ? 1 : 0;
+			rlSetUniform(arrowLoc, &arrow, SHADER_UNIFORM_INT, 1);
+			glBindVertexArray(s.vao);
+			const size_t base = first * sizeof(Instance);
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), reinterpret_cast<const void*>(base + offsetof(Instance, position)));
+			glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), reinterpret_cast<const void*>(base + offsetof(Instance, extent)));
+			glVertexAttribPointer(3, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Instance), reinterpret_cast<const void*>(base + offsetof(Instance, color)));
+			glDrawArraysInstanced(s.primitive, 0, s.vertexCount, static_cast<GLsizei>(s.instances.size()));
+			first += s.instances.size();
+			s.instances.clear();
+			++lastDraws;
+		}
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		rlDisableShader();
+		lastInstances = static_cast<int>(all.size());
+	}
+
+	// Of the last Flush.
+	int Instances() const {
+		return lastInstances;
+	}
+
+	int Draws() const {
+		return lastDraws;
+	}
+
+private:
+	enum Kind { C_SPHERE, C_WIRE_SPHERE, C_WIRE_BOX, C_ARROW, C_SHAPES };
+
+	struct Instance {
+		Vector3 position;
+		Vector3 extent;
+		Color   color;
+	};
+
+	struct Shape {
+		unsigned int          vao = 0;
+		unsigned int          vbo = 0;
+		GLenum                primitive = GL_LINES;
+		int                   vertexCount = 0;
+		std::vector<Instance> instances;  // this frame's
+	};
+
+	static Vector3 SpherePoint(int ring, int slice) {
+		const float polar = PI * ring / C_SPHERE_RINGS, azimuth = 2.0f * PI * slice / C_SPHERE_SLICES;
+		return { sinf(polar) * cosf(azimuth), cosf(polar), sinf(polar) * sinf(azimuth) };
+	}
+
+	// The shape's vertex array: unit-mesh positions at 0, instance attributes 1-3 from the
+	// instance buffer, their offsets set per Flush.
+	void Build(Shape& s, GLenum primitive, const std::vector<Vector3>& vertices) {
+		s.primitive = primitive;
+		s.vertexCount = static_cast<int>(vertices.size());
+		glGenVertexArrays(1, &s.vao);
+		glBindVertexArray(s.vao);
+		glGenBuffers(1, &s.vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, s.vbo);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(Vector3)), vertices.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+		glEnableVertexAttribArray(0);
+		for (unsigned int a = 1; a <= 3; ++a) {
+			glEnableVertexAttribArray(a);
+			glVertexAttribDivisor(a, 1);
+		}
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	Shape                 shapes[C_SHAPES];
+	std::vector<Instance> scratch;
+	Shader                shader{};
+	int                   arrowLoc = -1;
+	unsigned int          instanceVbo = 0;
+	int                   lastInstances = 0;
+	int                   lastDraws = 0;
+};
+
+#endif // DEBUG_GIZMOS_H
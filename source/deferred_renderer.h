@@ -0,0 +1,248 @@
+#ifndef DEFERRED_RENDERER_H
+#define DEFERRED_RENDERER_H
+
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "rlights.h"
+#include "clustered_lights.h"
+#include "shader_cache.h"
+
+// --- DEFERRED SHADING ---
+// Three passes over one G-buffer (position, normal, albedo + specular, and a depth
+// renderbuffer):
+//   1. geometry: the scene drawn once with gbuffer.vs/fs, colour blending off;
+//   2. lights: deferred_shading.fs over the whole screen for the rlights.h lights (read from
+//      the shared light buffer, ambient included), then every PointLight as a sphere volume
+//      added on top, so a light only costs the pixels it covers;
+//   3. composite: gamma and background into an output target, which is drawn to the screen.
+// Surfaces are shaded once per light however much geometry overlapped them. The light and
+// output targets share the G-buffer's depth, so unlit overlays drawn between Shade() and
+// Present() are still hidden by the scene; the window itself is multisampled and cannot
+// take a depth blit.
+class DeferredRenderer {
+public:
+	void Init(int w, int h) {
+		width = w;
+		height = h;
+
+		gbuffer = rlLoadFramebuffer(width, height);
+		rlEnableFramebuffer(gbuffer);
+		targets[C_POSITION] = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16, 1);
+		targets[C_NORMAL] = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16, 1);
+		targets[C_ALBEDO] = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+		rlActiveDrawBuffers(3);
+		for (int i = 0; i < 3; ++i) rlFramebufferAttach(gbuffer, targets[i], RL_ATTACHMENT_COLOR_CHANNEL0 + i, RL_ATTACHMENT_TEXTURE2D, 0);
+		depth = rlLoadTextureDepth(width, height, true);
+		rlFramebufferAttach(gbuffer, depth, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+		if (!rlFramebufferComplete(gbuffer)) TraceLog(LOG_WARNING, "DEFERRED: G-buffer framebuffer is incomplete");
+
+		accumulation = LoadTarget(lightFbo, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16);
+		output = LoadTarget(outputFbo, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		rlDisableFramebuffer();
+
+		geometry = ShaderCache::Load("../resources/shaders/glsl330/gbuffer.vs", "../resources/shaders/glsl330/gbuffer.fs");
+		geometry.locs[SHADER_LOC_MAP_DIFFUSE] = GetShaderLocation(geometry, "diffuseTexture");
+		// No specular maps here; its sampler stays on unit 0, the diffuse map, as in raylib's example.
+		// The material's other slots may hold unrelated textures (see ClusteredLights).
+		geometry.locs[SHADER_LOC_MAP_SPECULAR] = -1;
+		geometry.locs[SHADER_LOC_MAP_NORMAL] = -1;
+		geometry.locs[SHADER_LOC_MAP_ROUGHNESS] = -1;
+
+		ambient = ShaderCache::Load("../resources/shaders/glsl330/deferred_shading.vs", "../resources/shaders/glsl330/deferred_shading.fs");
+		BindLightBuffer(ambient);
+		ambientViewLoc = GetShaderLocation(ambient, "viewPosition");
+		BindSamplers(ambient);
+
+		volume = ShaderCache::Load("../resources/shaders/glsl330/deferred_light.vs", "../resources/shaders/glsl330/deferred_light.fs");
+		volumeViewLoc = GetShaderLocation(volume, "viewPosition");
+		volumeLightLoc = GetShaderLocation(volume, "lightPositionRadius");
+		volumeColorLoc = GetShaderLocation(volume, "lightColor");
+		BindSamplers(volume);
+		const float size[2] = { static_cast<float>(width), static_cast<float>(height) };
+		SetShaderValue(volume, GetShaderLocation(volume, "screenSize"), size, SHADER_UNIFORM_VEC2);
+		sphere = GenMeshSphere(1.0f, 12, 12);
+		volumeMaterial = LoadMaterialDefault();
+		volumeMaterial.shader = volume;
+
+		composite = ShaderCache::Load("../resources/shaders/glsl330/deferred_shading.vs", "../resources/shaders/glsl330/deferred_composite.fs");
+		BindSamplers(composite);
+		const int accumulationSlot = C_ACCUMULATION_SLOT;
+		SetShaderValue(composite, GetShaderLocation(composite, "lightAccumulation"), &accumulationSlot, SHADER_UNIFORM_INT);
+		backgroundLoc = GetShaderLocation(composite, "background");
+	}
+
+	void Unload() {
+		UnloadShader(geometry);
+		UnloadShader(ambient);
+		UnloadShader(composite);
+		UnloadShader(volume);
+		MemFree(volumeMaterial.maps);  // the material's shader is `volume`, already gone
+		UnloadMesh(sphere);
+
+		// The shared depth goes with the G-buffer; detach it first so it is deleted once.
+		for (unsigned int fbo : { lightFbo, outputFbo }) {
+			rlFramebufferAttach(fbo, 0, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+			rlUnloadFramebuffer(fbo);
+		}
+		rlUnloadFramebuffer(gbuffer);
+		for (unsigned int id : targets) rlUnloadTexture(id);
+		rlUnloadTexture(accumulation);
+		rlUnloadTexture(output);
+	}
+
+	// Give this to materials drawn between BeginGeometry and EndGeometry.
+	Shader GeometryShader() const {
+		return geometry;
+	}
+
+	void BeginGeometry(const Camera3D& camera) {
+		rlDrawRenderBatchActive();
+		rlEnableFramebuffer(gbuffer);
+		rlClearColor(0, 0, 0, 0);
+		rlClearScreenBuffers();
+		rlDisableColorBlend();  // albedo's alpha carries specular, not coverage
+		BeginMode3D(camera);
+	}
+
+	void EndGeometry() {
+		EndMode3D();
+		rlEnableColorBlend();
+		rlDisableFramebuffer();
+	}
+
+	// Light accumulation and composite. `volumes` are shaded as sphere volumes on top of the
+	// rlights.h lights already in the light buffer.
+	void Shade(const Camera3D& camera, const std::vector<PointLight>& volumes, Color background) {
+		const float view[3] = { camera.position.x, camera.position.y, camera.position.z };
+		BindTargets();
+
+		rlEnableFramebuffer(lightFbo);
+		rlDisableDepthMask();  // the depth is the G-buffer's; only the overlay tests against it
+		SetShaderValue(ambient, ambientViewLoc, view, SHADER_UNIFORM_VEC3);
+		rlEnableShader(ambient.id);
+		rlLoadDrawQuad();
+		rlDisableShader();
+
+		SetShaderValue(volume, volumeViewLoc, view, SHADER_UNIFORM_VEC3);
+		BeginMode3D(camera);
+		rlDisableDepthTest();  // BeginMode3D turned it on
+		BeginBlendMode(BLEND_ADD_COLORS);
+		rlSetCullFace(RL_CULL_FACE_FRONT);  // back faces still cover the light from inside it
+		for (const PointLight& l : volumes) {
+			const float light[4] = { l.position.x, l.position.y, l.position.z, l.radius };
+			const float color[3] = { static_cast<float>(l.color.r) / 255.0f, static_cast<float>(l.color.g) / 255.0f, static_cast<float>(l.color.b) / 255.0f };
+			SetShaderValue(volume, volumeLightLoc, light, SHADER_UNIFORM_VEC4);
+			SetShaderValue(volume, volumeColorLoc, color, SHADER_UNIFORM_VEC3);
+			// Scaled past the radius so the faceted sphere still encloses the true one.
+			const float r = l.radius * C_VOLUME_MARGIN;
+			DrawMesh(sphere, volumeMaterial, MatrixMultiply(MatrixScale(r, r, r), MatrixTranslate(l.position.x, l.position.y, l.position.z)));
+		}
+		rlSetCullFace(RL_CULL_FACE_BACK);
+		EndBlendMode();
+		EndMode3D();
+		volumesShaded = static_cast<int>(volumes.size());
+
+		rlEnableFramebuffer(outputFbo);
+		const Vector4 clear = ColorNormalize(background);
+		SetShaderValue(composite, backgroundLoc, &clear, SHADER_UNIFORM_VEC4);
+		rlActiveTextureSlot(C_ACCUMULATION_SLOT);
+		rlEnableTexture(accumulation);
+		rlEnableShader(composite.id);
+		rlLoadDrawQuad();
+		rlDisableShader();
+		rlDisableTexture();
+
+		UnbindTargets();
+		rlEnableDepthMask();
+	}
+
+	// Forward-drawn extras (gizmos, light markers) over the shaded scene, depth-tested
+	// against it. Only valid straight after Shade().
+	void BeginOverlay(const Camera3D& camera) {
+		rlEnableFramebuffer(outputFbo);
+		BeginMode3D(camera);
+	}
+
+	void EndOverlay() {
+		EndMode3D();
+		rlDisableFramebuffer();
+	}
+
+	// Draws the result into the current target; call between BeginDrawing and EndDrawing.
+	void Present() const {
+		Texture2D texture{ output, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+		DrawTextureRec(texture, { 0, 0, static_cast<float>(width), -static_cast<float>(height) }, { 0, 0 }, WHITE);
+	}
+
+	int VolumesShaded() const {
+		return volumesShaded;
+	}
+
+private:
+	enum { C_POSITION, C_NORMAL, C_ALBEDO };
+	static constexpr int   C_FIRST_SLOT = 1;         // G-buffer on units 1-3, clear of DrawMesh's unit 0
+	static constexpr int   C_ACCUMULATION_SLOT = 4;
+	static constexpr float C_VOLUME_MARGIN = 1.1f;
+
+	unsigned int LoadTarget(unsigned int& fbo, int format) const {
+		fbo = rlLoadFramebuffer(width, height);
+		rlEnableFramebuffer(fbo);
+		unsigned int texture = rlLoadTexture(nullptr, width, height, format, 1);
+		rlFramebufferAttach(fbo, texture, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+		rlFramebufferAttach(fbo, depth, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+		if (!rlFramebufferComplete(fbo)) TraceLog(LOG_WARNING, "DEFERRED: [ID %u] target framebuffer is incomplete", fbo);
+		return texture;
+	}
+
+	static void BindSamplers(Shader shader) {
+		const char* names[3] = { "gPosition", "gNormal", "gAlbedoSpec" };
+		for (int i = 0; i < 3; ++i) {
+			const int slot = C_FIRST_SLOT + i;
+			SetShaderValue(shader, GetShaderLocation(shader, names[i]), &slot, SHADER_UNIFORM_INT);
+		}
+	}
+
+	void BindTargets() const {
+		for (int i = 0; i < 3; ++i) {
+			rlActiveTextureSlot(C_FIRST_SLOT + i);
+			rlEnableTexture(targets[i]);
+		}
+		rlActiveTextureSlot(0);
+	}
+
+	static void UnbindTargets() {
+		for (int i = 0; i < 3; ++i) {
+			rlActiveTextureSlot(C_FIRST_SLOT + i);
+			rlDisableTexture();
+		}
+		rlActiveTextureSlot(0);
+	}
+
+	int          width = 0;
+	int          height = 0;
+	unsigned int gbuffer = 0;
+	unsigned int targets[3] = {};
+	unsigned int depth = 0;
+	unsigned int lightFbo = 0;
+	unsigned int accumulation = 0;
+	unsigned int outputFbo = 0;
+	unsigned int output = 0;
+
+	Shader   geometry{};
+	Shader   ambient{};
+	Shader   volume{};
+	Shader   composite{};
+	Mesh     sphere{};
+	Material volumeMaterial{};
+	int      ambientViewLoc = -1;
+	int      volumeViewLoc = -1;
+	int      volumeLightLoc = -1;
+	int      volumeColorLoc = -1;
+	int      backgroundLoc = -1;
+	int      volumesShaded = 0;
+};
+
+#endif // DEFERRED_RENDERER_H
@@ -0,0 +1,195 @@
+#ifndef DEPTH_PREPASS_H
+#define DEPTH_PREPASS_H
+
+#include <vector>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "shader_cache.h"
+#include "external/glad.h"  // colour masks and occlusion queries, which rlgl doesn't wrap
+
+// --- DEPTH PRE-PASS ---
+// Fragment shading cost of forward-drawn scenes, and the means to cut it:
+//   - pre-pass: the opaque geometry drawn first with colour writes off and an empty fragment
+//     shader, then the lit pass with depth writes off, so rlgl's LEQUAL test lets each pixel's
+//     front surface through and nothing behind it; the expensive shader runs once per pixel;
+//   - counting: the lit pass inside a GL_SAMPLES_PASSED query, read back C_LATENCY frames later so
+//     it never stalls, gives the fragments actually shaded per screen pixel;
+//   - overdraw view: the same geometry drawn with overdraw.fs into a float target, additively
+//     and with the pre-pass or not as the lit pass would be, then turned into a heatmap of how
+//     many fragments each pixel shaded.
+// Both passes draw through Draw(), which swaps the models' material shaders for the current
+// stand-in, whose vertex shader is lighting.vs: it places vertices exactly as pbr.vs does, so
+// the depths match, and decodes meshes in VertexCompression's compact layout, which raylib's
+// default shader can't. Instanced and skinned draws have their own vertex shaders and stay out.
+class DepthPrepass {
+public:
+	static constexpr int   C_LATENCY = 3;        // frames between a query and its readback
+	static constexpr float C_LAYER_VALUE = 0.2f; // what overdraw.fs adds per fragment
+
+	void Init(int w, int h) {
+		width = w;
+		height = h;
+		depthOnly = ShaderCache::Load("../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/depth_prepass.fs");
+		overdraw = ShaderCache::Load("../resources/shaders/glsl330/lighting.vs", "../resources/shaders/glsl330/overdraw.fs");
+		heatmap = ShaderCache::Load(nullptr, "../resources/shaders/glsl330/overdraw_heatmap.fs");
+		const float layer = C_LAYER_VALUE;
+		SetShaderValue(heatmap, GetShaderLocation(heatmap, "layerValue"), &layer, SHADER_UNIFORM_FLOAT);
+
+		// The window's own sample count, for the counts of lit passes drawn into it.
+		GLint samples = 0;
+		glGetIntegerv(GL_SAMPLES, &samples);
+		windowSamples = samples > 1 ? samples : 1;
+		glGenQueries(C_LATENCY, queries);
+
+		target.id = rlLoadFramebuffer(width, height);
+		rlEnableFramebuffer(target.id);
+		target.texture.id = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16, 1);
+		target.texture.width = width;
+		target.texture.height = height;
+		target.texture.mipmaps = 1;
+		target.texture.format = PIXELFORMAT_UNCOMPRESSED_R16G16B16A16;
+		rlFramebufferAttach(target.id, target.texture.id, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+		target.depth.id = rlLoadTextureDepth(width, height, true);
+		target.depth.width = width;
+		target.depth.height = height;
+		rlFramebufferAttach(target.id, target.depth.id, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_RENDERBUFFER, 0);
+		if (!rlFramebufferComplete(target.id)) TraceLog(LOG_WARNING, "PREPASS: [ID %u] overdraw framebuffer is incomplete", target.id);
+		rlDisableFramebuffer();
+	}
+
+	void Unload() {
+		UnloadShader(depthOnly);
+		UnloadShader(overdraw);
+		UnloadShader(heatmap);
+		glDeleteQueries(C_LATENCY, queries);
+		UnloadRenderTexture(target);  // the depth renderbuffer goes with the framebuffer
+	}
+
+	// Depth only, inside BeginMode3D; draw the opaque geometry through Draw() in between.
+	void BeginPrepass() {
+		rlDrawRenderBatchActive();
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		active = depthOnly;
+	}
+
+	// Leaves depth writes off for the lit pass; EndShading() turns them back on.
+	void EndPrepass() {
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		rlDisableDepthMask();
+	}
+
+	void EndShading() {
+		rlDrawRenderBatchActive();
+		rlEnableDepthMask();
+	}
+
+	// DrawModel with the materials' shaders replaced by the current pass's.
+	void Draw(const Model& model, Vector3 position, float scale, Color tint) {
+		saved.resize(static_cast<size_t>(model.materialCount));
+		for (int i = 0; i < model.materialCount; ++i) {
+			saved[i] = model.materials[i].shader;
+			model.materials[i].shader = active;
+		}
+		DrawModel(model, position, scale, tint);
+		for (int i = 0; i < model.materialCount; ++i) model.materials[i].shader = saved[i];
+	}
+
+	// Around the lit pass drawn into the window. One count in flight per slot: a frame whose
+	// slot hasn't been read back yet goes uncounted.
+	void BeginCount() {
+		Begin(windowSamples);
+	}
+
+	void EndCount() {
+		End();
+	}
+
+	// Fragments shaded per pixel by the newest pass read back, or 0 before the first.
+	float ShadedPerPixel() const {
+		return shadedPerPixel;
+	}
+
+	// Renders the overdraw heatmap of `drawScene`, which draws the same geometry as the lit
+	// pass through Draw(). With `prepass`, it counts what the lit pass would after a pre-pass.
+	// Opens its own BeginMode3D, so call outside one (and outside BeginDrawing is fine).
+	template <typename DrawScene>
+	void RenderOverdraw(const Camera3D& camera, bool prepass, DrawScene&& drawScene) {
+		BeginTextureMode(target);
+		ClearBackground(BLANK);
+		BeginMode3D(camera);
+		if (prepass) {
+			BeginPrepass();
+			drawScene();
+			EndPrepass();
+		}
+		active = overdraw;
+		BeginBlendMode(BLEND_ADDITIVE);
+		Begin(1);
+		drawScene();
+		End();
+		EndBlendMode();
+		EndShading();
+		EndMode3D();
+		EndTextureMode();
+	}
+
+	// Draws the last RenderOverdraw as a heatmap into the current target.
+	void Present() const {
+		BeginShaderMode(heatmap);
+		DrawTextureRec(target.texture, { 0, 0, static_cast<float>(width), -static_cast<float>(height) }, { 0, 0 }, WHITE);
+		EndShaderMode();
+	}
+
+private:
+	void Begin(int samples) {
+		Collect();
+		rlDrawRenderBatchActive();
+		counting = !pending[next];
+		if (!counting) return;
+		glBeginQuery(GL_SAMPLES_PASSED, queries[next]);
+		divisor[next] = static_cast<float>(width) * static_cast<float>(height) * static_cast<float>(samples);
+	}
+
+	void End() {
+		if (!counting) return;
+		rlDrawRenderBatchActive();
+		glEndQuery(GL_SAMPLES_PASSED);
+		pending[next] = true;
+		next = (next + 1) % C_LATENCY;
+		counting = false;
+	}
+
+	// Reads back every finished query, oldest first, so the newest result wins.
+	void Collect() {
+		for (int i = 0; i < C_LATENCY; ++i) {
+			const int slot = (next + i) % C_LATENCY;
+			if (!pending[slot]) continue;
+			GLint available = 0;
+			glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available) continue;
+			GLuint passed = 0;
+			glGetQueryObjectuiv(queries[slot], GL_QUERY_RESULT, &passed);
+			shadedPerPixel = static_cast<float>(passed) / divisor[slot];
+			pending[slot] = false;
+		}
+	}
+
+	int                 width = 0;
+	int                 height = 0;
+	int                 windowSamples = 1;
+	Shader              depthOnly{};
+	Shader              overdraw{};
+	Shader              heatmap{};
+	Shader              active{};
+	RenderTexture2D     target{};
+	std::vector<Shader> saved;
+	GLuint              queries[C_LATENCY] = {};
+	bool                pending[C_LATENCY] = {};
+	float               divisor[C_LATENCY] = {};
+	int                 next = 0;
+	bool                counting = false;
+	float               shadedPerPixel = 0.0f;
+};
+
+#endif // DEPTH_PREPASS_H
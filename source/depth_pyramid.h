@@ -0,0 +1,162 @@
+#ifndef DEPTH_PYRAMID_H
+#define DEPTH_PYRAMID_H
+
+#include <algorithm>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "shader_cache.h"
+#include "external/glad.h"  // depth-only targets, mip ranges and attribute-less draws, which rlgl doesn't wrap
+
+// --- DEPTH PYRAMID ---
+// A hierarchical-Z map for occlusion tests. Occluders are drawn depth-only into a
+// window-size depth texture between BeginOccluders() and EndOccluders(), which then reduces
+// it into a single-channel float mip chain where every texel holds the farthest depth of the
+// texels below it. Level 0 is half the window, each level after half the last (rounded
+// down, and an odd source row or column folds into its neighbour's texel), down to 1x1.
+// Anything whose nearest depth lies behind the farthest one over its screen rectangle is
+// hidden; a rectangle ceil(log2(size in level-0 texels)) levels up covers at most 2x2 texels.
+//
+// Every level is written by hiz_reduce.fs reading the one below through a base/max level
+// window on the same texture, so no level is ever read and written at once.
+class DepthPyramid {
+public:
+	void Init(int w, int h) {
+		width = w;
+		height = h;
+		fbo = rlLoadFramebuffer(width, height);
+		depth = rlLoadTextureDepth(width, height, false);
+		rlFramebufferAttach(fbo, depth, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+		rlEnableFramebuffer(fbo);
+		glDrawBuffer(GL_NONE);  // depth only
+		glReadBuffer(GL_NONE);
+		if (!rlFramebufferComplete(fbo)) TraceLog(LOG_WARNING, "HIZ: occluder framebuffer is incomplete");
+
+		baseWidth = std::max(width / 2, 1);
+		baseHeight = std::max(height / 2, 1);
+		levels = 1;
+		while ((baseWidth >> (levels - 1)) > 1 || (baseHeight >> (levels - 1)) > 1) ++levels;
+		glGenTextures(1, &pyramid);
+		glBindTexture(GL_TEXTURE_2D, pyramid);
+		for (int l = 0; l < levels; ++l) {
+			glTexImage2D(GL_TEXTURE_2D, l, GL_R32F, LevelSize(baseWidth, l), LevelSize(baseHeight, l), 0, GL_RED, GL_FLOAT, nullptr);
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		reduceFbo = rlLoadFramebuffer(baseWidth, baseHeight);
+		rlDisableFramebuffer();
+		reduce = ShaderCache::Load("../resources/shaders/glsl330/hiz_reduce.vs", "../resources/shaders/glsl330/hiz_reduce.fs");
+		sourceSizeLoc = GetShaderLocation(reduce, "sourceSize");
+		glGenVertexArrays(1, &vao);
+		Clear();
+	}
+
+	void Unload() {
+		rlUnloadFramebuffer(fbo);  // takes the depth texture with it
+		rlUnloadFramebuffer(reduceFbo);
+		glDeleteTextures(1, &pyramid);
+		glDeleteVertexArrays(1, &vao);
+		UnloadShader(reduce);
+		fbo = reduceFbo = depth = pyramid = vao = 0;
+	}
+
+	// Every level at the far plane: nothing is hidden, as before the first occluders are drawn.
+	void Clear() {
+		const float farthest = 1.0f;
+		rlEnableFramebuffer(reduceFbo);
+		for (int l = 0; l < levels; ++l) {
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pyramid, l);
+			glClearBufferfv(GL_COLOR, 0, &farthest);
+		}
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+		rlDisableFramebuffer();
+	}
+
+	// Occluders go in between, with the current view and projection, inside BeginMode3D.
+	void BeginOccluders() {
+		rlDrawRenderBatchActive();
+		rlEnableFramebuffer(fbo);
+		rlViewport(0, 0, width, height);
+		rlClearScreenBuffers();  // depth only: there is no colour attachment
+		rlEnableDepthTest();
+	}
+
+	// Builds the pyramid and goes back to the window's framebuffer.
+	void EndOccluders() {
+		rlDrawRenderBatchActive();
+		glUseProgram(reduce.id);
+		glBindVertexArray(vao);
+		glActiveTexture(GL_TEXTURE0);
+		rlDisableDepthTest();
+		rlDisableColorBlend();
+		rlEnableFramebuffer(reduceFbo);
+		for (int l = 0; l < levels; ++l) {
+			if (l == 0) {
+				glBindTexture(GL_TEXTURE_2D, depth);
+				glUniform2i(sourceSizeLoc, width, height);
+			}
+			else {
+				glBindTexture(GL_TEXTURE_2D, pyramid);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, l - 1);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, l - 1);
+				glUniform2i(sourceSizeLoc, LevelSize(baseWidth, l - 1), LevelSize(baseHeight, l - 1));
+			}
+			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, pyramid, l);
+			glViewport(0, 0, LevelSize(baseWidth, l), LevelSize(baseHeight, l));
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+		}
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+		glBindTexture(GL_TEXTURE_2D, pyramid);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindVertexArray(0);
+		glUseProgram(0);
+
+		rlEnableColorBlend();
+		rlEnableDepthTest();
+		rlDisableFramebuffer();
+		rlViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+	}
+
+	unsigned int Texture() const {
+		return pyramid;
+	}
+
+	// Level 0's size, in texels.
+	int Width() const {
+		return baseWidth;
+	}
+
+	int Height() const {
+		return baseHeight;
+	}
+
+	int Levels() const {
+		return levels;
+	}
+
+private:
+	static int LevelSize(int base, int level) {
+		return std::max(base >> level, 1);
+	}
+
+	int          width = 0;
+	int          height = 0;
+	int          baseWidth = 0;
+	int          baseHeight = 0;
+	int          levels = 0;
+	unsigned int fbo = 0;
+	unsigned int depth = 0;
+	unsigned int reduceFbo = 0;
+	unsigned int pyramid = 0;
+	unsigned int vao = 0;
+	Shader       reduce{};
+	int          sourceSizeLoc = -1;
+};
+
+#endif // DEPTH_PYRAMID_H
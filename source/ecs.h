@@ -0,0 +1,169 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+// --- ARCHETYPE ECS ---
+// Entities that share a component set live together in one Archetype: a table with one
+// contiguous column per component and one row per entity. A Registry is a fixed list of
+// archetypes known at compile time, and a query names the components it needs; only the
+// archetypes that have all of them are visited, each as plain column pointers, so a
+// system is a tight loop over contiguous memory with no virtual calls or type tests.
+// A new kind of entity is a new Archetype in the registry's list, not a new class.
+namespace Ecs {
+	template<typename T, typename... Ts>
+	inline constexpr bool Contains = (std::is_same_v<T, Ts> || ...);
+
+	template<typename... Cs>
+	class Archetype {
+	public:
+		static_assert(sizeof...(Cs) > 0, "an archetype needs at least one component");
+
+		template<typename... Qs>
+		static constexpr bool Has = (Contains<Qs, Cs...> && ...);
+
+		size_t Size() const {
+			return std::get<0>(columns).size();
+		}
+
+		bool Empty() const {
+			return Size() == 0;
+		}
+
+		void Reserve(size_t n) {
+			(std::get<std::vector<Cs>>(columns).reserve(n), ...);
+		}
+
+		void Clear() {
+			(std::get<std::vector<Cs>>(columns).clear(), ...);
+		}
+
+		// Appends an entity and returns its row.
+		size_t Push(const Cs&... values) {
+			(std::get<std::vector<Cs>>(columns).push_back(values), ...);
+			return Size() - 1;
+		}
+
+		template<typename C>
+		C* Column() {
+			return std::get<std::vector<C>>(columns).data();
+		}
+
+		template<typename C>
+		const C* Column() const {
+			return std::get<std::vector<C>>(columns).data();
+		}
+
+		template<typename C>
+		C& Get(size_t row) {
+			return std::get<std::vector<C>>(columns)[row];
+		}
+
+		template<typename C>
+		const C& Get(size_t row) const {
+			return std::get<std::vector<C>>(columns)[row];
+		}
+
+		// Calls fn(std::vector<C>&) for every component column, in declaration order, for
+		// code that handles whole columns alike (World snapshots). Whatever fn does, every
+		// column must end up Size() rows long.
+		template<typename Fn>
+		void EachColumn(Fn&& fn) {
+			(fn(std::get<std::vector<Cs>>(columns)), ...);
+		}
+
+		template<typename Fn>
+		void EachColumn(Fn&& fn) const {
+			(fn(std::get<std::vector<Cs>>(columns)), ...);
+		}
+
+		// Drops every row with dead[row] set. Survivors keep their relative order, so an
+		// archetype that relies on ordering (parents before children) stays valid.
+		void Erase(const std::vector<char>& dead) {
+			size_t keep = 0;
+			for (size_t row = 0; row < Size(); ++row) {
+				if (dead[row]) continue;
+				if (keep != row) ((std::get<std::vector<Cs>>(columns)[keep] = std::get<std::vector<Cs>>(columns)[row]), ...);
+				++keep;
+			}
+			(std::get<std::vector<Cs>>(columns).resize(keep), ...);
+		}
+
+	private:
+		std::tuple<std::vector<Cs>...> columns;
+	};
+
+	template<typename... As>
+	class Registry {
+	public:
+		template<typename A>
+		A& Get() {
+			return std::get<A>(archetypes);
+		}
+
+		template<typename A>
+		const A& Get() const {
+			return std::get<A>(archetypes);
+		}
+
+		// Entities over every archetype.
+		size_t Size() const {
+			return (std::get<As>(archetypes).Size() + ...);
+		}
+
+		void Clear() {
+			(std::get<As>(archetypes).Clear(), ...);
+		}
+
+		// Calls fn(n, Qs*...) once per archetype that has every Qs, in registry order,
+		// with its row count and column pointers.
+		template<typename... Qs, typename Fn>
+		void EachArchetype(Fn&& fn) {
+			(VisitArchetype<As, Qs...>(fn), ...);
+		}
+
+		template<typename... Qs, typename Fn>
+		void EachArchetype(Fn&& fn) const {
+			(VisitArchetype<As, Qs...>(fn), ...);
+		}
+
+		// Calls fn(Qs&...) for every entity that has every Qs, archetype by archetype.
+		template<typename... Qs, typename Fn>
+		void Each(Fn&& fn) {
+			EachArchetype<Qs...>([&](size_t n, Qs*... cols) {
+				for (size_t row = 0; row < n; ++row) fn(cols[row]...);
+			});
+		}
+
+		template<typename... Qs, typename Fn>
+		void Each(Fn&& fn) const {
+			EachArchetype<Qs...>([&](size_t n, const Qs*... cols) {
+				for (size_t row = 0; row < n; ++row) fn(cols[row]...);
+			});
+		}
+
+	private:
+		template<typename A, typename... Qs, typename Fn>
+		void VisitArchetype(Fn& fn) {
+			if constexpr (A::template Has<Qs...>) {
+				A& a = std::get<A>(archetypes);
+				if (!a.Empty()) fn(a.Size(), a.template Column<Qs>()...);
+			}
+		}
+
+		template<typename A, typename... Qs, typename Fn>
+		void VisitArchetype(Fn& fn) const {
+			if constexpr (A::template Has<Qs...>) {
+				const A& a = std::get<A>(archetypes);
+				if (!a.Empty()) fn(a.Size(), a.template Column<Qs>()...);
+			}
+		}
+
+		std::tuple<As...> archetypes;
+	};
+}
+
+#endif // ECS_H
@@ -0,0 +1,195 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// --- FIXED POINT ---
+// Integer arithmetic for lockstep simulation (World::SetLockstep). /fp:fast lets every
+// compiler fuse, reorder and approximate float math as it likes, and sinf/cosf differ
+// between C runtimes, so two machines stepping the same inputs drift apart within seconds.
+// Lockstep worlds keep every position and velocity a multiple of 1/C_ONE (Q24.8): such a
+// value up to 2^15 is exact in a float, so the field columns and SIMD kernels keep their
+// float layout, but all arithmetic on them goes through the integers here. The only float
+// operations left on the state are exact ones (add, subtract, compare, scale by a power of
+// two), which no compiler can round differently. Times are Q.16 seconds and the sine table
+// is built with integer arithmetic at compile time, so nothing depends on libm.
+namespace Fixed {
+	using Raw = int32_t;
+
+	inline constexpr int C_SHIFT = 8;
+	inline constexpr Raw C_ONE = Raw{ 1 } << C_SHIFT;
+	inline constexpr int C_TIME_SHIFT = 16;  // seconds
+	inline constexpr int C_UNIT_SHIFT = 16;  // Sin/Cos: 1.0 is 1 << C_UNIT_SHIFT
+	inline constexpr Raw C_FULL_TURN = 360 << C_SHIFT;  // degrees
+
+	// Exact for any value on the grid; anything else is rounded to the nearest point of it.
+	inline Raw FromFloat(float v) {
+		return static_cast<Raw>(lrintf(v * static_cast<float>(C_ONE)));
+	}
+
+	inline constexpr Raw FromInt(int v) {
+		return static_cast<Raw>(v * C_ONE);
+	}
+
+	// Exact while |r| < 2^24.
+	inline float ToFloat(Raw r) {
+		return static_cast<float>(r) * (1.f / static_cast<float>(C_ONE));
+	}
+
+	// The nearest grid value: constants and setup values enter a lockstep world this way.
+	inline float Snap(float v) {
+		return ToFloat(FromFloat(v));
+	}
+
+	inline int32_t FromSeconds(float s) {
+		return static_cast<int32_t>(lrintf(s * static_cast<float>(1 << C_TIME_SHIFT)));
+	}
+
+	inline float ToSeconds(int32_t t) {
+		return static_cast<float>(t) * (1.f / static_cast<float>(1 << C_TIME_SHIFT));
+	}
+
+	// How far `rate` per second goes in `dt` (Q.16 seconds), rounded down.
+	inline Raw Distance(Raw rate, int32_t dt) {
+		return static_cast<Raw>((static_cast<int64_t>(rate) * dt) >> C_TIME_SHIFT);
+	}
+
+	// x * unit, with unit a Sin/Cos value or any other Q.16 factor.
+	inline Raw MulUnit(Raw x, int32_t unit) {
+		return static_cast<Raw>((static_cast<int64_t>(x) * unit) >> C_UNIT_SHIFT);
+	}
+
+	// Into [0, C_FULL_TURN).
+	inline Raw WrapDegrees(Raw a) {
+		a %= C_FULL_TURN;
+		return a < 0 ? a + C_FULL_TURN : a;
+	}
+
+	// Uniform in [min, max) from a 32-bit draw, for raw values of any format.
+	inline int32_t Uniform(uint32_t draw, int32_t min, int32_t max) {
+		const int64_t span = static_cast<int64_t>(max) - min;
+		return static_cast<int32_t>(min + ((span * static_cast<int64_t>(draw)) >> 32));
+	}
+
+	// floor(sqrt(v)).
+	inline uint64_t Sqrt(uint64_t v) {
+		uint64_t root = 0;
+		uint64_t bit = uint64_t{ 1 } << 62;
+		while (bit > v) bit >>= 2;
+		while (bit) {
+			if (v >= root + bit) {
+				v -= root + bit;
+				root = (root >> 1) + bit;
+			}
+			else {
+				root >>= 1;
+			}
+			bit >>= 2;
+		}
+		return root;
+	}
+
+	inline Raw Length(Raw x, Raw y) {
+		return static_cast<Raw>(Sqrt(static_cast<uint64_t>(static_cast<int64_t>(x) * x + static_cast<int64_t>(y) * y)));
+	}
+
+	// (x, y) scaled to `length`; a zero vector becomes (length, 0).
+	inline void Resize(Raw x, Raw y, Raw length, Raw& outX, Raw& outY) {
+		const Raw len = Length(x, y);
+		if (len == 0) {
+			outX = length;
+			outY = 0;
+			return;
+		}
+		outX = static_cast<Raw>(static_cast<int64_t>(x) * length / len);
+		outY = static_cast<Raw>(static_cast<int64_t>(y) * length / len);
+	}
+
+	namespace Detail {
+		inline constexpr int C_TABLE_BITS = 12;
+		inline constexpr int C_TABLE = 1 << C_TABLE_BITS;  // entries per turn
+
+		// sin(2 pi k / C_TABLE) in Q.16, by a Taylor series in Q.30 integers: the table comes
+		// out the same from every compiler, which a constexpr double series need not.
+		constexpr std::array<int32_t, C_TABLE> BuildSines() {
+			constexpr int64_t C_Q = int64_t{ 1 } << 30;
+			constexpr int64_t C_HALF_PI = 1686629713;  // pi/2 in Q.30
+			std::array<int32_t, C_TABLE> table{};
+			constexpr int quarter = C_TABLE / 4;
+			for (int k = 0; k < C_TABLE; ++k) {
+				// Fold into the first quadrant.
+				const int q = k / quarter;
+				int r = k % quarter;
+				if (q == 1 || q == 3) r = quarter - r;
+				const int64_t x = C_HALF_PI * r / quarter;
+				const int64_t x2 = x * x / C_Q;
+				int64_t term = x;
+				int64_t sum = x;
+				for (int n = 1; n < 10; ++n) {
+					term = -term * x2 / C_Q / ((2 * n) * (2 * n + 1));
+					sum += term;
+				}
+				int64_t v = (sum + (int64_t{ 1 } << 13)) >> 14;  // Q.30 -> Q.16, rounded
+				table[k] = static_cast<int32_t>(q >= 2 ? -v : v);
+			}
+			return table;
+		}
+
+		inline constexpr std::array<int32_t, C_TABLE> C_SINES = BuildSines();
+
+		inline int IndexOf(Raw degrees) {
+			return static_cast<int>((static_cast<int64_t>(WrapDegrees(degrees)) * C_TABLE + C_FULL_TURN / 2) / C_FULL_TURN) & (C_TABLE - 1);
+		}
+	}
+
+	// Of an angle in degrees, to the nearest 1/C_TABLE of a turn, in Q.16.
+	inline int32_t Sin(Raw degrees) {
+		return Detail::C_SINES[Detail::IndexOf(degrees)];
+	}
+
+	inline int32_t Cos(Raw degrees) {
+		return Detail::C_SINES[Detail::IndexOf(degrees + C_FULL_TURN / 4)];
+	}
+
+	// x[i] += v[i] * dt on the grid, over [begin, end).
+	inline void Advance(float* x, const float* v, int32_t dt, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			x[i] = ToFloat(FromFloat(x[i]) + Distance(FromFloat(v[i]), dt));
+		}
+	}
+
+	// The same for angles in degrees, kept in [0, 360) so they stay exact.
+	inline void AdvanceDegrees(float* a, const float* v, int32_t dt, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			a[i] = ToFloat(WrapDegrees(FromFloat(a[i]) + Distance(FromFloat(v[i]), dt)));
+		}
+	}
+
+	// Whether a circle of radius r about (cx, cy) comes closer than r to the segment from
+	// (sx, sy) along (lx, ly): the point nearest the centre is found as a Q.16 fraction of
+	// the segment, so nothing overflows however long it is.
+	inline bool SweptOverlap(Raw sx, Raw sy, Raw lx, Raw ly, Raw cx, Raw cy, Raw r) {
+		const int64_t dx = static_cast<int64_t>(cx) - sx;
+		const int64_t dy = static_cast<int64_t>(cy) - sy;
+		const int64_t len2 = static_cast<int64_t>(lx) * lx + static_cast<int64_t>(ly) * ly;
+		int64_t t = 0;
+		if (len2 > 0) {
+			const int64_t dot = dx * lx + dy * ly;
+			t = dot <= 0 ? 0 : dot >= len2 ? int64_t{ 1 } << C_UNIT_SHIFT : (dot << C_UNIT_SHIFT) / len2;
+		}
+		const int64_t ex = dx - ((lx * t) >> C_UNIT_SHIFT);
+		const int64_t ey = dy - ((ly * t) >> C_UNIT_SHIFT);
+		return ex * ex + ey * ey < static_cast<int64_t>(r) * r;
+	}
+
+	inline bool Overlap(Raw ax, Raw ay, Raw bx, Raw by, Raw r) {
+		const int64_t dx = static_cast<int64_t>(bx) - ax;
+		const int64_t dy = static_cast<int64_t>(by) - ay;
+		return dx * dx + dy * dy < static_cast<int64_t>(r) * r;
+	}
+}
+
+#endif // FIXED_POINT_H
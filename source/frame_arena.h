@@ -0,0 +1,128 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// --- FRAME ARENA ---
+// Scratch memory that lives for one frame (or one tick). Allocation bumps a pointer through
+// a block; freeing does nothing, and Reset() drops everything at once. Containers take it
+// as their std::pmr::memory_resource (ArenaVector), so per-frame scratch is written the
+// usual way but never reaches the heap. A frame that overflows its block chains a new one
+// twice the size; the next Reset() folds them into a single block of their combined size,
+// so once the busiest frame has been through, a frame allocates nothing at all.
+//
+// Nothing made from the arena may be kept past Reset(): build containers inside the frame
+// (locals, or cleared and refilled each frame with the arena passed again). Allocations
+// take a mutex, so the chunks of a ParallelFor may share one arena; containers allocate
+// rarely enough (on growth) that it doesn't show. Instance() is the render thread's,
+// reset by Renderer::End right after EndDrawing.
+class FrameArena : public std::pmr::memory_resource {
+public:
+	static constexpr size_t C_DEFAULT_CAPACITY = 256 * 1024;
+
+	static FrameArena& Instance() {
+		static FrameArena instance;
+		return instance;
+	}
+
+	explicit FrameArena(size_t capacity = C_DEFAULT_CAPACITY) : firstCapacity(capacity) {}
+
+	~FrameArena() override {
+		for (Block& b : blocks) ::operator delete(b.data);
+	}
+
+	FrameArena(const FrameArena&) = delete;
+	FrameArena& operator=(const FrameArena&) = delete;
+
+	// Forgets every allocation. Only once nothing made from the arena is in use.
+	void Reset() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (blocks.size() > 1) {
+			size_t total = 0;
+			for (Block& b : blocks) {
+				total += b.capacity;
+				::operator delete(b.data);
+			}
+			blocks.clear();
+			AddBlock(total);
+		}
+		if (!blocks.empty()) blocks[0].used = 0;
+		used = 0;
+	}
+
+	// Bytes handed out since the last Reset(), and the most in any frame so far.
+	size_t Used() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return used;
+	}
+
+	size_t HighWater() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return highWater;
+	}
+
+	size_t Capacity() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		size_t n = 0;
+		for (const Block& b : blocks) n += b.capacity;
+		return n;
+	}
+
+private:
+	struct Block {
+		std::byte* data;
+		size_t     capacity;
+		size_t     used;
+	};
+
+	void AddBlock(size_t capacity) {
+		blocks.push_back({ static_cast<std::byte*>(::operator new(capacity)), capacity, 0 });
+	}
+
+	void* do_allocate(size_t bytes, size_t alignment) override {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (blocks.empty()) AddBlock(firstCapacity);
+		Block* b = &blocks.back();
+		size_t offset = AlignedOffset(*b, alignment);
+		if (offset + bytes > b->capacity) {
+			size_t capacity = b->capacity * 2;
+			if (capacity < bytes + alignment) capacity = bytes + alignment;
+			AddBlock(capacity);
+			b = &blocks.back();
+			offset = AlignedOffset(*b, alignment);
+		}
+		used += offset - b->used + bytes;
+		if (used > highWater) highWater = used;
+		b->used = offset + bytes;
+		return b->data + offset;
+	}
+
+	void do_deallocate(void*, size_t, size_t) override {}
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+		return this == &other;
+	}
+
+	// The block's first free offset aligned in memory, not just within the block.
+	static size_t AlignedOffset(const Block& b, size_t alignment) {
+		const uintptr_t next = reinterpret_cast<uintptr_t>(b.data) + b.used;
+		return b.used + (((next + alignment - 1) & ~(alignment - 1)) - next);
+	}
+
+	size_t             firstCapacity;
+	std::vector<Block> blocks;  // the last is the one being filled
+	size_t             used = 0;
+	size_t             highWater = 0;
+	mutable std::mutex mutex;
+};
+
+// A vector whose storage comes from a FrameArena (any memory_resource).
+template<typename T>
+using ArenaVector = std::pmr::vector<T>;
+
+#endif // FRAME_ARENA_H
@@ -0,0 +1,133 @@
+#ifndef FRAME_GOVERNOR_H
+#define FRAME_GOVERNOR_H
+
+#include <algorithm>
+#include <cstdio>
+
+// --- FRAME GOVERNOR ---
+// Back-pressure for a screen that fills up faster than the machine can draw it. Once a frame
+// it is told what the frame's work cost: the simulation's ticks, the render thread's drawing
+// and the GPU. Those run side by side, so the slowest of the three sets the frame rate, and
+// that share of the frame budget, smoothed, is the load. A load over 1 held for
+// C_ESCALATE_FRAMES moves one level up C_LEVELS, each cheaper to run than the last: cheaper
+// texture sampling first (SamplerPresets' tiers, lowered further alongside the next levels),
+// then explosions merged into fewer bursts, fewer particles, coarser asteroid outlines, and
+// last of all slower asteroid spawns. A load under C_RELAX held for the longer
+// C_RECOVER_FRAMES moves one level back down, so a busy moment degrades the picture
+// gracefully instead of stuttering, and the level doesn't flicker at the edge. Measurements right after a change are ignored while it takes effect.
+// DynamicResolution already holds GPU fill time by itself; this covers what resolution
+// can't (texture bandwidth, vertex, CPU and simulation load).
+class FrameGovernor {
+public:
+	struct Settings {
+		bool  mergeEffects;  // explosions in the same cell become one burst
+		float particles;     // share of every burst's and trail's particles
+		float lodBias;       // AsteroidLod's screen-size thresholds times this
+		float spawns;        // pace of the timed spawner and waves (World::SetSpawnRate)
+		int   samplerTier;   // SamplerPresets::SetTier: texture bandwidth given up first
+	};
+
+	static constexpr Settings C_LEVELS[] = {
+		{ false, 1.00f, 1.0f, 1.00f, 0 },
+		{ false, 1.00f, 1.0f, 1.00f, 1 },
+		{ true,  1.00f, 1.0f, 1.00f, 1 },
+		{ true,  0.50f, 1.0f, 1.00f, 2 },
+		{ true,  0.50f, 2.0f, 1.00f, 3 },
+		{ true,  0.25f, 2.0f, 0.50f, 3 },
+		{ true,  0.25f, 3.0f, 0.25f, 3 },
+	};
+	static constexpr int C_LEVEL_COUNT = static_cast<int>(sizeof(C_LEVELS) / sizeof(C_LEVELS[0]));
+
+	// With `throttleSpawns` false every level keeps spawns at full pace, for sessions whose
+	// replay has to reproduce them from input alone.
+	void Init(float frameSeconds, bool throttleSpawns) {
+		budgetMs = frameSeconds * 1000.f * C_BUDGET;
+		spawnsThrottled = throttleSpawns;
+		level = 0;
+		load = 0.f;
+		over = under = 0;
+		settle = 0;
+		Apply();
+	}
+
+	// One frame's costs in ms; 0 for one that isn't known (no GPU timer queries, say).
+	// Returns true when the level changed.
+	bool Update(float simMs, float drawMs, float gpuMs) {
+		const float worst = std::max(simMs, std::max(drawMs, gpuMs));
+		load += (worst / budgetMs - load) * C_SMOOTHING;
+		if (settle > 0) {
+			--settle;
+			return false;
+		}
+		over = load > 1.f ? over + 1 : 0;
+		under = load < C_RELAX ? under + 1 : 0;
+		int next = level;
+		if (over >= C_ESCALATE_FRAMES && level + 1 < C_LEVEL_COUNT) next = level + 1;
+		else if (under >= C_RECOVER_FRAMES && level > 0) next = level - 1;
+		if (next == level) return false;
+		level = next;
+		over = under = 0;
+		settle = C_SETTLE_FRAMES;
+		Apply();
+		return true;
+	}
+
+	int Level() const {
+		return level;
+	}
+
+	const Settings& Current() const {
+		return current;
+	}
+
+	// The smoothed load, as a share of the budget.
+	float Load() const {
+		return load;
+	}
+
+	// What the current level gives up, "effects merged, particles 50%, ..." for the
+	// overlay; empty at level 0.
+	const char* Actions() const {
+		return actions;
+	}
+
+private:
+	static constexpr float C_BUDGET = 0.9f;      // share of the frame the slowest side may take
+	static constexpr float C_RELAX = 0.6f;       // step back down while under this load
+	static constexpr float C_SMOOTHING = 0.1f;   // of each frame's load in the running one
+	static constexpr int   C_ESCALATE_FRAMES = 15;
+	static constexpr int   C_RECOVER_FRAMES = 180;
+	static constexpr int   C_SETTLE_FRAMES = 30;
+
+	void Apply() {
+		current = C_LEVELS[level];
+		if (!spawnsThrottled) current.spawns = 1.f;
+		const Settings& s = current;
+		int n = 0;
+		actions[0] = '\0';
+		auto add = [&](const char* text, int percent) {
+			if (n >= static_cast<int>(sizeof(actions))) return;
+			const char* sep = n > 0 ? ", " : "";
+			const int w = percent < 0 ? snprintf(actions + n, sizeof(actions) - static_cast<size_t>(n), "%s%s", sep, text)
+				: snprintf(actions + n, sizeof(actions) - static_cast<size_t>(n), "%s%s %d%%", sep, text, percent);
+			if (w > 0) n += w;
+		};
+		if (s.samplerTier > 0) add(s.samplerTier > 1 ? "sampling low" : "sampling reduced", -1);
+		if (s.mergeEffects) add("effects merged", -1);
+		if (s.particles < 1.f) add("particles", static_cast<int>(s.particles * 100.f + 0.5f));
+		if (s.lodBias > 1.f) add("outline LOD", static_cast<int>(100.f / s.lodBias + 0.5f));
+		if (s.spawns < 1.f) add("spawns", static_cast<int>(s.spawns * 100.f + 0.5f));
+	}
+
+	Settings current = C_LEVELS[0];
+	float budgetMs = 1000.f / 60.f * C_BUDGET;
+	bool  spawnsThrottled = true;
+	float load = 0.f;
+	int   level = 0;
+	int   over = 0;
+	int   under = 0;
+	int   settle = 0;
+	char  actions[96] = {};
+};
+
+#endif // FRAME_GOVERNOR_H
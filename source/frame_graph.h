@@ -0,0 +1,314 @@
+#ifndef FRAME_GRAPH_H
+#define FRAME_GRAPH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "raylib.h"
+
+// --- FRAME GRAPH ---
+// Render passes declared with what they read and write, instead of run in a hand-written
+// order on render textures owned per effect. A pass reads and writes versions of
+// resources: Write() returns the resource's next version, produced by that pass, so the
+// graph is a DAG however often a target is drawn into. Compile() then
+//   - culls every pass that nothing reaching a side-effect pass (one that draws outside
+//     the graph, to the window) reads from,
+//   - orders the rest so each runs after the producers of what it reads and after every
+//     reader of what it overwrites, declaration order breaking ties,
+//   - and gives each transient target a texture from a pool, reusing one of the same size
+//     whose previous owner's passes are all done, so targets whose lifetimes don't
+//     overlap alias the same memory. Pooled textures no compile asks for are unloaded.
+// Build a graph once per configuration and Execute() it every frame: declaring and
+// compiling allocate, executing doesn't. Imported resources (the scene, say) are bound
+// afresh before each Execute. Main thread only, like the GL calls the passes make.
+class FrameGraph {
+public:
+	using Handle = int;  // a version of a resource
+	using Run = std::function<void(FrameGraph&)>;
+
+	static constexpr Handle C_NONE = -1;
+
+	struct Stats {
+		int    passes = 0;    // declared
+		int    culled = 0;
+		int    targets = 0;   // transient targets in use after culling
+		int    textures = 0;  // pooled textures behind them
+		size_t bytes = 0;     // of those textures
+		size_t unaliasedBytes = 0;  // with a texture per target
+	};
+
+	// Starts a new graph; pooled textures are kept for the next Compile.
+	void Reset() {
+		resources.clear();
+		versions.clear();
+		passes.clear();
+		order.clear();
+		stats = {};
+	}
+
+	// A texture from outside the graph, bound with Bind before each Execute.
+	Handle Import(const char* name) {
+		resources.push_back({ name, 0, 0, true, -1, {} });
+		return NewVersion(static_cast<int>(resources.size() - 1), -1);
+	}
+
+	void Bind(Handle h, const Texture2D& texture) {
+		resources[Of(h)].imported = texture;
+	}
+
+	// A render target the graph owns; its contents are undefined until a pass writes it.
+	Handle Create(const char* name, int w, int h) {
+		resources.push_back({ name, w, h, false, -1, {} });
+		return NewVersion(static_cast<int>(resources.size() - 1), -1);
+	}
+
+	// `run` is called with the graph, to look up its targets, when the pass executes.
+	int AddPass(const char* name, Run run) {
+		passes.push_back({ name, std::move(run), {}, {}, false, false });
+		return static_cast<int>(passes.size() - 1);
+	}
+
+	void Read(int pass, Handle h) {
+		PassAt(pass).reads.push_back(h);
+		VersionOf(h).readers.push_back(pass);
+	}
+
+	// The next version of h's resource, made by `pass`. Read h as well when the pass
+	// draws over what is there.
+	Handle Write(int pass, Handle h) {
+		const Handle next = NewVersion(VersionOf(h).resource, pass);
+		VersionOf(next).previous = h;
+		PassAt(pass).writes.push_back(next);
+		return next;
+	}
+
+	// The pass draws outside the graph, so it is never culled.
+	void SideEffect(int pass) {
+		PassAt(pass).sideEffect = true;
+	}
+
+	void Compile() {
+		Cull();
+		Order();
+		Allocate();
+	}
+
+	void Execute() {
+		for (int p : order) PassAt(p).run(*this);
+	}
+
+	// Every version of a resource is the same texture.
+	const Texture2D& Texture(Handle h) const {
+		const Resource& r = resources[Of(h)];
+		return r.external ? r.imported : pool[static_cast<size_t>(r.physical)].target.texture;
+	}
+
+	RenderTexture2D& Target(Handle h) {
+		return pool[static_cast<size_t>(resources[Of(h)].physical)].target;
+	}
+
+	// False when a target's texture couldn't be made; Execute would draw into nothing.
+	bool Complete() const {
+		for (const Physical& p : pool) {
+			if (!p.target.id) return false;
+		}
+		return true;
+	}
+
+	const Stats& GetStats() const {
+		return stats;
+	}
+
+	void Unload() {
+		for (Physical& p : pool) UnloadRenderTexture(p.target);
+		pool.clear();
+		Reset();
+	}
+
+private:
+	struct Resource {
+		const char* name;
+		int         width;
+		int         height;
+		bool        external;
+		int         physical;  // pool index once allocated
+		Texture2D   imported;
+	};
+
+	struct Version {
+		int              resource;
+		int              producer;  // pass, or -1 for the resource as it starts
+		Handle           previous;
+		std::vector<int> readers;
+	};
+
+	struct Pass {
+		const char*         name;
+		Run                 run;
+		std::vector<Handle> reads;
+		std::vector<Handle> writes;
+		bool                sideEffect;
+		bool                needed;
+	};
+
+	struct Physical {
+		RenderTexture2D target;
+		int             width;
+		int             height;
+		bool            wanted;  // by the current compile
+		bool            busy;    // at the point of the schedule being allocated
+	};
+
+	Handle NewVersion(int resource, int producer) {
+		versions.push_back({ resource, producer, C_NONE, {} });
+		return static_cast<Handle>(versions.size() - 1);
+	}
+
+	size_t Of(Handle h) const {
+		return static_cast<size_t>(VersionOf(h).resource);
+	}
+
+	Version& VersionOf(Handle h) { return versions[static_cast<size_t>(h)]; }
+	const Version& VersionOf(Handle h) const { return versions[static_cast<size_t>(h)]; }
+	Pass& PassAt(int p) { return passes[static_cast<size_t>(p)]; }
+
+	// From the side-effect passes back through the producers of what they read.
+	void Cull() {
+		std::vector<int> stack;
+		for (size_t p = 0; p < passes.size(); ++p) {
+			passes[p].needed = passes[p].sideEffect;
+			if (passes[p].needed) stack.push_back(static_cast<int>(p));
+		}
+		while (!stack.empty()) {
+			const Pass& pass = PassAt(stack.back());
+			stack.pop_back();
+			for (Handle h : pass.reads) {
+				const int producer = VersionOf(h).producer;
+				if (producer >= 0 && !PassAt(producer).needed) {
+					PassAt(producer).needed = true;
+					stack.push_back(producer);
+				}
+			}
+		}
+		stats.passes = static_cast<int>(passes.size());
+		stats.culled = 0;
+		for (const Pass& pass : passes) {
+			if (!pass.needed) ++stats.culled;
+		}
+	}
+
+	// Kahn's algorithm over the needed passes, lowest declaration index first.
+	void Order() {
+		const size_t n = passes.size();
+		std::vector<std::vector<int>> after(n);
+		std::vector<int> waiting(n, 0);
+		auto edge = [&](int from, int to) {
+			if (from < 0 || from == to || !PassAt(from).needed) return;
+			after[static_cast<size_t>(from)].push_back(to);
+			++waiting[static_cast<size_t>(to)];
+		};
+		for (size_t p = 0; p < n; ++p) {
+			if (!passes[p].needed) continue;
+			const int self = static_cast<int>(p);
+			for (Handle h : passes[p].reads) edge(VersionOf(h).producer, self);
+			for (Handle h : passes[p].writes) {
+				const Version& overwritten = VersionOf(VersionOf(h).previous);
+				edge(overwritten.producer, self);
+				for (int reader : overwritten.readers) edge(reader, self);
+			}
+		}
+		order.clear();
+		std::vector<int> ready;
+		for (size_t p = 0; p < n; ++p) {
+			if (passes[p].needed && waiting[p] == 0) ready.push_back(static_cast<int>(p));
+		}
+		while (!ready.empty()) {
+			const auto lowest = std::min_element(ready.begin(), ready.end());
+			const int p = *lowest;
+			ready.erase(lowest);
+			order.push_back(p);
+			for (int next : after[static_cast<size_t>(p)]) {
+				if (--waiting[static_cast<size_t>(next)] == 0) ready.push_back(next);
+			}
+		}
+	}
+
+	// Walks the schedule: a target takes a free pooled texture of its size at its first
+	// pass and hands it back after its last.
+	void Allocate() {
+		std::vector<int> first(resources.size(), -1), last(resources.size(), -1);
+		for (size_t at = 0; at < order.size(); ++at) {
+			const Pass& pass = PassAt(order[at]);
+			for (const std::vector<Handle>* list : { &pass.reads, &pass.writes }) {
+				for (Handle h : *list) {
+					const size_t r = Of(h);
+					if (first[r] < 0) first[r] = static_cast<int>(at);
+					last[r] = static_cast<int>(at);
+				}
+			}
+		}
+		for (Physical& p : pool) p.wanted = p.busy = false;
+		stats.targets = 0;
+		stats.unaliasedBytes = 0;
+		for (size_t at = 0; at < order.size(); ++at) {
+			for (size_t r = 0; r < resources.size(); ++r) {
+				Resource& res = resources[r];
+				if (res.external || first[r] != static_cast<int>(at)) continue;
+				res.physical = Acquire(res);
+				++stats.targets;
+				stats.unaliasedBytes += Bytes(res.width, res.height);
+			}
+			for (size_t r = 0; r < resources.size(); ++r) {
+				if (!resources[r].external && last[r] == static_cast<int>(at)) pool[static_cast<size_t>(resources[r].physical)].busy = false;
+			}
+		}
+
+		// What no target wanted goes back to the GPU; indices shift, so remap the survivors.
+		std::vector<int> remap(pool.size(), -1);
+		size_t kept = 0;
+		for (size_t i = 0; i < pool.size(); ++i) {
+			if (!pool[i].wanted) {
+				UnloadRenderTexture(pool[i].target);
+				continue;
+			}
+			remap[i] = static_cast<int>(kept);
+			pool[kept++] = pool[i];
+		}
+		pool.resize(kept);
+		stats.textures = static_cast<int>(kept);
+		stats.bytes = 0;
+		for (const Physical& p : pool) stats.bytes += Bytes(p.width, p.height);
+		for (Resource& res : resources) {
+			if (res.physical >= 0) res.physical = remap[static_cast<size_t>(res.physical)];
+		}
+	}
+
+	int Acquire(const Resource& res) {
+		for (size_t i = 0; i < pool.size(); ++i) {
+			Physical& p = pool[i];
+			if (p.busy || p.width != res.width || p.height != res.height) continue;
+			p.wanted = p.busy = true;
+			return static_cast<int>(i);
+		}
+		RenderTexture2D target = LoadRenderTexture(res.width, res.height);
+		if (target.id) SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+		else TraceLog(LOG_WARNING, "FRAMEGRAPH: no %dx%d texture for %s", res.width, res.height, res.name);
+		pool.push_back({ target, res.width, res.height, true, true });
+		return static_cast<int>(pool.size() - 1);
+	}
+
+	static size_t Bytes(int w, int h) {
+		return static_cast<size_t>(w) * static_cast<size_t>(h) * 4;
+	}
+
+	std::vector<Resource> resources;
+	std::vector<Version>  versions;
+	std::vector<Pass>     passes;
+	std::vector<int>      order;
+	std::vector<Physical> pool;
+	Stats                 stats;
+};
+
+#endif // FRAME_GRAPH_H
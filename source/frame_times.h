@@ -0,0 +1,235 @@
+#ifndef FRAME_TIMES_H
+#define FRAME_TIMES_H
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "raylib.h"
+
+// --- LATENCY HISTOGRAM ---
+// Every sample of a session at a fixed cost, HDR-histogram style: microseconds are counted
+// in C_SUB_BUCKETS linear buckets per power of two, so any percentile comes back within
+// 1/C_SUB_BUCKETS (3%) of the true value however long the session and however far the
+// outliers, where the profiler's ring only remembers the last few seconds. Up to 2^32 us;
+// longer samples land in the last bucket. Counters are relaxed atomics and the maximum a
+// CAS loop, so any number of threads may record at once (WorldBatch's workers all record
+// SIM_TICK) and any may read; a read racing a record may see its count before its bucket.
+class LatencyHistogram {
+public:
+	static constexpr int C_SUB_BITS = 5;
+	static constexpr int C_SUB_BUCKETS = 1 << C_SUB_BITS;
+	static constexpr int C_MAX_SHIFT = 26;  // 2^(C_SUB_BITS + C_MAX_SHIFT + 1) us, about 71 minutes
+	static constexpr int C_BUCKETS = C_SUB_BUCKETS * (C_MAX_SHIFT + 2);
+
+	void Record(double ms) {
+		const double us = ms * 1000.0;
+		const uint64_t v = us <= 0.0 ? 0 : us >= C_TOP ? static_cast<uint64_t>(C_TOP) : static_cast<uint64_t>(us);
+		buckets[IndexOf(v)].fetch_add(1, std::memory_order_relaxed);
+		count.fetch_add(1, std::memory_order_relaxed);
+		sumUs.fetch_add(v, std::memory_order_relaxed);
+		for (uint64_t m = maxUs.load(std::memory_order_relaxed); v > m;) {
+			if (maxUs.compare_exchange_weak(m, v, std::memory_order_relaxed)) break;
+		}
+	}
+
+	void Reset() {
+		for (auto& b : buckets) b.store(0, std::memory_order_relaxed);
+		count.store(0, std::memory_order_relaxed);
+		sumUs.store(0, std::memory_order_relaxed);
+		maxUs.store(0, std::memory_order_relaxed);
+	}
+
+	uint64_t Count() const {
+		return count.load(std::memory_order_relaxed);
+	}
+
+	double MeanMs() const {
+		const uint64_t n = Count();
+		return n ? static_cast<double>(sumUs.load(std::memory_order_relaxed)) / static_cast<double>(n) * 1e-3 : 0.0;
+	}
+
+	double MaxMs() const {
+		return static_cast<double>(maxUs.load(std::memory_order_relaxed)) * 1e-3;
+	}
+
+	// The sample q of the way up (0.99 is p99), as the middle of its bucket; never past the
+	// largest sample.
+	double PercentileMs(double q) const {
+		const uint64_t n = Count();
+		if (n == 0) return 0.0;
+		uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(n) + 0.5);
+		if (rank < 1) rank = 1;
+		if (rank > n) rank = n;
+		uint64_t seen = 0;
+		for (int i = 0; i < C_BUCKETS; ++i) {
+			seen += buckets[i].load(std::memory_order_relaxed);
+			if (seen >= rank) {
+				const double ms = (static_cast<double>(LowerOf(i)) + 0.5 * static_cast<double>(WidthOf(i))) * 1e-3;
+				return ms < MaxMs() ? ms : MaxMs();
+			}
+		}
+		return MaxMs();
+	}
+
+private:
+	static constexpr double C_TOP = static_cast<double>((uint64_t{ 1 } << (C_SUB_BITS + C_MAX_SHIFT + 1)) - 1);
+
+	// Values below 2 * C_SUB_BUCKETS have a bucket each; above, a power of two [2^m, 2^(m+1))
+	// splits into C_SUB_BUCKETS of width 2^(m - C_SUB_BITS).
+	static int IndexOf(uint64_t v) {
+		if (v < 2 * C_SUB_BUCKETS) return static_cast<int>(v);
+		const int shift = static_cast<int>(std::bit_width(v)) - 1 - C_SUB_BITS;
+		return C_SUB_BUCKETS * shift + static_cast<int>(v >> shift);
+	}
+
+	static uint64_t LowerOf(int i) {
+		if (i < 2 * C_SUB_BUCKETS) return static_cast<uint64_t>(i);
+		const int shift = i / C_SUB_BUCKETS - 1;
+		return static_cast<uint64_t>(i - C_SUB_BUCKETS * shift) << shift;
+	}
+
+	static uint64_t WidthOf(int i) {
+		return i < 2 * C_SUB_BUCKETS ? 1 : uint64_t{ 1 } << (i / C_SUB_BUCKETS - 1);
+	}
+
+	std::atomic<uint64_t> buckets[C_BUCKETS] = {};
+	std::atomic<uint64_t> count{ 0 };
+	std::atomic<uint64_t> sumUs{ 0 };
+	std::atomic<uint64_t> maxUs{ 0 };
+};
+
+// --- FRAME TIMES ---
+// Whole-session distributions of the times players feel as stutter: the CPU frame (the
+// render thread's loop, Profiler's FRAME), the GPU frame (GpuProfiler's total, as each
+// frame is read back) and every simulation tick. An average hides a hitch every few
+// seconds; p99 and max don't. Report() logs p50/p95/p99/max at exit and Write() saves them
+// as JSON. CheckBaseline() compares a run against such a file, so an unattended replay can
+// fail when a p99 grows past the stored one by more than the tolerance.
+class FrameTimes {
+public:
+	enum class Series { CPU_FRAME, GPU_FRAME, SIM_TICK, COUNT };
+	static constexpr int C_SERIES = static_cast<int>(Series::COUNT);
+
+	// A p99 may exceed its baseline by this much on top of the tolerance: sub-millisecond
+	// ticks jitter by more than any fraction of themselves.
+	static constexpr double C_SLACK_MS = 0.02;
+
+	struct Summary {
+		uint64_t count;
+		double   mean;
+		double   p50;
+		double   p95;
+		double   p99;
+		double   max;
+	};
+
+	static FrameTimes& Instance() {
+		static FrameTimes instance;
+		return instance;
+	}
+
+	static const char* NameOf(Series s) {
+		static constexpr const char* names[C_SERIES] = { "cpu_frame", "gpu_frame", "sim_tick" };
+		return names[static_cast<int>(s)];
+	}
+
+	void Record(Series s, double ms) {
+		series[static_cast<int>(s)].Record(ms);
+	}
+
+	void Reset() {
+		for (LatencyHistogram& h : series) h.Reset();
+	}
+
+	Summary Get(Series s) const {
+		const LatencyHistogram& h = series[static_cast<int>(s)];
+		return { h.Count(), h.MeanMs(), h.PercentileMs(0.50), h.PercentileMs(0.95), h.PercentileMs(0.99), h.MaxMs() };
+	}
+
+	// Every series with samples, to the log.
+	void Report() const {
+		for (int i = 0; i < C_SERIES; ++i) {
+			const Summary s = Get(static_cast<Series>(i));
+			if (s.count == 0) continue;
+			TraceLog(LOG_INFO, "FRAMES: %-9s %8llu samples, mean %7.3f ms, p50 %7.3f, p95 %7.3f, p99 %7.3f, max %7.3f",
+				NameOf(static_cast<Series>(i)), static_cast<unsigned long long>(s.count), s.mean, s.p50, s.p95, s.p99, s.max);
+		}
+	}
+
+	// Returns false if the file can't be written.
+	bool Write(const char* path) const {
+		FILE* f = Open(path, "wb");
+		if (!f) return false;
+		fputs("{\n", f);
+		for (int i = 0; i < C_SERIES; ++i) {
+			const Summary s = Get(static_cast<Series>(i));
+			fprintf(f, "  \"%s\": { \"count\": %llu, \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n",
+				NameOf(static_cast<Series>(i)), static_cast<unsigned long long>(s.count), s.mean, s.p50, s.p95, s.p99, s.max,
+				i + 1 < C_SERIES ? "," : "");
+		}
+		fputs("}\n", f);
+		fclose(f);
+		return true;
+	}
+
+	// Compares every series sampled in both this run and the baseline (a file from Write()):
+	// one whose p99 is past baseline * (1 + tolerance) + C_SLACK_MS is logged and counted in
+	// `regressions`. Returns false if the baseline can't be read.
+	bool CheckBaseline(const char* path, double tolerance, int& regressions) const {
+		regressions = 0;
+		FILE* f = Open(path, "rb");
+		if (!f) return false;
+		char text[4096];
+		const size_t n = fread(text, 1, sizeof(text) - 1, f);
+		fclose(f);
+		text[n] = '\0';
+
+		bool any = false;
+		for (int i = 0; i < C_SERIES; ++i) {
+			const Series id = static_cast<Series>(i);
+			char key[32];
+			snprintf(key, sizeof(key), "\"%s\"", NameOf(id));
+			const char* at = strstr(text, key);
+			if (!at) continue;
+			at += strlen(key);
+			const char* c = strstr(at, "\"count\":");
+			const char* p = strstr(at, "\"p99\":");
+			if (!c || !p) continue;
+			const unsigned long long count = strtoull(c + strlen("\"count\":"), nullptr, 10);
+			const double p99 = strtod(p + strlen("\"p99\":"), nullptr);
+			any = true;
+			const Summary s = Get(id);
+			if (count == 0 || s.count == 0) continue;
+			const double limit = p99 * (1.0 + tolerance) + C_SLACK_MS;
+			if (s.p99 > limit) {
+				TraceLog(LOG_ERROR, "FRAMES: %s p99 %.3f ms is past the baseline's %.3f ms (limit %.3f ms)", NameOf(id), s.p99, p99, limit);
+				++regressions;
+			}
+			else {
+				TraceLog(LOG_INFO, "FRAMES: %s p99 %.3f ms, baseline %.3f ms", NameOf(id), s.p99, p99);
+			}
+		}
+		return any;
+	}
+
+private:
+	FrameTimes() = default;
+
+	static FILE* Open(const char* path, const char* mode) {
+		FILE* f = nullptr;
+#if defined(_MSC_VER)
+		if (fopen_s(&f, path, mode) != 0) f = nullptr;
+#else
+		f = fopen(path, mode);
+#endif
+		return f;
+	}
+
+	LatencyHistogram series[C_SERIES];
+};
+
+#endif // FRAME_TIMES_H
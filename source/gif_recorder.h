@@ -0,0 +1,204 @@
+#ifndef GIF_RECORDER_H
+#define GIF_RECORDER_H
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "raylib.h"
+#include "external/msf_gif.h"  // the encoder, compiled into rcore (SUPPORT_GIF_ENCODER)
+#include "screen_capture.h"
+
+// --- GIF RECORDER ---
+// CTRL+F12 screen recording without the frame-time cost of raylib's own recorder, which reads
+// the screen back synchronously and encodes on the main thread. Here:
+//   - Capture() issues a ScreenReadback at most every C_INTERVAL seconds; nothing waits for it;
+//   - a later Capture() maps each readback whose fence has signalled (a frame or two on) and
+//     copies it into a slot of a single-producer, single-consumer ring of C_QUEUE frames;
+//   - an encoder thread takes the slots in order through msf_gif_frame, each frame shown
+//     until the next one's capture time, and writes the file once the recording stops.
+// Frames are dropped, never waited for: when every readback is still in flight, and when the
+// ring is full because the encoder is behind. A dropped frame leaves the previous one on
+// screen longer, so the clip keeps real time. Main (GL) thread only, bar the encoder; without
+// GL 3.3 Start() refuses.
+class GifRecorder {
+public:
+	static constexpr int    C_QUEUE = 8;          // frames between readback and encoder
+	static constexpr double C_INTERVAL = 0.03;    // seconds between captures, ~33 fps
+	static constexpr int    C_BIT_DEPTH = 16;     // msf_gif's colour quality, as raylib records
+
+	static GifRecorder& Instance() {
+		static GifRecorder instance;
+		return instance;
+	}
+
+	void Init() {
+		supported = ScreenReadback::Supported();
+	}
+
+	void Unload() {
+		Stop();
+		if (encoder.joinable()) encoder.join();
+		readback.Unload();
+		slots.clear();
+		slots.shrink_to_fit();
+	}
+
+	bool Recording() const {
+		return recording;
+	}
+
+	void Toggle() {
+		if (recording) Stop();
+		else Start();
+	}
+
+	// Starts recording the screen to screenrecNNN.gif next to the executable. Waits for the
+	// previous recording's file to be written, if it is still being encoded.
+	void Start() {
+		if (recording) return;
+		if (!supported) {
+			TraceLog(LOG_WARNING, "GIF: recording needs pixel buffers and fences (GL 3.3)");
+			return;
+		}
+		if (encoder.joinable()) encoder.join();
+
+		readback.Track();
+		frameBytes = readback.FrameBytes();
+		slots.assign(frameBytes * C_QUEUE, 0);
+
+		path = TextFormat("%sscreenrec%03i.gif", GetApplicationDirectory(), ++clips);
+		msf_gif_begin(&gif, readback.Width(), readback.Height());
+		head.store(0, std::memory_order_relaxed);
+		tail.store(0, std::memory_order_relaxed);
+		finishing.store(false, std::memory_order_relaxed);
+		queued = dropped = 0;
+		nextCapture = GetTime();
+		recording = true;
+		encoder = std::thread([this] { Encode(); });
+		TraceLog(LOG_INFO, "GIF: recording %s (%i x %i)", path.c_str(), readback.Width(), readback.Height());
+	}
+
+	// Stops capturing. The readbacks in flight are waited for, so the clip ends on the last
+	// frame captured; encoding and writing the file finish on the encoder thread.
+	void Stop() {
+		if (!recording) return;
+		recording = false;
+		Collect(true);
+		finishing.store(true, std::memory_order_release);
+		Wake();
+	}
+
+	// Once per frame, after the frame is drawn and before EndDrawing, with the default
+	// framebuffer bound. Whatever is drawn after it is left out of the clip.
+	void Capture() {
+		if (!recording) return;
+		int w, h;
+		ScreenReadback::ScreenSize(w, h);
+		if (w != readback.Width() || h != readback.Height()) {
+			TraceLog(LOG_INFO, "GIF: window resized, recording stopped");
+			Stop();
+			return;
+		}
+		Collect(false);
+
+		const double now = GetTime();
+		if (now < nextCapture) return;
+		nextCapture = now + C_INTERVAL;
+		if (!readback.Issue(now)) ++dropped;
+	}
+
+	int Dropped() const {
+		return dropped;
+	}
+
+private:
+	uint8_t* Slot(uint32_t index) {
+		return slots.data() + frameBytes * (index % C_QUEUE);
+	}
+
+	// Moves the readbacks that have landed into the ring. With `wait` every one in flight is
+	// waited for.
+	void Collect(bool wait) {
+		dropped += readback.Collect(wait, [this](const uint8_t* pixels, double stamp) { Enqueue(pixels, stamp); });
+	}
+
+	void Enqueue(const uint8_t* pixels, double stamp) {
+		const uint32_t h = head.load(std::memory_order_relaxed);
+		if (h - tail.load(std::memory_order_acquire) == C_QUEUE) {
+			++dropped;
+			return;
+		}
+		memcpy(Slot(h), pixels, frameBytes);
+		times[h % C_QUEUE] = stamp;
+		head.store(h + 1, std::memory_order_release);
+		++queued;
+		Wake();
+	}
+
+	void Wake() {
+		wake.fetch_add(1, std::memory_order_release);
+		wake.notify_one();
+	}
+
+	// The encoder thread. A frame is encoded once the next one has arrived (its capture time
+	// is the first one's duration), or once the recording has finished; delays are rounded on
+	// the running total so they don't drift from the capture times.
+	void Encode() {
+		const int stride = readback.Width() * 4;
+		double origin = 0.0;
+		long long shown = 0;
+		for (uint32_t t = 0;;) {
+			const uint32_t seen = wake.load(std::memory_order_acquire);
+			const bool finished = finishing.load(std::memory_order_acquire);
+			const uint32_t h = head.load(std::memory_order_acquire);
+			if (h == t && finished) break;
+			if (h == t || (h == t + 1 && !finished)) {
+				wake.wait(seen, std::memory_order_acquire);
+				continue;
+			}
+
+			if (t == 0) origin = times[0];
+			const double until = h == t + 1 ? times[t % C_QUEUE] + C_INTERVAL : times[(t + 1) % C_QUEUE];
+			const long long total = std::llround((until - origin) * 100.0);
+			const int centiseconds = static_cast<int>(total - shown);
+			shown = total;
+			// Bottom row first, as GL reads it back: a negative pitch makes msf_gif flip it.
+			msf_gif_frame(&gif, Slot(t), centiseconds, C_BIT_DEPTH, -stride);
+			tail.store(++t, std::memory_order_release);
+		}
+
+		MsfGifResult result = msf_gif_end(&gif);
+		if (result.data != nullptr && SaveFileData(path.c_str(), result.data, static_cast<int>(result.dataSize))) {
+			TraceLog(LOG_INFO, "GIF: wrote %s, %i frames (%i dropped), %.1f s", path.c_str(), queued, dropped, static_cast<double>(shown) / 100.0);
+		}
+		else {
+			TraceLog(LOG_WARNING, "GIF: could not write %s", path.c_str());
+		}
+		msf_gif_free(result);
+	}
+
+	ScreenReadback readback;
+	bool           supported = false;
+	bool           recording = false;
+	size_t         frameBytes = 0;
+	int            clips = 0;
+	std::string    path;
+	double         nextCapture = 0.0;
+	int            queued = 0, dropped = 0;  // read by the encoder only once `finishing` is set
+
+	// The ring: the main thread fills slot `head`, the encoder empties slot `tail`.
+	std::vector<uint8_t>  slots;
+	double                times[C_QUEUE] = {};
+	std::atomic<uint32_t> head{0}, tail{0};
+	std::atomic<uint32_t> wake{0};  // bumped on every push and on finishing, what the encoder sleeps on
+	std::atomic<bool>     finishing{false};
+	MsfGifState           gif = {};  // the encoder thread's while it runs
+	std::thread           encoder;
+};
+
+#endif // GIF_RECORDER_H
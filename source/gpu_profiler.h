@@ -0,0 +1,206 @@
+#ifndef GPU_PROFILER_H
+#define GPU_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"  // timer queries, which rlgl doesn't wrap
+#include "profiler.h"
+
+// --- GPU PROFILER ---
+// GPU time per named render pass, the counterpart of Profiler's CPU phases. Begin()/End()
+// (or GPU_SCOPE) flush rlgl's batch and drop a GL_TIMESTAMP query on either side of the pass,
+// so passes may nest and sit inside DynamicResolution's GL_TIME_ELAPSED query. Queries are
+// read back C_LATENCY frames later, in BeginFrame(), when they have long finished: nothing
+// waits on the GPU, and a frame whose results still aren't in is dropped rather than waited
+// for. With a trace recording, every pass also goes onto a "gpu" track, its times moved onto
+// the CPU clock. Main (GL) thread only; without timer queries (before GL 3.3) it stays empty.
+class GpuProfiler {
+public:
+	static constexpr int   C_LATENCY = 4;      // frames in flight
+	static constexpr int   C_MAX_PASSES = 32;  // timed per frame; more are ignored
+	static constexpr float C_SMOOTHING = 0.1f; // weight of a new frame in the average
+
+	struct Pass {
+		const char* name;
+		float       last;     // ms in the newest frame read back
+		float       average;  // exponentially smoothed
+		bool        seen;     // in that frame
+	};
+
+	static GpuProfiler& Instance() {
+		static GpuProfiler instance;
+		return instance;
+	}
+
+	void Init() {
+		timed = GLAD_GL_VERSION_3_3 != 0;
+		if (!timed) return;
+		for (Frame& f : frames) {
+			glGenQueries(C_MAX_PASSES * 2, f.queries);
+			f.count = 0;
+		}
+		// GPU timestamps onto the trace's clock, once: both run at nanoseconds and don't drift
+		// apart over a session by anything a trace would show.
+		GLint64 gpuNow = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+		cpuBase = Trace::Clock::now();
+		gpuBase = gpuNow;
+		frame = 0;
+	}
+
+	void Unload() {
+		if (timed) {
+			for (Frame& f : frames) glDeleteQueries(C_MAX_PASSES * 2, f.queries);
+		}
+		timed = false;
+		passes.clear();
+	}
+
+	// Once a frame, before its first pass: reads back the frame that used this slot last.
+	// Returns true when one came in, TotalMs() and Passes() then being its times.
+	bool BeginFrame() {
+		if (!timed) return false;
+		++frame;
+		Frame& f = frames[frame % C_LATENCY];
+		const bool collected = f.count > 0 && f.last != 0 && Collect(f);
+		f.count = 0;
+		f.last = 0;
+		depth = 0;
+		return collected;
+	}
+
+	// `name` must be a literal: passes are told apart by its address.
+	void Begin(const char* name) {
+		if (!timed) return;
+		Frame& f = frames[frame % C_LATENCY];
+		if (depth >= C_MAX_DEPTH) {
+			++depth;
+			return;
+		}
+		if (f.count >= C_MAX_PASSES) {
+			open[depth++] = -1;
+			return;
+		}
+		rlDrawRenderBatchActive();
+		const int index = f.count++;
+		f.names[index] = name;
+		glQueryCounter(f.queries[index * 2], GL_TIMESTAMP);
+		open[depth++] = index;
+	}
+
+	void End() {
+		if (!timed || depth == 0 || depth-- > C_MAX_DEPTH) return;
+		const int index = open[depth];
+		if (index < 0) return;
+		rlDrawRenderBatchActive();
+		Frame& f = frames[frame % C_LATENCY];
+		f.last = f.queries[index * 2 + 1];
+		glQueryCounter(f.last, GL_TIMESTAMP);
+	}
+
+	// Every pass seen so far, in the order they first ran.
+	const std::vector<Pass>& Passes() const {
+		return passes;
+	}
+
+	// Sum of the newest frame's outermost passes.
+	float TotalMs() const {
+		return totalMs;
+	}
+
+	// Frames whose queries hadn't finished C_LATENCY frames on.
+	int Dropped() const {
+		return dropped;
+	}
+
+private:
+	static constexpr int C_MAX_DEPTH = 8;
+
+	struct Frame {
+		GLuint      queries[C_MAX_PASSES * 2] = {};  // begin, end per pass
+		const char* names[C_MAX_PASSES] = {};
+		int         count = 0;
+		GLuint      last = 0;  // the latest issued; the rest finished before it
+	};
+
+	GpuProfiler() = default;
+
+	// False when the frame's queries haven't finished.
+	bool Collect(Frame& f) {
+		GLint available = 0;
+		glGetQueryObjectiv(f.last, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available) {
+			++dropped;
+			return false;
+		}
+		for (Pass& p : passes) p.seen = false;
+		totalMs = 0.0f;
+		uint64_t outerEnd = 0;
+		for (int i = 0; i < f.count; ++i) {
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(f.queries[i * 2], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(f.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+			if (end < begin) continue;  // left open
+			const float ms = static_cast<float>(end - begin) * 1e-6f;
+			if (begin >= outerEnd) {
+				totalMs += ms;
+				outerEnd = end;
+			}
+			Record(f.names[i], ms);
+			if (Trace::Enabled()) Trace::Instance().CompleteOn("gpu", f.names[i], ToCpu(begin), ToCpu(end));
+		}
+		for (Pass& p : passes) {
+			if (p.seen) p.average += (p.last - p.average) * C_SMOOTHING;
+		}
+		return true;
+	}
+
+	// A pass that runs several times a frame sums; a new one starts its average at its first time.
+	void Record(const char* name, float ms) {
+		for (Pass& p : passes) {
+			if (p.name != name) continue;
+			p.last = p.seen ? p.last + ms : ms;
+			p.seen = true;
+			return;
+		}
+		passes.push_back({ name, ms, ms, true });
+	}
+
+	Trace::Clock::time_point ToCpu(uint64_t gpu) const {
+		const auto offset = std::chrono::nanoseconds(static_cast<int64_t>(gpu) - gpuBase);
+		return cpuBase + std::chrono::duration_cast<Trace::Clock::duration>(offset);
+	}
+
+	Frame                    frames[C_LATENCY];
+	std::vector<Pass>        passes;
+	int                      open[C_MAX_DEPTH] = {};
+	int                      depth = 0;
+	uint64_t                 frame = 0;
+	bool                     timed = false;
+	float                    totalMs = 0.0f;
+	int                      dropped = 0;
+	Trace::Clock::time_point cpuBase{};
+	int64_t                  gpuBase = 0;
+};
+
+// Times the enclosing scope on the GPU.
+class GpuScope {
+public:
+	explicit GpuScope(const char* name) {
+		GpuProfiler::Instance().Begin(name);
+	}
+	~GpuScope() {
+		GpuProfiler::Instance().End();
+	}
+
+	GpuScope(const GpuScope&) = delete;
+	GpuScope& operator=(const GpuScope&) = delete;
+};
+
+#define GPU_SCOPE(name) GpuScope PROFILE_CONCAT(gpuScope_, __LINE__)(name)
+
+#endif // GPU_PROFILER_H
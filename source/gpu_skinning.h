@@ -0,0 +1,126 @@
+#ifndef GPU_SKINNING_H
+#define GPU_SKINNING_H
+
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // uniform buffers and vertex arrays, which rlgl doesn't wrap
+
+// --- GPU SKINNING ---
+// Skeletal animation skinned in the vertex shader (lighting_skinned.vs) instead of by
+// UpdateModelAnimation, which poses every vertex on the CPU and re-uploads the meshes'
+// positions and normals each frame. Here the meshes keep their bind pose on the GPU; a frame
+// only uploads one matrix per bone. Init() adds each mesh's bone ids and weights to its vertex
+// array at C_IDS_LOCATION and C_WEIGHTS_LOCATION, the locations the shader declares.
+//
+// Per skinned draw: Pose(), then draw the model with a material whose shader went through
+// Bind(). Pose() rebinds this model's buffer, so several skinned models can share a shader.
+class GpuSkinning {
+public:
+	static constexpr int          C_MAX_BONES = 128;        // MAX_BONES in lighting_skinned.vs
+	static constexpr unsigned int C_BONE_BINDING = 1;       // the light buffer has 0
+	static constexpr unsigned int C_IDS_LOCATION = 6;       // after raylib's default attributes
+	static constexpr unsigned int C_WEIGHTS_LOCATION = 7;
+
+	// False, and nothing to unload, if the model has no skeleton or too many bones.
+	bool Init(const Model& model) {
+		if (model.boneCount <= 0 || model.boneCount > C_MAX_BONES || model.bindPose == nullptr) return false;
+
+		for (int m = 0; m < model.meshCount; ++m) {
+			const Mesh& mesh = model.meshes[m];
+			if (mesh.boneIds == nullptr || mesh.boneWeights == nullptr || mesh.vaoId == 0) continue;
+			const unsigned int ids = rlLoadVertexBuffer(mesh.boneIds, mesh.vertexCount * 4 * static_cast<int>(sizeof(unsigned char)), false);
+			rlEnableVertexArray(mesh.vaoId);
+			rlEnableVertexBuffer(ids);
+			rlSetVertexAttribute(C_IDS_LOCATION, 4, RL_UNSIGNED_BYTE, false, 0, nullptr);
+			rlEnableVertexAttribute(C_IDS_LOCATION);
+			const unsigned int weights = rlLoadVertexBuffer(mesh.boneWeights, mesh.vertexCount * 4 * static_cast<int>(sizeof(float)), false);
+			rlEnableVertexBuffer(weights);
+			rlSetVertexAttribute(C_WEIGHTS_LOCATION, 4, RL_FLOAT, false, 0, nullptr);
+			rlEnableVertexAttribute(C_WEIGHTS_LOCATION);
+			rlDisableVertexArray();
+			rlDisableVertexBuffer();
+			buffers.push_back(ids);
+			buffers.push_back(weights);
+		}
+
+		boneCount = model.boneCount;
+		bones.assign(static_cast<size_t>(boneCount) * 16, 0.0f);
+		glGenBuffers(1, &boneBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, boneBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(C_MAX_BONES * sizeof(float16)), nullptr, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		TraceLog(LOG_INFO, "SKINNING: [ID %u] %i bone(s) in %i mesh(es)", boneBuffer, boneCount, static_cast<int>(buffers.size() / 2));
+		return true;
+	}
+
+	void Unload() {
+		for (unsigned int id : buffers) rlUnloadVertexBuffer(id);
+		buffers.clear();
+		if (boneBuffer) glDeleteBuffers(1, &boneBuffer);
+		boneBuffer = 0;
+	}
+
+	// Points a shader's BoneBlock at the bone buffers' binding. Needed again for any program
+	// that replaces this one.
+	static bool Bind(Shader shader) {
+		const unsigned int block = glGetUniformBlockIndex(shader.id, "BoneBlock");
+		if (block == GL_INVALID_INDEX) return false;
+		glUniformBlockBinding(shader.id, block, C_BONE_BINDING);
+		return true;
+	}
+
+	// What UpdateModelAnimation does to a vertex for one bone, as a matrix: out of the bind
+	// pose `in`, scaled, rotated, into the frame's pose `out`.
+	static Matrix BoneMatrix(const Transform& in, const Transform& out) {
+		Matrix bone = MatrixMultiply(MatrixTranslate(-in.translation.x, -in.translation.y, -in.translation.z), MatrixScale(out.scale.x, out.scale.y, out.scale.z));
+		bone = MatrixMultiply(bone, QuaternionToMatrix(QuaternionMultiply(out.rotation, QuaternionInvert(in.rotation))));
+		return MatrixMultiply(bone, MatrixTranslate(out.translation.x, out.translation.y, out.translation.z));
+	}
+
+	// Uploads the bones for `frame` of `anim` and binds them for the next draws.
+	void Pose(const Model& model, const ModelAnimation& anim, int frame) {
+		if (!boneBuffer || anim.frameCount <= 0 || anim.boneCount != boneCount) return;
+		frame %= anim.frameCount;
+
+		for (int b = 0; b < boneCount; ++b) {
+			const float16 columns = MatrixToFloatV(BoneMatrix(model.bindPose[b], anim.framePoses[frame][b]));
+			for (int i = 0; i < 16; ++i) bones[static_cast<size_t>(b) * 16 + i] = columns.v[i];
+		}
+
+		glBindBuffer(GL_UNIFORM_BUFFER, boneBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, static_cast<GLsizeiptr>(bones.size() * sizeof(float)), bones.data());
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		glBindBufferBase(GL_UNIFORM_BUFFER, C_BONE_BINDING, boneBuffer);
+		uploaded += static_cast<int>(bones.size() * sizeof(float));
+	}
+
+	// Puts the bind pose back into buffers UpdateModelAnimation has overwritten, which this
+	// shader would otherwise skin a second time.
+	static void RestoreBindPose(const Model& model) {
+		for (int m = 0; m < model.meshCount; ++m) {
+			const Mesh& mesh = model.meshes[m];
+			if (mesh.vboId == nullptr) continue;
+			rlUpdateVertexBuffer(mesh.vboId[0], mesh.vertices, mesh.vertexCount * 3 * static_cast<int>(sizeof(float)), 0);
+			if (mesh.normals != nullptr) rlUpdateVertexBuffer(mesh.vboId[2], mesh.normals, mesh.vertexCount * 3 * static_cast<int>(sizeof(float)), 0);
+		}
+	}
+
+	// Bone bytes uploaded since the last call.
+	int TakeUploaded() {
+		const int bytes = uploaded;
+		uploaded = 0;
+		return bytes;
+	}
+
+private:
+	std::vector<unsigned int> buffers;  // ids and weights, per mesh
+	std::vector<float>        bones;    // column-major, as the block reads them
+	unsigned int              boneBuffer = 0;
+	int                       boneCount = 0;
+	int                       uploaded = 0;
+};
+
+#endif // GPU_SKINNING_H
@@ -0,0 +1,313 @@
+#ifndef GPU_SWARM_H
+#define GPU_SWARM_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // memory barriers and program point size, which rlgl doesn't wrap
+#include "shader_cache.h"
+
+// --- GPU SWARM ---
+// Asteroids and projectiles that live entirely on the GPU, in shader storage buffers, for
+// counts a World can't step at frame rate. Every Step is one or more substeps of three
+// passes of swarm.comp: clear the broadphase grid, integrate the asteroids and link each
+// into the list of its grid cell, then integrate the projectiles and test each against the
+// asteroids in the 3x3 cells around it. The test is a point in a circle, so a substep moves
+// a shot at most C_MIN_RADIUS against any asteroid: one passing within most of a radius of
+// the smallest asteroid's centre has a sample inside it. Hit asteroids and spent projectiles respawn somewhere random, so the
+// counts hold. Draw reads the same buffers from the vertex shader, one point per body.
+// Nothing but the hits comes back to the CPU: each step writes them to one of a ring of
+// C_RING event buffers, and the one written C_RING - 1 steps before is read, which the GPU
+// has long finished with, so the read doesn't stall on it.
+//
+// Needs rlgl's compute and storage buffer calls, live only in a GRAPHICS_API_OPENGL_43
+// build (build.bat -GL43), and a 4.3 context. It is not World on the GPU: the simulation
+// thread has no context, and replays and lockstep checksums are CPU arithmetic. Main thread
+// only.
+class GpuSwarm {
+public:
+	// An asteroid as it was hit.
+	struct Hit {
+		Vector2  position;
+		Vector2  velocity;
+		float    radius;
+		uint32_t asteroid;
+	};
+
+	struct Stats {
+		uint64_t steps = 0;
+		uint64_t hits = 0;
+		uint64_t dropped = 0;  // past C_MAX_HITS in a step, counted but not read back
+	};
+
+	static constexpr uint32_t C_MAX_BODIES = 1u << 24;
+	static constexpr uint32_t C_MAX_HITS = 1u << 16;  // read back per step
+
+	// False, with a warning, when the build or the context has no compute shaders.
+	bool Init(uint32_t asteroids_, uint32_t projectiles_) {
+#if defined(GRAPHICS_API_OPENGL_43)
+		if (!GLAD_GL_VERSION_4_3) {
+			TraceLog(LOG_WARNING, "SWARM: the context is older than GL 4.3, no compute shaders");
+			return false;
+		}
+		// swarm.vs reads the bodies straight from their buffers, which GL 4.3 lets a driver
+		// refuse in vertex shaders (the minimum is 0 blocks).
+		GLint vertexBlocks = 0;
+		glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &vertexBlocks);
+		if (vertexBlocks < C_DRAW_BLOCKS) {
+			TraceLog(LOG_WARNING, "SWARM: vertex shaders can read %d storage buffer(s), the swarm draw needs %d", vertexBlocks, C_DRAW_BLOCKS);
+			return false;
+		}
+		asteroidCount = std::min(asteroids_, C_MAX_BODIES);
+		projectileCount = std::min(projectiles_, C_MAX_BODIES);
+		extent = sqrtf(static_cast<float>(std::max(asteroidCount, 1u))) * C_SPACING;
+		cellSize = std::max(C_MAX_RADIUS * 2.f, extent / static_cast<float>(C_MAX_GRID));
+		gridSize = std::max(static_cast<int>(ceilf(extent / cellSize)), 1);
+
+		for (int p = 0; p < PASS_COUNT; ++p) {
+			programs[p] = LoadPass(C_PASSES[p]);
+			if (!programs[p]) return false;
+			Locate(p);
+		}
+
+		// rlLoadShaderBuffer zeroes what it isn't given, and zero is "not spawned yet".
+		const unsigned int cells = static_cast<unsigned int>(gridSize) * static_cast<unsigned int>(gridSize);
+		asteroidBuffer = rlLoadShaderBuffer(asteroidCount * C_ASTEROID_BYTES, nullptr, RL_DYNAMIC_COPY);
+		projectileBuffer = rlLoadShaderBuffer(projectileCount * C_PROJECTILE_BYTES, nullptr, RL_DYNAMIC_COPY);
+		headBuffer = rlLoadShaderBuffer(cells * 4u, nullptr, RL_DYNAMIC_COPY);
+		linkBuffer = rlLoadShaderBuffer(asteroidCount * 4u, nullptr, RL_DYNAMIC_COPY);
+		for (unsigned int& ring : eventBuffers) {
+			ring = rlLoadShaderBuffer(C_EVENT_HEADER + C_MAX_HITS * static_cast<unsigned int>(sizeof(Hit)), nullptr, RL_DYNAMIC_READ);
+		}
+
+		drawShader = ShaderCache::Load("../resources/shaders/glsl430/swarm.vs", "../resources/shaders/glsl430/swarm.fs");
+		drawAsteroidsLoc = GetShaderLocation(drawShader, "asteroidCount");
+		drawScaleLoc = GetShaderLocation(drawShader, "pixelsPerUnit");
+		asteroidColorLoc = GetShaderLocation(drawShader, "asteroidColor");
+		projectileColorLoc = GetShaderLocation(drawShader, "projectileColor");
+		vao = rlLoadVertexArray();
+		stats = {};
+		hits.clear();
+
+		TraceLog(LOG_INFO, "SWARM: %u asteroids, %u projectiles in a %.0f unit world, %dx%d grid of %.1f unit cells, %.1f MB on the GPU",
+			asteroidCount, projectileCount, extent, gridSize, gridSize, cellSize, static_cast<double>(Bytes()) / (1024.0 * 1024.0));
+		return IsReady();
+#else
+		TraceLog(LOG_WARNING, "SWARM: compute shaders need a GL 4.3 build (build.bat -GL43)");
+		return false;
+#endif
+	}
+
+	void Unload() {
+		for (unsigned int& program : programs) {
+			if (program) rlUnloadShaderProgram(program);
+			program = 0;
+		}
+		for (unsigned int* buffer : { &asteroidBuffer, &projectileBuffer, &headBuffer, &linkBuffer, &eventBuffers[0], &eventBuffers[1], &eventBuffers[2] }) {
+			if (*buffer) rlUnloadShaderBuffer(*buffer);
+			*buffer = 0;
+		}
+		if (vao) rlUnloadVertexArray(vao);
+		vao = 0;
+		if (drawShader.id) UnloadShader(drawShader);
+		drawShader = {};
+	}
+
+	bool IsReady() const {
+		return programs[PASS_PROJECTILES] != 0 && asteroidBuffer != 0 && eventBuffers[C_RING - 1] != 0
+			&& vao != 0 && drawShader.id != rlGetShaderIdDefault();
+	}
+
+	// Advances every body by `dt` seconds, in as many substeps as that takes, and replaces
+	// Hits() with those of the step C_RING - 1 steps back.
+	void Step(float dt) {
+		const unsigned int ring = static_cast<unsigned int>(stats.steps % C_RING);
+		const uint32_t zero[4] = {};
+		rlUpdateShaderBuffer(eventBuffers[ring], zero, sizeof(zero), 0);
+
+		rlBindShaderBuffer(asteroidBuffer, 0);
+		rlBindShaderBuffer(projectileBuffer, 1);
+		rlBindShaderBuffer(headBuffer, 2);
+		rlBindShaderBuffer(linkBuffer, 3);
+		rlBindShaderBuffer(eventBuffers[ring], 4);
+
+		const unsigned int counts[PASS_COUNT] = {
+			static_cast<unsigned int>(gridSize) * static_cast<unsigned int>(gridSize), asteroidCount, projectileCount };
+		const int substeps = std::max(1, static_cast<int>(ceilf(dt * (C_SHOT_SPEED + C_MAX_SPEED) / C_MIN_RADIUS)));
+		for (int s = 0; s < substeps; ++s) {
+			for (int p = 0; p < PASS_COUNT; ++p) {
+				rlEnableShader(programs[p]);
+				SetUniforms(p, dt / static_cast<float>(substeps));
+				rlComputeShaderDispatch((counts[p] + C_GROUP - 1) / C_GROUP, 1, 1);
+				glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+			}
+			++substepsRun;
+		}
+		rlDisableShader();
+		++stats.steps;
+
+		// The oldest buffer in the ring is the next one to be written.
+		hits.clear();
+		if (stats.steps < C_RING) return;
+		const unsigned int oldest = eventBuffers[stats.steps % C_RING];
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		uint32_t header[4] = {};
+		rlReadShaderBuffer(oldest, header, sizeof(header), 0);
+		const uint32_t read = std::min(header[0], C_MAX_HITS);
+		stats.hits += header[0];
+		stats.dropped += header[0] - read;
+		if (read == 0) return;
+		hits.resize(read);
+		rlReadShaderBuffer(oldest, hits.data(), read * static_cast<unsigned int>(sizeof(Hit)), C_EVENT_HEADER);
+	}
+
+	const std::vector<Hit>& Hits() const {
+		return hits;
+	}
+
+	// Every body as a point, a disc the size of the body once that is wider than a pixel,
+	// under the current 2D camera (BeginMode2D with `pixelsPerUnit` as its zoom).
+	void Draw(float pixelsPerUnit, Color asteroidColor, Color projectileColor) {
+		if (!IsReady()) return;
+		rlDrawRenderBatchActive();
+
+		rlBindShaderBuffer(asteroidBuffer, 0);
+		rlBindShaderBuffer(projectileBuffer, 1);
+		rlEnableVertexArray(vao);
+		glEnable(GL_PROGRAM_POINT_SIZE);
+		rlEnableShader(drawShader.id);
+		rlSetUniformMatrix(drawShader.locs[SHADER_LOC_MATRIX_MVP],
+			MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+		const int asteroids = static_cast<int>(asteroidCount);
+		rlSetUniform(drawAsteroidsLoc, &asteroids, RL_SHADER_UNIFORM_INT, 1);
+		rlSetUniform(drawScaleLoc, &pixelsPerUnit, RL_SHADER_UNIFORM_FLOAT, 1);
+		const Vector4 a = ColorNormalize(asteroidColor);
+		const Vector4 p = ColorNormalize(projectileColor);
+		rlSetUniform(asteroidColorLoc, &a, RL_SHADER_UNIFORM_VEC4, 1);
+		rlSetUniform(projectileColorLoc, &p, RL_SHADER_UNIFORM_VEC4, 1);
+
+		glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(asteroidCount + projectileCount));
+
+		rlDisableShader();
+		glDisable(GL_PROGRAM_POINT_SIZE);
+		rlDisableVertexArray();
+	}
+
+	// The world is [0, Extent()) on both axes, wrapping.
+	float Extent() const {
+		return extent;
+	}
+
+	uint32_t Asteroids() const {
+		return asteroidCount;
+	}
+
+	uint32_t Projectiles() const {
+		return projectileCount;
+	}
+
+	// Storage buffer bytes.
+	size_t Bytes() const {
+		const size_t cells = static_cast<size_t>(gridSize) * static_cast<size_t>(gridSize);
+		return static_cast<size_t>(asteroidCount) * (C_ASTEROID_BYTES + 4) + static_cast<size_t>(projectileCount) * C_PROJECTILE_BYTES
+			+ cells * 4 + C_RING * (C_EVENT_HEADER + C_MAX_HITS * sizeof(Hit));
+	}
+
+	const Stats& GetStats() const {
+		return stats;
+	}
+
+private:
+	enum Pass { PASS_CLEAR, PASS_ASTEROIDS, PASS_PROJECTILES, PASS_COUNT };
+	static constexpr const char* C_PASSES[PASS_COUNT] = { "PASS_CLEAR", "PASS_ASTEROIDS", "PASS_PROJECTILES" };
+
+	// Uniforms a pass may have; the ones it doesn't use are -1 and skipped.
+	enum Uniform { U_ASTEROIDS, U_PROJECTILES, U_CAPACITY, U_FRAME, U_DT, U_EXTENT, U_CELL, U_GRID, U_RADIUS, U_SPEED, U_SHOT, U_COUNT };
+	static constexpr const char* C_UNIFORMS[U_COUNT] = { "asteroidCount", "projectileCount", "eventCapacity", "frame", "dt",
+		"extent", "cellSize", "gridSize", "radiusRange", "speedRange", "shot" };
+
+	static constexpr unsigned int C_GROUP = 256;             // swarm.comp's local_size_x
+	static constexpr unsigned int C_RING = 3;
+	static constexpr unsigned int C_ASTEROID_BYTES = 24;     // swarm.comp's structs, std430
+	static constexpr unsigned int C_PROJECTILE_BYTES = 24;
+	static constexpr unsigned int C_EVENT_HEADER = 16;       // the count, padded to a Hit's alignment
+	static constexpr int          C_MAX_GRID = 2048;         // cells a side; keeps the clear in one dispatch
+	static constexpr GLint        C_DRAW_BLOCKS = 2;         // storage buffers swarm.vs reads
+	static constexpr float        C_SPACING = 24.f;          // world units per asteroid, along a side
+	static constexpr float        C_MIN_RADIUS = 2.f;
+	static constexpr float        C_MAX_RADIUS = 6.f;
+	static constexpr float        C_MIN_SPEED = 10.f;
+	static constexpr float        C_MAX_SPEED = 60.f;
+	static constexpr float        C_SHOT_SPEED = 240.f;
+	static constexpr float        C_SHOT_LIFE = 2.f;
+
+	static_assert(sizeof(Hit) == 24, "Hit mirrors swarm.comp's Event");
+
+	static unsigned int LoadPass(const char* pass) {
+		char* code = LoadFileText("../resources/shaders/glsl430/swarm.comp");
+		if (!code) {
+			TraceLog(LOG_WARNING, "SWARM: swarm.comp is missing");
+			return 0;
+		}
+		const std::string source = std::string("#version 430\n#define ") + pass + "\n" + code;  // longer than TextFormat's buffer
+		UnloadFileText(code);
+		const unsigned int shader = rlCompileShader(source.c_str(), RL_COMPUTE_SHADER);
+		const unsigned int program = shader ? rlLoadComputeShaderProgram(shader) : 0;
+		if (shader) glDeleteShader(shader);
+		if (!program) TraceLog(LOG_WARNING, "SWARM: %s failed to build", pass);
+		return program;
+	}
+
+	void Locate(int p) {
+		for (int u = 0; u < U_COUNT; ++u) locs[p][u] = rlGetLocationUniform(programs[p], C_UNIFORMS[u]);
+	}
+
+	void SetUniforms(int p, float dt) {
+		const int* at = locs[p];
+		auto setInt = [](int loc, int value) { if (loc >= 0) rlSetUniform(loc, &value, RL_SHADER_UNIFORM_INT, 1); };
+		auto setFloat = [](int loc, float value) { if (loc >= 0) rlSetUniform(loc, &value, RL_SHADER_UNIFORM_FLOAT, 1); };
+		auto setVec2 = [](int loc, Vector2 value) { if (loc >= 0) rlSetUniform(loc, &value, RL_SHADER_UNIFORM_VEC2, 1); };
+		setInt(at[U_ASTEROIDS], static_cast<int>(asteroidCount));
+		setInt(at[U_PROJECTILES], static_cast<int>(projectileCount));
+		setInt(at[U_CAPACITY], static_cast<int>(C_MAX_HITS));
+		setInt(at[U_FRAME], static_cast<int>(substepsRun & 0x7fffffff));  // reseeds every respawn
+		setFloat(at[U_DT], dt);
+		setFloat(at[U_EXTENT], extent);
+		setFloat(at[U_CELL], cellSize);
+		setInt(at[U_GRID], gridSize);
+		setVec2(at[U_RADIUS], { C_MIN_RADIUS, C_MAX_RADIUS });
+		setVec2(at[U_SPEED], { C_MIN_SPEED, C_MAX_SPEED });
+		setVec2(at[U_SHOT], { C_SHOT_SPEED, C_SHOT_LIFE });
+	}
+
+	uint32_t         asteroidCount = 0;
+	uint32_t         projectileCount = 0;
+	uint64_t         substepsRun = 0;
+	float            extent = 0.f;
+	float            cellSize = 0.f;
+	int              gridSize = 0;
+	unsigned int     programs[PASS_COUNT] = {};
+	int              locs[PASS_COUNT][U_COUNT] = {};
+	unsigned int     asteroidBuffer = 0;
+	unsigned int     projectileBuffer = 0;
+	unsigned int     headBuffer = 0;
+	unsigned int     linkBuffer = 0;
+	unsigned int     eventBuffers[C_RING] = {};
+	Shader           drawShader{};
+	int              drawAsteroidsLoc = -1;
+	int              drawScaleLoc = -1;
+	int              asteroidColorLoc = -1;
+	int              projectileColorLoc = -1;
+	unsigned int     vao = 0;
+	std::vector<Hit> hits;
+	Stats            stats;
+};
+
+#endif // GPU_SWARM_H
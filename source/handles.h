@@ -0,0 +1,114 @@
+#ifndef HANDLES_H
+#define HANDLES_H
+
+#include <cstdint>
+#include <vector>
+
+// --- HANDLES ---
+// Generational references to entities in dense storage that moves them around. A Handle
+// names a slot of a HandleTable, and the slot holds the entity's current dense index, so
+// finding it is one lookup however often the storage was compacted or reordered since: the
+// storage only has to Move() the slots of the entities it relocates. Destroying an entity
+// bumps its slot's generation before the slot is handed out again, so a handle kept past
+// its entity's death finds nothing instead of whoever took the slot over.
+//
+// A handle is 32 bits, C_SLOT_BITS of slot and the rest generation; a slot reused 4096
+// times wraps its generation, long after anything could still hold the first handle.
+struct Handle {
+	static constexpr uint32_t C_SLOT_BITS = 20;
+	static constexpr uint32_t C_SLOT_MASK = (1u << C_SLOT_BITS) - 1;
+	static constexpr uint32_t C_NONE = 0xffffffffu;
+
+	uint32_t bits = C_NONE;
+
+	uint32_t Slot() const { return bits & C_SLOT_MASK; }
+	uint32_t Generation() const { return bits >> C_SLOT_BITS; }
+	bool     IsNone() const { return bits == C_NONE; }
+
+	bool operator==(const Handle&) const = default;
+};
+
+class HandleTable {
+public:
+	// Where a slot's entity is, or C_FREE; trivially copyable for WorldSnapshot.
+	struct Entry {
+		uint32_t index;
+		uint32_t generation;
+	};
+
+	static constexpr uint32_t C_FREE = 0xffffffffu;
+
+	// Forgets every entity. Generations start over, so no handle from before may be used.
+	void Clear() {
+		entries.clear();
+		freeSlots.clear();
+	}
+
+	// A handle for the entity at dense `index`. Returns a none handle once every slot
+	// C_SLOT_BITS can name is taken.
+	Handle Create(uint32_t index) {
+		uint32_t slot;
+		if (!freeSlots.empty()) {
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+		else {
+			if (entries.size() > Handle::C_SLOT_MASK - 1) return {};
+			slot = static_cast<uint32_t>(entries.size());
+			entries.push_back({ C_FREE, 0 });
+		}
+		entries[slot].index = index;
+		return { entries[slot].generation << Handle::C_SLOT_BITS | slot };
+	}
+
+	// The entity is gone: its handles find nothing from now on.
+	void Destroy(Handle h) {
+		if (!Valid(h)) return;
+		Entry& e = entries[h.Slot()];
+		e.index = C_FREE;
+		e.generation = (e.generation + 1) & (C_GENERATIONS - 1);
+		freeSlots.push_back(h.Slot());
+	}
+
+	// The entity now lives at dense `index`.
+	void Move(Handle h, uint32_t index) {
+		if (Valid(h)) entries[h.Slot()].index = index;
+	}
+
+	bool Valid(Handle h) const {
+		if (h.IsNone() || h.Slot() >= entries.size()) return false;
+		const Entry& e = entries[h.Slot()];
+		return e.index != C_FREE && e.generation == h.Generation();
+	}
+
+	// The entity's dense index, or -1 when it is gone.
+	int64_t Find(Handle h) const {
+		return Valid(h) ? static_cast<int64_t>(entries[h.Slot()].index) : -1;
+	}
+
+	// The whole table, for saving and restoring with the storage it indexes.
+	const std::vector<Entry>&    Entries() const { return entries; }
+	const std::vector<uint32_t>& FreeSlots() const { return freeSlots; }
+
+	// Takes a saved table back. False, with the table cleared, when the free list names a
+	// slot that is out of range or in use.
+	bool Restore(const std::vector<Entry>& entries_, const std::vector<uint32_t>& freeSlots_) {
+		entries = entries_;
+		freeSlots = freeSlots_;
+		for (uint32_t slot : freeSlots) {
+			if (slot >= entries.size() || entries[slot].index != C_FREE) {
+				Clear();
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+	static constexpr uint32_t C_GENERATIONS = 1u << (32 - Handle::C_SLOT_BITS);
+
+	std::vector<Entry>    entries;
+	std::vector<uint32_t> freeSlots;
+};
+
+#endif // HANDLES_H
@@ -0,0 +1,243 @@
+#ifndef HYBRID_RAYMARCH_H
+#define HYBRID_RAYMARCH_H
+
+#include <algorithm>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "shader_cache.h"
+#include "external/glad.h"  // sampled depth, multiple render targets and attribute-less draws, which rlgl doesn't wrap
+
+// --- HYBRID RAYMARCHING ---
+// Raymarched SDF objects (hybrid_march.fs, the scene of hybrid_raymarch.fs) composited
+// with rasterised geometry through depth, the march at a fraction of the resolution:
+//   1. BeginRaster()/EndRaster(): the raster scene into a colour and depth target;
+//   2. March(): one texel per Scale() x Scale() pixels, each stopping at the farthest raster
+//      depth under it, as nothing past that can show; it also keeps that depth as a guide;
+//   3. Present(): full resolution, the four nearest texels weighted by bilinear weight and by
+//      how well their guide matches the pixel's own raster depth, so marched colour stays on
+//      its side of raster silhouettes; writes the nearer depth, for what is drawn after.
+// Adapt() picks the scale from the march's GPU time: a step coarser when it is over
+// C_BUDGET_MS, a step finer when the finer scale's cost, predicted by pixel count, would
+// stay under C_HEADROOM of it (unless SetAdaptive(false) pins it at 1). The targets are sized for scale 1, and coarser scales use
+// their lower-left corner, so a change costs nothing.
+class HybridRaymarch {
+public:
+	static constexpr int   C_MAX_SCALE = 4;
+	static constexpr float C_BUDGET_MS = 3.0f;   // GPU time the march may take
+	static constexpr float C_HEADROOM = 0.7f;    // step finer while predicted under this share of it
+	static constexpr int   C_SETTLE_FRAMES = 10; // measurements ignored after a change
+
+	void Init(int w, int h) {
+		width = w;
+		height = h;
+		rasterFbo = rlLoadFramebuffer(width, height);
+		color = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8, 1);
+		depth = rlLoadTextureDepth(width, height, false);
+		rlFramebufferAttach(rasterFbo, color, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+		rlFramebufferAttach(rasterFbo, depth, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+		if (!rlFramebufferComplete(rasterFbo)) TraceLog(LOG_WARNING, "HYBRID: raster framebuffer is incomplete");
+
+		marchFbo = rlLoadFramebuffer(width, height);
+		marched = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16, 1);
+		guide = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R32, 1);
+		rlFramebufferAttach(marchFbo, marched, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+		rlFramebufferAttach(marchFbo, guide, RL_ATTACHMENT_COLOR_CHANNEL1, RL_ATTACHMENT_TEXTURE2D, 0);
+		rlEnableFramebuffer(marchFbo);
+		rlActiveDrawBuffers(2);
+		if (!rlFramebufferComplete(marchFbo)) TraceLog(LOG_WARNING, "HYBRID: march framebuffer is incomplete");
+		rlDisableFramebuffer();
+
+		march = ShaderCache::Load("../resources/shaders/glsl330/hiz_reduce.vs", "../resources/shaders/glsl330/hybrid_march.fs");
+		upsample = ShaderCache::Load("../resources/shaders/glsl330/hiz_reduce.vs", "../resources/shaders/glsl330/hybrid_upsample.fs");
+		for (Pass* p : { &marchLocs, &upsampleLocs }) {
+			const Shader& s = (p == &marchLocs) ? march : upsample;
+			p->scale = GetShaderLocation(s, "scale");
+			p->camPos = GetShaderLocation(s, "camPos");
+			p->camForward = GetShaderLocation(s, "camForward");
+			p->invViewProj = GetShaderLocation(s, "invViewProj");
+			p->clipPlanes = GetShaderLocation(s, "clipPlanes");
+		}
+		marchedSizeLoc = GetShaderLocation(upsample, "marchedSize");
+		BindSampler(march, "sceneDepth", C_DEPTH_UNIT);
+		BindSampler(upsample, "sceneDepth", C_DEPTH_UNIT);
+		BindSampler(upsample, "sceneColor", C_COLOR_UNIT);
+		BindSampler(upsample, "marched", C_MARCHED_UNIT);
+		BindSampler(upsample, "guide", C_GUIDE_UNIT);
+		glGenVertexArrays(1, &vao);
+		scale = 2;
+		settle = 0;
+	}
+
+	void Unload() {
+		rlUnloadFramebuffer(rasterFbo);  // takes the depth texture with it
+		rlUnloadFramebuffer(marchFbo);
+		for (unsigned int id : { color, marched, guide }) rlUnloadTexture(id);
+		glDeleteVertexArrays(1, &vao);
+		UnloadShader(march);
+		UnloadShader(upsample);
+		rasterFbo = marchFbo = color = depth = marched = guide = vao = 0;
+	}
+
+	// The raster scene goes in between, drawn as usual; the view is the camera's.
+	void BeginRaster(const Camera3D& camera, Color background) {
+		rlDrawRenderBatchActive();
+		rlEnableFramebuffer(rasterFbo);
+		rlViewport(0, 0, width, height);
+		ClearBackground(background);
+		BeginMode3D(camera);
+		// What March and Present need of the view, while BeginMode3D has it set.
+		const Matrix viewProj = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+		invViewProj = MatrixInvert(viewProj);
+		camPos = camera.position;
+		camForward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+	}
+
+	void EndRaster() {
+		EndMode3D();
+		rlDisableFramebuffer();
+		rlViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+	}
+
+	void March() {
+		rlDrawRenderBatchActive();
+		rlEnableFramebuffer(marchFbo);
+		glViewport(0, 0, MarchedWidth(), MarchedHeight());
+		BeginFullscreen(march, marchLocs);
+		Bind(C_DEPTH_UNIT, depth);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		EndFullscreen();
+		rlDisableFramebuffer();
+		rlViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+	}
+
+	// Into the current framebuffer, colour and depth, at the window's size.
+	void Present() {
+		rlDrawRenderBatchActive();
+		BeginFullscreen(upsample, upsampleLocs);
+		const int size[2] = { MarchedWidth(), MarchedHeight() };
+		glUniform2iv(marchedSizeLoc, 1, size);
+		Bind(C_DEPTH_UNIT, depth);
+		Bind(C_COLOR_UNIT, color);
+		Bind(C_MARCHED_UNIT, marched);
+		Bind(C_GUIDE_UNIT, guide);
+		rlEnableDepthTest();
+		glDepthFunc(GL_ALWAYS);  // every pixel is written, depth and all
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		glDepthFunc(GL_LEQUAL);
+		rlDisableDepthTest();
+		EndFullscreen();
+	}
+
+	// `ms`: the march's GPU time, as last measured; once a frame.
+	void Adapt(float ms) {
+		marchMs = ms;
+		if (!adaptive) return;
+		if (settle > 0) {
+			--settle;
+			return;
+		}
+		int next = scale;
+		if (ms > C_BUDGET_MS) next = scale + 1;
+		else if (scale > 1 && ms * static_cast<float>(scale * scale) / static_cast<float>((scale - 1) * (scale - 1)) < C_BUDGET_MS * C_HEADROOM) next = scale - 1;
+		next = std::clamp(next, 1, C_MAX_SCALE);
+		if (next != scale) {
+			scale = next;
+			settle = C_SETTLE_FRAMES;
+		}
+	}
+
+	// Full-resolution pixels per marched texel, each way.
+	int Scale() const {
+		return scale;
+	}
+
+	// Off pins the march at full resolution, for comparison.
+	void SetAdaptive(bool on) {
+		adaptive = on;
+		scale = adaptive ? 2 : 1;
+		settle = C_SETTLE_FRAMES;
+	}
+
+	bool Adaptive() const {
+		return adaptive;
+	}
+
+	float MarchMs() const {
+		return marchMs;
+	}
+
+	int MarchedWidth() const {
+		return (width + scale - 1) / scale;
+	}
+
+	int MarchedHeight() const {
+		return (height + scale - 1) / scale;
+	}
+
+private:
+	static constexpr int C_DEPTH_UNIT = 0;
+	static constexpr int C_COLOR_UNIT = 1;
+	static constexpr int C_MARCHED_UNIT = 2;
+	static constexpr int C_GUIDE_UNIT = 3;
+
+	struct Pass {
+		int scale = -1;
+		int camPos = -1;
+		int camForward = -1;
+		int invViewProj = -1;
+		int clipPlanes = -1;
+	};
+
+	static void BindSampler(const Shader& s, const char* name, int unit) {
+		SetShaderValue(s, GetShaderLocation(s, name), &unit, SHADER_UNIFORM_INT);
+	}
+
+	static void Bind(int unit, unsigned int texture) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D, texture);
+	}
+
+	void BeginFullscreen(const Shader& s, const Pass& p) {
+		glUseProgram(s.id);
+		glBindVertexArray(vao);
+		rlDisableColorBlend();
+		glUniform1i(p.scale, scale);
+		glUniform3f(p.camPos, camPos.x, camPos.y, camPos.z);
+		glUniform3f(p.camForward, camForward.x, camForward.y, camForward.z);
+		glUniformMatrix4fv(p.invViewProj, 1, GL_FALSE, MatrixToFloatV(invViewProj).v);
+		glUniform2f(p.clipPlanes, static_cast<float>(RL_CULL_DISTANCE_NEAR), static_cast<float>(RL_CULL_DISTANCE_FAR));  // BeginMode3D's
+	}
+
+	void EndFullscreen() {
+		for (int unit = C_GUIDE_UNIT; unit >= C_DEPTH_UNIT; --unit) Bind(unit, 0);  // ends on unit 0, as rlgl expects
+		glBindVertexArray(0);
+		glUseProgram(0);
+		rlEnableColorBlend();
+	}
+
+	int          width = 0;
+	int          height = 0;
+	unsigned int rasterFbo = 0;
+	unsigned int color = 0;
+	unsigned int depth = 0;
+	unsigned int marchFbo = 0;
+	unsigned int marched = 0;
+	unsigned int guide = 0;
+	unsigned int vao = 0;
+	Shader       march{};
+	Shader       upsample{};
+	Pass         marchLocs;
+	Pass         upsampleLocs;
+	int          marchedSizeLoc = -1;
+	Matrix       invViewProj = MatrixIdentity();
+	Vector3      camPos{};
+	Vector3      camForward{ 0.0f, 0.0f, -1.0f };
+	int          scale = 2;
+	int          settle = 0;
+	bool         adaptive = true;
+	float        marchMs = 0.0f;
+};
+
+#endif // HYBRID_RAYMARCH_H
@@ -0,0 +1,327 @@
+#ifndef IBL_CACHE_H
+#define IBL_CACHE_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // cubemap mip levels, which rlgl only loads one at a time
+#include "asset_cache.h"
+#include "image_jobs.h"
+#include "jobs.h"
+
+// --- IMAGE-BASED LIGHTING ---
+// The three precomputed inputs of split-sum IBL for pbr_ibl.fs, made once and cached as DDS
+// in the asset cache directory:
+//   - irradiance: the environment convolved with a cosine lobe, per normal;
+//   - prefiltered: the environment convolved with the GGX lobe, roughness 0 to 1 down the
+//     mip chain (level 0 is the environment itself, and doubles as the skybox);
+//   - BRDF LUT: the scale and bias to F0 of the specular integral, by N.V and roughness.
+// The environment is an analytic sky (Detail::Sky); there is no HDR panorama to start from,
+// and this raylib is built without HDR support anyway. Everything is generated on the CPU
+// with the job system, in a second or two; later runs load the DDS files and upload them.
+//
+// raylib's DDS loader takes 8-bit BGRA, one image, no mips, so each cube level is a
+// vertical strip of faces (+X -X +Y -Y +Z -Z) in RGBM, range C_RGBM_RANGE: colour divided
+// by a multiplier kept in alpha. The shader decodes it after filtering, which is close
+// enough at these sizes. The LUT is plain 8-bit.
+namespace IblCache {
+	constexpr int   C_IRRADIANCE_SIZE = 32;
+	constexpr int   C_PREFILTER_SIZE = 256;
+	constexpr int   C_PREFILTER_LEVELS = 5;   // MAX_PREFILTER_LOD + 1 in pbr_ibl.fs
+	constexpr int   C_BRDF_SIZE = 128;
+	constexpr float C_RGBM_RANGE = 8.0f;      // RGBM_RANGE in pbr_ibl.fs and skybox.fs
+
+	struct Maps {
+		TextureCubemap irradiance{};
+		TextureCubemap prefiltered{};
+		Texture2D      brdf{};
+		bool           cached = false;  // loaded from disk rather than generated
+	};
+
+	namespace Detail {
+		constexpr int C_VERSION = 1;  // bump when anything below changes what is generated
+		constexpr int C_IRRADIANCE_SAMPLES = 512;
+		constexpr int C_PREFILTER_SAMPLES = 192;
+		constexpr int C_BRDF_SAMPLES = 256;
+
+		// HDR radiance arriving from direction `d` (unit): a sky gradient, a hazy sun and
+		// darker ground under the horizon.
+		inline Vector3 Sky(Vector3 d) {
+			const Vector3 sun = Vector3Normalize({ 0.45f, 0.55f, -0.7f });
+			const Vector3 zenith = { 0.20f, 0.38f, 0.85f };
+			const Vector3 horizon = { 1.10f, 1.05f, 1.00f };
+			const Vector3 ground = { 0.22f, 0.20f, 0.18f };
+			Vector3 c;
+			if (d.y >= 0.0f) c = Vector3Lerp(horizon, zenith, sqrtf(d.y));
+			else c = Vector3Lerp(horizon, ground, powf(-d.y, 0.35f));
+			const float s = Vector3DotProduct(d, sun);
+			if (s > 0.0f) c = Vector3Add(c, Vector3Scale({ 1.0f, 0.9f, 0.75f }, powf(s, 48.0f) * 1.5f + powf(s, 1200.0f) * 6.0f));
+			return c;
+		}
+
+		// Unit direction through texel (x, y) of cube face `face` (GL face order and
+		// orientation; row 0 is the top of the face as uploaded).
+		inline Vector3 CubeDirection(int face, int x, int y, int size) {
+			const float s = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(size) - 1.0f;
+			const float t = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(size) - 1.0f;
+			Vector3 d{};
+			switch (face) {
+			case 0: d = { 1.0f, -t, -s }; break;
+			case 1: d = { -1.0f, -t, s }; break;
+			case 2: d = { s, 1.0f, t }; break;
+			case 3: d = { s, -1.0f, -t }; break;
+			case 4: d = { s, -t, 1.0f }; break;
+			default: d = { -s, -t, -1.0f }; break;
+			}
+			return Vector3Normalize(d);
+		}
+
+		inline Vector2 Hammersley(uint32_t i, uint32_t n) {
+			uint32_t bits = (i << 16u) | (i >> 16u);
+			bits = ((bits & 0x55555555u) << 1u) | ((bits & 0xAAAAAAAAu) >> 1u);
+			bits = ((bits & 0x33333333u) << 2u) | ((bits & 0xCCCCCCCCu) >> 2u);
+			bits = ((bits & 0x0F0F0F0Fu) << 4u) | ((bits & 0xF0F0F0F0u) >> 4u);
+			bits = ((bits & 0x00FF00FFu) << 8u) | ((bits & 0xFF00FF00u) >> 8u);
+			return { static_cast<float>(i) / static_cast<float>(n), static_cast<float>(bits) * 2.3283064365386963e-10f };
+		}
+
+		// `local` (z up) in the frame around `n`.
+		inline Vector3 ToWorld(Vector3 local, Vector3 n) {
+			const Vector3 up = (fabsf(n.z) < 0.999f) ? Vector3{ 0.0f, 0.0f, 1.0f } : Vector3{ 1.0f, 0.0f, 0.0f };
+			const Vector3 tx = Vector3Normalize(Vector3CrossProduct(up, n));
+			const Vector3 ty = Vector3CrossProduct(n, tx);
+			return Vector3Add(Vector3Add(Vector3Scale(tx, local.x), Vector3Scale(ty, local.y)), Vector3Scale(n, local.z));
+		}
+
+		// GGX half vector around z for roughness `r` (alpha = r * r).
+		inline Vector3 SampleGgx(Vector2 xi, float r) {
+			const float a = r * r;
+			const float phi = 2.0f * PI * xi.x;
+			const float cosTheta = sqrtf((1.0f - xi.y) / (1.0f + (a * a - 1.0f) * xi.y));
+			const float sinTheta = sqrtf(1.0f - cosTheta * cosTheta);
+			return { cosf(phi) * sinTheta, sinf(phi) * sinTheta, cosTheta };
+		}
+
+		inline void EncodeRgbm(Vector3 c, unsigned char* out) {
+			float m = fmaxf(fmaxf(c.x, c.y), fmaxf(c.z, 1e-6f)) / C_RGBM_RANGE;
+			m = ceilf(Clamp(m, 1.0f / 255.0f, 1.0f) * 255.0f) / 255.0f;
+			const float scale = 1.0f / (m * C_RGBM_RANGE);
+			out[0] = static_cast<unsigned char>(Clamp(c.x * scale, 0.0f, 1.0f) * 255.0f + 0.5f);
+			out[1] = static_cast<unsigned char>(Clamp(c.y * scale, 0.0f, 1.0f) * 255.0f + 0.5f);
+			out[2] = static_cast<unsigned char>(Clamp(c.z * scale, 0.0f, 1.0f) * 255.0f + 0.5f);
+			out[3] = static_cast<unsigned char>(m * 255.0f + 0.5f);
+		}
+
+		// A cube level as a vertical strip, texel (face, x, y) set to RGBM(shade(direction)).
+		template<typename Shade>
+		Image MakeCube(int size, Shade&& shade) {
+			Image strip = GenImageColor(size, size * 6, BLANK);
+			unsigned char* pixels = static_cast<unsigned char*>(strip.data);
+			JobSystem::Instance().ParallelFor(static_cast<size_t>(size) * 6, 4, [&](size_t begin, size_t end) {
+				for (size_t row = begin; row < end; ++row) {
+					const int face = static_cast<int>(row) / size;
+					const int y = static_cast<int>(row) % size;
+					for (int x = 0; x < size; ++x) EncodeRgbm(shade(CubeDirection(face, x, y, size)), pixels + (row * size + x) * 4);
+				}
+			});
+			return strip;
+		}
+
+		inline Vector3 Irradiance(Vector3 n) {
+			Vector3 sum{};
+			for (int i = 0; i < C_IRRADIANCE_SAMPLES; ++i) {
+				// Cosine-weighted: the integral of L cos / PI is the plain mean.
+				const Vector2 xi = Hammersley(static_cast<uint32_t>(i), C_IRRADIANCE_SAMPLES);
+				const float r = sqrtf(xi.y);
+				const float phi = 2.0f * PI * xi.x;
+				const Vector3 l = { r * cosf(phi), r * sinf(phi), sqrtf(1.0f - xi.y) };
+				sum = Vector3Add(sum, Sky(ToWorld(l, n)));
+			}
+			return Vector3Scale(sum, 1.0f / C_IRRADIANCE_SAMPLES);
+		}
+
+		// The usual split-sum prefilter, with N = V = R.
+		inline Vector3 Prefilter(Vector3 n, float roughness) {
+			Vector3 sum{};
+			float weight = 0.0f;
+			for (int i = 0; i < C_PREFILTER_SAMPLES; ++i) {
+				const Vector3 h = ToWorld(SampleGgx(Hammersley(static_cast<uint32_t>(i), C_PREFILTER_SAMPLES), roughness), n);
+				const Vector3 l = Vector3Subtract(Vector3Scale(h, 2.0f * Vector3DotProduct(n, h)), n);
+				const float nDotL = Vector3DotProduct(n, l);
+				if (nDotL <= 0.0f) continue;
+				sum = Vector3Add(sum, Vector3Scale(Sky(l), nDotL));
+				weight += nDotL;
+			}
+			return (weight > 0.0f) ? Vector3Scale(sum, 1.0f / weight) : Sky(n);
+		}
+
+		// Scale (r) and bias (g) to F0, for N.V along x and roughness along y.
+		inline Image MakeBrdf() {
+			Image lut = GenImageColor(C_BRDF_SIZE, C_BRDF_SIZE, BLACK);
+			unsigned char* pixels = static_cast<unsigned char*>(lut.data);
+			JobSystem::Instance().ParallelFor(C_BRDF_SIZE, 4, [&](size_t begin, size_t end) {
+				for (size_t y = begin; y < end; ++y) {
+					const float roughness = (static_cast<float>(y) + 0.5f) / C_BRDF_SIZE;
+					const float k = roughness * roughness / 2.0f;  // Smith, IBL remapping
+					for (int x = 0; x < C_BRDF_SIZE; ++x) {
+						const float nDotV = (static_cast<float>(x) + 0.5f) / C_BRDF_SIZE;
+						const Vector3 v = { sqrtf(1.0f - nDotV * nDotV), 0.0f, nDotV };
+						float a = 0.0f, b = 0.0f;
+						for (int i = 0; i < C_BRDF_SAMPLES; ++i) {
+							const Vector3 h = SampleGgx(Hammersley(static_cast<uint32_t>(i), C_BRDF_SAMPLES), roughness);
+							const float vDotH = Vector3DotProduct(v, h);
+							const Vector3 l = Vector3Subtract(Vector3Scale(h, 2.0f * vDotH), v);
+							const float nDotL = fmaxf(l.z, 0.0f);
+							if (nDotL <= 0.0f) continue;
+							const float nDotH = fmaxf(h.z, 0.0f);
+							const float g = (nDotV / (nDotV * (1.0f - k) + k)) * (nDotL / (nDotL * (1.0f - k) + k));
+							const float gVis = g * fmaxf(vDotH, 0.0f) / (nDotH * nDotV);
+							const float fc = powf(1.0f - fmaxf(vDotH, 0.0f), 5.0f);
+							a += (1.0f - fc) * gVis;
+							b += fc * gVis;
+						}
+						unsigned char* p = pixels + (y * C_BRDF_SIZE + x) * 4;
+						p[0] = static_cast<unsigned char>(Clamp(a / C_BRDF_SAMPLES, 0.0f, 1.0f) * 255.0f + 0.5f);
+						p[1] = static_cast<unsigned char>(Clamp(b / C_BRDF_SAMPLES, 0.0f, 1.0f) * 255.0f + 0.5f);
+					}
+				}
+			});
+			return lut;
+		}
+
+		inline std::string PathOf(const char* name) {
+			return std::string(AssetCache::Directory()) + "/ibl_v" + std::to_string(C_VERSION) + "_" + name + ".dds";
+		}
+
+		// An uncompressed A8R8G8B8 DDS of an R8G8B8A8 image, as raylib's loader reads it.
+		inline bool SaveDds(const Image& image, const std::string& path) {
+			uint32_t header[32] = {};
+			memcpy(header, "DDS ", 4);
+			header[1] = 124;                                         // header size
+			header[2] = 0x1 | 0x2 | 0x4 | 0x8 | 0x1000;              // caps, height, width, pitch, pixel format
+			header[3] = static_cast<uint32_t>(image.height);
+			header[4] = static_cast<uint32_t>(image.width);
+			header[5] = static_cast<uint32_t>(image.width) * 4;      // pitch
+			header[19] = 32;                                         // pixel format size
+			header[20] = 0x41;                                       // RGB with alpha
+			header[22] = 32;
+			header[23] = 0x00ff0000;
+			header[24] = 0x0000ff00;
+			header[25] = 0x000000ff;
+			header[26] = 0xff000000;
+			header[27] = 0x1000;                                     // texture
+
+			const size_t pixels = static_cast<size_t>(image.width) * static_cast<size_t>(image.height);
+			std::vector<unsigned char> bytes(sizeof(header) + pixels * 4);
+			memcpy(bytes.data(), header, sizeof(header));
+			const unsigned char* src = static_cast<const unsigned char*>(image.data);
+			unsigned char* dst = bytes.data() + sizeof(header);
+			for (size_t i = 0; i < pixels * 4; i += 4) {
+				dst[i] = src[i + 2];
+				dst[i + 1] = src[i + 1];
+				dst[i + 2] = src[i];
+				dst[i + 3] = src[i + 3];
+			}
+			std::error_code ec;
+			std::filesystem::create_directories(AssetCache::Directory(), ec);
+			return SaveFileData(path.c_str(), bytes.data(), static_cast<int>(bytes.size()));
+		}
+
+		// Cubemap from strips, one per mip level, each half the size of the last.
+		inline TextureCubemap UploadCube(const std::vector<Image>& levels) {
+			TextureCubemap cube{};
+			cube.width = levels[0].width;
+			cube.height = levels[0].width;
+			cube.mipmaps = static_cast<int>(levels.size());
+			cube.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+			glGenTextures(1, &cube.id);
+			glBindTexture(GL_TEXTURE_CUBE_MAP, cube.id);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			for (int level = 0; level < cube.mipmaps; ++level) {
+				const int size = levels[level].width;
+				const size_t faceBytes = static_cast<size_t>(size) * static_cast<size_t>(size) * 4;
+				for (int face = 0; face < 6; ++face) {
+					const unsigned char* data = static_cast<const unsigned char*>(levels[level].data) + faceBytes * face;
+					glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level, GL_RGBA8, size, size, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+				}
+			}
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, (cube.mipmaps > 1) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_LEVEL, cube.mipmaps - 1);
+			for (GLenum wrap : { GL_TEXTURE_WRAP_S, GL_TEXTURE_WRAP_T, GL_TEXTURE_WRAP_R }) glTexParameteri(GL_TEXTURE_CUBE_MAP, wrap, GL_CLAMP_TO_EDGE);
+			glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+			return cube;
+		}
+
+		// A cached image: irradiance, BRDF LUT, then the prefiltered levels.
+		struct Entry {
+			std::string name;
+			int         size;  // of a face, or of the LUT
+		};
+
+		inline std::vector<Entry> Entries() {
+			std::vector<Entry> entries = { { "irradiance", C_IRRADIANCE_SIZE }, { "brdf", C_BRDF_SIZE } };
+			for (int level = 0; level < C_PREFILTER_LEVELS; ++level) entries.push_back({ "prefiltered" + std::to_string(level), C_PREFILTER_SIZE >> level });
+			return entries;
+		}
+
+		inline Image Generate(size_t index, const Entry& entry) {
+			if (index == 0) return MakeCube(entry.size, Irradiance);
+			if (index == 1) return MakeBrdf();
+			const float roughness = static_cast<float>(index - 2) / (C_PREFILTER_LEVELS - 1);
+			if (roughness == 0.0f) return MakeCube(entry.size, Sky);
+			return MakeCube(entry.size, [roughness](Vector3 n) { return Prefilter(n, roughness); });
+		}
+
+		// What a cached image must look like to be used.
+		inline bool Fits(const Image& image, size_t index, const Entry& entry) {
+			const int height = (index == 1) ? entry.size : entry.size * 6;
+			return image.data != nullptr && image.width == entry.size && image.height == height && image.format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+		}
+	}
+
+	// The maps from the cache, generating (and caching) whichever are missing.
+	inline Maps Load() {
+		Maps maps;
+		const double start = GetTime();
+		const std::vector<Detail::Entry> entries = Detail::Entries();
+		// Every cached map decodes at once; only the misses are generated, in order.
+		std::vector<std::string> paths;
+		for (const Detail::Entry& entry : entries) paths.push_back(Detail::PathOf(entry.name.c_str()));
+		std::vector<Image> images = ImageJobs::LoadImages(paths);
+		maps.cached = true;
+		for (size_t i = 0; i < entries.size(); ++i) {
+			const std::string& path = paths[i];
+			if (Detail::Fits(images[i], i, entries[i])) continue;
+			if (images[i].data != nullptr) UnloadImage(images[i]);
+			images[i] = Detail::Generate(i, entries[i]);
+			Detail::SaveDds(images[i], path);
+			maps.cached = false;
+		}
+
+		maps.irradiance = Detail::UploadCube({ images[0] });
+		maps.prefiltered = Detail::UploadCube(std::vector<Image>(images.begin() + 2, images.end()));
+		maps.brdf = LoadTextureFromImage(images[1]);
+		SetTextureWrap(maps.brdf, TEXTURE_WRAP_CLAMP);
+		SetTextureFilter(maps.brdf, TEXTURE_FILTER_BILINEAR);
+		for (Image& image : images) UnloadImage(image);
+		TraceLog(LOG_INFO, "IBL: maps %s in %.1f ms", maps.cached ? "loaded from the cache" : "generated", (GetTime() - start) * 1000.0);
+		return maps;
+	}
+
+	inline void Unload(Maps& maps) {
+		rlUnloadTexture(maps.irradiance.id);
+		rlUnloadTexture(maps.prefiltered.id);
+		UnloadTexture(maps.brdf);
+		maps = Maps{};
+	}
+}
+
+#endif // IBL_CACHE_H
@@ -0,0 +1,125 @@
+#ifndef IMAGE_JOBS_H
+#define IMAGE_JOBS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "external/stb_image_resize2.h"  // split samplers, already compiled into rtextures
+#include "jobs.h"
+
+// --- PARALLEL IMAGE PROCESSING ---
+// raylib's CPU image operations spread over the job system's threads, for the import and
+// cook paths (AssetCache, IblCache) where decoding and mip generation are most of the time:
+//   - LoadImages() decodes a list of files concurrently, one file per job;
+//   - Resize() does what ImageResize does, the 8-bit 1 to 4 channel formats through
+//     stb_image_resize2's split samplers, each job producing a band of output rows;
+//   - Mipmaps() builds ImageMipmaps's chain, each level resized from the last by Resize().
+// Every result is byte for byte what the raylib call gives; only the time differs. Images
+// under C_MIN_PIXELS, and formats without a banded path, go to the raylib call as they are.
+// Called from inside another loop or from a loader thread while the pool is busy, the jobs
+// run serially on the caller (see JobSystem).
+namespace ImageJobs {
+	constexpr int C_MIN_PIXELS = 128 * 128;  // below this, threads cost more than they save
+
+	// LoadImage for each of `fileNames`, concurrently; a file that is missing or fails to
+	// decode gives an empty Image.
+	inline std::vector<Image> LoadImages(const std::vector<std::string>& fileNames) {
+		std::vector<Image> images(fileNames.size());
+		JobSystem::Instance().ParallelFor(fileNames.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				if (FileExists(fileNames[i].c_str())) images[i] = LoadImage(fileNames[i].c_str());
+			}
+		});
+		return images;
+	}
+
+	namespace Detail {
+		// stb_image_resize2's layout for a format ImageResize resizes directly, else 0.
+		inline int Channels(int format) {
+			switch (format) {
+			case PIXELFORMAT_UNCOMPRESSED_GRAYSCALE:  return 1;
+			case PIXELFORMAT_UNCOMPRESSED_GRAY_ALPHA: return 2;
+			case PIXELFORMAT_UNCOMPRESSED_R8G8B8:     return 3;
+			case PIXELFORMAT_UNCOMPRESSED_R8G8B8A8:   return 4;
+			default:                                  return 0;
+			}
+		}
+
+		// stbir_resize_uint8_linear's resize, run as split jobs. The splits cover disjoint
+		// output rows and share the samplers, so the pixels are those of the one-call resize.
+		inline void ResizeSplit(const unsigned char* input, int width, int height, unsigned char* output,
+			int newWidth, int newHeight, int channels)
+		{
+			STBIR_RESIZE resize;
+			stbir_resize_init(&resize, input, width, height, 0, output, newWidth, newHeight, 0,
+				static_cast<stbir_pixel_layout>(channels), STBIR_TYPE_UINT8);
+			const int splits = stbir_build_samplers_with_splits(&resize, static_cast<int>(JobSystem::Instance().ThreadCount()));
+			if (splits <= 0) {
+				stbir_resize_extended(&resize);
+				return;
+			}
+			JobSystem::Instance().ParallelFor(static_cast<size_t>(splits), 1, [&](size_t begin, size_t end) {
+				stbir_resize_extended_split(&resize, static_cast<int>(begin), static_cast<int>(end - begin));
+			});
+			stbir_free_samplers(&resize);
+		}
+	}
+
+	// ImageResize.
+	inline void Resize(Image* image, int newWidth, int newHeight) {
+		if (image->data == nullptr || image->width == 0 || image->height == 0) return;
+		const int channels = Detail::Channels(image->format);
+		if (channels == 0 || std::max(image->width * image->height, newWidth * newHeight) < C_MIN_PIXELS) {
+			ImageResize(image, newWidth, newHeight);
+			return;
+		}
+
+		unsigned char* output = static_cast<unsigned char*>(MemAlloc(static_cast<unsigned int>(newWidth * newHeight * channels)));
+		Detail::ResizeSplit(static_cast<const unsigned char*>(image->data), image->width, image->height, output, newWidth, newHeight, channels);
+		MemFree(image->data);
+		image->data = output;
+		image->width = newWidth;
+		image->height = newHeight;
+	}
+
+	// ImageMipmaps: the chain raylib builds, every level resized from the previous one.
+	inline void Mipmaps(Image* image) {
+		if (image->data == nullptr || image->width == 0 || image->height == 0) return;
+		int count = 1;
+		int size = GetPixelDataSize(image->width, image->height, image->format);
+		for (int w = image->width, h = image->height; w != 1 || h != 1;) {
+			w = std::max(w / 2, 1);
+			h = std::max(h / 2, 1);
+			size += GetPixelDataSize(w, h, image->format);
+			++count;
+		}
+		if (image->mipmaps >= count) return;
+
+		void* data = MemRealloc(image->data, static_cast<unsigned int>(size));
+		if (data == nullptr) {
+			TraceLog(LOG_WARNING, "IMAGE: Mipmaps required memory could not be allocated");
+			return;
+		}
+		image->data = data;
+		unsigned char* next = static_cast<unsigned char*>(image->data) + GetPixelDataSize(image->width, image->height, image->format);
+		Image level = ImageCopy(*image);
+		// Like ImageMipmaps, the first level is halved without clamping to 1.
+		int w = image->width / 2, h = image->height / 2;
+		for (int i = 1; i < count; ++i) {
+			const int levelSize = GetPixelDataSize(w, h, image->format);
+			Resize(&level, w, h);
+			memcpy(next, level.data, static_cast<size_t>(levelSize));
+			next += levelSize;
+			++image->mipmaps;
+			w = std::max(w / 2, 1);
+			h = std::max(h / 2, 1);
+		}
+		UnloadImage(level);
+	}
+}
+
+#endif // IMAGE_JOBS_H
@@ -0,0 +1,464 @@
+#ifndef INSTANCE_CULLING_H
+#define INSTANCE_CULLING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // transform feedback, queries and indirect draws, which rlgl doesn't wrap
+#include "instancing.h"
+#include "depth_pyramid.h"
+#include "shader_cache.h"
+
+// --- LOD MESHES ---
+// A coarser copy of `mesh` by vertex clustering: the bounds are cut into `cells` cells along
+// their longest side, every vertex moves to the average of its cell, and triangles left
+// with two corners in one cell are dropped. Texture coordinates and normals are kept per
+// corner. Needs the mesh's CPU-side data, which LoadModel keeps. Free with UnloadMesh.
+inline Mesh GenMeshSimplified(const Mesh& mesh, int cells) {
+	const BoundingBox bounds = GetMeshBoundingBox(mesh);
+	const Vector3 extent = Vector3Subtract(bounds.max, bounds.min);
+	const float cell = std::max({ extent.x, extent.y, extent.z, 1e-6f }) / static_cast<float>(cells);
+	const int corners = (mesh.indices != nullptr) ? mesh.triangleCount * 3 : mesh.vertexCount;
+	auto vertexOf = [&](int corner) { return (mesh.indices != nullptr) ? static_cast<int>(mesh.indices[corner]) : corner; };
+	auto keyOf = [&](int v) {
+		const int64_t x = static_cast<int64_t>((mesh.vertices[v * 3 + 0] - bounds.min.x) / cell);
+		const int64_t y = static_cast<int64_t>((mesh.vertices[v * 3 + 1] - bounds.min.y) / cell);
+		const int64_t z = static_cast<int64_t>((mesh.vertices[v * 3 + 2] - bounds.min.z) / cell);
+		return x + (y << 20) + (z << 40);
+	};
+
+	struct Cell { Vector3 sum; int count; };
+	std::unordered_map<int64_t, Cell> clusters;
+	for (int v = 0; v < mesh.vertexCount; ++v) {
+		Cell& c = clusters[keyOf(v)];
+		c.sum = Vector3Add(c.sum, Vector3{ mesh.vertices[v * 3 + 0], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2] });
+		++c.count;
+	}
+
+	std::vector<int> kept;  // source corners of the surviving triangles
+	for (int t = 0; t + 2 < corners; t += 3) {
+		const int64_t a = keyOf(vertexOf(t)), b = keyOf(vertexOf(t + 1)), c = keyOf(vertexOf(t + 2));
+		if (a == b || b == c || a == c) continue;
+		kept.insert(kept.end(), { t, t + 1, t + 2 });
+	}
+
+	Mesh out{};
+	out.vertexCount = static_cast<int>(kept.size());
+	out.triangleCount = out.vertexCount / 3;
+	out.vertices = static_cast<float*>(MemAlloc(static_cast<unsigned int>(out.vertexCount * 3 * sizeof(float))));
+	if (mesh.texcoords) out.texcoords = static_cast<float*>(MemAlloc(static_cast<unsigned int>(out.vertexCount * 2 * sizeof(float))));
+	if (mesh.normals) out.normals = static_cast<float*>(MemAlloc(static_cast<unsigned int>(out.vertexCount * 3 * sizeof(float))));
+	for (int i = 0; i < out.vertexCount; ++i) {
+		const int v = vertexOf(kept[i]);
+		const Cell& c = clusters[keyOf(v)];
+		const Vector3 p = Vector3Scale(c.sum, 1.0f / static_cast<float>(c.count));
+		out.vertices[i * 3 + 0] = p.x;
+		out.vertices[i * 3 + 1] = p.y;
+		out.vertices[i * 3 + 2] = p.z;
+		if (out.texcoords) std::copy_n(&mesh.texcoords[v * 2], 2, &out.texcoords[i * 2]);
+		if (out.normals) std::copy_n(&mesh.normals[v * 3], 3, &out.normals[i * 3]);
+	}
+	UploadMesh(&out, false);
+	return out;
+}
+
+// --- INSTANCE CULLING ---
+// Frustum culling and LOD selection for InstanceRing props, on the GPU. GL 3.3 has no
+// compute shaders, so it is a transform feedback pass: each instance goes in as a point,
+// instance_cull.vs tests its bounding sphere against the frustum and its distance against
+// one LOD's range, and instance_cull.gs emits the transform only if it passed. The kept
+// transforms land packed in that kind and LOD's region of an output buffer, a query counts
+// them, and each LOD mesh is drawn from its region with that count. One pass per kind and
+// LOD, one draw per LOD mesh; the CPU only sends the planes.
+//
+// With ARB_draw_indirect and ARB_query_buffer_object the counts are copied on the GPU into
+// an indirect draw buffer and nothing comes back. Without them the counts are read back,
+// which waits for the cull passes to finish.
+//
+// LOD 0 is the model's own meshes; the others are GenMeshSimplified copies.
+//
+// With occlusion on (InitOcclusion, SetOcclusion), every Cull first redraws what the last one
+// kept, depth-only and at the current view, into a DepthPyramid; instances whose bounding
+// cube is behind it are then dropped with the rest, before any of their vertices are drawn.
+// The last frame's survivors are nearly this frame's, so little is missed, and hiding too
+// little only costs a draw. Props must not move: an occluder drawn where it was a frame
+// ago could hide what is now in view. Until there is a last frame nothing is hidden.
+class InstanceCuller {
+public:
+	static constexpr int   C_LODS = 3;
+	static constexpr int   C_LOD_CELLS[C_LODS] = { 0, 24, 8 };            // 0: the source meshes
+	static constexpr float C_LOD_START[C_LODS] = { 0.0f, 25.0f, 60.0f };  // distance each LOD takes over
+
+	// `capacity` is the ring's size. The models must outlive the culler.
+	void Init(Model* const* models, int kinds, int capacity) {
+		this->capacity = capacity;
+		indirect = GLAD_GL_ARB_draw_indirect && GLAD_GL_ARB_query_buffer_object;
+
+		props.resize(kinds);
+		for (int k = 0; k < kinds; ++k) {
+			Prop& prop = props[k];
+			prop.model = models[k];
+			const BoundingBox b = GetModelBoundingBox(*prop.model);
+			prop.sphere = Vector4{ (b.min.x + b.max.x) * 0.5f, (b.min.y + b.max.y) * 0.5f, (b.min.z + b.max.z) * 0.5f,
+				Vector3Distance(b.min, b.max) * 0.5f };
+			for (int l = 0; l < C_LODS; ++l) {
+				for (int m = 0; m < prop.model->meshCount; ++m) {
+					const Mesh& source = prop.model->meshes[m];
+					prop.lods[l].meshes.push_back((l == 0) ? source : GenMeshSimplified(source, C_LOD_CELLS[l]));
+					prop.lods[l].materials.push_back(prop.model->meshMaterial[m]);
+					prop.lods[l].commands.push_back(commandCount++);
+				}
+			}
+		}
+
+		program = LoadProgram();
+		planesLoc = glGetUniformLocation(program, "frustumPlanes");
+		sphereLoc = glGetUniformLocation(program, "boundingSphere");
+		viewLoc = glGetUniformLocation(program, "viewPos");
+		rangeLoc = glGetUniformLocation(program, "lodRange");
+
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(1, &output);
+		glBindBuffer(GL_ARRAY_BUFFER, output);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(C_LODS) * capacity * InstanceDraw::C_MATRIX_BYTES, nullptr, GL_DYNAMIC_COPY);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		queries.resize(kinds * C_LODS);
+		glGenQueries(static_cast<GLsizei>(queries.size()), queries.data());
+		visible.assign(queries.size(), 0);
+
+		if (indirect) {
+			// Vertex counts are fixed; the instance counts are written every frame.
+			std::vector<Command> commands(commandCount);
+			for (const Prop& prop : props) {
+				for (const Lod& lod : prop.lods) {
+					for (size_t m = 0; m < lod.meshes.size(); ++m) {
+						const Mesh& mesh = lod.meshes[m];
+						commands[lod.commands[m]].count = static_cast<GLuint>((mesh.indices != nullptr) ? mesh.triangleCount * 3 : mesh.vertexCount);
+					}
+				}
+			}
+			glGenBuffers(1, &commandBuffer);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(commands.size() * sizeof(Command)), commands.data(), GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		}
+		TraceLog(LOG_INFO, "CULLING: %i prop kind(s) x %i LOD(s), counts %s", kinds, C_LODS, indirect ? "stay on the GPU (indirect draws)" : "read back");
+	}
+
+	void Unload() {
+		for (Prop& prop : props) {
+			for (int l = 1; l < C_LODS; ++l) {
+				for (Mesh& mesh : prop.lods[l].meshes) UnloadMesh(mesh);
+			}
+		}
+		props.clear();
+		glDeleteQueries(static_cast<GLsizei>(queries.size()), queries.data());
+		queries.clear();
+		glDeleteBuffers(1, &output);
+		if (commandBuffer) glDeleteBuffers(1, &commandBuffer);
+		glDeleteVertexArrays(1, &vao);
+		glDeleteProgram(program);
+		output = commandBuffer = vao = program = 0;
+		commandCount = 0;
+		if (depthShader.id != 0) {
+			pyramid.Unload();
+			UnloadShader(depthShader);
+			depthShader = Shader{};
+		}
+		occlusion = culled = false;
+	}
+
+	// Allocates the depth pyramid for a `w` x `h` view; after Init. Occlusion starts off.
+	void InitOcclusion(int w, int h) {
+		pyramid.Init(w, h);
+		depthShader = ShaderCache::Load("../resources/shaders/glsl330/lighting_instancing.vs", "../resources/shaders/glsl330/depth_prepass.fs");
+		depthShader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(depthShader, "instanceTransform");
+		occlusionLoc = glGetUniformLocation(program, "occlusion");
+		viewProjectionLoc = glGetUniformLocation(program, "viewProjection");
+		pyramidSizeLoc = glGetUniformLocation(program, "pyramidSize");
+		pyramidLevelsLoc = glGetUniformLocation(program, "pyramidLevels");
+		glUseProgram(program);
+		glUniform1i(glGetUniformLocation(program, "depthPyramid"), C_PYRAMID_SLOT);
+		glUseProgram(0);
+	}
+
+	// Only once InitOcclusion has run.
+	void SetOcclusion(bool on) {
+		occlusion = on && (depthShader.id != 0);
+	}
+
+	bool Occlusion() const {
+		return occlusion;
+	}
+
+	// Culls this frame's ring, where kind k holds count[k] transforms from first[k], against
+	// the current view and projection: call between BeginMode3D and EndMode3D.
+	void Cull(InstanceRing& ring, const int* first, const int* count) {
+		rlDrawRenderBatchActive();
+		ring.Seal();
+		const Matrix view = rlGetMatrixModelview();
+		const Matrix eye = MatrixInvert(view);
+		const Vector3 viewPos = { eye.m12, eye.m13, eye.m14 };
+		const Matrix viewProjection = MatrixMultiply(view, rlGetMatrixProjection());
+		float planes[6 * 4];
+		FrustumPlanes(viewProjection, planes);
+
+		// Last frame's survivors, still in the output buffer with their counts, are the occluders.
+		const bool occluders = occlusion && culled;
+		if (occluders) {
+			pyramid.BeginOccluders();
+			Draw(depthShader);
+			pyramid.EndOccluders();
+		}
+
+		glUseProgram(program);
+		glUniform4fv(planesLoc, 6, planes);
+		glUniform3f(viewLoc, viewPos.x, viewPos.y, viewPos.z);
+		glUniform1i(occlusionLoc, occluders ? 1 : 0);
+		if (occluders) {
+			glUniformMatrix4fv(viewProjectionLoc, 1, GL_FALSE, MatrixToFloatV(viewProjection).v);
+			glUniform2f(pyramidSizeLoc, static_cast<float>(pyramid.Width()), static_cast<float>(pyramid.Height()));
+			glUniform1i(pyramidLevelsLoc, pyramid.Levels());
+			glActiveTexture(GL_TEXTURE0 + C_PYRAMID_SLOT);
+			glBindTexture(GL_TEXTURE_2D, pyramid.Texture());
+			glActiveTexture(GL_TEXTURE0);
+		}
+		glBindVertexArray(vao);
+		glBindBuffer(GL_ARRAY_BUFFER, ring.Buffer());
+		glEnable(GL_RASTERIZER_DISCARD);
+		passes = 0;
+		for (size_t k = 0; k < props.size(); ++k) {
+			Prop& prop = props[k];
+			prop.first = first[k];
+			prop.count = count[k];
+			if (prop.count <= 0) continue;
+
+			glUniform4f(sphereLoc, prop.sphere.x, prop.sphere.y, prop.sphere.z, prop.sphere.w);
+			for (GLuint column = 0; column < 4; ++column) {
+				glEnableVertexAttribArray(column);
+				glVertexAttribPointer(column, 4, GL_FLOAT, GL_FALSE, InstanceDraw::C_MATRIX_BYTES, reinterpret_cast<const void*>(ring.Offset(prop.first) + column * sizeof(Vector4)));
+			}
+			for (int l = 0; l < C_LODS; ++l) {
+				glUniform2f(rangeLoc, C_LOD_START[l], (l + 1 < C_LODS) ? C_LOD_START[l + 1] : INFINITY);
+				glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, output, static_cast<GLintptr>(OutputOffset(prop, l)),
+					static_cast<GLsizeiptr>(prop.count) * InstanceDraw::C_MATRIX_BYTES);
+				glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, queries[k * C_LODS + l]);
+				glBeginTransformFeedback(GL_POINTS);
+				glDrawArrays(GL_POINTS, 0, prop.count);
+				glEndTransformFeedback();
+				glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+				++passes;
+			}
+		}
+		glDisable(GL_RASTERIZER_DISCARD);
+		if (occluders) {
+			glActiveTexture(GL_TEXTURE0 + C_PYRAMID_SLOT);
+			glBindTexture(GL_TEXTURE_2D, 0);
+			glActiveTexture(GL_TEXTURE0);
+		}
+		glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+		glUseProgram(0);
+
+		if (indirect) {
+			glBindBuffer(GL_QUERY_BUFFER, commandBuffer);
+			for (size_t k = 0; k < props.size(); ++k) {
+				if (props[k].count <= 0) continue;
+				for (int l = 0; l < C_LODS; ++l) {
+					for (int command : props[k].lods[l].commands) {
+						const size_t at = command * sizeof(Command) + offsetof(Command, instanceCount);
+						glGetQueryObjectuiv(queries[k * C_LODS + l], GL_QUERY_RESULT, reinterpret_cast<GLuint*>(at));
+					}
+				}
+			}
+			glBindBuffer(GL_QUERY_BUFFER, 0);
+		}
+		else {
+			for (size_t i = 0; i < queries.size(); ++i) {
+				visible[i] = 0;
+				if (props[i / C_LODS].count > 0) glGetQueryObjectuiv(queries[i], GL_QUERY_RESULT, &visible[i]);
+			}
+		}
+		culled = true;
+	}
+
+	// Draws what the last Cull kept, every LOD mesh with `shader` (see InstanceDraw::Submit)
+	// in place of its material's.
+	void Draw(const Shader& shader) {
+		draws = 0;
+		if (indirect) glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+		for (size_t k = 0; k < props.size(); ++k) {
+			const Prop& prop = props[k];
+			if (prop.count <= 0) continue;
+			for (int l = 0; l < C_LODS; ++l) {
+				const Lod& lod = prop.lods[l];
+				const GLuint kept = visible[k * C_LODS + l];
+				if (!indirect && kept == 0) continue;
+				for (size_t m = 0; m < lod.meshes.size(); ++m) {
+					const Mesh& mesh = lod.meshes[m];
+					Material material = prop.model->materials[lod.materials[m]];
+					material.shader = shader;
+					InstanceDraw::Submit(mesh, material, output, OutputOffset(prop, l), [&]() {
+						const bool indexed = (mesh.indices != nullptr);
+						if (indirect) {
+							const void* command = reinterpret_cast<const void*>(lod.commands[m] * sizeof(Command));
+							if (indexed) glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT, command);
+							else glDrawArraysIndirect(GL_TRIANGLES, command);
+						}
+						else {
+							if (indexed) rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount * 3, nullptr, static_cast<int>(kept));
+							else rlDrawVertexArrayInstanced(0, mesh.vertexCount, static_cast<int>(kept));
+						}
+					});
+					++draws;
+				}
+			}
+		}
+		if (indirect) glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+
+	// True when the counts never leave the GPU.
+	bool Indirect() const {
+		return indirect;
+	}
+
+	// Transform feedback passes in the last Cull, and draws in the last Draw.
+	int Passes() const {
+		return passes;
+	}
+
+	int Draws() const {
+		return draws;
+	}
+
+	// Instances of `lod` kept by the last Cull; only known when the counts are read back.
+	int Visible(int lod) const {
+		int total = 0;
+		for (size_t i = lod; i < visible.size(); i += C_LODS) total += static_cast<int>(visible[i]);
+		return total;
+	}
+
+	// Inward-facing, normalised planes of the clip volume of `m` (raylib's row-vector order):
+	// left, right, bottom, top, near, far.
+	static void FrustumPlanes(const Matrix& m, float* planes) {
+		const float rows[4][4] = {
+			{ m.m0, m.m4, m.m8, m.m12 },
+			{ m.m1, m.m5, m.m9, m.m13 },
+			{ m.m2, m.m6, m.m10, m.m14 },
+			{ m.m3, m.m7, m.m11, m.m15 },
+		};
+		for (int p = 0; p < 6; ++p) {
+			const float sign = (p % 2 == 0) ? 1.0f : -1.0f;
+			float* plane = &planes[p * 4];
+			for (int i = 0; i < 4; ++i) plane[i] = rows[3][i] + sign * rows[p / 2][i];
+			const float length = sqrtf(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+			for (int i = 0; i < 4; ++i) plane[i] /= length;
+		}
+	}
+
+private:
+	static constexpr int C_PYRAMID_SLOT = 0;  // the cull program samples nothing else
+
+	// DrawElementsIndirectCommand; DrawArraysIndirectCommand reads the first four fields,
+	// and on GL 3.3 the last of those (baseInstance) must stay 0.
+	struct Command {
+		GLuint count = 0;
+		GLuint instanceCount = 0;
+		GLuint first = 0;
+		GLuint baseVertex = 0;
+		GLuint baseInstance = 0;
+	};
+
+	struct Lod {
+		std::vector<Mesh> meshes;
+		std::vector<int>  materials;
+		std::vector<int>  commands;  // per mesh, into the command buffer
+	};
+
+	struct Prop {
+		Model*  model = nullptr;
+		Vector4 sphere{};  // mesh space: centre, radius
+		Lod     lods[C_LODS];
+		int     first = 0;
+		int     count = 0;
+	};
+
+	// Kind k's region for LOD l: as many transforms as the kind has in the ring.
+	size_t OutputOffset(const Prop& prop, int lod) const {
+		return (static_cast<size_t>(lod) * capacity + static_cast<size_t>(prop.first)) * InstanceDraw::C_MATRIX_BYTES;
+	}
+
+	static unsigned int LoadProgram() {
+		const char* files[2] = { "../resources/shaders/glsl330/instance_cull.vs", "../resources/shaders/glsl330/instance_cull.gs" };
+		const GLenum types[2] = { GL_VERTEX_SHADER, GL_GEOMETRY_SHADER };
+		unsigned int shaders[2] = {};
+		unsigned int id = glCreateProgram();
+		for (int i = 0; i < 2; ++i) {
+			char* code = LoadFileText(files[i]);
+			const char* text = code ? code : "";
+			shaders[i] = glCreateShader(types[i]);
+			glShaderSource(shaders[i], 1, &text, nullptr);
+			glCompileShader(shaders[i]);
+			UnloadFileText(code);
+			GLint compiled = GL_FALSE;
+			glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &compiled);
+			if (compiled != GL_TRUE) {
+				char log[1024];
+				glGetShaderInfoLog(shaders[i], sizeof(log), nullptr, log);
+				TraceLog(LOG_WARNING, "CULLING: %s: %s", files[i], log);
+			}
+			glAttachShader(id, shaders[i]);
+		}
+		glBindAttribLocation(id, 0, "instanceTransform");  // a mat4: locations 0-3
+		const char* captured[4] = { "column0", "column1", "column2", "column3" };
+		glTransformFeedbackVaryings(id, 4, captured, GL_INTERLEAVED_ATTRIBS);
+		glLinkProgram(id);
+		for (unsigned int s : shaders) {
+			glDetachShader(id, s);
+			glDeleteShader(s);
+		}
+		GLint linked = GL_FALSE;
+		glGetProgramiv(id, GL_LINK_STATUS, &linked);
+		if (linked != GL_TRUE) {
+			char log[1024];
+			glGetProgramInfoLog(id, sizeof(log), nullptr, log);
+			TraceLog(LOG_WARNING, "CULLING: cull program failed to link: %s", log);
+		}
+		return id;
+	}
+
+	std::vector<Prop>   props;
+	int                 capacity = 0;
+	int                 commandCount = 0;
+	bool                indirect = false;
+	unsigned int        program = 0;
+	unsigned int        vao = 0;
+	unsigned int        output = 0;
+	unsigned int        commandBuffer = 0;
+	std::vector<GLuint> queries;
+	std::vector<GLuint> visible;  // per kind and LOD, read back only
+	int                 planesLoc = -1;
+	int                 sphereLoc = -1;
+	int                 viewLoc = -1;
+	int                 rangeLoc = -1;
+	DepthPyramid        pyramid;
+	Shader              depthShader{};  // lighting_instancing.vs without its lighting
+	bool                occlusion = false;
+	bool                culled = false;  // the output buffer holds a Cull's survivors
+	int                 occlusionLoc = -1;
+	int                 viewProjectionLoc = -1;
+	int                 pyramidSizeLoc = -1;
+	int                 pyramidLevelsLoc = -1;
+	int                 passes = 0;
+	int                 draws = 0;
+};
+
+#endif // INSTANCE_CULLING_H
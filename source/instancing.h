@@ -0,0 +1,227 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // buffer storage, mapping and fences, which rlgl doesn't wrap
+
+// --- INSTANCED DRAWS ---
+// What raylib's DrawMeshInstanced does around its draw call (no stereo), minus the buffer it
+// creates and deletes every time: the instance transforms are read from `buffer` at
+// `offset`, one column-major mat4 per instance. The shader needs
+// locs[SHADER_LOC_MATRIX_MODEL] set to its mat4 instance attribute; `issue` makes the draw
+// call with the mesh's vertex array bound.
+namespace InstanceDraw {
+	constexpr int C_MATRIX_BYTES = static_cast<int>(16 * sizeof(float));
+	constexpr int C_MATERIAL_MAPS = 12;  // raylib's MAX_MATERIAL_MAPS, which config.h keeps private
+
+	template<typename Issue>
+	void Submit(const Mesh& mesh, const Material& material, unsigned int buffer, size_t offset, Issue&& issue) {
+		const int* locs = material.shader.locs;
+		if (locs[SHADER_LOC_MATRIX_MODEL] < 0) return;
+
+		rlEnableShader(material.shader.id);
+		if (locs[SHADER_LOC_COLOR_DIFFUSE] != -1) {
+			const Vector4 diffuse = ColorNormalize(material.maps[MATERIAL_MAP_DIFFUSE].color);
+			rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], &diffuse, SHADER_UNIFORM_VEC4, 1);
+		}
+		const Matrix view = rlGetMatrixModelview();
+		const Matrix projection = rlGetMatrixProjection();
+		if (locs[SHADER_LOC_MATRIX_VIEW] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_VIEW], view);
+		if (locs[SHADER_LOC_MATRIX_PROJECTION] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_PROJECTION], projection);
+		if (locs[SHADER_LOC_MATRIX_NORMAL] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_NORMAL], MatrixIdentity());
+		rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), view), projection));
+
+		for (int i = 0; i < C_MATERIAL_MAPS; i++) {
+			if (material.maps[i].texture.id == 0) continue;
+			rlActiveTextureSlot(i);
+			if (i == MATERIAL_MAP_IRRADIANCE || i == MATERIAL_MAP_PREFILTER || i == MATERIAL_MAP_CUBEMAP) rlEnableTextureCubemap(material.maps[i].texture.id);
+			else rlEnableTexture(material.maps[i].texture.id);
+			rlSetUniform(locs[SHADER_LOC_MAP_DIFFUSE + i], &i, SHADER_UNIFORM_INT, 1);
+		}
+
+		// Point the mesh's instance attribute at the transforms.
+		rlEnableVertexArray(mesh.vaoId);
+		rlEnableVertexBuffer(buffer);
+		for (unsigned int column = 0; column < 4; column++) {
+			const unsigned int attribute = static_cast<unsigned int>(locs[SHADER_LOC_MATRIX_MODEL]) + column;
+			rlEnableVertexAttribute(attribute);
+			rlSetVertexAttribute(attribute, 4, RL_FLOAT, false, C_MATRIX_BYTES, reinterpret_cast<const void*>(offset + column * sizeof(Vector4)));
+			rlSetVertexAttributeDivisor(attribute, 1);
+		}
+		rlDisableVertexBuffer();
+		if (mesh.vboId[3] == 0 && locs[SHADER_LOC_VERTEX_COLOR] != -1) rlDisableVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR]);
+
+		issue();
+
+		for (int i = 0; i < C_MATERIAL_MAPS; i++) {
+			if (material.maps[i].texture.id == 0) continue;
+			rlActiveTextureSlot(i);
+			if (i == MATERIAL_MAP_IRRADIANCE || i == MATERIAL_MAP_PREFILTER || i == MATERIAL_MAP_CUBEMAP) rlDisableTextureCubemap();
+			else rlDisableTexture();
+		}
+		rlDisableVertexArray();
+		rlDisableShader();
+	}
+}
+
+// --- INSTANCE RING ---
+// Per-instance transforms for DrawInstanced, written straight into GPU-visible memory.
+// The buffer holds C_FRAMES regions of Capacity() matrices; each frame writes the next
+// region while the GPU may still be reading the last ones, and a fence per region makes
+// Begin() wait only if the GPU is a whole ring behind. With ARB_buffer_storage the buffer
+// stays mapped (persistent, coherent) for its whole life; without it each region is
+// mapped unsynchronised for the frame, with the same fences guarding it.
+//
+// Per frame: Begin(), Set() each transform, DrawInstanced() each mesh (or Seal() and read
+// Buffer() some other way), End().
+class InstanceRing {
+public:
+	static constexpr int C_FRAMES = 3;
+
+	void Init(int instances) {
+		capacity = instances;
+		regionBytes = static_cast<GLsizeiptr>(capacity) * C_MATRIX_BYTES;
+		persistent = GLAD_GL_ARB_buffer_storage && glBufferStorage != nullptr;
+
+		glGenBuffers(1, &vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		if (persistent) {
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_ARRAY_BUFFER, regionBytes * C_FRAMES, nullptr, flags);
+			mapped = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, regionBytes * C_FRAMES, flags));
+		}
+		else {
+			glBufferData(GL_ARRAY_BUFFER, regionBytes * C_FRAMES, nullptr, GL_DYNAMIC_DRAW);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		TraceLog(LOG_INFO, "INSTANCES: [ID %u] %i x %i transforms, %s", vbo, C_FRAMES, capacity, persistent ? "persistently mapped" : "mapped per frame");
+	}
+
+	void Unload() {
+		for (GLsync& f : fences) {
+			if (f) glDeleteSync(f);
+			f = nullptr;
+		}
+		if (persistent && mapped) {
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &vbo);
+		vbo = 0;
+		mapped = nullptr;
+	}
+
+	int Capacity() const {
+		return capacity;
+	}
+
+	// Moves to the next region, waiting for the GPU to finish with it if it must.
+	void Begin() {
+		region = (region + 1) % C_FRAMES;
+		if (GLsync& f = fences[region]) {
+			if (glClientWaitSync(f, 0, 0) == GL_TIMEOUT_EXPIRED) {
+				++stalls;
+				glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, C_WAIT_NANOSECONDS);
+			}
+			glDeleteSync(f);
+			f = nullptr;
+		}
+		if (!persistent) {
+			glBindBuffer(GL_ARRAY_BUFFER, vbo);
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+			frame = static_cast<uint8_t*>(glMapBufferRange(GL_ARRAY_BUFFER, RegionOffset(), regionBytes, flags));
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+		}
+		else {
+			frame = mapped + RegionOffset();
+		}
+	}
+
+	// Transform `index` of this frame, as the column-major mat4 the shader reads.
+	void Set(int index, const Matrix& transform) {
+		const float16 columns = MatrixToFloatV(transform);
+		memcpy(frame + static_cast<size_t>(index) * C_MATRIX_BYTES, columns.v, C_MATRIX_BYTES);
+	}
+
+	// Draws instances [first, first + count) of this frame with one instanced call.
+	void DrawInstanced(const Mesh& mesh, const Material& material, int first, int count) {
+		if (count <= 0) return;
+		Seal();
+		InstanceDraw::Submit(mesh, material, vbo, Offset(first), [&]() {
+			if (mesh.indices != nullptr) rlDrawVertexArrayElementsInstanced(0, mesh.triangleCount * 3, nullptr, count);
+			else rlDrawVertexArrayInstanced(0, mesh.vertexCount, count);
+		});
+		++draws;
+	}
+
+	// Finishes this frame's writes; anything reading the ring on the GPU must come after.
+	// DrawInstanced seals on its own.
+	void Seal() {
+		if (persistent || unmapped) return;
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		unmapped = true;
+	}
+
+	unsigned int Buffer() const {
+		return vbo;
+	}
+
+	// Byte offset of this frame's transform `index` in Buffer().
+	size_t Offset(int index) const {
+		return static_cast<size_t>(RegionOffset()) + static_cast<size_t>(index) * C_MATRIX_BYTES;
+	}
+
+	// Fences this frame's region behind the draws that read it.
+	void End() {
+		Seal();
+		unmapped = false;
+		fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		lastDraws = draws;
+		draws = 0;
+	}
+
+	bool Persistent() const {
+		return persistent;
+	}
+
+	// Instanced draws issued in the last frame.
+	int Draws() const {
+		return lastDraws;
+	}
+
+	// Frames in which Begin() had to wait for the GPU.
+	int Stalls() const {
+		return stalls;
+	}
+
+private:
+	static constexpr int      C_MATRIX_BYTES = InstanceDraw::C_MATRIX_BYTES;
+	static constexpr GLuint64 C_WAIT_NANOSECONDS = 1000000000;
+
+	GLintptr RegionOffset() const {
+		return static_cast<GLintptr>(region) * regionBytes;
+	}
+
+	unsigned int vbo = 0;
+	int          capacity = 0;
+	GLsizeiptr   regionBytes = 0;
+	bool         persistent = false;
+	bool         unmapped = false;
+	uint8_t*     mapped = nullptr;  // whole ring, persistent only
+	uint8_t*     frame = nullptr;   // this frame's region
+	int          region = 0;
+	GLsync       fences[C_FRAMES] = {};
+	int          draws = 0;
+	int          lastDraws = 0;
+	int          stalls = 0;
+};
+
+#endif // INSTANCING_H
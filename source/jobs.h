@@ -0,0 +1,348 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class JobCounter;
+
+// One unit of work for the pool, and the counter it finishes.
+struct JobTask {
+	std::function<void()> fn;
+	JobCounter*           counter = nullptr;
+};
+
+// Counts jobs started with Run() that haven't finished yet. JobSystem::Wait() blocks until
+// none are left; a job Run() after a counter starts only once that counter has drained,
+// which is how one stage waits for another without a thread blocking in between. A
+// counter can be reused once it is back at zero, and must outlive its jobs.
+class JobCounter {
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	int Pending() const {
+		return pending.load(std::memory_order_acquire);
+	}
+
+	bool Done() const {
+		return Pending() == 0;
+	}
+
+private:
+	friend class JobSystem;
+
+	std::atomic<int>     pending{ 0 };
+	std::mutex           mutex;       // a job finishing vs. a dependant being added
+	std::vector<JobTask> dependants;  // jobs waiting for this counter to drain
+};
+
+// --- JOB SYSTEM ---
+// One pool of worker threads for the whole program, shared by the simulation tick, render
+// queues, image processing and asset loading instead of each spawning threads of its own.
+// Every worker has a deque of jobs: it takes its own newest first and, when that is empty,
+// the oldest from the shared deque (which threads outside the pool submit to) or steals
+// the oldest from another worker. The deques are short mutex-guarded rings; jobs are
+// coarse enough that a lock per push and pop doesn't show. Rings only grow and loops are
+// recycled, so once the pool has seen its busiest frame it allocates nothing.
+//
+// ParallelFor blocks until every chunk is done. Its caller works through chunks itself
+// and the pool only lends helpers, so a loop behaves like an ordinary for loop to the code
+// around it and never waits for a worker busy elsewhere: loops from several threads, or
+// from inside a chunk, simply share the pool. Chunks write to disjoint ranges; anything
+// order-dependent is merged by the caller afterwards.
+class JobSystem {
+public:
+	static JobSystem& Instance() {
+		static JobSystem instance;
+		return instance;
+	}
+
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+
+	~JobSystem() {
+		quit.store(true, std::memory_order_release);
+		epoch.fetch_add(1, std::memory_order_release);
+		epoch.notify_all();
+		for (auto& t : workers) t.join();
+	}
+
+	// Worker threads plus the calling thread.
+	size_t ThreadCount() const {
+		return workerCount + 1;
+	}
+
+	// Calls fn(begin, end) over [0, count) in chunks of at least minChunk items.
+	template<typename Fn>
+	void ParallelFor(size_t count, size_t minChunk, Fn&& fn) {
+		if (count == 0) return;
+		if (minChunk == 0) minChunk = 1;
+		size_t chunk = (count + ThreadCount() * 4 - 1) / (ThreadCount() * 4);
+		if (chunk < minChunk) chunk = minChunk;
+		if (workerCount == 0 || chunk >= count) {
+			fn(size_t(0), count);
+			return;
+		}
+
+		// The loop outlives this call in any helper that a worker only gets to afterwards;
+		// such a helper finds no chunks left and never touches fn. The last one out
+		// recycles it.
+		const size_t chunks = (count + chunk - 1) / chunk;
+		const size_t helpers = chunks - 1 < workerCount ? chunks - 1 : workerCount;
+		Loop* loop = AcquireLoop();
+		loop->invoke = [](void* ctx, size_t b, size_t e) { (*static_cast<std::remove_reference_t<Fn>*>(ctx))(b, e); };
+		loop->ctx = &fn;
+		loop->count = count;
+		loop->chunk = chunk;
+		loop->next.store(0, std::memory_order_relaxed);
+		loop->pending.store(chunks, std::memory_order_relaxed);
+		loop->refs.store(helpers + 1, std::memory_order_relaxed);
+
+		for (size_t h = 0; h < helpers; ++h) {
+			Push(JobTask{ [this, loop] {
+				RunChunks(*loop);
+				ReleaseLoop(loop);
+			}, nullptr });
+		}
+		Notify(helpers);
+
+		RunChunks(*loop);
+		for (size_t left; (left = loop->pending.load(std::memory_order_acquire)) != 0;) {
+			loop->pending.wait(left, std::memory_order_acquire);
+		}
+		ReleaseLoop(loop);
+	}
+
+	// Runs fn on the pool, counted on `counter` if there is one. With `after`, fn starts
+	// only once every job counted on `after` has finished.
+	void Run(std::function<void()> fn, JobCounter* counter = nullptr, JobCounter* after = nullptr) {
+		if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+		JobTask task{ std::move(fn), counter };
+		if (after) {
+			std::lock_guard<std::mutex> lock(after->mutex);
+			if (after->pending.load(std::memory_order_acquire) != 0) {
+				after->dependants.push_back(std::move(task));
+				return;
+			}
+		}
+		Submit(std::move(task));
+	}
+
+	// Blocks until `counter` has drained. A worker runs other jobs meanwhile, so jobs may
+	// wait on jobs without using up the pool.
+	void Wait(JobCounter& counter) {
+		if (Self() >= 0) {
+			JobTask task;
+			while (counter.pending.load(std::memory_order_acquire) != 0) {
+				if (Find(Self(), task)) Execute(task);
+				else std::this_thread::yield();
+			}
+		}
+		else {
+			for (int left; (left = counter.pending.load(std::memory_order_acquire)) != 0;) {
+				counter.pending.wait(left, std::memory_order_acquire);
+			}
+		}
+		// The last job still holds the mutex right after the count hits zero.
+		std::lock_guard<std::mutex> lock(counter.mutex);
+	}
+
+private:
+	struct Loop {
+		void (*invoke)(void*, size_t, size_t) = nullptr;
+		void*               ctx = nullptr;
+		size_t              count = 0;
+		size_t              chunk = 0;
+		std::atomic<size_t> next{ 0 };
+		std::atomic<size_t> pending{ 0 };  // chunks not yet finished
+		std::atomic<size_t> refs{ 0 };     // the caller and the helpers still to finish
+		Loop*               nextFree = nullptr;
+	};
+
+	static constexpr size_t C_QUEUE_CAPACITY = 64;  // per deque to start with, a power of two
+
+	// A deque as a ring: jobs are pushed and taken back at the end, stolen at the front.
+	// Doubles when full, never shrinks.
+	struct Queue {
+		std::mutex           mutex;
+		std::vector<JobTask> ring = std::vector<JobTask>(C_QUEUE_CAPACITY);
+		size_t               head = 0;  // the oldest
+		size_t               size = 0;
+
+		void PushBack(JobTask task) {
+			if (size == ring.size()) {
+				std::vector<JobTask> grown(ring.size() * 2);
+				for (size_t i = 0; i < size; ++i) grown[i] = std::move(ring[(head + i) & (ring.size() - 1)]);
+				ring.swap(grown);
+				head = 0;
+			}
+			ring[(head + size) & (ring.size() - 1)] = std::move(task);
+			++size;
+		}
+
+		bool PopBack(JobTask& out) {
+			if (size == 0) return false;
+			--size;
+			out = std::move(ring[(head + size) & (ring.size() - 1)]);
+			return true;
+		}
+
+		bool PopFront(JobTask& out) {
+			if (size == 0) return false;
+			out = std::move(ring[head]);
+			head = (head + 1) & (ring.size() - 1);
+			--size;
+			return true;
+		}
+	};
+
+	JobSystem() {
+		unsigned hw = std::thread::hardware_concurrency();
+		unsigned n = hw > 1 ? hw - 1 : 0;
+		workerCount = n;
+		queues.reserve(n + 1);
+		for (unsigned i = 0; i <= n; ++i) queues.push_back(std::make_unique<Queue>());
+		workers.reserve(n);
+		for (unsigned i = 0; i < n; ++i) {
+			workers.emplace_back([this, i] { WorkerLoop(static_cast<int>(i)); });
+		}
+	}
+
+	static void RunChunks(Loop& loop) {
+		for (;;) {
+			size_t begin = loop.next.fetch_add(loop.chunk, std::memory_order_relaxed);
+			if (begin >= loop.count) break;
+			size_t end = begin + loop.chunk < loop.count ? begin + loop.chunk : loop.count;
+			loop.invoke(loop.ctx, begin, end);
+			if (loop.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) loop.pending.notify_all();
+		}
+	}
+
+	Loop* AcquireLoop() {
+		std::lock_guard<std::mutex> lock(loopMutex);
+		if (!freeLoops) {
+			loops.push_back(std::make_unique<Loop>());
+			return loops.back().get();
+		}
+		Loop* loop = freeLoops;
+		freeLoops = loop->nextFree;
+		return loop;
+	}
+
+	void ReleaseLoop(Loop* loop) {
+		if (loop->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+		std::lock_guard<std::mutex> lock(loopMutex);
+		loop->nextFree = freeLoops;
+		freeLoops = loop;
+	}
+
+	// The calling thread's worker index, or -1 outside the pool.
+	static int& Self() {
+		static thread_local int self = -1;
+		return self;
+	}
+
+	// Onto the caller's own deque, or the shared one (the last) from outside the pool.
+	void Push(JobTask task) {
+		const int self = Self();
+		Queue& q = *queues[self >= 0 ? static_cast<size_t>(self) : workerCount];
+		std::lock_guard<std::mutex> lock(q.mutex);
+		q.PushBack(std::move(task));
+	}
+
+	void Notify(size_t jobs) {
+		if (jobs == 0) return;
+		epoch.fetch_add(1, std::memory_order_release);
+		if (jobs == 1) epoch.notify_one();
+		else epoch.notify_all();
+	}
+
+	// Without workers a job runs right away on the thread that made it ready.
+	void Submit(JobTask task) {
+		if (workerCount == 0) {
+			Execute(task);
+			return;
+		}
+		Push(std::move(task));
+		Notify(1);
+	}
+
+	// Own deque newest first, then the shared deque, then steal from the others, oldest first.
+	bool Find(int self, JobTask& out) {
+		if (self >= 0) {
+			Queue& own = *queues[static_cast<size_t>(self)];
+			std::lock_guard<std::mutex> lock(own.mutex);
+			if (own.PopBack(out)) return true;
+		}
+		const size_t others = workerCount;
+		if (TakeOldest(*queues[others], out)) return true;
+		const size_t start = self >= 0 ? static_cast<size_t>(self) + 1 : 0;
+		for (size_t k = 0; k < others; ++k) {
+			const size_t i = (start + k) % others;
+			if (static_cast<int>(i) != self && TakeOldest(*queues[i], out)) return true;
+		}
+		return false;
+	}
+
+	static bool TakeOldest(Queue& q, JobTask& out) {
+		std::lock_guard<std::mutex> lock(q.mutex);
+		return q.PopFront(out);
+	}
+
+	void Execute(JobTask& task) {
+		task.fn();
+		task.fn = nullptr;
+		if (task.counter) Finish(*task.counter);
+	}
+
+	void Finish(JobCounter& counter) {
+		std::vector<JobTask> ready;
+		{
+			std::lock_guard<std::mutex> lock(counter.mutex);
+			if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+			ready.swap(counter.dependants);
+			counter.pending.notify_all();
+		}
+		if (workerCount == 0) {
+			for (JobTask& task : ready) Execute(task);
+			return;
+		}
+		for (JobTask& task : ready) Push(std::move(task));
+		Notify(ready.size());
+	}
+
+	void WorkerLoop(int index) {
+		Self() = index;
+		JobTask task;
+		for (;;) {
+			const uint32_t seen = epoch.load(std::memory_order_acquire);
+			if (quit.load(std::memory_order_acquire)) return;
+			if (Find(index, task)) {
+				Execute(task);
+				continue;
+			}
+			epoch.wait(seen, std::memory_order_acquire);
+		}
+	}
+
+	std::vector<std::thread>            workers;
+	size_t                              workerCount = 0;  // set before any worker starts
+	std::vector<std::unique_ptr<Queue>> queues;  // one per worker, then the shared one
+	std::mutex                          loopMutex;
+	std::vector<std::unique_ptr<Loop>>  loops;           // every loop made so far
+	Loop*                               freeLoops = nullptr;  // those not running, linked
+	std::atomic<uint32_t>               epoch{ 0 };  // bumped on every submit, what idle workers sleep on
+	std::atomic<bool>                   quit{ false };
+};
+
+#endif // JOBS_H
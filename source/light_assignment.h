@@ -0,0 +1,171 @@
+#ifndef LIGHT_ASSIGNMENT_H
+#define LIGHT_ASSIGNMENT_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "clustered_lights.h"
+
+// --- PER-OBJECT LIGHT ASSIGNMENT ---
+// Forward shading where each draw loops over only the point lights whose radius reaches
+// its bounding sphere, for many small lights spread over a large scene: an object's
+// cost follows the lights around it, not the scene's total.
+//
+// Update() uploads every light once a frame (two texels each, as ClusteredLights lays
+// them out) and bins them into a C_GRID x C_GRID grid over the ground plane, spanning the
+// lights' bounds. Assign() then gathers the lights in the cells under an object's sphere,
+// keeps those that truly overlap it and sets the shader's per-draw list: up to
+// C_MAX_PER_DRAW indices and a count, the nearest (relative to their radius) winning
+// when there are more. Lights fade to zero at their radius, so the list is exact unless
+// it overflows.
+class LightAssignment {
+public:
+	static constexpr int C_MAX_LIGHTS = 1024;
+	static constexpr int C_MAX_PER_DRAW = 16;  // lighting_assigned.fs's array size
+	static constexpr int C_GRID = 32;
+
+	struct Stats {
+		int lights = 0;    // lights submitted
+		int draws = 0;     // Assign() calls
+		int assigned = 0;  // light-draw pairs shaded
+		int busiest = 0;   // longest list
+		int dropped = 0;   // pairs lost to C_MAX_PER_DRAW
+	};
+
+	void Init() {
+		lightData = rlLoadTexture(nullptr, 2 * C_MAX_LIGHTS, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+		lightTexels.resize(2 * C_MAX_LIGHTS * 4);
+	}
+
+	void Unload() {
+		rlUnloadTexture(lightData);
+		lightData = 0;
+	}
+
+	// Fetches the per-draw uniforms and points the specular map slot at the light sampler.
+	// Needed again for every program that replaces this one.
+	void Bind(Shader& shader) {
+		shader.locs[SHADER_LOC_MAP_SPECULAR] = GetShaderLocation(shader, "assignedLights");
+		indicesLoc = GetShaderLocation(shader, "lightIndices");
+		countLoc = GetShaderLocation(shader, "lightCount");
+	}
+
+	void Attach(Material& material) const {
+		SetLightSlot(material, MATERIAL_MAP_SPECULAR, lightData, 2 * C_MAX_LIGHTS, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+	}
+
+	void Detach(Material& material) const {
+		ClearLightSlot(material, MATERIAL_MAP_SPECULAR);
+	}
+
+	// Uploads this frame's lights and bins them. Lights past C_MAX_LIGHTS are ignored.
+	void Update(const std::vector<PointLight>& lights) {
+		const int n = std::min(static_cast<int>(lights.size()), C_MAX_LIGHTS);
+		stats = Stats{};
+		stats.lights = n;
+		current.assign(lights.begin(), lights.begin() + n);
+		for (auto& cell : cells) cell.clear();
+		stamps.assign(n, 0);
+		stamp = 0;
+		if (n == 0) return;
+
+		lo = { current[0].position.x, current[0].position.z };
+		Vector2 hi = lo;
+		for (int i = 0; i < n; ++i) {
+			const PointLight& l = current[i];
+			float* texel = &lightTexels[i * 8];
+			texel[0] = l.position.x;
+			texel[1] = l.position.y;
+			texel[2] = l.position.z;
+			texel[3] = l.radius;
+			texel[4] = static_cast<float>(l.color.r) / 255.0f;
+			texel[5] = static_cast<float>(l.color.g) / 255.0f;
+			texel[6] = static_cast<float>(l.color.b) / 255.0f;
+			texel[7] = 0.0f;
+			lo = { std::min(lo.x, l.position.x - l.radius), std::min(lo.y, l.position.z - l.radius) };
+			hi = { std::max(hi.x, l.position.x + l.radius), std::max(hi.y, l.position.z + l.radius) };
+		}
+		rlUpdateTexture(lightData, 0, 0, 2 * n, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, lightTexels.data());
+
+		cellSize = std::max(std::max(hi.x - lo.x, hi.y - lo.y) / C_GRID, 1e-3f);
+		for (int i = 0; i < n; ++i) {
+			const PointLight& l = current[i];
+			ForEachCell(l.position, l.radius, [&](std::vector<int>& cell) { cell.push_back(i); });
+		}
+	}
+
+	// Lists the lights reaching the sphere into `shader`'s per-draw uniforms, for the draw
+	// that follows; returns how many.
+	int Assign(const Shader& shader, Vector3 centre, float radius) {
+		++stamp;
+		candidates.clear();
+		ForEachCell(centre, radius, [&](const std::vector<int>& cell) {
+			for (int i : cell) {
+				if (stamps[i] == stamp) continue;  // already seen through another cell
+				stamps[i] = stamp;
+				const float reach = current[i].radius + radius;
+				const float d = Vector3Distance(current[i].position, centre);
+				if (d < reach) candidates.push_back({ i, d / reach });
+			}
+		});
+
+		const int count = std::min(static_cast<int>(candidates.size()), C_MAX_PER_DRAW);
+		if (static_cast<int>(candidates.size()) > count) {
+			std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(),
+				[](const Candidate& a, const Candidate& b) { return a.overlap < b.overlap; });
+		}
+		for (int k = 0; k < count; ++k) list[k] = candidates[k].light;
+		if (count > 0) SetShaderValueV(shader, indicesLoc, list, SHADER_UNIFORM_INT, count);
+		SetShaderValue(shader, countLoc, &count, SHADER_UNIFORM_INT);
+
+		++stats.draws;
+		stats.assigned += count;
+		stats.busiest = std::max(stats.busiest, count);
+		stats.dropped += static_cast<int>(candidates.size()) - count;
+		return count;
+	}
+
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+private:
+	struct Candidate {
+		int   light;
+		float overlap;  // centre distance over the combined radius: lower is deeper
+	};
+
+	// The grid cells under a sphere's footprint on the ground plane, clamped to the grid.
+	template<typename F>
+	void ForEachCell(Vector3 centre, float radius, F&& visit) {
+		auto cell = [&](float v, float origin) {
+			return std::clamp(static_cast<int>(floorf((v - origin) / cellSize)), 0, C_GRID - 1);
+		};
+		const int x0 = cell(centre.x - radius, lo.x), x1 = cell(centre.x + radius, lo.x);
+		const int z0 = cell(centre.z - radius, lo.y), z1 = cell(centre.z + radius, lo.y);
+		for (int z = z0; z <= z1; ++z) {
+			for (int x = x0; x <= x1; ++x) visit(cells[z * C_GRID + x]);
+		}
+	}
+
+	unsigned int lightData = 0;
+	int          indicesLoc = -1;
+	int          countLoc = -1;
+	int          list[C_MAX_PER_DRAW] = {};
+
+	std::vector<float>      lightTexels;
+	std::vector<PointLight> current;
+	std::vector<int>        cells[C_GRID * C_GRID];
+	std::vector<unsigned>   stamps;  // per light, the Assign() that last saw it
+	unsigned                stamp = 0;
+	std::vector<Candidate>  candidates;
+	Vector2                 lo{};    // grid origin, on x and z
+	float                   cellSize = 1.0f;
+	Stats                   stats;
+};
+
+#endif // LIGHT_ASSIGNMENT_H
@@ -0,0 +1,721 @@
+#ifndef LIGHTMAP_BAKER_H
+#define LIGHTMAP_BAKER_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlights.h"
+#include "asset_cache.h"
+#include "jobs.h"
+
+// raylib builds its own copy for font atlases but doesn't export it as API; a private one
+// here keeps the baker independent of how raylib was configured.
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "external/stb_rect_pack.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+// --- LIGHTMAP BAKING ---
+// Static lighting for a scene of models, baked into one atlas that lightmap.vs/fs read
+// through the second UV set:
+//   1. unwrap: each model's triangles are grouped into charts (connected triangles that face
+//      the same axis), each chart projected flat along that axis at Settings::texelsPerUnit
+//      in world space, and all the charts packed into the atlas with stb_rect_pack (denser
+//      first, coarser until they fit). Vertices on chart seams are split, so the baked
+//      models are copies of the inputs with texcoords2 added;
+//   2. direct: every covered texel is lit by the rlights.h Lights as lighting.fs lights them
+//      (point lights fade out at Settings::pointRadius, as in the clustered path), with a
+//      shadow ray per light against a BVH of the whole scene;
+//   3. bounce: cosine-distributed rays from every texel gather the direct light where they
+//      land, times Settings::albedo, or the sky where they escape;
+//   4. the sum is gamma-encoded (8 bits keep the darks that way), dilated into the chart
+//      padding so filtering doesn't pull in black, and uploaded.
+// The result is cooked into the asset cache under a key hashed from everything that went
+// in, so a scene that hasn't changed only maps its blobs.
+namespace Lightmap {
+	struct Settings {
+		int     size = 1024;             // atlas width and height
+		float   texelsPerUnit = 8.0f;    // at most; lowered until the charts fit
+		int     padding = 2;             // texels around each chart
+		float   pointRadius = 12.0f;
+		int     bounceSamples = 32;
+		float   albedo = 0.5f;           // reflectance of everything, for the bounce
+		Vector3 sky = { 0.20f, 0.22f, 0.28f };
+	};
+
+	struct Scene {
+		std::vector<Model> models;  // the inputs with lightmap UVs, materials with colours only
+		Texture2D          lightmap{};
+		bool               cached = false;
+		int                charts = 0;
+		int                texels = 0;  // covered by some chart
+		float              texelsPerUnit = 0.0f;
+	};
+
+	namespace Detail {
+		constexpr int      C_VERSION = 1;  // bump when anything below changes the result
+		constexpr float    C_EPSILON = 1e-6f;
+		constexpr uint64_t C_PRIME = 1099511628211ull;
+
+		// --- BVH ---
+		struct Triangle {
+			Vector3 a, b, c;
+			Vector3 normal;   // geometric, unit
+			Vector2 ta, tb, tc;  // lightmap texel coordinates of the corners
+		};
+
+		struct Hit {
+			float t = INFINITY;
+			int   triangle = -1;
+			float u = 0.0f, v = 0.0f;
+		};
+
+		// Median-split bounding volume hierarchy; leaves hold up to C_LEAF triangles.
+		class Bvh {
+		public:
+			void Build(std::vector<Triangle> triangles) {
+				tris = std::move(triangles);
+				order.resize(tris.size());
+				for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+				nodes.clear();
+				nodes.reserve(tris.size() * 2);
+				if (!tris.empty()) Split(0, static_cast<int>(tris.size()));
+				std::vector<Triangle> sorted(tris.size());
+				for (size_t i = 0; i < order.size(); ++i) sorted[i] = tris[order[i]];
+				tris = std::move(sorted);
+			}
+
+			const Triangle& Get(int i) const {
+				return tris[i];
+			}
+
+			// The nearest hit closer than `maxT`.
+			Hit Trace(Vector3 origin, Vector3 dir, float maxT) const {
+				Hit hit;
+				hit.t = maxT;
+				Walk(origin, dir, hit, false);
+				return hit;
+			}
+
+			bool Occluded(Vector3 origin, Vector3 dir, float maxT) const {
+				Hit hit;
+				hit.t = maxT;
+				return Walk(origin, dir, hit, true);
+			}
+
+		private:
+			static constexpr int C_LEAF = 4;
+
+			struct Node {
+				Vector3 min, max;
+				int     first;  // leaf: first triangle; inner: right child (left is next)
+				int     count;  // 0 for inner nodes
+			};
+
+			int Split(int first, int count) {
+				const int index = static_cast<int>(nodes.size());
+				nodes.push_back({});
+				Vector3 mn = { INFINITY, INFINITY, INFINITY }, mx = { -INFINITY, -INFINITY, -INFINITY };
+				Vector3 cmn = mn, cmx = mx;
+				for (int i = first; i < first + count; ++i) {
+					const Triangle& t = tris[order[i]];
+					for (const Vector3& p : { t.a, t.b, t.c }) {
+						mn = Vector3Min(mn, p);
+						mx = Vector3Max(mx, p);
+					}
+					const Vector3 c = Centroid(t);
+					cmn = Vector3Min(cmn, c);
+					cmx = Vector3Max(cmx, c);
+				}
+				nodes[index].min = mn;
+				nodes[index].max = mx;
+				if (count <= C_LEAF) {
+					nodes[index].first = first;
+					nodes[index].count = count;
+					return index;
+				}
+
+				const Vector3 extent = Vector3Subtract(cmx, cmn);
+				const int axis = (extent.x > extent.y && extent.x > extent.z) ? 0 : (extent.y > extent.z ? 1 : 2);
+				const int mid = first + count / 2;
+				std::nth_element(order.begin() + first, order.begin() + mid, order.begin() + first + count, [&](int l, int r) {
+					return Axis(Centroid(tris[l]), axis) < Axis(Centroid(tris[r]), axis);
+				});
+				Split(first, mid - first);
+				const int right = Split(mid, first + count - mid);
+				nodes[index].first = right;
+				nodes[index].count = 0;
+				return index;
+			}
+
+			static Vector3 Centroid(const Triangle& t) {
+				return Vector3Scale(Vector3Add(Vector3Add(t.a, t.b), t.c), 1.0f / 3.0f);
+			}
+
+			static float Axis(Vector3 v, int axis) {
+				return (axis == 0) ? v.x : (axis == 1 ? v.y : v.z);
+			}
+
+			static bool Box(const Node& n, Vector3 origin, Vector3 inv, float maxT) {
+				float t0 = 0.0f, t1 = maxT;
+				const float o[3] = { origin.x, origin.y, origin.z };
+				const float d[3] = { inv.x, inv.y, inv.z };
+				const float lo[3] = { n.min.x, n.min.y, n.min.z };
+				const float hi[3] = { n.max.x, n.max.y, n.max.z };
+				for (int a = 0; a < 3; ++a) {
+					float near = (lo[a] - o[a]) * d[a];
+					float far = (hi[a] - o[a]) * d[a];
+					if (near > far) std::swap(near, far);
+					t0 = near > t0 ? near : t0;
+					t1 = far < t1 ? far : t1;
+					if (t0 > t1) return false;
+				}
+				return true;
+			}
+
+			// Moller-Trumbore, both faces.
+			static bool Intersect(const Triangle& tri, Vector3 origin, Vector3 dir, Hit& hit, int index) {
+				const Vector3 e1 = Vector3Subtract(tri.b, tri.a);
+				const Vector3 e2 = Vector3Subtract(tri.c, tri.a);
+				const Vector3 p = Vector3CrossProduct(dir, e2);
+				const float det = Vector3DotProduct(e1, p);
+				if (fabsf(det) < C_EPSILON) return false;
+				const float inv = 1.0f / det;
+				const Vector3 s = Vector3Subtract(origin, tri.a);
+				const float u = Vector3DotProduct(s, p) * inv;
+				if (u < 0.0f || u > 1.0f) return false;
+				const Vector3 q = Vector3CrossProduct(s, e1);
+				const float v = Vector3DotProduct(dir, q) * inv;
+				if (v < 0.0f || u + v > 1.0f) return false;
+				const float t = Vector3DotProduct(e2, q) * inv;
+				if (t <= C_EPSILON || t >= hit.t) return false;
+				hit = { t, index, u, v };
+				return true;
+			}
+
+			bool Walk(Vector3 origin, Vector3 dir, Hit& hit, bool any) const {
+				if (nodes.empty()) return false;
+				const Vector3 inv = { 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z };
+				int stack[64];
+				int top = 0;
+				stack[top++] = 0;
+				bool found = false;
+				while (top > 0) {
+					const Node& n = nodes[stack[--top]];
+					if (!Box(n, origin, inv, hit.t)) continue;
+					if (n.count > 0) {
+						for (int i = n.first; i < n.first + n.count; ++i) {
+							if (Intersect(tris[i], origin, dir, hit, i)) {
+								found = true;
+								if (any) return true;
+							}
+						}
+					}
+					else {
+						const int self = static_cast<int>(&n - nodes.data());
+						stack[top++] = n.first;
+						stack[top++] = self + 1;
+					}
+				}
+				return found;
+			}
+
+			std::vector<Triangle> tris;
+			std::vector<int>      order;
+			std::vector<Node>     nodes;
+		};
+
+		// --- UNWRAP ---
+		struct Chart {
+			int              object;
+			int              mesh;
+			int              axis;       // 0-5: +X -X +Y -Y +Z -Z
+			std::vector<int> triangles;  // of the mesh
+			Vector2          min, max;   // projected, world units
+			int              x = 0, y = 0;  // packed corner, texels
+		};
+
+		struct Source {
+			const Mesh*          mesh;
+			Matrix               transform;
+			std::vector<Vector3> world;    // positions
+			std::vector<int>     corners;  // 3 per triangle
+		};
+
+		inline Vector3 VertexOf(const Mesh& mesh, int i) {
+			return { mesh.vertices[i * 3], mesh.vertices[i * 3 + 1], mesh.vertices[i * 3 + 2] };
+		}
+
+		inline int DominantAxis(Vector3 n) {
+			const float ax = fabsf(n.x), ay = fabsf(n.y), az = fabsf(n.z);
+			if (ax >= ay && ax >= az) return n.x >= 0.0f ? 0 : 1;
+			if (ay >= az) return n.y >= 0.0f ? 2 : 3;
+			return n.z >= 0.0f ? 4 : 5;
+		}
+
+		inline Vector2 Project(Vector3 p, int axis) {
+			switch (axis / 2) {
+			case 0: return { p.z, p.y };
+			case 1: return { p.x, p.z };
+			default: return { p.x, p.y };
+			}
+		}
+
+		inline Vector3 FaceNormal(Vector3 a, Vector3 b, Vector3 c) {
+			return Vector3Normalize(Vector3CrossProduct(Vector3Subtract(b, a), Vector3Subtract(c, a)));
+		}
+
+		// The charts of one mesh: flood fill over edges shared (by position) between
+		// triangles of the same axis. Degenerate triangles are left out of every chart.
+		inline void MakeCharts(const Source& src, int object, int mesh, std::vector<Chart>& charts) {
+			const int triangles = static_cast<int>(src.corners.size() / 3);
+			// Corners welded by exact position, so unindexed meshes chart the same way.
+			std::unordered_map<uint64_t, int> ids;
+			std::vector<int> position(src.world.size());
+			for (size_t i = 0; i < src.world.size(); ++i) {
+				const Vector3 p = VertexOf(*src.mesh, static_cast<int>(i));
+				uint32_t bits[3];
+				memcpy(bits, &p, sizeof(bits));
+				const uint64_t key = (static_cast<uint64_t>(bits[0]) * C_PRIME ^ bits[1]) * C_PRIME ^ bits[2];
+				position[i] = ids.emplace(key, static_cast<int>(ids.size())).first->second;
+			}
+
+			std::vector<int> axis(triangles, -1);
+			std::unordered_map<uint64_t, std::vector<int>> edges;
+			for (int t = 0; t < triangles; ++t) {
+				const int* c = &src.corners[t * 3];
+				const Vector3 n = Vector3CrossProduct(Vector3Subtract(src.world[c[1]], src.world[c[0]]), Vector3Subtract(src.world[c[2]], src.world[c[0]]));
+				if (Vector3LengthSqr(n) < C_EPSILON * C_EPSILON) continue;
+				axis[t] = DominantAxis(n);
+				for (int e = 0; e < 3; ++e) {
+					const uint64_t p = static_cast<uint64_t>(position[c[e]]), q = static_cast<uint64_t>(position[c[(e + 1) % 3]]);
+					edges[std::min(p, q) << 32 | std::max(p, q)].push_back(t);
+				}
+			}
+
+			std::vector<bool> done(triangles, false);
+			std::vector<int> stack;
+			for (int seed = 0; seed < triangles; ++seed) {
+				if (done[seed] || axis[seed] < 0) continue;
+				Chart chart{ object, mesh, axis[seed], {}, { INFINITY, INFINITY }, { -INFINITY, -INFINITY } };
+				stack.assign(1, seed);
+				done[seed] = true;
+				while (!stack.empty()) {
+					const int t = stack.back();
+					stack.pop_back();
+					chart.triangles.push_back(t);
+					const int* c = &src.corners[t * 3];
+					for (int e = 0; e < 3; ++e) {
+						const Vector2 uv = Project(src.world[c[e]], chart.axis);
+						chart.min = { std::min(chart.min.x, uv.x), std::min(chart.min.y, uv.y) };
+						chart.max = { std::max(chart.max.x, uv.x), std::max(chart.max.y, uv.y) };
+						const uint64_t p = static_cast<uint64_t>(position[c[e]]), q = static_cast<uint64_t>(position[c[(e + 1) % 3]]);
+						for (int other : edges[std::min(p, q) << 32 | std::max(p, q)]) {
+							if (done[other] || axis[other] != chart.axis) continue;
+							done[other] = true;
+							stack.push_back(other);
+						}
+					}
+				}
+				charts.push_back(std::move(chart));
+			}
+		}
+
+		inline int Extent(float length, float density, int padding) {
+			return static_cast<int>(ceilf(length * density)) + 1 + padding * 2;
+		}
+
+		// Packs every chart at `density`; false if they don't all fit.
+		inline bool Pack(std::vector<Chart>& charts, float density, const Settings& s) {
+			std::vector<stbrp_rect> rects(charts.size());
+			for (size_t i = 0; i < charts.size(); ++i) {
+				rects[i].id = static_cast<int>(i);
+				rects[i].w = Extent(charts[i].max.x - charts[i].min.x, density, s.padding);
+				rects[i].h = Extent(charts[i].max.y - charts[i].min.y, density, s.padding);
+			}
+			std::vector<stbrp_node> nodes(static_cast<size_t>(s.size));
+			stbrp_context context;
+			stbrp_init_target(&context, s.size, s.size, nodes.data(), static_cast<int>(nodes.size()));
+			if (!stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()))) return false;
+			for (const stbrp_rect& r : rects) {
+				charts[r.id].x = r.x;
+				charts[r.id].y = r.y;
+			}
+			return true;
+		}
+
+		// Lightmap texel coordinates of a world position in `chart`.
+		inline Vector2 TexelOf(const Chart& chart, Vector3 world, float density, int padding) {
+			const Vector2 p = Vector2Subtract(Project(world, chart.axis), chart.min);
+			return { static_cast<float>(chart.x + padding) + 0.5f + p.x * density, static_cast<float>(chart.y + padding) + 0.5f + p.y * density };
+		}
+
+		// Copies `object`'s mesh with its vertices split along chart seams and texcoords2 set;
+		// false (and nothing allocated) if the split needs more than 16-bit indices.
+		inline bool Rebuild(const Source& src, const std::vector<const Chart*>& charts, float density, const Settings& s, Mesh& out) {
+			const Mesh& in = *src.mesh;
+			std::vector<int> from;          // source vertex of each new one
+			std::vector<Vector2> uv;
+			std::vector<unsigned short> indices;
+			for (const Chart* chart : charts) {
+				std::unordered_map<int, int> local;
+				for (int t : chart->triangles) {
+					for (int e = 0; e < 3; ++e) {
+						const int v = src.corners[t * 3 + e];
+						auto [it, added] = local.emplace(v, static_cast<int>(from.size()));
+						if (added) {
+							from.push_back(v);
+							const Vector2 texel = TexelOf(*chart, src.world[v], density, s.padding);
+							uv.push_back({ texel.x / static_cast<float>(s.size), texel.y / static_cast<float>(s.size) });
+						}
+						indices.push_back(static_cast<unsigned short>(it->second));
+					}
+				}
+			}
+			if (from.size() > 65535) return false;
+
+			out = Mesh{};
+			out.vertexCount = static_cast<int>(from.size());
+			out.triangleCount = static_cast<int>(indices.size() / 3);
+			auto gather = [&](const float* stream, int width) -> float* {
+				if (!stream) return nullptr;
+				float* copy = static_cast<float*>(MemAlloc(static_cast<unsigned int>(sizeof(float) * width * from.size())));
+				for (size_t i = 0; i < from.size(); ++i) memcpy(copy + i * width, stream + static_cast<size_t>(from[i]) * width, sizeof(float) * width);
+				return copy;
+			};
+			out.vertices = gather(in.vertices, 3);
+			out.texcoords = gather(in.texcoords, 2);
+			out.normals = gather(in.normals, 3);
+			out.tangents = gather(in.tangents, 4);
+			if (in.colors) {
+				out.colors = static_cast<unsigned char*>(MemAlloc(static_cast<unsigned int>(4 * from.size())));
+				for (size_t i = 0; i < from.size(); ++i) memcpy(out.colors + i * 4, in.colors + static_cast<size_t>(from[i]) * 4, 4);
+			}
+			out.texcoords2 = static_cast<float*>(MemAlloc(static_cast<unsigned int>(sizeof(Vector2) * uv.size())));
+			memcpy(out.texcoords2, uv.data(), sizeof(Vector2) * uv.size());
+			out.indices = static_cast<unsigned short*>(MemAlloc(static_cast<unsigned int>(sizeof(unsigned short) * indices.size())));
+			memcpy(out.indices, indices.data(), sizeof(unsigned short) * indices.size());
+			return true;
+		}
+
+		// --- LIGHTING ---
+		struct Texel {
+			Vector3 position;
+			Vector3 normal;
+			bool    covered = false;
+		};
+
+		inline Vector3 ColorOf(Color c) {
+			return { static_cast<float>(c.r) / 255.0f, static_cast<float>(c.g) / 255.0f, static_cast<float>(c.b) / 255.0f };
+		}
+
+		inline Vector3 Direct(const Bvh& bvh, const Texel& t, const Light* lights, int count, const Settings& s, float bias) {
+			Vector3 sum{};
+			const Vector3 origin = Vector3Add(t.position, Vector3Scale(t.normal, bias));
+			for (int i = 0; i < count; ++i) {
+				const Light& l = lights[i];
+				if (!l.enabled) continue;
+				Vector3 dir;
+				float distance = INFINITY, fade = 1.0f;
+				if (l.type == LIGHT_DIRECTIONAL) dir = Vector3Negate(Vector3Normalize(Vector3Subtract(l.target, l.position)));
+				else {
+					const Vector3 to = Vector3Subtract(l.position, t.position);
+					distance = Vector3Length(to);
+					fade = Clamp(1.0f - distance * distance / (s.pointRadius * s.pointRadius), 0.0f, 1.0f);
+					fade *= fade;
+					if (fade <= 0.0f) continue;
+					dir = Vector3Scale(to, 1.0f / distance);
+				}
+				const float nDotL = Vector3DotProduct(t.normal, dir);
+				if (nDotL <= 0.0f || bvh.Occluded(origin, dir, distance)) continue;
+				sum = Vector3Add(sum, Vector3Scale(ColorOf(l.color), nDotL * fade));
+			}
+			return sum;
+		}
+
+		// The cosine-weighted hemisphere around `n`, sample `i` of `count`, rotated by `spin`.
+		inline Vector3 CosineSample(Vector3 n, int i, int count, float spin) {
+			const float u = (static_cast<float>(i) + 0.5f) / static_cast<float>(count);
+			const float v = fmodf(static_cast<float>(i) * 0.618034f + spin, 1.0f);
+			const float r = sqrtf(u);
+			const float phi = 2.0f * PI * v;
+			const Vector3 up = (fabsf(n.y) < 0.999f) ? Vector3{ 0.0f, 1.0f, 0.0f } : Vector3{ 1.0f, 0.0f, 0.0f };
+			const Vector3 tx = Vector3Normalize(Vector3CrossProduct(up, n));
+			const Vector3 ty = Vector3CrossProduct(n, tx);
+			const Vector3 l = { r * cosf(phi), r * sinf(phi), sqrtf(1.0f - u) };
+			return Vector3Add(Vector3Add(Vector3Scale(tx, l.x), Vector3Scale(ty, l.y)), Vector3Scale(n, l.z));
+		}
+
+		// Fills uncovered texels next to covered ones, `passes` rings out.
+		inline void Dilate(std::vector<Vector3>& values, std::vector<bool> covered, int size, int passes) {
+			for (int pass = 0; pass < passes; ++pass) {
+				std::vector<bool> next = covered;
+				for (int y = 0; y < size; ++y) {
+					for (int x = 0; x < size; ++x) {
+						const size_t i = static_cast<size_t>(y) * size + x;
+						if (covered[i]) continue;
+						Vector3 sum{};
+						int n = 0;
+						for (int dy = -1; dy <= 1; ++dy) {
+							for (int dx = -1; dx <= 1; ++dx) {
+								const int nx = x + dx, ny = y + dy;
+								if (nx < 0 || ny < 0 || nx >= size || ny >= size) continue;
+								const size_t j = static_cast<size_t>(ny) * size + nx;
+								if (!covered[j]) continue;
+								sum = Vector3Add(sum, values[j]);
+								++n;
+							}
+						}
+						if (n == 0) continue;
+						values[i] = Vector3Scale(sum, 1.0f / static_cast<float>(n));
+						next[i] = true;
+					}
+				}
+				covered = std::move(next);
+			}
+		}
+
+		// --- CACHE ---
+		inline uint64_t SceneKey(const Model* const* models, const Matrix* transforms, int count, const Light* lights, int lightCount, const Settings& s) {
+			uint64_t h = 14695981039346656037ull;
+			auto mix = [&h](const void* data, size_t bytes) {
+				const unsigned char* p = static_cast<const unsigned char*>(data);
+				for (size_t i = 0; i < bytes; ++i) h = (h ^ p[i]) * C_PRIME;
+			};
+			mix(&C_VERSION, sizeof(C_VERSION));
+			mix(&s, sizeof(s));
+			for (int i = 0; i < lightCount; ++i) {
+				mix(&lights[i].type, sizeof(int));
+				mix(&lights[i].enabled, sizeof(bool));
+				mix(&lights[i].position, sizeof(Vector3));
+				mix(&lights[i].target, sizeof(Vector3));
+				mix(&lights[i].color, sizeof(Color));
+			}
+			for (int o = 0; o < count; ++o) {
+				mix(&transforms[o], sizeof(Matrix));
+				for (int m = 0; m < models[o]->meshCount; ++m) {
+					const Mesh& mesh = models[o]->meshes[m];
+					mix(&mesh.vertexCount, sizeof(int));
+					mix(&mesh.triangleCount, sizeof(int));
+					mix(mesh.vertices, sizeof(float) * 3 * mesh.vertexCount);
+					if (mesh.indices) mix(mesh.indices, sizeof(unsigned short) * 3 * mesh.triangleCount);
+				}
+			}
+			return h;
+		}
+
+		inline uint64_t ModelKey(uint64_t scene, int object) {
+			return (scene ^ static_cast<uint64_t>(object + 1)) * C_PRIME;
+		}
+
+		// Materials like the cache gives back: default ones, diffuse colour kept.
+		inline Model CopyFrame(const Model& source) {
+			Model model{};
+			model.transform = source.transform;
+			model.materialCount = source.materialCount;
+			model.materials = static_cast<Material*>(MemAlloc(static_cast<unsigned int>(sizeof(Material) * model.materialCount)));
+			for (int i = 0; i < model.materialCount; ++i) {
+				model.materials[i] = LoadMaterialDefault();
+				model.materials[i].maps[MATERIAL_MAP_DIFFUSE].color = source.materials[i].maps[MATERIAL_MAP_DIFFUSE].color;
+			}
+			model.meshCount = source.meshCount;
+			model.meshes = static_cast<Mesh*>(MemAlloc(static_cast<unsigned int>(sizeof(Mesh) * model.meshCount)));
+			model.meshMaterial = static_cast<int*>(MemAlloc(static_cast<unsigned int>(sizeof(int) * model.meshCount)));
+			for (int m = 0; m < model.meshCount; ++m) model.meshMaterial[m] = source.meshMaterial ? source.meshMaterial[m] : 0;
+			return model;
+		}
+
+		// Everything but the GPU: the unwrapped models (meshes not uploaded) and the lightmap.
+		inline bool Compute(const Model* const* models, const Matrix* transforms, int count, const Light* lights, int lightCount, const Settings& s, Scene& scene, Image& image) {
+			std::vector<std::vector<Source>> sources(count);
+			std::vector<Chart> charts;
+			for (int o = 0; o < count; ++o) {
+				for (int m = 0; m < models[o]->meshCount; ++m) {
+					const Mesh& mesh = models[o]->meshes[m];
+					Source src{ &mesh, transforms[o], {}, {} };
+					if (mesh.vertices == nullptr) return false;
+					for (int v = 0; v < mesh.vertexCount; ++v) src.world.push_back(Vector3Transform(VertexOf(mesh, v), transforms[o]));
+					for (int i = 0; i < mesh.triangleCount * 3; ++i) src.corners.push_back(mesh.indices ? mesh.indices[i] : i);
+					MakeCharts(src, o, m, charts);
+					sources[o].push_back(std::move(src));
+				}
+			}
+			// Big charts first packs tighter.
+			std::sort(charts.begin(), charts.end(), [](const Chart& a, const Chart& b) {
+				return (a.max.y - a.min.y) > (b.max.y - b.min.y);
+			});
+			float density = s.texelsPerUnit;
+			while (!Pack(charts, density, s)) {
+				density *= 0.85f;
+				if (density < 0.05f) return false;
+			}
+
+			// Unwrapped meshes, and the scene's triangles in lightmap space.
+			std::vector<std::vector<std::vector<const Chart*>>> byMesh(count);
+			for (int o = 0; o < count; ++o) byMesh[o].resize(sources[o].size());
+			for (const Chart& c : charts) byMesh[c.object][c.mesh].push_back(&c);
+			std::vector<Triangle> triangles;
+			for (const Chart& c : charts) {
+				const Source& src = sources[c.object][c.mesh];
+				for (int t : c.triangles) {
+					const Vector3& a = src.world[src.corners[t * 3]];
+					const Vector3& b = src.world[src.corners[t * 3 + 1]];
+					const Vector3& d = src.world[src.corners[t * 3 + 2]];
+					triangles.push_back({ a, b, d, FaceNormal(a, b, d), TexelOf(c, a, density, s.padding), TexelOf(c, b, density, s.padding), TexelOf(c, d, density, s.padding) });
+				}
+			}
+			for (int o = 0; o < count; ++o) {
+				Model model = CopyFrame(*models[o]);
+				for (int m = 0; m < model.meshCount; ++m) {
+					if (!Rebuild(sources[o][m], byMesh[o][m], density, s, model.meshes[m])) {
+						TraceLog(LOG_WARNING, "LIGHTMAP: model %i mesh %i has too many vertices once split into charts", o, m);
+						model.meshes[m] = Mesh{};
+					}
+				}
+				scene.models.push_back(model);
+			}
+
+			// Rasterize every triangle's texel centres, then light them.
+			const int size = s.size;
+			std::vector<Texel> texels(static_cast<size_t>(size) * size);
+			Bvh bvh;
+			bvh.Build(triangles);
+			for (size_t i = 0; i < triangles.size(); ++i) {
+				const Triangle& t = bvh.Get(static_cast<int>(i));
+				const int x0 = std::max(0, static_cast<int>(floorf(std::min({ t.ta.x, t.tb.x, t.tc.x }))));
+				const int x1 = std::min(size - 1, static_cast<int>(ceilf(std::max({ t.ta.x, t.tb.x, t.tc.x }))));
+				const int y0 = std::max(0, static_cast<int>(floorf(std::min({ t.ta.y, t.tb.y, t.tc.y }))));
+				const int y1 = std::min(size - 1, static_cast<int>(ceilf(std::max({ t.ta.y, t.tb.y, t.tc.y }))));
+				const float area = (t.tb.x - t.ta.x) * (t.tc.y - t.ta.y) - (t.tc.x - t.ta.x) * (t.tb.y - t.ta.y);
+				if (fabsf(area) < C_EPSILON) continue;
+				for (int y = y0; y <= y1; ++y) {
+					for (int x = x0; x <= x1; ++x) {
+						const Vector2 p = { static_cast<float>(x) + 0.5f, static_cast<float>(y) + 0.5f };
+						const float w1 = ((p.x - t.ta.x) * (t.tc.y - t.ta.y) - (t.tc.x - t.ta.x) * (p.y - t.ta.y)) / area;
+						const float w2 = ((t.tb.x - t.ta.x) * (p.y - t.ta.y) - (p.x - t.ta.x) * (t.tb.y - t.ta.y)) / area;
+						const float w0 = 1.0f - w1 - w2;
+						if (w0 < -0.01f || w1 < -0.01f || w2 < -0.01f) continue;
+						Texel& texel = texels[static_cast<size_t>(y) * size + x];
+						texel.position = Vector3Add(Vector3Add(Vector3Scale(t.a, w0), Vector3Scale(t.b, w1)), Vector3Scale(t.c, w2));
+						texel.normal = t.normal;
+						texel.covered = true;
+					}
+				}
+			}
+
+			const float bias = 0.5f / density;
+			std::vector<Vector3> direct(texels.size());
+			std::vector<bool> covered(texels.size());
+			for (size_t i = 0; i < texels.size(); ++i) covered[i] = texels[i].covered;
+			JobSystem::Instance().ParallelFor(static_cast<size_t>(size), 8, [&](size_t begin, size_t end) {
+				for (size_t i = begin * size; i < end * size; ++i) {
+					if (texels[i].covered) direct[i] = Direct(bvh, texels[i], lights, lightCount, s, bias);
+				}
+			});
+			Dilate(direct, covered, size, s.padding);
+
+			std::vector<Vector3> light(texels.size());
+			JobSystem::Instance().ParallelFor(static_cast<size_t>(size), 8, [&](size_t begin, size_t end) {
+				for (size_t i = begin * size; i < end * size; ++i) {
+					const Texel& t = texels[i];
+					if (!t.covered) continue;
+					const Vector3 origin = Vector3Add(t.position, Vector3Scale(t.normal, bias));
+					const float spin = fmodf(static_cast<float>(i) * 0.754877f, 1.0f);
+					Vector3 gathered{};
+					for (int k = 0; k < s.bounceSamples; ++k) {
+						const Vector3 dir = CosineSample(t.normal, k, s.bounceSamples, spin);
+						const Hit hit = bvh.Trace(origin, dir, INFINITY);
+						if (hit.triangle < 0) {
+							gathered = Vector3Add(gathered, s.sky);
+							continue;
+						}
+						const Triangle& h = bvh.Get(hit.triangle);
+						if (Vector3DotProduct(h.normal, dir) > 0.0f) continue;  // the inside of something
+						const Vector2 at = Vector2Add(Vector2Add(Vector2Scale(h.ta, 1.0f - hit.u - hit.v), Vector2Scale(h.tb, hit.u)), Vector2Scale(h.tc, hit.v));
+						const int hx = std::clamp(static_cast<int>(at.x), 0, size - 1), hy = std::clamp(static_cast<int>(at.y), 0, size - 1);
+						gathered = Vector3Add(gathered, Vector3Scale(direct[static_cast<size_t>(hy) * size + hx], s.albedo));
+					}
+					light[i] = Vector3Add(direct[i], Vector3Scale(gathered, 1.0f / static_cast<float>(s.bounceSamples)));
+				}
+			});
+			Dilate(light, covered, size, s.padding);
+
+			image = GenImageColor(size, size, BLACK);
+			unsigned char* pixels = static_cast<unsigned char*>(image.data);
+			for (size_t i = 0; i < light.size(); ++i) {
+				pixels[i * 4] = static_cast<unsigned char>(powf(Clamp(light[i].x, 0.0f, 1.0f), 1.0f / 2.2f) * 255.0f + 0.5f);
+				pixels[i * 4 + 1] = static_cast<unsigned char>(powf(Clamp(light[i].y, 0.0f, 1.0f), 1.0f / 2.2f) * 255.0f + 0.5f);
+				pixels[i * 4 + 2] = static_cast<unsigned char>(powf(Clamp(light[i].z, 0.0f, 1.0f), 1.0f / 2.2f) * 255.0f + 0.5f);
+			}
+			scene.charts = static_cast<int>(charts.size());
+			scene.texels = static_cast<int>(std::count(covered.begin(), covered.end(), true));
+			scene.texelsPerUnit = density;
+			return true;
+		}
+	}
+
+	// The `count` models, drawn with `transforms`, baked under `lights`: from the cache if
+	// nothing changed, else unwrapped, lit and cooked. The inputs need their CPU mesh data
+	// and are left as they are. Empty models and no lightmap if baking failed.
+	inline Scene Bake(const Model* const* models, const Matrix* transforms, int count, const Light* lights, int lightCount, const Settings& settings = Settings{}) {
+		const double start = GetTime();
+		Scene scene;
+		const uint64_t key = Detail::SceneKey(models, transforms, count, lights, lightCount, settings);
+		scene.lightmap = AssetCache::Detail::ReadTexture(key);
+		if (scene.lightmap.id != 0) {
+			for (int o = 0; o < count; ++o) {
+				Model model = AssetCache::Detail::ReadModel(Detail::ModelKey(key, o), true);
+				if (model.meshCount == 0) break;
+				scene.models.push_back(model);
+			}
+			if (static_cast<int>(scene.models.size()) == count) {
+				scene.cached = true;
+				SetTextureFilter(scene.lightmap, TEXTURE_FILTER_BILINEAR);
+				TraceLog(LOG_INFO, "LIGHTMAP: %i model(s) mapped from the asset cache", count);
+				return scene;
+			}
+			for (Model& m : scene.models) UnloadModel(m);
+			scene.models.clear();
+			UnloadTexture(scene.lightmap);
+		}
+
+		Image image{};
+		if (!Detail::Compute(models, transforms, count, lights, lightCount, settings, scene, image)) {
+			TraceLog(LOG_WARNING, "LIGHTMAP: the scene's charts don't fit a %i x %i atlas", settings.size, settings.size);
+			for (Model& m : scene.models) UnloadModel(m);
+			return Scene{};
+		}
+		AssetCache::Detail::CookTexture(key, image);
+		for (int o = 0; o < count; ++o) {
+			AssetCache::Detail::CookModel(Detail::ModelKey(key, o), scene.models[o]);
+			for (int m = 0; m < scene.models[o].meshCount; ++m) {
+				if (scene.models[o].meshes[m].vertexCount > 0) UploadMesh(&scene.models[o].meshes[m], false);
+			}
+		}
+		scene.lightmap = LoadTextureFromImage(image);
+		SetTextureFilter(scene.lightmap, TEXTURE_FILTER_BILINEAR);
+		UnloadImage(image);
+		TraceLog(LOG_INFO, "LIGHTMAP: %i chart(s), %i texel(s) at %.2f per unit, baked in %.1f ms", scene.charts, scene.texels, scene.texelsPerUnit, (GetTime() - start) * 1000.0);
+		return scene;
+	}
+
+	inline void Unload(Scene& scene) {
+		for (Model& m : scene.models) UnloadModel(m);
+		UnloadTexture(scene.lightmap);
+		scene = Scene{};
+	}
+}
+
+#endif // LIGHTMAP_BAKER_H
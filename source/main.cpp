@@ -1,678 +1,6981 @@
-﻿#include <vector>
-#include <algorithm>
-#include <functional> 
-#include <memory>
-#include <cstdlib>
-#include <cmath>
-#include <ctime>
-
-#include <raylib.h>
-#include <raymath.h>
-
-// --- UTILS ---
-namespace Utils {
-	inline static float RandomFloat(float min, float max) {
-		return min + static_cast<float>(rand()) / RAND_MAX * (max - min);
-	}
-}
-
-// --- TRANSFORM, PHYSICS, LIFETIME, RENDERABLE ---
-struct TransformA {
-	Vector2 position{};
-	float rotation{};
-};
-
-struct Physics {
-	Vector2 velocity{};
-	float rotationSpeed{};
-};
-
-struct Renderable {
-	enum Size { SMALL = 1, MEDIUM = 2, LARGE = 4 } size = SMALL;
-};
-
-// --- RENDERER ---
-class Renderer {
-public:
-	static Renderer& Instance() {
-		static Renderer inst;
-		return inst;
-	}
-
-	void Init(int w, int h, const char* title) {
-		InitWindow(w, h, title);
-		SetTargetFPS(60);
-		screenW = w;
-		screenH = h;
-	}
-
-	void Begin() {
-		BeginDrawing();
-		ClearBackground(BLACK);
-	}
-
-	void End() {
-		EndDrawing();
-	}
-
-	void DrawPoly(const Vector2& pos, int sides, float radius, float rot) {
-		DrawPolyLines(pos, sides, radius, rot, RED);
-	}
-
-	int Width() const {
-		return screenW;
-	}
-
-	int Height() const {
-		return screenH;
-	}
-
-private:
-	Renderer() = default;
-
-	int screenW{};
-	int screenH{};
-};
-
-// --- ASTEROID HIERARCHY ---
-
-class Asteroid {
-public:
-	Asteroid(int screenW, int screenH) {
-		init(screenW, screenH);
-	}
-	virtual ~Asteroid() = default;
-
-	bool Update(float dt) {
-		transform.position = Vector2Add(transform.position, Vector2Scale(physics.velocity, dt));
-		transform.rotation += physics.rotationSpeed * dt;
-		if (transform.position.x < -GetRadius() || transform.position.x > Renderer::Instance().Width() + GetRadius() ||
-			transform.position.y < -GetRadius() || transform.position.y > Renderer::Instance().Height() + GetRadius())
-			return false;
-		return true;
-	}
-	virtual void Draw() const = 0;
-
-	Vector2 GetPosition() const {
-		return transform.position;
-	}
-
-	float constexpr GetRadius() const {
-		return 16.f * (float)render.size;
-	}
-
-	int GetDamage() const {
-		return baseDamage * static_cast<int>(render.size);
-	}
-
-	int GetSize() const {
-		return static_cast<int>(render.size);
-	}
-
-protected:
-	void init(int screenW, int screenH) {
-
-		render.size = static_cast<Renderable::Size>(1 << GetRandomValue(0, 2));
-
-		switch (GetRandomValue(0, 3)) {
-		case 0:
-			transform.position = { Utils::RandomFloat(0, screenW), -GetRadius() };
-			break;
-		case 1:
-			transform.position = { screenW + GetRadius(), Utils::RandomFloat(0, screenH) };
-			break;
-		case 2:
-			transform.position = { Utils::RandomFloat(0, screenW), screenH + GetRadius() };
-			break;
-		default:
-			transform.position = { -GetRadius(), Utils::RandomFloat(0, screenH) };
-			break;
-		}
-
-		float maxOff = fminf(screenW, screenH) * 0.1f;
-		float ang = Utils::RandomFloat(0, 2 * PI);
-		float rad = Utils::RandomFloat(0, maxOff);
-		Vector2 center = {
-										 screenW * 0.5f + cosf(ang) * rad,
-										 screenH * 0.5f + sinf(ang) * rad
-		};
-
-		Vector2 dir = Vector2Normalize(Vector2Subtract(center, transform.position));
-		physics.velocity = Vector2Scale(dir, Utils::RandomFloat(SPEED_MIN, SPEED_MAX));
-		physics.rotationSpeed = Utils::RandomFloat(ROT_MIN, ROT_MAX);
-
-		transform.rotation = Utils::RandomFloat(0, 360);
-	}
-
-	TransformA transform;
-	Physics    physics;
-	Renderable render;
-
-	int baseDamage = 0;
-	static constexpr float LIFE = 10.f;
-	static constexpr float SPEED_MIN = 125.f;
-	static constexpr float SPEED_MAX = 250.f;
-	static constexpr float ROT_MIN = 50.f;
-	static constexpr float ROT_MAX = 240.f;
-};
-
-class TriangleAsteroid : public Asteroid {
-public:
-	TriangleAsteroid(int w, int h) : Asteroid(w, h) { baseDamage = 5; }
-	void Draw() const override {
-		Renderer::Instance().DrawPoly(transform.position, 3, GetRadius(), transform.rotation);
-	}
-};
-class SquareAsteroid : public Asteroid {
-public:
-	SquareAsteroid(int w, int h) : Asteroid(w, h) { baseDamage = 10; }
-	void Draw() const override {
-		Renderer::Instance().DrawPoly(transform.position, 4, GetRadius(), transform.rotation);
-	}
-};
-class PentagonAsteroid : public Asteroid {
-public:
-	PentagonAsteroid(int w, int h) : Asteroid(w, h) { baseDamage = 15; }
-	void Draw() const override {
-		Renderer::Instance().DrawPoly(transform.position, 5, GetRadius(), transform.rotation);
-	}
-};
-
-
-enum class AsteroidShape { TRIANGLE = 3, SQUARE = 4, PENTAGON = 5, RANDOM = 0 };
-
-
-static inline std::unique_ptr<Asteroid> MakeAsteroid(int w, int h, AsteroidShape shape) {
-	switch (shape) {
-	case AsteroidShape::TRIANGLE:
-		return std::make_unique<TriangleAsteroid>(w, h);
-	case AsteroidShape::SQUARE:
-		return std::make_unique<SquareAsteroid>(w, h);
-	case AsteroidShape::PENTAGON:
-		return std::make_unique<PentagonAsteroid>(w, h);
-	default: {
-		return MakeAsteroid(w, h, static_cast<AsteroidShape>(3 + GetRandomValue(0, 2)));
-	}
-	}
-}
-
-// --- PROJECTILE HIERARCHY ---
-enum class WeaponType { LASER, BULLET, COUNT };
-class Projectile {
-public:
-	Projectile(Vector2 pos, Vector2 vel, int dmg, WeaponType wt)
-	{
-		transform.position = pos;
-		physics.velocity = vel;
-		baseDamage = dmg;
-		type = wt;
-	}
-	bool Update(float dt) {
-		transform.position = Vector2Add(transform.position, Vector2Scale(physics.velocity, dt));
-
-		if (transform.position.x < 0 ||
-			transform.position.x > Renderer::Instance().Width() ||
-			transform.position.y < 0 ||
-			transform.position.y > Renderer::Instance().Height())
-		{
-			return true;
-		}
-		return false;
-	}
-	void Draw() const {
-		if (type == WeaponType::BULLET) {
-			DrawCircleV(transform.position, 5.f, WHITE);
-		}
-		else {
-			static constexpr float LASER_LENGTH = 30.f;
-			Rectangle lr = { transform.position.x - 2.f, transform.position.y - LASER_LENGTH, 4.f, LASER_LENGTH };
-			DrawRectangleRec(lr, RED);
-		}
-	}
-	Vector2 GetPosition() const {
-		return transform.position;
-	}
-
-	float GetRadius() const {
-		return (type == WeaponType::BULLET) ? 5.f : 2.f;
-	}
-
-	int GetDamage() const {
-		return baseDamage;
-	}
-
-private:
-	TransformA transform;
-	Physics    physics;
-	int        baseDamage;
-	WeaponType type;
-};
-
-inline static Projectile MakeProjectile(WeaponType wt, const Vector2 pos, float speed, float rotationDeg)
-{
-    float rotationRad = DEG2RAD * rotationDeg;
-    Vector2 dir = { sinf(rotationRad), -cosf(rotationRad) };
-    Vector2 vel = Vector2Scale(dir, speed);
-	if (wt == WeaponType::LASER) {
-		return Projectile(pos, vel, 20, wt);
-	}
-	else {
-		return Projectile(pos, vel, 10, wt);
-	}
-}
-
-// --- SHIP HIERARCHY ---
-class Ship {
-public:
-    Ship(int screenW, int screenH)
-        : parent(nullptr), orbitRadius(0), orbitAngle(0), score(0)
-    {
-        transform.position = {
-            screenW * 0.5f,
-            screenH * 0.5f
-        };
-        hp = 100;
-        speed = 250.f;
-        alive = true;
-
-        fireRateLaser = 18.f;
-        fireRateBullet = 22.f;
-        spacingLaser = 40.f;
-        spacingBullet = 20.f;
-    }
-    virtual ~Ship() = default;
-    virtual void Update(float dt) = 0;
-    virtual void Draw() const = 0;
-
-    void TakeDamage(int dmg) {
-        if (!alive) return;
-        hp -= dmg;
-        if (hp <= 0) alive = false;
-    }
-
-    bool IsAlive() const {
-        return alive;
-    }
-
-    Vector2 GetPosition() const {
-        return transform.position;
-    }
-
-    virtual float GetRadius() const = 0;
-
-	virtual float GetRotation() const = 0;
-
-    int GetHP() const {
-        return hp;
-    }
-
-    float GetFireRate(WeaponType wt) const {
-        return (wt == WeaponType::LASER) ? fireRateLaser : fireRateBullet;
-    }
-
-    float GetSpacing(WeaponType wt) const {
-        return (wt == WeaponType::LASER) ? spacingLaser : spacingBullet;
-    }
-
-    int GetScore() const { return score; }
-    void AddScore(int s) { score += s; }
-
-    void SetParent(Ship* p, float radius, float angle) {
-        parent = p;
-        orbitRadius = radius;
-        orbitAngle = angle;
-    }
-
-    void UpdateOrbit(float dt) {
-        if (parent) {
-            orbitAngle += dt * 1.0f;
-            Vector2 parentPos = parent->GetPosition();
-            transform.position = {
-                parentPos.x + orbitRadius * cosf(orbitAngle),
-                parentPos.y + orbitRadius * sinf(orbitAngle)
-            };
-        }
-    }
-
-
-    void Ship::UpdateOrbiters(float dt) {
-		for (auto& orb : orbiters) {
-			orb->UpdateOrbit(dt);
-			orb->Update(dt);
-			orb->UpdateOrbiters(dt);
-		}
-		orbiters.erase(
-			std::remove_if(orbiters.begin(), orbiters.end(),
-				[](const std::unique_ptr<Ship>& orb) { return !orb->IsAlive(); }),
-			orbiters.end()
-    );
-}
-    void DrawOrbiters() const {
-        for (const auto& orb : orbiters) {
-            orb->Draw();
-            orb->DrawOrbiters();
-        }
-    }
-
-    void ShootAll(std::vector<Projectile>& projectiles, WeaponType currentWeapon, float& shotTimer, float dt) {
-        if (!IsAlive()) return;
-        shotTimer += dt;
-        float interval = 1.f / GetFireRate(currentWeapon);
-        float projSpeed = GetSpacing(currentWeapon) * GetFireRate(currentWeapon);
-
-        while (shotTimer >= interval) {
-            Vector2 shipPos = GetPosition();
-            float rotDeg = GetRotation();
-            float rotRad = DEG2RAD * rotDeg;
-            Vector2 localOffset = { 0.f, -GetRadius() };
-            Vector2 rotatedOffset = {
-                localOffset.x * cosf(rotRad) - localOffset.y * sinf(rotRad),
-                localOffset.x * sinf(rotRad) + localOffset.y * cosf(rotRad)
-            };
-            Vector2 p = Vector2Add(shipPos, rotatedOffset);
-            projectiles.push_back(MakeProjectile(currentWeapon, p, projSpeed, GetRotation()));
-            shotTimer -= interval;
-        }
-        for (auto& orb : orbiters) {
-            orb->ShootAll(projectiles, currentWeapon, shotTimer, dt);
-        }
-    }
-
-
-    void GetAllShips(std::vector<Ship*>& out) {
-        out.push_back(this);
-        for (auto& orb : orbiters) {
-            orb->GetAllShips(out);
-        }
-    }
-
-    void TrySpawnOrbiter(int screenW, int screenH, int scoreThreshold, Texture2D* sharedTexture = nullptr);
-
-protected:
-    TransformA transform;
-    int        hp;
-    float      speed;
-    bool       alive;
-    float      fireRateLaser;
-    float      fireRateBullet;
-    float      spacingLaser;
-    float      spacingBullet;
-
-
-    Ship* parent;
-    float orbitRadius;
-    float orbitAngle;
-    std::vector<std::unique_ptr<Ship>> orbiters;
-
-    int score;
-};
--
-class PlayerShip : public Ship {
-public:
-    PlayerShip(int w, int h, Texture2D* sharedTex = nullptr, float scale_ = 0.3f) : Ship(w, h), scale(scale_) {
-        if (sharedTex) {
-            texture = *sharedTex;
-            ownsTexture = false;
-        } else {
-            texture = LoadTexture("spaceship1.png");
-            GenTextureMipmaps(&texture);
-            SetTextureFilter(texture, 2);
-            ownsTexture = true;
-        }
-    }
-    ~PlayerShip() {
-        if (ownsTexture) UnloadTexture(texture);
-    }
-
-    void Update(float dt) override {
-        if (!parent) {
-            if (alive) {
-                if (IsKeyDown(KEY_W)) transform.position.y -= speed * dt;
-                if (IsKeyDown(KEY_S)) transform.position.y += speed * dt;
-                if (IsKeyDown(KEY_A)) transform.position.x -= speed * dt;
-                if (IsKeyDown(KEY_D)) transform.position.x += speed * dt;
-                if (IsKeyDown(KEY_Q)) rotation -= 180.0f * dt;
-                if (IsKeyDown(KEY_E)) rotation += 180.0f * dt;
-            }
-            else {
-                transform.position.y += speed * dt;
-            }
-        }
-
-    }
-
-    void Draw() const override {
-        if (!alive && fmodf(GetTime(), 0.4f) > 0.2f) return;
-        Vector2 center = {
-            (texture.width * scale) * 0.5f,
-            (texture.height * scale) * 0.5f
-        };
-        DrawTexturePro(
-            texture,
-            Rectangle{ 0, 0, (float)texture.width, (float)texture.height },
-            Rectangle{ transform.position.x, transform.position.y, texture.width * scale, texture.height * scale },
-            center,
-            rotation,
-            WHITE
-        );
-    }
-
-    float GetRadius() const override {
-        return (texture.width * scale) * 0.5f;
-    }
-
-    float GetRotation() const {
-        return rotation;
-    }
-
-private:
-    Texture2D texture;
-    float     scale;
-    float rotation = 0.0f;
-    bool ownsTexture = true;
-};
-void Ship::TrySpawnOrbiter(int screenW, int screenH, int scoreThreshold, Texture2D* sharedTexture) {
-    if (score >= scoreThreshold && orbiters.empty()) {
-        auto orb = std::make_unique<PlayerShip>(screenW, screenH, sharedTexture, 0.18f);
-        orb->SetParent(this, GetRadius() + 60.f, 0.f);
-        orbiters.push_back(std::move(orb));
-    }
-    for (auto& orb : orbiters) {
-        orb->TrySpawnOrbiter(screenW, screenH, scoreThreshold, sharedTexture);
-    }
-}
-
-// --- APPLICATION ---
-class Application {
-public:
-    static Application& Instance() {
-        static Application inst;
-        return inst;
-    }
-
-    void Run() {
-        srand(static_cast<unsigned>(time(nullptr)));
-        Renderer::Instance().Init(C_WIDTH, C_HEIGHT, "Asteroids OOP");
-
-        Texture2D sharedTex = LoadTexture("spaceship1.png");
-        GenTextureMipmaps(&sharedTex);
-        SetTextureFilter(sharedTex, 2);
-
-        auto player = std::make_unique<PlayerShip>(C_WIDTH, C_HEIGHT, &sharedTex);
-
-        float spawnTimer = 0.f;
-        float spawnInterval = Utils::RandomFloat(C_SPAWN_MIN, C_SPAWN_MAX);
-        WeaponType currentWeapon = WeaponType::LASER;
-        float shotTimer = 0.f;
-
-        const int SCORE_THRESHOLD = 3;
-
-        while (!WindowShouldClose()) {
-            float dt = GetFrameTime();
-            spawnTimer += dt;
-
-
-            player->Update(dt);
-            player->UpdateOrbiters(dt);
-
-            if (!player->IsAlive() && IsKeyPressed(KEY_R)) {
-                player = std::make_unique<PlayerShip>(C_WIDTH, C_HEIGHT, &sharedTex);
-                asteroids.clear();
-                projectiles.clear();
-                spawnTimer = 0.f;
-                spawnInterval = Utils::RandomFloat(C_SPAWN_MIN, C_SPAWN_MAX);
-            }
-
-            if (IsKeyPressed(KEY_ONE)) {
-                currentShape = AsteroidShape::TRIANGLE;
-            }
-            if (IsKeyPressed(KEY_TWO)) {
-                currentShape = AsteroidShape::SQUARE;
-            }
-            if (IsKeyPressed(KEY_THREE)) {
-                currentShape = AsteroidShape::PENTAGON;
-            }
-            if (IsKeyPressed(KEY_FOUR)) {
-                currentShape = AsteroidShape::RANDOM;
-            }
-
-
-            if (IsKeyPressed(KEY_TAB)) {
-                currentWeapon = static_cast<WeaponType>((static_cast<int>(currentWeapon) + 1) % static_cast<int>(WeaponType::COUNT));
-            }
-
-
-            if (player->IsAlive() && IsKeyDown(KEY_SPACE)) {
-                player->ShootAll(projectiles, currentWeapon, shotTimer, dt);
-            }
-            else {
-                float maxInterval = 1.f / player->GetFireRate(currentWeapon);
-                if (shotTimer > maxInterval) {
-                    shotTimer = fmodf(shotTimer, maxInterval);
-                }
-            }
-
-
-            if (spawnTimer >= spawnInterval && asteroids.size() < MAX_AST) {
-                asteroids.push_back(MakeAsteroid(C_WIDTH, C_HEIGHT, currentShape));
-                spawnTimer = 0.f;
-                spawnInterval = Utils::RandomFloat(C_SPAWN_MIN, C_SPAWN_MAX);
-            }
-
-
-            {
-                auto projectile_to_remove = std::remove_if(projectiles.begin(), projectiles.end(),
-                    [dt](auto& projectile) {
-                        return projectile.Update(dt);
-                    });
-                projectiles.erase(projectile_to_remove, projectiles.end());
-            }
-
-
-            std::vector<Ship*> allShips;
-            player->GetAllShips(allShips);
-
-            for (auto pit = projectiles.begin(); pit != projectiles.end();) {
-                bool removed = false;
-
-                for (auto ait = asteroids.begin(); ait != asteroids.end(); ++ait) {
-                    float dist = Vector2Distance((*pit).GetPosition(), (*ait)->GetPosition());
-                    if (dist < (*pit).GetRadius() + (*ait)->GetRadius()) {
-                        Ship* closest = nullptr;
-                        float minDist = 1e9f;
-                        for (auto* s : allShips) {
-                            float d = Vector2Distance(s->GetPosition(), pit->GetPosition());
-                            if (d < minDist) { minDist = d; closest = s; }
-                        }
-                        if (closest) closest->AddScore(1);
-
-                        ait = asteroids.erase(ait);
-                        pit = projectiles.erase(pit);
-                        removed = true;
-                        break;
-                    }
-                }
-                if (!removed) {
-                    ++pit;
-                }
-            }
-
-            {
-                auto remove_collision =
-                    [&allShips, dt](auto& asteroid_ptr_like) -> bool {
-                    for (auto* player : allShips) {
-                        if (player->IsAlive()) {
-                            float dist = Vector2Distance(player->GetPosition(), asteroid_ptr_like->GetPosition());
-                            if (dist < player->GetRadius() + asteroid_ptr_like->GetRadius()) {
-                                player->TakeDamage(asteroid_ptr_like->GetDamage());
-                                return true;
-                            }
-                        }
-                    }
-                    if (!asteroid_ptr_like->Update(dt)) {
-                        return true;
-                    }
-                    return false;
-                };
-                auto asteroid_to_remove = std::remove_if(asteroids.begin(), asteroids.end(), remove_collision);
-                asteroids.erase(asteroid_to_remove, asteroids.end());
-            }
-
-
-            player->TrySpawnOrbiter(C_WIDTH, C_HEIGHT, SCORE_THRESHOLD, &sharedTex);
-
-            {
-                Renderer::Instance().Begin();
-
-                DrawText(TextFormat("HP: %d", player->GetHP()),
-                    10, 10, 20, GREEN);
-
-                const char* weaponName = (currentWeapon == WeaponType::LASER) ? "LASER" : "BULLET";
-                DrawText(TextFormat("Weapon: %s", weaponName),
-                    10, 40, 20, BLUE);
-
-                DrawText(TextFormat("Score: %d", player->GetScore()),
-                    10, 70, 20, YELLOW);
-
-                for (const auto& projPtr : projectiles) {
-                    projPtr.Draw();
-                }
-                for (const auto& astPtr : asteroids) {
-                    astPtr->Draw();
-                }
-
-                player->Draw();
-                player->DrawOrbiters();
-
-                Renderer::Instance().End();
-            }
-        }
-        UnloadTexture(sharedTex);
-    }
-
-private:
-    Application()
-    {
-        asteroids.reserve(1000);
-        projectiles.reserve(10'000);
-    };
-
-    std::vector<std::unique_ptr<Asteroid>> asteroids;
-    std::vector<Projectile> projectiles;
-
-    AsteroidShape currentShape = AsteroidShape::TRIANGLE;
-
-    static constexpr int C_WIDTH = 1600;
-    static constexpr int C_HEIGHT = 1600;
-    static constexpr size_t MAX_AST = 150;
-    static constexpr float C_SPAWN_MIN = 0.5f;
-    static constexpr float C_SPAWN_MAX = 3.0f;
-
-    static constexpr int C_MAX_ASTEROIDS = 1000;
-    static constexpr int C_MAX_PROJECTILES = 10'000;
-};
-
-int main() {
-	Application::Instance().Run();
-	return 0;
-}
+﻿#include <vector>
+#include <array>
+#include <algorithm>
+#include <functional> 
+#include <utility>
+#include <cstdlib>
+#include <cstdint>
+#include <atomic>
+#include <cstddef>
+#include <cmath>
+#include <ctime>
+#include <chrono>
+#include <bit>
+#include <thread>
+#include <string>
+#include <memory>
+
+#include <raylib.h>
+#include <raymath.h>
+#include <rlgl.h>
+#include <external/glad.h>
+
+#include "jobs.h"
+#include "simd.h"
+#include "simd_vector.h"
+#include "profiler.h"
+#include "gpu_profiler.h"
+#include "replay.h"
+#include "scenario.h"
+#include "ecs.h"
+#include "snapshot.h"
+#include "shader_cache.h"
+#include "async_loader.h"
+#include "asset_archive.h"
+#include "screen_capture.h"
+#include "gif_recorder.h"
+#include "sound_effects.h"
+#include "music_stream.h"
+#include "collision_events.h"
+#include "memory_tracker.h"
+#include "frame_arena.h"
+#include "frame_times.h"
+#include "fixed_point.h"
+#include "replication.h"
+#include "world_snapshot.h"
+#include "resource_cache.h"
+#include "frame_governor.h"
+#include "sector_map.h"
+#include "startup_profile.h"
+#include "frame_graph.h"
+#include "gpu_swarm.h"
+#include "spatial_order.h"
+#include "handles.h"
+#include "soak_monitor.h"
+#include "sampler_presets.h"
+#include "telemetry.h"
+
+#include <new>
+
+// --- HEAP ---
+// Every new and delete of the program goes through MemoryTracker, tagged with the calling
+// thread's MEMORY_SCOPE. The aligned forms keep the standard library's own pair.
+void* operator new(size_t size) {
+	if (void* p = MemoryTracker::Allocate(size)) return p;
+	throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+	return operator new(size);
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+	return MemoryTracker::Allocate(size);
+}
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+	return MemoryTracker::Allocate(size);
+}
+void operator delete(void* p) noexcept {
+	MemoryTracker::Free(p);
+}
+void operator delete[](void* p) noexcept {
+	MemoryTracker::Free(p);
+}
+void operator delete(void* p, size_t) noexcept {
+	MemoryTracker::Free(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+	MemoryTracker::Free(p);
+}
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+	MemoryTracker::Free(p);
+}
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+	MemoryTracker::Free(p);
+}
+
+// --- UTILS ---
+namespace Utils {
+	// PCG32 (XSH-RR). Eight bytes of state plus a stream selector, so independent generators
+	// can share one seed: stream k of seed s never overlaps stream j of the same seed.
+	class Rng {
+	public:
+		explicit Rng(uint64_t seed = 0x853c49e6748fea9bULL, uint64_t stream = 0) {
+			Seed(seed, stream);
+		}
+
+		void Seed(uint64_t seed, uint64_t stream = 0) {
+			state = 0;
+			inc = (stream << 1u) | 1u;
+			NextU32();
+			state += seed;
+			NextU32();
+		}
+
+		uint32_t NextU32() {
+			uint64_t old = state;
+			state = old * 6364136223846793005ULL + inc;
+			uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+			uint32_t rot = static_cast<uint32_t>(old >> 59u);
+			return (xorshifted >> rot) | (xorshifted << ((~rot + 1u) & 31u));
+		}
+
+		// Uniform in [0, 1), built from the top 24 bits so every value is exact in a float.
+		float NextFloat01() {
+			return static_cast<float>(NextU32() >> 8) * (1.f / 16777216.f);
+		}
+
+		float NextFloat(float min, float max) {
+			return min + NextFloat01() * (max - min);
+		}
+
+		// Uniform in [min, max], inclusive like raylib's GetRandomValue.
+		int NextInt(int min, int max) {
+			uint32_t span = static_cast<uint32_t>(max - min) + 1u;
+			return min + static_cast<int>((static_cast<uint64_t>(NextU32()) * span) >> 32);
+		}
+
+		void Fill(float* out, size_t n, float min, float max) {
+			for (size_t i = 0; i < n; ++i) out[i] = NextFloat(min, max);
+		}
+
+	private:
+		uint64_t state;
+		uint64_t inc;
+	};
+
+	namespace Detail {
+		inline std::atomic<uint64_t> randomSeed{ 0x853c49e6748fea9bULL };
+		inline std::atomic<uint32_t> randomEpoch{ 0 };
+		inline std::atomic<uint64_t> nextStream{ 1 };
+		inline thread_local Rng*     boundRng = nullptr;
+	}
+
+	// The calling thread's generator, or the one an RngScope has bound to it.
+	inline Rng& ThreadRng() {
+		if (Detail::boundRng) return *Detail::boundRng;
+		struct Local {
+			Rng      rng;
+			uint32_t epoch = ~0u;
+			uint64_t stream = Detail::nextStream.fetch_add(1, std::memory_order_relaxed);
+		};
+		thread_local Local local;
+		uint32_t epoch = Detail::randomEpoch.load(std::memory_order_acquire);
+		if (local.epoch != epoch) {
+			local.epoch = epoch;
+			local.rng.Seed(Detail::randomSeed.load(std::memory_order_relaxed), local.stream);
+		}
+		return local.rng;
+	}
+
+	// Reseeds every thread's generator. The calling thread gets stream 0 of `seed`, so a
+	// single-threaded run replays exactly; other threads pick a fresh stream on next use.
+	// Work that must replay across threads should own an Rng(seed, chunkIndex) instead.
+	inline void SeedRandom(uint64_t seed) {
+		Detail::randomSeed.store(seed, std::memory_order_relaxed);
+		Detail::randomEpoch.fetch_add(1, std::memory_order_release);
+		ThreadRng().Seed(seed, 0);
+	}
+
+	// Draws the calling thread's Random* calls from `rng` until the end of the scope, so
+	// state that owns its generator (a World) replays the same on whichever thread steps it.
+	class RngScope {
+	public:
+		explicit RngScope(Rng& rng) : previous(Detail::boundRng) {
+			Detail::boundRng = &rng;
+		}
+		~RngScope() {
+			Detail::boundRng = previous;
+		}
+
+		RngScope(const RngScope&) = delete;
+		RngScope& operator=(const RngScope&) = delete;
+
+	private:
+		Rng* previous;
+	};
+
+	inline static float RandomFloat(float min, float max) {
+		return ThreadRng().NextFloat(min, max);
+	}
+
+	inline static int RandomInt(int min, int max) {
+		return ThreadRng().NextInt(min, max);
+	}
+
+	inline static void RandomFill(float* out, size_t n, float min, float max) {
+		ThreadRng().Fill(out, n, min, max);
+	}
+
+	// Uniform raw fixed-point value in [min, max), of any Fixed format.
+	inline static int32_t RandomFixed(int32_t min, int32_t max) {
+		return Fixed::Uniform(ThreadRng().NextU32(), min, max);
+	}
+
+	// Removes every element flagged in `dead` by moving the last live element into its slot.
+	// Order is not preserved; only the removed slots are written to.
+	template<typename T>
+	inline static void SwapAndPop(std::vector<T>& items, std::vector<char>& dead) {
+		size_t i = 0;
+		while (i < items.size()) {
+			if (dead[i]) {
+				size_t last = items.size() - 1;
+				if (i != last) {
+					items[i] = std::move(items[last]);
+					dead[i] = dead[last];
+				}
+				items.pop_back();
+				dead.pop_back();
+			}
+			else {
+				++i;
+			}
+		}
+	}
+}
+
+// --- CONSTEXPR TRIG ---
+// Compile-time sine/cosine for building constant tables; runtime code keeps using sinf/cosf.
+namespace Trig {
+	inline constexpr double C_PI = 3.14159265358979323846;
+
+	constexpr double Sin(double x) {
+		while (x > C_PI) x -= 2.0 * C_PI;
+		while (x < -C_PI) x += 2.0 * C_PI;
+		double term = x;
+		double sum = x;
+		for (int n = 1; n < 12; ++n) {
+			term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+			sum += term;
+		}
+		return sum;
+	}
+
+	constexpr double Cos(double x) {
+		return Sin(x + C_PI * 0.5);
+	}
+}
+
+// --- TRANSFORM, PHYSICS, LIFETIME, RENDERABLE ---
+struct TransformA {
+	Vector2 position{};
+	float rotation{};
+};
+
+struct Physics {
+	Vector2 velocity{};
+	float rotationSpeed{};
+};
+
+struct Renderable {
+	enum Size { SMALL = 1, MEDIUM = 2, LARGE = 4 } size = SMALL;
+};
+
+// Playfield extents as plain data, so the simulation never has to ask the window.
+struct WorldBounds {
+	float width{};
+	float height{};
+};
+
+// --- RENDERER ---
+// The part of the world a frame shows, in world units, and how many pixels one unit
+// covers. Renderers cull against it and pick detail from it. The camera frames the
+// playfield unless a streaming world scrolls it after the player (Renderer::SetCamera).
+struct View {
+	float minX = 0.f;
+	float minY = 0.f;
+	float maxX = 0.f;
+	float maxY = 0.f;
+	float pixelsPerUnit = 1.f;
+	float lodBias = 1.f;  // AsteroidLod's thresholds times this; above 1 coarsens (FrameGovernor)
+
+	// Whole screen of a w x h window seen through `camera`. Rotation is covered by taking
+	// the bounding box of the four corners.
+	static View Of(const Camera2D& camera, int w, int h) {
+		Vector2 corners[4] = {
+			GetScreenToWorld2D({ 0.f, 0.f }, camera),
+			GetScreenToWorld2D({ static_cast<float>(w), 0.f }, camera),
+			GetScreenToWorld2D({ 0.f, static_cast<float>(h) }, camera),
+			GetScreenToWorld2D({ static_cast<float>(w), static_cast<float>(h) }, camera),
+		};
+		View v;
+		v.minX = v.maxX = corners[0].x;
+		v.minY = v.maxY = corners[0].y;
+		for (const Vector2& c : corners) {
+			v.minX = fminf(v.minX, c.x); v.maxX = fmaxf(v.maxX, c.x);
+			v.minY = fminf(v.minY, c.y); v.maxY = fmaxf(v.maxY, c.y);
+		}
+		v.pixelsPerUnit = camera.zoom;
+		return v;
+	}
+
+	// False when a circle is entirely outside the view.
+	bool Sees(Vector2 c, float r) const {
+		return c.x + r >= minX && c.x - r <= maxX && c.y + r >= minY && c.y - r <= maxY;
+	}
+};
+
+class Renderer {
+public:
+	static constexpr int C_TARGET_FPS = 60;
+
+	static Renderer& Instance() {
+		static Renderer inst;
+		return inst;
+	}
+
+	void Init(int w, int h, const char* title) {
+		InitWindow(w, h, title);
+		SetTargetFPS(C_TARGET_FPS);
+		screenW = w;
+		screenH = h;
+	}
+
+	void Begin() {
+		BeginDrawing();
+		ClearBackground(BLACK);
+	}
+
+	// The frame's scratch is done with once it has been submitted.
+	void End() {
+		EndDrawing();
+		FrameArena::Instance().Reset();
+	}
+
+	void DrawPoly(const Vector2& pos, int sides, float radius, float rot) {
+		DrawPolyLines(pos, sides, radius, rot, RED);
+	}
+
+	int Width() const {
+		return screenW;
+	}
+
+	int Height() const {
+		return screenH;
+	}
+
+	// The world drawing's camera, the playfield at one pixel per unit until it is set.
+	void SetCamera(const Camera2D& c) {
+		camera = c;
+	}
+
+	const Camera2D& GetCamera() const {
+		return camera;
+	}
+
+	View CurrentView() const {
+		return View::Of(camera, screenW, screenH);
+	}
+
+private:
+	Renderer() = default;
+
+	int      screenW{};
+	int      screenH{};
+	Camera2D camera{ { 0.f, 0.f }, { 0.f, 0.f }, 0.f, 1.f };
+};
+
+// --- INPUT ---
+// Everything the simulation reads from the keyboard, as bits, handed over as FrameInputs
+// (see replay.h): `held` drives every tick of one, `pressed` edges are applied once before
+// them. InputTimeline cuts a rendered frame's ticks into as many FrameInputs as the input
+// asks for. Recording those two masks is enough to replay a session.
+namespace Input {
+	enum Bit : uint32_t {
+		UP             = 1u << 0,
+		DOWN           = 1u << 1,
+		LEFT           = 1u << 2,
+		RIGHT          = 1u << 3,
+		ROTATE_LEFT    = 1u << 4,
+		ROTATE_RIGHT   = 1u << 5,
+		FIRE           = 1u << 6,
+		RESTART        = 1u << 7,
+		SHAPE_TRIANGLE = 1u << 8,
+		SHAPE_SQUARE   = 1u << 9,
+		SHAPE_PENTAGON = 1u << 10,
+		SHAPE_RANDOM   = 1u << 11,
+		NEXT_WEAPON    = 1u << 12,
+	};
+
+	struct Binding {
+		Bit bit;
+		int key;
+	};
+
+	inline constexpr Binding C_HELD[] = {
+		{ UP, KEY_W }, { DOWN, KEY_S }, { LEFT, KEY_A }, { RIGHT, KEY_D },
+		{ ROTATE_LEFT, KEY_Q }, { ROTATE_RIGHT, KEY_E }, { FIRE, KEY_SPACE },
+	};
+
+	inline constexpr Binding C_PRESSED[] = {
+		{ RESTART, KEY_R },
+		{ SHAPE_TRIANGLE, KEY_ONE }, { SHAPE_SQUARE, KEY_TWO }, { SHAPE_PENTAGON, KEY_THREE }, { SHAPE_RANDOM, KEY_FOUR },
+		{ NEXT_WEAPON, KEY_TAB },
+	};
+
+	template<size_t N>
+	constexpr uint32_t MaskOf(const Binding (&bindings)[N]) {
+		uint32_t bits = 0;
+		for (const Binding& b : bindings) bits |= b.bit;
+		return bits;
+	}
+}
+
+// --- INPUT TIMELINE ---
+// Key changes stamped with when they were seen, so each simulation tick takes the input of
+// the moment it stands for instead of one sample per rendered frame. raylib only hears from
+// the OS when input is polled, which EndDrawing does once a frame; Pump() polls again in
+// the middle of one, so a slow frame stamps what arrived while it drew at about the time
+// it arrived rather than at its end. Slice() then hands a frame's ticks out as FrameInputs:
+// a new one wherever the held keys change or a key is pressed, the press landing on the
+// tick it fell in. A key counts as held for every tick it was down in at all, so a tap
+// shorter than a tick still moves the ship for one. Render thread only.
+class InputTimeline {
+public:
+	// The application's own keys, edge-triggered; they never reach the simulation.
+	enum AppBit : uint32_t {
+		APP_PROFILER   = 1u << 0,  // F3
+		APP_CAPTURE    = 1u << 1,  // F12, CTRL for a GIF
+		APP_BROADPHASE = 1u << 2,  // F4
+	};
+
+	// Forgets everything seen; keys down at `now` are held from then on.
+	void Reset(double now) {
+		events.clear();
+		observed = sliced = 0;
+		appDown = appPressed = 0;
+		Observe(now);
+		sliced = observed;
+		events.clear();
+	}
+
+	// Polls the OS here as well as in EndDrawing. raylib's IsKeyPressed misses the presses
+	// this sees, so every edge-triggered key goes through the timeline.
+	void Pump(double now) {
+		PollInputEvents();
+		Observe(now);
+	}
+
+	// Records what changed since the last look, at `now`. After every poll, before the next.
+	void Observe(double now) {
+		uint32_t down = 0, tapped = 0;
+		uint32_t app = 0, appTapped = 0;
+		for (const Input::Binding& b : Input::C_HELD) if (IsKeyDown(b.key)) down |= b.bit;
+		for (const Input::Binding& b : Input::C_PRESSED) if (IsKeyDown(b.key)) down |= b.bit;
+		for (const AppBinding& b : C_APP) if (IsKeyDown(b.key)) app |= b.bit;
+		// A key pressed and let go again between two polls is only in raylib's press queue.
+		for (int key = GetKeyPressed(); key != 0; key = GetKeyPressed()) {
+			for (const Input::Binding& b : Input::C_HELD) if (b.key == key) tapped |= b.bit;
+			for (const Input::Binding& b : Input::C_PRESSED) if (b.key == key) tapped |= b.bit;
+			for (const AppBinding& b : C_APP) if (b.key == key) appTapped |= b.bit;
+		}
+
+		for (uint32_t changed = (down ^ observed) | tapped; changed; changed &= changed - 1) {
+			const uint32_t bit = changed & (~changed + 1);
+			const bool was = (observed & bit) != 0, is = (down & bit) != 0;
+			if ((tapped & bit) && was) events.push_back({ now, bit, false });
+			if ((tapped & bit) || (is && !was)) events.push_back({ now, bit, true });
+			if (!is && (was || (tapped & bit))) events.push_back({ now, bit, false });
+		}
+		observed = down;
+		appPressed |= (app & ~appDown) | appTapped;
+		appDown = app;
+	}
+
+	// Splits the `ticks` ticks that end at `end` (the clock Observe was given) into
+	// FrameInputs in `out`, which has room for one per tick, and returns how many. A tick
+	// takes the events up to its own end; ones past `end` go to the last tick rather than
+	// wait a frame. No ticks still make one FrameInput, so a press is never lost.
+	int Slice(double end, int ticks, double tickDt, FrameInput* out) {
+		int count = 0;
+		size_t at = 0;
+		const int n = ticks > 0 ? ticks : 1;
+		for (int k = 0; k < n; ++k) {
+			const double until = k + 1 < n ? end - (n - 1 - k) * tickDt : INFINITY;
+			uint32_t held = sliced, pressed = 0;
+			for (; at < events.size() && events[at].time <= until; ++at) {
+				const Event& e = events[at];
+				if (e.down) {
+					sliced |= e.bit;
+					held |= e.bit;
+					pressed |= e.bit;
+				}
+				else {
+					sliced &= ~e.bit;
+				}
+			}
+			held &= C_HELD_MASK;
+			pressed &= C_PRESSED_MASK;
+			if (count > 0 && out[count - 1].held == held && pressed == 0) ++out[count - 1].ticks;
+			else out[count++] = { ticks > 0 ? 1 : 0, held, pressed };
+		}
+		events.clear();
+		return count;
+	}
+
+	// Drops the events seen so far, when the frame's input comes from elsewhere (a replay).
+	void Discard() {
+		sliced = observed;
+		events.clear();
+	}
+
+	// The application keys pressed since the last call.
+	uint32_t TakeAppPressed() {
+		const uint32_t bits = appPressed;
+		appPressed = 0;
+		return bits;
+	}
+
+private:
+	struct Event {
+		double   time;
+		uint32_t bit;
+		bool     down;
+	};
+
+	struct AppBinding {
+		AppBit bit;
+		int    key;
+	};
+
+	static constexpr AppBinding C_APP[] = { { APP_PROFILER, KEY_F3 }, { APP_CAPTURE, KEY_F12 }, { APP_BROADPHASE, KEY_F4 } };
+	static constexpr uint32_t   C_HELD_MASK = Input::MaskOf(Input::C_HELD);
+	static constexpr uint32_t   C_PRESSED_MASK = Input::MaskOf(Input::C_PRESSED);
+
+	std::vector<Event> events;     // since the last Slice, in the order seen
+	uint32_t           observed = 0;  // keys down as of the last Observe
+	uint32_t           sliced = 0;    // keys down as of the end of the last sliced tick
+	uint32_t           appDown = 0;
+	uint32_t           appPressed = 0;
+};
+
+// --- ASTEROIDS ---
+
+enum class AsteroidShape : uint8_t { TRIANGLE, SQUARE, PENTAGON, COUNT, RANDOM = COUNT };
+
+// All that tells the shapes apart, indexed by shape id. Every pass looks its shape up here
+// (the outlines come from AsteroidLod's unit polygons for the side count), so no loop
+// dispatches on the shape and a field column holds one byte per asteroid.
+struct AsteroidShapeInfo {
+	int sides;
+	int baseDamage;  // per unit of Renderable::Size
+};
+
+inline constexpr AsteroidShapeInfo C_ASTEROID_SHAPES[static_cast<size_t>(AsteroidShape::COUNT)] = {
+	{ 3, 5 },   // TRIANGLE
+	{ 4, 10 },  // SQUARE
+	{ 5, 15 },  // PENTAGON
+};
+
+// Spawn rules for asteroids. Live asteroids are stored in AsteroidField; init() rolls a
+// fresh asteroid straight into the components of a field slot, so spawning never allocates.
+class Asteroid {
+public:
+	static constexpr float MAX_RADIUS = 16.f * static_cast<float>(Renderable::LARGE);
+
+	static constexpr float RadiusOf(Renderable::Size size) {
+		return 16.f * (float)size;
+	}
+
+	static constexpr const AsteroidShapeInfo& InfoOf(AsteroidShape shape) {
+		return C_ASTEROID_SHAPES[static_cast<size_t>(shape)];
+	}
+
+	static AsteroidShape Resolve(AsteroidShape shape) {
+		return (shape == AsteroidShape::RANDOM) ? static_cast<AsteroidShape>(Utils::RandomInt(0, 2)) : shape;
+	}
+
+	static void init(int screenW, int screenH, TransformA& transform, Physics& physics, Renderable& render) {
+
+		render.size = static_cast<Renderable::Size>(1 << Utils::RandomInt(0, 2));
+		const float radius = RadiusOf(render.size);
+
+		switch (Utils::RandomInt(0, 3)) {
+		case 0:
+			transform.position = { Utils::RandomFloat(0, screenW), -radius };
+			break;
+		case 1:
+			transform.position = { screenW + radius, Utils::RandomFloat(0, screenH) };
+			break;
+		case 2:
+			transform.position = { Utils::RandomFloat(0, screenW), screenH + radius };
+			break;
+		default:
+			transform.position = { -radius, Utils::RandomFloat(0, screenH) };
+			break;
+		}
+
+		float maxOff = fminf(screenW, screenH) * 0.1f;
+		float ang = Utils::RandomFloat(0, 2 * PI);
+		float rad = Utils::RandomFloat(0, maxOff);
+		Vector2 center = {
+										 screenW * 0.5f + cosf(ang) * rad,
+										 screenH * 0.5f + sinf(ang) * rad
+		};
+
+		Vector2 dir = Vector2Normalize(Vector2Subtract(center, transform.position));
+		physics.velocity = Vector2Scale(dir, Utils::RandomFloat(SPEED_MIN, SPEED_MAX));
+		physics.rotationSpeed = Utils::RandomFloat(ROT_MIN, ROT_MAX);
+
+		transform.rotation = Utils::RandomFloat(0, 360);
+	}
+
+	// init() for lockstep worlds, in Fixed arithmetic: every value lands on the fixed grid,
+	// so the same draws give the same asteroid on any machine.
+	static void InitFixed(int screenW, int screenH, TransformA& transform, Physics& physics, Renderable& render) {
+		render.size = static_cast<Renderable::Size>(1 << Utils::RandomInt(0, 2));
+		const Fixed::Raw radius = Fixed::FromFloat(RadiusOf(render.size));
+		const Fixed::Raw w = Fixed::FromInt(screenW);
+		const Fixed::Raw h = Fixed::FromInt(screenH);
+
+		Fixed::Raw x, y;
+		switch (Utils::RandomInt(0, 3)) {
+		case 0:  x = Utils::RandomFixed(0, w); y = -radius;                   break;
+		case 1:  x = w + radius;               y = Utils::RandomFixed(0, h); break;
+		case 2:  x = Utils::RandomFixed(0, w); y = h + radius;                break;
+		default: x = -radius;                  y = Utils::RandomFixed(0, h); break;
+		}
+
+		const Fixed::Raw maxOff = (w < h ? w : h) / 10;
+		const Fixed::Raw ang = Utils::RandomFixed(0, Fixed::C_FULL_TURN);
+		const Fixed::Raw rad = Utils::RandomFixed(0, maxOff);
+		const Fixed::Raw dx = w / 2 + Fixed::MulUnit(rad, Fixed::Cos(ang)) - x;
+		const Fixed::Raw dy = h / 2 + Fixed::MulUnit(rad, Fixed::Sin(ang)) - y;
+		Fixed::Raw vx, vy;
+		Fixed::Resize(dx, dy, Utils::RandomFixed(Fixed::FromFloat(SPEED_MIN), Fixed::FromFloat(SPEED_MAX)), vx, vy);
+
+		transform.position = { Fixed::ToFloat(x), Fixed::ToFloat(y) };
+		physics.velocity = { Fixed::ToFloat(vx), Fixed::ToFloat(vy) };
+		physics.rotationSpeed = Fixed::ToFloat(Utils::RandomFixed(Fixed::FromFloat(ROT_MIN), Fixed::FromFloat(ROT_MAX)));
+		transform.rotation = Fixed::ToFloat(Utils::RandomFixed(0, Fixed::C_FULL_TURN));
+	}
+
+	static constexpr float SPEED_MIN = 125.f;
+	static constexpr float SPEED_MAX = 250.f;
+	static constexpr float ROT_MIN = 50.f;
+	static constexpr float ROT_MAX = 240.f;
+};
+
+// --- ASTEROID FIELD ---
+// Structure-of-arrays storage for live asteroids. Each column is contiguous, so the
+// update, collision and draw passes stream through memory instead of chasing pointers.
+// The columns are allocated once for a fixed capacity and live asteroids are kept
+// dense in [0, Size()): a kill moves the last asteroid into the freed slot and a spawn
+// recycles the slot just past the end, so gameplay never touches the heap.
+class AsteroidField {
+public:
+	explicit AsteroidField(size_t capacity = 0) {
+		Reserve(capacity);
+	}
+
+	// Grows the fixed capacity. Meant for setup (benchmarks, scenarios), not gameplay.
+	void Reserve(size_t n) {
+		if (n <= Capacity()) return;
+		posX.resize(n); posY.resize(n);
+		velX.resize(n); velY.resize(n);
+		rotation.resize(n); rotationSpeed.resize(n);
+		radius.resize(n); size.resize(n); shape.resize(n);
+	}
+
+	size_t Size() const {
+		return count;
+	}
+
+	size_t Capacity() const {
+		return posX.size();
+	}
+
+	void Clear() {
+		count = 0;
+	}
+
+	// Rolls a new asteroid into the next free slot. Returns false when the field is full.
+	bool Spawn(int screenW, int screenH, AsteroidShape requested) {
+		if (count == Capacity()) return false;
+
+		TransformA transform;
+		Physics    physics;
+		Renderable render;
+		if (fixedPoint) Asteroid::InitFixed(screenW, screenH, transform, physics, render);
+		else Asteroid::init(screenW, screenH, transform, physics, render);
+
+		const size_t i = count++;
+		posX[i] = transform.position.x;
+		posY[i] = transform.position.y;
+		velX[i] = physics.velocity.x;
+		velY[i] = physics.velocity.y;
+		rotation[i] = transform.rotation;
+		rotationSpeed[i] = physics.rotationSpeed;
+		size[i] = render.size;
+		radius[i] = Asteroid::RadiusOf(render.size);
+		shape[i] = Asteroid::Resolve(requested);
+		Touch(i);
+		return true;
+	}
+
+	// Puts a given asteroid (one a SectorMap hands back) into the next free slot. Returns
+	// false when the field is full.
+	bool Add(Vector2 position, Vector2 velocity, float rotation_, float rotationSpeed_, Renderable::Size size_, AsteroidShape shape_) {
+		if (count == Capacity()) return false;
+		const size_t i = count++;
+		posX[i] = position.x;
+		posY[i] = position.y;
+		velX[i] = velocity.x;
+		velY[i] = velocity.y;
+		rotation[i] = rotation_;
+		rotationSpeed[i] = rotationSpeed_;
+		size[i] = size_;
+		radius[i] = Asteroid::RadiusOf(size_);
+		shape[i] = shape_;
+		Touch(i);
+		return true;
+	}
+
+	// Spawns up to n asteroids in one call with the same distribution as Spawn(), but column
+	// by column: each random quantity is drawn for the whole wave in one Fill pass and the
+	// placement math runs as flat loops over the new slots. Returns how many were spawned
+	// (fewer than n only when the field is full).
+	size_t SpawnWave(size_t n, int screenW, int screenH, AsteroidShape requested) {
+		if (n > Capacity() - count) n = Capacity() - count;
+		if (n == 0) return 0;
+		if (fixedPoint) {
+			for (size_t k = 0; k < n; ++k) Spawn(screenW, screenH, requested);
+			return n;
+		}
+		const size_t first = count;
+		const size_t end = first + n;
+		Utils::Rng& rng = Utils::ThreadRng();
+
+		waveA.resize(n);
+		waveB.resize(n);
+		waveEdge.resize(n);
+
+		for (size_t i = first; i < end; ++i) {
+			size[i] = static_cast<Renderable::Size>(1 << rng.NextInt(0, 2));
+			radius[i] = Asteroid::RadiusOf(size[i]);
+			shape[i] = Asteroid::Resolve(requested);
+		}
+
+		// Entry point: a random edge and a position along it.
+		for (size_t k = 0; k < n; ++k) waveEdge[k] = rng.NextInt(0, 3);
+		rng.Fill(waveA.data(), n, 0.f, 1.f);
+		const float w = static_cast<float>(screenW);
+		const float h = static_cast<float>(screenH);
+		for (size_t k = 0; k < n; ++k) {
+			const size_t i = first + k;
+			const float r = radius[i];
+			switch (waveEdge[k]) {
+			case 0:  posX[i] = waveA[k] * w; posY[i] = -r;           break;
+			case 1:  posX[i] = w + r;        posY[i] = waveA[k] * h; break;
+			case 2:  posX[i] = waveA[k] * w; posY[i] = h + r;        break;
+			default: posX[i] = -r;           posY[i] = waveA[k] * h; break;
+			}
+		}
+
+		// Heading: towards a random point near the centre, then a random speed.
+		const float maxOff = fminf(w, h) * 0.1f;
+		rng.Fill(waveA.data(), n, 0.f, 2 * PI);
+		rng.Fill(waveB.data(), n, 0.f, maxOff);
+		for (size_t k = 0; k < n; ++k) {
+			const size_t i = first + k;
+			velX[i] = w * 0.5f + cosf(waveA[k]) * waveB[k] - posX[i];
+			velY[i] = h * 0.5f + sinf(waveA[k]) * waveB[k] - posY[i];
+		}
+		rng.Fill(waveA.data(), n, Asteroid::SPEED_MIN, Asteroid::SPEED_MAX);
+		Simd::Normalize2(velX.data() + first, velY.data() + first, waveA.data(), 0, n);
+
+		rng.Fill(rotationSpeed.data() + first, n, Asteroid::ROT_MIN, Asteroid::ROT_MAX);
+		rng.Fill(rotation.data() + first, n, 0.f, 360.f);
+
+		for (size_t i = first; i < end; ++i) Touch(i);
+		count = end;
+		return n;
+	}
+
+	// Breaks asteroid i into two of the next size down, flying apart at +-C_SPLIT_ANGLE
+	// from the parent's heading. Slot i is reused for one fragment and the other takes the
+	// slot past the end, so splitting stays inside the preallocated pool; dead[i] is cleared
+	// and a flag is appended for the new slot. Returns the number of fragments: 0 for a
+	// SMALL asteroid (which stays flagged), 1 when the field is full.
+	int Split(size_t i, std::vector<char>& dead) {
+		if (size[i] == Renderable::SMALL) return 0;
+
+		const auto childSize = static_cast<Renderable::Size>(size[i] / 2);
+		const float childRadius = Asteroid::RadiusOf(childSize);
+		if (fixedPoint) return SplitFixed(i, childSize, dead);
+		const float vx = velX[i] * C_SPLIT_SPEEDUP;
+		const float vy = velY[i] * C_SPLIT_SPEEDUP;
+		constexpr float c = Trig::Cos(C_SPLIT_ANGLE * DEG2RAD);
+		constexpr float sn = Trig::Sin(C_SPLIT_ANGLE * DEG2RAD);
+		float len = sqrtf(vx * vx + vy * vy);
+		float nx = len > 0.f ? -vy / len : 1.f;
+		float ny = len > 0.f ? vx / len : 0.f;
+
+		size[i] = childSize;
+		radius[i] = childRadius;
+		dead[i] = 0;
+		int fragments = 1;
+		if (count < Capacity()) {
+			const size_t j = count++;
+			posX[j] = posX[i] - nx * childRadius;
+			posY[j] = posY[i] - ny * childRadius;
+			velX[j] = vx * c + vy * sn;
+			velY[j] = vy * c - vx * sn;
+			rotation[j] = rotation[i];
+			rotationSpeed[j] = -rotationSpeed[i];
+			radius[j] = childRadius;
+			size[j] = childSize;
+			shape[j] = shape[i];
+			dead.push_back(0);
+			Touch(j);
+			fragments = 2;
+		}
+		posX[i] += nx * childRadius;
+		posY[i] += ny * childRadius;
+		velX[i] = vx * c - vy * sn;
+		velY[i] = vy * c + vx * sn;
+		Touch(i);
+		return fragments;
+	}
+
+	void Integrate(float dt) {
+		Integrate(dt, 0, Size());
+	}
+
+	// Range forms let the field be stepped in independent chunks.
+	void Integrate(float dt, size_t begin, size_t end) {
+		if (fixedPoint) {
+			const int32_t step = Fixed::FromSeconds(dt);
+			Fixed::Advance(posX.data(), velX.data(), step, begin, end);
+			Fixed::Advance(posY.data(), velY.data(), step, begin, end);
+			Fixed::AdvanceDegrees(rotation.data(), rotationSpeed.data(), step, begin, end);
+			return;
+		}
+		Simd::Axpy(posX.data(), velX.data(), dt, begin, end);
+		Simd::Axpy(posY.data(), velY.data(), dt, begin, end);
+		Simd::Axpy(rotation.data(), rotationSpeed.data(), dt, begin, end);
+	}
+
+	// Moves every asteroid by (dx, dy), which gives each a new course: every slot changes.
+	void Translate(float dx, float dy) {
+		for (size_t i = 0; i < count; ++i) {
+			posX[i] += dx;
+			posY[i] += dy;
+			Touch(i);
+		}
+	}
+
+	// Flags every asteroid that drifted fully outside the playfield.
+	void MarkOutOfBounds(const WorldBounds& bounds, std::vector<char>& dead) const {
+		MarkOutOfBounds(bounds, dead, 0, Size());
+	}
+
+	void MarkOutOfBounds(const WorldBounds& bounds, std::vector<char>& dead, size_t begin, size_t end) const {
+		Simd::MarkOutside(posX.data(), posY.data(), radius.data(), bounds.width, bounds.height, begin, end, dead.data());
+	}
+
+	// Swap-and-pop over every column, same contract as Utils::SwapAndPop.
+	void Compact(std::vector<char>& dead) {
+		size_t i = 0;
+		while (i < count) {
+			if (dead[i]) {
+				size_t last = count - 1;
+				if (i != last) {
+					posX[i] = posX[last]; posY[i] = posY[last];
+					velX[i] = velX[last]; velY[i] = velY[last];
+					rotation[i] = rotation[last]; rotationSpeed[i] = rotationSpeed[last];
+					radius[i] = radius[last]; size[i] = size[last];
+					shape[i] = shape[last];
+					dead[i] = dead[last];
+					Touch(i);
+				}
+				--count;
+				dead.pop_back();
+			}
+			else {
+				++i;
+			}
+		}
+	}
+
+	Vector2 GetPosition(size_t i) const {
+		return { posX[i], posY[i] };
+	}
+
+	float GetRotation(size_t i) const {
+		return rotation[i];
+	}
+
+	Vector2 GetVelocity(size_t i) const {
+		return { velX[i], velY[i] };
+	}
+
+	float GetRotationSpeed(size_t i) const {
+		return rotationSpeed[i];
+	}
+
+	int GetSides(size_t i) const {
+		return Asteroid::InfoOf(shape[i]).sides;
+	}
+
+	Renderable::Size GetSize(size_t i) const {
+		return size[i];
+	}
+
+	AsteroidShape GetShape(size_t i) const {
+		return shape[i];
+	}
+
+	void SetPosition(size_t i, Vector2 p) {
+		posX[i] = p.x;
+		posY[i] = p.y;
+		Touch(i);
+	}
+
+	float GetRadius(size_t i) const {
+		return radius[i];
+	}
+
+	int GetDamage(size_t i) const {
+		return Asteroid::InfoOf(shape[i]).baseDamage * static_cast<int>(size[i]);
+	}
+
+	// Renumbers the asteroids in the Morton order of their position over [0, width) x
+	// [0, height), so neighbours in space are neighbours in the columns: slot k takes the
+	// asteroid that was at sorter.Order()[k]. Every slot counts as changed.
+	void SortSpatially(SpatialOrder::Sorter& sorter, float width, float height) {
+		sorter.Sort(posX.data(), posY.data(), count, width, height);
+		const uint32_t* order = sorter.Order().data();
+		SpatialOrder::Permute(posX.data(), order, count, sortScratch);
+		SpatialOrder::Permute(posY.data(), order, count, sortScratch);
+		SpatialOrder::Permute(velX.data(), order, count, sortScratch);
+		SpatialOrder::Permute(velY.data(), order, count, sortScratch);
+		SpatialOrder::Permute(rotation.data(), order, count, sortScratch);
+		SpatialOrder::Permute(rotationSpeed.data(), order, count, sortScratch);
+		SpatialOrder::Permute(radius.data(), order, count, sortScratch);
+		SpatialOrder::Permute(size.data(), order, count, sortScratch);
+		SpatialOrder::Permute(shape.data(), order, count, sortScratch);
+		for (size_t i = 0; i < count; ++i) Touch(i);
+	}
+
+	// Raw columns for the SIMD kernels, valid for [0, Size()).
+	const float* X() const { return posX.data(); }
+	const float* Y() const { return posY.data(); }
+	const float* Radii() const { return radius.data(); }
+
+	// Change log for renderers that keep their own copy of the field: with tracking on,
+	// every slot that is given a new asteroid or a new course (spawn, split, compaction,
+	// SetPosition) is listed in Changed() until ClearChanged(). Integration is not a
+	// change, since it only moves an asteroid along the course it already has. Slots may
+	// repeat, and ones at or past Size() are stale.
+	void TrackChanges(bool on) {
+		tracking = on;
+		if (!on) changed.clear();
+	}
+
+	const std::vector<uint32_t>& Changed() const { return changed; }
+	void ClearChanged() { changed.clear(); }
+
+	// Lockstep worlds: spawning, splitting and integration in Fixed arithmetic, so every
+	// column holds values on the fixed grid. Set before the first spawn.
+	void SetFixedPoint(bool on) {
+		fixedPoint = on;
+	}
+
+	// The live asteroids' columns as WorldSnapshot sections.
+	void Save(WorldSnapshot::Writer& out) const {
+		out.Add(C_SNAPSHOT_TAG, 0, posX.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 1, posY.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 2, velX.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 3, velY.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 4, rotation.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 5, rotationSpeed.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 6, radius.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 7, size.data(), count);
+		out.Add(C_SNAPSHOT_TAG, 8, shape.data(), count);
+	}
+
+	// Replaces the field with a saved one, growing the capacity if it must. Every slot
+	// counts as changed. False, with the field empty, when the columns are missing or
+	// disagree.
+	bool Load(const WorldSnapshot::Reader& in) {
+		count = 0;
+		const int64_t n = in.Count(C_SNAPSHOT_TAG, 0, sizeof(float));
+		if (n < 0) return false;
+		const size_t saved = static_cast<size_t>(n);
+		Reserve(saved);
+		bool ok = in.Read(C_SNAPSHOT_TAG, 0, posX.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 1, posY.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 2, velX.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 3, velY.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 4, rotation.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 5, rotationSpeed.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 6, radius.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 7, size.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 8, shape.data(), saved) == n;
+		for (size_t i = 0; ok && i < saved; ++i) ok = shape[i] < AsteroidShape::COUNT;
+		if (!ok) return false;
+		count = saved;
+		for (size_t i = 0; i < count; ++i) Touch(i);
+		return true;
+	}
+
+private:
+	static constexpr uint32_t C_SNAPSHOT_TAG = WorldSnapshot::Tag("ASTR");
+
+	void Touch(size_t i) {
+		if (tracking) changed.push_back(static_cast<uint32_t>(i));
+	}
+
+	// Split()'s fragments in Fixed arithmetic, with the table's sine of C_SPLIT_ANGLE.
+	int SplitFixed(size_t i, Renderable::Size childSize, std::vector<char>& dead) {
+		const Fixed::Raw childRadius = Fixed::FromFloat(Asteroid::RadiusOf(childSize));
+		const int32_t speedup = static_cast<int32_t>(lrintf(C_SPLIT_SPEEDUP * static_cast<float>(1 << Fixed::C_UNIT_SHIFT)));
+		const Fixed::Raw vx = Fixed::MulUnit(Fixed::FromFloat(velX[i]), speedup);
+		const Fixed::Raw vy = Fixed::MulUnit(Fixed::FromFloat(velY[i]), speedup);
+		const int32_t c = Fixed::Cos(Fixed::FromFloat(C_SPLIT_ANGLE));
+		const int32_t sn = Fixed::Sin(Fixed::FromFloat(C_SPLIT_ANGLE));
+		Fixed::Raw offX, offY;
+		Fixed::Resize(-vy, vx, childRadius, offX, offY);
+		const Fixed::Raw x = Fixed::FromFloat(posX[i]);
+		const Fixed::Raw y = Fixed::FromFloat(posY[i]);
+
+		size[i] = childSize;
+		radius[i] = Fixed::ToFloat(childRadius);
+		dead[i] = 0;
+		int fragments = 1;
+		if (count < Capacity()) {
+			const size_t j = count++;
+			posX[j] = Fixed::ToFloat(x - offX);
+			posY[j] = Fixed::ToFloat(y - offY);
+			velX[j] = Fixed::ToFloat(Fixed::MulUnit(vx, c) + Fixed::MulUnit(vy, sn));
+			velY[j] = Fixed::ToFloat(Fixed::MulUnit(vy, c) - Fixed::MulUnit(vx, sn));
+			rotation[j] = rotation[i];
+			rotationSpeed[j] = -rotationSpeed[i];
+			radius[j] = radius[i];
+			size[j] = childSize;
+			shape[j] = shape[i];
+			dead.push_back(0);
+			Touch(j);
+			fragments = 2;
+		}
+		posX[i] = Fixed::ToFloat(x + offX);
+		posY[i] = Fixed::ToFloat(y + offY);
+		velX[i] = Fixed::ToFloat(Fixed::MulUnit(vx, c) - Fixed::MulUnit(vy, sn));
+		velY[i] = Fixed::ToFloat(Fixed::MulUnit(vy, c) + Fixed::MulUnit(vx, sn));
+		Touch(i);
+		return fragments;
+	}
+
+	size_t count = 0;
+	bool   tracking = false;
+	bool   fixedPoint = false;
+	std::vector<uint32_t> changed;
+
+	std::vector<float> posX, posY;
+	std::vector<float> velX, velY;
+	std::vector<float> rotation, rotationSpeed;
+	std::vector<float> radius;
+	std::vector<Renderable::Size> size;
+	std::vector<AsteroidShape>    shape;
+
+	static constexpr float C_SPLIT_ANGLE = 30.f;
+	static constexpr float C_SPLIT_SPEEDUP = 1.25f;
+
+	// SpawnWave scratch, reused between waves.
+	std::vector<float> waveA, waveB;
+	std::vector<int>   waveEdge;
+
+	// SortSpatially's, one column at a time.
+	std::vector<unsigned char> sortScratch;
+};
+
+// --- GPU STREAM BUFFER ---
+// Dynamic VBO that is rewritten every frame. It grows geometrically, so steady-state
+// frames only do a sub-data upload. Reserve() returns true when the buffer object was
+// recreated; the caller must then set its vertex attribute pointers again (with its VAO bound).
+class StreamBuffer {
+public:
+	bool Reserve(int bytes) {
+		if (bytes <= capacityBytes) return false;
+		if (id) rlUnloadVertexBuffer(id);
+		capacityBytes = (bytes > capacityBytes * 2) ? bytes : capacityBytes * 2;
+		id = rlLoadVertexBuffer(nullptr, capacityBytes, true);
+		return true;
+	}
+
+	void Update(const void* data, int bytes, int offset = 0) {
+		rlUpdateVertexBuffer(id, data, bytes, offset);
+	}
+
+	void Unload() {
+		if (id) rlUnloadVertexBuffer(id);
+		id = 0;
+		capacityBytes = 0;
+	}
+
+private:
+	unsigned int id = 0;
+	int          capacityBytes = 0;
+};
+
+// --- ASTEROID LEVEL OF DETAIL ---
+// How much of an asteroid's outline is worth drawing at its size on screen: the full
+// polygon, a triangle once it is a few pixels across, and a single dot below that. Every
+// asteroid renderer applies the same policy (the analytic one in its vertex shader).
+struct AsteroidLod {
+	static constexpr float C_TRIANGLE_BELOW = 4.f;  // screen radius in px
+	static constexpr float C_DOT_BELOW = 1.5f;
+	static constexpr int   C_DOT = 1;
+
+	// Sides to draw, or C_DOT.
+	static int Sides(int sides, float radius, const View& view) {
+		float pixels = radius * view.pixelsPerUnit;
+		if (pixels < C_DOT_BELOW * view.lodBias) return C_DOT;
+		if (pixels < C_TRIANGLE_BELOW * view.lodBias) return 3;
+		return sides;
+	}
+};
+
+// --- ASTEROID BATCH RENDERER ---
+// Draws the outline of every visible asteroid with one instanced GL_LINES draw, instead of
+// one rlgl DrawPolyLines each. Per asteroid only its centre, rotation, radius, side count
+// and colour are uploaded (20 bytes); a fixed index buffer walks the five corners of an
+// outline and the vertex shader places each corner, so the CPU writes no vertices at all.
+// Triangles and squares fold their surplus corners onto corner 0, which leaves the closing
+// segment in place and the rest zero-length.
+class AsteroidBatch {
+public:
+	void Init() {
+		shader = ShaderCache::Load("../resources/shaders/glsl330/asteroid_instanced.vs",
+			"../resources/shaders/glsl330/asteroid_instanced.fs");
+		pixelLoc = GetShaderLocation(shader, "pixel");
+
+		vao = rlLoadVertexArray();
+		if (!vao) return;
+		rlEnableVertexArray(vao);
+
+		static constexpr unsigned short outline[C_MAX_SIDES * 2] = { 0, 1,   1, 2,   2, 3,   3, 4,   4, 0 };
+		indexVbo = rlLoadVertexBufferElement(outline, static_cast<int>(sizeof(outline)), false);
+
+		rlDisableVertexArray();
+	}
+
+	void Unload() {
+		instanceVbo.Unload();
+		if (indexVbo) rlUnloadVertexBuffer(indexVbo);
+		if (vao) rlUnloadVertexArray(vao);
+		UnloadShader(shader);
+		indexVbo = vao = 0;
+	}
+
+	// False when the shader failed to load (or VAOs are unavailable); callers then
+	// fall back to AsteroidSnapshot::Draw.
+	bool IsReady() const {
+		return vao != 0 && shader.id != rlGetShaderIdDefault();
+	}
+
+	// `field` is an AsteroidField or an AsteroidSnapshot: anything with Size() and the
+	// per-index GetPosition/GetSides/GetRadius/GetRotation accessors. Culling and level of
+	// detail stay here, so only what is on screen is uploaded. `color` is drawn opaque.
+	template<typename Field>
+	void Draw(const Field& field, const View& view, Color color) {
+		instances.clear();
+		const size_t n = field.Size();
+		for (size_t i = 0; i < n; ++i) {
+			Vector2 c = field.GetPosition(i);
+			float radius = field.GetRadius(i);
+			if (!view.Sees(c, radius)) continue;
+			const int sides = std::clamp(AsteroidLod::Sides(field.GetSides(i), radius, view), AsteroidLod::C_DOT, C_MAX_SIDES);
+			instances.push_back({ c, field.GetRotation(i), radius, static_cast<unsigned char>(sides), color.r, color.g, color.b });
+		}
+		if (instances.empty()) return;
+
+		// Anything already queued in the rlgl batch has to reach the GPU first to keep draw order.
+		if (Trace::Enabled()) Trace::Instance().Instant("rlgl flush");
+		rlDrawRenderBatchActive();
+
+		rlEnableVertexArray(vao);
+		Upload();
+
+		rlEnableShader(shader.id);
+		rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP],
+			MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+		float pixel = 1.f / view.pixelsPerUnit;
+		rlSetUniform(pixelLoc, &pixel, RL_SHADER_UNIFORM_FLOAT, 1);
+
+		glDrawElementsInstanced(GL_LINES, C_MAX_SIDES * 2, GL_UNSIGNED_SHORT, nullptr, static_cast<GLsizei>(instances.size()));
+
+		rlDisableShader();
+		rlDisableVertexArray();
+	}
+
+private:
+	static constexpr int C_MAX_SIDES = 5;
+
+	struct Instance {
+		Vector2       position;
+		float         rotation;  // degrees
+		float         radius;
+		unsigned char sides;     // 3..C_MAX_SIDES, or AsteroidLod::C_DOT
+		unsigned char r, g, b;
+	};
+	static_assert(sizeof(Instance) == 20, "an asteroid instance is 20 bytes");
+
+	void Upload() {
+		constexpr int STRIDE = static_cast<int>(sizeof(Instance));
+		int bytes = static_cast<int>(instances.size()) * STRIDE;
+		if (instanceVbo.Reserve(bytes)) {
+			rlSetVertexAttribute(0, 2, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Instance, position)));
+			rlSetVertexAttribute(1, 2, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Instance, rotation)));
+			rlSetVertexAttribute(2, 4, RL_UNSIGNED_BYTE, false, STRIDE, reinterpret_cast<void*>(offsetof(Instance, sides)));
+			for (unsigned int a = 0; a <= 2; ++a) {
+				rlEnableVertexAttribute(a);
+				rlSetVertexAttributeDivisor(a, 1);
+			}
+		}
+		instanceVbo.Update(instances.data(), bytes);
+	}
+
+	Shader                shader{};
+	int                   pixelLoc = -1;
+	unsigned int          vao = 0;
+	unsigned int          indexVbo = 0;
+	StreamBuffer          instanceVbo;
+	std::vector<Instance> instances;
+};
+
+// --- ANALYTIC ASTEROID RENDERER ---
+// Asteroids fly in straight lines at a constant spin, so one record per asteroid, its
+// state at some time0, fixes where it is at any later time. This renderer keeps those
+// records in a GPU buffer mirroring the field's slots and lets the vertex shader place
+// and outline every asteroid from the current time, with one instanced GL_LINES draw.
+// A record is only re-sent when its slot changes (AsteroidField::Changed), so a field
+// that is merely drifting streams nothing at all.
+class AsteroidMotionBatch {
+public:
+	struct Motion {
+		Vector2 origin;
+		Vector2 velocity;
+		float   rotation;  // degrees at time0
+		float   spin;      // degrees per second
+		float   radius;
+		float   sides;
+		float   time0;
+	};
+
+	// A new record for `slot`, taking effect with the snapshot of simulation frame `frame`.
+	struct Update {
+		uint64_t frame;
+		uint32_t slot;
+		Motion   motion;
+	};
+
+	void Init() {
+		shader = ShaderCache::Load("../resources/shaders/glsl330/asteroid_motion.vs",
+			"../resources/shaders/glsl330/asteroid_lines.fs");
+		timeLoc = GetShaderLocation(shader, "time");
+		viewLoc = GetShaderLocation(shader, "view");
+		lodLoc = GetShaderLocation(shader, "lod");
+		vao = rlLoadVertexArray();
+		mirror.clear();
+		backlog.clear();
+		dirtyBegin = dirtyEnd = 0;
+	}
+
+	void Unload() {
+		vbo.Unload();
+		if (vao) rlUnloadVertexArray(vao);
+		UnloadShader(shader);
+		vao = 0;
+	}
+
+	bool IsReady() const {
+		return vao != 0 && shader.id != rlGetShaderIdDefault();
+	}
+
+	// Collects posted updates and applies those up to and including `frame`; later ones
+	// wait for the snapshot they belong to, so the buffer always matches what is drawn.
+	void Apply(Mailbox<Update>& mail, uint64_t frame) {
+		mail.Take(incoming);
+		backlog.insert(backlog.end(), incoming.begin(), incoming.end());
+		size_t k = 0;
+		for (; k < backlog.size() && backlog[k].frame <= frame; ++k) {
+			const Update& u = backlog[k];
+			if (u.slot >= mirror.size()) mirror.resize(std::max<size_t>(u.slot + 1, mirror.size() * 2));
+			mirror[u.slot] = u.motion;
+			dirtyBegin = std::min<size_t>(dirtyBegin, u.slot);
+			dirtyEnd = std::max<size_t>(dirtyEnd, u.slot + 1);
+		}
+		backlog.erase(backlog.begin(), backlog.begin() + static_cast<std::ptrdiff_t>(k));
+	}
+
+	// Draws slots [0, count) as they are at simulation time `time`. Culling and level of
+	// detail happen per instance in the shader, which knows where each asteroid is.
+	void Draw(size_t count, float time, const View& view, Color color) {
+		count = std::min(count, mirror.size());
+		if (count == 0) return;
+
+		if (Trace::Enabled()) Trace::Instance().Instant("rlgl flush");
+		rlDrawRenderBatchActive();
+
+		rlEnableVertexArray(vao);
+		Upload();
+
+		rlEnableShader(shader.id);
+		rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP],
+			MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+		rlSetUniform(timeLoc, &time, RL_SHADER_UNIFORM_FLOAT, 1);
+		Vector4 rect = { view.minX, view.minY, view.maxX, view.maxY };
+		rlSetUniform(viewLoc, &rect, RL_SHADER_UNIFORM_VEC4, 1);
+		Vector3 lod = { view.pixelsPerUnit, AsteroidLod::C_TRIANGLE_BELOW * view.lodBias, AsteroidLod::C_DOT_BELOW * view.lodBias };
+		rlSetUniform(lodLoc, &lod, RL_SHADER_UNIFORM_VEC3, 1);
+		Vector4 c = ColorNormalize(color);
+		rlSetUniform(shader.locs[SHADER_LOC_COLOR_DIFFUSE], &c, RL_SHADER_UNIFORM_VEC4, 1);
+
+		// Every instance is C_MAX_SIDES line segments; the shader collapses the unused ones.
+		glDrawArraysInstanced(GL_LINES, 0, C_MAX_SIDES * 2, static_cast<GLsizei>(count));
+
+		rlDisableShader();
+		rlDisableVertexArray();
+	}
+
+private:
+	static constexpr int C_MAX_SIDES = 5;
+
+	// Sends the dirty slot range; everything when the buffer had to be recreated.
+	void Upload() {
+		constexpr int SIZE = static_cast<int>(sizeof(Motion));
+		if (vbo.Reserve(static_cast<int>(mirror.size()) * SIZE)) {
+			rlSetVertexAttribute(0, 2, RL_FLOAT, false, SIZE, reinterpret_cast<void*>(offsetof(Motion, origin)));
+			rlSetVertexAttribute(1, 2, RL_FLOAT, false, SIZE, reinterpret_cast<void*>(offsetof(Motion, velocity)));
+			rlSetVertexAttribute(2, 2, RL_FLOAT, false, SIZE, reinterpret_cast<void*>(offsetof(Motion, rotation)));
+			rlSetVertexAttribute(3, 3, RL_FLOAT, false, SIZE, reinterpret_cast<void*>(offsetof(Motion, radius)));
+			for (unsigned int a = 0; a <= 3; ++a) {
+				rlEnableVertexAttribute(a);
+				rlSetVertexAttributeDivisor(a, 1);
+			}
+			dirtyBegin = 0;
+			dirtyEnd = mirror.size();
+		}
+		if (dirtyBegin < dirtyEnd) {
+			vbo.Update(mirror.data() + dirtyBegin, static_cast<int>(dirtyEnd - dirtyBegin) * SIZE,
+				static_cast<int>(dirtyBegin) * SIZE);
+		}
+		dirtyBegin = SIZE_MAX;
+		dirtyEnd = 0;
+	}
+
+	Shader              shader{};
+	int                 timeLoc = -1;
+	int                 viewLoc = -1;
+	int                 lodLoc = -1;
+	unsigned int        vao = 0;
+	StreamBuffer        vbo;
+	std::vector<Motion> mirror;
+	std::vector<Update> backlog;
+	std::vector<Update> incoming;
+	size_t              dirtyBegin = SIZE_MAX;
+	size_t              dirtyEnd = 0;
+};
+
+// --- PROJECTILE HIERARCHY ---
+enum class WeaponType : uint8_t { LASER, BULLET, COUNT };
+// One shot as handed to ProjectileField::Add. Damage and radius follow from the weapon,
+// so a projectile is only where it is, where it's going, what it is and who fired it.
+class Projectile {
+public:
+	Projectile(Vector2 pos, Vector2 vel, WeaponType wt, Handle owner_)
+		: position(pos), velocity(vel), type(wt), owner(owner_)
+	{
+	}
+
+	Vector2 GetPosition() const {
+		return position;
+	}
+
+	Vector2 GetVelocity() const {
+		return velocity;
+	}
+
+	float GetRadius() const {
+		return RadiusOf(type);
+	}
+
+	static constexpr float RadiusOf(WeaponType wt) {
+		return (wt == WeaponType::BULLET) ? 5.f : 2.f;
+	}
+
+	static constexpr int DamageOf(WeaponType wt) {
+		return (wt == WeaponType::LASER) ? 20 : 10;
+	}
+
+	int GetDamage() const {
+		return DamageOf(type);
+	}
+
+	WeaponType GetType() const {
+		return type;
+	}
+
+	// The firing ship (Fleet::HandleOf), or none for a shot nobody scores.
+	Handle GetOwner() const {
+		return owner;
+	}
+
+private:
+	Vector2    position;
+	Vector2    velocity;
+	WeaponType type;
+	Handle     owner;
+};
+
+inline static Projectile MakeProjectile(WeaponType wt, const Vector2 pos, float speed, float rotationDeg, Handle owner)
+{
+    float rotationRad = DEG2RAD * rotationDeg;
+    Vector2 dir = { sinf(rotationRad), -cosf(rotationRad) };
+    Vector2 vel = Vector2Scale(dir, speed);
+	return Projectile(pos, vel, wt, owner);
+}
+
+// MakeProjectile for lockstep worlds: `pos` on the fixed grid, speed and heading (degrees)
+// as Fixed values, and table trig.
+inline static Projectile MakeProjectileFixed(WeaponType wt, const Vector2 pos, Fixed::Raw speed, Fixed::Raw rotation, Handle owner)
+{
+	const Vector2 vel = { Fixed::ToFloat(Fixed::MulUnit(speed, Fixed::Sin(rotation))), Fixed::ToFloat(-Fixed::MulUnit(speed, Fixed::Cos(rotation))) };
+	return Projectile(pos, vel, wt, owner);
+}
+
+// --- PROJECTILE FIELD ---
+// Structure-of-arrays storage for projectiles, the counterpart of AsteroidField. Ships
+// emit in time order and shots mostly expire in that order too, so the columns are used
+// as a FIFO window of slots [Begin(), End()): new shots are appended at the tail and a
+// kill only leaves a tombstone. Reclaim() drops tombstones from the head, and the live
+// slots are slid back to the front only when the tail runs out of room or tombstones make
+// up most of the window. Per tick that cost follows the shots that expired, not the total.
+// Integration and the bounds test run as SIMD kernels over the window.
+//
+// A slot is 22 bytes: four float columns the kernels stream through, the owner's Handle,
+// then one byte each for the weapon and the tombstone. Damage and radius are looked up
+// from the weapon. A shot outlives its ship often enough, so the owner is a handle rather
+// than a fleet index, which orbiter deaths shift.
+class ProjectileField {
+public:
+	ProjectileField() = default;
+	ProjectileField(const ProjectileField&) = delete;
+	ProjectileField& operator=(const ProjectileField&) = delete;
+
+	// Grows the fixed capacity. Meant for setup; Grow() also doubles it when it must.
+	void Reserve(size_t n) {
+		if (n <= Capacity()) return;
+		posX.resize(n); posY.resize(n);
+		velX.resize(n); velY.resize(n);
+		type.resize(n); owner.resize(n);
+		dead.resize(n);
+	}
+
+	size_t Capacity() const {
+		return posX.size();
+	}
+
+	// Live projectiles.
+	size_t Size() const {
+		return Slots() - tombstones.load(std::memory_order_relaxed);
+	}
+
+	bool Empty() const {
+		return Size() == 0;
+	}
+
+	// The window of slots, live and tombstoned, that every pass walks.
+	size_t Begin() const { return head; }
+	size_t End() const { return tail; }
+	size_t Slots() const { return tail - head; }
+
+	void Clear() {
+		head = tail = 0;
+		tombstones.store(0, std::memory_order_relaxed);
+		++layout;
+	}
+
+	// Bumped whenever live projectiles are renumbered or freed slots are handed out again,
+	// so anything keyed by slot index knows to start over.
+	uint32_t Layout() const { return layout; }
+
+	// Appends n uninitialised live slots and returns the index of the first. Slot indices
+	// move when this compacts, so nothing may hold them across a Grow.
+	size_t Grow(size_t n) {
+		if (tail + n > Capacity()) Compact();
+		if (tail + n > Capacity()) Reserve(std::max(Capacity() * 2, tail + n));
+		size_t first = tail;
+		tail += n;
+		std::fill(dead.begin() + first, dead.begin() + tail, char(0));
+		return first;
+	}
+
+	// Writes n identical projectiles starting at slot `at` (see Grow).
+	void Fill(size_t at, size_t n, Vector2 pos, Vector2 vel, WeaponType wt, Handle owner_) {
+		const size_t end = at + n;
+		std::fill(posX.begin() + at, posX.begin() + end, pos.x);
+		std::fill(posY.begin() + at, posY.begin() + end, pos.y);
+		std::fill(velX.begin() + at, velX.begin() + end, vel.x);
+		std::fill(velY.begin() + at, velY.begin() + end, vel.y);
+		std::fill(type.begin() + at, type.begin() + end, wt);
+		std::fill(owner.begin() + at, owner.begin() + end, owner_);
+	}
+
+	void Add(const Projectile& p) {
+		Fill(Grow(1), 1, p.GetPosition(), p.GetVelocity(), p.GetType(), p.GetOwner());
+	}
+
+	// Advances slots [begin, end) and tombstones the projectiles that left the playfield.
+	// Chunks of the window may run concurrently.
+	void Integrate(float dt, const WorldBounds& bounds, size_t begin, size_t end) {
+		if (fixedPoint) {
+			const int32_t step = Fixed::FromSeconds(dt);
+			Fixed::Advance(posX.data(), velX.data(), step, begin, end);
+			Fixed::Advance(posY.data(), velY.data(), step, begin, end);
+		}
+		else {
+			Simd::Axpy(posX.data(), velX.data(), dt, begin, end);
+			Simd::Axpy(posY.data(), velY.data(), dt, begin, end);
+		}
+		size_t marked = Simd::MarkOutside(posX.data(), posY.data(), nullptr, bounds.width, bounds.height, begin, end, dead.data());
+		if (marked) tombstones.fetch_add(marked, std::memory_order_relaxed);
+	}
+
+	// Moves every slot of the window by (dx, dy).
+	void Translate(float dx, float dy) {
+		for (size_t i = head; i < tail; ++i) {
+			posX[i] += dx;
+			posY[i] += dy;
+		}
+	}
+
+	bool IsDead(size_t i) const {
+		return dead[i] != 0;
+	}
+
+	void Kill(size_t i) {
+		if (dead[i]) return;
+		dead[i] = 1;
+		tombstones.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// End-of-tick cleanup: pops tombstones off the head, and compacts only when they
+	// have taken over the window.
+	void Reclaim() {
+		while (head < tail && dead[head]) {
+			++head;
+			tombstones.fetch_sub(1, std::memory_order_relaxed);
+		}
+		if (head == tail) {
+			if (tail > 0) ++layout;
+			head = tail = 0;
+			return;
+		}
+		size_t t = tombstones.load(std::memory_order_relaxed);
+		if (t > C_MIN_SLACK && t * 2 > Slots()) Compact();
+	}
+
+	Vector2 GetPosition(size_t i) const {
+		return { posX[i], posY[i] };
+	}
+
+	Vector2 GetVelocity(size_t i) const {
+		return { velX[i], velY[i] };
+	}
+
+	float GetRadius(size_t i) const {
+		return Projectile::RadiusOf(type[i]);
+	}
+
+	int GetDamage(size_t i) const {
+		return Projectile::DamageOf(type[i]);
+	}
+
+	WeaponType GetType(size_t i) const {
+		return type[i];
+	}
+
+	// The firing ship, which may have died since (Fleet::Find), or none.
+	Handle GetOwner(size_t i) const {
+		return owner[i];
+	}
+
+	// Compacts the window and renumbers the live slots in the Morton order of their position
+	// over [0, width) x [0, height), as AsteroidField::SortSpatially. A new Layout().
+	void SortSpatially(SpatialOrder::Sorter& sorter, float width, float height) {
+		Compact();
+		sorter.Sort(posX.data(), posY.data(), tail, width, height);
+		const uint32_t* order = sorter.Order().data();
+		SpatialOrder::Permute(posX.data(), order, tail, sortScratch);
+		SpatialOrder::Permute(posY.data(), order, tail, sortScratch);
+		SpatialOrder::Permute(velX.data(), order, tail, sortScratch);
+		SpatialOrder::Permute(velY.data(), order, tail, sortScratch);
+		SpatialOrder::Permute(type.data(), order, tail, sortScratch);
+		SpatialOrder::Permute(owner.data(), order, tail, sortScratch);
+	}
+
+	// Lockstep worlds: integration in Fixed arithmetic. Shots must then be added on the
+	// fixed grid (MakeProjectileFixed, Fleet::SetFixedPoint).
+	void SetFixedPoint(bool on) {
+		fixedPoint = on;
+	}
+
+	// The window's columns as WorldSnapshot sections, tombstones included, so a restored
+	// field reclaims and compacts exactly when this one would have.
+	void Save(WorldSnapshot::Writer& out) const {
+		const size_t n = Slots();
+		out.Add(C_SNAPSHOT_TAG, 0, posX.data() + head, n);
+		out.Add(C_SNAPSHOT_TAG, 1, posY.data() + head, n);
+		out.Add(C_SNAPSHOT_TAG, 2, velX.data() + head, n);
+		out.Add(C_SNAPSHOT_TAG, 3, velY.data() + head, n);
+		out.Add(C_SNAPSHOT_TAG, 4, type.data() + head, n);
+		out.Add(C_SNAPSHOT_TAG, 5, owner.data() + head, n);
+		out.Add(C_SNAPSHOT_TAG, 6, dead.data() + head, n);
+	}
+
+	// Replaces the field with a saved window, moved to slot 0. False, with the field empty,
+	// when the columns are missing or disagree.
+	bool Load(const WorldSnapshot::Reader& in) {
+		Clear();
+		const int64_t n = in.Count(C_SNAPSHOT_TAG, 0, sizeof(float));
+		if (n < 0) return false;
+		const size_t saved = static_cast<size_t>(n);
+		Reserve(saved);
+		bool ok = in.Read(C_SNAPSHOT_TAG, 0, posX.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 1, posY.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 2, velX.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 3, velY.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 4, type.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 5, owner.data(), saved) == n
+			&& in.Read(C_SNAPSHOT_TAG, 6, dead.data(), saved) == n;
+		size_t deadSlots = 0;
+		for (size_t i = 0; ok && i < saved; ++i) {
+			ok = type[i] < WeaponType::COUNT;
+			if (dead[i]) ++deadSlots;
+		}
+		if (!ok) return false;
+		tail = saved;
+		tombstones.store(deadSlots, std::memory_order_relaxed);
+		return true;
+	}
+
+private:
+	static constexpr uint32_t C_SNAPSHOT_TAG = WorldSnapshot::Tag("PROJ");
+
+	// Below this many tombstones a window is never worth compacting.
+	static constexpr size_t C_MIN_SLACK = 256;
+
+	// Slides the live slots down to slot 0 in order, dropping every tombstone.
+	void Compact() {
+		size_t out = 0;
+		for (size_t i = head; i < tail; ++i) {
+			if (dead[i]) continue;
+			if (out != i) {
+				posX[out] = posX[i]; posY[out] = posY[i];
+				velX[out] = velX[i]; velY[out] = velY[i];
+				type[out] = type[i]; owner[out] = owner[i];
+				dead[out] = 0;
+			}
+			++out;
+		}
+		head = 0;
+		tail = out;
+		tombstones.store(0, std::memory_order_relaxed);
+		++layout;
+	}
+
+	std::vector<float>      posX, posY;
+	std::vector<float>      velX, velY;
+	std::vector<WeaponType> type;
+	std::vector<Handle>     owner;
+	std::vector<char>       dead;
+	bool                    fixedPoint = false;
+
+	std::vector<unsigned char> sortScratch;  // SortSpatially's
+
+	size_t              head = 0;
+	size_t              tail = 0;
+	uint32_t            layout = 0;
+	std::atomic<size_t> tombstones{ 0 };
+};
+
+// --- PROJECTILE INSTANCED RENDERER ---
+// Draws every projectile, lasers and bullets alike, with one instanced draw of a unit
+// quad. Per instance only the position, weapon type and colour are uploaded; the vertex
+// shader sizes the quad per type and the fragment shader rounds bullets off.
+class ProjectileBatch {
+public:
+	void Init() {
+		shader = ShaderCache::Load("../resources/shaders/glsl330/projectile_instanced.vs",
+			"../resources/shaders/glsl330/projectile_instanced.fs");
+
+		vao = rlLoadVertexArray();
+		if (!vao) return;
+		rlEnableVertexArray(vao);
+
+		static constexpr float quad[] = { 0, 0, 1, 0, 1, 1,   0, 0, 1, 1, 0, 1 };
+		quadVbo = rlLoadVertexBuffer(quad, static_cast<int>(sizeof(quad)), false);
+		rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, nullptr);
+		rlEnableVertexAttribute(0);
+
+		rlDisableVertexArray();
+	}
+
+	void Unload() {
+		instanceVbo.Unload();
+		if (quadVbo) rlUnloadVertexBuffer(quadVbo);
+		if (vao) rlUnloadVertexArray(vao);
+		UnloadShader(shader);
+		quadVbo = vao = 0;
+	}
+
+	bool IsReady() const {
+		return vao != 0 && shader.id != rlGetShaderIdDefault();
+	}
+
+	// `projectiles` is a ProjectileSnapshot (defined further down, hence the template):
+	// dense, with Size() and per-index GetPosition/GetType.
+	template<typename Snapshot>
+	void Draw(const Snapshot& projectiles) {
+		if (projectiles.Empty()) return;
+
+		instances.resize(projectiles.Size());
+		for (size_t i = 0; i < projectiles.Size(); ++i) {
+			bool bullet = projectiles.GetType(i) == WeaponType::BULLET;
+			instances[i] = { projectiles.GetPosition(i), bullet ? 1.f : 0.f, bullet ? WHITE : RED };
+		}
+
+		if (Trace::Enabled()) Trace::Instance().Instant("rlgl flush");
+		rlDrawRenderBatchActive();
+
+		rlEnableVertexArray(vao);
+		int bytes = static_cast<int>(instances.size() * sizeof(Instance));
+		if (instanceVbo.Reserve(bytes)) {
+			constexpr int STRIDE = static_cast<int>(sizeof(Instance));
+			rlSetVertexAttribute(1, 2, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Instance, position)));
+			rlSetVertexAttribute(2, 1, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Instance, type)));
+			rlSetVertexAttribute(3, 4, RL_UNSIGNED_BYTE, true, STRIDE, reinterpret_cast<void*>(offsetof(Instance, color)));
+			for (unsigned int a = 1; a <= 3; ++a) {
+				rlEnableVertexAttribute(a);
+				rlSetVertexAttributeDivisor(a, 1);
+			}
+		}
+		instanceVbo.Update(instances.data(), bytes);
+
+		rlEnableShader(shader.id);
+		rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP],
+			MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+		rlDrawVertexArrayInstanced(0, 6, static_cast<int>(instances.size()));
+
+		rlDisableShader();
+		rlDisableVertexArray();
+	}
+
+private:
+	struct Instance {
+		Vector2 position;
+		float   type;
+		Color   color;
+	};
+
+	Shader                shader{};
+	unsigned int          vao = 0;
+	unsigned int          quadVbo = 0;
+	StreamBuffer          instanceVbo;
+	std::vector<Instance> instances;
+};
+
+// --- GPU PARTICLES ---
+// An asteroid destroyed in a collision pass, as reported to the renderer.
+struct Explosion {
+	Vector2 position;
+	Vector2 velocity;
+	float   radius;
+};
+
+// Debris and engine trails, simulated entirely in the vertex shader. A particle is written
+// once, when it is emitted: origin, inherited velocity, spawn time and how fast it may fly
+// off. Its direction, speed, lifetime, size and colour are hashed from its slot and spawn
+// time, and its position is the closed-form integral of a drag-damped flight, so a live
+// particle costs the CPU nothing. Particles sit in a fixed ring of C_CAPACITY slots that
+// is drawn whole every frame with one instanced, additive draw; the oldest particles are
+// overwritten when the ring is full, and expired ones collapse to nothing in the shader.
+class ParticleSystem {
+public:
+	static constexpr int C_CAPACITY = 1 << 17;
+
+	void Init() {
+		shader = ResourceCache::LoadShader("../resources/shaders/glsl330/particles.vs",
+			"../resources/shaders/glsl330/particles.fs");
+		timeLoc = GetShaderLocation(shader.Get(), "time");
+		texture = ResourceCache::LoadTexture("../resources/spark_flame.png");
+		if (texture) SamplerPresets::Instance().Register(texture.Get(), SamplerPresets::Class::EFFECT);
+		epoch = GetTime();
+
+		vao = rlLoadVertexArray();
+		if (!vao) return;
+		rlEnableVertexArray(vao);
+
+		static constexpr float quad[] = { 0, 0, 1, 0, 1, 1,   0, 0, 1, 1, 0, 1 };
+		quadVbo = rlLoadVertexBuffer(quad, static_cast<int>(sizeof(quad)), false);
+		rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, nullptr);
+		rlEnableVertexAttribute(0);
+
+		instanceVbo = rlLoadVertexBuffer(nullptr, C_CAPACITY * static_cast<int>(sizeof(Particle)), true);
+		constexpr int STRIDE = static_cast<int>(sizeof(Particle));
+		rlSetVertexAttribute(1, 2, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Particle, origin)));
+		rlSetVertexAttribute(2, 2, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Particle, velocity)));
+		rlSetVertexAttribute(3, 1, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Particle, spawnTime)));
+		rlSetVertexAttribute(4, 1, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Particle, spread)));
+		for (unsigned int a = 1; a <= 4; ++a) {
+			rlEnableVertexAttribute(a);
+			rlSetVertexAttributeDivisor(a, 1);
+		}
+
+		rlDisableVertexArray();
+		head = 0;
+		used = 0;
+	}
+
+	void Unload() {
+		if (instanceVbo) rlUnloadVertexBuffer(instanceVbo);
+		if (quadVbo) rlUnloadVertexBuffer(quadVbo);
+		if (vao) rlUnloadVertexArray(vao);
+		if (texture) SamplerPresets::Instance().Forget(texture.Get().id);
+		texture.Release();
+		shader.Release();
+		instanceVbo = quadVbo = vao = 0;
+	}
+
+	bool IsReady() const {
+		return vao != 0 && shader && texture;
+	}
+
+	// Seconds on the particle clock; spawn times are stored relative to Init so they keep
+	// float precision in long sessions.
+	float Now() const {
+		return static_cast<float>(GetTime() - epoch);
+	}
+
+	// `count` particles leave `origin` at `velocity` plus up to `spread` px/s in a random
+	// direction. Only staged here; Draw() uploads them.
+	void Burst(Vector2 origin, Vector2 velocity, float spread, int count) {
+		const float now = Now();
+		for (int k = 0; k < count; ++k) {
+			pending.push_back({ origin, velocity, now, spread });
+		}
+	}
+
+	void Explode(const Explosion& e) {
+		Burst(e.position, e.velocity, e.radius * C_DEBRIS_SPEED, static_cast<int>(e.radius * C_DEBRIS_PER_PX * particleShare));
+	}
+
+	// A frame's explosions, merged first when the budget says so.
+	void Explode(const std::vector<Explosion>& list) {
+		if (!mergeExplosions) {
+			for (const Explosion& e : list) Explode(e);
+			return;
+		}
+		Merge(list);
+		for (const Explosion& e : merged) Explode(e);
+	}
+
+	// Back-pressure (FrameGovernor): bursts and trails emit `share` of their particles, and
+	// with `merge` a frame's explosions in the same C_MERGE_CELL square go off as one.
+	void SetBudget(float share, bool merge) {
+		particleShare = share;
+		mergeExplosions = merge;
+	}
+
+	// Engine exhaust for every ship that moved over its last tick, out of the back of the
+	// sprite at C_TRAIL_RATE particles per second of frame time. `offset` takes the ships'
+	// positions to world coordinates, which particles are kept in (World::Origin).
+	template<typename Ships>
+	void EmitTrails(const Ships& ships, float alpha, float frameTime, Vector2 offset) {
+		trailCarry += frameTime * C_TRAIL_RATE * particleShare;
+		const int n = static_cast<int>(trailCarry);
+		trailCarry -= static_cast<float>(n);
+		if (n == 0) return;
+		for (size_t i = 0; i < ships.Size(); ++i) {
+			if (!ships.alive[i]) continue;
+			if (ships.x[i] == ships.prevX[i] && ships.y[i] == ships.prevY[i]) continue;
+			float rotRad = DEG2RAD * Lerp(ships.prevRotation[i], ships.rotation[i], alpha);
+			Vector2 facing = { sinf(rotRad), -cosf(rotRad) };
+			float r = ships.spriteSize.x * ships.scale[i] * 0.5f;
+			Vector2 pos = { Lerp(ships.prevX[i], ships.x[i], alpha) + offset.x, Lerp(ships.prevY[i], ships.y[i], alpha) + offset.y };
+			Burst({ pos.x - facing.x * r, pos.y - facing.y * r },
+				{ -facing.x * C_TRAIL_SPEED, -facing.y * C_TRAIL_SPEED }, C_TRAIL_SPREAD, n);
+		}
+	}
+
+	void Draw() {
+		Upload();
+		if (used == 0) return;
+
+		if (Trace::Enabled()) Trace::Instance().Instant("rlgl flush");
+		rlDrawRenderBatchActive();
+		rlSetBlendMode(RL_BLEND_ADDITIVE);
+
+		rlEnableVertexArray(vao);
+		const Shader& program = shader.Get();
+		rlEnableShader(program.id);
+		rlSetUniformMatrix(program.locs[SHADER_LOC_MATRIX_MVP],
+			MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+		float now = Now();
+		rlSetUniform(timeLoc, &now, RL_SHADER_UNIFORM_FLOAT, 1);
+		int slot = 0;
+		rlSetUniform(program.locs[SHADER_LOC_MAP_DIFFUSE], &slot, RL_SHADER_UNIFORM_INT, 1);
+		rlActiveTextureSlot(0);
+		rlEnableTexture(texture.Get().id);
+
+		rlDrawVertexArrayInstanced(0, 6, used);
+
+		rlDisableTexture();
+		rlDisableShader();
+		rlDisableVertexArray();
+		rlSetBlendMode(RL_BLEND_ALPHA);
+	}
+
+private:
+	struct Particle {
+		Vector2 origin;
+		Vector2 velocity;
+		float   spawnTime;
+		float   spread;
+	};
+
+	// One explosion per C_MERGE_CELL square into `merged`, at the area-weighted centre and
+	// velocity of those in it and with their combined area, so a chain of kills costs one
+	// burst of about the particles of its largest kill.
+	void Merge(const std::vector<Explosion>& list) {
+		keyed.clear();
+		for (size_t i = 0; i < list.size(); ++i) {
+			const uint32_t cx = static_cast<uint32_t>(static_cast<int32_t>(floorf(list[i].position.x / C_MERGE_CELL)));
+			const uint32_t cy = static_cast<uint32_t>(static_cast<int32_t>(floorf(list[i].position.y / C_MERGE_CELL)));
+			keyed.push_back({ static_cast<uint64_t>(cx) << 32 | cy, static_cast<uint32_t>(i) });
+		}
+		std::sort(keyed.begin(), keyed.end());
+		merged.clear();
+		for (size_t i = 0; i < keyed.size();) {
+			Vector2 position = { 0.f, 0.f };
+			Vector2 velocity = { 0.f, 0.f };
+			float area = 0.f;
+			size_t j = i;
+			for (; j < keyed.size() && keyed[j].first == keyed[i].first; ++j) {
+				const Explosion& e = list[keyed[j].second];
+				const float w = e.radius * e.radius;
+				position.x += e.position.x * w; position.y += e.position.y * w;
+				velocity.x += e.velocity.x * w; velocity.y += e.velocity.y * w;
+				area += w;
+			}
+			if (area > 0.f) {
+				merged.push_back({ { position.x / area, position.y / area }, { velocity.x / area, velocity.y / area }, sqrtf(area) });
+			}
+			i = j;
+		}
+	}
+
+	// Copies the staged particles into the ring, in at most two sub-data updates.
+	void Upload() {
+		if (pending.empty()) return;
+		const Particle* src = pending.data();
+		int n = static_cast<int>(pending.size());
+		if (n > C_CAPACITY) {
+			src += n - C_CAPACITY;
+			n = C_CAPACITY;
+		}
+		constexpr int SIZE = static_cast<int>(sizeof(Particle));
+		int first = n < C_CAPACITY - head ? n : C_CAPACITY - head;
+		rlUpdateVertexBuffer(instanceVbo, src, first * SIZE, head * SIZE);
+		if (n > first) rlUpdateVertexBuffer(instanceVbo, src + first, (n - first) * SIZE, 0);
+		head = (head + n) % C_CAPACITY;
+		used = used + n < C_CAPACITY ? used + n : C_CAPACITY;
+		pending.clear();
+	}
+
+	static constexpr float C_DEBRIS_SPEED = 6.f;   // px/s of spread per px of radius
+	static constexpr float C_DEBRIS_PER_PX = 1.f;  // particles per px of radius
+	static constexpr float C_TRAIL_RATE = 120.f;
+	static constexpr float C_TRAIL_SPEED = 120.f;
+	static constexpr float C_TRAIL_SPREAD = 30.f;
+	static constexpr float C_MERGE_CELL = 64.f;    // px
+
+	ResourceCache::ShaderHandle  shader;
+	ResourceCache::TextureHandle texture;
+	int                          timeLoc = -1;
+	double                       epoch = 0.0;
+	unsigned int                 vao = 0;
+	unsigned int                 quadVbo = 0;
+	unsigned int                 instanceVbo = 0;
+	int                          head = 0;
+	int                          used = 0;
+	float                        trailCarry = 0.f;
+	float                        particleShare = 1.f;
+	bool                         mergeExplosions = false;
+	std::vector<Particle>        pending;
+	std::vector<std::pair<uint64_t, uint32_t>> keyed;  // Merge's (cell, explosion) pairs
+	std::vector<Explosion>       merged;
+};
+
+// --- SPRITE ATLAS ---
+// One texture holding the ship sprite, the HUD font and a white texel for raylib's shape
+// drawing. Everything the rlgl batch draws then samples the same texture, so ships, text
+// and fallback projectile shapes share one draw call instead of flushing on every switch.
+// The ship is baked at each scale it is drawn at, which stands in for the mipmaps a
+// shared texture can't have without bleeding into the glyphs.
+class SpriteAtlas {
+public:
+	static constexpr float C_SHIP_SCALES[] = { 0.3f, 0.18f };
+	static constexpr int   C_SHIP_LODS = static_cast<int>(sizeof(C_SHIP_SCALES) / sizeof(C_SHIP_SCALES[0]));
+
+	void Build(const Image& ship) {
+		const Font& def = GetFontDefault();
+
+		// Single shelf, left to right, 2 px apart.
+		constexpr int PAD = 2;
+		int x = PAD;
+		int height = def.texture.height;
+		for (int l = 0; l < C_SHIP_LODS; ++l) {
+			int w = static_cast<int>(ship.width * C_SHIP_SCALES[l]);
+			int h = static_cast<int>(ship.height * C_SHIP_SCALES[l]);
+			shipRegion[l] = { (float)x, (float)PAD, (float)w, (float)h };
+			x += w + PAD;
+			if (h > height) height = h;
+		}
+		Vector2 fontOrigin = { (float)x, (float)PAD };
+		x += def.texture.width + PAD;
+		whiteRegion = { (float)x + 1, (float)PAD + 1, 1, 1 };
+		x += 3 + PAD;
+
+		// One copy of the ship, shrunk in place from each scale to the next (they run largest
+		// first), rather than a fresh copy of the full-size image per scale.
+		Image atlas = GenImageColor(x, height + 2 * PAD, BLANK);
+		Image lod = ImageCopy(ship);
+		for (int l = 0; l < C_SHIP_LODS; ++l) {
+			ImageResize(&lod, (int)shipRegion[l].width, (int)shipRegion[l].height);
+			ImageDraw(&atlas, lod, { 0, 0, (float)lod.width, (float)lod.height }, shipRegion[l], WHITE);
+		}
+		UnloadImage(lod);
+
+		// The default font keeps a CPU copy of every glyph; re-pack them at the same
+		// relative offsets so the font's metrics carry over unchanged.
+		font = def;
+		font.recs = static_cast<Rectangle*>(RL_MALLOC(def.glyphCount * sizeof(Rectangle)));
+		for (int i = 0; i < def.glyphCount; ++i) {
+			Rectangle r = def.recs[i];
+			r.x += fontOrigin.x;
+			r.y += fontOrigin.y;
+			font.recs[i] = r;
+			const Image& glyph = def.glyphs[i].image;
+			ImageDraw(&atlas, glyph, { 0, 0, (float)glyph.width, (float)glyph.height }, r, WHITE);
+		}
+		ImageDrawRectangle(&atlas, (int)whiteRegion.x - 1, (int)whiteRegion.y - 1, 3, 3, WHITE);
+
+		texture = LoadTextureFromImage(atlas);
+		UnloadImage(atlas);
+		SamplerPresets::Instance().Register(texture, SamplerPresets::Class::INTERFACE);
+		font.texture = texture;
+
+		SetShapesTexture(texture, whiteRegion);
+	}
+
+	void Unload() {
+		if (!texture.id) return;
+		SetShapesTexture(Texture2D{ rlGetTextureIdDefault(), 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 }, Rectangle{ 0, 0, 1, 1 });
+		RL_FREE(font.recs);
+		SamplerPresets::Instance().Forget(texture.id);
+		UnloadTexture(texture);
+		texture = {};
+		font = {};
+	}
+
+	bool IsReady() const {
+		return texture.id != 0;
+	}
+
+	const Texture2D& Texture() const {
+		return texture;
+	}
+
+	const Font& HudFont() const {
+		return font;
+	}
+
+	// The baked ship closest in size to `scale`.
+	Rectangle ShipSource(float scale) const {
+		int best = 0;
+		for (int l = 1; l < C_SHIP_LODS; ++l) {
+			if (fabsf(C_SHIP_SCALES[l] - scale) < fabsf(C_SHIP_SCALES[best] - scale)) best = l;
+		}
+		return shipRegion[best];
+	}
+
+private:
+	Texture2D texture{};
+	Font      font{};
+	Rectangle shipRegion[C_SHIP_LODS]{};
+	Rectangle whiteRegion{};
+};
+
+// --- SPRITE BATCH ---
+// Collects rotated textured quads for the frame and submits them in one rlBegin/rlEnd
+// block on a single texture. Corner math is DrawTexturePro's. Made per frame, with the
+// quads in the frame's arena.
+class SpriteBatch {
+public:
+	explicit SpriteBatch(std::pmr::memory_resource* arena) : quads(arena) {}
+
+	void Add(Rectangle source, Rectangle dest, Vector2 origin, float rotationDeg, Color tint) {
+		quads.push_back({ source, dest, origin, rotationDeg, tint });
+	}
+
+	void Flush(const Texture2D& texture) {
+		if (quads.empty()) return;
+		const float invW = 1.f / texture.width;
+		const float invH = 1.f / texture.height;
+
+		rlSetTexture(texture.id);
+		rlBegin(RL_QUADS);
+		rlNormal3f(0.0f, 0.0f, 1.0f);
+		for (const Quad& q : quads) {
+			float s = sinf(q.rotation * DEG2RAD);
+			float c = cosf(q.rotation * DEG2RAD);
+			float dx = -q.origin.x;
+			float dy = -q.origin.y;
+			float dx1 = dx + q.dest.width;
+			float dy1 = dy + q.dest.height;
+
+			float u0 = q.source.x * invW, u1 = (q.source.x + q.source.width) * invW;
+			float v0 = q.source.y * invH, v1 = (q.source.y + q.source.height) * invH;
+
+			rlColor4ub(q.tint.r, q.tint.g, q.tint.b, q.tint.a);
+			rlTexCoord2f(u0, v0); rlVertex2f(q.dest.x + dx * c - dy * s, q.dest.y + dx * s + dy * c);
+			rlTexCoord2f(u0, v1); rlVertex2f(q.dest.x + dx * c - dy1 * s, q.dest.y + dx * s + dy1 * c);
+			rlTexCoord2f(u1, v1); rlVertex2f(q.dest.x + dx1 * c - dy1 * s, q.dest.y + dx1 * s + dy1 * c);
+			rlTexCoord2f(u1, v0); rlVertex2f(q.dest.x + dx1 * c - dy * s, q.dest.y + dx1 * s + dy * c);
+		}
+		rlEnd();
+		rlSetTexture(0);
+		quads.clear();
+	}
+
+private:
+	struct Quad {
+		Rectangle source;
+		Rectangle dest;
+		Vector2   origin;
+		float     rotation;
+		Color     tint;
+	};
+
+	ArenaVector<Quad> quads;
+};
+
+// --- ORBITER BATCH ---
+// Every orbiter in one instanced draw, placed by the vertex shader. All orbits turn at the
+// same rate (Fleet::C_ORBIT_SPEED), so however deep the tree is it turns rigidly about the
+// player: an orbiter's offset from the player, resolved down its parent chain once
+// (Fleet::CaptureOrbits), is all the shader needs to find it at any later time, by
+// rotating the offset by the time since. The table is only sent again when the tree
+// changes (or to leave float drift behind, see Application::PostOrbits), so a frame costs
+// one draw call and a few uniforms however many orbiters there are.
+class OrbiterBatch {
+public:
+	struct Orbit {
+		Vector2 offset;    // from the player, when the table was captured
+		float   rotation;  // of the sprite, degrees
+		float   scale;
+	};
+
+	void Init() {
+		shader = ShaderCache::Load("../resources/shaders/glsl330/orbiter_instanced.vs",
+			"../resources/shaders/glsl330/orbiter_instanced.fs");
+		centreLoc = GetShaderLocation(shader, "centre");
+		spriteSizeLoc = GetShaderLocation(shader, "spriteSize");
+
+		vao = rlLoadVertexArray();
+		if (!vao) return;
+		rlEnableVertexArray(vao);
+
+		static constexpr float quad[] = { 0, 0, 1, 0, 1, 1,   0, 0, 1, 1, 0, 1 };
+		quadVbo = rlLoadVertexBuffer(quad, static_cast<int>(sizeof(quad)), false);
+		rlSetVertexAttribute(0, 2, RL_FLOAT, false, 0, nullptr);
+		rlEnableVertexAttribute(0);
+
+		rlDisableVertexArray();
+		version = UINT64_MAX;
+		count = 0;
+	}
+
+	void Unload() {
+		instanceVbo.Unload();
+		if (quadVbo) rlUnloadVertexBuffer(quadVbo);
+		if (vao) rlUnloadVertexArray(vao);
+		UnloadShader(shader);
+		quadVbo = vao = 0;
+	}
+
+	bool IsReady() const {
+		return vao != 0 && shader.id != rlGetShaderIdDefault();
+	}
+
+	// Sends `orbits` unless the buffer already holds table `version`. Each sprite's atlas
+	// rectangle is looked up here, once, rather than in the shader.
+	void Upload(const std::vector<Orbit>& orbits, uint64_t version_, const SpriteAtlas& atlas) {
+		if (version_ == version) return;
+		version = version_;
+		count = orbits.size();
+		if (count == 0) return;
+
+		const float invW = 1.f / static_cast<float>(atlas.Texture().width);
+		const float invH = 1.f / static_cast<float>(atlas.Texture().height);
+		instances.resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			const Rectangle r = atlas.ShipSource(orbits[i].scale);
+			instances[i] = { orbits[i], { r.x * invW, r.y * invH, r.width * invW, r.height * invH } };
+		}
+
+		rlEnableVertexArray(vao);
+		const int bytes = static_cast<int>(count * sizeof(Instance));
+		if (instanceVbo.Reserve(bytes)) {
+			constexpr int STRIDE = static_cast<int>(sizeof(Instance));
+			rlSetVertexAttribute(1, 4, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Instance, orbit)));
+			rlSetVertexAttribute(2, 4, RL_FLOAT, false, STRIDE, reinterpret_cast<void*>(offsetof(Instance, source)));
+			for (unsigned int a = 1; a <= 2; ++a) {
+				rlEnableVertexAttribute(a);
+				rlSetVertexAttributeDivisor(a, 1);
+			}
+		}
+		instanceVbo.Update(instances.data(), bytes);
+		rlDisableVertexArray();
+	}
+
+	// The uploaded orbiters around a player at `player` whose tree has turned `angle`
+	// radians since the table was captured.
+	void Draw(Vector2 player, float angle, Vector2 spriteSize, const Texture2D& texture) {
+		if (count == 0) return;
+
+		if (Trace::Enabled()) Trace::Instance().Instant("rlgl flush");
+		rlDrawRenderBatchActive();
+
+		rlEnableVertexArray(vao);
+		rlEnableShader(shader.id);
+		rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP],
+			MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection()));
+		Vector3 centre = { player.x, player.y, angle };
+		rlSetUniform(centreLoc, &centre, RL_SHADER_UNIFORM_VEC3, 1);
+		rlSetUniform(spriteSizeLoc, &spriteSize, RL_SHADER_UNIFORM_VEC2, 1);
+		int slot = 0;
+		rlSetUniform(shader.locs[SHADER_LOC_MAP_DIFFUSE], &slot, RL_SHADER_UNIFORM_INT, 1);
+		rlActiveTextureSlot(0);
+		rlEnableTexture(texture.id);
+
+		rlDrawVertexArrayInstanced(0, 6, static_cast<int>(count));
+
+		rlDisableTexture();
+		rlDisableShader();
+		rlDisableVertexArray();
+	}
+
+private:
+	struct Instance {
+		Orbit     orbit;
+		Rectangle source;  // texture coordinates
+	};
+
+	Shader                shader{};
+	int                   centreLoc = -1;
+	int                   spriteSizeLoc = -1;
+	unsigned int          vao = 0;
+	unsigned int          quadVbo = 0;
+	StreamBuffer          instanceVbo;
+	std::vector<Instance> instances;
+	size_t                count = 0;
+	uint64_t              version = UINT64_MAX;
+};
+
+// --- HUD ---
+// HP/Weapon/Score rendered into a small render texture that is only redrawn when one of
+// the three values changes; every other frame the HUD is a single textured quad.
+class HudCache {
+public:
+	void Init() {
+		target = LoadRenderTexture(C_WIDTH, C_HEIGHT);
+		dirty = true;
+	}
+
+	void Unload() {
+		if (target.id) UnloadRenderTexture(target);
+		target = {};
+	}
+
+	bool IsReady() const {
+		return target.id != 0;
+	}
+
+	// Must run outside any other texture mode, before the frame's scene drawing, so the
+	// re-render doesn't split the gameplay batch.
+	void Update(const Font& font, int hp, WeaponType weapon, int score) {
+		if (!dirty && hp == lastHp && weapon == lastWeapon && score == lastScore) return;
+		lastHp = hp;
+		lastWeapon = weapon;
+		lastScore = score;
+		dirty = false;
+
+		BeginTextureMode(target);
+		ClearBackground(BLANK);
+		DrawTextEx(font, TextFormat("HP: %d", hp), { 10, 10 }, 20, 2, GREEN);
+		const char* weaponName = (weapon == WeaponType::LASER) ? "LASER" : "BULLET";
+		DrawTextEx(font, TextFormat("Weapon: %s", weaponName), { 10, 40 }, 20, 2, BLUE);
+		DrawTextEx(font, TextFormat("Score: %d", score), { 10, 70 }, 20, 2, YELLOW);
+		EndTextureMode();
+	}
+
+	void Draw() const {
+		// Render textures are stored bottom-up, hence the negative source height.
+		DrawTextureRec(target.texture, { 0, 0, (float)C_WIDTH, -(float)C_HEIGHT }, { 0, 0 }, WHITE);
+	}
+
+private:
+	static constexpr int C_WIDTH = 320;
+	static constexpr int C_HEIGHT = 100;
+
+	RenderTexture2D target{};
+	bool            dirty = true;
+	int             lastHp = 0;
+	WeaponType      lastWeapon = WeaponType::LASER;
+	int             lastScore = 0;
+};
+
+// --- DYNAMIC RESOLUTION ---
+// Renders the world into an offscreen target at a fraction of the window's size, which
+// PostStack then stretches over the window, so a fill-rate-bound GPU holds the frame rate. The
+// fraction follows the GPU time the scene takes, measured with timer queries that are
+// read a few frames late so nothing stalls: it drops at once when the scene overruns its
+// budget and creeps back up while there is headroom. The target is allocated once at
+// full size and the scene only uses its lower-left corner, so a new scale never
+// reallocates. Without timer queries the scale simply stays at 1.
+class DynamicResolution {
+public:
+	void Init(int w, int h, float frameSeconds) {
+		width = w;
+		height = h;
+		budgetMs = frameSeconds * 1000.f * C_BUDGET;
+		target = LoadRenderTexture(w, h);
+		if (target.id) SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+		timed = GLAD_GL_VERSION_3_3 != 0;
+		if (timed) glGenQueries(C_QUERIES, queries);
+		issued = collected = 0;
+		scale = 1.f;
+		settle = 0;
+		gpuMs = 0.f;
+	}
+
+	void Unload() {
+		if (timed) glDeleteQueries(C_QUERIES, queries);
+		timed = false;
+		if (target.id) UnloadRenderTexture(target);
+		target = {};
+	}
+
+	bool IsReady() const {
+		return target.id != 0;
+	}
+
+	float Scale() const {
+		return scale;
+	}
+
+	// Latest measured GPU time of the scene pass, 0 until one has come back.
+	float GpuMs() const {
+		return gpuMs;
+	}
+
+	// Redirects drawing into the target. World coordinates are unchanged: only the
+	// viewport shrinks.
+	void BeginScene() {
+		Collect();
+		BeginTextureMode(target);
+		ClearBackground(BLACK);
+		rlViewport(0, 0, ScaledWidth(), ScaledHeight());
+		timing = timed && issued - collected < C_QUERIES;
+		if (timing) glBeginQuery(GL_TIME_ELAPSED, queries[issued % C_QUERIES]);
+	}
+
+	void EndScene() {
+		rlDrawRenderBatchActive();
+		if (timing) {
+			glEndQuery(GL_TIME_ELAPSED);
+			++issued;
+		}
+		EndTextureMode();
+	}
+
+	const Texture2D& SceneTexture() const {
+		return target.texture;
+	}
+
+	// The part of SceneTexture() the last scene covered, ready for DrawTexturePro. Render
+	// textures are stored bottom-up, hence the negative height.
+	Rectangle SceneSource() const {
+		return { 0.f, 0.f, static_cast<float>(ScaledWidth()), -static_cast<float>(ScaledHeight()) };
+	}
+
+private:
+	static constexpr int   C_QUERIES = 4;
+	static constexpr float C_BUDGET = 0.75f;     // share of the frame the scene may take; the rest is blit, HUD, present
+	static constexpr float C_HEADROOM = 0.6f;    // grow back while under this share of the budget
+	static constexpr float C_STEP = 1.f / 16.f;
+	static constexpr float C_MIN_SCALE = 0.5f;
+	static constexpr int   C_SETTLE_FRAMES = 10; // measurements ignored after a change
+
+	int ScaledWidth() const { return std::max(1, static_cast<int>(static_cast<float>(width) * scale + 0.5f)); }
+	int ScaledHeight() const { return std::max(1, static_cast<int>(static_cast<float>(height) * scale + 0.5f)); }
+
+	// Reads back every query that has finished, oldest first.
+	void Collect() {
+		while (collected < issued) {
+			unsigned int id = queries[collected % C_QUERIES];
+			GLint available = 0;
+			glGetQueryObjectiv(id, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available) break;
+			GLuint64 ns = 0;
+			glGetQueryObjectui64v(id, GL_QUERY_RESULT, &ns);
+			++collected;
+			Adapt(static_cast<float>(ns) * 1e-6f);
+		}
+	}
+
+	// Fill cost goes with the pixel count, the square of the scale, so an overrun is
+	// corrected in one step; growing back is one notch at a time.
+	void Adapt(float ms) {
+		gpuMs = ms;
+		if (settle > 0) {
+			--settle;
+			return;
+		}
+		float next = scale;
+		if (ms > budgetMs) next = floorf(scale * sqrtf(budgetMs / ms) / C_STEP) * C_STEP;
+		else if (ms < budgetMs * C_HEADROOM) next = scale + C_STEP;
+		next = std::clamp(next, C_MIN_SCALE, 1.f);
+		if (next != scale) {
+			scale = next;
+			settle = C_SETTLE_FRAMES;
+		}
+	}
+
+	RenderTexture2D target{};
+	int             width = 0;
+	int             height = 0;
+	float           budgetMs = 0.f;
+	float           scale = 1.f;
+	float           gpuMs = 0.f;
+	int             settle = 0;
+	bool            timed = false;
+	bool            timing = false;
+	unsigned int    queries[C_QUERIES] = {};
+	uint64_t        issued = 0;
+	uint64_t        collected = 0;
+};
+
+// --- POST-PROCESS STACK ---
+// Full-screen effects, applied while the scene is stretched onto the window. Per-pixel
+// effects (post_<name>.glsl, one function each) are pasted into one generated shader, so
+// any number of them cost the single pass the upscale needed anyway. Only effects that
+// read a neighbourhood get passes of their own, at half resolution or below: BLUR swaps
+// the scene for a separably blurred copy, BLOOM adds glow from a mip chain (see
+// AddBloom). One generated shader is kept per effect set. The passes are a FrameGraph,
+// built when the effect set changes: every effect's passes are declared and the composite
+// reads only the enabled ones, so the rest are culled, and the half-resolution targets
+// share textures where their passes don't overlap (blur's scratch becomes bloom's first
+// level). Effects that are off hold no render targets.
+class PostStack {
+public:
+	enum Effect : uint32_t {
+		POSTERIZE = 1u << 0,
+		GRAYSCALE = 1u << 1,
+		PREDATOR  = 1u << 2,
+		SCANLINES = 1u << 3,
+		BLUR      = 1u << 4,
+		BLOOM     = 1u << 5,
+	};
+
+	// Comma-separated effect names, e.g. "bloom,scanlines". False on an unknown name.
+	static bool Parse(const char* list, uint32_t& out) {
+		out = 0;
+		int count = 0;
+		const char** names = TextSplit(list, ',', &count);
+		for (int k = 0; k < count; ++k) {
+			const EffectInfo* info = Find(names[k]);
+			if (!info) return false;
+			out |= info->bit;
+		}
+		return true;
+	}
+
+	void Init(int w, int h) {
+		width = w;
+		height = h;
+		halfW = std::max(1, w / 2);
+		halfH = std::max(1, h / 2);
+		built = false;
+		blur = ShaderCache::Load(nullptr, "../resources/shaders/glsl330/post_blur.fs");
+		bright = ShaderCache::Load(nullptr, "../resources/shaders/glsl330/post_bright.fs");
+		directionLoc = GetShaderLocation(blur, "direction");
+		float threshold = C_BLOOM_THRESHOLD;
+		SetShaderValue(bright, GetShaderLocation(bright, "threshold"), &threshold, SHADER_UNIFORM_FLOAT);
+		ready = blur.id != rlGetShaderIdDefault() && bright.id != rlGetShaderIdDefault();
+	}
+
+	void Unload() {
+		graph.Unload();
+		built = false;
+		UnloadShader(blur);
+		UnloadShader(bright);
+		for (Fused& f : fused) UnloadShader(f.shader);
+		fused.clear();
+		ready = false;
+	}
+
+	// Can be set before Init.
+	void SetEffects(uint32_t mask) {
+		effects = mask;
+	}
+
+	uint32_t Effects() const {
+		return effects;
+	}
+
+	// Full-screen passes Present draws for the current effects: the graph's, once built.
+	int Passes() const {
+		if (!effects || !built) return 1;
+		const FrameGraph::Stats& stats = graph.GetStats();
+		return stats.passes - stats.culled;
+	}
+
+	// The effect set's render targets and the textures behind them (FrameGraph::Stats);
+	// all zero without effects.
+	FrameGraph::Stats Targets() const {
+		return effects && built ? graph.GetStats() : FrameGraph::Stats{};
+	}
+
+	// Draws the `source` part of `scene` over the whole window, through the effects. With
+	// none set, or if their shader or targets didn't build, it is a plain bilinear upscale.
+	void Present(const Texture2D& scene, Rectangle source) {
+		const Fused* f = effects && ready ? Get(effects) : nullptr;
+		if (f && (!built || builtEffects != effects)) Build();
+		if (!f && built) {
+			// Effects off (or their shader gone): the targets go with them until a set is on again.
+			graph.Unload();
+			built = false;
+		}
+		if (!f || !graph.Complete()) {
+			DrawTexturePro(scene, source, Window(), { 0.f, 0.f }, 0.f, WHITE);
+			return;
+		}
+		sceneSource = source;
+		graph.Bind(sceneHandle, scene);
+		graph.Execute();
+	}
+
+private:
+	struct EffectInfo {
+		Effect      bit;
+		const char* name;
+		const char* file;      // per-pixel snippet, or nullptr for a neighbourhood effect
+		const char* function;
+	};
+
+	// Per-pixel effects run in this order.
+	static constexpr EffectInfo C_EFFECTS[] = {
+		{ POSTERIZE, "posterize", "../resources/shaders/glsl330/post_posterize.glsl", "Posterize" },
+		{ GRAYSCALE, "grayscale", "../resources/shaders/glsl330/post_grayscale.glsl", "Grayscale" },
+		{ PREDATOR,  "predator",  "../resources/shaders/glsl330/post_predator.glsl",  "Predator" },
+		{ SCANLINES, "scanlines", "../resources/shaders/glsl330/post_scanlines.glsl", "Scanlines" },
+		{ BLUR,      "blur",      nullptr, nullptr },
+		{ BLOOM,     "bloom",     nullptr, nullptr },
+	};
+
+	static constexpr int   C_BLOOM_LEVELS = 5;     // half resolution down to 1/32
+	static constexpr float C_BLOOM_THRESHOLD = 0.6f;
+	static constexpr float C_BLOOM_STRENGTH = 1.0f / C_BLOOM_LEVELS;  // each level adds its share
+
+	struct Fused {
+		uint32_t effects;
+		Shader   shader;
+		int      sceneScaleLoc;
+		int      blurredLoc;
+		int      bloomLoc;
+		int      strengthLoc;
+	};
+
+	static const EffectInfo* Find(const char* name) {
+		for (const EffectInfo& e : C_EFFECTS) {
+			if (TextIsEqual(name, e.name)) return &e;
+		}
+		return nullptr;
+	}
+
+	// The fused shader for `mask`, generated on first use; nullptr if it failed to build.
+	const Fused* Get(uint32_t mask) {
+		for (const Fused& f : fused) {
+			if (f.effects == mask) return f.shader.id != rlGetShaderIdDefault() ? &f : nullptr;
+		}
+		std::string source = Generate(mask);
+		Fused f{ mask, ShaderCache::LoadFromMemory(nullptr, source.c_str()), -1, -1, -1, -1 };
+		f.sceneScaleLoc = GetShaderLocation(f.shader, "sceneScale");
+		f.blurredLoc = GetShaderLocation(f.shader, "blurred");
+		f.bloomLoc = GetShaderLocation(f.shader, "bloom");
+		f.strengthLoc = GetShaderLocation(f.shader, "bloomStrength");
+		if (f.shader.id == rlGetShaderIdDefault()) TraceLog(LOG_WARNING, "POST: effect set 0x%x did not build, drawing without it", mask);
+		fused.push_back(f);
+		return Get(mask);
+	}
+
+	static std::string Generate(uint32_t mask) {
+		std::string src =
+			"#version 330\n\n"
+			"in vec2 fragTexCoord;\n"
+			"in vec4 fragColor;\n\n"
+			"uniform sampler2D texture0;\n"
+			"uniform sampler2D blurred;\n"
+			"uniform sampler2D bloom;\n"
+			"uniform vec2 sceneScale;\n"
+			"uniform float bloomStrength;\n\n"
+			"out vec4 finalColor;\n\n";
+		for (const EffectInfo& e : C_EFFECTS) {
+			if (!(mask & e.bit) || !e.file) continue;
+			char* text = LoadFileText(e.file);
+			if (text) {
+				src += text;
+				src += "\n";
+				UnloadFileText(text);
+			}
+		}
+		src += "void main()\n{\n    vec2 uv = fragTexCoord/sceneScale;\n";
+		src += (mask & BLUR) ? "    vec3 color = texture(blurred, uv).rgb;\n" : "    vec3 color = texture(texture0, fragTexCoord).rgb;\n";
+		if (mask & BLOOM) src += "    color += texture(bloom, uv).rgb*bloomStrength;\n";
+		for (const EffectInfo& e : C_EFFECTS) {
+			if (!(mask & e.bit) || !e.file) continue;
+			src += "    color = ";
+			src += e.function;
+			src += "(color, gl_FragCoord.xy);\n";
+		}
+		src += "    finalColor = vec4(color, 1.0);\n}\n";
+		return src;
+	}
+
+	Rectangle Window() const {
+		return { 0.f, 0.f, static_cast<float>(width), static_cast<float>(height) };
+	}
+
+	// Declares every effect's passes and a composite reading the enabled ones into the
+	// window, then compiles: culling, ordering and target aliasing happen here, once per
+	// effect set, and Present only executes.
+	void Build() {
+		graph.Reset();
+		sceneHandle = graph.Import("scene");
+		const FrameGraph::Handle blurred = AddBlur("blur", AddDownsample("blur downsample", sceneHandle, graph.Create("blur", halfW, halfH), nullptr),
+			graph.Create("blur scratch", halfW, halfH));
+		const FrameGraph::Handle glow = AddBloom();
+
+		const uint32_t mask = effects;
+		const int composite = graph.AddPass("composite", [this, mask, blurred, glow](FrameGraph& g) {
+			const Fused* f = Get(mask);
+			const Texture2D& scene = g.Texture(sceneHandle);
+			BeginShaderMode(f->shader);
+			// The half-res copies cover only the part of the scene texture in use.
+			Vector2 sceneScale = { sceneSource.width / static_cast<float>(scene.width), fabsf(sceneSource.height) / static_cast<float>(scene.height) };
+			SetShaderValue(f->shader, f->sceneScaleLoc, &sceneScale, SHADER_UNIFORM_VEC2);
+			if (mask & BLUR) SetShaderValueTexture(f->shader, f->blurredLoc, g.Texture(blurred));
+			if (mask & BLOOM) {
+				float strength = C_BLOOM_STRENGTH;
+				SetShaderValueTexture(f->shader, f->bloomLoc, g.Texture(glow));
+				SetShaderValue(f->shader, f->strengthLoc, &strength, SHADER_UNIFORM_FLOAT);
+			}
+			DrawTexturePro(scene, sceneSource, Window(), { 0.f, 0.f }, 0.f, WHITE);
+			EndShaderMode();
+		});
+		graph.Read(composite, sceneHandle);
+		if (mask & BLUR) graph.Read(composite, blurred);
+		if (mask & BLOOM) graph.Read(composite, glow);
+		graph.SideEffect(composite);
+
+		graph.Compile();
+		built = true;
+		builtEffects = mask;
+		const FrameGraph::Stats& stats = graph.GetStats();
+		TraceLog(LOG_INFO, "POST: effect set 0x%x: %d of %d passes, %d targets in %d textures (%.2f MB, %.2f MB unaliased)", mask,
+			stats.passes - stats.culled, stats.passes, stats.targets, stats.textures, static_cast<double>(stats.bytes) / (1024.0 * 1024.0),
+			static_cast<double>(stats.unaliasedBytes) / (1024.0 * 1024.0));
+	}
+
+	// Bright pass into the half-resolution level, then each level is the one above scaled
+	// down by two and blurred. Walking back up, every level is added onto the one above
+	// it, so level 0 ends up with tight glow from the fine levels plus wide glow from the
+	// coarse ones. Each blur is still the small 9-tap kernel, but at 1/32 resolution it
+	// spans a good part of the screen, for a fraction of a full-resolution kernel's cost.
+	// Returns level 0 as the composite reads it.
+	FrameGraph::Handle AddBloom() {
+		FrameGraph::Handle mip[C_BLOOM_LEVELS] = {};
+		mip[0] = AddDownsample("bloom bright", sceneHandle, graph.Create("bloom", halfW, halfH), &bright);
+		for (int level = 1; level < C_BLOOM_LEVELS; ++level) {
+			const FrameGraph::Handle into = graph.Create("bloom", std::max(1, halfW >> level), std::max(1, halfH >> level));
+			mip[level] = AddDownsample("bloom downsample", mip[level - 1], into, nullptr);
+		}
+		for (int level = 0; level < C_BLOOM_LEVELS; ++level) {
+			const FrameGraph::Handle scratch = graph.Create("bloom scratch", std::max(1, halfW >> level), std::max(1, halfH >> level));
+			mip[level] = AddBlur("bloom", mip[level], scratch);
+		}
+		for (int level = C_BLOOM_LEVELS - 1; level > 0; --level) {
+			const FrameGraph::Handle below = mip[level];
+			const FrameGraph::Handle into = mip[level - 1];
+			const int pass = graph.AddPass("bloom upsample", [below, into](FrameGraph& g) {
+				const Texture2D& from = g.Texture(below);
+				RenderTexture2D& target = g.Target(into);
+				BeginTextureMode(target);
+				BeginBlendMode(BLEND_ADDITIVE);
+				DrawTexturePro(from, Whole(from), Whole(target.texture, false), { 0.f, 0.f }, 0.f, WHITE);
+				EndBlendMode();
+				EndTextureMode();
+			});
+			graph.Read(pass, below);
+			graph.Read(pass, into);  // added onto
+			mip[level - 1] = graph.Write(pass, into);
+		}
+		return mip[0];
+	}
+
+	// A pass scaling `from` (the visible part of it, for the scene) into the whole of
+	// `into`, through `shader` if given; returns what it wrote.
+	FrameGraph::Handle AddDownsample(const char* name, FrameGraph::Handle from, FrameGraph::Handle into, const Shader* shader) {
+		const bool scene = from == sceneHandle;
+		const int pass = graph.AddPass(name, [this, from, into, shader, scene](FrameGraph& g) {
+			const Texture2D& t = g.Texture(from);
+			Downsample(t, scene ? sceneSource : Whole(t), g.Target(into), shader);
+		});
+		graph.Read(pass, from);
+		return graph.Write(pass, into);
+	}
+
+	// Blur's two passes: horizontally into `scratch`, vertically back into `target`;
+	// both the same size. Returns the blurred target.
+	FrameGraph::Handle AddBlur(const char* name, FrameGraph::Handle target, FrameGraph::Handle scratch) {
+		const int across = graph.AddPass(name, [this, target, scratch](FrameGraph& g) {
+			BlurPass(g.Target(target), g.Target(scratch), true);
+		});
+		graph.Read(across, target);
+		const FrameGraph::Handle spread = graph.Write(across, scratch);
+		const int down = graph.AddPass(name, [this, target, scratch](FrameGraph& g) {
+			BlurPass(g.Target(scratch), g.Target(target), false);
+		});
+		graph.Read(down, spread);
+		return graph.Write(down, target);
+	}
+
+	// All of a texture as a DrawTexturePro rectangle. Render textures are stored bottom-up,
+	// hence the negative height when it is a source.
+	static Rectangle Whole(const Texture2D& t, bool asSource = true) {
+		float h = static_cast<float>(t.height);
+		return { 0.f, 0.f, static_cast<float>(t.width), asSource ? -h : h };
+	}
+
+	// Scales `source` of `from` into the whole of `into`, through `shader` if given.
+	static void Downsample(const Texture2D& from, Rectangle source, RenderTexture2D& into, const Shader* shader) {
+		BeginTextureMode(into);
+		if (shader) BeginShaderMode(*shader);
+		DrawTexturePro(from, source, Whole(into.texture, false), { 0.f, 0.f }, 0.f, WHITE);
+		if (shader) EndShaderMode();
+		EndTextureMode();
+	}
+
+	// One axis of the separable blur, `from` into `to`; both the same size.
+	void BlurPass(const RenderTexture2D& from, RenderTexture2D& to, bool horizontal) const {
+		const Vector2 axis = horizontal ? Vector2{ 1.f / static_cast<float>(from.texture.width), 0.f }
+			: Vector2{ 0.f, 1.f / static_cast<float>(from.texture.height) };
+		BeginTextureMode(to);
+		BeginShaderMode(blur);
+		SetShaderValue(blur, directionLoc, &axis, SHADER_UNIFORM_VEC2);
+		DrawTextureRec(from.texture, Whole(from.texture), { 0.f, 0.f }, WHITE);
+		EndShaderMode();
+		EndTextureMode();
+	}
+
+	uint32_t           effects = 0;
+	bool               ready = false;
+	int                width = 0;
+	int                height = 0;
+	int                halfW = 0;
+	int                halfH = 0;
+	FrameGraph         graph;
+	bool               built = false;
+	uint32_t           builtEffects = 0;
+	FrameGraph::Handle sceneHandle = FrameGraph::C_NONE;
+	Rectangle          sceneSource{};  // of the scene texture, for this frame's Execute
+	Shader             blur{};
+	Shader             bright{};
+	int                directionLoc = -1;
+	std::vector<Fused> fused;
+};
+
+// --- RENDER SNAPSHOT ---
+// What the renderer needs of the world, copied out by the simulation thread once a frame's
+// ticks are done: positions, rotations and types, densely packed. Drawing only ever reads
+// a snapshot, so the render thread can submit one frame while the simulation steps the
+// next (see Application::Run).
+//
+// Every entity carries two states, the last tick (x, y, rotation) and the one before
+// (prevX, prevY, prevRotation). Blend(alpha) views the snapshot `alpha` of the way from
+// one to the other, so motion stays smooth at any display rate however coarse the tick.
+// Asteroids and projectiles move in straight lines, so their previous state is stepped
+// back from the velocity; ships remember theirs (PreviousTransform).
+struct AsteroidSnapshot {
+	std::vector<float>   x, y, rotation, radius;
+	std::vector<float>   prevX, prevY, prevRotation;
+	std::vector<uint8_t> sides;
+
+	void Capture(const AsteroidField& field, float dt) {
+		const size_t n = field.Size();
+		x.assign(field.X(), field.X() + n);
+		y.assign(field.Y(), field.Y() + n);
+		radius.assign(field.Radii(), field.Radii() + n);
+		rotation.resize(n);
+		prevX.resize(n);
+		prevY.resize(n);
+		prevRotation.resize(n);
+		sides.resize(n);
+		for (size_t i = 0; i < n; ++i) {
+			Vector2 v = field.GetVelocity(i);
+			rotation[i] = field.GetRotation(i);
+			prevX[i] = x[i] - v.x * dt;
+			prevY[i] = y[i] - v.y * dt;
+			prevRotation[i] = rotation[i] - field.GetRotationSpeed(i) * dt;
+			sides[i] = static_cast<uint8_t>(field.GetSides(i));
+		}
+	}
+
+	size_t Size() const { return x.size(); }
+
+	// Same accessors as AsteroidField, so AsteroidBatch::Draw takes it directly.
+	struct Blended {
+		const AsteroidSnapshot& s;
+		float                   alpha;
+
+		size_t  Size() const { return s.Size(); }
+		Vector2 GetPosition(size_t i) const { return { Lerp(s.prevX[i], s.x[i], alpha), Lerp(s.prevY[i], s.y[i], alpha) }; }
+		int     GetSides(size_t i) const { return s.sides[i]; }
+		float   GetRadius(size_t i) const { return s.radius[i]; }
+		float   GetRotation(size_t i) const { return Lerp(s.prevRotation[i], s.rotation[i], alpha); }
+	};
+
+	Blended Blend(float alpha) const { return { *this, alpha }; }
+
+	// Fallback for when AsteroidBatch is unavailable.
+	void Draw(float alpha, const View& view) const {
+		Blended b = Blend(alpha);
+		for (size_t i = 0; i < Size(); ++i) {
+			Vector2 c = b.GetPosition(i);
+			if (!view.Sees(c, radius[i])) continue;
+			int lod = AsteroidLod::Sides(sides[i], radius[i], view);
+			if (lod == AsteroidLod::C_DOT) DrawPixelV(c, RED);
+			else Renderer::Instance().DrawPoly(c, lod, radius[i], b.GetRotation(i));
+		}
+	}
+};
+
+struct ProjectileSnapshot {
+	std::vector<float>      x, y, prevX, prevY;
+	std::vector<WeaponType> type;
+
+	// Live projectiles only; tombstones stay behind in the store.
+	void Capture(const ProjectileField& field, float dt) {
+		x.clear();
+		y.clear();
+		prevX.clear();
+		prevY.clear();
+		type.clear();
+		for (size_t i = field.Begin(); i < field.End(); ++i) {
+			if (field.IsDead(i)) continue;
+			Vector2 p = field.GetPosition(i);
+			Vector2 v = field.GetVelocity(i);
+			x.push_back(p.x);
+			y.push_back(p.y);
+			prevX.push_back(p.x - v.x * dt);
+			prevY.push_back(p.y - v.y * dt);
+			type.push_back(field.GetType(i));
+		}
+	}
+
+	size_t Size() const { return x.size(); }
+	bool   Empty() const { return x.empty(); }
+
+	struct Blended {
+		const ProjectileSnapshot& s;
+		float                     alpha;
+
+		size_t     Size() const { return s.Size(); }
+		bool       Empty() const { return s.Empty(); }
+		Vector2    GetPosition(size_t i) const { return { Lerp(s.prevX[i], s.x[i], alpha), Lerp(s.prevY[i], s.y[i], alpha) }; }
+		WeaponType GetType(size_t i) const { return s.type[i]; }
+	};
+
+	Blended Blend(float alpha) const { return { *this, alpha }; }
+
+	// Fallback for when ProjectileBatch is unavailable.
+	void Draw(float alpha) const {
+		static constexpr float LASER_LENGTH = 30.f;
+		Blended b = Blend(alpha);
+		for (size_t i = 0; i < Size(); ++i) {
+			Vector2 p = b.GetPosition(i);
+			if (type[i] == WeaponType::BULLET) {
+				DrawCircleV(p, 5.f, WHITE);
+			}
+			else {
+				Rectangle lr = { p.x - 2.f, p.y - LASER_LENGTH, 4.f, LASER_LENGTH };
+				DrawRectangleRec(lr, RED);
+			}
+		}
+	}
+};
+
+// Filled by Fleet::Capture, in Fleet index order.
+struct ShipSnapshot {
+	std::vector<float> x, y, rotation, scale;
+	std::vector<float> prevX, prevY, prevRotation;
+	std::vector<char>  alive;
+	Vector2            spriteSize{};
+
+	void Clear() {
+		x.clear(); y.clear(); rotation.clear(); scale.clear(); alive.clear();
+		prevX.clear(); prevY.clear(); prevRotation.clear();
+	}
+
+	void Push(Vector2 prevPos, float prevRot, Vector2 pos, float rot, float s, bool isAlive) {
+		x.push_back(pos.x);
+		y.push_back(pos.y);
+		rotation.push_back(rot);
+		prevX.push_back(prevPos.x);
+		prevY.push_back(prevPos.y);
+		prevRotation.push_back(prevRot);
+		scale.push_back(s);
+		alive.push_back(isAlive ? 1 : 0);
+	}
+
+	size_t Size() const { return x.size(); }
+
+	// One sprite per ship of the first `count`, `alpha` of the way from the previous tick;
+	// dead ships blink.
+	void Draw(SpriteBatch& sprites, const SpriteAtlas& atlas, float alpha, size_t count = SIZE_MAX) const {
+		const bool blinkOff = fmodf(static_cast<float>(GetTime()), 0.4f) > 0.2f;
+		count = std::min(count, Size());
+		for (size_t i = 0; i < count; ++i) {
+			if (!alive[i] && blinkOff) continue;
+			Vector2 size = { spriteSize.x * scale[i], spriteSize.y * scale[i] };
+			sprites.Add(
+				atlas.ShipSource(scale[i]),
+				Rectangle{ Lerp(prevX[i], x[i], alpha), Lerp(prevY[i], y[i], alpha), size.x, size.y },
+				Vector2{ size.x * 0.5f, size.y * 0.5f },
+				Lerp(prevRotation[i], rotation[i], alpha),
+				WHITE
+			);
+		}
+	}
+};
+
+// --- SHIP COMPONENTS ---
+// Ships are entities in an Ecs::Registry rather than a class hierarchy: the player and
+// the orbiters are two archetypes that share TransformA, Hull, Sprite and Score and differ
+// in what moves them (Pilot follows the input bits, Orbit follows the parent). Each also
+// carries its Handle, which moves with its row.
+struct Hull {
+    int  hp = 100;
+    bool alive = true;
+
+    void TakeDamage(int dmg) {
+        if (!alive) return;
+        hp -= dmg;
+        if (hp <= 0) alive = false;
+    }
+};
+
+// The transform as of the start of the tick, for interpolated drawing.
+struct PreviousTransform {
+    Vector2 position{};
+    float   rotation{};
+};
+
+struct Pilot {
+    float speed = 250.f;
+};
+
+// `parent` is a Fleet index: 0 for the player, 1 + row for an orbiter.
+struct Orbit {
+    int   parent = 0;
+    float radius = 0.f;
+    float angle = 0.f;
+};
+
+struct Sprite {
+    float scale = 0.3f;
+};
+
+struct Score {
+    int value = 0;
+};
+
+using PlayerArchetype  = Ecs::Archetype<TransformA, PreviousTransform, Pilot, Hull, Sprite, Score, Handle>;
+using OrbiterArchetype = Ecs::Archetype<TransformA, PreviousTransform, Orbit, Hull, Sprite, Score, Handle>;
+using ShipRegistry     = Ecs::Registry<PlayerArchetype, OrbiterArchetype>;
+
+// --- FLEET ---
+// The player ship and its orbiter tree. Fleet indices run over the registry in archetype
+// order: index 0 is the player and index 1 + k is orbiter row k. Orbiter rows are kept in
+// topological order (every ship after its parent), so each system is one forward loop and
+// parents are always updated before the orbiters that follow them. Indices shift whenever
+// an orbiter dies; what must find a ship again later (a projectile's owner) keeps its
+// Handle instead, which Find turns back into its index.
+class Fleet {
+public:
+    static constexpr size_t C_PLAYER = 0;
+    static constexpr float  C_ORBIT_SPEED = 1.f;  // radians per second, the same for every orbit
+
+    Fleet() {
+        ships.Get<OrbiterArchetype>().Reserve(C_INITIAL_CAPACITY);
+    }
+
+    // A fresh player at the centre of the world. Every ship draws the same sprite, whose
+    // size (before scaling) defines the ship radius.
+    void Reset(int screenW, int screenH, Vector2 spriteSize_) {
+        spriteSize = spriteSize_;
+        ships.Clear();
+        handles.Clear();
+        ++orbitLayout;
+        TransformA start{ { screenW * 0.5f, screenH * 0.5f }, 0.f };
+        PreviousTransform previous{ start.position, start.rotation };
+        ships.Get<PlayerArchetype>().Push(start, previous, Pilot{}, Hull{}, Sprite{ C_PLAYER_SCALE }, Score{}, handles.Create(static_cast<uint32_t>(C_PLAYER)));
+    }
+
+    size_t Size() const { return ships.Size(); }
+
+    Vector2 GetPosition(size_t i) const { return Component<TransformA>(i).position; }
+    float   GetRotation(size_t i) const { return Component<TransformA>(i).rotation; }
+    float   GetRadius(size_t i) const { return RadiusOf(Component<Sprite>(i)); }
+    bool    IsAlive(size_t i) const { return Component<Hull>(i).alive; }
+    int     GetHP(size_t i) const { return Component<Hull>(i).hp; }
+    int     GetScore(size_t i) const { return Component<Score>(i).value; }
+    Handle  HandleOf(size_t i) const { return Component<Handle>(i); }
+
+    // The ship's index, or -1 once it is gone.
+    int Find(Handle h) const { return static_cast<int>(handles.Find(h)); }
+
+    void TakeDamage(size_t i, int dmg) { Component<Hull>(i).TakeDamage(dmg); }
+    void AddScore(size_t i, int s) { Component<Score>(i).value += s; }
+
+    // Moves every ship, and where it was a tick ago, by (dx, dy).
+    void Translate(float dx, float dy) {
+        ships.Each<TransformA, PreviousTransform>([&](TransformA& t, PreviousTransform& prev) {
+            t.position.x += dx; t.position.y += dy;
+            prev.position.x += dx; prev.position.y += dy;
+        });
+    }
+
+    // Keeps the piloted ships inside [minX, maxX] x [minY, maxY]; orbiters follow them.
+    void Confine(float minX, float minY, float maxX, float maxY) {
+        ships.Each<TransformA, Pilot>([&](TransformA& t, const Pilot&) {
+            t.position.x = fminf(fmaxf(t.position.x, minX), maxX);
+            t.position.y = fminf(fmaxf(t.position.y, minY), maxY);
+        });
+    }
+
+    // Every ship shares the same guns.
+    static float FireRate(WeaponType wt) {
+        return (wt == WeaponType::LASER) ? 18.f : 22.f;
+    }
+
+    static float Spacing(WeaponType wt) {
+        return (wt == WeaponType::LASER) ? 40.f : 20.f;
+    }
+
+    // 1 / FireRate in Q.16 seconds, for lockstep worlds.
+    static int32_t FireIntervalFixed(WeaponType wt) {
+        return (1 << Fixed::C_TIME_SHIFT) / static_cast<int32_t>(FireRate(wt));
+    }
+
+    // Lockstep worlds: movement, orbits and shots in Fixed arithmetic with table trig, and
+    // ship radii snapped to the fixed grid. Set before Reset.
+    void SetFixedPoint(bool on) {
+        fixedPoint = on;
+    }
+
+    void Update(float dt, uint32_t input) {
+        RememberTransforms();
+        MovePilots(dt, input);
+        UpdateOrbits(dt);
+        RemoveDeadOrbiters();
+    }
+
+    // Render extraction: what the renderer needs of every ship, in Fleet index order.
+    void Capture(ShipSnapshot& out) const {
+        out.Clear();
+        out.spriteSize = spriteSize;
+        ships.Each<TransformA, PreviousTransform, Hull, Sprite>(
+            [&](const TransformA& t, const PreviousTransform& prev, const Hull& hull, const Sprite& sprite) {
+                out.Push(prev.position, prev.rotation, t.position, t.rotation, sprite.scale, hull.alive);
+            });
+    }
+
+    // Changes whenever orbiters are added or removed, so OrbiterBatch's table can be kept
+    // until it does.
+    uint64_t OrbitLayout() const { return orbitLayout; }
+
+    // Render extraction for OrbiterBatch: every orbiter's offset from the player as of now,
+    // in orbiter order. UpdateOrbits has already resolved each one down its parent chain.
+    void CaptureOrbits(std::vector<OrbiterBatch::Orbit>& out) const {
+        const OrbiterArchetype& orbiters = ships.Get<OrbiterArchetype>();
+        const TransformA* t = orbiters.Column<TransformA>();
+        const Sprite*     sprite = orbiters.Column<Sprite>();
+        const Vector2     player = GetPosition(C_PLAYER);
+        out.resize(orbiters.Size());
+        for (size_t row = 0; row < orbiters.Size(); ++row) {
+            out[row] = { { t[row].position.x - player.x, t[row].position.y - player.y }, t[row].rotation, sprite[row].scale };
+        }
+    }
+
+    // Two passes: count every ship's shots against the shared timer, then grow the store
+    // once and let each ship write its burst in place. All of a tick's shots leave the
+    // muzzle together, so the trig is done once per ship; each projectile is stamped with
+    // its ship's Handle as the owner. Returns how many shots were fired.
+    size_t Shoot(ProjectileField& projectiles, WeaponType currentWeapon, float& shotTimer, float dt) {
+        if (!IsAlive(C_PLAYER)) return 0;
+        shots.resize(Size());
+        size_t total = 0;
+        size_t i = 0;
+        const float interval = 1.f / FireRate(currentWeapon);
+        const int32_t intervalFixed = FireIntervalFixed(currentWeapon);
+        int32_t timerFixed = Fixed::FromSeconds(shotTimer);
+        const int32_t dtFixed = Fixed::FromSeconds(dt);
+        ships.Each<Hull>([&](const Hull& hull) {
+            int n = 0;
+            if (hull.alive && fixedPoint) {
+                timerFixed += dtFixed;
+                n = timerFixed / intervalFixed;
+                timerFixed -= n * intervalFixed;
+            }
+            else if (hull.alive) {
+                shotTimer += dt;
+                n = static_cast<int>(shotTimer / interval);
+                shotTimer -= n * interval;
+            }
+            shots[i++] = n;
+            total += static_cast<size_t>(n);
+        });
+        if (fixedPoint) shotTimer = Fixed::ToSeconds(timerFixed);
+        if (total == 0) return 0;
+
+        size_t at = projectiles.Grow(total);
+        const float projSpeed = Spacing(currentWeapon) * FireRate(currentWeapon);
+        i = 0;
+        ships.Each<TransformA, Sprite, Handle>([&](const TransformA& t, const Sprite& sprite, const Handle& self) {
+            const int n = shots[i++];
+            if (n == 0) return;
+            if (fixedPoint) {
+                const Fixed::Raw rotation = Fixed::FromFloat(t.rotation);
+                const int32_t s = Fixed::Sin(rotation);
+                const int32_t c = Fixed::Cos(rotation);
+                const Fixed::Raw r = Fixed::FromFloat(RadiusOf(sprite));
+                const Fixed::Raw speed = Fixed::FromFloat(projSpeed);
+                const Vector2 muzzle = { Fixed::ToFloat(Fixed::FromFloat(t.position.x) + Fixed::MulUnit(r, s)),
+                                         Fixed::ToFloat(Fixed::FromFloat(t.position.y) - Fixed::MulUnit(r, c)) };
+                const Vector2 vel = { Fixed::ToFloat(Fixed::MulUnit(speed, s)), Fixed::ToFloat(-Fixed::MulUnit(speed, c)) };
+                projectiles.Fill(at, static_cast<size_t>(n), muzzle, vel, currentWeapon, self);
+                at += static_cast<size_t>(n);
+                return;
+            }
+            float rotRad = DEG2RAD * t.rotation;
+            float s = sinf(rotRad);
+            float c = cosf(rotRad);
+            float r = RadiusOf(sprite);
+            Vector2 muzzle = { t.position.x + r * s, t.position.y - r * c };
+            Vector2 vel = { s * projSpeed, -c * projSpeed };
+            projectiles.Fill(at, static_cast<size_t>(n), muzzle, vel, currentWeapon, self);
+            at += static_cast<size_t>(n);
+        });
+        return total;
+    }
+
+    // Appends an orbiter circling `parent` and returns its index. Appending keeps the
+    // orbiters in topological order, since the parent is always already in the fleet.
+    int AddOrbiter(int parent) {
+        float radius = GetRadius(static_cast<size_t>(parent)) + 60.f;
+        Vector2 p = GetPosition(static_cast<size_t>(parent));
+        TransformA start{ { p.x + radius, p.y }, 0.f };
+        PreviousTransform previous{ start.position, start.rotation };
+        const Handle h = handles.Create(static_cast<uint32_t>(Size()));
+        ships.Get<OrbiterArchetype>().Push(start, previous, Orbit{ parent, radius, 0.f }, Hull{}, Sprite{ C_ORBITER_SCALE }, Score{}, h);
+        ++orbitLayout;
+        return static_cast<int>(Size() - 1);
+    }
+
+    // Every ship that reached the threshold and has no orbiter yet gets one.
+    void TrySpawnOrbiters(int scoreThreshold) {
+        hasOrbiter.assign(Size(), 0);
+        ships.Each<Orbit>([&](const Orbit& o) { hasOrbiter[o.parent] = 1; });
+        const size_t n = Size();
+        for (size_t i = 0; i < n; ++i) {
+            if (GetScore(i) >= scoreThreshold && !hasOrbiter[i]) {
+                AddOrbiter(static_cast<int>(i));
+            }
+        }
+    }
+
+    // Every component column of both archetypes as WorldSnapshot sections; the orbiter
+    // tree is in the Orbit parents. The handle table goes too, so the handles of ships that
+    // died before the save, which shots may still carry, stay dead after a load.
+    void Save(WorldSnapshot::Writer& out) const {
+        uint32_t column = 0;
+        ships.Get<PlayerArchetype>().EachColumn([&](const auto& c) { out.Add(C_PLAYER_TAG, column++, c); });
+        column = 0;
+        ships.Get<OrbiterArchetype>().EachColumn([&](const auto& c) { out.Add(C_ORBITER_TAG, column++, c); });
+        out.Add(C_HANDLES_TAG, 0, handles.Entries());
+        out.Add(C_HANDLES_TAG, 1, handles.FreeSlots());
+    }
+
+    // Replaces the fleet with a saved one, as Reset does with a fresh player. False, with
+    // the fleet empty, when a column is missing, the rows don't form a tree in topological
+    // order or a ship's handle doesn't lead back to it.
+    bool Load(const WorldSnapshot::Reader& in, Vector2 spriteSize_) {
+        spriteSize = spriteSize_;
+        bool ok = true;
+        uint32_t column = 0;
+        ships.Get<PlayerArchetype>().EachColumn([&](auto& c) { ok = ok && in.Read(C_PLAYER_TAG, column++, c) && c.size() == 1; });
+        OrbiterArchetype& orbiters = ships.Get<OrbiterArchetype>();
+        const int64_t rows = in.Count(C_ORBITER_TAG, 0, sizeof(TransformA));
+        column = 0;
+        orbiters.EachColumn([&](auto& c) { ok = ok && in.Read(C_ORBITER_TAG, column++, c) && static_cast<int64_t>(c.size()) == rows; });
+        const Orbit* o = orbiters.Column<Orbit>();
+        for (size_t row = 0; ok && row < orbiters.Size(); ++row) {
+            ok = o[row].parent >= 0 && static_cast<size_t>(o[row].parent) <= row;
+        }
+        std::vector<HandleTable::Entry> entries;
+        std::vector<uint32_t> freeSlots;
+        ok = ok && in.Read(C_HANDLES_TAG, 0, entries) && in.Read(C_HANDLES_TAG, 1, freeSlots) && handles.Restore(entries, freeSlots);
+        for (size_t i = 0; ok && i < Size(); ++i) ok = Find(HandleOf(i)) == static_cast<int>(i);
+        if (!ok) {
+            ships.Clear();
+            handles.Clear();
+        }
+        ++orbitLayout;
+        return ok;
+    }
+
+private:
+    static constexpr uint32_t C_PLAYER_TAG = WorldSnapshot::Tag("PLYR");
+    static constexpr uint32_t C_ORBITER_TAG = WorldSnapshot::Tag("ORBT");
+    static constexpr uint32_t C_HANDLES_TAG = WorldSnapshot::Tag("SHID");
+
+    static constexpr float C_PLAYER_SCALE = 0.3f;
+    static constexpr float C_ORBITER_SCALE = 0.18f;
+
+    float RadiusOf(const Sprite& sprite) const {
+        const float r = spriteSize.x * sprite.scale * 0.5f;
+        return fixedPoint ? Fixed::Snap(r) : r;
+    }
+
+    // Fleet index -> component, for the few per-ship lookups outside the systems.
+    template<typename C>
+    C& Component(size_t i) {
+        if (i == C_PLAYER) return ships.Get<PlayerArchetype>().Get<C>(0);
+        return ships.Get<OrbiterArchetype>().Get<C>(i - 1);
+    }
+
+    template<typename C>
+    const C& Component(size_t i) const {
+        if (i == C_PLAYER) return ships.Get<PlayerArchetype>().Get<C>(0);
+        return ships.Get<OrbiterArchetype>().Get<C>(i - 1);
+    }
+
+    void RememberTransforms() {
+        ships.Each<TransformA, PreviousTransform>([](const TransformA& t, PreviousTransform& prev) {
+            prev.position = t.position;
+            prev.rotation = t.rotation;
+        });
+    }
+
+    // Movement system: the input bits steer every piloted ship; a dead one drifts down.
+    void MovePilots(float dt, uint32_t input) {
+        if (fixedPoint) {
+            MovePilotsFixed(Fixed::FromSeconds(dt), input);
+            return;
+        }
+        ships.Each<TransformA, Pilot, Hull>([&](TransformA& t, const Pilot& pilot, const Hull& hull) {
+            const float step = pilot.speed * dt;
+            if (!hull.alive) {
+                t.position.y += step;
+                return;
+            }
+            if (input & Input::UP) t.position.y -= step;
+            if (input & Input::DOWN) t.position.y += step;
+            if (input & Input::LEFT) t.position.x -= step;
+            if (input & Input::RIGHT) t.position.x += step;
+            if (input & Input::ROTATE_LEFT) t.rotation -= 180.0f * dt;
+            if (input & Input::ROTATE_RIGHT) t.rotation += 180.0f * dt;
+        });
+    }
+
+    void MovePilotsFixed(int32_t dt, uint32_t input) {
+        const Fixed::Raw turn = Fixed::Distance(Fixed::FromInt(180), dt);
+        ships.Each<TransformA, Pilot, Hull>([&](TransformA& t, const Pilot& pilot, const Hull& hull) {
+            const Fixed::Raw step = Fixed::Distance(Fixed::FromFloat(pilot.speed), dt);
+            Fixed::Raw x = Fixed::FromFloat(t.position.x);
+            Fixed::Raw y = Fixed::FromFloat(t.position.y);
+            Fixed::Raw rotation = Fixed::FromFloat(t.rotation);
+            if (!hull.alive) {
+                y += step;
+            }
+            else {
+                if (input & Input::UP) y -= step;
+                if (input & Input::DOWN) y += step;
+                if (input & Input::LEFT) x -= step;
+                if (input & Input::RIGHT) x += step;
+                if (input & Input::ROTATE_LEFT) rotation -= turn;
+                if (input & Input::ROTATE_RIGHT) rotation += turn;
+            }
+            t.position = { Fixed::ToFloat(x), Fixed::ToFloat(y) };
+            t.rotation = Fixed::ToFloat(Fixed::WrapDegrees(rotation));
+        });
+    }
+
+    // Orbit system: rows are in topological order, so a parent has already moved when its
+    // orbiters read its position. Lockstep fleets keep the angle in degrees on the fixed
+    // grid; the float one is in radians.
+    void UpdateOrbits(float dt) {
+        OrbiterArchetype& orbiters = ships.Get<OrbiterArchetype>();
+        TransformA* t = orbiters.Column<TransformA>();
+        Orbit*      o = orbiters.Column<Orbit>();
+        if (fixedPoint) {
+            const Fixed::Raw turn = Fixed::Distance(Fixed::FromFloat(RAD2DEG * C_ORBIT_SPEED), Fixed::FromSeconds(dt));
+            for (size_t row = 0; row < orbiters.Size(); ++row) {
+                Vector2 parentPos = GetPosition(static_cast<size_t>(o[row].parent));
+                const Fixed::Raw angle = Fixed::WrapDegrees(Fixed::FromFloat(o[row].angle) + turn);
+                const Fixed::Raw radius = Fixed::FromFloat(o[row].radius);
+                o[row].angle = Fixed::ToFloat(angle);
+                t[row].position = {
+                    Fixed::ToFloat(Fixed::FromFloat(parentPos.x) + Fixed::MulUnit(radius, Fixed::Cos(angle))),
+                    Fixed::ToFloat(Fixed::FromFloat(parentPos.y) + Fixed::MulUnit(radius, Fixed::Sin(angle)))
+                };
+            }
+            return;
+        }
+        for (size_t row = 0; row < orbiters.Size(); ++row) {
+            Vector2 parentPos = GetPosition(static_cast<size_t>(o[row].parent));
+            o[row].angle += dt * C_ORBIT_SPEED;
+            t[row].position = {
+                parentPos.x + o[row].radius * cosf(o[row].angle),
+                parentPos.y + o[row].radius * sinf(o[row].angle)
+            };
+        }
+    }
+
+    // A dead orbiter takes its whole subtree with it. Erase keeps the survivors' order, so
+    // topological order holds after the parents are remapped. The dead ships' handles go
+    // and the survivors' follow them to their new index.
+    void RemoveDeadOrbiters() {
+        OrbiterArchetype& orbiters = ships.Get<OrbiterArchetype>();
+        remap.assign(Size(), -1);
+        remap[C_PLAYER] = static_cast<int>(C_PLAYER);
+        dead.assign(orbiters.Size(), 0);
+        int keep = 1;
+        Orbit*        o = orbiters.Column<Orbit>();
+        const Hull*   h = orbiters.Column<Hull>();
+        const Handle* id = orbiters.Column<Handle>();
+        for (size_t row = 0; row < orbiters.Size(); ++row) {
+            if (!h[row].alive || remap[o[row].parent] < 0) {
+                dead[row] = 1;
+                handles.Destroy(id[row]);
+                continue;
+            }
+            o[row].parent = remap[o[row].parent];
+            remap[row + 1] = keep++;
+        }
+        if (static_cast<size_t>(keep) == Size()) return;
+        ++orbitLayout;
+        orbiters.Erase(dead);
+        id = orbiters.Column<Handle>();
+        for (size_t row = 0; row < orbiters.Size(); ++row) handles.Move(id[row], static_cast<uint32_t>(row + 1));
+    }
+
+    static constexpr size_t C_INITIAL_CAPACITY = 256;
+
+    ShipRegistry      ships;
+    HandleTable       handles;
+    Vector2           spriteSize{};
+    bool              fixedPoint = false;
+    std::vector<int>  remap;
+    std::vector<char> dead;
+    std::vector<char> hasOrbiter;
+    std::vector<int>  shots;
+    uint64_t          orbitLayout = 0;
+};
+
+// --- AUTOPILOT ---
+// Flies the player for unattended load runs. It stands in for Input::SampleHeld and
+// SamplePressed, so it produces the same once-a-frame FrameInput a keyboard would and the
+// simulation can't tell a bot from a player. Each frame it tries the nine WASD moves and
+// keeps the one with the most clearance from the asteroids (and the walls) over the next
+// C_LOOKAHEAD_SECONDS, turns with ROTATE_LEFT/RIGHT towards where the nearest asteroid will
+// be when a shot gets there, and holds FIRE throughout. It cycles the weapon every
+// C_WEAPON_SECONDS and restarts C_RESTART_SECONDS after dying. It reads only the
+// simulation state and draws no random numbers, so a headless run with the same seed and
+// scenario flies the same session every time on the same build and machine. Its decisions
+// are float math (sqrtf, atan2f, remainderf) even under lockstep, though, so another
+// compiler or CPU may steer differently and the session diverge; only recorded or scripted
+// input (--record saves the autopilot's) is deterministic across machines.
+class Autopilot {
+public:
+    void Reset() {
+        weaponTimer = 0.f;
+        deadTimer = 0.f;
+    }
+
+    // The input for a frame of `ticks` ticks, from the world as the frame starts.
+    FrameInput Fly(const Fleet& fleet, const AsteroidField& asteroids, WorldBounds bounds, WeaponType weapon, int ticks, float tickDt) {
+        FrameInput in;
+        in.ticks = ticks;
+        const float dt = static_cast<float>(ticks) * tickDt;
+
+        if (!fleet.IsAlive(Fleet::C_PLAYER)) {
+            deadTimer += dt;
+            if (deadTimer >= C_RESTART_SECONDS) {
+                in.pressed |= Input::RESTART;
+                deadTimer = 0.f;
+            }
+            return in;
+        }
+        deadTimer = 0.f;
+        weaponTimer += dt;
+        if (weaponTimer >= C_WEAPON_SECONDS) {
+            in.pressed |= Input::NEXT_WEAPON;
+            weaponTimer = 0.f;
+        }
+
+        const Vector2 p = fleet.GetPosition(Fleet::C_PLAYER);
+        const float shipRadius = fleet.GetRadius(Fleet::C_PLAYER);
+        const float shipSpeed = Pilot{}.speed;
+        const float* ax = asteroids.X();
+        const float* ay = asteroids.Y();
+        const float* ar = asteroids.Radii();
+
+        // The nearest asteroid is the target; the ones that could come within C_SAFE_GAP
+        // during the lookahead are the threats.
+        threats.clear();
+        size_t target = asteroids.Size();
+        float targetGap = INFINITY;
+        for (size_t i = 0; i < asteroids.Size(); ++i) {
+            const Vector2 v = asteroids.GetVelocity(i);
+            const float gap = sqrtf((ax[i] - p.x) * (ax[i] - p.x) + (ay[i] - p.y) * (ay[i] - p.y)) - ar[i] - shipRadius;
+            if (gap < targetGap) {
+                targetGap = gap;
+                target = i;
+            }
+            const float reach = (shipSpeed * 1.5f + sqrtf(v.x * v.x + v.y * v.y)) * C_LOOKAHEAD_SECONDS;
+            if (gap < C_SAFE_GAP + reach) threats.push_back(static_cast<uint32_t>(i));
+        }
+
+        float bestScore = -INFINITY;
+        for (const uint32_t move : C_MOVES) {
+            const float mx = ((move & Input::RIGHT) ? shipSpeed : 0.f) - ((move & Input::LEFT) ? shipSpeed : 0.f);
+            const float my = ((move & Input::DOWN) ? shipSpeed : 0.f) - ((move & Input::UP) ? shipSpeed : 0.f);
+            float clearance = C_SAFE_GAP;
+            for (int s = 1; s <= C_LOOKAHEAD_SAMPLES; ++s) {
+                const float t = C_LOOKAHEAD_SECONDS * static_cast<float>(s) / static_cast<float>(C_LOOKAHEAD_SAMPLES);
+                const float qx = p.x + mx * t;
+                const float qy = p.y + my * t;
+                clearance = fminf(clearance, fminf(fminf(qx, bounds.width - qx), fminf(qy, bounds.height - qy)) - shipRadius);
+                for (uint32_t i : threats) {
+                    const Vector2 v = asteroids.GetVelocity(i);
+                    const float dx = ax[i] + v.x * t - qx;
+                    const float dy = ay[i] + v.y * t - qy;
+                    clearance = fminf(clearance, sqrtf(dx * dx + dy * dy) - ar[i] - shipRadius);
+                }
+            }
+            // Once every move is safe, the one drifting towards the middle wins, which keeps
+            // the ship clear of the walls and of asteroids spawning off them.
+            const float ex = p.x + mx * C_LOOKAHEAD_SECONDS - bounds.width * 0.5f;
+            const float ey = p.y + my * C_LOOKAHEAD_SECONDS - bounds.height * 0.5f;
+            const float score = clearance - C_CENTER_PULL * sqrtf(ex * ex + ey * ey);
+            if (score > bestScore) {
+                bestScore = score;
+                in.held = move;
+            }
+        }
+
+        in.held |= Input::FIRE;
+        if (target < asteroids.Size()) {
+            // Lead the target by a shot's flight time to where it is now, a close enough
+            // guess at these speeds.
+            const Vector2 v = asteroids.GetVelocity(target);
+            const float t = (targetGap + ar[target] + shipRadius) / (Fleet::Spacing(weapon) * Fleet::FireRate(weapon));
+            const float dx = ax[target] + v.x * t - p.x;
+            const float dy = ay[target] + v.y * t - p.y;
+            // Rotation 0 points up and grows clockwise (see Fleet::Shoot).
+            const float want = RAD2DEG * atan2f(dx, -dy);
+            const float error = remainderf(want - fleet.GetRotation(Fleet::C_PLAYER), 360.f);
+            if (error < -C_AIM_TOLERANCE) in.held |= Input::ROTATE_LEFT;
+            if (error > C_AIM_TOLERANCE) in.held |= Input::ROTATE_RIGHT;
+        }
+        return in;
+    }
+
+private:
+    static constexpr uint32_t C_MOVES[] = {
+        0, Input::UP, Input::DOWN, Input::LEFT, Input::RIGHT,
+        Input::UP | Input::LEFT, Input::UP | Input::RIGHT, Input::DOWN | Input::LEFT, Input::DOWN | Input::RIGHT,
+    };
+    static constexpr float C_LOOKAHEAD_SECONDS = 0.5f;
+    static constexpr int   C_LOOKAHEAD_SAMPLES = 4;
+    static constexpr float C_SAFE_GAP = 80.f;       // px of clearance past which a move is as good as any
+    static constexpr float C_CENTER_PULL = 0.01f;   // px of clearance per px from the middle
+    static constexpr float C_AIM_TOLERANCE = 3.f;   // degrees, about two ticks of turning at 120 Hz
+    static constexpr float C_WEAPON_SECONDS = 8.f;
+    static constexpr float C_RESTART_SECONDS = 1.f;
+
+    float                 weaponTimer = 0.f;
+    float                 deadTimer = 0.f;
+    std::vector<uint32_t> threats;
+};
+
+// --- SPATIAL GRID ---
+// Uniform grid over the world. Entries are stored by index, bucketed with a counting sort
+// so a rebuild never allocates once the buffers are warm. Build() starts from scratch
+// every tick, which touches every entry although most asteroids are still in the cell
+// they were in. Update() (Broadphase::INCREMENTAL) keeps the buckets instead: each
+// rebuild leaves every cell some slack past its entries, every entry remembers its cell
+// and place, and an entry whose cell changed since the last tick is swapped out of its old
+// bucket and appended to the new one. The check is a compare per entry, so the upkeep goes
+// with the cell crossings. Swap-and-pop compaction refills slots, which changes their cell
+// like a crossing does, and slots past the new count are simply dropped. A bucket out of
+// slack moves to the end of the array at twice its size, leaving a hole behind; every
+// C_REBUILD_TICKS'th update, or once the holes are half the array, a rebuild compacts the
+// buckets, sorts them back into index order and hands out the slack where the entries are.
+class SpatialGrid {
+public:
+	SpatialGrid(float worldW, float worldH, float cellSize)
+		: cellSize(cellSize), invCell(1.f / cellSize)
+	{
+		cols = static_cast<int>(ceilf(worldW * invCell));
+		rows = static_cast<int>(ceilf(worldH * invCell));
+		cellStart.assign(static_cast<size_t>(cols * rows) + 1, 0);
+		cellCount.assign(static_cast<size_t>(cols * rows), 0);
+		cellCapacity.assign(static_cast<size_t>(cols * rows), 0);
+	}
+
+	template<typename PosFn>
+	void Build(size_t count, PosFn&& positionOf) {
+		Rebuild(count, positionOf, false);
+	}
+
+	// Build()'s result, from the last tick's buckets. Every entry must be in [0, count).
+	template<typename PosFn>
+	void Update(size_t count, PosFn&& positionOf) {
+		if (!incremental || ++sinceRebuild >= C_REBUILD_TICKS || holes * 2 > items.size()) {
+			Rebuild(count, positionOf, true);
+			return;
+		}
+		const size_t previous = itemCell.size();
+		for (size_t i = count; i < previous; ++i) Remove(static_cast<int>(i));
+		itemCell.resize(count);
+		itemSlot.resize(count);
+
+		moved = 0;
+		for (size_t i = 0; i < count; ++i) {
+			const int c = CellOf(positionOf(i));
+			if (i < previous) {
+				if (c == itemCell[i]) continue;
+				Remove(static_cast<int>(i));
+			}
+			Insert(static_cast<int>(i), c);
+			++moved;
+		}
+	}
+
+	// Entries Update() moved to another cell (or added) on its last run; 0 after a rebuild.
+	size_t Moved() const {
+		return moved;
+	}
+
+	size_t Rebuilds() const {
+		return rebuilds;
+	}
+
+	// The entries have been renumbered: the next Update rebuilds.
+	void Invalidate() {
+		incremental = false;
+	}
+
+	// Calls fn(index) for every entry whose cell overlaps the square [pos - radius, pos + radius].
+	template<typename Fn>
+	void Query(Vector2 pos, float radius, Fn&& fn) const {
+		QueryCells(pos, radius, [&](const int* cellItems, int n) {
+			for (int k = 0; k < n; ++k) fn(cellItems[k]);
+			return false;
+		});
+	}
+
+	// Same cells as Query, but hands each cell over as one contiguous run of indices
+	// so the caller can test them in SIMD blocks. fn returns true to stop early, and
+	// QueryCells then returns true as well.
+	template<typename Fn>
+	bool QueryCells(Vector2 pos, float radius, Fn&& fn) const {
+		int x0 = ClampCol(static_cast<int>(floorf((pos.x - radius) * invCell)));
+		int x1 = ClampCol(static_cast<int>(floorf((pos.x + radius) * invCell)));
+		int y0 = ClampRow(static_cast<int>(floorf((pos.y - radius) * invCell)));
+		int y1 = ClampRow(static_cast<int>(floorf((pos.y + radius) * invCell)));
+		for (int cy = y0; cy <= y1; ++cy) {
+			for (int cx = x0; cx <= x1; ++cx) {
+				int c = cy * cols + cx;
+				int n = cellCount[c];
+				if (n > 0 && fn(items.data() + cellStart[c], n)) return true;
+			}
+		}
+		return false;
+	}
+
+	float CellSize() const {
+		return cellSize;
+	}
+
+private:
+	// Entities outside the world (e.g. asteroids spawning in from an edge) are clamped
+	// into the border cells; queries clamp the same way, so nothing is missed.
+	int ClampCol(int x) const { return x < 0 ? 0 : (x >= cols ? cols - 1 : x); }
+	int ClampRow(int y) const { return y < 0 ? 0 : (y >= rows ? rows - 1 : y); }
+
+	int CellOf(Vector2 p) const {
+		int cx = ClampCol(static_cast<int>(floorf(p.x * invCell)));
+		int cy = ClampRow(static_cast<int>(floorf(p.y * invCell)));
+		return cy * cols + cx;
+	}
+
+	// The counting sort. With `slack` each cell gets room for a quarter more entries, and
+	// C_SLACK more, for Update() to move entries into.
+	template<typename PosFn>
+	void Rebuild(size_t count, PosFn&& positionOf, bool slack) {
+		std::fill(cellStart.begin(), cellStart.end(), 0);
+		itemCell.resize(count);
+		itemSlot.resize(count);
+
+		for (size_t i = 0; i < count; ++i) {
+			int c = CellOf(positionOf(i));
+			itemCell[i] = c;
+			++cellStart[c + 1];
+		}
+		for (size_t c = 0; c < cellCount.size(); ++c) {
+			cellCount[c] = cellStart[c + 1];
+			if (slack) cellStart[c + 1] += cellStart[c + 1] / 4 + C_SLACK;
+			cellCapacity[c] = cellStart[c + 1];
+		}
+		for (size_t c = 1; c < cellStart.size(); ++c) {
+			cellStart[c] += cellStart[c - 1];
+		}
+		items.resize(static_cast<size_t>(cellStart.back()));
+		cursor.assign(cellStart.begin(), cellStart.end() - 1);
+		for (size_t i = 0; i < count; ++i) {
+			const int slot = cursor[itemCell[i]]++;
+			items[slot] = static_cast<int>(i);
+			itemSlot[i] = slot;
+		}
+		incremental = slack;
+		sinceRebuild = 0;
+		holes = 0;
+		moved = 0;
+		++rebuilds;
+	}
+
+	// Swaps the last entry of i's bucket into i's place.
+	void Remove(int i) {
+		const int c = itemCell[i];
+		const int last = cellStart[c] + --cellCount[c];
+		const int other = items[last];
+		items[itemSlot[i]] = other;
+		itemSlot[other] = itemSlot[i];
+	}
+
+	void Insert(int i, int c) {
+		if (cellCount[c] == cellCapacity[c]) Grow(c);
+		const int slot = cellStart[c] + cellCount[c]++;
+		items[slot] = i;
+		itemSlot[i] = slot;
+		itemCell[i] = c;
+	}
+
+	// Moves a full bucket to the end of items with twice the room.
+	void Grow(int c) {
+		const int from = cellStart[c];
+		const int to = static_cast<int>(items.size());
+		const int room = std::max(cellCapacity[c] * 2, C_SLACK);
+		items.resize(items.size() + static_cast<size_t>(room));
+		for (int k = 0; k < cellCount[c]; ++k) {
+			items[to + k] = items[from + k];
+			itemSlot[items[to + k]] = to + k;
+		}
+		holes += static_cast<size_t>(cellCapacity[c]);
+		cellStart[c] = to;
+		cellCapacity[c] = room;
+	}
+
+	static constexpr int C_SLACK = 2;
+	static constexpr int C_REBUILD_TICKS = 256;
+
+	float cellSize;
+	float invCell;
+	int   cols{};
+	int   rows{};
+
+	std::vector<int> cellStart;
+	std::vector<int> cellCount;     // entries at the front of each cell's bucket
+	std::vector<int> cellCapacity;  // the bucket's size
+	std::vector<int> cursor;
+	std::vector<int> itemCell;
+	std::vector<int> itemSlot;   // where in items each entry is
+	std::vector<int> items;
+	bool             incremental = false;  // the buckets have slack
+	int              sinceRebuild = 0;
+	size_t           holes = 0;  // items left behind by grown buckets
+	size_t           moved = 0;
+	size_t           rebuilds = 0;
+};
+
+// --- SWEEP AND PRUNE ---
+// Broadphase along x: entries are kept sorted by their centre x, so a query is two binary
+// searches and hands back one contiguous run of candidates. The order from the previous
+// build is kept and repaired with an insertion sort, which is close to linear because
+// asteroids move a few pixels per tick. Entries that would have to travel further than
+// C_MAX_SHIFT (new spawns, and slots that compaction refilled with another asteroid) are
+// set aside, sorted on their own and merged back in.
+class SweepAndPrune {
+public:
+	void Build(size_t count, const float* x) {
+		const size_t previous = order.size();
+		misplaced.clear();
+
+		size_t kept = 0;
+		for (size_t k = 0; k < previous; ++k) {
+			const int item = order[k];
+			if (static_cast<size_t>(item) >= count) continue; // compacted away
+			const float key = x[item];
+			size_t j = kept;
+			while (j > 0 && keys[j - 1] > key && kept - j < C_MAX_SHIFT) --j;
+			if (j > 0 && keys[j - 1] > key) {
+				misplaced.push_back({ key, item });
+				continue;
+			}
+			for (size_t m = kept; m > j; --m) {
+				keys[m] = keys[m - 1];
+				order[m] = order[m - 1];
+			}
+			keys[j] = key;
+			order[j] = item;
+			++kept;
+		}
+		for (size_t i = previous; i < count; ++i) {
+			misplaced.push_back({ x[i], static_cast<int>(i) });
+		}
+
+		if (misplaced.empty()) {
+			keys.resize(kept);
+			order.resize(kept);
+			return;
+		}
+		std::sort(misplaced.begin(), misplaced.end(),
+			[](const Entry& a, const Entry& b) { return a.key < b.key; });
+
+		mergedKeys.resize(kept + misplaced.size());
+		mergedOrder.resize(kept + misplaced.size());
+		size_t a = 0, b = 0, out = 0;
+		while (a < kept || b < misplaced.size()) {
+			if (b == misplaced.size() || (a < kept && keys[a] <= misplaced[b].key)) {
+				mergedKeys[out] = keys[a];
+				mergedOrder[out++] = order[a++];
+			}
+			else {
+				mergedKeys[out] = misplaced[b].key;
+				mergedOrder[out++] = misplaced[b++].item;
+			}
+		}
+		keys.swap(mergedKeys);
+		order.swap(mergedOrder);
+	}
+
+	// The entries have been renumbered, entry i to newIndex[i]. The order found so far still
+	// holds, so the next Build only touches up what moved since.
+	void Renumber(const std::vector<uint32_t>& newIndex) {
+		for (int& item : order) {
+			if (static_cast<size_t>(item) < newIndex.size()) item = static_cast<int>(newIndex[static_cast<size_t>(item)]);
+		}
+	}
+
+	// Hands fn every entry with its centre x in [pos.x - radius, pos.x + radius] as one
+	// run of indices, the same contract as SpatialGrid::QueryCells.
+	template<typename Fn>
+	bool QueryCells(Vector2 pos, float radius, Fn&& fn) const {
+		auto lo = std::lower_bound(keys.begin(), keys.end(), pos.x - radius);
+		auto hi = std::upper_bound(lo, keys.end(), pos.x + radius);
+		int n = static_cast<int>(hi - lo);
+		return n > 0 && fn(order.data() + (lo - keys.begin()), n);
+	}
+
+private:
+	struct Entry {
+		float key;
+		int   item;
+	};
+
+	static constexpr size_t C_MAX_SHIFT = 32;
+
+	std::vector<int>   order;
+	std::vector<float> keys;
+	std::vector<Entry> misplaced;
+	std::vector<int>   mergedOrder;
+	std::vector<float> mergedKeys;
+};
+
+// --- CIRCLE BVH ---
+// Bounding volume hierarchy over a small set of circles (the fleet), rebuilt every tick.
+// Nodes split at the median of their longer axis, so the tree stays balanced however the
+// ships cluster; leaves hold up to C_LEAF circles. Buffers are reused between builds, so
+// a rebuild only allocates when the fleet outgrows every previous one.
+class CircleBvh {
+public:
+	// Entries are the indices [0, count) with their centres and radii.
+	void Build(size_t count, const float* x, const float* y, const float* r) {
+		cx = x; cy = y; cr = r;
+		items.resize(count);
+		for (size_t i = 0; i < count; ++i) items[i] = static_cast<int>(i);
+		nodes.resize(count > 0 ? 1 : 0);
+		if (count > 0) Split(0, 0, static_cast<int>(count));
+	}
+
+	bool Empty() const {
+		return nodes.empty();
+	}
+
+	// Box around every entry; only meaningful when not Empty().
+	void Bounds(float& minX, float& minY, float& maxX, float& maxY) const {
+		minX = nodes[0].minX; minY = nodes[0].minY;
+		maxX = nodes[0].maxX; maxY = nodes[0].maxY;
+	}
+
+	// Calls fn(index) for every entry whose bounding box overlaps the circle's.
+	template<typename Fn>
+	void Query(float px, float py, float pr, Fn&& fn) const {
+		if (nodes.empty()) return;
+		int stack[64];
+		int top = 0;
+		stack[top++] = 0;
+		while (top > 0) {
+			const Node& node = nodes[stack[--top]];
+			if (px + pr < node.minX || px - pr > node.maxX || py + pr < node.minY || py - pr > node.maxY) continue;
+			if (node.count > 0) {
+				for (int k = 0; k < node.count; ++k) fn(items[node.first + k]);
+			}
+			else {
+				stack[top++] = node.first;
+				stack[top++] = node.first + 1;
+			}
+		}
+	}
+
+private:
+	struct Node {
+		float minX, minY, maxX, maxY;
+		int   first; // first item for a leaf, left child for an inner node (right is first + 1)
+		int   count; // items in a leaf, 0 for an inner node
+	};
+
+	static constexpr int C_LEAF = 4;
+
+	// Fills nodes[index] for items [begin, end). Children are allocated as a pair, so the
+	// right one is always left + 1.
+	void Split(int index, int begin, int end) {
+		Node node{ INFINITY, INFINITY, -INFINITY, -INFINITY, begin, end - begin };
+		for (int k = begin; k < end; ++k) {
+			int i = items[k];
+			node.minX = fminf(node.minX, cx[i] - cr[i]);
+			node.minY = fminf(node.minY, cy[i] - cr[i]);
+			node.maxX = fmaxf(node.maxX, cx[i] + cr[i]);
+			node.maxY = fmaxf(node.maxY, cy[i] + cr[i]);
+		}
+		if (end - begin > C_LEAF) {
+			const float* axis = (node.maxX - node.minX >= node.maxY - node.minY) ? cx : cy;
+			const int mid = begin + (end - begin) / 2;
+			std::nth_element(items.begin() + begin, items.begin() + mid, items.begin() + end,
+				[axis](int a, int b) { return axis[a] < axis[b]; });
+			node.first = static_cast<int>(nodes.size());
+			node.count = 0;
+			nodes.resize(nodes.size() + 2);
+			Split(node.first, begin, mid);
+			Split(node.first + 1, mid, end);
+		}
+		nodes[index] = node;
+	}
+
+	const float*      cx = nullptr;
+	const float*      cy = nullptr;
+	const float*      cr = nullptr;
+	std::vector<int>  items;
+	std::vector<Node> nodes;
+};
+
+// --- KINETIC COLLISIONS ---
+// Event-driven projectile-vs-asteroid collisions. Both kinds fly in straight lines at a
+// constant velocity, so when two will first touch is a quadratic in closed form. Every
+// live projectile holds one prediction, the earliest asteroid contact it has before
+// either of them leaves the playfield, kept in a min-heap of events. A tick then only
+// pops the events that fall inside it: nothing is paired up per tick, and since contact
+// is solved over the whole flight a fast laser can't step over an asteroid.
+//
+// Predictions are refreshed only on change. A new projectile is tested against every
+// asteroid. An asteroid that got a new course (AsteroidField::Changed) is tested against
+// every projectile and can take over its prediction. A prediction whose asteroid has
+// since died or been replaced is only found out when it comes due, and the projectile is
+// then predicted again from that moment. All of this is linear in the other kind, so it
+// pays off in sparse fields where changes are rare against the ticks that pass. When the
+// projectile store renumbers its slots everything is predicted from scratch.
+class KineticCollider {
+public:
+	// Drops every prediction; the next Step rebuilds them all.
+	void Invalidate() {
+		heap.clear();
+		current.clear();
+		best.clear();
+		seenEnd = 0;
+		built = false;
+	}
+
+	// Advances one tick of length `dt`. Projectiles must already be integrated over it and
+	// asteroids not yet, so both are evaluated at the end of the tick. `changed` lists
+	// asteroid slots given a new course since the last Step. onHit(projectile, asteroid) is
+	// called, in time order, for every contact inside the tick; it must kill the
+	// projectile and flag the asteroid in `dead`.
+	template<typename OnHit>
+	void Step(float dt, const WorldBounds& world, const ProjectileField& projectiles, const AsteroidField& asteroids,
+		const std::vector<char>& dead, const uint32_t* changed, size_t changedCount, OnHit&& onHit)
+	{
+		clock += dt;
+		ps = &projectiles;
+		deadFlags = &dead;
+		lowest = -dt;
+		Gather(dt, world, projectiles, asteroids);
+
+		if (stamp.size() < asteroids.Size()) stamp.resize(asteroids.Size(), 0);
+		for (size_t k = 0; k < changedCount; ++k) {
+			if (changed[k] < stamp.size()) ++stamp[changed[k]];
+		}
+
+		if (!built || projectiles.Layout() != layout) {
+			// Slot numbers changed under every prediction.
+			heap.clear();
+			current.assign(projectiles.End(), 0);
+			best.assign(projectiles.End(), C_NEVER);
+			for (size_t p = projectiles.Begin(); p < projectiles.End(); ++p) Predict(p, lowest);
+			layout = projectiles.Layout();
+			built = true;
+		}
+		else {
+			current.resize(projectiles.End(), 0);
+			best.resize(projectiles.End(), C_NEVER);
+			const size_t from = seenEnd > projectiles.Begin() ? seenEnd : projectiles.Begin();
+			for (size_t p = from; p < projectiles.End(); ++p) Predict(p, lowest);
+			for (size_t k = 0; k < changedCount; ++k) {
+				if (changed[k] < asteroids.Size()) Offer(changed[k]);
+			}
+		}
+		seenEnd = projectiles.End();
+
+		while (!heap.empty() && heap.front().time <= clock) {
+			std::pop_heap(heap.begin(), heap.end(), Later{});
+			const Event e = heap.back();
+			heap.pop_back();
+			if (e.serial != current[e.projectile]) continue;  // superseded
+			current[e.projectile] = 0;
+			best[e.projectile] = C_NEVER;
+			if (projectiles.IsDead(e.projectile)) continue;
+
+			if (e.asteroid < asteroids.Size() && stamp[e.asteroid] == e.stamp && !dead[e.asteroid]) {
+				onHit(static_cast<size_t>(e.projectile), static_cast<int>(e.asteroid));
+			}
+			else {
+				// Its asteroid is gone: look again from the moment it would have hit.
+				Predict(e.projectile, static_cast<float>(e.time - clock));
+			}
+		}
+	}
+
+private:
+	struct Event {
+		double   time;
+		uint32_t projectile;
+		uint32_t asteroid;
+		uint32_t stamp;
+		uint32_t serial;
+	};
+
+	// Heap order: earliest first, ties in the order they were predicted.
+	struct Later {
+		bool operator()(const Event& a, const Event& b) const {
+			return a.time != b.time ? a.time > b.time : a.serial > b.serial;
+		}
+	};
+
+	// Moving state of one kind, as of the end of the tick, plus how long each one has
+	// before it leaves the playfield and is culled.
+	struct Columns {
+		std::vector<float> x, y, vx, vy, r, until;
+
+		void Resize(size_t n) {
+			x.resize(n); y.resize(n); vx.resize(n); vy.resize(n); r.resize(n); until.resize(n);
+		}
+
+		// Time until point i leaves [-margin, w + margin] x [-margin, h + margin].
+		void SetUntil(size_t i, float margin, const WorldBounds& world) {
+			float t = 1e30f;
+			if (vx[i] > 0.f) t = fminf(t, (world.width + margin - x[i]) / vx[i]);
+			else if (vx[i] < 0.f) t = fminf(t, (-margin - x[i]) / vx[i]);
+			if (vy[i] > 0.f) t = fminf(t, (world.height + margin - y[i]) / vy[i]);
+			else if (vy[i] < 0.f) t = fminf(t, (-margin - y[i]) / vy[i]);
+			until[i] = t;
+		}
+	};
+
+	static constexpr double C_NEVER = 1e300;
+
+	// Asteroids are integrated after the collision pass, so they are stepped forward here.
+	void Gather(float dt, const WorldBounds& world, const ProjectileField& projectiles, const AsteroidField& asteroids) {
+		first = projectiles.Begin();
+		const size_t np = projectiles.Slots();
+		proj.Resize(np);
+		for (size_t k = 0; k < np; ++k) {
+			Vector2 p = projectiles.GetPosition(first + k);
+			Vector2 v = projectiles.GetVelocity(first + k);
+			proj.x[k] = p.x; proj.y[k] = p.y; proj.vx[k] = v.x; proj.vy[k] = v.y;
+			proj.r[k] = projectiles.GetRadius(first + k);
+			proj.SetUntil(k, 0.f, world);
+		}
+		const size_t na = asteroids.Size();
+		rock.Resize(na);
+		for (size_t a = 0; a < na; ++a) {
+			Vector2 p = asteroids.GetPosition(a);
+			Vector2 v = asteroids.GetVelocity(a);
+			rock.x[a] = p.x + v.x * dt; rock.y[a] = p.y + v.y * dt; rock.vx[a] = v.x; rock.vy[a] = v.y;
+			rock.r[a] = asteroids.GetRadius(a);
+			rock.SetUntil(a, rock.r[a], world);
+		}
+		times.resize(np > na ? np : na);
+	}
+
+	// Earliest contact of projectile p with any live asteroid from `lower` on; ties go to
+	// the lower asteroid index.
+	void Predict(size_t p, float lower) {
+		if (ps->IsDead(p)) return;
+		const size_t k = p - first;
+		const size_t na = rock.x.size();
+		Simd::ContactTimes(proj.x[k], proj.y[k], proj.vx[k], proj.vy[k], proj.r[k], lower, proj.until[k],
+			rock.x.data(), rock.y.data(), rock.vx.data(), rock.vy.data(), rock.r.data(), rock.until.data(), na, times.data());
+		int hit = -1;
+		float when = Simd::C_NO_CONTACT;
+		for (size_t a = 0; a < na; ++a) {
+			if (times[a] < when && !(*deadFlags)[a]) {
+				when = times[a];
+				hit = static_cast<int>(a);
+			}
+		}
+		if (hit >= 0) Schedule(p, static_cast<size_t>(hit), when);
+	}
+
+	// Asteroid a has a new course: it takes over any projectile it now reaches first.
+	void Offer(size_t a) {
+		if ((*deadFlags)[a]) return;
+		const size_t np = proj.x.size();
+		Simd::ContactTimes(rock.x[a], rock.y[a], rock.vx[a], rock.vy[a], rock.r[a], lowest, rock.until[a],
+			proj.x.data(), proj.y.data(), proj.vx.data(), proj.vy.data(), proj.r.data(), proj.until.data(), np, times.data());
+		for (size_t k = 0; k < np; ++k) {
+			if (times[k] == Simd::C_NO_CONTACT) continue;
+			const size_t p = first + k;
+			if (clock + times[k] < best[p] && !ps->IsDead(p)) Schedule(p, a, times[k]);
+		}
+	}
+
+	void Schedule(size_t p, size_t a, float t) {
+		Event e{ clock + t, static_cast<uint32_t>(p), static_cast<uint32_t>(a), stamp[a], ++serial };
+		current[p] = e.serial;
+		best[p] = e.time;
+		heap.push_back(e);
+		std::push_heap(heap.begin(), heap.end(), Later{});
+	}
+
+	std::vector<Event>    heap;
+	std::vector<uint32_t> current;  // per projectile slot: serial of its live prediction
+	std::vector<double>   best;     // per projectile slot: when that prediction is due
+	std::vector<uint32_t> stamp;    // per asteroid slot: bumped on every new course
+	double                clock = 0.0;
+	uint32_t              serial = 0;
+	uint32_t              layout = 0;
+	size_t                seenEnd = 0;
+	bool                  built = false;
+
+	// Rebuilt by every Step.
+	Columns                  proj;   // indexed from `first`, the start of the projectile window
+	Columns                  rock;
+	std::vector<float>       times;
+	size_t                   first = 0;
+	float                    lowest = 0.f;  // start of the tick
+	const ProjectileField*   ps = nullptr;
+	const std::vector<char>* deadFlags = nullptr;
+};
+
+// INCREMENTAL is GRID's grid kept up to date instead of rebuilt (SpatialGrid::Update).
+enum class Broadphase { GRID, SWEEP, BRUTE, KINETIC, INCREMENTAL, COUNT };
+
+inline const char* BroadphaseName(Broadphase b) {
+	static constexpr const char* names[] = { "grid", "sap", "brute", "kinetic", "incremental" };
+	return names[static_cast<int>(b)];
+}
+
+// Returns false for an unknown name.
+inline bool ParseBroadphase(const char* name, Broadphase& out) {
+	for (int b = 0; b < static_cast<int>(Broadphase::COUNT); ++b) {
+		if (TextIsEqual(name, BroadphaseName(static_cast<Broadphase>(b)))) {
+			out = static_cast<Broadphase>(b);
+			return true;
+		}
+	}
+	return false;
+}
+
+// --- WORLD ---
+// One game's simulation: the field, the fleet, the spawn and weapon timers and the
+// generator they draw from, with everything a tick needs to step them. It knows nothing
+// of windows or threads; Application drives one from its simulation thread, WorldBatch
+// steps many side by side. Every entry point below routes the Utils::Random* calls of the
+// thread it runs on to the world's own Rng (Utils::RngScope), so a world replays the same
+// from a seed on whichever thread, and next to however many others, it is stepped.
+class World {
+public:
+    World()
+        : asteroidGrid(static_cast<float>(scenario.width), static_cast<float>(scenario.height), Asteroid::MAX_RADIUS)
+    {
+        {
+            MEMORY_SCOPE(ASTEROIDS);
+            asteroids.Reserve(C_MAX_ASTEROIDS);
+        }
+        MEMORY_SCOPE(PROJECTILES);
+        projectiles.Reserve(C_MAX_PROJECTILES);
+    }
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // Resizes the world for a scenario. Call before Reset.
+    void Configure(const Scenario& s) {
+        scenario = s;
+        tickDt = TickDtOf(s);
+        ConfigureRegion();
+        const size_t asteroidCapacity = (s.asteroids + s.maxAsteroids + s.waveSize) * C_SPLIT_HEADROOM;
+        asteroidDead.reserve(asteroidCapacity);
+        asteroidSplits.reserve(asteroidCapacity);
+        MEMORY_SCOPE(ASTEROIDS);
+        asteroids.Reserve(asteroidCapacity);
+        MEMORY_SCOPE(PROJECTILES);
+        projectiles.Reserve(s.projectiles + C_MAX_PROJECTILES);
+    }
+
+    // The sprite's size defines the ship radius. Before Reset.
+    void SetSpriteSize(Vector2 size) {
+        shipSpriteSize = size;
+    }
+
+    // Lockstep mode: positions, velocities, timers and collision tests on the Fixed grid, so
+    // identical inputs give bit-identical states on any machine and build (Checksum). That is
+    // the input as recorded: the Autopilot decides in floats, so its flights are only
+    // reproducible on the machine that flew them (WorldBatch's too). KINETIC
+    // solves contact times in floats and falls back to GRID. Before Reset.
+    void SetLockstep(bool on) {
+        lockstep = on;
+        asteroids.SetFixedPoint(on);
+        projectiles.SetFixedPoint(on);
+        fleet.SetFixedPoint(on);
+        tickDt = TickDtOf(scenario);
+        ConfigureRegion();
+        SetBroadphase(broadphase);
+    }
+
+    bool Lockstep() const {
+        return lockstep;
+    }
+
+    // Scenario::spatialSort, which a replay sets to what it was recorded with.
+    void SetSpatialSort(int ticks) {
+        scenario.spatialSort = ticks;
+        sinceSort = 0;
+    }
+
+    int SpatialSort() const {
+        return scenario.spatialSort;
+    }
+
+    // Back-pressure from the FrameGovernor: the timed spawner and the waves run at this
+    // fraction of their pace. Not part of a replay's input, so 1 whenever one is recorded
+    // or played back.
+    void SetSpawnRate(float rate) {
+        spawnRate = rate;
+    }
+
+    // Stream `stream` of `seed`; a replay only reproduces from stream 0.
+    void Seed(uint64_t seed, uint64_t stream = 0) {
+        rng.Seed(seed, stream);
+    }
+
+    // A new session from `seed`: the first weapon and shape, then a fresh world.
+    void Start(uint64_t seed, uint64_t stream = 0) {
+        Seed(seed, stream);
+        currentWeapon = WeaponType::LASER;
+        currentShape = AsteroidShape::TRIANGLE;
+        Reset();
+    }
+
+    // Fresh player and empty field, then the scenario's preloaded entities.
+    void Reset() {
+        Utils::RngScope scope(rng);
+        {
+            MEMORY_SCOPE(SHIPS);
+            fleet.Reset(static_cast<int>(bounds.width), static_cast<int>(bounds.height), shipSpriteSize);
+        }
+        asteroids.Clear();
+        projectiles.Clear();
+        sectors.Clear();
+        region = CentredRegion();
+        spawnTimer = 0.f;
+        spawnInterval = NextSpawnInterval();
+        waveTimer = 0.f;
+        wavePending = 0;
+        shotTimer = 0.f;
+        simClock = 0.0;
+        sinceSort = 0;
+        kinetic.Invalidate();
+
+        Populate(scenario.asteroids, scenario.projectiles);
+        MEMORY_SCOPE(SHIPS);
+        for (int d = 0; d < scenario.orbiters; ++d) {
+            fleet.AddOrbiter(d);
+        }
+    }
+
+    // Room for populations held at these counts (Populate every tick).
+    void Reserve(size_t asteroidCount, size_t projectileCount) {
+        MEMORY_SCOPE(ASTEROIDS);
+        asteroids.Reserve(asteroidCount * C_SPLIT_HEADROOM);
+        asteroidDead.reserve(asteroidCount * C_SPLIT_HEADROOM);
+        asteroidSplits.reserve(asteroidCount * C_SPLIT_HEADROOM);
+        MEMORY_SCOPE(PROJECTILES);
+        projectiles.Reserve(projectileCount + C_MAX_PROJECTILES);
+    }
+
+    // One frame: its presses, then its ticks at tickDt.
+    void Step(const FrameInput& in) {
+        HandleFrameInput(in.pressed);
+        for (int t = 0; t < in.ticks; ++t) {
+            Tick(tickDt, in.held);
+        }
+        simClock += in.ticks * static_cast<double>(tickDt);
+    }
+
+    // What `pilot` would press over the next `ticks` ticks of this world.
+    FrameInput Fly(Autopilot& pilot, int ticks) const {
+        return pilot.Fly(fleet, asteroids, bounds, currentWeapon, ticks, tickDt);
+    }
+
+    void SetBroadphase(Broadphase b) {
+        if (lockstep && b == Broadphase::KINETIC) {
+            TraceLog(LOG_WARNING, "WORLD: kinetic collisions aren't deterministic, lockstep uses the grid");
+            b = Broadphase::GRID;
+        }
+        broadphase = b;
+        kinetic.Invalidate();
+        UpdateChangeTracking();
+    }
+
+    // Asteroid kills are collected for Explosions() only while this is on.
+    void ReportExplosions(bool on) {
+        reportExplosions = on;
+        if (!on) explosions.clear();
+    }
+
+    // The kills since the caller last emptied it.
+    std::vector<Explosion>& Explosions() {
+        return explosions;
+    }
+
+    // Keeps a log of every asteroid slot that changed course (TakeChanges) for a renderer
+    // drawing them analytically.
+    void KeepChanges(bool on) {
+        keepChanges = on;
+        UpdateChangeTracking();
+    }
+
+    // Every slot changed since the last ClearChanges, duplicates and all.
+    const std::vector<uint32_t>& TakeChanges() {
+        TakeAsteroidChanges();
+        return asteroidChanges;
+    }
+
+    void ClearChanges() {
+        asteroidChanges.clear();
+    }
+
+    // Streaming mode (Scenario::worldWidth): the world is a grid of playfield-sized sectors,
+    // of which only the C_REGION_SECTORS x C_REGION_SECTORS around the player are
+    // simulated, with the player in the middle one. Entity positions are relative to the
+    // region; the rest of the world's asteroids are parked in the SectorMap.
+    bool                     Streaming() const { return streaming; }
+    const SectorMap&         Sectors() const { return sectors; }
+    const SectorMap::Region& GetRegion() const { return region; }
+
+    // The region's corner in world coordinates: add it to an entity's position for the
+    // world one, which only changes when the entity moves. (0, 0) unless streaming.
+    Vector2 Origin() const {
+        return { static_cast<float>(region.col) * static_cast<float>(scenario.width), static_cast<float>(region.row) * static_cast<float>(scenario.height) };
+    }
+
+    const Scenario&        GetScenario() const { return scenario; }
+    const AsteroidField&   Asteroids() const { return asteroids; }
+    const ProjectileField& Projectiles() const { return projectiles; }
+    const Fleet&           GetFleet() const { return fleet; }
+    const FrameArena&      TickArena() const { return tickArena; }
+    WorldBounds            Bounds() const { return bounds; }
+    WeaponType             Weapon() const { return currentWeapon; }
+    Broadphase             GetBroadphase() const { return broadphase; }
+    float                  TickDt() const { return tickDt; }
+    double                 SimClock() const { return simClock; }  // simulation seconds since the last Reset
+
+    // Fingerprint of the simulation state, for checking that a replay matched its recording.
+    int Score() const {
+        return fleet.GetScore(Fleet::C_PLAYER);
+    }
+
+    // FNV-1a over every entity's state and the timers, for comparing lockstep peers tick by
+    // tick; equal only between worlds fed the same inputs in the same mode.
+    uint64_t Checksum() const {
+        uint64_t h = 14695981039346656037ull;
+        auto mix = [&h](const void* data, size_t bytes) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (size_t i = 0; i < bytes; ++i) {
+                h ^= p[i];
+                h *= 1099511628211ull;
+            }
+        };
+        auto mixFloat = [&mix](float v) { mix(&v, sizeof(v)); };
+        auto mixInt = [&mix](int64_t v) { mix(&v, sizeof(v)); };
+        mixInt(static_cast<int64_t>(asteroids.Size()));
+        for (size_t i = 0; i < asteroids.Size(); ++i) {
+            const Vector2 p = asteroids.GetPosition(i);
+            const Vector2 v = asteroids.GetVelocity(i);
+            mixFloat(p.x); mixFloat(p.y); mixFloat(v.x); mixFloat(v.y); mixFloat(asteroids.GetRadius(i));
+        }
+        for (size_t i = projectiles.Begin(); i < projectiles.End(); ++i) {
+            if (projectiles.IsDead(i)) continue;
+            const Vector2 p = projectiles.GetPosition(i);
+            const Vector2 v = projectiles.GetVelocity(i);
+            mixFloat(p.x); mixFloat(p.y); mixFloat(v.x); mixFloat(v.y);
+            mixInt(static_cast<int64_t>(projectiles.GetType(i)));
+            mixInt(projectiles.GetOwner(i).bits);
+        }
+        mixInt(static_cast<int64_t>(fleet.Size()));
+        for (size_t i = 0; i < fleet.Size(); ++i) {
+            const Vector2 p = fleet.GetPosition(i);
+            mixFloat(p.x); mixFloat(p.y); mixFloat(fleet.GetRotation(i));
+            mixInt(fleet.GetHP(i));
+            mixInt(fleet.GetScore(i));
+        }
+        mixFloat(spawnTimer); mixFloat(spawnInterval); mixFloat(waveTimer); mixFloat(shotTimer);
+        mixInt(static_cast<int64_t>(wavePending));
+        mixInt(static_cast<int64_t>(currentWeapon));
+        mixInt(static_cast<int64_t>(currentShape));
+        if (streaming) {
+            mixInt(region.col); mixInt(region.row);
+            mixInt(static_cast<int64_t>(sectors.Size()));
+            h = sectors.Checksum(h);
+        }
+        return h;
+    }
+
+    // Everything the next tick depends on, as a WorldSnapshot file: the scenario, the mode,
+    // the generator, the timers and every entity. Between frames. Returns the bytes
+    // written, 0 when the file could not be.
+    size_t Save(const char* path) const {
+        SavedState state;
+        state.scenario = scenario;
+        state.rng = rng;
+        state.shipSpriteSize = shipSpriteSize;
+        state.simClock = simClock;
+        state.wavePending = wavePending;
+        state.sinceSort = sinceSort;
+        state.spawnTimer = spawnTimer;
+        state.spawnInterval = spawnInterval;
+        state.waveTimer = waveTimer;
+        state.shotTimer = shotTimer;
+        state.weapon = currentWeapon;
+        state.shape = currentShape;
+        state.lockstep = lockstep;
+
+        WorldSnapshot::Writer out;
+        out.AddValue(C_SNAPSHOT_TAG, 0, state);
+        asteroids.Save(out);
+        projectiles.Save(out);
+        fleet.Save(out);
+        if (streaming) {
+            out.AddValue(C_SNAPSHOT_TAG, 1, region);
+            sectors.Save(out);
+        }
+        return out.Save(path);
+    }
+
+    // Replaces the world with a saved one, which then steps on exactly as the original
+    // would have (Checksum matches): its scenario is Configured and its mode set. The
+    // broadphase, explosion reports and change log stay as they were set here. False when
+    // `in` holds no world from this build; a world whose entities fail to load is Reset.
+    bool Load(const WorldSnapshot::Reader& in) {
+        SavedState state;
+        if (!in.ReadValue(C_SNAPSHOT_TAG, 0, state) || state.weapon >= WeaponType::COUNT || state.shape > AsteroidShape::RANDOM) {
+            return false;
+        }
+        Configure(state.scenario);
+        SetLockstep(state.lockstep);
+        rng = state.rng;
+        shipSpriteSize = state.shipSpriteSize;
+        simClock = state.simClock;
+        wavePending = static_cast<size_t>(state.wavePending);
+        sinceSort = state.sinceSort;
+        spawnTimer = state.spawnTimer;
+        spawnInterval = state.spawnInterval;
+        waveTimer = state.waveTimer;
+        shotTimer = state.shotTimer;
+        currentWeapon = state.weapon;
+        currentShape = state.shape;
+        kinetic.Invalidate();
+        explosions.clear();
+
+        bool ok;
+        {
+            MEMORY_SCOPE(ASTEROIDS);
+            ok = asteroids.Load(in);
+        }
+        {
+            MEMORY_SCOPE(PROJECTILES);
+            ok = ok && projectiles.Load(in);
+        }
+        {
+            MEMORY_SCOPE(SHIPS);
+            ok = ok && fleet.Load(in, shipSpriteSize);
+        }
+        if (streaming) {
+            MEMORY_SCOPE(SECTORS);
+            SectorMap::Region saved{};
+            ok = ok && in.ReadValue(C_SNAPSHOT_TAG, 1, saved) && saved.cols == region.cols && saved.rows == region.rows
+                && saved.col >= 0 && saved.row >= 0 && saved.col + saved.cols <= sectors.Cols() && saved.row + saved.rows <= sectors.Rows()
+                && sectors.Load(in);
+            if (ok) region = saved;
+        }
+        if (!ok) {
+            TraceLog(LOG_WARNING, "WORLD: snapshot entities are damaged, starting a fresh world");
+            Reset();
+        }
+        return ok;
+    }
+
+    // Tops the field up to the counts with entities scattered over the playfield.
+    void Populate(size_t asteroidCount, size_t projectileCount) {
+        Utils::RngScope scope(rng);
+        MEMORY_SCOPE(ASTEROIDS);
+        while (asteroids.Size() < asteroidCount && asteroids.Spawn(static_cast<int>(bounds.width), static_cast<int>(bounds.height), AsteroidShape::RANDOM)) {
+            asteroids.SetPosition(asteroids.Size() - 1, RandomPointInWorld());
+        }
+        MEMORY_SCOPE(PROJECTILES);
+        while (projectiles.Size() < projectileCount) {
+            WeaponType wt = static_cast<WeaponType>(Utils::RandomInt(0, static_cast<int>(WeaponType::COUNT) - 1));
+            float speed = Fleet::Spacing(wt) * Fleet::FireRate(wt);
+            if (lockstep) {
+                const Vector2 pos = RandomPointInWorld();
+                projectiles.Add(MakeProjectileFixed(wt, pos, Fixed::FromFloat(speed), Utils::RandomFixed(0, Fixed::C_FULL_TURN), fleet.HandleOf(Fleet::C_PLAYER)));
+            }
+            else {
+                projectiles.Add(MakeProjectile(wt, RandomPointInWorld(), speed, Utils::RandomFloat(0, 360), fleet.HandleOf(Fleet::C_PLAYER)));
+            }
+        }
+    }
+
+    // Queues whatever the field lacks of `asteroidCount` as a wave, so a held population
+    // comes in from the edges as the waves do instead of landing on the ship.
+    void QueueShortfall(size_t asteroidCount) {
+        const size_t coming = asteroids.Size() + wavePending;
+        if (coming < asteroidCount) wavePending += asteroidCount - coming;
+    }
+
+    // Edge-triggered keys are read once per rendered frame so a press is never
+    // applied twice when several ticks run in the same frame.
+    void HandleFrameInput(uint32_t pressed) {
+        PROFILE_SCOPE(INPUT);
+        if (!fleet.IsAlive(Fleet::C_PLAYER) && (pressed & Input::RESTART)) {
+            Reset();
+        }
+
+        if (pressed & Input::SHAPE_TRIANGLE) {
+            currentShape = AsteroidShape::TRIANGLE;
+        }
+        if (pressed & Input::SHAPE_SQUARE) {
+            currentShape = AsteroidShape::SQUARE;
+        }
+        if (pressed & Input::SHAPE_PENTAGON) {
+            currentShape = AsteroidShape::PENTAGON;
+        }
+        if (pressed & Input::SHAPE_RANDOM) {
+            currentShape = AsteroidShape::RANDOM;
+        }
+
+
+        if (pressed & Input::NEXT_WEAPON) {
+            currentWeapon = static_cast<WeaponType>((static_cast<int>(currentWeapon) + 1) % static_cast<int>(WeaponType::COUNT));
+        }
+    }
+
+    // `input` is the frame's held-key mask (Input::Bit).
+    void Tick(float dt, uint32_t input) {
+        Utils::RngScope scope(rng);
+        const Profiler::Clock::time_point start = Profiler::Clock::now();
+        UpdateShips(dt, input);
+        SpawnAsteroids(dt);
+
+        // Nothing is erased while the passes below run: asteroids are only flagged dead and
+        // compacted once at the end of the tick, projectiles are tombstoned in their store.
+        asteroidDead.assign(asteroids.Size(), 0);
+        asteroidSplits.clear();
+        collisions.Clear();
+        tickArena.Reset();
+
+        // Detection only records events; ResolveCollisions applies them. KINETIC's contacts
+        // come due in time order and are applied as they do. Asteroids move only after
+        // resolving, so every pair is tested where the asteroid stood when the tick began.
+        IntegrateProjectiles(dt);
+        if (broadphase == Broadphase::KINETIC) {
+            CollideKinetic(dt);
+            DetectShipHits();
+        }
+        else if (broadphase == Broadphase::BRUTE) {
+            DetectProjectileHits(dt);
+            DetectShipHits();
+        }
+        else {
+            BuildBroadphase();
+            DetectHits(dt);
+        }
+        ResolveCollisions(dt);
+        SplitAsteroids();
+        IntegrateAsteroids(dt);
+        SpawnOrbiters();
+        if (streaming) Stream(dt);
+        if (scenario.spatialSort > 0 && ++sinceSort >= scenario.spatialSort) SortSpatially();
+        FrameTimes::Instance().Record(FrameTimes::Series::SIM_TICK, Profiler::Milliseconds(start, Profiler::Clock::now()));
+    }
+
+private:
+    Vector2 RandomPointInWorld() const {
+        if (lockstep) {
+            const Fixed::Raw x = Utils::RandomFixed(0, Fixed::FromInt(scenario.width));
+            return { Fixed::ToFloat(x), Fixed::ToFloat(Utils::RandomFixed(0, Fixed::FromInt(scenario.height))) };
+        }
+        return { Utils::RandomFloat(0, bounds.width), Utils::RandomFloat(0, bounds.height) };
+    }
+
+    // Lockstep worlds round the step to the Q.16 grid of seconds.
+    float TickDtOf(const Scenario& s) const {
+        const float dt = 1.f / static_cast<float>(std::max(s.tickRate, 1));
+        return lockstep ? Fixed::ToSeconds(Fixed::FromSeconds(dt)) : dt;
+    }
+
+    // Lockstep timers stay on the Q.16 grid of seconds, where float sums are exact.
+    float NextSpawnInterval() const {
+        if (lockstep) {
+            return Fixed::ToSeconds(Utils::RandomFixed(Fixed::FromSeconds(scenario.spawnMin), Fixed::FromSeconds(scenario.spawnMax)));
+        }
+        return Utils::RandomFloat(scenario.spawnMin, scenario.spawnMax);
+    }
+
+    void UpdateShips(float dt, uint32_t input) {
+        PROFILE_SCOPE(SHIPS);
+        MEMORY_SCOPE(SHIPS);
+        fleet.Update(dt, input);
+
+        if (fleet.IsAlive(Fleet::C_PLAYER) && (input & Input::FIRE)) {
+            const size_t fired = fleet.Shoot(projectiles, currentWeapon, shotTimer, dt);
+            SoundEffects::Instance().Trigger(SoundEffects::Effect::SHOT, static_cast<uint32_t>(fired), Pan(fleet.GetPosition(Fleet::C_PLAYER)));
+        }
+        else if (lockstep) {
+            const int32_t maxInterval = Fleet::FireIntervalFixed(currentWeapon);
+            shotTimer = Fixed::ToSeconds(Fixed::FromSeconds(shotTimer) % maxInterval);
+        }
+        else {
+            float maxInterval = 1.f / Fleet::FireRate(currentWeapon);
+            if (shotTimer > maxInterval) {
+                shotTimer = fmodf(shotTimer, maxInterval);
+            }
+        }
+    }
+
+    void SpawnAsteroids(float dt) {
+        PROFILE_SCOPE(SPAWN);
+        MEMORY_SCOPE(ASTEROIDS);
+        spawnTimer += dt * spawnRate;
+        if (spawnTimer >= spawnInterval && asteroids.Size() < scenario.maxAsteroids) {
+            asteroids.Spawn(static_cast<int>(bounds.width), static_cast<int>(bounds.height), currentShape);
+            spawnTimer = 0.f;
+            spawnInterval = NextSpawnInterval();
+        }
+
+        // Waves, and QueueShortfall's, are queued and released C_WAVE_BUDGET per tick, so a
+        // wave of thousands is spread over a few ticks instead of landing in one.
+        if (scenario.waveSize > 0) {
+            waveTimer += dt * spawnRate;
+            if (waveTimer >= (lockstep ? Fixed::ToSeconds(Fixed::FromSeconds(scenario.waveInterval)) : scenario.waveInterval)) {
+                waveTimer = 0.f;
+                wavePending += scenario.waveSize;
+            }
+        }
+        if (wavePending > 0) {
+            const size_t n = wavePending < C_WAVE_BUDGET ? wavePending : C_WAVE_BUDGET;
+            // A full field leaves the rest queued until splits and kills make room.
+            wavePending -= asteroids.SpawnWave(n, static_cast<int>(bounds.width), static_cast<int>(bounds.height), currentShape);
+        }
+    }
+
+    void IntegrateProjectiles(float dt) {
+        PROFILE_SCOPE(PROJECTILES);
+        MEMORY_SCOPE(PROJECTILES);
+        const size_t first = projectiles.Begin();
+        JobSystem::Instance().ParallelFor(projectiles.Slots(), C_JOB_CHUNK, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("projectiles chunk");
+            projectiles.Integrate(dt, bounds, first + begin, first + end);
+        });
+    }
+
+    void BuildBroadphase() {
+        PROFILE_SCOPE(BROADPHASE);
+        MEMORY_SCOPE(COLLISION);
+        switch (broadphase) {
+        case Broadphase::GRID:
+            asteroidGrid.Build(asteroids.Size(),
+                [this](size_t i) { return asteroids.GetPosition(i); });
+            break;
+        case Broadphase::INCREMENTAL:
+            asteroidGrid.Update(asteroids.Size(),
+                [this](size_t i) { return asteroids.GetPosition(i); });
+            break;
+        case Broadphase::SWEEP:
+            asteroidSweep.Build(asteroids.Size(), asteroids.X());
+            break;
+        default:
+            break;
+        }
+    }
+
+    void DetectProjectileHits(float dt) {
+        PROFILE_SCOPE(COLLISION);
+        MEMORY_SCOPE(COLLISION);
+        // Broadphase runs in parallel against the untouched field and only records each
+        // projectile's first candidate; ResolveCollisions settles who got there first.
+        const size_t first = projectiles.Begin();
+        const size_t pass = collisions.AddPass(projectiles.Slots(), C_JOB_CHUNK);
+        JobSystem::Instance().ParallelFor(projectiles.Slots(), C_JOB_CHUNK, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("broadphase chunk");
+            CollisionEvents::Buffer& out = collisions.Chunk(pass, begin, C_JOB_CHUNK);
+            for (size_t k = begin; k < end; ++k) {
+                const size_t pi = first + k;
+                if (projectiles.IsDead(pi)) continue;
+                int hit = FirstHit(pi, dt);
+                if (hit >= 0) out.push_back({ static_cast<uint32_t>(pi), static_cast<uint32_t>(hit), CollisionEvent::Kind::PROJECTILE_ASTEROID });
+            }
+        });
+    }
+
+    // GRID, INCREMENTAL, SWEEP: every kind of pair in one sweep over the one broadphase. The
+    // broadphase holds the asteroids, which are in every pair; the queriers are the projectile
+    // slots followed by the ships, and each finds its asteroids by asking it for its
+    // surroundings, so the field isn't walked a second time for the ships. The events still
+    // come in two passes, the projectiles' and then the ships'. A ship only reports the
+    // asteroids it is the lowest live ship of, as the asteroid walk (DetectShipHits) would
+    // have, and its pass is put back in asteroid order, so resolving comes out the same.
+    void DetectHits(float dt) {
+        PROFILE_SCOPE(COLLISION);
+        MEMORY_SCOPE(COLLISION);
+        BuildShipBvh();
+        const size_t first = projectiles.Begin();
+        const size_t slots = projectiles.Slots();
+        const size_t queriers = slots + (shipBvh.Empty() ? 0 : fleet.Size());
+        const size_t pass = collisions.AddPass(slots, C_JOB_CHUNK);
+        const size_t shipPass = collisions.AddPass(queriers, C_JOB_CHUNK);
+        JobSystem::Instance().ParallelFor(queriers, C_JOB_CHUNK, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("collision chunk");
+            if (begin < slots) {
+                CollisionEvents::Buffer& out = collisions.Chunk(pass, begin, C_JOB_CHUNK);
+                for (size_t k = begin; k < end && k < slots; ++k) {
+                    const size_t pi = first + k;
+                    if (projectiles.IsDead(pi)) continue;
+                    int hit = FirstHit(pi, dt);
+                    if (hit >= 0) out.push_back({ static_cast<uint32_t>(pi), static_cast<uint32_t>(hit), CollisionEvent::Kind::PROJECTILE_ASTEROID });
+                }
+            }
+            if (end > slots) {
+                CollisionEvents::Buffer& out = collisions.Chunk(shipPass, begin, C_JOB_CHUNK);
+                for (size_t k = begin > slots ? begin : slots; k < end; ++k) CollectShipHits(k - slots, out);
+            }
+        });
+        collisions.SortByAsteroid(shipPass, queriers, C_JOB_CHUNK);
+    }
+
+    // A ship's share of DetectHits: the asteroids near it whose lowest live ship it is.
+    void CollectShipHits(size_t si, CollisionEvents::Buffer& out) const {
+        if (!fleet.IsAlive(si)) return;
+        const Vector2 spos = { shipX[si], shipY[si] };
+        // A pixel of slack, so the float test never drops a pair the lockstep one keeps
+        const float slack = shipR[si] + 1.0f;
+        auto test = [&](const int* run, int n) {
+            for (int k = 0; k < n; ++k) {
+                const size_t ai = static_cast<size_t>(run[k]);
+                float dx = asteroids.X()[ai] - spos.x;
+                float dy = asteroids.Y()[ai] - spos.y;
+                float rs = slack + asteroids.Radii()[ai];
+                if (dx * dx + dy * dy >= rs * rs || asteroidDead[ai]) continue;
+                if (ShipHit(ai) == static_cast<int>(si)) out.push_back({ static_cast<uint32_t>(si), static_cast<uint32_t>(ai), CollisionEvent::Kind::SHIP_ASTEROID });
+            }
+            return false;
+        };
+        if (broadphase == Broadphase::SWEEP) asteroidSweep.QueryCells(spos, slack + Asteroid::MAX_RADIUS, test);
+        else asteroidGrid.QueryCells(spos, slack + Asteroid::MAX_RADIUS, test);
+    }
+
+    // The only place the collision passes change the world, one event at a time in the
+    // order CollisionEvents keeps, so the result is the same as a single-threaded pass no
+    // matter how chunks were split. A projectile whose asteroid an earlier one already took
+    // looks again; an asteroid whose ship has died since tries the next one it overlaps.
+    void ResolveCollisions(float dt) {
+        PROFILE_SCOPE(COLLISION);
+        MEMORY_SCOPE(COLLISION);
+        collisions.ForEach([&](const CollisionEvent& e) {
+            switch (e.kind) {
+            case CollisionEvent::Kind::PROJECTILE_ASTEROID: {
+                int hit = static_cast<int>(e.b);
+                if (asteroidDead[hit]) hit = FirstHit(e.a, dt);
+                if (hit >= 0) ResolveHit(e.a, hit);
+                break;
+            }
+            case CollisionEvent::Kind::SHIP_ASTEROID: {
+                if (asteroidDead[e.b]) break;
+                int target = static_cast<int>(e.a);
+                if (!fleet.IsAlive(e.a)) target = ShipHit(e.b);
+                if (target >= 0) ResolveShipHit(static_cast<size_t>(target), e.b);
+                break;
+            }
+            }
+        });
+    }
+
+    // KINETIC: contacts come due from the predictions instead of being searched for.
+    void CollideKinetic(float dt) {
+        PROFILE_SCOPE(COLLISION);
+        MEMORY_SCOPE(COLLISION);
+        TakeAsteroidChanges();
+        kinetic.Step(dt, bounds, projectiles, asteroids, asteroidDead, kineticChanges.data(), kineticChanges.size(),
+            [this](size_t pi, int ai) { ResolveHit(pi, ai); });
+        kineticChanges.clear();
+    }
+
+    void ResolveHit(size_t pi, int hit) {
+        // A shot that outlives its orbiter goes unscored.
+        const int owner = fleet.Find(projectiles.GetOwner(pi));
+        if (owner >= 0) fleet.AddScore(static_cast<size_t>(owner), 1);
+
+        asteroidDead[hit] = 1;
+        projectiles.Kill(pi);
+        asteroidSplits.push_back(hit);
+        ReportExplosion(static_cast<size_t>(hit));
+        SoundEffects::Instance().Trigger(SoundEffects::Effect::HIT, 1, Pan(asteroids.GetPosition(static_cast<size_t>(hit))));
+    }
+
+    // Stereo position of a world point for SoundEffects, in raylib's pan (1 left, 0 right).
+    float Pan(Vector2 p) const {
+        if (streaming) return 0.5f - (p.x - fleet.GetPosition(Fleet::C_PLAYER).x) / static_cast<float>(scenario.width);
+        return 1.f - p.x / static_cast<float>(scenario.width);
+    }
+
+    // Moves the field's change log onto each consumer's own copy: asteroidChanges collects
+    // everything since the last ClearChanges (TakeChanges), kineticChanges everything since
+    // the last CollideKinetic. Neither clearing its log can lose the other's entries, such
+    // as the splits and compaction moves that land after a tick's collisions.
+    void TakeAsteroidChanges() {
+        const std::vector<uint32_t>& log = asteroids.Changed();
+        if (keepChanges) asteroidChanges.insert(asteroidChanges.end(), log.begin(), log.end());
+        if (broadphase == Broadphase::KINETIC) kineticChanges.insert(kineticChanges.end(), log.begin(), log.end());
+        asteroids.ClearChanged();
+    }
+
+    void UpdateChangeTracking() {
+        bool on = keepChanges || broadphase == Broadphase::KINETIC;
+        asteroids.TrackChanges(on);
+        if (!keepChanges) asteroidChanges.clear();
+        if (broadphase != Broadphase::KINETIC) kineticChanges.clear();
+    }
+
+    // The fleet goes into a BVH once per tick and each asteroid only tests the ships near
+    // it, so orbiter trees of any depth cost log(ships) per asteroid.
+    void BuildShipBvh() {
+        const size_t ships = fleet.Size();
+        shipX.resize(ships);
+        shipY.resize(ships);
+        shipR.resize(ships);
+        for (size_t si = 0; si < ships; ++si) {
+            Vector2 spos = fleet.GetPosition(si);
+            shipX[si] = spos.x;
+            shipY[si] = spos.y;
+            shipR[si] = fleet.GetRadius(si);
+        }
+        shipBvh.Build(ships, shipX.data(), shipY.data(), shipR.data());
+    }
+
+    // BRUTE, KINETIC: the asteroids are walked for the ships they hit. Each asteroid records
+    // the lowest-indexed live ship it overlaps; the chunks run over blocks of 8 asteroids.
+    void DetectShipHits() {
+        PROFILE_SCOPE(COLLISION);
+        MEMORY_SCOPE(COLLISION);
+        BuildShipBvh();
+        if (shipBvh.Empty()) return;
+
+        // Most asteroids are nowhere near the fleet; the box test drops them 8 at a time.
+        float minX, minY, maxX, maxY;
+        shipBvh.Bounds(minX, minY, maxX, maxY);
+        const size_t blocks = (asteroids.Size() + 7) / 8;
+        const size_t pass = collisions.AddPass(blocks, C_JOB_BLOCKS);
+        JobSystem::Instance().ParallelFor(blocks, C_JOB_BLOCKS, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("ship collision chunk");
+            CollisionEvents::Buffer& out = collisions.Chunk(pass, begin, C_JOB_BLOCKS);
+            for (size_t b = begin; b < end; ++b) {
+                const size_t a0 = b * 8;
+                int block = static_cast<int>(asteroids.Size() - a0 < 8 ? asteroids.Size() - a0 : 8);
+                unsigned near = Simd::BoxOverlapMask(minX, minY, maxX, maxY,
+                    asteroids.X() + a0, asteroids.Y() + a0, asteroids.Radii() + a0, block);
+                for (; near; near &= near - 1) {
+                    size_t ai = a0 + std::countr_zero(near);
+                    if (asteroidDead[ai]) continue;
+                    int target = ShipHit(ai);
+                    if (target >= 0) out.push_back({ static_cast<uint32_t>(target), static_cast<uint32_t>(ai), CollisionEvent::Kind::SHIP_ASTEROID });
+                }
+            }
+        });
+    }
+
+    // Lowest-indexed live ship the asteroid overlaps, or -1. Needs this tick's shipBvh.
+    int ShipHit(size_t ai) const {
+        Vector2 apos = asteroids.GetPosition(ai);
+        float arad = asteroids.GetRadius(ai);
+        int target = -1;
+        shipBvh.Query(apos.x, apos.y, arad, [&](int si) {
+            if (target >= 0 && si > target) return;
+            if (lockstep) {
+                if (Fixed::Overlap(Fixed::FromFloat(apos.x), Fixed::FromFloat(apos.y), Fixed::FromFloat(shipX[si]), Fixed::FromFloat(shipY[si]),
+                        Fixed::FromFloat(shipR[si]) + Fixed::FromFloat(arad)) && fleet.IsAlive(static_cast<size_t>(si))) {
+                    target = si;
+                }
+                return;
+            }
+            float dx = shipX[si] - apos.x;
+            float dy = shipY[si] - apos.y;
+            float rs = shipR[si] + arad;
+            if (dx * dx + dy * dy < rs * rs && fleet.IsAlive(static_cast<size_t>(si))) target = si;
+        });
+        return target;
+    }
+
+    void ResolveShipHit(size_t si, size_t ai) {
+        fleet.TakeDamage(si, asteroids.GetDamage(ai));
+        asteroidDead[ai] = 1;
+        ReportExplosion(ai);
+        SoundEffects::Instance().Trigger(SoundEffects::Effect::EXPLOSION, 1, Pan(asteroids.GetPosition(ai)));
+    }
+
+    // Only while a window is drawing them; headless runs skip the bookkeeping.
+    void ReportExplosion(size_t ai) {
+        if (!reportExplosions) return;
+        const Vector2 at = Vector2Add(asteroids.GetPosition(ai), Origin());
+        explosions.push_back({ at, asteroids.GetVelocity(ai), asteroids.GetRadius(ai) });
+    }
+
+    // Shot asteroids break up once both collision passes are done, so fragments can't be hit
+    // again in the tick that created them.
+    void SplitAsteroids() {
+        PROFILE_SCOPE(COLLISION);
+        MEMORY_SCOPE(ASTEROIDS);
+        for (int ai : asteroidSplits) {
+            asteroids.Split(static_cast<size_t>(ai), asteroidDead);
+        }
+    }
+
+    // Spawning, splitting and compaction scatter neighbours across the fields over time, so
+    // every Scenario::spatialSort ticks both are put back in Morton order (SpatialOrder) and
+    // a grid query's run of indices reads a few nearby cache lines again. The broadphases
+    // follow the renumbering; the renderers and KineticCollider see every asteroid changed
+    // and a new projectile Layout(). KINETIC doesn't query by area and is left alone.
+    void SortSpatially() {
+        PROFILE_SCOPE(BROADPHASE);
+        MEMORY_SCOPE(COLLISION);
+        sinceSort = 0;
+        if (broadphase == Broadphase::KINETIC) return;
+        asteroids.SortSpatially(spatialSorter, bounds.width, bounds.height);
+        const std::vector<uint32_t>& order = spatialSorter.Order();
+        sortRenumber.resize(order.size());
+        for (size_t k = 0; k < order.size(); ++k) sortRenumber[order[k]] = static_cast<uint32_t>(k);
+        asteroidGrid.Invalidate();
+        asteroidSweep.Renumber(sortRenumber);
+        projectiles.SortSpatially(spatialSorter, bounds.width, bounds.height);
+    }
+
+    void IntegrateAsteroids(float dt) {
+        PROFILE_SCOPE(ASTEROIDS);
+        MEMORY_SCOPE(ASTEROIDS);
+        JobSystem::Instance().ParallelFor(asteroids.Size(), C_JOB_CHUNK, [&](size_t begin, size_t end) {
+            TRACE_SCOPE("asteroids chunk");
+            asteroids.Integrate(dt, begin, end);
+            if (!streaming) asteroids.MarkOutOfBounds(bounds, asteroidDead, begin, end);
+        });
+        if (streaming) {
+            MEMORY_SCOPE(SECTORS);
+            ParkLeavers();
+        }
+
+        projectiles.Reclaim();
+        asteroids.Compact(asteroidDead);
+    }
+
+    // Streaming: the region's size and the sector grid around it, or the playfield alone.
+    // Lockstep worlds don't stream; parked asteroids are stored rounded, in floats.
+    void ConfigureRegion() {
+        const bool wanted = scenario.worldWidth > 0 && scenario.worldHeight > 0;
+        if (wanted && lockstep) TraceLog(LOG_WARNING, "WORLD: lockstep worlds don't stream, the playfield is the world");
+        streaming = wanted && !lockstep;
+        const int n = streaming ? C_REGION_SECTORS : 1;
+        bounds = { static_cast<float>(scenario.width * n), static_cast<float>(scenario.height * n) };
+        {
+            MEMORY_SCOPE(COLLISION);
+            asteroidGrid = SpatialGrid(bounds.width, bounds.height, Asteroid::MAX_RADIUS);
+        }
+        if (streaming) {
+            const int cols = std::max((scenario.worldWidth + scenario.width - 1) / scenario.width, n);
+            const int rows = std::max((scenario.worldHeight + scenario.height - 1) / scenario.height, n);
+            sectors.Init(static_cast<float>(scenario.width), static_cast<float>(scenario.height), cols, rows);
+        }
+        else {
+            sectors.Init(1.f, 1.f, 0, 0);
+        }
+        region = CentredRegion();
+    }
+
+    // The region in the middle of the world.
+    SectorMap::Region CentredRegion() const {
+        if (!streaming) return {};
+        return { (sectors.Cols() - C_REGION_SECTORS) / 2, (sectors.Rows() - C_REGION_SECTORS) / 2, C_REGION_SECTORS, C_REGION_SECTORS };
+    }
+
+    // A parked asteroid arriving in the region; refused while the field has no room to
+    // split it in.
+    bool Unpark(const SectorMap::Body& b) {
+        if (asteroids.Size() * C_SPLIT_HEADROOM >= asteroids.Capacity()) return false;
+        const Vector2 origin = Origin();
+        return asteroids.Add({ b.x - origin.x, b.y - origin.y }, { b.vx, b.vy }, b.rotation, b.rotationSpeed,
+            static_cast<Renderable::Size>(b.size), static_cast<AsteroidShape>(b.shape));
+    }
+
+    void Park(size_t i) {
+        const Vector2 p = Vector2Add(asteroids.GetPosition(i), Origin());
+        const Vector2 v = asteroids.GetVelocity(i);
+        sectors.Park({ p.x, p.y, v.x, v.y, asteroids.GetRotation(i), asteroids.GetRotationSpeed(i),
+            static_cast<uint8_t>(asteroids.GetSize(i)), static_cast<uint8_t>(asteroids.GetShape(i)) });
+    }
+
+    // Asteroids that drifted fully out of the region go on in the sector map instead of
+    // dying, unless they left the world as well.
+    void ParkLeavers() {
+        const float* x = asteroids.X();
+        const float* y = asteroids.Y();
+        const float* r = asteroids.Radii();
+        for (size_t i = 0; i < asteroids.Size(); ++i) {
+            if (asteroidDead[i]) continue;
+            if (x[i] + r[i] >= 0.f && x[i] - r[i] <= bounds.width && y[i] + r[i] >= 0.f && y[i] - r[i] <= bounds.height) continue;
+            Park(i);
+            asteroidDead[i] = 1;
+        }
+    }
+
+    // Streaming, once a tick: the sector map's coarse update, the player held inside the
+    // world, and the region moved a sector along once the player is C_RECENTRE_MARGIN of a
+    // sector past the middle one. Moving parks the asteroids left behind, unparks the
+    // sectors coming in and shifts every position by the sector, so the player is back in
+    // the middle sector and the simulated coordinates stay small however big the world.
+    void Stream(float dt) {
+        PROFILE_SCOPE(SECTORS);
+        MEMORY_SCOPE(SECTORS);
+        const float w = static_cast<float>(scenario.width);
+        const float h = static_cast<float>(scenario.height);
+        sectors.Step(dt, region, [&](const SectorMap::Body& b) { return Unpark(b); });
+
+        const Vector2 origin = Origin();
+        fleet.Confine(-origin.x, -origin.y, static_cast<float>(sectors.Cols()) * w - origin.x, static_cast<float>(sectors.Rows()) * h - origin.y);
+        const Vector2 p = fleet.GetPosition(Fleet::C_PLAYER);
+        const float middle = static_cast<float>(C_REGION_SECTORS / 2);
+        int dx = 0, dy = 0;
+        if (p.x < w * (middle - C_RECENTRE_MARGIN) && region.col > 0) dx = -1;
+        else if (p.x >= w * (middle + 1.f + C_RECENTRE_MARGIN) && region.col + region.cols < sectors.Cols()) dx = 1;
+        if (p.y < h * (middle - C_RECENTRE_MARGIN) && region.row > 0) dy = -1;
+        else if (p.y >= h * (middle + 1.f + C_RECENTRE_MARGIN) && region.row + region.rows < sectors.Rows()) dy = 1;
+        if (dx == 0 && dy == 0) return;
+
+        const float sx = static_cast<float>(dx) * w;
+        const float sy = static_cast<float>(dy) * h;
+        asteroidDead.assign(asteroids.Size(), 0);
+        for (size_t i = 0; i < asteroids.Size(); ++i) {
+            const Vector2 q = asteroids.GetPosition(i);
+            if (q.x >= sx && q.x < sx + bounds.width && q.y >= sy && q.y < sy + bounds.height) continue;
+            Park(i);
+            asteroidDead[i] = 1;
+        }
+        asteroids.Compact(asteroidDead);
+        asteroids.Translate(-sx, -sy);
+        projectiles.Translate(-sx, -sy);
+        fleet.Translate(-sx, -sy);
+        kinetic.Invalidate();
+
+        const SectorMap::Region left = region;
+        region.col += dx;
+        region.row += dy;
+        for (int r = region.row; r < region.row + region.rows; ++r) {
+            for (int c = region.col; c < region.col + region.cols; ++c) {
+                if (!left.Contains(c, r)) sectors.Unpark(c, r, [&](const SectorMap::Body& b) { return Unpark(b); });
+            }
+        }
+    }
+
+    void SpawnOrbiters() {
+        PROFILE_SCOPE(ORBITERS);
+        MEMORY_SCOPE(SHIPS);
+        fleet.TrySpawnOrbiters(scenario.scoreThreshold);
+    }
+
+    // First live asteroid overlapping the projectile in the broadphase's visiting order, or
+    // -1. Stopping at the first overlap is what keeps dense fields cheap, so a projectile
+    // touching two asteroids can pick a different one under each broadphase.
+    // The projectile is swept over the segment it covered this tick, so a laser at a low
+    // tick rate still hits the small asteroids it passed through. Asteroids haven't moved
+    // yet and are tested where they stand.
+    int FirstHit(size_t pi, float dt) const {
+        if (lockstep) return FirstHitFixed(pi, dt);
+        int hit = -1;
+        Vector2 pend = projectiles.GetPosition(pi);
+        Vector2 pvel = projectiles.GetVelocity(pi);
+        Vector2 step = { pvel.x * dt, pvel.y * dt };
+        Vector2 pstart = { pend.x - step.x, pend.y - step.y };
+        Vector2 mid = { pend.x - step.x * 0.5f, pend.y - step.y * 0.5f };
+        float reach = 0.5f * sqrtf(step.x * step.x + step.y * step.y);
+        float prad = projectiles.GetRadius(pi);
+
+        auto test = [&](const int* run, int n) {
+            for (int k = 0; k < n; k += 8) {
+                int block = n - k < 8 ? n - k : 8;
+                unsigned mask = Simd::SweptOverlapMask(pstart.x, pstart.y, step.x, step.y, prad,
+                    asteroids.X(), asteroids.Y(), asteroids.Radii(), run + k, block);
+                for (; mask; mask &= mask - 1) {
+                    int ai = run[k + std::countr_zero(mask)];
+                    if (!asteroidDead[ai]) {
+                        hit = ai;
+                        return true;
+                    }
+                }
+            }
+            return false;
+        };
+
+        switch (broadphase) {
+        case Broadphase::GRID:
+        case Broadphase::INCREMENTAL:
+            asteroidGrid.QueryCells(mid, reach + prad + Asteroid::MAX_RADIUS, test);
+            break;
+        case Broadphase::SWEEP:
+            asteroidSweep.QueryCells(mid, reach + prad + Asteroid::MAX_RADIUS, test);
+            break;
+        default:
+            for (size_t a0 = 0; a0 < asteroids.Size() && hit < 0; a0 += 8) {
+                int block = static_cast<int>(asteroids.Size() - a0 < 8 ? asteroids.Size() - a0 : 8);
+                unsigned mask = Simd::SweptOverlapMask(pstart.x, pstart.y, step.x, step.y, prad,
+                    asteroids.X() + a0, asteroids.Y() + a0, asteroids.Radii() + a0, nullptr, block);
+                for (; mask; mask &= mask - 1) {
+                    int ai = static_cast<int>(a0) + std::countr_zero(mask);
+                    if (!asteroidDead[ai]) {
+                        hit = ai;
+                        break;
+                    }
+                }
+            }
+            break;
+        }
+        return hit;
+    }
+
+    // FirstHit for lockstep worlds: the sweep is tested in integers against every candidate
+    // and the lowest live index wins, so the result no longer depends on the order the
+    // broadphase visits them in. The queries only need to cover every hit, which the exact
+    // grid values make sure of.
+    int FirstHitFixed(size_t pi, float dt) const {
+        const int32_t dtq = Fixed::FromSeconds(dt);
+        const Vector2 pend = projectiles.GetPosition(pi);
+        const Vector2 pvel = projectiles.GetVelocity(pi);
+        const Fixed::Raw ex = Fixed::FromFloat(pend.x), ey = Fixed::FromFloat(pend.y);
+        const Fixed::Raw lx = Fixed::Distance(Fixed::FromFloat(pvel.x), dtq);
+        const Fixed::Raw ly = Fixed::Distance(Fixed::FromFloat(pvel.y), dtq);
+        const Fixed::Raw sx = ex - lx, sy = ey - ly;
+        const Fixed::Raw prad = Fixed::FromFloat(projectiles.GetRadius(pi));
+        const Vector2 mid = { Fixed::ToFloat(ex - lx / 2), Fixed::ToFloat(ey - ly / 2) };
+        const float reach = Fixed::ToFloat(Fixed::Length(lx, ly) / 2 + Fixed::C_ONE + prad + Fixed::FromFloat(Asteroid::MAX_RADIUS));
+
+        int hit = -1;
+        auto consider = [&](int ai) {
+            if ((hit >= 0 && ai >= hit) || asteroidDead[ai]) return;
+            const size_t a = static_cast<size_t>(ai);
+            if (Fixed::SweptOverlap(sx, sy, lx, ly, Fixed::FromFloat(asteroids.X()[a]), Fixed::FromFloat(asteroids.Y()[a]),
+                    Fixed::FromFloat(asteroids.Radii()[a]) + prad)) {
+                hit = ai;
+            }
+        };
+        auto test = [&](const int* run, int n) {
+            for (int k = 0; k < n; ++k) consider(run[k]);
+            return false;
+        };
+
+        switch (broadphase) {
+        case Broadphase::GRID:
+        case Broadphase::INCREMENTAL:
+            asteroidGrid.QueryCells(mid, reach, test);
+            break;
+        case Broadphase::SWEEP:
+            asteroidSweep.QueryCells(mid, reach, test);
+            break;
+        default:
+            for (size_t a = 0; a < asteroids.Size() && hit < 0; ++a) consider(static_cast<int>(a));
+            break;
+        }
+        return hit;
+    }
+
+    // Save's scalars, in the snapshot's one SavedState section.
+    struct SavedState {
+        Scenario      scenario;
+        Utils::Rng    rng;
+        Vector2       shipSpriteSize;
+        double        simClock;
+        uint64_t      wavePending;
+        int32_t       sinceSort;
+        float         spawnTimer;
+        float         spawnInterval;
+        float         waveTimer;
+        float         shotTimer;
+        WeaponType    weapon;
+        AsteroidShape shape;
+        bool          lockstep;
+    };
+    static constexpr uint32_t C_SNAPSHOT_TAG = WorldSnapshot::Tag("WRLD");
+
+    // Declared first: the members below are sized from it.
+    Scenario              scenario;
+    Utils::Rng            rng;
+
+    AsteroidField         asteroids;
+    ProjectileField       projectiles;
+
+    SpatialGrid           asteroidGrid;
+    SweepAndPrune         asteroidSweep;
+    SpatialOrder::Sorter  spatialSorter;
+    std::vector<uint32_t> sortRenumber;  // each asteroid's slot after SortSpatially
+    std::vector<char>     asteroidDead;
+    std::vector<int>      asteroidSplits;
+    FrameArena            tickArena{ C_TICK_ARENA_BYTES };  // the tick's scratch, reset as it starts
+    CollisionEvents       collisions{ &tickArena };
+    CircleBvh             shipBvh;
+    KineticCollider       kinetic;
+    std::vector<uint32_t> asteroidChanges;  // TakeChanges'
+    std::vector<uint32_t> kineticChanges;   // CollideKinetic's
+    std::vector<float>    shipX, shipY, shipR;
+
+    Fleet                 fleet;
+    Vector2               shipSpriteSize{};
+    WorldBounds           bounds{ static_cast<float>(scenario.width), static_cast<float>(scenario.height) };
+
+    bool              streaming = false;
+    SectorMap         sectors;
+    SectorMap::Region region{};
+
+    float         spawnTimer = 0.f;
+    float         spawnInterval = 0.f;
+    float         spawnRate = 1.f;
+    float         waveTimer = 0.f;
+    size_t        wavePending = 0;
+    float         shotTimer = 0.f;
+    WeaponType    currentWeapon = WeaponType::LASER;
+    AsteroidShape currentShape = AsteroidShape::TRIANGLE;
+    Broadphase    broadphase = Broadphase::GRID;
+    bool          lockstep = false;
+
+    bool                   reportExplosions = false;
+    std::vector<Explosion> explosions;
+    bool                   keepChanges = false;
+    double                 simClock = 0.0;
+    int                    sinceSort = 0;  // ticks since SortSpatially
+
+    // Fixed step, from the scenario's tick rate.
+    float tickDt = 1.f / static_cast<float>(scenario.tickRate);
+
+    static constexpr int C_MAX_ASTEROIDS = 1000;
+    static constexpr int C_MAX_PROJECTILES = 10'000;
+
+    // Smallest slice of entities handed to one worker; below this a loop stays serial.
+    static constexpr size_t C_JOB_CHUNK = 1024;
+    static constexpr size_t C_JOB_BLOCKS = C_JOB_CHUNK / 8;  // the same, in blocks of 8
+
+    // A large asteroid shatters into four small ones at most, so the pool is sized for the
+    // spawners' cap times this.
+    static constexpr size_t C_SPLIT_HEADROOM = 4;
+
+    // Most wave asteroids spawned in one tick.
+    static constexpr size_t C_WAVE_BUDGET = 512;
+
+    // Streaming: sectors per side of the simulated region, and how far into a neighbouring
+    // sector (as a share of one) the player goes before the region follows.
+    static constexpr int   C_REGION_SECTORS = 3;
+    static constexpr float C_RECENTRE_MARGIN = 0.25f;
+
+    // Starting size of the tick's arena; it grows to the busiest tick.
+    static constexpr size_t C_TICK_ARENA_BYTES = 64 * 1024;
+};
+
+// --- WORLD BATCH ---
+// Many independent games in one process, for balancing runs and training bots. World i
+// plays from stream i of the batch's seed, flown by an Autopilot of its own if asked, and
+// Run() hands the worlds to the job system whole: each one's ticks run start to finish
+// inside a single task, so the worlds share nothing but the pool and throughput grows with
+// the cores. A world's own loops still split over idle workers when they are big enough;
+// a typical game's stay under C_JOB_CHUNK and inside its task. Phase timings are muted
+// while it runs (ProfileMute), or every world would queue on the profiler's mutex.
+class WorldBatch {
+public:
+    struct Stats {
+        size_t worlds;
+        int    ticks;    // per world
+        double seconds;
+        size_t ships;    // over every world
+        int    minScore;
+        int    maxScore;
+        double meanScore;
+    };
+
+    // `count` worlds of the scenario. World 0 plays exactly as a single session from `seed`.
+    // With `start` every world begins as that snapshot instead, in its scenario and mode;
+    // world 0 keeps its generator, so it plays on as the saved session would, and world i
+    // draws from stream i of `seed`. Returns false when the snapshot doesn't load.
+    bool Init(const Scenario& s, size_t count, uint64_t seed, Broadphase b, bool autopilot, bool lockstep = false,
+        const WorldSnapshot::Reader* start = nullptr) {
+        Image img = LoadImage("spaceship1.png");
+        const Vector2 sprite = { static_cast<float>(img.width), static_cast<float>(img.height) };
+        UnloadImage(img);
+
+        flown = autopilot;
+        slots.clear();
+        slots.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            Slot& slot = *slots.emplace_back(std::make_unique<Slot>());
+            slot.world.Configure(s);
+            slot.world.SetSpriteSize(sprite);
+            slot.world.SetLockstep(lockstep);
+            slot.world.SetBroadphase(b);
+            if (!start) {
+                slot.world.Start(seed, i);
+            }
+            else if (!slot.world.Load(*start)) {
+                return false;
+            }
+            else if (i > 0) {
+                slot.world.Seed(seed, i);
+            }
+            slot.pilot.Reset();
+        }
+        return true;
+    }
+
+    // Steps every world `ticks` ticks, one frame of one tick at a time as RunHeadless does.
+    Stats Run(int ticks) {
+        auto start = std::chrono::steady_clock::now();
+        JobSystem::Instance().ParallelFor(slots.size(), 1, [&](size_t begin, size_t end) {
+            ProfileMute mute;
+            for (size_t w = begin; w < end; ++w) {
+                TRACE_SCOPE("world");
+                Slot& slot = *slots[w];
+                for (int t = 0; t < ticks; ++t) {
+                    FrameInput in{ 1, 0, 0 };
+                    if (flown) in = slot.world.Fly(slot.pilot, 1);
+                    slot.world.Step(in);
+                }
+            }
+        });
+
+        Stats stats{ slots.size(), ticks, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 0, 0, 0, 0.0 };
+        for (size_t w = 0; w < slots.size(); ++w) {
+            const World& world = slots[w]->world;
+            const int score = world.Score();
+            stats.ships += world.GetFleet().Size();
+            stats.minScore = w == 0 || score < stats.minScore ? score : stats.minScore;
+            stats.maxScore = w == 0 || score > stats.maxScore ? score : stats.maxScore;
+            stats.meanScore += static_cast<double>(score) / static_cast<double>(slots.size());
+        }
+        return stats;
+    }
+
+    const World& Get(size_t i) const {
+        return slots[i]->world;
+    }
+
+    size_t Size() const {
+        return slots.size();
+    }
+
+private:
+    struct Slot {
+        World     world;
+        Autopilot pilot;
+    };
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    bool                               flown = false;
+};
+
+// --- REPLICATION SOURCE ---
+// Feeds a Replication::Server from a World, one packet per frame. Asteroid courses come
+// from the world's change log (World::KeepChanges); projectiles have none, so the window
+// is compared against the last frame's: slots past its old end are new shots, a
+// tombstone not seen before is a kill (hit or out of bounds), and a new Layout() means
+// every slot was renumbered. Asteroid kinds are the size's bit index plus, in the upper
+// two bits, sides - 3; a projectile's kind is its weapon.
+class ReplicationSource {
+public:
+    explicit ReplicationSource(World& w)
+        : world(w), server(w.Bounds().width, w.Bounds().height)
+    {
+        world.KeepChanges(true);
+    }
+
+    ReplicationSource(const ReplicationSource&) = delete;
+    ReplicationSource& operator=(const ReplicationSource&) = delete;
+
+    // After each World::Step, with the ticks it ran.
+    void Capture(int ticks) {
+        ++sequence;
+        clock += static_cast<uint32_t>(ticks);
+        const Fleet& fleet = world.GetFleet();
+        ships.resize(fleet.Size());
+        for (size_t i = 0; i < fleet.Size(); ++i) {
+            const Vector2 p = fleet.GetPosition(i);
+            ships[i] = { p.x, p.y, fleet.GetRotation(i), fleet.GetHP(i), fleet.GetScore(i), fleet.IsAlive(i) };
+        }
+        server.Begin(sequence, clock, ships.data(), ships.size());
+
+        const AsteroidField& asteroids = world.Asteroids();
+        Replication::Stream& rocks = server.Asteroids();
+        rocks.SetWindow(0, asteroids.Size());
+        for (uint32_t slot : world.TakeChanges()) {
+            if (slot < asteroids.Size()) rocks.Touch(slot, sequence);
+        }
+        world.ClearChanges();
+
+        const ProjectileField& projectiles = world.Projectiles();
+        Replication::Stream& shots = server.Projectiles();
+        shots.SetWindow(projectiles.Begin(), projectiles.End());
+        if (killed.size() < projectiles.End()) killed.resize(projectiles.End(), 0);
+        if (projectiles.Layout() != layout) {
+            layout = projectiles.Layout();
+            shots.TouchWindow(sequence);
+            for (size_t s = projectiles.Begin(); s < projectiles.End(); ++s) killed[s] = projectiles.IsDead(s);
+        }
+        else {
+            const size_t known = std::clamp(seenEnd, projectiles.Begin(), projectiles.End());
+            for (size_t s = projectiles.Begin(); s < known; ++s) {
+                if (!projectiles.IsDead(s) || killed[s]) continue;
+                killed[s] = 1;
+                shots.Touch(s, sequence);
+            }
+            for (size_t s = known; s < projectiles.End(); ++s) {
+                killed[s] = projectiles.IsDead(s);
+                shots.Touch(s, sequence);
+            }
+        }
+        seenEnd = projectiles.End();
+    }
+
+    // The packet for a receiver that last acknowledged `ack`.
+    const std::vector<uint8_t>& Encode(uint32_t ack) {
+        const AsteroidField& asteroids = world.Asteroids();
+        const ProjectileField& projectiles = world.Projectiles();
+        return server.Encode(ack,
+            [&](size_t i, Replication::Body& b) {
+                const Vector2 p = asteroids.GetPosition(i);
+                const Vector2 v = asteroids.GetVelocity(i);
+                const int kind = std::countr_zero(static_cast<unsigned>(asteroids.GetSize(i))) | (asteroids.GetSides(i) - 3) << 2;
+                b = { p.x, p.y, v.x, v.y, asteroids.GetRotation(i), asteroids.GetRotationSpeed(i), static_cast<uint8_t>(kind) };
+                return true;
+            },
+            [&](size_t i, Replication::Body& b) {
+                if (projectiles.IsDead(i)) return false;
+                const Vector2 p = projectiles.GetPosition(i);
+                const Vector2 v = projectiles.GetVelocity(i);
+                b = { p.x, p.y, v.x, v.y, 0.f, 0.f, static_cast<uint8_t>(projectiles.GetType(i)) };
+                return true;
+            });
+    }
+
+    uint32_t Sequence() const { return sequence; }
+    uint32_t Clock() const { return clock; }
+
+private:
+    World&                         world;
+    Replication::Server            server;
+    std::vector<Replication::Ship> ships;
+    std::vector<char>              killed;  // per projectile slot: its tombstone was sent
+    uint32_t                       sequence = Replication::C_NONE;
+    uint32_t                       clock = 0;
+    uint32_t                       layout = ~0u;
+    size_t                         seenEnd = 0;
+};
+
+// --- REPLICATION LOOPBACK ---
+// A spectator on a simulated link, for `--replicate` replays: every frame's packet reaches
+// the Client C_LINK_DELAY frames later unless it is one of the C_LINK_LOSS in 100 dropped,
+// and acknowledgements take as long to come back, so the server always encodes against a
+// stale ack. Finish() lets the link drain, then measures how far the replica's
+// extrapolated bodies and ships are from the world.
+class ReplicationLoopback {
+public:
+    struct Stats {
+        uint64_t packets;
+        uint64_t bytes;
+        uint64_t fullBytes;        // the same frames sent as whole float snapshots
+        int      rejected;
+        float    asteroidError;    // px, worst over every live slot
+        float    projectileError;
+        float    shipError;
+        size_t   missing;          // live slots or ships the replica has dead, or the other way round
+    };
+
+    explicit ReplicationLoopback(World& w)
+        : world(w), source(w), client(w.Bounds().width, w.Bounds().height, w.TickDt())
+    {
+    }
+
+    // After each World::Step.
+    void Step(int ticks) {
+        source.Capture(ticks);
+        ++frame;
+        const size_t asteroidBytes = sizeof(float) * 6 + 1;
+        const size_t projectileBytes = sizeof(float) * 4 + 1;
+        stats.fullBytes += world.Asteroids().Size() * asteroidBytes + world.Projectiles().Size() * projectileBytes
+            + world.GetFleet().Size() * sizeof(Replication::Ship);
+        const std::vector<uint8_t>& packet = Send(frame % 100 >= C_LINK_LOSS);
+        ++stats.packets;
+        stats.bytes += packet.size();
+    }
+
+    // Runs the link with no loss and no new ticks until the client has the latest frame.
+    Stats Finish() {
+        for (int k = 0; k < 4 * C_LINK_DELAY && client.Ack() != source.Sequence(); ++k) {
+            ++frame;
+            Send(true);
+        }
+        Measure();
+        return stats;
+    }
+
+private:
+    static constexpr int C_LINK_DELAY = 6;  // frames each way
+    static constexpr int C_LINK_LOSS = 10;  // percent
+
+    struct Packet {
+        uint64_t             due;
+        std::vector<uint8_t> bytes;
+    };
+
+    struct Ack {
+        uint64_t due;
+        uint32_t value;
+    };
+
+    // One frame of the link: the acks due reach the server, it encodes against the newest,
+    // and the packets due reach the client.
+    const std::vector<uint8_t>& Send(bool delivered) {
+        while (!acks.empty() && acks.front().due <= frame) {
+            serverAck = std::max(serverAck, acks.front().value);
+            acks.erase(acks.begin());
+        }
+        const std::vector<uint8_t>& packet = source.Encode(serverAck);
+        if (delivered) inFlight.push_back({ frame + C_LINK_DELAY, packet });
+        while (!inFlight.empty() && inFlight.front().due <= frame) {
+            const Packet& p = inFlight.front();
+            if (!client.Apply(p.bytes.data(), p.bytes.size())) ++stats.rejected;
+            acks.push_back({ frame + C_LINK_DELAY, client.Ack() });
+            inFlight.erase(inFlight.begin());
+        }
+        return packet;
+    }
+
+    void Measure() {
+        const uint32_t now = source.Clock();
+        Replication::Body b;
+        const AsteroidField& asteroids = world.Asteroids();
+        for (size_t i = 0; i < asteroids.Size(); ++i) {
+            if (!client.Asteroid(i, now, b)) {
+                ++stats.missing;
+                continue;
+            }
+            stats.asteroidError = std::max(stats.asteroidError, Vector2Distance({ b.x, b.y }, asteroids.GetPosition(i)));
+        }
+        const ProjectileField& projectiles = world.Projectiles();
+        for (size_t i = projectiles.Begin(); i < projectiles.End(); ++i) {
+            const bool live = client.Projectile(i, now, b);
+            if (live != !projectiles.IsDead(i)) ++stats.missing;
+            if (live && !projectiles.IsDead(i)) {
+                stats.projectileError = std::max(stats.projectileError, Vector2Distance({ b.x, b.y }, projectiles.GetPosition(i)));
+            }
+        }
+        const Fleet& fleet = world.GetFleet();
+        if (client.ShipCount() != fleet.Size()) stats.missing += fleet.Size();
+        for (size_t i = 0; i < std::min(client.ShipCount(), fleet.Size()); ++i) {
+            const Replication::Ship s = client.GetShip(i);
+            if (s.alive != fleet.IsAlive(i)) ++stats.missing;
+            stats.shipError = std::max(stats.shipError, Vector2Distance({ s.x, s.y }, fleet.GetPosition(i)));
+        }
+    }
+
+    World&              world;
+    ReplicationSource   source;
+    Replication::Client client;
+    std::vector<Packet> inFlight;
+    std::vector<Ack>    acks;
+    uint32_t            serverAck = Replication::C_NONE;
+    uint64_t            frame = 0;
+    Stats               stats{};
+};
+
+// --- APPLICATION ---
+class Application {
+public:
+    static Application& Instance() {
+        static Application inst;
+        return inst;
+    }
+
+    // Plays interactively. With `playback` the recorded frames drive the session instead of
+    // the keyboard and the window closes when they run out; with `record` every frame's
+    // input is appended to it, along with the seed the session started from.
+    //
+    // This thread owns the window: it samples input, queues one FrameInput per frame for
+    // the simulation thread (SimulationLoop) and draws the newest snapshot the simulation
+    // has published. GPU submission and the next frame's ticks overlap, at the price of
+    // showing the world one frame behind the input. The queue holds at most
+    // C_MAX_QUEUED_FRAMES, so a slow simulation holds the window back instead of drifting.
+    // Each frame also passes on how far the clock has run into the next tick, and the
+    // snapshot is drawn blended that far from the previous tick, which lets the scenario's
+    // tick rate drop well below the display rate without visible stepping.
+    // With the autopilot on (SetAutopilot) it flies instead of the keyboard, and `record`
+    // gets its input.
+    void Run(const Replay* playback = nullptr, Replay* record = nullptr) {
+        uint64_t seed = playback ? playback->seed : static_cast<uint64_t>(time(nullptr));
+        if (playback || record) restored = false;  // a recording only replays from its seed
+        if (playback) {
+            world.SetLockstep(playback->lockstep);
+            world.SetSpatialSort(playback->spatialSort);
+        }
+        if (record) {
+            record->seed = seed;
+            record->lockstep = world.Lockstep();
+            record->spatialSort = world.SpatialSort();
+            record->frames.clear();
+        }
+        // The sprite decodes and the audio device opens (synthesising the effects) on the
+        // loader's workers while the window, the GL context and the GPU resources below are
+        // created; with SetSerialInit they run one after another on this thread instead, to
+        // compare. The sprite's pixels only live in the atlas; the fleet only needs its size,
+        // as in headless mode.
+        Image shipImage{};
+        auto decodeShip = [&shipImage] {
+            STARTUP_SCOPE("sprite decode");
+            MEMORY_SCOPE(TEXTURES);
+            shipImage = AssetCache::LoadImageData("spaceship1.png");
+            return shipImage.data != nullptr;
+        };
+        auto openAudio = [] {
+            STARTUP_SCOPE("audio");
+            MEMORY_SCOPE(AUDIO);
+            SoundEffects::Instance().Init();
+            return true;
+        };
+        AsyncLoader loader;
+        if (!serialInit) {
+            loader.Start(C_INIT_THREADS);
+            loader.Run(decodeShip, [](bool) {});
+            loader.Run(openAudio, [](bool) {});
+        }
+        const Scenario& scenario = world.GetScenario();
+        {
+            STARTUP_SCOPE("window");
+            Renderer::Instance().Init(scenario.width, scenario.height, "Asteroids OOP");
+        }
+
+        {
+            STARTUP_SCOPE("batches");
+            MEMORY_SCOPE(MESHES);
+            asteroidBatch.Init();
+            projectileBatch.Init();
+            asteroidMotion.Init();
+            orbiterBatch.Init();
+        }
+        {
+            STARTUP_SCOPE("particles");
+            MEMORY_SCOPE(PARTICLES);
+            particles.Init();
+        }
+        {
+            STARTUP_SCOPE("hud");
+            MEMORY_SCOPE(TEXTURES);
+            hud.Init();
+        }
+        {
+            STARTUP_SCOPE("render targets");
+            MEMORY_SCOPE(RENDER);
+            resolution.Init(scenario.width, scenario.height, 1.f / static_cast<float>(Renderer::C_TARGET_FPS));
+            governor.Init(1.f / static_cast<float>(Renderer::C_TARGET_FPS), !playback && !record);
+            post.Init(scenario.width, scenario.height);
+            GpuProfiler::Instance().Init();
+            Screenshots::Instance().Init();
+            GifRecorder::Instance().Init();
+        }
+        if (serialInit) {
+            decodeShip();
+            openAudio();
+        }
+        {
+            STARTUP_SCOPE("loader wait");
+            loader.Finish();
+            loader.Stop();
+        }
+        {
+            STARTUP_SCOPE("atlas");
+            MEMORY_SCOPE(TEXTURES);
+            if (!shipImage.data) TraceLog(LOG_WARNING, "ASSETS: spaceship1.png failed to load");
+            atlas.Build(shipImage);
+            world.SetSpriteSize({ static_cast<float>(shipImage.width), static_cast<float>(shipImage.height) });
+            UnloadImage(shipImage);
+        }
+        if (musicPath) {
+            STARTUP_SCOPE("music");
+            MEMORY_SCOPE(AUDIO);
+            MusicStream::Instance().Play(musicPath);
+        }
+
+        inbox.Reset();
+        world.ReportExplosions(particles.IsReady());
+        analyticAsteroids = !streamAsteroids && asteroidMotion.IsReady();
+        world.KeepChanges(analyticAsteroids);
+        instancedShips = orbiterBatch.IsReady() && atlas.IsReady();
+        orbitLayout = UINT64_MAX;
+        Govern();
+        std::thread simulation([this, seed, record] { SimulationLoop(seed, autopilotOn ? record : nullptr); });
+
+        const float tickDt = world.TickDt();
+        float accumulator = 0.f;
+        size_t frame = 0;
+        input.Reset(GetTime());
+
+        while (!WindowShouldClose()) {
+            Profiler::Instance().BeginFrame();
+            MemoryTracker::Instance().BeginFrame();
+
+            // What EndDrawing's poll brought in.
+            const double now = GetTime();
+            input.Observe(now);
+            QueuedFrame queued;
+            if (playback) {
+                if (frame >= playback->frames.size()) break;
+                queued.inputs[0] = playback->frames[frame];
+                queued.count = 1;
+                input.Discard();
+            }
+            else {
+                // The simulation only ever advances in tickDt steps. A long frame is clamped
+                // so a hitch costs at most C_MAX_TICKS_PER_FRAME ticks instead of one huge dt.
+                int ticks = 0;
+                accumulator += fminf(GetFrameTime(), tickDt * C_MAX_TICKS_PER_FRAME);
+                while (accumulator >= tickDt && ticks < C_MAX_TICKS_PER_FRAME) {
+                    accumulator -= tickDt;
+                    ++ticks;
+                }
+                queued.count = input.Slice(now - accumulator, ticks, tickDt, queued.inputs.data());
+            }
+            // A recording only has whole ticks, so playback shows each tick as it landed.
+            queued.alpha = playback ? 1.f : fminf(accumulator / tickDt, 1.f);
+            // The autopilot's input is only known on the simulation thread, which records it.
+            if (record && !autopilotOn) record->frames.insert(record->frames.end(), queued.inputs.begin(), queued.inputs.begin() + queued.count);
+            ++frame;
+
+            const uint32_t app = input.TakeAppPressed();
+            if (app & InputTimeline::APP_PROFILER) showProfiler = !showProfiler;
+            if (app & InputTimeline::APP_CAPTURE) {
+                if (IsKeyDown(KEY_LEFT_CONTROL)) GifRecorder::Instance().Toggle();
+                else Screenshots::Instance().Request();
+            }
+            if ((app & InputTimeline::APP_BROADPHASE) && !playback && !record) {
+                int next = (static_cast<int>(snapshots.Front().broadphase) + 1) % static_cast<int>(Broadphase::COUNT);
+                pendingBroadphase.store(next, std::memory_order_relaxed);
+            }
+            inbox.Push(queued);
+
+            snapshots.Acquire();
+            Draw(snapshots.Front());
+            if (frame == 1) StartupProfile::Instance().FirstFrame();
+            if (governed && governor.Update(simMs.load(std::memory_order_relaxed), drawMs, GpuProfiler::Instance().TotalMs())) {
+                Govern();
+            }
+            SoundEffects::Instance().Update();
+            FrameTimes::Instance().Record(FrameTimes::Series::CPU_FRAME, Profiler::Instance().EndFrame());
+            if (Telemetry::Stream::IsOpen()) PublishFrame(frame, queued.Ticks());
+        }
+        // Frames still queued are stepped before the thread exits, so a recording matches
+        // the simulation that ran.
+        inbox.Close();
+        simulation.join();
+        tickTelemetry.Flush();
+        frameTelemetry.Flush();
+        world.ReportExplosions(false);
+        analyticAsteroids = false;
+        world.KeepChanges(false);
+        instancedShips = false;
+
+        asteroidBatch.Unload();
+        projectileBatch.Unload();
+        particles.Unload();
+        asteroidMotion.Unload();
+        orbiterBatch.Unload();
+        hud.Unload();
+        resolution.Unload();
+        post.Unload();
+        GpuProfiler::Instance().Unload();
+        Screenshots::Instance().Unload();
+        GifRecorder::Instance().Unload();
+        MusicStream::Instance().Stop();
+        SoundEffects::Instance().Unload();
+        atlas.Unload();
+    }
+
+    // A window of `asteroids` and `projectiles` stepped, hit-tested and drawn on the GPU
+    // (GpuSwarm) instead of by the world, which the game's own counts never come near. Only
+    // the hits come back, to set off particles. The mouse wheel zooms about the cursor. False
+    // when the build or the driver has no compute shaders.
+    bool RunGpuSwarm(uint32_t asteroids, uint32_t projectiles) {
+        const Scenario& scenario = world.GetScenario();
+        Renderer::Instance().Init(scenario.width, scenario.height, "Asteroids OOP - GPU swarm");
+        GpuSwarm swarm;
+        if (!swarm.Init(asteroids, projectiles)) {
+            swarm.Unload();
+            CloseWindow();
+            return false;
+        }
+        particles.Init();
+        particles.SetBudget(1.f, true);
+
+        const float w = static_cast<float>(scenario.width);
+        const float h = static_cast<float>(scenario.height);
+        const float fit = fminf(w, h) / swarm.Extent();
+        Camera2D camera = { { w * 0.5f, h * 0.5f }, { swarm.Extent() * 0.5f, swarm.Extent() * 0.5f }, 0.f, fit };
+        std::vector<Explosion> explosions;
+        while (!WindowShouldClose()) {
+            Profiler::Instance().BeginFrame();
+            const float wheel = GetMouseWheelMove();
+            if (wheel != 0.f) {
+                const Vector2 mouse = GetMousePosition();
+                camera.target = GetScreenToWorld2D(mouse, camera);
+                camera.offset = mouse;
+                camera.zoom = Clamp(camera.zoom * powf(C_SWARM_ZOOM_STEP, wheel), fit, C_SWARM_MAX_ZOOM);
+            }
+
+            swarm.Step(fminf(GetFrameTime(), C_SWARM_MAX_DT));
+            explosions.clear();
+            for (const GpuSwarm::Hit& hit : swarm.Hits()) explosions.push_back({ hit.position, hit.velocity, hit.radius });
+            particles.Explode(explosions);
+
+            Renderer::Instance().Begin();
+            BeginMode2D(camera);
+            swarm.Draw(camera.zoom, LIGHTGRAY, RED);
+            particles.Draw();
+            EndMode2D();
+            DrawText(TextFormat("GPU SWARM  %u asteroids  %u projectiles  %d fps  %zu hits", swarm.Asteroids(), swarm.Projectiles(),
+                GetFPS(), swarm.Hits().size()), 10, 10, 10, WHITE);
+            Renderer::Instance().End();
+            FrameTimes::Instance().Record(FrameTimes::Series::CPU_FRAME, Profiler::Instance().EndFrame());
+        }
+
+        const GpuSwarm::Stats& stats = swarm.GetStats();
+        TraceLog(LOG_INFO, "SWARM: %llu steps, %llu hits read back, %llu past the per-step limit",
+            static_cast<unsigned long long>(stats.steps), static_cast<unsigned long long>(stats.hits - stats.dropped),
+            static_cast<unsigned long long>(stats.dropped));
+        particles.Unload();
+        swarm.Unload();
+        return true;
+    }
+
+    struct HeadlessStats {
+        int    ticks;
+        double seconds;
+        size_t asteroids;
+        size_t projectiles;
+        size_t ships;
+        int    score;
+    };
+
+    // Sets the simulation up without a window or GL context. Only the sprite's size is
+    // needed (it defines the ship radius), so the image is read on the CPU and never uploaded.
+    void InitHeadless() {
+        Image img = LoadImage("spaceship1.png");
+        world.SetSpriteSize({ static_cast<float>(img.width), static_cast<float>(img.height) });
+        UnloadImage(img);
+        if (!restored) world.Reset();
+    }
+
+    // Resizes the world for a scenario. Call before Run/InitHeadless.
+    void Configure(const Scenario& s) {
+        world.Configure(s);
+    }
+
+    // World::SetLockstep. Replays play in the mode they were recorded in. Before
+    // Run/InitHeadless.
+    void SetLockstep(bool on) {
+        world.SetLockstep(on);
+    }
+
+    // Seeds the world's generator for the headless runs; Run and replays seed their own.
+    void Seed(uint64_t seed) {
+        world.Seed(seed);
+    }
+
+    void ResetWorld() {
+        world.Reset();
+    }
+
+    // Starts Run and RunHeadless from a World::Save snapshot instead of a fresh world, in
+    // the snapshot's scenario and mode. After Configure and SetLockstep, before
+    // Run/InitHeadless; replays always start from their seed.
+    bool LoadWorld(const WorldSnapshot::Reader& in) {
+        restored = world.Load(in);
+        return restored;
+    }
+
+    const World& GetWorld() const {
+        return world;
+    }
+
+    // Steps the simulation `ticks` times at tickDt. Before every tick the populations are
+    // topped back up to the requested counts with entities scattered over the playfield;
+    // only Tick itself is timed. With the autopilot on, each tick is a frame it flies
+    // (its input handling is timed with the tick); otherwise nothing is pressed.
+    HeadlessStats RunHeadless(int ticks, size_t asteroidCount, size_t projectileCount) {
+        world.Reserve(asteroidCount, projectileCount);
+
+        HeadlessStats stats{ ticks, 0.0, 0, 0, 0, 0 };
+        autopilot.Reset();
+        for (int t = 0; t < ticks; ++t) {
+            world.Populate(asteroidCount, projectileCount);
+            FrameInput in{ 1, 0, 0 };
+            if (autopilotOn) in = world.Fly(autopilot, 1);
+            Profiler::Instance().BeginFrame();
+            MemoryTracker::Instance().BeginFrame();
+            auto start = std::chrono::steady_clock::now();
+            if (autopilotOn) world.HandleFrameInput(in.pressed);
+            world.Tick(world.TickDt(), in.held);
+            stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            TraceCounts();
+            TraceHeap();
+            Profiler::Instance().EndFrame();
+        }
+        stats.asteroids = world.Asteroids().Size();
+        stats.projectiles = world.Projectiles().Size();
+        stats.ships = world.GetFleet().Size();
+        stats.score = Score();
+        return stats;
+    }
+
+    // Plays headless for `seconds` of wall clock as RunHeadless does, holding the counts as
+    // a floor: before every tick the asteroids the field lacks are queued as a wave (from
+    // the edges, not scattered onto the ship) and projectiles are scattered as RunHeadless
+    // scatters them. The spawner and waves still add on top, and whatever the session
+    // accumulates above the floor stays. Every tick's time goes to `soak`, and it samples
+    // the world whenever its interval is up. Returns the ticks run.
+    uint64_t RunSoak(SoakMonitor& soak, double seconds, size_t asteroidCount, size_t projectileCount) {
+        world.Reserve(asteroidCount, projectileCount);
+
+        uint64_t ticks = 0;
+        autopilot.Reset();
+        while (soak.Elapsed() < seconds) {
+            world.QueueShortfall(asteroidCount);
+            world.Populate(0, projectileCount);
+            FrameInput in{ 1, 0, 0 };
+            if (autopilotOn) in = world.Fly(autopilot, 1);
+            Profiler::Instance().BeginFrame();
+            MemoryTracker::Instance().BeginFrame();
+            const MemoryTracker& memory = MemoryTracker::Instance();
+            const uint64_t allocations = memory.Allocations();
+            const uint64_t allocatedBytes = memory.AllocatedBytes();
+            auto start = std::chrono::steady_clock::now();
+            if (autopilotOn) world.HandleFrameInput(in.pressed);
+            world.Tick(world.TickDt(), in.held);
+            soak.RecordTick(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            if (Telemetry::Stream::IsOpen()) PublishTick(start, 1, allocations, allocatedBytes);
+            Profiler::Instance().EndFrame();
+            ++ticks;
+            if (soak.Due()) {
+                soak.TakeSample({ world.Asteroids().Size(), world.Streaming() ? world.Sectors().Size() : 0,
+                    world.Projectiles().Size(), world.GetFleet().Size(), Score() });
+            }
+        }
+        tickTelemetry.Flush();
+        return ticks;
+    }
+
+    struct ReplayStats {
+        size_t frames;
+        int    ticks;
+        double seconds;
+        double frameP50;
+        double frameP95;
+        double frameP99;
+        double frameMax;
+    };
+
+    // Replays a recording with no window as fast as the simulation allows. Each frame's
+    // input and tick count are applied exactly as in Run(); only HandleFrameInput and the
+    // ticks are timed, so `frame*` is the per-frame simulation cost in ms. Those times are
+    // FrameTimes' CPU frames, which starts the replay empty.
+    ReplayStats RunReplayHeadless(const Replay& replay) {
+        restored = false;
+        world.SetLockstep(replay.lockstep);
+        world.SetSpatialSort(replay.spatialSort);
+        world.Start(replay.seed);
+        FrameTimes::Instance().Reset();
+        std::unique_ptr<ReplicationLoopback> link;
+        if (replicate) link = std::make_unique<ReplicationLoopback>(world);
+
+        ReplayStats stats{ replay.frames.size(), 0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        for (const FrameInput& in : replay.frames) {
+            Profiler::Instance().BeginFrame();
+            MemoryTracker::Instance().BeginFrame();
+            auto start = std::chrono::steady_clock::now();
+            world.Step(in);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            if (link) link->Step(in.ticks);
+            TraceCounts();
+            TraceHeap();
+            Profiler::Instance().EndFrame();
+
+            FrameTimes::Instance().Record(FrameTimes::Series::CPU_FRAME, ms);
+            stats.seconds += ms * 1e-3;
+            stats.ticks += in.ticks;
+        }
+        if (link) replication = link->Finish();
+
+        const FrameTimes::Summary frames = FrameTimes::Instance().Get(FrameTimes::Series::CPU_FRAME);
+        stats.frameP50 = frames.p50;
+        stats.frameP95 = frames.p95;
+        stats.frameP99 = frames.p99;
+        stats.frameMax = frames.max;
+        return stats;
+    }
+
+    // Headless replays also stream the session to a ReplicationLoopback spectator;
+    // ReplicationResult() has its packet stats once the replay is over.
+    void SetReplicate(bool on) {
+        replicate = on;
+    }
+
+    const ReplicationLoopback::Stats& ReplicationResult() const {
+        return replication;
+    }
+
+    // Hands the player's controls to the Autopilot, in a window or headless. Replays play
+    // their recorded input regardless.
+    void SetAutopilot(bool on) {
+        autopilotOn = on;
+    }
+
+    // F4 cycles it in a window, except while recording or playing back.
+    void SetBroadphase(Broadphase b) {
+        world.SetBroadphase(b);
+    }
+
+    // By default a window draws asteroids analytically (AsteroidMotionBatch) when its shader
+    // loads; streaming copies every position into each snapshot instead.
+    void SetStreamAsteroids(bool on) {
+        streamAsteroids = on;
+    }
+
+    // The FrameGovernor holds the windowed frame rate by shedding effects, detail and, outside
+    // replays, spawns; off keeps the full load, for comparable frame-time runs.
+    void SetGovernor(bool on) {
+        governed = on;
+    }
+
+    // A .qoa track streamed in the background of the windowed game (MusicStream).
+    void SetMusic(const char* path) {
+        musicPath = path;
+    }
+
+    // Run's startup work one step after another on the main thread, for measuring what the
+    // overlapped path saves.
+    void SetSerialInit(bool on) {
+        serialInit = on;
+    }
+
+    // PostStack::Effect bits for the windowed renderer.
+    void SetPostEffects(uint32_t effects) {
+        post.SetEffects(effects);
+    }
+
+    // Fingerprint of the simulation state, for checking that a replay matched its recording.
+    int Score() const {
+        return world.Score();
+    }
+
+    uint64_t Checksum() const {
+        return world.Checksum();
+    }
+
+private:
+    struct RenderSnapshot {
+        AsteroidSnapshot   asteroids;
+        ProjectileSnapshot projectiles;
+        ShipSnapshot       ships;
+        int                hp = 0;
+        int                score = 0;
+        WeaponType         weapon = WeaponType::LASER;
+        Broadphase         broadphase = Broadphase::GRID;
+        float              alpha = 1.f;  // how far the display is from the previous tick
+        uint64_t           frame = 0;    // simulation frames stepped so far
+        float              simTime = 0.f;
+        size_t             asteroidCount = 0;
+        bool               streaming = false;  // the camera follows the player (World::Streaming)
+        Vector2            origin{};           // World::Origin
+        SectorMap::Region  region{};
+        size_t             parked = 0;
+        size_t             sectors = 0;
+        size_t             sectorBytes = 0;
+        std::vector<OrbiterBatch::Orbit> orbits;  // copied only when orbitVersion moves on
+        uint64_t           orbitVersion = 0;
+        float              orbitEpoch = 0.f;      // simTime the orbits were taken at
+    };
+
+    static constexpr int C_MAX_TICKS_PER_FRAME = 8;
+
+    // One frame's input, cut where it changed (InputTimeline::Slice), plus the render
+    // thread's tick fraction at the time it was sampled.
+    struct QueuedFrame {
+        std::array<FrameInput, C_MAX_TICKS_PER_FRAME> inputs{};
+        int   count = 0;
+        float alpha = 1.f;
+
+        int Ticks() const {
+            int ticks = 0;
+            for (int i = 0; i < count; ++i) ticks += inputs[static_cast<size_t>(i)].ticks;
+            return ticks;
+        }
+    };
+
+    Application() = default;
+
+    // Simulation side of Run: steps each queued frame and publishes what it looks like.
+    // The autopilot decides each frame's input here, from the world it is about to step,
+    // and appends it to `record` if given.
+    void SimulationLoop(uint64_t seed, Replay* record) {
+        if (Trace::Enabled()) Trace::Instance().NameThread("simulation");
+        simFrame = 0;
+        if (!restored) world.Start(seed);
+        PostAsteroidMotion();
+        PostOrbits();
+        Capture(snapshots.Back(), 1.f);
+        snapshots.Publish();
+
+        autopilot.Reset();
+        QueuedFrame frame;
+        while (inbox.Pop(frame)) {
+            if (autopilotOn) {
+                frame.inputs[0] = world.Fly(autopilot, frame.Ticks());
+                frame.count = 1;
+                if (record) record->frames.push_back(frame.inputs[0]);
+            }
+            int requested = pendingBroadphase.exchange(-1, std::memory_order_relaxed);
+            if (requested >= 0) SetBroadphase(static_cast<Broadphase>(requested));
+            world.SetSpawnRate(spawnRate.load(std::memory_order_relaxed));
+
+            ++simFrame;
+            const auto stepStart = std::chrono::steady_clock::now();
+            for (int i = 0; i < frame.count; ++i) StepPublished(frame.inputs[static_cast<size_t>(i)]);
+            simMs.store(static_cast<float>(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - stepStart).count()),
+                std::memory_order_relaxed);
+            TraceCounts();
+            explosionMail.Post(world.Explosions());
+
+            TRACE_SCOPE("snapshot");
+            PostAsteroidMotion();
+            PostOrbits();
+            Capture(snapshots.Back(), frame.alpha);
+            snapshots.Publish();
+        }
+    }
+
+    // Analytic drawing: the current course of every slot that changed during this frame,
+    // stamped with the frame so the renderer applies it along with the matching snapshot.
+    void PostAsteroidMotion() {
+        if (!analyticAsteroids) return;
+        MEMORY_SCOPE(SNAPSHOTS);
+        const AsteroidField& asteroids = world.Asteroids();
+        const float now = static_cast<float>(world.SimClock());
+        for (uint32_t slot : world.TakeChanges()) {
+            if (slot >= asteroids.Size()) continue;
+            AsteroidMotionBatch::Motion m{
+                asteroids.GetPosition(slot), asteroids.GetVelocity(slot),
+                asteroids.GetRotation(slot), asteroids.GetRotationSpeed(slot),
+                asteroids.GetRadius(slot), static_cast<float>(asteroids.GetSides(slot)), now
+            };
+            asteroidUpdates.push_back({ simFrame, slot, m });
+        }
+        world.ClearChanges();
+        asteroidMail.Post(asteroidUpdates);
+    }
+
+    // Instanced orbiters: a new table whenever the tree changed, and otherwise every
+    // C_ORBIT_RESYNC_SECONDS, since the simulation's float angles drift from the exact
+    // rotation the shader applies. Each snapshot buffer copies it once (Capture).
+    void PostOrbits() {
+        if (!instancedShips) return;
+        const Fleet& fleet = world.GetFleet();
+        const double now = world.SimClock();
+        if (fleet.OrbitLayout() == orbitLayout && now - orbitEpoch < C_ORBIT_RESYNC_SECONDS) return;
+        MEMORY_SCOPE(SNAPSHOTS);
+        fleet.CaptureOrbits(orbits);
+        orbitLayout = fleet.OrbitLayout();
+        orbitEpoch = now;
+        ++orbitVersion;
+    }
+
+    void Capture(RenderSnapshot& out, float alpha) const {
+        MEMORY_SCOPE(SNAPSHOTS);
+        const Fleet& fleet = world.GetFleet();
+        out.frame = simFrame;
+        out.simTime = static_cast<float>(world.SimClock());
+        out.asteroidCount = world.Asteroids().Size();
+        if (!analyticAsteroids) out.asteroids.Capture(world.Asteroids(), world.TickDt());
+        out.projectiles.Capture(world.Projectiles(), world.TickDt());
+        fleet.Capture(out.ships);
+        if (instancedShips && out.orbitVersion != orbitVersion) {
+            out.orbits = orbits;
+            out.orbitVersion = orbitVersion;
+            out.orbitEpoch = static_cast<float>(orbitEpoch);
+        }
+        out.alpha = alpha;
+        out.hp = fleet.GetHP(Fleet::C_PLAYER);
+        out.score = fleet.GetScore(Fleet::C_PLAYER);
+        out.weapon = world.Weapon();
+        out.broadphase = world.GetBroadphase();
+        out.streaming = world.Streaming();
+        out.origin = world.Origin();
+        out.region = world.GetRegion();
+        if (out.streaming) {
+            const SectorMap& sectors = world.Sectors();
+            out.parked = sectors.Size();
+            out.sectors = sectors.Sectors();
+            out.sectorBytes = sectors.Bytes();
+        }
+    }
+
+    void Draw(const RenderSnapshot& snap) {
+        MEMORY_SCOPE(RENDER);
+        // EndDrawing waits for vsync, so only the CPU side of drawing is counted here.
+        {
+            PROFILE_SCOPE(DRAW);
+            const auto drawStart = std::chrono::steady_clock::now();
+            DrawScene(snap);
+            drawMs = static_cast<float>(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - drawStart).count());
+        }
+        // Presenting can wait on the GPU for a long while: what arrived while drawing is
+        // stamped now rather than after it.
+        input.Pump(GetTime());
+        Screenshots::Instance().Capture();
+        GifRecorder& gif = GifRecorder::Instance();
+        if (gif.Recording()) {
+            gif.Capture();
+            DrawText("GIF RECORDING", 50, GetScreenHeight() - 25, 10, RED);
+        }
+        TRACE_SCOPE("present");
+        if (Trace::Enabled()) Trace::Instance().Instant("rlgl flush");
+        Renderer::Instance().End();
+        if (Trace::Enabled()) {
+            const rlFrameStats rl = rlGetFrameStats();
+            Trace::Instance().Counter("rlgl draws", static_cast<int64_t>(rl.drawCalls));
+            Trace::Instance().Counter("rlgl flushes", static_cast<int64_t>(rl.batchFlushes));
+            Trace::Instance().Counter("rlgl upload KB", static_cast<int64_t>(rl.uploadBytes / 1024));
+        }
+        TraceHeap();
+    }
+
+    void TraceCounts() const {
+        if (!Trace::Enabled()) return;
+        Trace::Instance().Counter("asteroids", static_cast<int64_t>(world.Asteroids().Size()));
+        Trace::Instance().Counter("projectiles", static_cast<int64_t>(world.Projectiles().Size()));
+        Trace::Instance().Counter("ships", static_cast<int64_t>(world.GetFleet().Size()));
+    }
+
+    // Main thread: the last frame's allocations are only closed there.
+    static void TraceHeap() {
+        if (!Trace::Enabled()) return;
+        const MemoryTracker& mem = MemoryTracker::Instance();
+        Trace::Instance().Counter("heap KB", static_cast<int64_t>(mem.LiveBytes() / 1024));
+        Trace::Instance().Counter("allocations/frame", static_cast<int64_t>(mem.FrameAllocations()));
+    }
+
+    // World::Step, publishing its TickRecord while telemetry streams. Simulation thread.
+    void StepPublished(const FrameInput& in) {
+        if (!Telemetry::Stream::IsOpen()) {
+            world.Step(in);
+            return;
+        }
+        const MemoryTracker& memory = MemoryTracker::Instance();
+        const uint64_t allocations = memory.Allocations();
+        const uint64_t allocatedBytes = memory.AllocatedBytes();
+        const auto start = std::chrono::steady_clock::now();
+        world.Step(in);
+        PublishTick(start, in.ticks, allocations, allocatedBytes);
+    }
+
+    // The step that began at `start`, when the allocation counters read `allocations` and
+    // `allocatedBytes`, and the world it left. One thread at a time: the simulation thread
+    // in Run, the main thread in RunSoak.
+    void PublishTick(std::chrono::steady_clock::time_point start, int ticks, uint64_t allocations, uint64_t allocatedBytes) {
+        const float ms = static_cast<float>(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        const MemoryTracker& memory = MemoryTracker::Instance();
+        Telemetry::TickRecord r{};
+        r.step = ++telemetrySteps;
+        r.liveBytes = memory.LiveBytes();
+        r.ms = ms;
+        r.ticks = static_cast<uint32_t>(ticks);
+        r.asteroids = static_cast<uint32_t>(world.Asteroids().Size());
+        r.projectiles = static_cast<uint32_t>(world.Projectiles().Size());
+        r.ships = static_cast<uint32_t>(world.GetFleet().Size());
+        r.sectors = static_cast<uint32_t>(world.Streaming() ? world.Sectors().Size() : 0);
+        r.allocations = static_cast<uint32_t>(memory.Allocations() - allocations);
+        r.allocatedKb = static_cast<uint32_t>((memory.AllocatedBytes() - allocatedBytes) / 1024);
+        r.score = Score();
+        tickTelemetry.Publish(r);
+    }
+
+    // The frame just ended: its profiler phases, the GPU frame that last came back and
+    // rlgl's counters from EndDrawing. Render thread.
+    void PublishFrame(uint64_t frame, int ticks) {
+        Telemetry::FrameRecord r{};
+        r.frame = frame;
+        const std::array<double, Profiler::C_PHASES> phases = Profiler::Instance().Last();
+        for (int p = 0; p < Profiler::C_PHASES; ++p) r.phaseMs[p] = static_cast<float>(phases[static_cast<size_t>(p)]);
+        r.gpuMs = static_cast<float>(GpuProfiler::Instance().TotalMs());
+        r.ticks = static_cast<uint32_t>(ticks);
+        const rlFrameStats rl = rlGetFrameStats();
+        r.batchFlushes = static_cast<uint32_t>(rl.batchFlushes);
+        r.batchVertices = static_cast<uint32_t>(rl.batchFlushVertices);
+        r.drawCalls = static_cast<uint32_t>(rl.drawCalls);
+        r.shaderSwitches = static_cast<uint32_t>(rl.shaderSwitches);
+        r.uploadKb = static_cast<uint32_t>(rl.uploadBytes / 1024);
+        frameTelemetry.Publish(r);
+    }
+
+    void DrawScene(const RenderSnapshot& snap) {
+        const Font& font = atlas.HudFont();
+        if (hud.IsReady()) {
+            hud.Update(font, snap.hp, snap.weapon, snap.score);
+        }
+
+        if (GpuProfiler::Instance().BeginFrame()) {
+            FrameTimes::Instance().Record(FrameTimes::Series::GPU_FRAME, GpuProfiler::Instance().TotalMs());
+        }
+        Renderer::Instance().Begin();
+
+        // A streaming world scrolls: the camera keeps the player in the middle of the window.
+        // Particles live in world coordinates, so they keep their place when the region moves,
+        // and are drawn through the same camera moved by the region's origin.
+        Camera2D camera = { { 0.f, 0.f }, { 0.f, 0.f }, 0.f, 1.f };
+        if (snap.streaming && snap.ships.Size() > 0) {
+            camera.offset = { static_cast<float>(Renderer::Instance().Width()) * 0.5f, static_cast<float>(Renderer::Instance().Height()) * 0.5f };
+            camera.target = { Lerp(snap.ships.prevX[Fleet::C_PLAYER], snap.ships.x[Fleet::C_PLAYER], snap.alpha),
+                Lerp(snap.ships.prevY[Fleet::C_PLAYER], snap.ships.y[Fleet::C_PLAYER], snap.alpha) };
+        }
+        Renderer::Instance().SetCamera(camera);
+        Camera2D particleCamera = camera;
+        particleCamera.target = Vector2Add(camera.target, snap.origin);
+
+        // The world goes through the scaled target, the HUD stays at native resolution.
+        // Level of detail follows the pixels actually drawn.
+        View view = Renderer::Instance().CurrentView();
+        if (resolution.IsReady()) {
+            resolution.BeginScene();
+            view.pixelsPerUnit *= resolution.Scale();
+        }
+        view.lodBias = governor.Current().lodBias;
+        BeginMode2D(camera);
+
+        {
+            GPU_SCOPE("projectiles");
+            if (projectileBatch.IsReady()) {
+                projectileBatch.Draw(snap.projectiles.Blend(snap.alpha));
+            }
+            else {
+                snap.projectiles.Draw(snap.alpha);
+            }
+        }
+        {
+            GPU_SCOPE("asteroids");
+            if (analyticAsteroids) {
+                // Blending is free here: the courses are simply evaluated a fraction of a tick
+                // before the snapshot's time, exactly as Blend does for streamed positions.
+                asteroidMotion.Apply(asteroidMail, snap.frame);
+                asteroidMotion.Draw(snap.asteroidCount, snap.simTime - (1.f - snap.alpha) * world.TickDt(), view, RED);
+            }
+            else if (asteroidBatch.IsReady()) {
+                asteroidBatch.Draw(snap.asteroids.Blend(snap.alpha), view, RED);
+            }
+            else {
+                snap.asteroids.Draw(snap.alpha, view);
+            }
+        }
+
+        // No CPU fallback: without the shader there are simply no particles.
+        if (particles.IsReady()) {
+            GPU_SCOPE("particles");
+            explosionMail.Take(explosionsDrawn);
+            particles.Explode(explosionsDrawn);
+            particles.EmitTrails(snap.ships, snap.alpha, GetFrameTime(), snap.origin);
+            EndMode2D();
+            BeginMode2D(particleCamera);
+            particles.Draw();
+            EndMode2D();
+            BeginMode2D(camera);
+        }
+
+        // Ships go out as one rlgl draw call however many orbiters there are; with the
+        // instanced batch only the player is a sprite, and the orbiters one instanced draw
+        // that costs nothing per orbiter on this thread. The HUD is drawn last to stay on top.
+        {
+            GPU_SCOPE("ships");
+            SpriteBatch sprites(&FrameArena::Instance());
+            snap.ships.Draw(sprites, atlas, snap.alpha, instancedShips ? 1 : SIZE_MAX);
+            sprites.Flush(atlas.Texture());
+            if (instancedShips && snap.ships.Size() > 0) {
+                // Evaluated a fraction of a tick before the snapshot, like analytic asteroids.
+                orbiterBatch.Upload(snap.orbits, snap.orbitVersion, atlas);
+                const Vector2 player = { Lerp(snap.ships.prevX[Fleet::C_PLAYER], snap.ships.x[Fleet::C_PLAYER], snap.alpha),
+                    Lerp(snap.ships.prevY[Fleet::C_PLAYER], snap.ships.y[Fleet::C_PLAYER], snap.alpha) };
+                const float turned = (snap.simTime - (1.f - snap.alpha) * world.TickDt() - snap.orbitEpoch) * Fleet::C_ORBIT_SPEED;
+                orbiterBatch.Draw(player, turned, snap.ships.spriteSize, atlas.Texture());
+            }
+        }
+        EndMode2D();
+        if (resolution.IsReady()) {
+            resolution.EndScene();
+            GPU_SCOPE("post");
+            post.Present(resolution.SceneTexture(), resolution.SceneSource());
+        }
+
+        // The cached HUD is its own texture, the profiler's text the atlas: rlgl groups the
+        // overlay's draws by texture, one draw call each however they interleave.
+        GPU_SCOPE("hud");
+        rlEnableTextureBuckets();
+        if (hud.IsReady()) {
+            hud.Draw();
+        }
+        else {
+            DrawTextEx(font, TextFormat("HP: %d", snap.hp),
+                { 10, 10 }, 20, 2, GREEN);
+
+            const char* weaponName = (snap.weapon == WeaponType::LASER) ? "LASER" : "BULLET";
+            DrawTextEx(font, TextFormat("Weapon: %s", weaponName),
+                { 10, 40 }, 20, 2, BLUE);
+
+            DrawTextEx(font, TextFormat("Score: %d", snap.score),
+                { 10, 70 }, 20, 2, YELLOW);
+        }
+
+        // What the governor has given up to hold the frame rate, while it gives up anything.
+        if (governor.Level() > 0) {
+            DrawTextEx(font, TextFormat("GOVERNOR %d: %s", governor.Level(), governor.Actions()),
+                { 10, static_cast<float>(GetScreenHeight() - 40) }, 10, 1, ORANGE);
+        }
+
+        if (showProfiler) DrawProfiler(font, snap);
+        rlDrawRenderBatchActive();
+        rlDisableTextureBuckets();
+    }
+
+    // Applies the governor's current level and logs it.
+    void Govern() {
+        const FrameGovernor::Settings& s = governor.Current();
+        particles.SetBudget(s.particles, s.mergeEffects);
+        SamplerPresets::Instance().SetTier(s.samplerTier);
+        spawnRate.store(s.spawns, std::memory_order_relaxed);
+        if (governor.Level() > 0) {
+            TraceLog(LOG_INFO, "GOVERNOR: level %d at %.0f%% of the frame budget: %s", governor.Level(), governor.Load() * 100.f, governor.Actions());
+        }
+        else if (governor.Load() > 0.f) {
+            TraceLog(LOG_INFO, "GOVERNOR: back to full detail at %.0f%% of the frame budget", governor.Load() * 100.f);
+        }
+    }
+
+    // Per-phase ms for the last frame plus p50/p99 over the profiler history, beside the HUD.
+    void DrawProfiler(const Font& font, const RenderSnapshot& snap) const {
+        const Profiler& prof = Profiler::Instance();
+        float x = 260.f;
+        float y = 10.f;
+        DrawTextEx(font, TextFormat("%-12s %7s %7s %7s", "phase", "ms", "p50", "p99"), { x, y }, 10, 1, LIGHTGRAY);
+        for (int p = 0; p < Profiler::C_PHASES; ++p) {
+            y += 12.f;
+            Profiler::Phase phase = static_cast<Profiler::Phase>(p);
+            Profiler::Stats st = prof.Get(phase);
+            DrawTextEx(font, TextFormat("%-12s %7.2f %7.2f %7.2f", Profiler::NameOf(phase), st.last, st.p50, st.p99),
+                { x, y }, 10, 1, phase == Profiler::Phase::FRAME ? WHITE : LIGHTGRAY);
+        }
+        // The whole session so far, where the columns above only cover the last few seconds.
+        const FrameTimes::Summary cpuFrames = FrameTimes::Instance().Get(FrameTimes::Series::CPU_FRAME);
+        const FrameTimes::Summary ticks = FrameTimes::Instance().Get(FrameTimes::Series::SIM_TICK);
+        y += 12.f;
+        DrawTextEx(font, TextFormat("session: frame p99 %.2f max %.2f, tick p99 %.2f max %.2f ms", cpuFrames.p99, cpuFrames.max, ticks.p99, ticks.max),
+            { x, y }, 10, 1, LIGHTGRAY);
+        y += 12.f;
+        DrawTextEx(font, TextFormat("broadphase: %s (F4)", BroadphaseName(snap.broadphase)), { x, y }, 10, 1, LIGHTGRAY);
+        y += 12.f;
+        DrawTextEx(font, TextFormat("resolution: %3.0f%% (scene %.2f ms gpu)", resolution.Scale() * 100.f, resolution.GpuMs()),
+            { x, y }, 10, 1, LIGHTGRAY);
+        y += 12.f;
+        const FrameGraph::Stats targets = post.Targets();
+        DrawTextEx(font, TextFormat("post: %d pass(es), %d target(s) in %d texture(s), %zu KB", post.Passes(), targets.targets,
+            targets.textures, targets.bytes / 1024), { x, y }, 10, 1, LIGHTGRAY);
+        if (snap.streaming) {
+            y += 12.f;
+            DrawTextEx(font, TextFormat("world: region at sector %d,%d, %zu parked in %zu sector(s), %zu KB", snap.region.col, snap.region.row,
+                snap.parked, snap.sectors, snap.sectorBytes / 1024), { x, y }, 10, 1, LIGHTGRAY);
+        }
+        y += 12.f;
+        DrawTextEx(font, TextFormat("governor: level %d at %3.0f%% of budget%s", governor.Level(), governor.Load() * 100.f, governed ? "" : " (off)"),
+            { x, y }, 10, 1, governor.Level() > 0 ? ORANGE : LIGHTGRAY);
+
+        // rlgl's own counters for the last frame; direct GL draws (instanced batches) aren't in them.
+        const rlFrameStats rl = rlGetFrameStats();
+        y += 12.f;
+        DrawTextEx(font, TextFormat("rlgl: %d flush(es), %d vert(s), %d draw(s)", rl.batchFlushes, rl.batchFlushVertices, rl.drawCalls),
+            { x, y }, 10, 1, LIGHTGRAY);
+        y += 12.f;
+        DrawTextEx(font, TextFormat("rlgl: %d bind(s), %d shader(s), %d KB up", rl.textureBinds, rl.shaderSwitches, rl.uploadBytes / 1024),
+            { x, y }, 10, 1, LIGHTGRAY);
+
+        // Heap use; any allocation in a frame of steady play is worth a look (red).
+        const MemoryTracker& mem = MemoryTracker::Instance();
+        y += 12.f;
+        DrawTextEx(font, TextFormat("heap: %.1f MB, %llu alloc(s) %llu KB last frame", static_cast<double>(mem.LiveBytes()) / (1024.0 * 1024.0),
+            static_cast<unsigned long long>(mem.FrameAllocations()), static_cast<unsigned long long>(mem.FrameBytes() / 1024)),
+            { x, y }, 10, 1, mem.FrameAllocations() == 0 ? LIGHTGRAY : RED);
+        const FrameArena& arena = FrameArena::Instance();
+        y += 12.f;
+        const FrameArena& tickArena = world.TickArena();
+        DrawTextEx(font, TextFormat("arenas: frame %zu/%zu KB, tick %zu/%zu KB (peak/size)", arena.HighWater() / 1024, arena.Capacity() / 1024,
+            tickArena.HighWater() / 1024, tickArena.Capacity() / 1024), { x, y }, 10, 1, LIGHTGRAY);
+        for (int t = 0; t < MemoryTracker::C_TAGS; ++t) {
+            const MemoryTracker::Tag tag = static_cast<MemoryTracker::Tag>(t);
+            const MemoryTracker::Stats st = mem.Get(tag);
+            if (st.liveBytes < C_HEAP_SHOWN_BYTES) continue;
+            y += 12.f;
+            DrawTextEx(font, TextFormat("  %-12s %8.1f KB", MemoryTracker::NameOf(tag), static_cast<double>(st.liveBytes) / 1024.0),
+                { x, y }, 10, 1, LIGHTGRAY);
+        }
+
+        // GPU passes, read back a few frames late; only those that ran in that frame.
+        const GpuProfiler& gpu = GpuProfiler::Instance();
+        y += 18.f;
+        DrawTextEx(font, TextFormat("%-12s %7s %7s", "gpu pass", "ms", "avg"), { x, y }, 10, 1, LIGHTGRAY);
+        for (const GpuProfiler::Pass& p : gpu.Passes()) {
+            if (!p.seen) continue;
+            y += 12.f;
+            DrawTextEx(font, TextFormat("%-12s %7.2f %7.2f", p.name, p.last, p.average), { x, y }, 10, 1, LIGHTGRAY);
+        }
+        y += 12.f;
+        DrawTextEx(font, TextFormat("%-12s %7.2f", "gpu total", gpu.TotalMs()), { x, y }, 10, 1, WHITE);
+    }
+
+    World world;
+    bool  restored = false;  // world holds a snapshot (LoadWorld) that Run/InitHeadless keep
+
+    AsteroidBatch           asteroidBatch;
+    ProjectileBatch         projectileBatch;
+    ParticleSystem          particles;
+    AsteroidMotionBatch     asteroidMotion;
+    OrbiterBatch            orbiterBatch;
+    SpriteAtlas             atlas;
+    HudCache                hud;
+    DynamicResolution       resolution;
+    PostStack               post;
+
+    Autopilot autopilot;
+    bool      autopilotOn = false;
+
+    bool                       replicate = false;
+    ReplicationLoopback::Stats replication{};
+
+    bool          showProfiler = false;
+    InputTimeline input;  // Run's, render thread only
+
+    // Back-pressure: the governor sees each frame's draw and simulation ms and sets the
+    // particle budget and LOD directly, the simulation's spawn rate through spawnRate.
+    FrameGovernor      governor;
+    bool               governed = true;
+    float              drawMs = 0.f;
+    std::atomic<float> simMs{ 0.f };
+    std::atomic<float> spawnRate{ 1.f };
+
+    // Telemetry: ticks from whichever thread steps the world, frames from the render thread.
+    Telemetry::TickChannel  tickTelemetry;
+    Telemetry::FrameChannel frameTelemetry;
+    uint64_t                telemetrySteps = 0;
+
+    // Hand-off between the render thread and the simulation thread in Run.
+    static constexpr size_t C_MAX_QUEUED_FRAMES = 2;
+    BoundedQueue<QueuedFrame, C_MAX_QUEUED_FRAMES> inbox;
+    TripleBuffer<RenderSnapshot>                   snapshots;
+    std::atomic<int>                               pendingBroadphase{ -1 };
+
+    // Asteroid kills on their way from the world's collision passes to the particle system.
+    Mailbox<Explosion>      explosionMail;
+    std::vector<Explosion>  explosionsDrawn;
+
+    // Analytic asteroid drawing (see PostAsteroidMotion).
+    bool                                     streamAsteroids = false;
+    const char*                              musicPath = nullptr;
+    bool                                     serialInit = false;
+    bool                                     analyticAsteroids = false;
+    uint64_t                                 simFrame = 0;
+    std::vector<AsteroidMotionBatch::Update> asteroidUpdates;
+    Mailbox<AsteroidMotionBatch::Update>     asteroidMail;
+
+    // Instanced orbiters (see PostOrbits): the latest table, simulation thread only, and
+    // the fleet layout and time it was taken at.
+    static constexpr double          C_ORBIT_RESYNC_SECONDS = 1.0;
+    bool                             instancedShips = false;
+    std::vector<OrbiterBatch::Orbit> orbits;
+    uint64_t                         orbitVersion = 0;
+    uint64_t                         orbitLayout = UINT64_MAX;
+    double                           orbitEpoch = 0.0;
+
+    static constexpr float C_SWARM_MAX_DT = 1.f / 30.f;  // a hitch slows the swarm down rather than piling up substeps
+    static constexpr float C_SWARM_ZOOM_STEP = 1.25f;   // per wheel notch
+    static constexpr float C_SWARM_MAX_ZOOM = 8.f;
+    static constexpr int C_INIT_THREADS = 2;  // Run's startup decoders, one per job
+
+    // Subsystems holding less than this stay off the profiler overlay's heap list.
+    static constexpr size_t C_HEAP_SHOWN_BYTES = 16 * 1024;
+};
+
+#ifndef POIGK_NO_MAIN
+// `Main.exe --headless [ticks]` steps the simulation without opening a window.
+// `--trace <file.json>` records a Chrome/Perfetto trace of the run, written at exit.
+// `--record <file>` saves the session's seed and input; `--replay <file>` plays it back,
+// in a window or, with --headless, as fast as possible with a frame-time report.
+// `--scenario <file>` and `--<key> <value>` override the world settings (see scenario.h);
+// with --headless the scenario's asteroid/projectile counts are held for every tick.
+// `--broadphase grid|sap|brute|kinetic|incremental` picks the projectile broadphase (F4 cycles it in a window
+// unless a replay is being recorded or played). `--stream-asteroids` draws asteroids from
+// per-frame positions instead of their analytic courses. Resources come from resources.pak
+// (Pack.exe in build.bat) when it is there; `--loose` reads ../resources file by file.
+// F12 saves a screenshot, as PNG or with `--qoi-screenshots` as QOI; CTRL+F12 records a GIF.
+// Under load a window sheds merged explosions, particles, outline detail and then spawns
+// (FrameGovernor, shown below the HUD); `--no-governor` keeps the full load.
+// `--music <file.qoa>` loops a QOA track behind the game, decoded off the main thread.
+// The heap per subsystem is logged at exit; F3 shows it live with the frame's allocations.
+// Frame, GPU frame and tick time percentiles are logged at exit; `--frame-report <file.json>`
+// saves them, and `--frame-baseline <file.json>` exits with 2 when a p99 is past the one
+// saved there by more than `--frame-tolerance` (a fraction, 0.1 by default).
+// Each startup phase is logged with its time since process start, up to the first frame;
+// `--startup-report <file.json>` saves them, and `--serial-init` runs the phases the window
+// otherwise overlaps with decoding one after another, to compare.
+// `--autopilot` lets the Autopilot fly the player, in a window (where --record saves its
+// input) or headless; `--preset soak|saturate|expanse` picks built-in settings for such runs.
+// `--headless [ticks] --worlds <n>` plays n independent games side by side on the job system
+// (WorldBatch), each from its own stream of `--seed <n>` (1 by default), and logs their
+// combined throughput and scores; with --autopilot every world is flown.
+// `--replay <file> --headless --replicate` also streams the session to a spectator over a
+// simulated lossy link (ReplicationLoopback) and logs the bandwidth and the replica's error.
+// `--lockstep` runs the simulation in fixed point (World::SetLockstep), so sessions from the
+// same seed and input end with the same checksum on every machine; --record keeps the mode.
+// The input must be recorded or scripted: the autopilot steers in floats, so --autopilot
+// runs and --worlds batches only repeat on the same build and machine.
+// `--save-world <file>` writes the world as the session or run ends (World::Save, world 0
+// of a batch) and `--load-world <file>` starts a window, --headless or --worlds from such a
+// snapshot, in its scenario and mode, instead of a fresh world. Replays and recordings
+// always start from their seed.
+// `--gpu-swarm [asteroids]` opens a window on that many asteroids (2^20 by default) and a
+// quarter as many projectiles, integrated and hit-tested in compute shaders (GpuSwarm);
+// it needs a GL 4.3 build, `build.bat -Release -GL43`, and exits with 1 without one.
+// `--soak <minutes>` lets the autopilot play headless for that long, holding the scenario's
+// asteroids (its max-asteroids when it sets none) and projectiles as a floor while the
+// spawner and waves add on top, and sampling the heap, entity counts, allocations and tick
+// percentiles every `--soak-interval <seconds>` (10) into `--soak-log <file>` (soak.bin,
+// SoakMonitor's format); it exits with 2 when a series grew or drifted by more than
+// `--soak-tolerance` (a fraction, 0.2 by default).
+// `--telemetry [port]` streams a record per simulation step and per frame as UDP datagrams
+// to 127.0.0.1 (port 47800 by default) for a live dashboard, in a window or a soak; see
+// telemetry.h for the format. Nothing blocks on it: unread packets are dropped.
+int main(int argc, char** argv) {
+	MemoryTracker::Install();
+	StartupProfile::Instance();  // main()'s thread is the main one
+	Scenario scenario;
+	const char* tracePath = nullptr;
+	const char* recordPath = nullptr;
+	const char* replayPath = nullptr;
+	bool headless = false;
+	int ticks = 1200;
+	Broadphase broadphase = Broadphase::GRID;
+	bool streamAsteroids = false;
+	bool governor = true;
+	bool autopilot = false;
+	size_t worlds = 0;
+	uint64_t seed = 1;
+	bool lockstep = false;
+	bool replicate = false;
+	const char* saveWorldPath = nullptr;
+	const char* loadWorldPath = nullptr;
+	bool loose = false;
+	const char* musicPath = nullptr;
+	const char* frameReportPath = nullptr;
+	const char* startupReportPath = nullptr;
+	bool serialInit = false;
+	const char* frameBaselinePath = nullptr;
+	double frameTolerance = 0.1;
+	uint32_t postEffects = 0;
+	uint32_t swarm = 0;
+	double soakMinutes = 0.0;
+	double soakInterval = 10.0;
+	double soakTolerance = 0.2;
+	const char* soakLogPath = "soak.bin";
+	uint16_t telemetryPort = 0;
+	for (int i = 1; i < argc; ++i) {
+		if (TextIsEqual(argv[i], "--trace") && i + 1 < argc) {
+			tracePath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--record") && i + 1 < argc) {
+			recordPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--replay") && i + 1 < argc) {
+			replayPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--headless")) {
+			headless = true;
+			if (i + 1 < argc && argv[i + 1][0] != '-') ticks = TextToInteger(argv[++i]);
+		}
+		else if (TextIsEqual(argv[i], "--broadphase") && i + 1 < argc) {
+			if (!ParseBroadphase(argv[++i], broadphase)) {
+				TraceLog(LOG_WARNING, "unknown broadphase %s, using grid", argv[i]);
+			}
+		}
+		else if (TextIsEqual(argv[i], "--frame-report") && i + 1 < argc) {
+			frameReportPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--startup-report") && i + 1 < argc) {
+			startupReportPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--serial-init")) {
+			serialInit = true;
+		}
+		else if (TextIsEqual(argv[i], "--frame-baseline") && i + 1 < argc) {
+			frameBaselinePath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--frame-tolerance") && i + 1 < argc) {
+			frameTolerance = atof(argv[++i]);
+		}
+		else if (TextIsEqual(argv[i], "--autopilot")) {
+			autopilot = true;
+		}
+		else if (TextIsEqual(argv[i], "--worlds") && i + 1 < argc) {
+			worlds = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (TextIsEqual(argv[i], "--seed") && i + 1 < argc) {
+			seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (TextIsEqual(argv[i], "--preset") && i + 1 < argc) {
+			if (!scenario.ApplyPreset(argv[++i])) {
+				TraceLog(LOG_ERROR, "SCENARIO: unknown preset %s", argv[i]);
+				return 1;
+			}
+		}
+		else if (TextIsEqual(argv[i], "--gpu-swarm")) {
+			swarm = 1u << 20;
+			if (i + 1 < argc && argv[i + 1][0] != '-') {
+				swarm = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+				if (swarm == 0) {
+					TraceLog(LOG_WARNING, "SWARM: '%s' is not an asteroid count, using %u", argv[i], 1u << 20);
+					swarm = 1u << 20;
+				}
+			}
+		}
+		else if (TextIsEqual(argv[i], "--soak") && i + 1 < argc) {
+			soakMinutes = atof(argv[++i]);
+		}
+		else if (TextIsEqual(argv[i], "--soak-interval") && i + 1 < argc) {
+			soakInterval = atof(argv[++i]);
+		}
+		else if (TextIsEqual(argv[i], "--soak-tolerance") && i + 1 < argc) {
+			soakTolerance = atof(argv[++i]);
+		}
+		else if (TextIsEqual(argv[i], "--soak-log") && i + 1 < argc) {
+			soakLogPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--telemetry")) {
+			telemetryPort = Telemetry::C_DEFAULT_PORT;
+			if (i + 1 < argc && argv[i + 1][0] != '-') telemetryPort = static_cast<uint16_t>(strtoul(argv[++i], nullptr, 10));
+		}
+		else if (TextIsEqual(argv[i], "--lockstep")) {
+			lockstep = true;
+		}
+		else if (TextIsEqual(argv[i], "--replicate")) {
+			replicate = true;
+		}
+		else if (TextIsEqual(argv[i], "--save-world") && i + 1 < argc) {
+			saveWorldPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--load-world") && i + 1 < argc) {
+			loadWorldPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--stream-asteroids")) {
+			streamAsteroids = true;
+		}
+		else if (TextIsEqual(argv[i], "--no-governor")) {
+			governor = false;
+		}
+		else if (TextIsEqual(argv[i], "--loose")) {
+			loose = true;
+		}
+		else if (TextIsEqual(argv[i], "--music") && i + 1 < argc) {
+			musicPath = argv[++i];
+		}
+		else if (TextIsEqual(argv[i], "--qoi-screenshots")) {
+			Screenshots::Instance().UseQoi(true);
+		}
+		else if (TextIsEqual(argv[i], "--post") && i + 1 < argc) {
+			if (!PostStack::Parse(argv[++i], postEffects)) {
+				TraceLog(LOG_WARNING, "unknown post effect in %s, drawing without post effects", argv[i]);
+				postEffects = 0;
+			}
+		}
+		else if (TextIsEqual(argv[i], "--scenario") && i + 1 < argc) {
+			if (!scenario.Load(argv[++i])) {
+				TraceLog(LOG_ERROR, "SCENARIO: could not load %s", argv[i]);
+				return 1;
+			}
+		}
+		else if (TextIsEqual(TextSubtext(argv[i], 0, 2), "--") && i + 1 < argc && scenario.Set(argv[i] + 2, argv[i + 1])) {
+			++i;
+		}
+		else {
+			TraceLog(LOG_WARNING, "unknown argument %s", argv[i]);
+		}
+	}
+
+	Replay replay;
+	if (replayPath && !replay.Load(replayPath)) {
+		TraceLog(LOG_ERROR, "REPLAY: could not load %s", replayPath);
+		return 1;
+	}
+	if (tracePath) Trace::Instance().Start();
+	if (!loose) {
+		STARTUP_SCOPE("archive");
+		AssetArchive::Mount("resources.pak", "../resources/");
+	}
+
+	Application& app = Application::Instance();
+	{
+		STARTUP_SCOPE("configure");
+		app.Configure(scenario);
+		app.SetLockstep(lockstep);
+		app.SetReplicate(replicate);
+		app.SetBroadphase(broadphase);
+		app.SetStreamAsteroids(streamAsteroids);
+		app.SetGovernor(governor);
+		if (autopilot && replayPath) TraceLog(LOG_WARNING, "AUTOPILOT: a replay plays its recorded input, ignoring --autopilot");
+		app.SetAutopilot((autopilot && !replayPath) || soakMinutes > 0.0);
+		app.SetPostEffects(postEffects);
+		app.SetMusic(musicPath);
+		app.SetSerialInit(serialInit);
+	}
+	if (telemetryPort) Telemetry::Stream::Instance().Open(telemetryPort);
+
+	// The snapshot is mapped here and copied into the world (or a batch's worlds) below.
+	std::unique_ptr<WorldSnapshot::Reader> snapshot;
+	const auto loadStart = std::chrono::steady_clock::now();
+	if (loadWorldPath && (replayPath || recordPath)) {
+		TraceLog(LOG_WARNING, "WORLD: a replay starts from its seed, ignoring --load-world");
+	}
+	else if (loadWorldPath) {
+		snapshot = std::make_unique<WorldSnapshot::Reader>(loadWorldPath);
+		if (!snapshot->Valid() || (!(headless && worlds > 0) && !app.LoadWorld(*snapshot))) {
+			TraceLog(LOG_ERROR, "WORLD: %s is not a world snapshot from this build", loadWorldPath);
+			return 1;
+		}
+	}
+	auto loadedWorld = [&](const World& w) {
+		if (!snapshot) return;
+		TraceLog(LOG_INFO, "WORLD: loaded %s (%zu bytes) in %.3f ms, %zu asteroids, %zu projectiles, %zu ships, checksum %016llx",
+			loadWorldPath, snapshot->Bytes(), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count(),
+			w.Asteroids().Size(), w.Projectiles().Size(), w.GetFleet().Size(), static_cast<unsigned long long>(w.Checksum()));
+	};
+	auto saveWorld = [&](const World& w) {
+		if (!saveWorldPath) return;
+		const size_t bytes = w.Save(saveWorldPath);
+		if (bytes == 0) TraceLog(LOG_WARNING, "WORLD: could not write %s", saveWorldPath);
+		else TraceLog(LOG_INFO, "WORLD: saved %s (%zu bytes), checksum %016llx", saveWorldPath, bytes, static_cast<unsigned long long>(w.Checksum()));
+	};
+
+	// Where a streaming world's region ended up and what it left parked behind.
+	auto logSectors = [](const World& w) {
+		if (!w.Streaming()) return;
+		const SectorMap& sectors = w.Sectors();
+		TraceLog(LOG_INFO, "WORLD: region at sector %d,%d of %dx%d, %zu asteroids live, %zu parked in %zu sector(s) (%.1f KB)",
+			w.GetRegion().col, w.GetRegion().row, sectors.Cols(), sectors.Rows(), w.Asteroids().Size(),
+			sectors.Size(), sectors.Sectors(), static_cast<double>(sectors.Bytes()) / 1024.0);
+	};
+
+	int soakFlagged = 0;
+	if (swarm > 0) {
+		if (!app.RunGpuSwarm(swarm, swarm / 4)) return 1;
+	}
+	else if (soakMinutes > 0.0) {
+		if (replayPath || worlds > 0) TraceLog(LOG_WARNING, "SOAK: a soak flies a single world, ignoring --replay and --worlds");
+		loadedWorld(app.GetWorld());
+		app.InitHeadless();
+		SoakMonitor soak;
+		const double seconds = soakMinutes * 60.0;
+		if (!soak.Start(soakLogPath, seconds, soakInterval, app.GetWorld().GetScenario().tickRate)) {
+			TraceLog(LOG_WARNING, "SOAK: could not write %s, soaking without a log", soakLogPath);
+		}
+		const Scenario& held = app.GetWorld().GetScenario();  // a loaded world's own
+		const uint64_t soakTicks = app.RunSoak(soak, seconds, held.asteroids > 0 ? held.asteroids : held.maxAsteroids, held.projectiles);
+		TraceLog(LOG_INFO, "SOAK: %llu ticks in %.1f minutes, score %d, checksum %016llx", static_cast<unsigned long long>(soakTicks),
+			soak.Elapsed() / 60.0, app.Score(), static_cast<unsigned long long>(app.Checksum()));
+		soakFlagged = soak.Analyze(soakTolerance);
+		logSectors(app.GetWorld());
+		saveWorld(app.GetWorld());
+	}
+	else if (headless && replayPath) {
+		if (worlds > 0) TraceLog(LOG_WARNING, "BATCH: a replay plays a single world, ignoring --worlds");
+		app.InitHeadless();
+		auto stats = app.RunReplayHeadless(replay);
+		TraceLog(LOG_INFO, "REPLAY: %zu frames, %d ticks, %.3f ms sim (frame p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms), score %d, checksum %016llx",
+			stats.frames, stats.ticks, stats.seconds * 1000.0, stats.frameP50, stats.frameP95, stats.frameP99, stats.frameMax, app.Score(),
+			static_cast<unsigned long long>(app.Checksum()));
+		logSectors(app.GetWorld());
+		if (replicate) {
+			const ReplicationLoopback::Stats& r = app.ReplicationResult();
+			const double packets = static_cast<double>(std::max<uint64_t>(r.packets, 1));
+			TraceLog(LOG_INFO, "REPLICATION: %llu packets, %.1f bytes/frame against %.1f as float snapshots (%.0fx), %d rejected",
+				static_cast<unsigned long long>(r.packets), static_cast<double>(r.bytes) / packets, static_cast<double>(r.fullBytes) / packets,
+				static_cast<double>(r.fullBytes) / static_cast<double>(std::max<uint64_t>(r.bytes, 1)), r.rejected);
+			TraceLog(LOG_INFO, "REPLICATION: worst error %.3f px asteroids, %.3f px projectiles, %.3f px ships, %zu out of step",
+				r.asteroidError, r.projectileError, r.shipError, r.missing);
+		}
+		saveWorld(app.GetWorld());
+	}
+	else if (headless && worlds > 0) {
+		WorldBatch batch;
+		if (!batch.Init(scenario, worlds, seed, broadphase, autopilot, lockstep, snapshot.get())) {
+			TraceLog(LOG_ERROR, "WORLD: %s is not a world snapshot from this build", loadWorldPath);
+			return 1;
+		}
+		loadedWorld(batch.Get(0));
+		auto stats = batch.Run(ticks);
+		const double worldTicks = static_cast<double>(stats.worlds) * stats.ticks;
+		TraceLog(LOG_INFO, "BATCH: %zu worlds x %d ticks in %.3f ms (%.0f world ticks/s on %zu threads), %zu ships, score min %d mean %.1f max %d",
+			stats.worlds, stats.ticks, stats.seconds * 1000.0, worldTicks / stats.seconds, JobSystem::Instance().ThreadCount(),
+			stats.ships, stats.minScore, stats.meanScore, stats.maxScore);
+		saveWorld(batch.Get(0));
+	}
+	else if (headless) {
+		loadedWorld(app.GetWorld());
+		app.InitHeadless();
+		const Scenario& held = app.GetWorld().GetScenario();  // a loaded world's own
+		auto stats = app.RunHeadless(ticks, held.asteroids, held.projectiles);
+		TraceLog(LOG_INFO, "HEADLESS: %d ticks in %.3f ms (%.0f ticks/s), %zu ships, score %d, checksum %016llx",
+			stats.ticks, stats.seconds * 1000.0, stats.ticks / stats.seconds, stats.ships, stats.score,
+			static_cast<unsigned long long>(app.Checksum()));
+		logSectors(app.GetWorld());
+		saveWorld(app.GetWorld());
+	}
+	else {
+		if (worlds > 0) TraceLog(LOG_WARNING, "BATCH: --worlds needs --headless, ignoring it");
+		loadedWorld(app.GetWorld());
+		Replay recording;
+		app.Run(replayPath ? &replay : nullptr, recordPath ? &recording : nullptr);
+		if (recordPath && !recording.Save(recordPath)) {
+			TraceLog(LOG_WARNING, "REPLAY: could not write %s", recordPath);
+		}
+		if (recordPath || replayPath) TraceLog(LOG_INFO, "REPLAY: session ended with score %d", app.Score());
+		saveWorld(app.GetWorld());
+		if (startupReportPath && !StartupProfile::Instance().Write(startupReportPath)) {
+			TraceLog(LOG_WARNING, "STARTUP: could not write %s", startupReportPath);
+		}
+	}
+
+	if (tracePath && !Trace::Instance().Write(tracePath)) {
+		TraceLog(LOG_WARNING, "TRACE: could not write %s", tracePath);
+	}
+	Telemetry::Stream::Instance().Close();
+	AssetArchive::Unmount();
+	MemoryTracker::Instance().Report();
+
+	FrameTimes& frameTimes = FrameTimes::Instance();
+	frameTimes.Report();
+	if (frameReportPath && !frameTimes.Write(frameReportPath)) {
+		TraceLog(LOG_WARNING, "FRAMES: could not write %s", frameReportPath);
+	}
+	if (frameBaselinePath) {
+		int regressions = 0;
+		if (!frameTimes.CheckBaseline(frameBaselinePath, frameTolerance, regressions)) {
+			TraceLog(LOG_ERROR, "FRAMES: could not read a baseline from %s", frameBaselinePath);
+			return 1;
+		}
+		if (regressions > 0) return 2;
+	}
+	return soakFlagged > 0 ? 2 : 0;
+}
+#endif
@@ -0,0 +1,275 @@
+#ifndef MATERIAL_BATCH_H
+#define MATERIAL_BATCH_H
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // texture arrays, image copies and multi-draw indirect, which rlgl doesn't wrap
+#include "instancing.h"
+
+// --- MATERIAL BATCH ---
+// Several models drawn as one: their meshes concatenated into a single vertex array, their
+// diffuse maps copied into the layers of one GL_TEXTURE_2D_ARRAY, and a layer index per
+// instance next to its transform, so instances of different models with different textures
+// share one texture bind and one draw call. A model draws with the diffuse map of its first
+// mesh's material; the maps must share a size and an uncompressed format (mipmaps are
+// generated for the array).
+//
+// Draw() reads the kinds' transforms from an InstanceRing, each kind's contiguous as the
+// ring's own DrawInstanced wants them, and issues one glMultiDrawArraysIndirect with a
+// command per mesh, each starting at its kind's first instance (baseInstance). Without
+// ARB_multi_draw_indirect and GL 4.2's base instances it falls back to one instanced draw
+// per command, the attributes moved to its kind's instances, still under one texture bind.
+//
+// The shader reads the layer as `layout(location = C_LAYER_LOCATION) in float instanceLayer`
+// and samples texture0 as a sampler2DArray (lighting_layered.vs and .fs); the rest is as
+// InstanceDraw::Submit needs it.
+class MaterialBatch {
+public:
+	static constexpr int C_LAYER_LOCATION = 9;  // past the compact vertex layout's decode attribute
+
+	// `capacity` is the ring's size. False, logged, if the maps can't share an array; the
+	// models can go once Init has returned.
+	bool Init(Model* const* models, int kinds, int capacity) {
+		Unload();
+		std::vector<Texture2D> maps;
+		for (int k = 0; k < kinds; ++k) {
+			const Model& model = *models[k];
+			const int material = (model.meshCount > 0) ? model.meshMaterial[0] : 0;
+			const Texture2D map = model.materials[material].maps[MATERIAL_MAP_DIFFUSE].texture;
+			int layer = 0;
+			while (layer < static_cast<int>(maps.size()) && maps[layer].id != map.id) ++layer;
+			if (layer == static_cast<int>(maps.size())) maps.push_back(map);
+			kindLayers.push_back(static_cast<float>(layer));
+		}
+		if (!LoadLayers(maps)) {
+			Unload();
+			return false;
+		}
+
+		Mesh merged{};
+		for (int k = 0; k < kinds; ++k) {
+			for (int m = 0; m < models[k]->meshCount; ++m) {
+				const Mesh& mesh = models[k]->meshes[m];
+				merged.vertexCount += (mesh.indices != nullptr) ? mesh.triangleCount * 3 : mesh.vertexCount;
+			}
+		}
+		merged.triangleCount = merged.vertexCount / 3;
+		const unsigned int vertices = static_cast<unsigned int>(merged.vertexCount);
+		merged.vertices = static_cast<float*>(MemAlloc(vertices * 3 * sizeof(float)));
+		merged.texcoords = static_cast<float*>(MemAlloc(vertices * 2 * sizeof(float)));  // zeroed
+		merged.normals = static_cast<float*>(MemAlloc(vertices * 3 * sizeof(float)));
+		int at = 0;
+		for (int k = 0; k < kinds; ++k) {
+			for (int m = 0; m < models[k]->meshCount; ++m) {
+				const Mesh& mesh = models[k]->meshes[m];
+				const int corners = (mesh.indices != nullptr) ? mesh.triangleCount * 3 : mesh.vertexCount;
+				ranges.push_back({ k, at, corners });
+				for (int c = 0; c < corners; ++c, ++at) {
+					const int v = (mesh.indices != nullptr) ? mesh.indices[c] : c;
+					memcpy(merged.vertices + at * 3, mesh.vertices + v * 3, 3 * sizeof(float));
+					if (mesh.texcoords) memcpy(merged.texcoords + at * 2, mesh.texcoords + v * 2, 2 * sizeof(float));
+					if (mesh.normals) memcpy(merged.normals + at * 3, mesh.normals + v * 3, 3 * sizeof(float));
+					else merged.normals[at * 3 + 1] = 1.0f;
+				}
+			}
+		}
+		UploadMesh(&merged, false);
+		for (float** data : { &merged.vertices, &merged.texcoords, &merged.normals }) {
+			MemFree(*data);
+			*data = nullptr;
+		}
+		batched = merged;
+
+		instanceLayers.assign(capacity, 0.0f);
+		glGenBuffers(1, &layerBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, layerBuffer);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(instanceLayers.size() * sizeof(float)), instanceLayers.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		multiDraw = GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_VERSION_4_2;
+		if (multiDraw) {
+			glGenBuffers(1, &commandBuffer);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(ranges.size() * sizeof(Command)), nullptr, GL_DYNAMIC_DRAW);
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+		}
+		TraceLog(LOG_INFO, "BATCH: %i model(s), %i mesh(es), %i vertices, %i layer(s) of %ix%i, %s", kinds, static_cast<int>(ranges.size()), merged.vertexCount,
+			static_cast<int>(maps.size()), maps[0].width, maps[0].height, multiDraw ? "one multi-draw" : "one draw per mesh");
+		return true;
+	}
+
+	void Unload() {
+		if (batched.vaoId != 0) UnloadMesh(batched);
+		batched = Mesh{};
+		if (array != 0) glDeleteTextures(1, &array);
+		if (layerBuffer != 0) glDeleteBuffers(1, &layerBuffer);
+		if (commandBuffer != 0) glDeleteBuffers(1, &commandBuffer);
+		array = layerBuffer = commandBuffer = 0;
+		layers = 0;
+		ranges.clear();
+		kindLayers.clear();
+		instanceLayers.clear();
+		first.clear();
+		count.clear();
+	}
+
+	bool Ready() const {
+		return array != 0;
+	}
+
+	// Draws kind k's instances [first[k], first[k] + count[k]) of the ring's frame, all kinds
+	// at once, with `shader`.
+	void Draw(InstanceRing& ring, const Shader& shader, const int* kindFirst, const int* kindCount) {
+		draws = 0;
+		if (!Ready()) return;
+		const size_t kinds = kindLayers.size();
+		if (first.size() != kinds || !std::equal(first.begin(), first.end(), kindFirst) || !std::equal(count.begin(), count.end(), kindCount)) {
+			first.assign(kindFirst, kindFirst + kinds);
+			count.assign(kindCount, kindCount + kinds);
+			for (size_t k = 0; k < kinds; ++k) std::fill_n(instanceLayers.begin() + first[k], count[k], kindLayers[k]);
+			glBindBuffer(GL_ARRAY_BUFFER, layerBuffer);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(instanceLayers.size() * sizeof(float)), instanceLayers.data());
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			if (multiDraw) {
+				std::vector<Command> commands(ranges.size());
+				for (size_t r = 0; r < ranges.size(); ++r) {
+					commands[r].count = static_cast<GLuint>(ranges[r].count);
+					commands[r].instanceCount = static_cast<GLuint>(count[ranges[r].kind]);
+					commands[r].first = static_cast<GLuint>(ranges[r].first);
+					commands[r].baseInstance = static_cast<GLuint>(first[ranges[r].kind]);
+				}
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+				glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, static_cast<GLsizeiptr>(commands.size() * sizeof(Command)), commands.data());
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+			}
+		}
+
+		ring.Seal();
+		MaterialMap maps[InstanceDraw::C_MATERIAL_MAPS] = {};  // no textures: the array is bound below instead
+		maps[MATERIAL_MAP_DIFFUSE].color = WHITE;
+		const Material material{ shader, maps, {} };
+		InstanceDraw::Submit(batched, material, ring.Buffer(), ring.Offset(0), [&]() {
+			rlActiveTextureSlot(0);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+			rlEnableVertexAttribute(C_LAYER_LOCATION);
+			rlSetVertexAttributeDivisor(C_LAYER_LOCATION, 1);
+			if (multiDraw) {
+				rlEnableVertexBuffer(layerBuffer);
+				rlSetVertexAttribute(C_LAYER_LOCATION, 1, RL_FLOAT, false, sizeof(float), nullptr);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+				glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, static_cast<GLsizei>(ranges.size()), 0);
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+				++draws;
+			}
+			else {
+				const unsigned int transform = static_cast<unsigned int>(shader.locs[SHADER_LOC_MATRIX_MODEL]);
+				for (const Range& r : ranges) {
+					if (count[r.kind] <= 0) continue;
+					rlEnableVertexBuffer(layerBuffer);
+					rlSetVertexAttribute(C_LAYER_LOCATION, 1, RL_FLOAT, false, sizeof(float), reinterpret_cast<const void*>(first[r.kind] * sizeof(float)));
+					rlEnableVertexBuffer(ring.Buffer());
+					for (unsigned int column = 0; column < 4; column++) {
+						rlSetVertexAttribute(transform + column, 4, RL_FLOAT, false, InstanceDraw::C_MATRIX_BYTES, reinterpret_cast<const void*>(ring.Offset(first[r.kind]) + column * sizeof(Vector4)));
+					}
+					glDrawArraysInstanced(GL_TRIANGLES, r.first, r.count, count[r.kind]);
+					++draws;
+				}
+			}
+			rlDisableVertexBuffer();
+			rlDisableVertexAttribute(C_LAYER_LOCATION);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+		});
+	}
+
+	// Layers in the texture array.
+	int Layers() const {
+		return layers;
+	}
+
+	// Draw calls in the last Draw(): 1 with multi-draw, else one per mesh with instances.
+	int Draws() const {
+		return draws;
+	}
+
+	bool MultiDraw() const {
+		return multiDraw;
+	}
+
+private:
+	// DrawArraysIndirectCommand
+	struct Command {
+		GLuint count = 0;
+		GLuint instanceCount = 0;
+		GLuint first = 0;
+		GLuint baseInstance = 0;
+	};
+
+	// A source mesh's vertices in the merged one.
+	struct Range {
+		int kind = 0;
+		int first = 0;
+		int count = 0;
+	};
+
+	// One layer per map, copied on the GPU when ARB_copy_image allows, else read back.
+	bool LoadLayers(const std::vector<Texture2D>& maps) {
+		if (maps.empty()) return false;
+		const Texture2D& base = maps[0];
+		for (const Texture2D& map : maps) {
+			if (map.id == 0 || map.width != base.width || map.height != base.height || map.format != base.format || map.format >= PIXELFORMAT_COMPRESSED_DXT1_RGB) {
+				TraceLog(LOG_WARNING, "BATCH: maps must share a size and an uncompressed format (%ix%i format %i against %ix%i format %i)", map.width, map.height, map.format, base.width, base.height, base.format);
+				return false;
+			}
+		}
+		unsigned int internalFormat = 0, format = 0, type = 0;
+		rlGetGlTextureFormats(base.format, &internalFormat, &format, &type);
+		layers = static_cast<int>(maps.size());
+		int levels = 1;
+		while ((base.width >> levels) > 0 || (base.height >> levels) > 0) ++levels;
+
+		glGenTextures(1, &array);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+		for (int l = 0; l < levels; ++l) {
+			glTexImage3D(GL_TEXTURE_2D_ARRAY, l, static_cast<GLint>(internalFormat), std::max(base.width >> l, 1), std::max(base.height >> l, 1), layers, 0, format, type, nullptr);
+		}
+		for (int i = 0; i < layers; ++i) {
+			if (GLAD_GL_ARB_copy_image) {
+				glCopyImageSubData(maps[i].id, GL_TEXTURE_2D, 0, 0, 0, 0, array, GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, base.width, base.height, 1);
+			}
+			else {
+				void* pixels = rlReadTexturePixels(maps[i].id, maps[i].width, maps[i].height, maps[i].format);
+				glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+				glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, base.width, base.height, 1, format, type, pixels);
+				MemFree(pixels);
+			}
+		}
+		glBindTexture(GL_TEXTURE_2D_ARRAY, array);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+		return true;
+	}
+
+	Mesh                  batched{};         // every model's meshes, unindexed, GPU side only
+	std::vector<Range>    ranges;            // per source mesh
+	std::vector<float>    kindLayers;        // per kind
+	std::vector<float>    instanceLayers;    // per ring instance, what layerBuffer holds
+	std::vector<int>      first;             // the ranges instanceLayers was written for
+	std::vector<int>      count;
+	unsigned int          array = 0;
+	unsigned int          layerBuffer = 0;
+	unsigned int          commandBuffer = 0;
+	int                   layers = 0;
+	bool                  multiDraw = false;
+	int                   draws = 0;
+};
+
+#endif // MATERIAL_BATCH_H
@@ -0,0 +1,228 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+
+#include "raylib.h"
+
+// --- MEMORY TRACKER ---
+// Live bytes per subsystem and allocations per frame. Every heap block of the game goes
+// through Allocate()/Free(): main.cpp replaces the global operator new and delete, and
+// Install() routes raylib's RL_MALLOC/RL_FREE here with SetMemoryCallbacks. Each block
+// carries a small header with its size and the tag of the MEMORY_SCOPE that was open on
+// its thread when it was made, so it is credited back to the right subsystem whichever
+// thread frees it; raylib's blocks made outside any scope are tagged RAYLIB. The counters
+// are relaxed atomics, a handful per allocation, so tracking stays on in release builds.
+// BeginFrame() closes the frame's allocation count: in steady-state play it should read
+// zero, anything else is a container growing or a temporary made every frame.
+class MemoryTracker {
+public:
+	enum class Tag : uint8_t {
+		GENERAL, ASTEROIDS, SECTORS, PROJECTILES, SHIPS, COLLISION, PARTICLES, SNAPSHOTS, RENDER, TEXTURES, MESHES, AUDIO, RAYLIB, COUNT
+	};
+	static constexpr int C_TAGS = static_cast<int>(Tag::COUNT);
+
+	struct Stats {
+		size_t   liveBytes;
+		size_t   liveBlocks;
+		size_t   peakBytes;
+		uint64_t allocations;  // since the start
+	};
+
+	static MemoryTracker& Instance() {
+		static MemoryTracker instance;  // constant-initialized: usable by operator new before main
+		return instance;
+	}
+
+	static const char* NameOf(Tag t) {
+		static constexpr const char* names[C_TAGS] = {
+			"general", "asteroids", "sectors", "projectiles", "ships", "collision", "particles", "snapshots", "render",
+			"textures", "meshes", "audio", "raylib"
+		};
+		return names[static_cast<int>(t)];
+	}
+
+	// Hooks raylib's allocator. First thing in main(): what raylib allocated before can't be
+	// freed once it's installed.
+	static void Install() {
+		SetMemoryCallbacks(RaylibAllocate, RaylibReallocate, Free);
+	}
+
+	// The calling thread's tag for new blocks (MemoryScope sets it).
+	static Tag& Current() {
+		static thread_local Tag tag = Tag::GENERAL;
+		return tag;
+	}
+
+	// nullptr when out of memory.
+	static void* Allocate(size_t size, Tag tag = Current()) {
+		if (size > SIZE_MAX - sizeof(Header)) return nullptr;
+		void* raw = malloc(sizeof(Header) + size);
+		if (!raw) return nullptr;
+		Header* h = static_cast<Header*>(raw);
+		h->size = size;
+		h->tag = static_cast<size_t>(tag);
+		Instance().Added(tag, size);
+		return h + 1;
+	}
+
+	static void* Reallocate(void* p, size_t size, Tag tag = Current()) {
+		if (!p) return Allocate(size, tag);
+		if (size == 0) {
+			Free(p);
+			return nullptr;
+		}
+		if (size > SIZE_MAX - sizeof(Header)) return nullptr;
+		Header* h = static_cast<Header*>(p) - 1;
+		const Header old = *h;
+		void* raw = realloc(h, sizeof(Header) + size);
+		if (!raw) return nullptr;
+		h = static_cast<Header*>(raw);
+		h->size = size;
+		Instance().Removed(static_cast<Tag>(old.tag), old.size);
+		Instance().Added(static_cast<Tag>(old.tag), size);  // stays with its subsystem
+		return h + 1;
+	}
+
+	static void Free(void* p) {
+		if (!p) return;
+		Header* h = static_cast<Header*>(p) - 1;
+		Instance().Removed(static_cast<Tag>(h->tag), h->size);
+		free(h);
+	}
+
+	// Once a frame, on the main thread: the allocations since the last call become the
+	// frame's.
+	void BeginFrame() {
+		const uint64_t count = allocations.load(std::memory_order_relaxed);
+		const uint64_t bytes = allocatedBytes.load(std::memory_order_relaxed);
+		frameAllocations = count - frameMark;
+		frameBytes = bytes - frameBytesMark;
+		frameMark = count;
+		frameBytesMark = bytes;
+	}
+
+	// In the last finished frame, from every thread.
+	uint64_t FrameAllocations() const {
+		return frameAllocations;
+	}
+
+	uint64_t FrameBytes() const {
+		return frameBytes;
+	}
+
+	// Since the start, from every thread.
+	uint64_t Allocations() const {
+		return allocations.load(std::memory_order_relaxed);
+	}
+
+	uint64_t AllocatedBytes() const {
+		return allocatedBytes.load(std::memory_order_relaxed);
+	}
+
+	Stats Get(Tag t) const {
+		const Counters& c = counters[static_cast<int>(t)];
+		return { c.bytes.load(std::memory_order_relaxed), c.blocks.load(std::memory_order_relaxed),
+			c.peak.load(std::memory_order_relaxed), c.allocations.load(std::memory_order_relaxed) };
+	}
+
+	size_t LiveBytes() const {
+		size_t n = 0;
+		for (const Counters& c : counters) n += c.bytes.load(std::memory_order_relaxed);
+		return n;
+	}
+
+	// Every subsystem that has allocated anything, to the log.
+	void Report() const {
+		TraceLog(LOG_INFO, "MEMORY: %.2f MB live, %llu allocations last frame", static_cast<double>(LiveBytes()) / (1024.0 * 1024.0),
+			static_cast<unsigned long long>(frameAllocations));
+		for (int t = 0; t < C_TAGS; ++t) {
+			const Stats s = Get(static_cast<Tag>(t));
+			if (s.allocations == 0) continue;
+			TraceLog(LOG_INFO, "MEMORY:   %-12s %10.1f KB live in %6zu blocks, peak %10.1f KB, %8llu allocations",
+				NameOf(static_cast<Tag>(t)), static_cast<double>(s.liveBytes) / 1024.0, s.liveBlocks,
+				static_cast<double>(s.peakBytes) / 1024.0, static_cast<unsigned long long>(s.allocations));
+		}
+	}
+
+private:
+	// Two words keep the block past it aligned as malloc's was.
+	struct Header {
+		size_t size;
+		size_t tag;
+	};
+	static_assert(sizeof(Header) % alignof(std::max_align_t) == 0, "blocks must stay max-aligned");
+
+	struct Counters {
+		std::atomic<size_t>   bytes{ 0 };
+		std::atomic<size_t>   blocks{ 0 };
+		std::atomic<size_t>   peak{ 0 };
+		std::atomic<uint64_t> allocations{ 0 };
+	};
+
+	constexpr MemoryTracker() = default;
+
+	static Tag RaylibTag() {
+		const Tag t = Current();
+		return t == Tag::GENERAL ? Tag::RAYLIB : t;
+	}
+
+	static void* RaylibAllocate(size_t size) {
+		return Allocate(size, RaylibTag());
+	}
+
+	static void* RaylibReallocate(void* p, size_t size) {
+		return Reallocate(p, size, RaylibTag());
+	}
+
+	void Added(Tag t, size_t size) {
+		Counters& c = counters[static_cast<int>(t)];
+		const size_t live = c.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+		c.blocks.fetch_add(1, std::memory_order_relaxed);
+		c.allocations.fetch_add(1, std::memory_order_relaxed);
+		for (size_t peak = c.peak.load(std::memory_order_relaxed); live > peak;) {
+			if (c.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) break;
+		}
+		allocations.fetch_add(1, std::memory_order_relaxed);
+		allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	void Removed(Tag t, size_t size) {
+		Counters& c = counters[static_cast<int>(t)];
+		c.bytes.fetch_sub(size, std::memory_order_relaxed);
+		c.blocks.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	Counters              counters[C_TAGS];
+	std::atomic<uint64_t> allocations{ 0 };     // every thread, since the start
+	std::atomic<uint64_t> allocatedBytes{ 0 };
+	uint64_t              frameMark = 0, frameBytesMark = 0;  // main thread only, from here on
+	uint64_t              frameAllocations = 0, frameBytes = 0;
+};
+
+// Tags the blocks the calling thread allocates until the end of the scope. Jobs a scope
+// hands to the pool run untagged (GENERAL) unless they open a scope of their own.
+class MemoryScope {
+public:
+	explicit MemoryScope(MemoryTracker::Tag tag) : previous(MemoryTracker::Current()) {
+		MemoryTracker::Current() = tag;
+	}
+	~MemoryScope() {
+		MemoryTracker::Current() = previous;
+	}
+
+	MemoryScope(const MemoryScope&) = delete;
+	MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+	MemoryTracker::Tag previous;
+};
+
+#define MEMORY_CONCAT_(a, b) a##b
+#define MEMORY_CONCAT(a, b) MEMORY_CONCAT_(a, b)
+#define MEMORY_SCOPE(tag) MemoryScope MEMORY_CONCAT(memoryScope_, __LINE__)(MemoryTracker::Tag::tag)
+
+#endif // MEMORY_TRACKER_H
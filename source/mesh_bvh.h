@@ -0,0 +1,457 @@
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+
+// --- MESH BVH ---
+// Ray queries against meshes in O(log triangles) rather than GetRayCollisionMesh's test of
+// every triangle, for picking and line of sight:
+//   - MeshBvh: one per mesh, built once at load from its CPU-side data (which LoadModel
+//     keeps); ModelBvh holds one per mesh of a model;
+//   - SceneBvh: a second level over placed meshes, each with its transform, that rays enter
+//     in world space and leave into a mesh's own space.
+// Both levels are built by binned SAH (C_BINS bins per axis, splitting where the expected
+// cost of the children beats a leaf) into flattened nodes: depth-first, a node's left child
+// right after it, the right one by index. Queries walk them front to back, nearer child
+// first, and skip any box past the nearest hit so far. Results are RayCollision, as
+// GetRayCollisionMesh returns: the nearest hit, either face, with the triangle's normal.
+namespace BvhDetail {
+	constexpr int   C_BINS = 12;
+	constexpr int   C_MAX_LEAF = 8;         // a leaf never holds more
+	constexpr float C_TRAVERSE_COST = 1.0f; // relative to one primitive test
+	constexpr int   C_STACK = 128;          // deeper than any tree SAH builds of real meshes
+
+	struct Box {
+		Vector3 min = { INFINITY, INFINITY, INFINITY };
+		Vector3 max = { -INFINITY, -INFINITY, -INFINITY };
+
+		void Grow(Vector3 p) {
+			min = Vector3Min(min, p);
+			max = Vector3Max(max, p);
+		}
+
+		void Grow(const Box& b) {
+			min = Vector3Min(min, b.min);
+			max = Vector3Max(max, b.max);
+		}
+
+		float Area() const {
+			const Vector3 e = Vector3Subtract(max, min);
+			return (e.x < 0.0f) ? 0.0f : 2.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+		}
+
+		Vector3 Centre() const {
+			return Vector3Scale(Vector3Add(min, max), 0.5f);
+		}
+	};
+
+	// 32 bytes. Inner nodes: count 0, `first` the right child. Leaves: `count` primitives
+	// from `first` in build order.
+	struct Node {
+		Vector3 min;
+		int     first;
+		Vector3 max;
+		int     count;
+	};
+
+	inline float Axis(Vector3 v, int axis) {
+		return (axis == 0) ? v.x : (axis == 1 ? v.y : v.z);
+	}
+
+	class Builder {
+	public:
+		Builder(const std::vector<Box>& from, std::vector<Node>& into, std::vector<int>& leafOrder) : boxes(from), nodes(into), order(leafOrder) {
+			order.resize(boxes.size());
+			for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+			nodes.clear();
+			nodes.reserve(boxes.size() * 2);
+			if (!boxes.empty()) Split(0, static_cast<int>(boxes.size()));
+		}
+
+	private:
+		int Split(int first, int count) {
+			const int index = static_cast<int>(nodes.size());
+			nodes.push_back({});
+			Box bounds, centres;
+			for (int i = first; i < first + count; ++i) {
+				bounds.Grow(boxes[order[i]]);
+				centres.Grow(boxes[order[i]].Centre());
+			}
+			nodes[index].min = bounds.min;
+			nodes[index].max = bounds.max;
+
+			int mid = (count > 1) ? Partition(first, count, bounds, centres) : first;
+			if (mid == first) {
+				if (count <= C_MAX_LEAF) {
+					nodes[index].first = first;
+					nodes[index].count = count;
+					return index;
+				}
+				// Too many to leave, too alike to bin (coincident centres): halve by order.
+				mid = first + count / 2;
+			}
+			Split(first, mid - first);
+			const int right = Split(mid, first + count - mid);
+			nodes[index].first = right;
+			nodes[index].count = 0;
+			return index;
+		}
+
+		// The SAH split of [first, first + count), applied; `first` if a leaf is cheaper.
+		int Partition(int first, int count, const Box& bounds, const Box& centres) {
+			float bestCost = static_cast<float>(count);  // as a leaf
+			int bestAxis = -1, bestBin = 0;
+			const float parentArea = std::max(bounds.Area(), 1e-12f);
+			for (int axis = 0; axis < 3; ++axis) {
+				const float lo = Axis(centres.min, axis), hi = Axis(centres.max, axis);
+				if (hi <= lo) continue;
+				const float scale = C_BINS / (hi - lo);
+				Box bins[C_BINS];
+				int counts[C_BINS] = {};
+				for (int i = first; i < first + count; ++i) {
+					const int b = std::min(C_BINS - 1, static_cast<int>((Axis(boxes[order[i]].Centre(), axis) - lo) * scale));
+					bins[b].Grow(boxes[order[i]]);
+					++counts[b];
+				}
+				// Areas and counts left of each plane, then right of it, sweeping.
+				float leftArea[C_BINS - 1];
+				int leftCount[C_BINS - 1];
+				Box acc;
+				int n = 0;
+				for (int b = 0; b < C_BINS - 1; ++b) {
+					acc.Grow(bins[b]);
+					n += counts[b];
+					leftArea[b] = acc.Area();
+					leftCount[b] = n;
+				}
+				acc = Box{};
+				n = 0;
+				for (int b = C_BINS - 1; b > 0; --b) {
+					acc.Grow(bins[b]);
+					n += counts[b];
+					if (n == 0 || leftCount[b - 1] == 0) continue;
+					const float cost = C_TRAVERSE_COST + (leftArea[b - 1] * static_cast<float>(leftCount[b - 1]) + acc.Area() * static_cast<float>(n)) / parentArea;
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestAxis = axis;
+						bestBin = b;
+					}
+				}
+			}
+			if (bestAxis < 0) return first;
+
+			const float lo = Axis(centres.min, bestAxis);
+			const float scale = C_BINS / (Axis(centres.max, bestAxis) - lo);
+			const auto split = std::partition(order.begin() + first, order.begin() + first + count, [&](int p) {
+				return std::min(C_BINS - 1, static_cast<int>((Axis(boxes[p].Centre(), bestAxis) - lo) * scale)) < bestBin;
+			});
+			return static_cast<int>(split - order.begin());
+		}
+
+		const std::vector<Box>& boxes;
+		std::vector<Node>&      nodes;
+		std::vector<int>&       order;
+	};
+
+	// Builds `nodes` over `boxes`; `order` gets the primitives in leaf order.
+	inline void Build(const std::vector<Box>& boxes, std::vector<Node>& nodes, std::vector<int>& order) {
+		Builder build(boxes, nodes, order);
+	}
+
+	// Slab test; the entry distance if the ray meets the box before `maxT`, else INFINITY.
+	inline float Enter(const Node& n, Vector3 origin, Vector3 inv, float maxT) {
+		float t0 = 0.0f, t1 = maxT;
+		const float o[3] = { origin.x, origin.y, origin.z };
+		const float d[3] = { inv.x, inv.y, inv.z };
+		const float lo[3] = { n.min.x, n.min.y, n.min.z };
+		const float hi[3] = { n.max.x, n.max.y, n.max.z };
+		for (int a = 0; a < 3; ++a) {
+			float near = (lo[a] - o[a]) * d[a];
+			float far = (hi[a] - o[a]) * d[a];
+			if (near > far) std::swap(near, far);
+			t0 = near > t0 ? near : t0;  // NaN-safe order: a NaN slab is ignored
+			t1 = far < t1 ? far : t1;
+			if (t0 > t1) return INFINITY;
+		}
+		return t0;
+	}
+
+	// Front-to-back walk: test(primitive, bestT) shortens bestT on a hit and returns true;
+	// with `any`, the first hit ends the walk.
+	template<typename Test>
+	bool Walk(const std::vector<Node>& nodes, Vector3 origin, Vector3 dir, float& bestT, bool any, Test&& test) {
+		if (nodes.empty()) return false;
+		const Vector3 inv = { 1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z };
+		struct Pending {
+			int   node;
+			float t;  // where the ray enters it
+		};
+		Pending stack[C_STACK];
+		int top = 0;
+		const float rootT = Enter(nodes[0], origin, inv, bestT);
+		if (rootT == INFINITY) return false;
+		stack[top++] = { 0, rootT };
+		bool found = false;
+		while (top > 0) {
+			const Pending pending = stack[--top];
+			if (pending.t >= bestT) continue;  // behind a hit found since it was pushed
+			int index = pending.node;
+			for (;;) {
+				const Node& n = nodes[index];
+				if (n.count > 0) {
+					for (int i = n.first; i < n.first + n.count; ++i) {
+						if (test(i, bestT)) {
+							found = true;
+							if (any) return true;
+						}
+					}
+					break;
+				}
+				int nearChild = index + 1, farChild = n.first;
+				float tNear = Enter(nodes[nearChild], origin, inv, bestT);
+				float tFar = Enter(nodes[farChild], origin, inv, bestT);
+				if (tFar < tNear) {
+					std::swap(nearChild, farChild);
+					std::swap(tNear, tFar);
+				}
+				if (tNear == INFINITY) break;
+				if (tFar != INFINITY && top < C_STACK) stack[top++] = { farChild, tFar };
+				index = nearChild;
+			}
+		}
+		return found;
+	}
+}
+
+class MeshBvh {
+public:
+	// From the mesh's vertices and indices, in its own space. An empty mesh builds nothing.
+	void Build(const Mesh& mesh) {
+		tris.clear();
+		nodes.clear();
+		if (mesh.vertices == nullptr || mesh.vertexCount == 0) return;
+		const int count = (mesh.indices != nullptr) ? mesh.triangleCount : mesh.vertexCount / 3;
+		std::vector<Triangle> source(count);
+		std::vector<BvhDetail::Box> boxes(count);
+		auto vertex = [&](int corner) {
+			const int v = (mesh.indices != nullptr) ? mesh.indices[corner] : corner;
+			return Vector3{ mesh.vertices[v * 3 + 0], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2] };
+		};
+		for (int t = 0; t < count; ++t) {
+			const Vector3 a = vertex(t * 3), b = vertex(t * 3 + 1), c = vertex(t * 3 + 2);
+			source[t] = { a, Vector3Subtract(b, a), Vector3Subtract(c, a), t };
+			boxes[t].Grow(a);
+			boxes[t].Grow(b);
+			boxes[t].Grow(c);
+		}
+		std::vector<int> order;
+		BvhDetail::Build(boxes, nodes, order);
+		tris.resize(count);
+		for (int i = 0; i < count; ++i) tris[i] = source[order[i]];
+	}
+
+	bool Empty() const {
+		return nodes.empty();
+	}
+
+	// In the mesh's own space.
+	BoundingBox Bounds() const {
+		if (nodes.empty()) return BoundingBox{};
+		return { nodes[0].min, nodes[0].max };
+	}
+
+	int Triangles() const {
+		return static_cast<int>(tris.size());
+	}
+
+	int Nodes() const {
+		return static_cast<int>(nodes.size());
+	}
+
+	// As GetRayCollisionMesh(ray, mesh, transform), `maxDistance` capping the search.
+	RayCollision Raycast(Ray ray, Matrix transform, float maxDistance = INFINITY, int* triangle = nullptr) const {
+		const Matrix inverse = MatrixInvert(transform);
+		const Vector3 dir = Vector3Normalize(ray.direction);
+		return Local(ray.position, dir, inverse, maxDistance, triangle);
+	}
+
+	// Whether anything is hit within `maxDistance`; stops at the first hit found.
+	bool Occluded(Ray ray, Matrix transform, float maxDistance) const {
+		const Matrix inverse = MatrixInvert(transform);
+		const Vector3 dir = Vector3Normalize(ray.direction);
+		float t = maxDistance;
+		int hit = -1;
+		float u = 0.0f, v = 0.0f;
+		return Walk(Vector3Transform(ray.position, inverse), Direction(dir, inverse), t, true, hit, u, v);
+	}
+
+private:
+	friend class SceneBvh;
+
+	struct Triangle {
+		Vector3 a, e1, e2;  // a corner and the edges from it
+		int     index;      // in the mesh
+	};
+
+	// The direction, with `m`'s linear part only: t stays the same along the ray in both spaces.
+	static Vector3 Direction(Vector3 d, const Matrix& m) {
+		return { m.m0 * d.x + m.m4 * d.y + m.m8 * d.z, m.m1 * d.x + m.m5 * d.y + m.m9 * d.z, m.m2 * d.x + m.m6 * d.y + m.m10 * d.z };
+	}
+
+	// Moller-Trumbore, both faces, as GetRayCollisionTriangle.
+	static bool Intersect(const Triangle& tri, Vector3 origin, Vector3 dir, float& bestT, float& u, float& v) {
+		const Vector3 p = Vector3CrossProduct(dir, tri.e2);
+		const float det = Vector3DotProduct(tri.e1, p);
+		if (det > -EPSILON && det < EPSILON) return false;
+		const float inv = 1.0f / det;
+		const Vector3 s = Vector3Subtract(origin, tri.a);
+		const float bu = Vector3DotProduct(s, p) * inv;
+		if (bu < 0.0f || bu > 1.0f) return false;
+		const Vector3 q = Vector3CrossProduct(s, tri.e1);
+		const float bv = Vector3DotProduct(dir, q) * inv;
+		if (bv < 0.0f || bu + bv > 1.0f) return false;
+		const float t = Vector3DotProduct(tri.e2, q) * inv;
+		if (t <= EPSILON || t >= bestT) return false;
+		bestT = t;
+		u = bu;
+		v = bv;
+		return true;
+	}
+
+	bool Walk(Vector3 origin, Vector3 dir, float& bestT, bool any, int& hit, float& u, float& v) const {
+		return BvhDetail::Walk(nodes, origin, dir, bestT, any, [&](int i, float& t) {
+			if (!Intersect(tris[i], origin, dir, t, u, v)) return false;
+			hit = i;
+			return true;
+		});
+	}
+
+	// `dir` unit, in world space; `inverse` takes world space into the mesh's.
+	RayCollision Local(Vector3 origin, Vector3 dir, const Matrix& inverse, float maxDistance, int* triangle) const {
+		RayCollision result{};
+		result.distance = maxDistance;
+		int hit = -1;
+		float u = 0.0f, v = 0.0f;
+		if (!Walk(Vector3Transform(origin, inverse), Direction(dir, inverse), result.distance, false, hit, u, v)) {
+			result.distance = 0.0f;
+			return result;
+		}
+		const Triangle& tri = tris[hit];
+		const Vector3 n = Vector3CrossProduct(tri.e1, tri.e2);
+		// Normals take the inverse transpose: `inverse`'s rows as columns.
+		result.normal = Vector3Normalize({ inverse.m0 * n.x + inverse.m1 * n.y + inverse.m2 * n.z, inverse.m4 * n.x + inverse.m5 * n.y + inverse.m6 * n.z, inverse.m8 * n.x + inverse.m9 * n.y + inverse.m10 * n.z });
+		result.hit = true;
+		result.point = Vector3Add(origin, Vector3Scale(dir, result.distance));
+		if (triangle != nullptr) *triangle = tri.index;
+		return result;
+	}
+
+	std::vector<Triangle>        tris;   // in leaf order
+	std::vector<BvhDetail::Node> nodes;
+};
+
+// A MeshBvh per mesh of a model, built at load.
+struct ModelBvh {
+	std::vector<MeshBvh> meshes;
+
+	void Build(const Model& model) {
+		meshes.resize(model.meshCount);
+		for (int m = 0; m < model.meshCount; ++m) meshes[m].Build(model.meshes[m]);
+	}
+};
+
+class SceneBvh {
+public:
+	struct Hit {
+		RayCollision collision{};
+		int          id = -1;        // as added
+		int          mesh = -1;      // of that model
+		int          triangle = -1;  // of that mesh
+	};
+
+	void Clear() {
+		instances.clear();
+		nodes.clear();
+	}
+
+	// Every mesh of `model` placed as DrawModel places it with `placed` (model.transform is
+	// applied first), reported with `id`. The BVHs must outlive the scene; Build() after adding.
+	void Add(const ModelBvh& bvh, const Model& model, const Matrix& placed, int id) {
+		const Matrix transform = MatrixMultiply(model.transform, placed);
+		for (size_t m = 0; m < bvh.meshes.size(); ++m) {
+			if (bvh.meshes[m].Empty()) continue;
+			instances.push_back({ &bvh.meshes[m], transform, MatrixInvert(transform), id, static_cast<int>(m) });
+		}
+	}
+
+	void Build() {
+		std::vector<BvhDetail::Box> boxes(instances.size());
+		for (size_t i = 0; i < instances.size(); ++i) {
+			const BoundingBox b = instances[i].bvh->Bounds();
+			for (int corner = 0; corner < 8; ++corner) {
+				const Vector3 p = { (corner & 1) ? b.max.x : b.min.x, (corner & 2) ? b.max.y : b.min.y, (corner & 4) ? b.max.z : b.min.z };
+				boxes[i].Grow(Vector3Transform(p, instances[i].transform));
+			}
+		}
+		std::vector<int> order;
+		BvhDetail::Build(boxes, nodes, order);
+		std::vector<Instance> sorted(instances.size());
+		for (size_t i = 0; i < order.size(); ++i) sorted[i] = instances[order[i]];
+		instances = std::move(sorted);
+	}
+
+	int Instances() const {
+		return static_cast<int>(instances.size());
+	}
+
+	// The nearest hit on any instance within `maxDistance`.
+	Hit Raycast(Ray ray, float maxDistance = INFINITY) const {
+		Hit best;
+		const Vector3 dir = Vector3Normalize(ray.direction);
+		float bestT = maxDistance;
+		BvhDetail::Walk(nodes, ray.position, dir, bestT, false, [&](int i, float& t) {
+			const Instance& inst = instances[i];
+			int triangle = -1;
+			const RayCollision c = inst.bvh->Local(ray.position, dir, inst.inverse, t, &triangle);
+			if (!c.hit) return false;
+			t = c.distance;
+			best = { c, inst.id, inst.mesh, triangle };
+			return true;
+		});
+		return best;
+	}
+
+	// Line of sight: whether anything lies between `from` and `to`.
+	bool Occluded(Vector3 from, Vector3 to) const {
+		const Vector3 span = Vector3Subtract(to, from);
+		const float length = Vector3Length(span);
+		if (length <= 0.0f) return false;
+		const Vector3 dir = Vector3Scale(span, 1.0f / length);
+		float bestT = length;
+		return BvhDetail::Walk(nodes, from, dir, bestT, true, [&](int i, float& t) {
+			const Instance& inst = instances[i];
+			int hit = -1;
+			float u = 0.0f, v = 0.0f;
+			return inst.bvh->Walk(Vector3Transform(from, inst.inverse), MeshBvh::Direction(dir, inst.inverse), t, true, hit, u, v);
+		});
+	}
+
+private:
+	struct Instance {
+		const MeshBvh* bvh;
+		Matrix         transform;
+		Matrix         inverse;
+		int            id;
+		int            mesh;
+	};
+
+	std::vector<Instance>        instances;  // in leaf order
+	std::vector<BvhDetail::Node> nodes;
+};
+
+#endif // MESH_BVH_H
@@ -0,0 +1,281 @@
+#ifndef MESH_OPTIMIZE_H
+#define MESH_OPTIMIZE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "raylib.h"
+
+// --- MESH OPTIMIZATION ---
+// Post-load clean-up for meshes that arrive as triangle soup, as LoadModel's OBJ path
+// produces: every corner its own vertex. Four steps, in this order:
+//   1. weld: corners whose attributes are identical, bit for bit, become one vertex;
+//   2. index: the triangles refer to the welded vertices through an index buffer;
+//   3. triangle order: Forsyth's linear-speed vertex cache optimisation, so a vertex's
+//      triangles are drawn while it is still in the post-transform cache;
+//   4. vertex order: vertices renumbered in order of first use, so fetches walk the
+//      vertex buffers forwards.
+// raylib's Mesh holds 16-bit indices only; a mesh that welds to more than 65535 vertices is
+// left as it is. Skinned meshes are skipped too, their bone data not being rewritten here.
+namespace MeshOptimize {
+	struct Stats {
+		int   verticesBefore = 0;
+		int   verticesAfter = 0;
+		float acmrBefore = 0.0f;  // average cache misses per triangle, C_SIMULATED_CACHE FIFO
+		float acmrAfter = 0.0f;
+	};
+
+	namespace Detail {
+		constexpr int   C_CACHE = 32;           // Forsyth's modelled LRU cache
+		constexpr float C_LAST_TRIANGLE = 0.75f;
+		constexpr float C_CACHE_DECAY = 1.5f;
+		constexpr float C_VALENCE_SCALE = 2.0f;
+		constexpr float C_VALENCE_POWER = -0.5f;
+		constexpr int   C_SIMULATED_CACHE = 16;  // typical post-transform FIFO, for Stats only
+
+		// How much drawing a triangle of this vertex next is worth.
+		inline float VertexScore(int cachePosition, int remaining) {
+			if (remaining == 0) return -1.0f;
+			float score = 0.0f;
+			if (cachePosition >= 3) score = powf(1.0f - static_cast<float>(cachePosition - 3) / (C_CACHE - 3), C_CACHE_DECAY);
+			else if (cachePosition >= 0) score = C_LAST_TRIANGLE;  // the triangle just drawn: don't favour it over its neighbours
+			return score + C_VALENCE_SCALE * powf(static_cast<float>(remaining), C_VALENCE_POWER);
+		}
+
+		inline float CacheMisses(const std::vector<unsigned int>& indices, int vertexCount) {
+			std::vector<int> stamp(vertexCount, -C_SIMULATED_CACHE - 1);
+			int misses = 0;
+			for (unsigned int v : indices) {
+				if (misses - stamp[v] > C_SIMULATED_CACHE) stamp[v] = misses++;  // FIFO: hits don't refresh
+			}
+			return indices.empty() ? 0.0f : static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+		}
+
+		// Reorders the triangles of `indices` in place.
+		inline void OrderTriangles(std::vector<unsigned int>& indices, int vertexCount) {
+			const int triangles = static_cast<int>(indices.size() / 3);
+			std::vector<int> remaining(vertexCount, 0);
+			for (unsigned int v : indices) ++remaining[v];
+			std::vector<int> first(vertexCount + 1, 0);  // each vertex's triangles, as a CSR list
+			for (int v = 0; v < vertexCount; ++v) first[v + 1] = first[v] + remaining[v];
+			std::vector<int> adjacency(indices.size());
+			std::vector<int> fill(first.begin(), first.end() - 1);
+			for (int t = 0; t < triangles; ++t) {
+				for (int c = 0; c < 3; ++c) adjacency[fill[indices[t * 3 + c]]++] = t;
+			}
+
+			std::vector<int> position(vertexCount, -1);
+			std::vector<float> vertexScore(vertexCount);
+			for (int v = 0; v < vertexCount; ++v) vertexScore[v] = VertexScore(-1, remaining[v]);
+			std::vector<char> drawn(triangles, 0);
+
+			std::vector<unsigned int> ordered;
+			ordered.reserve(indices.size());
+			std::vector<int> cache, next;
+			cache.reserve(C_CACHE + 3);
+			next.reserve(C_CACHE + 3);
+			int best = -1;
+			int scan = 0;  // no candidate in the cache: fall back to the first undrawn triangle
+			for (int emitted = 0; emitted < triangles; ++emitted) {
+				if (best < 0) {
+					while (drawn[scan]) ++scan;
+					best = scan;
+				}
+				const int t = best;
+				drawn[t] = 1;
+				for (int c = 0; c < 3; ++c) {
+					const unsigned int v = indices[t * 3 + c];
+					ordered.push_back(v);
+					// Take t out of v's live list.
+					int* list = &adjacency[first[v]];
+					const int live = remaining[v];
+					for (int i = 0; i < live; ++i) {
+						if (list[i] == t) {
+							std::swap(list[i], list[live - 1]);
+							break;
+						}
+					}
+					--remaining[v];
+				}
+
+				// LRU update: t's corners to the front.
+				next.clear();
+				for (int c = 0; c < 3; ++c) next.push_back(static_cast<int>(indices[t * 3 + c]));
+				for (int v : cache) {
+					if (v != next[0] && v != next[1] && v != next[2]) next.push_back(v);
+				}
+				for (size_t i = 0; i < next.size(); ++i) {
+					const int v = next[i];
+					position[v] = (i < C_CACHE) ? static_cast<int>(i) : -1;
+					vertexScore[v] = VertexScore(position[v], remaining[v]);
+				}
+				if (next.size() > C_CACHE) next.resize(C_CACHE);
+				cache.swap(next);
+
+				// Rescore the triangles around the cache and pick the best.
+				best = -1;
+				float bestScore = -1.0f;
+				for (int v : cache) {
+					for (int i = 0; i < remaining[v]; ++i) {
+						const int u = adjacency[first[v] + i];
+						const float s = vertexScore[indices[u * 3]] + vertexScore[indices[u * 3 + 1]] + vertexScore[indices[u * 3 + 2]];
+						if (s > bestScore) {
+							bestScore = s;
+							best = u;
+						}
+					}
+				}
+			}
+			indices.swap(ordered);
+		}
+
+		// Bitwise hash and equality of vertices, across every attribute the mesh has.
+		struct VertexKey {
+			const Mesh* mesh;
+
+			size_t operator()(int v) const {
+				uint64_t h = 1469598103934665603ull;  // FNV-1a
+				Each([&](const auto* array, int components) {
+					const unsigned char* p = reinterpret_cast<const unsigned char*>(&array[v * components]);
+					for (size_t i = 0; i < components * sizeof(*array); ++i) h = (h ^ p[i]) * 1099511628211ull;
+					return true;
+				});
+				return static_cast<size_t>(h);
+			}
+
+			bool operator()(int a, int b) const {
+				return Each([&](const auto* array, int components) {
+					return memcmp(&array[a * components], &array[b * components], components * sizeof(*array)) == 0;
+				});
+			}
+
+			// Visits each present attribute until `visit` returns false.
+			template<typename F>
+			bool Each(F&& visit) const {
+				return (!mesh->vertices || visit(mesh->vertices, 3))
+					&& (!mesh->texcoords || visit(mesh->texcoords, 2))
+					&& (!mesh->normals || visit(mesh->normals, 3))
+					&& (!mesh->colors || visit(mesh->colors, 4))
+					&& (!mesh->tangents || visit(mesh->tangents, 4))
+					&& (!mesh->texcoords2 || visit(mesh->texcoords2, 2));
+			}
+		};
+
+		template<typename T>
+		T* Gather(const T* source, int components, const std::vector<int>& from) {
+			if (!source) return nullptr;
+			T* out = static_cast<T*>(MemAlloc(static_cast<unsigned int>(from.size() * components * sizeof(T))));
+			for (size_t i = 0; i < from.size(); ++i) std::copy_n(&source[from[i] * components], components, &out[i * components]);
+			return out;
+		}
+
+		// The CPU half of Optimize: `out` gets fresh arrays, nothing is uploaded. False when
+		// the mesh is left as it is.
+		inline bool Rebuild(const Mesh& mesh, Mesh& out, Stats& stats) {
+			stats.verticesBefore = stats.verticesAfter = mesh.vertexCount;
+			if (mesh.vertices == nullptr || mesh.vertexCount == 0 || mesh.animVertices != nullptr || mesh.boneIds != nullptr) return false;
+
+			// The corners, as they come.
+			std::vector<unsigned int> indices;
+			if (mesh.indices != nullptr) indices.assign(mesh.indices, mesh.indices + mesh.triangleCount * 3);
+			else for (int v = 0; v < mesh.vertexCount; ++v) indices.push_back(static_cast<unsigned int>(v));
+			stats.acmrBefore = CacheMisses(indices, mesh.vertexCount);
+
+			// 1-2. Weld; `welded` maps every source vertex to its first identical one.
+			std::unordered_map<int, int, VertexKey, VertexKey> unique(static_cast<size_t>(mesh.vertexCount), VertexKey{ &mesh }, VertexKey{ &mesh });
+			std::vector<int> representative;  // welded vertex -> a source vertex
+			std::vector<unsigned int> welded(mesh.vertexCount);
+			for (int v = 0; v < mesh.vertexCount; ++v) {
+				auto [it, inserted] = unique.try_emplace(v, static_cast<int>(representative.size()));
+				if (inserted) representative.push_back(v);
+				welded[v] = static_cast<unsigned int>(it->second);
+			}
+			const int vertexCount = static_cast<int>(representative.size());
+			if (vertexCount > 65535) {
+				TraceLog(LOG_WARNING, "MESH: %i vertices after welding, too many for 16-bit indices; left unoptimised", vertexCount);
+				return false;
+			}
+			// Triangles that welded to a line or a point draw nothing.
+			size_t kept = 0;
+			for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+				const unsigned int a = welded[indices[t]], b = welded[indices[t + 1]], c = welded[indices[t + 2]];
+				if (a == b || b == c || a == c) continue;
+				indices[kept++] = a;
+				indices[kept++] = b;
+				indices[kept++] = c;
+			}
+			indices.resize(kept);
+
+			// 3. Triangle order.
+			OrderTriangles(indices, vertexCount);
+
+			// 4. Vertex order: first use.
+			std::vector<int> renumber(vertexCount, -1);
+			std::vector<int> from;  // new vertex -> source vertex
+			from.reserve(vertexCount);
+			for (unsigned int& i : indices) {
+				if (renumber[i] < 0) {
+					renumber[i] = static_cast<int>(from.size());
+					from.push_back(representative[i]);
+				}
+				i = static_cast<unsigned int>(renumber[i]);
+			}
+
+			out = Mesh{};
+			out.vertexCount = static_cast<int>(from.size());
+			out.triangleCount = static_cast<int>(indices.size() / 3);
+			out.vertices = Gather(mesh.vertices, 3, from);
+			out.texcoords = Gather(mesh.texcoords, 2, from);
+			out.normals = Gather(mesh.normals, 3, from);
+			out.colors = Gather(mesh.colors, 4, from);
+			out.tangents = Gather(mesh.tangents, 4, from);
+			out.texcoords2 = Gather(mesh.texcoords2, 2, from);
+			out.indices = static_cast<unsigned short*>(MemAlloc(static_cast<unsigned int>(indices.size() * sizeof(unsigned short))));
+			for (size_t i = 0; i < indices.size(); ++i) out.indices[i] = static_cast<unsigned short>(indices[i]);
+
+			stats.verticesAfter = out.vertexCount;
+			stats.acmrAfter = CacheMisses(indices, out.vertexCount);
+			return true;
+		}
+	}
+
+	// Optimises `mesh` in place: its CPU arrays are rebuilt and it is uploaded again.
+	inline Stats Optimize(Mesh& mesh) {
+		Stats stats;
+		Mesh out{};
+		if (!Detail::Rebuild(mesh, out, stats)) {
+			stats.acmrAfter = stats.acmrBefore;
+			return stats;
+		}
+		UnloadMesh(mesh);
+		UploadMesh(&out, false);
+		mesh = out;
+		return stats;
+	}
+
+	// Every mesh of `model`; the stats are summed, the ratios weighted by triangles.
+	inline Stats Optimize(Model& model) {
+		Stats total;
+		float trianglesBefore = 0.0f, trianglesAfter = 0.0f;
+		for (int m = 0; m < model.meshCount; ++m) {
+			const float before = static_cast<float>(model.meshes[m].triangleCount);
+			const Stats s = Optimize(model.meshes[m]);
+			const float after = static_cast<float>(model.meshes[m].triangleCount);
+			total.verticesBefore += s.verticesBefore;
+			total.verticesAfter += s.verticesAfter;
+			total.acmrBefore += s.acmrBefore * before;
+			total.acmrAfter += s.acmrAfter * after;
+			trianglesBefore += before;
+			trianglesAfter += after;
+		}
+		if (trianglesBefore > 0.0f) total.acmrBefore /= trianglesBefore;
+		if (trianglesAfter > 0.0f) total.acmrAfter /= trianglesAfter;
+		return total;
+	}
+}
+
+#endif // MESH_OPTIMIZE_H
@@ -0,0 +1,446 @@
+#ifndef MESHLETS_H
+#define MESHLETS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "asset_cache.h"
+#include "instance_culling.h"
+#include "simd_vector.h"
+
+// --- MESHLETS ---
+// Dense meshes split into clusters of at most C_MAX_TRIANGLES triangles over C_MAX_VERTICES
+// distinct positions, each bounded by a sphere and a normal cone, so that whole clusters no
+// pixel can show are dropped before their triangles are submitted:
+//   - frustum: the sphere outside any plane of the view;
+//   - back faces: every normal within the cone's spread of its axis, and the eye behind all
+//     of them from every point of the sphere, so GL would cull each triangle anyway.
+// Build() grows a cluster from a seed triangle, adding the neighbour that shares the most of
+// its corners and faces most like it, until either limit or until no neighbour faces within
+// C_MIN_FACING of it: a narrow cone is what lets a cluster be culled, so hard-surface models
+// split finer than smooth ones. Neighbours share positions, not vertices, so seams in
+// normals or UVs (or a mesh with no shared vertices at all) don't split the surface. The next
+// seed is left over from the previous cluster's edge, else the next unused triangle in Morton
+// order of the centres. Load() cooks the clusters into the asset cache, keyed by the model's
+// source file: built on the first run, mapped after that. Only meshes with 16-bit indices
+// (all MeshOptimize indexes) are split.
+namespace Meshlets {
+	constexpr int      C_MAX_VERTICES = 64;
+	constexpr int      C_MAX_TRIANGLES = 124;
+	constexpr int      C_LOOSE_TRIANGLES = 8;    // clusters this small take any neighbour
+	constexpr float    C_MIN_FACING = 0.8f;      // larger ones only triangles facing this close to theirs (cosine)
+	constexpr float    C_FACING_WEIGHT = 4.0f;   // against one shared corner
+	constexpr uint32_t C_VERSION = 1;
+
+	struct Meshlet {
+		Vector3  centre;     // bounding sphere, in the mesh's space
+		float    radius;
+		Vector3  axis;       // normal cone: no triangle's normal further than acos(cosSpread) away
+		float    cosSpread;  // 0 or less: too wide to ever face away as a whole
+		uint32_t first;      // into Clusters::indices
+		uint32_t count;      // indices, three per triangle
+	};
+
+	// One mesh's clusters, and its triangles reordered cluster by cluster.
+	struct Clusters {
+		std::vector<Meshlet>        meshlets;
+		std::vector<unsigned short> indices;
+	};
+
+	// Whether the eye sees every triangle of `m` from behind: even the cone normal nearest to
+	// facing it, at the sphere's nearest point, still faces away.
+	inline bool BackFacing(const Meshlet& m, Vector3 eye) {
+		if (m.cosSpread <= 0.0f) return false;
+		const Vector3 v = Vector3Subtract(m.centre, eye);
+		const float along = Vector3DotProduct(v, m.axis);
+		const float across = sqrtf(std::max(Vector3DotProduct(v, v) - along * along, 0.0f));
+		const float sinSpread = sqrtf(std::max(1.0f - m.cosSpread * m.cosSpread, 0.0f));
+		return along * m.cosSpread - across * sinSpread >= m.radius;
+	}
+
+	namespace Detail {
+		constexpr uint32_t C_KIND = 0x200u | (C_VERSION << 4);
+
+		// Per mesh, after the header; a mesh that isn't split has no meshlets.
+		struct Record {
+			int32_t  triangleCount;
+			int32_t  meshletCount;
+			uint64_t indexHash;  // of the mesh's own indices, which the clusters reorder
+			uint64_t meshlets;
+			uint64_t indices;
+		};
+
+		// FNV-1a, so clusters cooked for other indices (a changed MeshOptimize) rebuild.
+		inline uint64_t IndexHash(const Mesh& mesh) {
+			uint64_t h = 14695981039346656037ull;
+			if (mesh.indices == nullptr) return h;
+			const unsigned char* p = reinterpret_cast<const unsigned char*>(mesh.indices);
+			for (size_t i = 0; i < static_cast<size_t>(mesh.triangleCount) * 3 * sizeof(unsigned short); ++i) h = (h ^ p[i]) * 1099511628211ull;
+			return h;
+		}
+
+		inline void Cook(uint64_t key, const Model& model, const std::vector<Clusters>& clusters) {
+			using namespace AssetCache::Detail;
+			Writer w;
+			w.Put(MakeHeader(key, static_cast<Kind>(C_KIND), static_cast<uint32_t>(model.meshCount), 0));
+			const size_t records = w.AppendAligned(nullptr, 0);
+			w.bytes.resize(records + sizeof(Record) * model.meshCount);
+			for (int m = 0; m < model.meshCount; ++m) {
+				const Clusters& c = clusters[m];
+				Record r{};
+				r.triangleCount = model.meshes[m].triangleCount;
+				r.meshletCount = static_cast<int32_t>(c.meshlets.size());
+				r.indexHash = IndexHash(model.meshes[m]);
+				if (!c.meshlets.empty()) {
+					r.meshlets = w.AppendAligned(c.meshlets.data(), c.meshlets.size() * sizeof(Meshlet));
+					r.indices = w.AppendAligned(c.indices.data(), c.indices.size() * sizeof(unsigned short));
+				}
+				memcpy(w.bytes.data() + records + sizeof(Record) * m, &r, sizeof(Record));
+			}
+			if (w.Save(key)) TraceLog(LOG_INFO, "MESHLETS: cooked %i mesh(es) into %s (%i bytes)", model.meshCount, PathOf(key).c_str(), static_cast<int>(w.bytes.size()));
+		}
+
+		// False unless every mesh's record is there and matches its indices.
+		inline bool Read(uint64_t key, const Model& model, std::vector<Clusters>& clusters) {
+			using namespace AssetCache::Detail;
+			MappedFile file(PathOf(key).c_str());
+			const Header* h = Check(file, key, static_cast<Kind>(C_KIND));
+			if (h == nullptr || h->count != static_cast<uint32_t>(model.meshCount)) return false;
+			const size_t records = RecordsOffset(sizeof(Header));
+			if (!file.Contains(records, sizeof(Record) * static_cast<uint64_t>(model.meshCount))) return false;
+			clusters.assign(model.meshCount, Clusters{});
+			for (int m = 0; m < model.meshCount; ++m) {
+				Record r;
+				memcpy(&r, file.Data() + records + sizeof(Record) * m, sizeof(Record));
+				if (r.triangleCount != model.meshes[m].triangleCount || r.indexHash != IndexHash(model.meshes[m]) || r.meshletCount < 0) return false;
+				if (r.meshletCount == 0) continue;
+				const uint64_t indexBytes = static_cast<uint64_t>(r.triangleCount) * 3 * sizeof(unsigned short);
+				const uint64_t meshletBytes = static_cast<uint64_t>(r.meshletCount) * sizeof(Meshlet);
+				if (!file.Contains(r.meshlets, meshletBytes) || !file.Contains(r.indices, indexBytes)) return false;
+				Clusters& c = clusters[m];
+				c.meshlets.resize(static_cast<size_t>(r.meshletCount));
+				c.indices.resize(static_cast<size_t>(r.triangleCount) * 3);
+				memcpy(c.meshlets.data(), file.Data() + r.meshlets, static_cast<size_t>(meshletBytes));
+				memcpy(c.indices.data(), file.Data() + r.indices, static_cast<size_t>(indexBytes));
+			}
+			return true;
+		}
+	}
+
+	inline Clusters Build(const Mesh& mesh) {
+		Clusters out;
+		if (mesh.indices == nullptr || mesh.vertices == nullptr || mesh.triangleCount <= 0) return out;
+		const int triangles = mesh.triangleCount;
+		const int vertices = mesh.vertexCount;
+		const unsigned short* idx = mesh.indices;
+		auto position = [&](int v) { return Vector3{ mesh.vertices[v * 3], mesh.vertices[v * 3 + 1], mesh.vertices[v * 3 + 2] }; };
+
+		// Corners as positions: vertices at the same place, bit for bit, are one.
+		std::vector<int> corner(static_cast<size_t>(triangles) * 3);
+		int positions = 0;
+		{
+			std::vector<int> positionOf(vertices, -1);
+			std::unordered_map<uint64_t, std::vector<int>> buckets;
+			for (int v = 0; v < vertices; ++v) {
+				uint32_t bits[3];
+				memcpy(bits, &mesh.vertices[v * 3], sizeof(bits));
+				const uint64_t hash = (static_cast<uint64_t>(bits[0]) * 73856093u) ^ (static_cast<uint64_t>(bits[1]) * 19349663u) ^ (static_cast<uint64_t>(bits[2]) * 83492791u);
+				std::vector<int>& bucket = buckets[hash];
+				for (int other : bucket) {
+					if (memcmp(&mesh.vertices[other * 3], &mesh.vertices[v * 3], sizeof(bits)) == 0) positionOf[v] = positionOf[other];
+				}
+				if (positionOf[v] >= 0) continue;
+				positionOf[v] = positions++;
+				bucket.push_back(v);
+			}
+			for (int i = 0; i < triangles * 3; ++i) corner[i] = positionOf[idx[i]];
+		}
+
+		// Each position's triangles, packed.
+		std::vector<int> firstOf(static_cast<size_t>(positions) + 1, 0);
+		for (int i = 0; i < triangles * 3; ++i) ++firstOf[corner[i] + 1];
+		for (int v = 0; v < positions; ++v) firstOf[v + 1] += firstOf[v];
+		std::vector<int> fill(firstOf.begin(), firstOf.end() - 1);
+		std::vector<int> triangleOf(static_cast<size_t>(triangles) * 3);
+		for (int i = 0; i < triangles * 3; ++i) triangleOf[fill[corner[i]]++] = i / 3;
+
+		std::vector<Vector3> normals(triangles);  // zero for degenerate triangles
+		for (int t = 0; t < triangles; ++t) {
+			const Vector3 a = position(idx[t * 3]);
+			const Vector3 n = Vector3CrossProduct(Vector3Subtract(position(idx[t * 3 + 1]), a), Vector3Subtract(position(idx[t * 3 + 2]), a));
+			const float length = Vector3Length(n);
+			normals[t] = (length > 0.0f) ? Vector3Scale(n, 1.0f / length) : Vector3Zero();
+		}
+
+		// Seeds when a cluster's edge runs dry: triangles by the Morton code of their centres.
+		std::vector<int> seeds(triangles);
+		{
+			const BoundingBox bounds = GetMeshBoundingBox(mesh);
+			const Vector3 size = Vector3Subtract(bounds.max, bounds.min);
+			const float scale = 1023.0f / std::max({ size.x, size.y, size.z, 1e-6f });
+			auto spread = [](uint32_t x) {
+				x &= 0x3ffu;
+				x = (x | (x << 16)) & 0x030000ffu;
+				x = (x | (x << 8)) & 0x0300f00fu;
+				x = (x | (x << 4)) & 0x030c30c3u;
+				return (x | (x << 2)) & 0x09249249u;
+			};
+			std::vector<uint32_t> codes(triangles);
+			for (int t = 0; t < triangles; ++t) {
+				const Vector3 c = Vector3Scale(Vector3Add(Vector3Add(position(idx[t * 3]), position(idx[t * 3 + 1])), position(idx[t * 3 + 2])), 1.0f / 3.0f);
+				const Vector3 q = Vector3Scale(Vector3Subtract(c, bounds.min), scale);
+				codes[t] = spread(static_cast<uint32_t>(q.x)) | (spread(static_cast<uint32_t>(q.y)) << 1) | (spread(static_cast<uint32_t>(q.z)) << 2);
+				seeds[t] = t;
+			}
+			std::stable_sort(seeds.begin(), seeds.end(), [&](int a, int b) { return codes[a] < codes[b]; });
+		}
+
+		std::vector<unsigned char> used(triangles, 0);
+		std::vector<int> vertexIn(positions, -1);  // the cluster holding a position
+		std::vector<int> queuedIn(triangles, -1);  // the cluster whose edge a triangle is on
+		std::vector<int> edge;
+		std::vector<int> members;
+		int cursor = 0;
+		for (int done = 0; done < triangles;) {
+			const int id = static_cast<int>(out.meshlets.size());
+			int t = -1;
+			for (int e : edge) {
+				if (!used[e]) {
+					t = e;
+					break;
+				}
+			}
+			edge.clear();
+			if (t < 0) {
+				while (used[seeds[cursor]]) ++cursor;
+				t = seeds[cursor];
+			}
+
+			members.clear();
+			int vertexCount = 0;
+			Vector3 facing = Vector3Zero();
+			while (t >= 0) {
+				used[t] = 1;
+				++done;
+				members.push_back(t);
+				facing = Vector3Add(facing, normals[t]);
+				for (int c = 0; c < 3; ++c) {
+					const int v = corner[t * 3 + c];
+					if (vertexIn[v] == id) continue;
+					vertexIn[v] = id;
+					++vertexCount;
+					for (int k = firstOf[v]; k < firstOf[v + 1]; ++k) {
+						const int n = triangleOf[k];
+						if (used[n] || queuedIn[n] == id) continue;
+						queuedIn[n] = id;
+						edge.push_back(n);
+					}
+				}
+				if (static_cast<int>(members.size()) == C_MAX_TRIANGLES) break;
+
+				t = -1;
+				float best = -INFINITY;
+				const Vector3 direction = Vector3Normalize(facing);
+				for (size_t k = 0; k < edge.size();) {
+					const int n = edge[k];
+					if (used[n]) {
+						edge[k] = edge.back();
+						edge.pop_back();
+						continue;
+					}
+					++k;
+					int shared = 0;
+					for (int c = 0; c < 3; ++c) shared += (vertexIn[corner[n * 3 + c]] == id) ? 1 : 0;
+					if (vertexCount + 3 - shared > C_MAX_VERTICES) continue;
+					const float facingDot = Vector3DotProduct(normals[n], direction);
+					if (static_cast<int>(members.size()) >= C_LOOSE_TRIANGLES && facingDot < C_MIN_FACING) continue;
+					const float score = static_cast<float>(shared) + facingDot * C_FACING_WEIGHT;
+					if (score > best) {
+						best = score;
+						t = n;
+					}
+				}
+			}
+
+			Meshlet m{};
+			m.first = static_cast<uint32_t>(out.indices.size());
+			m.count = static_cast<uint32_t>(members.size()) * 3;
+			Vector3 lo = position(idx[members[0] * 3]);
+			Vector3 hi = lo;
+			for (int tri : members) {
+				for (int c = 0; c < 3; ++c) {
+					out.indices.push_back(idx[tri * 3 + c]);
+					lo = Vector3Min(lo, position(idx[tri * 3 + c]));
+					hi = Vector3Max(hi, position(idx[tri * 3 + c]));
+				}
+			}
+			m.centre = Vector3Scale(Vector3Add(lo, hi), 0.5f);
+			for (uint32_t i = m.first; i < m.first + m.count; ++i) m.radius = std::max(m.radius, Vector3Distance(m.centre, position(out.indices[i])));
+			m.cosSpread = -1.0f;
+			if (Vector3Length(facing) > 1e-6f) {
+				m.axis = Vector3Normalize(facing);
+				m.cosSpread = 1.0f;
+				for (int tri : members) {
+					if (normals[tri].x != 0.0f || normals[tri].y != 0.0f || normals[tri].z != 0.0f) m.cosSpread = std::min(m.cosSpread, Vector3DotProduct(m.axis, normals[tri]));
+				}
+			}
+			out.meshlets.push_back(m);
+		}
+		return out;
+	}
+
+	// Clusters for every mesh of `model` loaded from `fileName`: mapped from the asset cache,
+	// or built and cooked there. Meshes without 16-bit indices get none.
+	inline std::vector<Clusters> Load(const char* fileName, const Model& model) {
+		const uint64_t key = AssetCache::Detail::Key(fileName, Detail::C_KIND);
+		std::vector<Clusters> clusters;
+		if (Detail::Read(key, model, clusters)) {
+			TraceLog(LOG_INFO, "MESHLETS: %s mapped from %s", fileName, AssetCache::Detail::PathOf(key).c_str());
+			return clusters;
+		}
+		const double start = GetTime();
+		clusters.assign(model.meshCount, Clusters{});
+		int meshlets = 0;
+		for (int m = 0; m < model.meshCount; ++m) {
+			clusters[m] = Build(model.meshes[m]);
+			meshlets += static_cast<int>(clusters[m].meshlets.size());
+		}
+		TraceLog(LOG_INFO, "MESHLETS: %s split into %i meshlet(s) in %.1f ms", fileName, meshlets, (GetTime() - start) * 1000.0);
+		Detail::Cook(key, model, clusters);
+		return clusters;
+	}
+}
+
+// Per frame, Cull() copies the indices of the clusters that survive into the front of each
+// mesh's own index buffer; between Begin() and End() the model's meshes draw only that
+// part, through DrawModel or anything that calls it. The buffer always holds every triangle,
+// cluster order, after Init() and Uncull().
+class MeshletCuller {
+public:
+	struct Stats {
+		int   meshlets = 0;
+		int   visible = 0;
+		int   outside = 0;     // of the frustum
+		int   backFacing = 0;
+		int   triangles = 0;
+		int   drawn = 0;       // triangles
+		float cullMs = 0.0f;
+	};
+
+	void Init(const char* fileName, const Model& model) {
+		clusters = Meshlets::Load(fileName, model);
+		spheres.assign(model.meshCount, Spheres{});
+		for (int m = 0; m < model.meshCount; ++m) {
+			for (const Meshlets::Meshlet& meshlet : clusters[m].meshlets) {
+				spheres[m].x.push_back(meshlet.centre.x);
+				spheres[m].y.push_back(meshlet.centre.y);
+				spheres[m].z.push_back(meshlet.centre.z);
+				spheres[m].r.push_back(meshlet.radius);
+			}
+		}
+		drawn.assign(model.meshCount, 0);
+		saved.assign(model.meshCount, 0);
+		Uncull(model);
+	}
+
+	// `transform` places the model as drawn (model.transform included); `eye` in the same
+	// space as the view. Any affine transform: both tests run in the mesh's space.
+	void Cull(const Model& model, const Matrix& transform, const Matrix& viewProjection, Vector3 eye) {
+		using Clock = std::chrono::steady_clock;
+		const Clock::time_point start = Clock::now();
+		stats = Stats{};
+		float planes[6 * 4];
+		InstanceCuller::FrustumPlanes(MatrixMultiply(transform, viewProjection), planes);
+		const Vector3 local = Vector3Transform(eye, MatrixInvert(transform));
+		for (int m = 0; m < model.meshCount; ++m) {
+			const Meshlets::Clusters& c = clusters[m];
+			if (c.meshlets.empty()) continue;
+			compacted.clear();
+			const Spheres& s = spheres[m];
+			inside.resize(c.meshlets.size());
+			Simd::SpheresInFrustum(planes, s.x.data(), s.y.data(), s.z.data(), s.r.data(), 0, c.meshlets.size(), inside.data());
+			for (size_t k = 0; k < c.meshlets.size(); ++k) {
+				const Meshlets::Meshlet& meshlet = c.meshlets[k];
+				++stats.meshlets;
+				if (!inside[k]) {
+					++stats.outside;
+					continue;
+				}
+				if (Meshlets::BackFacing(meshlet, local)) {
+					++stats.backFacing;
+					continue;
+				}
+				++stats.visible;
+				compacted.insert(compacted.end(), c.indices.begin() + meshlet.first, c.indices.begin() + meshlet.first + meshlet.count);
+			}
+			Upload(model.meshes[m], compacted);
+			drawn[m] = static_cast<int>(compacted.size() / 3);
+			stats.triangles += model.meshes[m].triangleCount;
+			stats.drawn += drawn[m];
+		}
+		stats.cullMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+	}
+
+	// Every cluster back in the index buffers.
+	void Uncull(const Model& model) {
+		stats = Stats{};
+		for (int m = 0; m < model.meshCount; ++m) {
+			const Meshlets::Clusters& c = clusters[m];
+			if (c.meshlets.empty()) continue;
+			Upload(model.meshes[m], c.indices);
+			drawn[m] = model.meshes[m].triangleCount;
+			stats.meshlets += static_cast<int>(c.meshlets.size());
+			stats.visible += static_cast<int>(c.meshlets.size());
+			stats.triangles += drawn[m];
+			stats.drawn += drawn[m];
+		}
+	}
+
+	// The model's split meshes report the culled triangle counts until End().
+	void Begin(const Model& model) {
+		for (int m = 0; m < model.meshCount; ++m) {
+			if (clusters[m].meshlets.empty()) continue;
+			saved[m] = model.meshes[m].triangleCount;
+			model.meshes[m].triangleCount = drawn[m];
+		}
+	}
+
+	void End(const Model& model) {
+		for (int m = 0; m < model.meshCount; ++m) {
+			if (!clusters[m].meshlets.empty()) model.meshes[m].triangleCount = saved[m];
+		}
+	}
+
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+private:
+	static void Upload(const Mesh& mesh, const std::vector<unsigned short>& indices) {
+		if (mesh.vboId == nullptr || mesh.vboId[6] == 0 || indices.empty()) return;
+		rlUpdateVertexBufferElements(mesh.vboId[6], indices.data(), static_cast<int>(indices.size() * sizeof(unsigned short)), 0);
+	}
+
+	// The meshlets' bounding spheres again, a column per component for the frustum kernel.
+	struct Spheres {
+		std::vector<float> x, y, z, r;
+	};
+
+	std::vector<Meshlets::Clusters> clusters;  // per mesh
+	std::vector<Spheres>            spheres;   // per mesh
+	std::vector<unsigned char>      inside;    // per meshlet of the mesh being culled
+	std::vector<int>                drawn;     // per mesh, triangles at the front of its buffer
+	std::vector<int>                saved;
+	std::vector<unsigned short>     compacted;
+	Stats                           stats;
+};
+
+#endif // MESHLETS_H
@@ -0,0 +1,362 @@
+// Micro-benchmarks of the game's hot kernels (MicroBench.exe in build.bat).
+// Bench.exe times whole ticks; this times one kernel at a time on one thread, at several
+// entity counts, in ns per entity, so an optimization can be measured where it lands:
+//
+//   projectile update   ProjectileField::Integrate
+//   asteroid update     AsteroidField::Integrate and MarkOutOfBounds
+//   hits <broadphase>   every projectile against the asteroids under it, as FirstHit tests
+//                       them but counting every overlap, so the pairs column must agree:
+//                       the per-pair nested loop, SIMD brute force, grid and sweep, and
+//                       the grid again with both fields in Morton order (SortSpatially)
+//   grid rebuild/update a tick of asteroid movement and the grid kept up with it, rebuilt
+//                       (Build) or incrementally (Update), with the cell crossings per tick
+//   orbiters chain/tree Fleet::Update with the orbiters in one chain of depth N, or in a
+//                       binary tree of the same size
+//   spawn / spawn wave  AsteroidField::Spawn one at a time and SpawnWave
+//   capture             the render snapshots' Capture, the extraction every frame does
+//
+// `MicroBench.exe [ms]` runs each row for about that long (default 100). `--gl` also times
+// the batch renderers' submission in a hidden window, which needs a GPU; projectile tests
+// leave KINETIC out, whose cost depends on the ticks before (Bench.exe covers it).
+#define POIGK_NO_MAIN
+#include "main.cpp"
+
+#include <cstdio>
+
+namespace {
+
+constexpr float C_DT = 1.f / 120.f;
+constexpr float C_SPACING = 100.f;   // world side per sqrt(entity): the same density at every count
+constexpr size_t C_MAX_QUADRATIC = 10'000;
+
+double budgetSeconds = 0.1;
+volatile uint64_t sink = 0;  // what the kernels return, so nothing is optimized away
+
+struct Timing {
+	int    runs;
+	double nsPerEntity;
+};
+
+// Runs fn, one pass over n entities, until the budget has passed, after one untimed pass
+// to warm caches and buffers.
+template<typename Fn>
+Timing Time(size_t n, Fn&& fn) {
+	fn();
+	int runs = 0;
+	double seconds = 0.0;
+	while (seconds < budgetSeconds || runs < 3) {
+		auto start = std::chrono::steady_clock::now();
+		fn();
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		++runs;
+	}
+	return { runs, seconds * 1e9 / (static_cast<double>(runs) * static_cast<double>(n)) };
+}
+
+void PrintRow(const char* kernel, size_t n, Timing t) {
+	printf("%-20s %-10zu %-8d %-12.2f", kernel, n, t.runs, t.nsPerEntity);
+}
+
+template<typename Fn>
+void Measure(const char* kernel, size_t n, Fn&& fn) {
+	PrintRow(kernel, n, Time(n, fn));
+	printf("\n");
+}
+
+WorldBounds WorldFor(size_t n) {
+	const float side = C_SPACING * sqrtf(static_cast<float>(n));
+	return { side, side };
+}
+
+Vector2 RandomPoint(const WorldBounds& world) {
+	return { Utils::RandomFloat(0, world.width), Utils::RandomFloat(0, world.height) };
+}
+
+void FillProjectiles(ProjectileField& field, size_t n, const WorldBounds& world) {
+	field.Clear();
+	field.Reserve(n);
+	for (size_t i = 0; i < n; ++i) {
+		WeaponType wt = static_cast<WeaponType>(Utils::RandomInt(0, static_cast<int>(WeaponType::COUNT) - 1));
+		float speed = Fleet::Spacing(wt) * Fleet::FireRate(wt);
+		field.Add(MakeProjectile(wt, RandomPoint(world), speed, Utils::RandomFloat(0, 360), Handle{}));
+	}
+}
+
+void FillAsteroids(AsteroidField& field, size_t n, const WorldBounds& world) {
+	field.Clear();
+	field.Reserve(n);
+	while (field.Size() < n && field.Spawn(static_cast<int>(world.width), static_cast<int>(world.height), AsteroidShape::RANDOM)) {
+		field.SetPosition(field.Size() - 1, RandomPoint(world));
+	}
+}
+
+// The swept probe FirstHit builds for projectile pi.
+struct Probe {
+	float x, y, dx, dy, r;
+	Vector2 mid;
+	float reach;
+};
+
+Probe ProbeOf(const ProjectileField& projectiles, size_t pi) {
+	Vector2 p = projectiles.GetPosition(pi);
+	Vector2 v = projectiles.GetVelocity(pi);
+	Vector2 step = { v.x * C_DT, v.y * C_DT };
+	float r = projectiles.GetRadius(pi);
+	return { p.x - step.x, p.y - step.y, step.x, step.y, r, { p.x - step.x * 0.5f, p.y - step.y * 0.5f },
+		0.5f * sqrtf(step.x * step.x + step.y * step.y) + r + Asteroid::MAX_RADIUS };
+}
+
+void Header(const char* title) {
+	printf("\n%s\n%-20s %-10s %-8s %-12s\n", title, "kernel", "entities", "runs", "ns/entity");
+}
+
+void BenchUpdates(const size_t* counts, size_t countCount) {
+	Header("Integration");
+	// Far walls, so nothing leaves and every run moves the same number.
+	const WorldBounds open{ 1e9f, 1e9f };
+	for (size_t c = 0; c < countCount; ++c) {
+		const size_t n = counts[c];
+		const WorldBounds world = WorldFor(n);
+		ProjectileField projectiles;
+		FillProjectiles(projectiles, n, world);
+		Measure("projectile update", n, [&] { projectiles.Integrate(C_DT, open, projectiles.Begin(), projectiles.End()); });
+
+		AsteroidField asteroids;
+		FillAsteroids(asteroids, n, world);
+		std::vector<char> dead(n, 0);
+		Measure("asteroid update", n, [&] {
+			asteroids.Integrate(C_DT);
+			asteroids.MarkOutOfBounds(open, dead);
+		});
+	}
+}
+
+void BenchBroadphases(const size_t* counts, size_t countCount) {
+	printf("\nProjectile hits, as many asteroids as projectiles at the same density (pairs must agree)\n");
+	printf("%-20s %-10s %-8s %-12s %-10s\n", "kernel", "entities", "runs", "ns/entity", "pairs");
+	for (size_t c = 0; c < countCount; ++c) {
+		const size_t n = counts[c];
+		const WorldBounds world = WorldFor(n);
+		ProjectileField projectiles;
+		AsteroidField asteroids;
+		FillProjectiles(projectiles, n, world);
+		FillAsteroids(asteroids, n, world);
+		const float* ax = asteroids.X();
+		const float* ay = asteroids.Y();
+		const float* ar = asteroids.Radii();
+
+		uint64_t pairs = 0;
+		auto countRun = [&](const Probe& p, const int* run, int count) {
+			for (int k = 0; k < count; k += 8) {
+				int block = count - k < 8 ? count - k : 8;
+				pairs += static_cast<uint64_t>(std::popcount(Simd::SweptOverlapMask(p.x, p.y, p.dx, p.dy, p.r, ax, ay, ar, run + k, block)));
+			}
+			return false;
+		};
+		auto report = [&](const char* kernel, auto&& pass) {
+			const Timing t = Time(n, [&] {
+				pairs = 0;
+				pass();
+			});
+			PrintRow(kernel, n, t);
+			printf(" %-10llu\n", static_cast<unsigned long long>(pairs));
+			sink = sink + pairs;
+		};
+
+		if (n <= C_MAX_QUADRATIC) {
+			report("hits nested", [&] {
+				for (size_t pi = projectiles.Begin(); pi < projectiles.End(); ++pi) {
+					const Probe p = ProbeOf(projectiles, pi);
+					for (size_t a = 0; a < asteroids.Size(); ++a) {
+						pairs += Simd::SweptOverlapMask(p.x, p.y, p.dx, p.dy, p.r, ax + a, ay + a, ar + a, nullptr, 1);
+					}
+				}
+			});
+			report("hits brute", [&] {
+				for (size_t pi = projectiles.Begin(); pi < projectiles.End(); ++pi) {
+					const Probe p = ProbeOf(projectiles, pi);
+					for (size_t a0 = 0; a0 < asteroids.Size(); a0 += 8) {
+						int block = static_cast<int>(asteroids.Size() - a0 < 8 ? asteroids.Size() - a0 : 8);
+						pairs += static_cast<uint64_t>(std::popcount(Simd::SweptOverlapMask(p.x, p.y, p.dx, p.dy, p.r,
+							ax + a0, ay + a0, ar + a0, nullptr, block)));
+					}
+				}
+			});
+		}
+
+		SpatialGrid grid(world.width, world.height, Asteroid::MAX_RADIUS);
+		report("hits grid", [&] {
+			grid.Build(asteroids.Size(), [&](size_t i) { return asteroids.GetPosition(i); });
+			for (size_t pi = projectiles.Begin(); pi < projectiles.End(); ++pi) {
+				const Probe p = ProbeOf(projectiles, pi);
+				grid.QueryCells(p.mid, p.reach, [&](const int* run, int count) { return countRun(p, run, count); });
+			}
+		});
+
+		SweepAndPrune sweep;
+		report("hits sweep", [&] {
+			sweep.Build(asteroids.Size(), asteroids.X());
+			for (size_t pi = projectiles.Begin(); pi < projectiles.End(); ++pi) {
+				const Probe p = ProbeOf(projectiles, pi);
+				sweep.QueryCells(p.mid, p.reach, [&](const int* run, int count) { return countRun(p, run, count); });
+			}
+		});
+
+		SpatialOrder::Sorter sorter;
+		asteroids.SortSpatially(sorter, world.width, world.height);
+		projectiles.SortSpatially(sorter, world.width, world.height);
+		report("hits grid sorted", [&] {
+			grid.Build(asteroids.Size(), [&](size_t i) { return asteroids.GetPosition(i); });
+			for (size_t pi = projectiles.Begin(); pi < projectiles.End(); ++pi) {
+				const Probe p = ProbeOf(projectiles, pi);
+				grid.QueryCells(p.mid, p.reach, [&](const int* run, int count) { return countRun(p, run, count); });
+			}
+		});
+	}
+}
+
+void BenchGridUpkeep(const size_t* counts, size_t countCount) {
+	printf("\nGrid upkeep, a tick of asteroid movement included\n");
+	printf("%-20s %-10s %-8s %-12s %-10s\n", "kernel", "entities", "runs", "ns/entity", "moved");
+	for (size_t c = 0; c < countCount; ++c) {
+		const size_t n = counts[c];
+		const WorldBounds world = WorldFor(n);
+		AsteroidField asteroids;
+		FillAsteroids(asteroids, n, world);
+		auto positionOf = [&](size_t i) { return asteroids.GetPosition(i); };
+
+		// Forth and back on alternate runs, so the field stays where it was filled.
+		SpatialGrid rebuilt(world.width, world.height, Asteroid::MAX_RADIUS);
+		bool forth = true;
+		PrintRow("grid rebuild", n, Time(n, [&] {
+			asteroids.Integrate(forth ? C_DT : -C_DT);
+			forth = !forth;
+			rebuilt.Build(asteroids.Size(), positionOf);
+		}));
+		printf("\n");
+
+		SpatialGrid updated(world.width, world.height, Asteroid::MAX_RADIUS);
+		size_t moved = 0, runs = 0;
+		PrintRow("grid update", n, Time(n, [&] {
+			asteroids.Integrate(forth ? C_DT : -C_DT);
+			forth = !forth;
+			updated.Update(asteroids.Size(), positionOf);
+			moved += updated.Moved();
+			++runs;
+		}));
+		printf(" %-10.1f\n", static_cast<double>(moved) / static_cast<double>(runs));
+	}
+}
+
+void BenchOrbiters() {
+	Header("Orbiter traversal (ns per ship)");
+	const int sizes[] = { 10, 100, 1'000, 10'000 };
+	for (int n : sizes) {
+		Fleet fleet;
+		fleet.Reset(1600, 1600, { 100.f, 100.f });
+		for (int d = 0; d < n; ++d) fleet.AddOrbiter(d);
+		Measure("orbiters chain", fleet.Size(), [&] { fleet.Update(C_DT, 0); });
+
+		fleet.Reset(1600, 1600, { 100.f, 100.f });
+		for (int d = 0; d < n; ++d) fleet.AddOrbiter(d / 2);
+		Measure("orbiters tree", fleet.Size(), [&] { fleet.Update(C_DT, 0); });
+	}
+}
+
+void BenchSpawning(const size_t* counts, size_t countCount) {
+	Header("Spawning");
+	for (size_t c = 0; c < countCount; ++c) {
+		const size_t n = counts[c];
+		AsteroidField asteroids(n);
+		Measure("spawn", n, [&] {
+			asteroids.Clear();
+			while (asteroids.Spawn(1600, 1600, AsteroidShape::RANDOM)) {}
+		});
+		Measure("spawn wave", n, [&] {
+			asteroids.Clear();
+			sink = sink + asteroids.SpawnWave(n, 1600, 1600, AsteroidShape::RANDOM);
+		});
+	}
+}
+
+void BenchCapture(const size_t* counts, size_t countCount) {
+	Header("Render extraction");
+	for (size_t c = 0; c < countCount; ++c) {
+		const size_t n = counts[c];
+		const WorldBounds world = WorldFor(n);
+		AsteroidField asteroids;
+		ProjectileField projectiles;
+		FillAsteroids(asteroids, n, world);
+		FillProjectiles(projectiles, n, world);
+		AsteroidSnapshot asteroidSnap;
+		ProjectileSnapshot projectileSnap;
+		Measure("capture asteroids", n, [&] { asteroidSnap.Capture(asteroids, C_DT); });
+		Measure("capture projectiles", n, [&] { projectileSnap.Capture(projectiles, C_DT); });
+	}
+}
+
+// Submission only: vertex building, the buffer upload and the draw call, with the GPU
+// left to catch up behind. Everything is inside a 1600 x 1600 view, so nothing is culled.
+void BenchRenderers(const size_t* counts, size_t countCount) {
+	SetConfigFlags(FLAG_WINDOW_HIDDEN);
+	InitWindow(1600, 1600, "MicroBench");
+	if (!IsWindowReady()) {
+		printf("\nno window, skipping the renderers\n");
+		return;
+	}
+	Header("Batch rendering submission");
+	AsteroidBatch asteroidBatch;
+	ProjectileBatch projectileBatch;
+	asteroidBatch.Init();
+	projectileBatch.Init();
+	const WorldBounds world{ 1600.f, 1600.f };
+	const View view = View::Of(Camera2D{ { 0.f, 0.f }, { 0.f, 0.f }, 0.f, 1.f }, 1600, 1600);
+	for (size_t c = 0; c < countCount; ++c) {
+		const size_t n = counts[c];
+		AsteroidField asteroids;
+		ProjectileField projectiles;
+		FillAsteroids(asteroids, n, world);
+		FillProjectiles(projectiles, n, world);
+		AsteroidSnapshot asteroidSnap;
+		ProjectileSnapshot projectileSnap;
+		asteroidSnap.Capture(asteroids, C_DT);
+		projectileSnap.Capture(projectiles, C_DT);
+
+		BeginDrawing();
+		if (asteroidBatch.IsReady()) {
+			Measure("draw asteroids", n, [&] { asteroidBatch.Draw(asteroidSnap.Blend(1.f), view, RED); });
+		}
+		if (projectileBatch.IsReady()) {
+			Measure("draw projectiles", n, [&] { projectileBatch.Draw(projectileSnap.Blend(1.f)); });
+		}
+		EndDrawing();
+	}
+	asteroidBatch.Unload();
+	projectileBatch.Unload();
+	CloseWindow();
+}
+
+}
+
+int main(int argc, char** argv) {
+	MemoryTracker::Install();
+	SetTraceLogLevel(LOG_WARNING);
+	Utils::SeedRandom(1234);
+
+	bool gl = false;
+	for (int i = 1; i < argc; ++i) {
+		if (TextIsEqual(argv[i], "--gl")) gl = true;
+		else budgetSeconds = TextToInteger(argv[i]) * 1e-3;
+	}
+
+	const size_t counts[] = { 1'000, 10'000, 100'000 };
+	const size_t countCount = sizeof(counts) / sizeof(counts[0]);
+	BenchUpdates(counts, countCount);
+	BenchBroadphases(counts, countCount);
+	BenchGridUpkeep(counts, countCount);
+	BenchOrbiters();
+	BenchSpawning(counts, countCount);
+	BenchCapture(counts, countCount);
+	if (gl) BenchRenderers(counts, countCount);
+	return 0;
+}
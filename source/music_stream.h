@@ -0,0 +1,183 @@
+#ifndef MUSIC_STREAM_H
+#define MUSIC_STREAM_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "raylib.h"
+#include "external/qoa.h"  // the decoder, compiled into raudio (SUPPORT_FILEFORMAT_QOA)
+
+// --- STREAMED MUSIC ---
+// Background music that the main thread never decodes. raylib's Music is decoded inside
+// UpdateMusicStream, on whichever thread calls it; here a decoder thread runs QOA frames
+// (cheap next to MP3 or FLAC) up to C_AHEAD_SECONDS ahead into a single-producer,
+// single-consumer ring of float samples, and the AudioStream's callback, on raudio's audio
+// thread, only copies out of the ring. Nothing is called per frame. The track loops. The
+// file is read whole through LoadFileData, so it comes out of resources.pak like any other
+// asset; frames are decoded straight from it with qoa.h (qoaplay's memory reader starts at
+// the file header rather than the first frame, and reads past the end on the last one). If
+// the decoder ever falls behind, the callback plays silence for what's missing and counts it.
+class MusicStream {
+public:
+	static constexpr double C_AHEAD_SECONDS = 1.0;     // decoded and waiting in the ring
+	static constexpr double C_PREFILL_SECONDS = 0.25;  // in the ring before the first sample plays
+	static constexpr auto   C_POLL = std::chrono::milliseconds(10);
+
+	static MusicStream& Instance() {
+		static MusicStream instance;
+		return instance;
+	}
+
+	// Loads a .qoa file and starts playing it, looped. Needs the audio device open.
+	bool Play(const char* fileName, float volume = 0.5f) {
+		Stop();
+		if (!IsAudioDeviceReady()) return false;
+		int size = 0;
+		file = LoadFileData(fileName, &size);
+		if (file == nullptr) return false;
+		fileSize = static_cast<unsigned int>(size);
+		firstFrame = qoa_decode_header(file, size, &desc);
+		if (firstFrame == 0) {
+			TraceLog(LOG_WARNING, "MUSIC: [%s] is not a QOA file", fileName);
+			UnloadFileData(file);
+			file = nullptr;
+			return false;
+		}
+
+		// `desc` is the decoder's from here on, which rewrites it every frame.
+		channels = desc.channels;
+		const unsigned int rate = desc.samplerate;
+		const double seconds = static_cast<double>(desc.samples) / rate;
+		capacity = std::bit_ceil(static_cast<uint32_t>(C_AHEAD_SECONDS * rate));
+		prefill = static_cast<uint32_t>(C_PREFILL_SECONDS * rate);
+		ring.assign(static_cast<size_t>(capacity) * channels, 0.f);
+		head.store(0, std::memory_order_relaxed);
+		tail.store(0, std::memory_order_relaxed);
+		primed.store(false, std::memory_order_relaxed);
+		underruns.store(0, std::memory_order_relaxed);
+		quit.store(false, std::memory_order_relaxed);
+		decoder = std::thread([this] { Decode(); });
+
+		stream = LoadAudioStream(rate, 32, channels);
+		SetAudioStreamCallback(stream, &Feed);
+		SetAudioStreamVolume(stream, volume);
+		PlayAudioStream(stream);
+		TraceLog(LOG_INFO, "MUSIC: [%s] %u Hz, %u channels, %.1f s, streamed %.2f s ahead", fileName, rate, channels,
+			seconds, static_cast<double>(capacity) / rate);
+		return true;
+	}
+
+	// Stops the music and frees it. Before CloseAudioDevice.
+	void Stop() {
+		if (file == nullptr) return;
+		if (IsAudioStreamReady(stream)) {
+			StopAudioStream(stream);
+			UnloadAudioStream(stream);  // takes raudio's lock, so the callback is done with the ring
+		}
+		stream = {};
+		quit.store(true, std::memory_order_relaxed);
+		if (decoder.joinable()) decoder.join();
+		UnloadFileData(file);
+		file = nullptr;
+		ring.clear();
+		ring.shrink_to_fit();
+	}
+
+	bool Playing() const {
+		return file != nullptr;
+	}
+
+	void SetVolume(float volume) {
+		if (file != nullptr) SetAudioStreamVolume(stream, volume);
+	}
+
+	// Callback frames that found the ring empty.
+	uint64_t Underruns() const {
+		return underruns.load(std::memory_order_relaxed);
+	}
+
+private:
+	// The decoder thread: one QOA frame at a time, whenever the ring has room for one.
+	void Decode() {
+		std::vector<short> samples(static_cast<size_t>(QOA_FRAME_LEN) * channels);
+		unsigned int position = firstFrame;
+		while (!quit.load(std::memory_order_relaxed)) {
+			const uint32_t h = head.load(std::memory_order_relaxed);
+			if (capacity - (h - tail.load(std::memory_order_acquire)) < QOA_FRAME_LEN) {
+				std::this_thread::sleep_for(C_POLL);
+				continue;
+			}
+			unsigned int frames = 0;
+			const unsigned int used = position < fileSize
+				? qoa_decode_frame(file + position, fileSize - position, &desc, samples.data(), &frames) : 0;
+			if (used == 0 || frames == 0) {
+				if (position == firstFrame) {
+					TraceLog(LOG_WARNING, "MUSIC: no frame could be decoded");
+					return;
+				}
+				position = firstFrame;  // the end (or a bad frame): loop
+				continue;
+			}
+			position += used;
+			for (unsigned int f = 0; f < frames; ++f) {
+				float* out = &ring[static_cast<size_t>((h + f) & (capacity - 1)) * channels];
+				for (unsigned int c = 0; c < channels; ++c) out[c] = static_cast<float>(samples[f * channels + c]) / 32768.f;
+			}
+			head.store(h + frames, std::memory_order_release);
+		}
+	}
+
+	// raudio's audio thread: copies `frames` out of the ring; no decoding, no locks.
+	static void Feed(void* buffer, unsigned int frames) {
+		MusicStream& m = Instance();
+		float* out = static_cast<float*>(buffer);
+		const uint32_t t = m.tail.load(std::memory_order_relaxed);
+		const uint32_t available = m.head.load(std::memory_order_acquire) - t;
+		if (!m.primed.load(std::memory_order_relaxed)) {
+			if (available < m.prefill) {
+				memset(out, 0, sizeof(float) * frames * m.channels);
+				return;
+			}
+			m.primed.store(true, std::memory_order_relaxed);
+		}
+
+		const uint32_t n = std::min(available, static_cast<uint32_t>(frames));
+		for (uint32_t done = 0; done < n;) {
+			const uint32_t at = (t + done) & (m.capacity - 1);
+			const uint32_t run = std::min(n - done, m.capacity - at);
+			memcpy(out + static_cast<size_t>(done) * m.channels, &m.ring[static_cast<size_t>(at) * m.channels], sizeof(float) * run * m.channels);
+			done += run;
+		}
+		if (n < frames) {
+			memset(out + static_cast<size_t>(n) * m.channels, 0, sizeof(float) * (frames - n) * m.channels);
+			m.underruns.fetch_add(frames - n, std::memory_order_relaxed);
+		}
+		m.tail.store(t + n, std::memory_order_release);
+	}
+
+	unsigned char* file = nullptr;
+	unsigned int   fileSize = 0;
+	unsigned int   firstFrame = 0;
+	qoa_desc       desc = {};  // the decoder thread's while it runs (lms state per frame)
+	unsigned int   channels = 0;
+	AudioStream    stream = {};
+
+	// The ring, in frames of `channels` samples: the decoder fills at `head`, the callback
+	// empties at `tail`. `capacity` is a power of two.
+	std::vector<float>    ring;
+	uint32_t              capacity = 0;
+	uint32_t              prefill = 0;
+	std::atomic<uint32_t> head{0}, tail{0};
+	std::atomic<bool>     primed{false};
+	std::atomic<uint64_t> underruns{0};
+	std::atomic<bool>     quit{false};
+	std::thread           decoder;
+};
+
+#endif // MUSIC_STREAM_H
@@ -0,0 +1,9 @@
+// Asset archive packer (Pack.exe in build.bat): `Pack.exe [root] [archive]` packs every
+// file under root (../resources) into one archive (resources.pak) for AssetArchive::Mount.
+#include "asset_archive.h"
+
+int main(int argc, char** argv) {
+	const char* root = (argc > 1) ? argv[1] : "../resources";
+	const char* archive = (argc > 2) ? argv[2] : "resources.pak";
+	return AssetArchive::Build(root, archive) ? 0 : 1;
+}
@@ -0,0 +1,340 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// --- TRACE ---
+// Optional recording of timeline events in the Chrome trace-event JSON format, loadable in
+// chrome://tracing and Perfetto. Each thread appends to its own buffer with no locking (the
+// mutex is only taken the first time a thread records), and everything is written out in
+// one go by Write() once the workers are idle. While recording is off an event costs one
+// relaxed load, so the hooks can stay in release builds.
+class Trace {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	static Trace& Instance() {
+		static Trace instance;
+		return instance;
+	}
+
+	void Start() {
+		origin = Clock::now();
+		enabled.store(true, std::memory_order_release);
+	}
+
+	static bool Enabled() {
+		return Instance().enabled.load(std::memory_order_relaxed);
+	}
+
+	// A span [begin, end) on the calling thread. `name` must outlive the trace (a literal).
+	void Complete(const char* name, Clock::time_point begin, Clock::time_point end) {
+		Local().events.push_back({ name, Nanoseconds(begin), Nanoseconds(end) - Nanoseconds(begin), 0, 'X' });
+	}
+
+	void Instant(const char* name) {
+		Local().events.push_back({ name, Nanoseconds(Clock::now()), 0, 0, 'i' });
+	}
+
+	void Counter(const char* name, int64_t value) {
+		Local().events.push_back({ name, Nanoseconds(Clock::now()), 0, value, 'C' });
+	}
+
+	// A span on a track of its own rather than the calling thread's, for timings taken
+	// elsewhere (GpuProfiler's come back from the GPU frames late). One thread per track;
+	// `track` and `name` must outlive the trace (literals).
+	void CompleteOn(const char* track, const char* name, Clock::time_point begin, Clock::time_point end) {
+		Track(track).events.push_back({ name, Nanoseconds(begin), Nanoseconds(end) - Nanoseconds(begin), 0, 'X' });
+	}
+
+	// Labels the calling thread's track. `name` must outlive the trace (a literal).
+	void NameThread(const char* name) {
+		Local().name = name;
+	}
+
+	// Stops recording and writes every thread's events. Returns false if the file can't be opened.
+	bool Write(const char* path) {
+		enabled.store(false, std::memory_order_release);
+		FILE* f = nullptr;
+#if defined(_MSC_VER)
+		if (fopen_s(&f, path, "wb") != 0) f = nullptr;
+#else
+		f = fopen(path, "wb");
+#endif
+		if (!f) return false;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", f);
+		bool first = true;
+		for (const auto& buf : buffers) {
+			char threadName[32];
+			if (buf->name) snprintf(threadName, sizeof(threadName), "%s", buf->name);
+			else if (buf->tid == 0) snprintf(threadName, sizeof(threadName), "main");
+			else snprintf(threadName, sizeof(threadName), "worker %d", buf->tid);
+			fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",\n", buf->tid, threadName);
+			first = false;
+			for (const Event& e : buf->events) {
+				double ts = e.ts * 1e-3;
+				switch (e.type) {
+				case 'X':
+					fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+						e.name, buf->tid, ts, e.dur * 1e-3);
+					break;
+				case 'i':
+					fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+						e.name, buf->tid, ts);
+					break;
+				default:
+					fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"args\":{\"value\":%lld}}",
+						e.name, buf->tid, ts, static_cast<long long>(e.value));
+					break;
+				}
+			}
+		}
+		fputs("\n]}\n", f);
+		fclose(f);
+		return true;
+	}
+
+private:
+	struct Event {
+		const char* name;
+		int64_t     ts;
+		int64_t     dur;
+		int64_t     value;
+		char        type;
+	};
+
+	struct Buffer {
+		int                tid;
+		const char*        name = nullptr;
+		std::vector<Event> events;
+	};
+
+	static constexpr size_t C_RESERVE = 1 << 16;
+
+	Trace() = default;
+
+	int64_t Nanoseconds(Clock::time_point t) const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(t - origin).count();
+	}
+
+	// The first thread to record is the main thread (tid 0); workers follow in order of
+	// their first event.
+	Buffer& Local() {
+		thread_local Buffer* local = nullptr;
+		if (!local) {
+			std::lock_guard<std::mutex> lock(mutex);
+			auto buf = std::make_unique<Buffer>();
+			buf->tid = static_cast<int>(buffers.size());
+			buf->events.reserve(C_RESERVE);
+			local = buf.get();
+			buffers.push_back(std::move(buf));
+		}
+		return *local;
+	}
+
+	// Tracks are few and found by their literal's address; only creating one locks.
+	Buffer& Track(const char* name) {
+		thread_local std::vector<std::pair<const char*, Buffer*>> tracks;
+		for (auto& t : tracks) {
+			if (t.first == name) return *t.second;
+		}
+		std::lock_guard<std::mutex> lock(mutex);
+		auto buf = std::make_unique<Buffer>();
+		buf->tid = static_cast<int>(buffers.size());
+		buf->name = name;
+		buf->events.reserve(C_RESERVE);
+		tracks.push_back({ name, buf.get() });
+		buffers.push_back(std::move(buf));
+		return *tracks.back().second;
+	}
+
+	std::atomic<bool>                    enabled{ false };
+	Clock::time_point                    origin{};
+	std::mutex                           mutex;
+	std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+// Records a trace span when recording is on; free otherwise apart from the flag check.
+class TraceScope {
+public:
+	explicit TraceScope(const char* n) : name(n) {
+		if (Trace::Enabled()) start = Trace::Clock::now();
+	}
+	~TraceScope() {
+		if (Trace::Enabled() && start != Trace::Clock::time_point{}) {
+			Trace::Instance().Complete(name, start, Trace::Clock::now());
+		}
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char*              name;
+	Trace::Clock::time_point start{};
+};
+
+// --- PROFILER ---
+// Per-phase CPU timings. Scoped timers add their elapsed time to the current frame (a
+// phase that runs once per tick sums over the frame's ticks), and EndFrame() pushes the
+// totals into a ring of the last C_HISTORY frames for the overlay. In a window the
+// simulation and render threads both report, so everything goes through one mutex; that
+// is a few dozen uncontended locks per frame.
+class Profiler {
+public:
+	enum class Phase { INPUT, SHIPS, SPAWN, PROJECTILES, BROADPHASE, COLLISION, ASTEROIDS, ORBITERS, SECTORS, DRAW, FRAME, COUNT };
+	static constexpr int    C_PHASES = static_cast<int>(Phase::COUNT);
+	static constexpr size_t C_HISTORY = 240;
+
+	using Clock = std::chrono::steady_clock;
+
+	struct Stats {
+		double last;
+		double p50;
+		double p99;
+	};
+
+	static Profiler& Instance() {
+		static Profiler instance;
+		return instance;
+	}
+
+	static const char* NameOf(Phase p) {
+		static constexpr const char* names[C_PHASES] = {
+			"input", "ships", "spawn", "projectiles", "broadphase", "collision", "asteroids", "orbiters", "sectors", "draw", "frame"
+		};
+		return names[static_cast<int>(p)];
+	}
+
+	void BeginFrame() {
+		std::lock_guard<std::mutex> lock(mutex);
+		current.fill(0.0);
+		frameStart = Clock::now();
+	}
+
+	// Returns the frame's ms.
+	double EndFrame() {
+		std::lock_guard<std::mutex> lock(mutex);
+		Clock::time_point now = Clock::now();
+		const double ms = Milliseconds(frameStart, now);
+		current[static_cast<int>(Phase::FRAME)] = ms;
+		if (Trace::Enabled()) Trace::Instance().Complete(NameOf(Phase::FRAME), frameStart, now);
+		history[head] = current;
+		head = (head + 1) % C_HISTORY;
+		if (frames < C_HISTORY) ++frames;
+		return ms;
+	}
+
+	void Add(Phase p, double ms) {
+		std::lock_guard<std::mutex> lock(mutex);
+		current[static_cast<int>(p)] += ms;
+	}
+
+	size_t Frames() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return frames;
+	}
+
+	// Over the recorded frames; `last` is the most recently finished one.
+	Stats Get(Phase p) const {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (frames == 0) return { 0.0, 0.0, 0.0 };
+		const int idx = static_cast<int>(p);
+		scratch.resize(frames);
+		for (size_t f = 0; f < frames; ++f) scratch[f] = history[f][idx];
+		auto at = [&](double q) {
+			size_t k = static_cast<size_t>(q * static_cast<double>(frames - 1));
+			std::nth_element(scratch.begin(), scratch.begin() + k, scratch.end());
+			return scratch[k];
+		};
+		double last = history[(head + C_HISTORY - 1) % C_HISTORY][idx];
+		double p50 = at(0.50);
+		double p99 = at(0.99);
+		return { last, p50, p99 };
+	}
+
+	// Every phase of the most recently finished frame, zeros before the first; the overlay's
+	// `last` without the percentiles.
+	std::array<double, C_PHASES> Last() const {
+		std::lock_guard<std::mutex> lock(mutex);
+		return history[(head + C_HISTORY - 1) % C_HISTORY];
+	}
+
+	// While set, the calling thread's scopes add nothing (ProfileMute). Worlds stepped on
+	// every core at once (WorldBatch) would otherwise all queue on the mutex.
+	static bool& Muted() {
+		static thread_local bool muted = false;
+		return muted;
+	}
+
+	static double Milliseconds(Clock::time_point a, Clock::time_point b) {
+		return std::chrono::duration<double, std::milli>(b - a).count();
+	}
+
+private:
+	Profiler() = default;
+
+	using Sample = std::array<double, C_PHASES>;
+
+	std::array<Sample, C_HISTORY> history{};
+	Sample                        current{};
+	size_t                        head = 0;
+	size_t                        frames = 0;
+	Clock::time_point             frameStart{};
+	mutable std::vector<double>   scratch;
+	mutable std::mutex            mutex;
+};
+
+class ProfileScope {
+public:
+	explicit ProfileScope(Profiler::Phase p) : phase(p), start(Profiler::Clock::now()) {}
+	~ProfileScope() {
+		Profiler::Clock::time_point end = Profiler::Clock::now();
+		if (!Profiler::Muted()) Profiler::Instance().Add(phase, Profiler::Milliseconds(start, end));
+		if (Trace::Enabled()) Trace::Instance().Complete(Profiler::NameOf(phase), start, end);
+	}
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+	Profiler::Phase              phase;
+	Profiler::Clock::time_point  start;
+};
+
+// Mutes the calling thread's profile scopes until the end of the scope; trace spans stay.
+class ProfileMute {
+public:
+	ProfileMute() : previous(Profiler::Muted()) {
+		Profiler::Muted() = true;
+	}
+	~ProfileMute() {
+		Profiler::Muted() = previous;
+	}
+
+	ProfileMute(const ProfileMute&) = delete;
+	ProfileMute& operator=(const ProfileMute&) = delete;
+
+private:
+	bool previous;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(phase) ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(Profiler::Phase::phase)
+#define TRACE_SCOPE(name) TraceScope PROFILE_CONCAT(traceScope_, __LINE__)(name)
+
+#endif // PROFILER_H
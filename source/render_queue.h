@@ -0,0 +1,303 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "jobs.h"
+
+// --- RENDER QUEUE ---
+// DrawModel-compatible submission that is sorted before it reaches the GPU. Add() records one
+// item per mesh; Flush() gives each a 64-bit key, radix-sorts the keys and draws in key order,
+// binding a shader, a material's textures or a vertex array only when it differs from the one
+// already bound. Keys, high bits first:
+//   - opaque:      0 | shader | material | mesh | depth, front to back within equal state;
+//   - translucent: 1 | far-to-near depth | shader | material | mesh, drawn after every opaque
+//     item, for blending in order.
+// An item is translucent when its diffuse colour, tinted, has alpha below 255. Depth is the
+// view distance of the item's origin, quantised over the far plane's range. Shader and mesh
+// fields are their GL names, material fields a per-flush index; fields are truncated to fit,
+// which can only cost a redundant bind, since binds compare the real state.
+//
+// Call between BeginMode3D and EndMode3D, with the view the items should be drawn from; what
+// happens per draw otherwise matches DrawMesh (no stereo). Models and materials must stay
+// alive, and unchanged, until Flush().
+//
+// Gather() fills the queue from worker threads: each chunk of a traversal records into a
+// Recorder of its own, and the chunks are appended in order once all are done, so the queue
+// ends up as a serial loop would have left it. Flush() also generates the keys of a long
+// queue in parallel; only the draws themselves stay on the GL thread.
+namespace RenderQueueDetail {
+	// LSD radix sort of `keys` carrying `order`, 8 bits a pass; a pass every key agrees on is skipped.
+	inline void RadixSort(std::vector<uint64_t>& keys, std::vector<uint32_t>& order, std::vector<uint64_t>& keyScratch, std::vector<uint32_t>& orderScratch) {
+		const size_t n = keys.size();
+		keyScratch.resize(n);
+		orderScratch.resize(n);
+		for (int shift = 0; shift < 64; shift += 8) {
+			size_t counts[256] = {};
+			for (uint64_t key : keys) ++counts[(key >> shift) & 0xFF];
+			if (counts[(keys[0] >> shift) & 0xFF] == n) continue;
+			size_t offset = 0;
+			for (size_t& c : counts) {
+				const size_t bucket = c;
+				c = offset;
+				offset += bucket;
+			}
+			for (size_t i = 0; i < n; ++i) {
+				const size_t to = counts[(keys[i] >> shift) & 0xFF]++;
+				keyScratch[to] = keys[i];
+				orderScratch[to] = order[i];
+			}
+			keys.swap(keyScratch);
+			order.swap(orderScratch);
+		}
+	}
+}
+
+class RenderQueue {
+public:
+	static constexpr int C_MATERIAL_MAPS = 12;  // raylib's MAX_MATERIAL_MAPS, which config.h keeps private
+
+	// Of the last Flush: items drawn, and how many shader, material and vertex array binds they
+	// took, sorted and as they would have in submission order.
+	struct Stats {
+		int items = 0;
+		int shaders = 0;
+		int materials = 0;
+		int meshes = 0;
+		int unsortedShaders = 0;
+		int unsortedMaterials = 0;
+		int unsortedMeshes = 0;
+		int chunks = 0;      // Gather() chunks recorded, on however many threads
+	};
+
+	// As DrawModel.
+	void Add(const Model& model, Vector3 position, float scale, Color tint) {
+		const Matrix placed = MatrixMultiply(MatrixScale(scale, scale, scale), MatrixTranslate(position.x, position.y, position.z));
+		Record(items, model, placed, tint);
+	}
+
+	// Calls visit(i, recorder) for every i in [0, count) on the job system's threads, in
+	// chunks of at least `minChunk`, and queues what the chunks recorded in index order.
+	// `visit` may run concurrently with itself: it must write only through its recorder, or
+	// to what is its own i's.
+	template<typename Visit>
+	void Gather(size_t count, size_t minChunk, Visit&& visit) {
+		if (count == 0) return;
+		JobSystem& jobs = JobSystem::Instance();
+		const size_t target = jobs.ThreadCount() * 4;
+		const size_t chunk = std::max(std::max<size_t>(minChunk, 1), (count + target - 1) / target);
+		const size_t chunks = (count + chunk - 1) / chunk;
+		if (recorders.size() < chunks) recorders.resize(chunks);
+		jobs.ParallelFor(chunks, 1, [&](size_t begin, size_t end) {
+			for (size_t c = begin; c < end; ++c) {
+				Recorder& recorder = recorders[c];
+				recorder.items.clear();
+				const size_t last = std::min(count, (c + 1) * chunk);
+				for (size_t i = c * chunk; i < last; ++i) visit(i, recorder);
+			}
+		});
+		for (size_t c = 0; c < chunks; ++c) items.insert(items.end(), recorders[c].items.begin(), recorders[c].items.end());
+		gathered += static_cast<int>(chunks);
+	}
+
+	// Sorts and draws everything added since the last Flush, then empties the queue.
+	void Flush() {
+		stats = Stats{};
+		stats.items = static_cast<int>(items.size());
+		stats.chunks = gathered;
+		gathered = 0;
+		if (items.empty()) return;
+
+		const Matrix view = rlGetMatrixModelview();
+		const Matrix projection = rlGetMatrixProjection();
+		const float depthScale = static_cast<float>(C_DEPTH_MASK) / static_cast<float>(RL_CULL_DISTANCE_FAR);  // BeginMode3D's far plane
+		// Material indices in order of first use, serially, parked in `order` until each key
+		// is built from them in parallel.
+		materialIndex.clear();
+		keys.resize(items.size());
+		order.resize(items.size());
+		const Material* lastMaterial = nullptr;
+		uint32_t lastIndex = 0;
+		for (size_t i = 0; i < items.size(); ++i) {
+			if (items[i].material != lastMaterial) {
+				lastMaterial = items[i].material;
+				lastIndex = materialIndex.emplace(lastMaterial, static_cast<uint32_t>(materialIndex.size())).first->second;
+			}
+			order[i] = lastIndex;
+		}
+		JobSystem::Instance().ParallelFor(items.size(), C_KEY_CHUNK, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const Item& item = items[i];
+				const Vector3 origin = Vector3Transform({ item.transform.m12, item.transform.m13, item.transform.m14 }, view);
+				const uint64_t depth = static_cast<uint64_t>(std::clamp(-origin.z * depthScale, 0.0f, static_cast<float>(C_DEPTH_MASK)));
+				const uint64_t shader = item.material->shader.id & 0xFFF;
+				const uint64_t material = order[i] & 0xFFF;
+				const uint64_t mesh = item.mesh->vaoId & 0xFFFF;
+				if (item.color.a == 255) keys[i] = (shader << 51) | (material << 39) | (mesh << 23) | depth;
+				else keys[i] = (uint64_t{ 1 } << 63) | ((C_DEPTH_MASK - depth) << 40) | (shader << 28) | (material << 16) | mesh;
+				order[i] = static_cast<uint32_t>(i);
+			}
+		});
+		CountUnsorted();
+		RenderQueueDetail::RadixSort(keys, order, keyScratch, orderScratch);
+
+		const Shader* shader = nullptr;
+		const Material* material = nullptr;
+		unsigned int vao = 0;
+		unsigned int bound[C_MATERIAL_MAPS] = {};
+		Color color{};
+		bool colorSet = false;
+		for (uint32_t index : order) {
+			const Item& item = items[index];
+			const int* locs = item.material->shader.locs;
+			const bool newShader = (shader == nullptr || shader->id != item.material->shader.id);
+			if (newShader) {
+				shader = &item.material->shader;
+				rlEnableShader(shader->id);
+				if (locs[SHADER_LOC_MATRIX_VIEW] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_VIEW], view);
+				if (locs[SHADER_LOC_MATRIX_PROJECTION] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_PROJECTION], projection);
+				material = nullptr;  // sampler units and colours are per program
+				++stats.shaders;
+			}
+			if (material != item.material) {
+				material = item.material;
+				BindMaps(*material, bound);
+				if (locs[SHADER_LOC_COLOR_SPECULAR] != -1) {
+					const Vector4 specular = ColorNormalize(material->maps[MATERIAL_MAP_SPECULAR].color);
+					rlSetUniform(locs[SHADER_LOC_COLOR_SPECULAR], &specular, SHADER_UNIFORM_VEC4, 1);
+				}
+				colorSet = false;
+				++stats.materials;
+			}
+			if (locs[SHADER_LOC_COLOR_DIFFUSE] != -1 && (!colorSet || !SameColor(color, item.color))) {
+				color = item.color;
+				colorSet = true;
+				const Vector4 diffuse = ColorNormalize(color);
+				rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], &diffuse, SHADER_UNIFORM_VEC4, 1);
+			}
+			if (newShader || vao != item.mesh->vaoId) {
+				vao = item.mesh->vaoId;
+				rlEnableVertexArray(vao);
+				if (item.mesh->vboId[3] == 0 && locs[SHADER_LOC_VERTEX_COLOR] != -1) rlDisableVertexAttribute(locs[SHADER_LOC_VERTEX_COLOR]);
+				++stats.meshes;
+			}
+
+			if (locs[SHADER_LOC_MATRIX_MODEL] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MODEL], item.transform);
+			const Matrix model = MatrixMultiply(item.transform, rlGetMatrixTransform());
+			if (locs[SHADER_LOC_MATRIX_NORMAL] != -1) rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_NORMAL], MatrixTranspose(MatrixInvert(model)));
+			rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(MatrixMultiply(model, view), projection));
+			if (item.mesh->indices != nullptr) rlDrawVertexArrayElements(0, item.mesh->triangleCount * 3, nullptr);
+			else rlDrawVertexArray(0, item.mesh->vertexCount);
+		}
+
+		for (int i = 0; i < C_MATERIAL_MAPS; ++i) {
+			if (bound[i] == 0) continue;
+			rlActiveTextureSlot(i);
+			if (IsCubemap(i)) rlDisableTextureCubemap();
+			else rlDisableTexture();
+		}
+		rlActiveTextureSlot(0);
+		rlDisableVertexArray();
+		rlDisableShader();
+		items.clear();
+	}
+
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+private:
+	static constexpr uint64_t C_DEPTH_MASK = (uint64_t{ 1 } << 23) - 1;
+	static constexpr size_t   C_KEY_CHUNK = 2048;  // queues shorter than this key serially
+
+	struct Item {
+		const Mesh*     mesh;
+		const Material* material;
+		Matrix          transform;  // model.transform and the placement, as DrawModel combines them
+		Color           color;      // diffuse colour times tint
+	};
+
+	// One item per mesh of `model`, placed by `placed` as DrawModel places it.
+	static void Record(std::vector<Item>& out, const Model& model, const Matrix& placed, Color tint) {
+		const Matrix transform = MatrixMultiply(model.transform, placed);
+		for (int m = 0; m < model.meshCount; ++m) {
+			const Material* material = &model.materials[model.meshMaterial[m]];
+			const Color base = material->maps[MATERIAL_MAP_DIFFUSE].color;
+			const Color color = {
+				static_cast<unsigned char>(base.r * tint.r / 255), static_cast<unsigned char>(base.g * tint.g / 255),
+				static_cast<unsigned char>(base.b * tint.b / 255), static_cast<unsigned char>(base.a * tint.a / 255),
+			};
+			out.push_back({ &model.meshes[m], material, transform, color });
+		}
+	}
+
+public:
+	// A Gather() chunk's items, recorded on whichever thread runs it.
+	class Recorder {
+	public:
+		// As DrawModel, placed by `transform` (what DrawModel builds from position and scale).
+		void Add(const Model& model, const Matrix& transform, Color tint) {
+			Record(items, model, transform, tint);
+		}
+
+	private:
+		friend class RenderQueue;
+		std::vector<Item> items;
+	};
+
+private:
+
+	static bool SameColor(Color a, Color b) {
+		return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+	}
+
+	static bool IsCubemap(int map) {
+		return map == MATERIAL_MAP_IRRADIANCE || map == MATERIAL_MAP_PREFILTER || map == MATERIAL_MAP_CUBEMAP;
+	}
+
+	// Rebinds only the units whose texture changed; the sampler uniforms are set every time, as
+	// the program may have changed under them.
+	static void BindMaps(const Material& material, unsigned int* bound) {
+		for (int i = 0; i < C_MATERIAL_MAPS; ++i) {
+			const unsigned int id = material.maps[i].texture.id;
+			if (id == 0) continue;
+			if (bound[i] != id) {
+				rlActiveTextureSlot(i);
+				if (IsCubemap(i)) rlEnableTextureCubemap(id);
+				else rlEnableTexture(id);
+				bound[i] = id;
+			}
+			rlSetUniform(material.shader.locs[SHADER_LOC_MAP_DIFFUSE + i], &i, SHADER_UNIFORM_INT, 1);
+		}
+	}
+
+	// The binds the same items would have taken drawn as they were added.
+	void CountUnsorted() {
+		const Item* last = nullptr;
+		for (const Item& item : items) {
+			const bool newShader = (last == nullptr || last->material->shader.id != item.material->shader.id);
+			stats.unsortedShaders += newShader ? 1 : 0;
+			stats.unsortedMaterials += (newShader || last->material != item.material) ? 1 : 0;
+			stats.unsortedMeshes += (newShader || last->mesh->vaoId != item.mesh->vaoId) ? 1 : 0;
+			last = &item;
+		}
+	}
+
+	std::vector<Item>                               items;
+	std::vector<uint64_t>                           keys;
+	std::vector<uint32_t>                           order;
+	std::vector<uint64_t>                           keyScratch;
+	std::vector<uint32_t>                           orderScratch;
+	std::unordered_map<const Material*, uint32_t>   materialIndex;
+	std::vector<Recorder>                           recorders;  // one per Gather() chunk, kept for their capacity
+	int                                             gathered = 0;
+	Stats                                           stats;
+};
+
+#endif // RENDER_QUEUE_H
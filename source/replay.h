@@ -0,0 +1,88 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// --- REPLAY ---
+// A recorded play session: the RNG seed plus, for every rendered frame, how many fixed
+// ticks it ran and the input it sampled. Input is only ever read once per frame, so this
+// is everything the simulation consumes; replaying it from the same seed reproduces the
+// session tick for tick, in a window or headless.
+//
+// File format (text): a "POIGK-REPLAY 3" line, a "seed <n>" line, a "lockstep <0|1>"
+// line (World::SetLockstep; version 1 files have none and are float sessions), a
+// "spatial-sort <ticks>" line (Scenario::spatialSort, which renumbers entities and so
+// changes hit order; older files have none and were recorded without it), then one
+// "<ticks> <held> <pressed>" line per frame, masks in hex.
+struct FrameInput {
+	int      ticks = 0;
+	uint32_t held = 0;
+	uint32_t pressed = 0;
+};
+
+struct Replay {
+	uint64_t                seed = 0;
+	bool                    lockstep = false;
+	int                     spatialSort = 0;
+	std::vector<FrameInput> frames;
+
+	bool Save(const char* path) const {
+		FILE* f = Open(path, "wb");
+		if (!f) return false;
+		fprintf(f, "POIGK-REPLAY 3\nseed %llu\nlockstep %d\nspatial-sort %d\n", static_cast<unsigned long long>(seed), lockstep ? 1 : 0, spatialSort);
+		for (const FrameInput& in : frames) {
+			fprintf(f, "%d %x %x\n", in.ticks, in.held, in.pressed);
+		}
+		fclose(f);
+		return true;
+	}
+
+	bool Load(const char* path) {
+		FILE* f = Open(path, "rb");
+		if (!f) return false;
+		int version = 0;
+		unsigned long long s = 0;
+		int fixed = 0;
+		int sort = 0;
+		bool ok = Scan(f, "POIGK-REPLAY %d\n", &version) == 1 && version >= 1 && version <= 3
+			&& Scan(f, "seed %llu\n", &s) == 1
+			&& (version == 1 || Scan(f, "lockstep %d\n", &fixed) == 1)
+			&& (version < 3 || Scan(f, "spatial-sort %d\n", &sort) == 1);
+		frames.clear();
+		if (ok) {
+			seed = s;
+			lockstep = fixed != 0;
+			spatialSort = sort;
+			FrameInput in;
+			while (Scan(f, "%d %x %x\n", &in.ticks, &in.held, &in.pressed) == 3) {
+				frames.push_back(in);
+			}
+		}
+		fclose(f);
+		return ok;
+	}
+
+private:
+	static FILE* Open(const char* path, const char* mode) {
+		FILE* f = nullptr;
+#if defined(_MSC_VER)
+		if (fopen_s(&f, path, mode) != 0) f = nullptr;
+#else
+		f = fopen(path, mode);
+#endif
+		return f;
+	}
+
+	template<typename... Args>
+	static int Scan(FILE* f, const char* fmt, Args... args) {
+#if defined(_MSC_VER)
+		return fscanf_s(f, fmt, args...);
+#else
+		return fscanf(f, fmt, args...);
+#endif
+	}
+};
+
+#endif // REPLAY_H
@@ -0,0 +1,564 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// --- REPLICATION ---
+// World state for spectators and remote players at a fraction of its size. Asteroids and
+// projectiles fly straight at a constant speed between changes, so a body is sent only
+// when its slot gets a new course (a spawn, a split, a compaction landing a survivor in
+// it, a shot fired into it) or dies, and the other end extrapolates it from then on. A
+// packet carries, per stream, the slot window and every slot that changed after the
+// packet the receiver last acknowledged; ships, which steer every tick, are sent as
+// differences from their state in that packet. A lost packet costs nothing extra: the
+// next one still covers everything since the acknowledged one, so the link may drop or
+// reorder packets freely. Packets are numbered by `sequence`, one per frame sent, and
+// stamped with the simulation `clock` in ticks, which bodies are extrapolated along.
+// Every value is quantized (Format) and bit-packed: a new asteroid takes about twelve
+// bytes against the 25 of its floats.
+//
+// Server and Client know nothing of the game; main.cpp's ReplicationSource fills a
+// Server from a World.
+namespace Replication {
+	// A body on a straight course as of some clock tick. `kind` is the game's 4-bit code.
+	struct Body {
+		float   x = 0.f, y = 0.f;
+		float   vx = 0.f, vy = 0.f;
+		float   rotation = 0.f;  // degrees
+		float   spin = 0.f;      // degrees per second
+		uint8_t kind = 0;
+	};
+
+	struct Ship {
+		float   x = 0.f, y = 0.f;
+		float   rotation = 0.f;  // degrees
+		int32_t hp = 0;
+		int32_t score = 0;
+		bool    alive = false;
+	};
+
+	class BitWriter {
+	public:
+		void Clear() {
+			bytes.clear();
+			acc = 0;
+			used = 0;
+		}
+
+		// The low `bits` (at most 32) of v.
+		void Write(uint32_t v, int bits) {
+			const uint64_t mask = bits >= 32 ? 0xFFFFFFFFull : (uint64_t{ 1 } << bits) - 1;
+			acc |= (static_cast<uint64_t>(v) & mask) << used;
+			used += bits;
+			while (used >= 8) {
+				bytes.push_back(static_cast<uint8_t>(acc));
+				acc >>= 8;
+				used -= 8;
+			}
+		}
+
+		void WriteBool(bool b) {
+			Write(b ? 1u : 0u, 1);
+		}
+
+		// Groups of C_GROUP bits, each followed by a continuation bit: 5 bits below 16.
+		void WriteVarint(uint32_t v) {
+			for (;;) {
+				Write(v, C_GROUP);
+				v >>= C_GROUP;
+				WriteBool(v != 0);
+				if (v == 0) return;
+			}
+		}
+
+		void WriteSigned(int32_t v) {
+			WriteVarint((static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31));
+		}
+
+		// The packet, padded to a whole byte.
+		const std::vector<uint8_t>& Finish() {
+			if (used > 0) {
+				bytes.push_back(static_cast<uint8_t>(acc));
+				acc = 0;
+				used = 0;
+			}
+			return bytes;
+		}
+
+		static constexpr int C_GROUP = 4;
+
+	private:
+		std::vector<uint8_t> bytes;
+		uint64_t             acc = 0;
+		int                  used = 0;
+	};
+
+	// Reading past the end yields zeros and clears Ok().
+	class BitReader {
+	public:
+		BitReader(const uint8_t* data_, size_t size_) : data(data_), size(size_) {}
+
+		uint32_t Read(int bits) {
+			while (used < bits) {
+				if (at == size) {
+					ok = false;
+					return 0;
+				}
+				acc |= static_cast<uint64_t>(data[at++]) << used;
+				used += 8;
+			}
+			const uint64_t mask = bits >= 32 ? 0xFFFFFFFFull : (uint64_t{ 1 } << bits) - 1;
+			const uint32_t v = static_cast<uint32_t>(acc & mask);
+			acc >>= bits;
+			used -= bits;
+			return v;
+		}
+
+		bool ReadBool() {
+			return Read(1) != 0;
+		}
+
+		uint32_t ReadVarint() {
+			uint32_t v = 0;
+			for (int shift = 0; shift < 32 && ok; shift += BitWriter::C_GROUP) {
+				v |= Read(BitWriter::C_GROUP) << shift;
+				if (!ReadBool()) return v;
+			}
+			ok = false;
+			return 0;
+		}
+
+		int32_t ReadSigned() {
+			const uint32_t z = ReadVarint();
+			return static_cast<int32_t>(z >> 1) ^ -static_cast<int32_t>(z & 1);
+		}
+
+		bool Ok() const {
+			return ok;
+		}
+
+	private:
+		const uint8_t* data;
+		size_t         size;
+		size_t         at = 0;
+		uint64_t       acc = 0;
+		int            used = 0;
+		bool           ok = true;
+	};
+
+	// Quantization both ends agree on, from the world's size. Body positions are in 1/8 px
+	// over the world plus C_MARGIN on every side (bodies spawn just outside it). Nothing
+	// keeps ships on the playfield, so theirs are 32-bit Coordinates in 1/8 px, which cost
+	// no more once sent as differences. Velocities are in 1/16 px/s up to +-2048, angles
+	// in 1/4096 of a turn and spins in 1/8 degree/s up to +-512. Values past a range are
+	// clamped.
+	class Format {
+	public:
+		static constexpr float C_POSITION_SCALE = 8.f;
+		static constexpr float C_MARGIN = 256.f;
+		static constexpr float C_VELOCITY_SCALE = 16.f;
+		static constexpr int   C_VELOCITY_BITS = 16;
+		static constexpr int   C_ANGLE_BITS = 12;
+		static constexpr float C_SPIN_SCALE = 8.f;
+		static constexpr int   C_SPIN_BITS = 13;
+		static constexpr int   C_KIND_BITS = 4;
+
+		Format(float width, float height) {
+			const float extent = (width > height ? width : height) + 2.f * C_MARGIN;
+			positionBits = static_cast<int>(std::bit_width(static_cast<uint32_t>(extent * C_POSITION_SCALE)));
+		}
+
+		int PositionBits() const {
+			return positionBits;
+		}
+
+		uint32_t Position(float v) const {
+			return Clamp(lrintf((v + C_MARGIN) * C_POSITION_SCALE), 0, (1 << positionBits) - 1);
+		}
+
+		static float Position(uint32_t q) {
+			return static_cast<float>(q) / C_POSITION_SCALE - C_MARGIN;
+		}
+
+		static uint32_t Coordinate(float v) {
+			return static_cast<uint32_t>(static_cast<int32_t>(lrintf(v * C_POSITION_SCALE)));
+		}
+
+		static float Coordinate(uint32_t q) {
+			return static_cast<float>(static_cast<int32_t>(q)) / C_POSITION_SCALE;
+		}
+
+		static uint32_t Velocity(float v) {
+			return Signed(v * C_VELOCITY_SCALE, C_VELOCITY_BITS);
+		}
+
+		static float Velocity(uint32_t q) {
+			return static_cast<float>(Unsigned(q, C_VELOCITY_BITS)) / C_VELOCITY_SCALE;
+		}
+
+		static uint32_t Angle(float degrees) {
+			const float turns = degrees / 360.f;
+			return static_cast<uint32_t>(lrintf((turns - floorf(turns)) * (1 << C_ANGLE_BITS))) & ((1u << C_ANGLE_BITS) - 1);
+		}
+
+		static float Angle(uint32_t q) {
+			return static_cast<float>(q) * (360.f / (1 << C_ANGLE_BITS));
+		}
+
+		static uint32_t Spin(float v) {
+			return Signed(v * C_SPIN_SCALE, C_SPIN_BITS);
+		}
+
+		static float Spin(uint32_t q) {
+			return static_cast<float>(Unsigned(q, C_SPIN_BITS)) / C_SPIN_SCALE;
+		}
+
+	private:
+		static uint32_t Clamp(long v, long lo, long hi) {
+			return static_cast<uint32_t>(v < lo ? lo : v > hi ? hi : v);
+		}
+
+		// Two's complement in `bits`.
+		static uint32_t Signed(float v, int bits) {
+			const long half = 1L << (bits - 1);
+			return Clamp(lrintf(v), -half, half - 1) & ((1u << bits) - 1);
+		}
+
+		static int32_t Unsigned(uint32_t q, int bits) {
+			return static_cast<int32_t>(q << (32 - bits)) >> (32 - bits);
+		}
+
+		int positionBits;
+	};
+
+	inline constexpr uint32_t C_NONE = 0;      // sequences count from 1; an ack of 0 asks for everything
+	inline constexpr size_t   C_HISTORY = 64;  // packets' ship states kept for deltas, both ends
+
+	// Server side of one stream of slots: when each slot last changed, and the window of
+	// live slots [Begin(), End()).
+	class Stream {
+	public:
+		void SetWindow(size_t begin, size_t end) {
+			windowBegin = begin;
+			windowEnd = end;
+			if (changed.size() < end) changed.resize(end, C_NONE);
+		}
+
+		// Slot `slot` changed for the packet `sequence`.
+		void Touch(size_t slot, uint32_t sequence) {
+			if (changed.size() <= slot) changed.resize(slot + 1, C_NONE);
+			changed[slot] = sequence;
+		}
+
+		// Every slot of the window, after the game renumbered them.
+		void TouchWindow(uint32_t sequence) {
+			for (size_t s = windowBegin; s < windowEnd; ++s) Touch(s, sequence);
+		}
+
+		size_t Begin() const { return windowBegin; }
+		size_t End() const { return windowEnd; }
+
+		// The window, then every slot of it that changed after `ack` (all of them for
+		// C_NONE) as a gap from the previous one, a live bit and, if live, its course.
+		// body(slot, out) fills the course and returns whether the slot is live; `rotating`
+		// streams also carry rotation and spin.
+		template<typename BodyFn>
+		void Encode(BitWriter& out, const Format& format, uint32_t ack, bool rotating, BodyFn&& body) {
+			pending.clear();
+			for (size_t s = windowBegin; s < windowEnd; ++s) {
+				if (ack == C_NONE || changed[s] > ack) pending.push_back(static_cast<uint32_t>(s));
+			}
+			out.WriteVarint(static_cast<uint32_t>(windowBegin));
+			out.WriteVarint(static_cast<uint32_t>(windowEnd - windowBegin));
+			out.WriteVarint(static_cast<uint32_t>(pending.size()));
+			uint32_t next = static_cast<uint32_t>(windowBegin);
+			Body b;
+			for (uint32_t s : pending) {
+				out.WriteVarint(s - next);
+				next = s + 1;
+				const bool live = body(static_cast<size_t>(s), b);
+				out.WriteBool(live);
+				if (!live) continue;
+				out.Write(format.Position(b.x), format.PositionBits());
+				out.Write(format.Position(b.y), format.PositionBits());
+				out.Write(Format::Velocity(b.vx), Format::C_VELOCITY_BITS);
+				out.Write(Format::Velocity(b.vy), Format::C_VELOCITY_BITS);
+				if (rotating) {
+					out.Write(Format::Angle(b.rotation), Format::C_ANGLE_BITS);
+					out.Write(Format::Spin(b.spin), Format::C_SPIN_BITS);
+				}
+				out.Write(b.kind, Format::C_KIND_BITS);
+			}
+		}
+
+	private:
+		std::vector<uint32_t> changed;  // per slot: the sequence it last changed in
+		std::vector<uint32_t> pending;  // Encode scratch
+		size_t                windowBegin = 0;
+		size_t                windowEnd = 0;
+	};
+
+	namespace Detail {
+		struct QuantizedShip {
+			uint32_t x = 0, y = 0, rotation = 0, hp = 0, score = 0, alive = 0;
+		};
+
+		struct ShipFrame {
+			uint32_t                   sequence = C_NONE;
+			std::vector<QuantizedShip> ships;
+		};
+
+		// The ship frame of packet `sequence`, if still kept.
+		inline const ShipFrame* Find(const std::vector<ShipFrame>& history, uint32_t sequence) {
+			if (sequence == C_NONE) return nullptr;
+			const ShipFrame& f = history[sequence % C_HISTORY];
+			return f.sequence == sequence ? &f : nullptr;
+		}
+
+		// An unchanged field costs one bit.
+		inline void WriteDelta(BitWriter& out, uint32_t value, uint32_t base) {
+			out.WriteBool(value != base);
+			if (value != base) out.WriteSigned(static_cast<int32_t>(value - base));
+		}
+
+		inline uint32_t ReadDelta(BitReader& in, uint32_t base) {
+			return in.ReadBool() ? base + static_cast<uint32_t>(in.ReadSigned()) : base;
+		}
+	}
+
+	class Server {
+	public:
+		Server(float width, float height) : format(width, height), history(C_HISTORY) {}
+
+		Stream& Asteroids() { return asteroids; }
+		Stream& Projectiles() { return projectiles; }
+
+		// Starts packet `sequence` at simulation tick `clock` with the fleet as it is then.
+		// Once per packet, before the streams are touched for it; both only go up.
+		void Begin(uint32_t sequence, uint32_t clock_, const Ship* ships, size_t count) {
+			current = sequence;
+			clock = clock_;
+			Detail::ShipFrame& f = history[sequence % C_HISTORY];
+			f.sequence = sequence;
+			f.ships.resize(count);
+			for (size_t i = 0; i < count; ++i) {
+				const Ship& s = ships[i];
+				Detail::QuantizedShip& q = f.ships[i];
+				q.x = Format::Coordinate(s.x);
+				q.y = Format::Coordinate(s.y);
+				q.rotation = Format::Angle(s.rotation);
+				q.hp = static_cast<uint32_t>(s.hp < 0 ? 0 : s.hp > 255 ? 255 : s.hp);
+				q.score = static_cast<uint32_t>(s.score);
+				q.alive = s.alive ? 1 : 0;
+			}
+		}
+
+		// The packet for a receiver that last acknowledged `ack`. Ships are sent against
+		// that packet's when it is still in the history, whole otherwise.
+		template<typename AsteroidFn, typename ProjectileFn>
+		const std::vector<uint8_t>& Encode(uint32_t ack, AsteroidFn&& asteroid, ProjectileFn&& projectile) {
+			const Detail::ShipFrame* base = Detail::Find(history, ack);
+			if (!base) ack = C_NONE;
+			out.Clear();
+			out.Write(current, 32);
+			out.WriteVarint(ack == C_NONE ? 0 : current - ack);
+			out.Write(clock, 32);
+			asteroids.Encode(out, format, ack, true, asteroid);
+			projectiles.Encode(out, format, ack, false, projectile);
+
+			const Detail::ShipFrame& f = history[current % C_HISTORY];
+			out.WriteVarint(static_cast<uint32_t>(f.ships.size()));
+			const Detail::QuantizedShip none;
+			for (size_t i = 0; i < f.ships.size(); ++i) {
+				const Detail::QuantizedShip& q = f.ships[i];
+				const Detail::QuantizedShip& b = base && i < base->ships.size() ? base->ships[i] : none;
+				Detail::WriteDelta(out, q.x, b.x);
+				Detail::WriteDelta(out, q.y, b.y);
+				Detail::WriteDelta(out, q.rotation, b.rotation);
+				Detail::WriteDelta(out, q.hp, b.hp);
+				Detail::WriteDelta(out, q.score, b.score);
+				out.WriteBool(q.alive != 0);
+			}
+			return out.Finish();
+		}
+
+	private:
+		Format                         format;
+		Stream                         asteroids;
+		Stream                         projectiles;
+		std::vector<Detail::ShipFrame> history;
+		uint32_t                       current = C_NONE;
+		uint32_t                       clock = 0;
+		BitWriter                      out;
+	};
+
+	// The receiving end: a copy of every body's last course, extrapolated on demand, and
+	// the ships of the newest packet.
+	class Client {
+	public:
+		Client(float width, float height, float tickDt_) : format(width, height), tickDt(tickDt_), history(C_HISTORY) {}
+
+		// Applies a packet. Returns false, changing nothing, for a corrupt one or one
+		// against a ship frame this end no longer has; an older packet than the newest
+		// applied is ignored and returns true.
+		bool Apply(const uint8_t* data, size_t size) {
+			BitReader in(data, size);
+			const uint32_t sequence = in.Read(32);
+			const uint32_t back = in.ReadVarint();
+			const uint32_t now = in.Read(32);
+			if (!in.Ok()) return false;
+			if (sequence <= latest) return true;
+			const Detail::ShipFrame* base = back ? Detail::Find(history, sequence - back) : nullptr;
+			if (back && !base) return false;
+
+			if (!ReadStream(in, now, true, scratchA)) return false;
+			if (!ReadStream(in, now, false, scratchP)) return false;
+
+			const uint32_t count = in.ReadVarint();
+			if (!in.Ok() || count > C_MAX_SHIPS) return false;
+			Detail::ShipFrame next{ sequence, std::vector<Detail::QuantizedShip>(count) };
+			const Detail::QuantizedShip none;
+			for (uint32_t i = 0; i < count; ++i) {
+				const Detail::QuantizedShip& b = base && i < base->ships.size() ? base->ships[i] : none;
+				Detail::QuantizedShip& q = next.ships[i];
+				q.x = Detail::ReadDelta(in, b.x);
+				q.y = Detail::ReadDelta(in, b.y);
+				q.rotation = Detail::ReadDelta(in, b.rotation);
+				q.hp = Detail::ReadDelta(in, b.hp);
+				q.score = Detail::ReadDelta(in, b.score);
+				q.alive = in.ReadBool() ? 1 : 0;
+			}
+			if (!in.Ok()) return false;
+
+			Commit(asteroidWindow, asteroids, scratchA);
+			Commit(projectileWindow, projectiles, scratchP);
+			history[sequence % C_HISTORY] = std::move(next);
+			latest = sequence;
+			clock = now;
+			return true;
+		}
+
+		// The newest packet applied, to acknowledge to the server.
+		uint32_t Ack() const {
+			return latest;
+		}
+
+		// The simulation tick of that packet.
+		uint32_t Clock() const {
+			return clock;
+		}
+
+		size_t AsteroidBegin() const { return asteroidWindow.begin; }
+		size_t AsteroidEnd() const { return asteroidWindow.end; }
+		size_t ProjectileBegin() const { return projectileWindow.begin; }
+		size_t ProjectileEnd() const { return projectileWindow.end; }
+
+		// Slot `slot` extrapolated to simulation tick `at`; false if it is dead or outside
+		// the window.
+		bool Asteroid(size_t slot, uint32_t at, Body& out) const {
+			return At(asteroidWindow, asteroids, slot, at, out);
+		}
+
+		bool Projectile(size_t slot, uint32_t at, Body& out) const {
+			return At(projectileWindow, projectiles, slot, at, out);
+		}
+
+		size_t ShipCount() const {
+			const Detail::ShipFrame* f = Detail::Find(history, latest);
+			return f ? f->ships.size() : 0;
+		}
+
+		// As of Ack().
+		Ship GetShip(size_t i) const {
+			const Detail::QuantizedShip& q = Detail::Find(history, latest)->ships[i];
+			return { Format::Coordinate(q.x), Format::Coordinate(q.y), Format::Angle(q.rotation),
+				static_cast<int32_t>(q.hp), static_cast<int32_t>(q.score), q.alive != 0 };
+		}
+
+	private:
+		static constexpr uint32_t C_MAX_SHIPS = 1u << 16;
+		static constexpr uint32_t C_MAX_SLOTS = 1u << 24;
+
+		struct Entry {
+			Body     body;
+			uint32_t clock = 0;  // as of
+			bool     live = false;
+		};
+
+		struct Window {
+			size_t begin = 0, end = 0;
+		};
+
+		// A stream's decoded records, applied only once the whole packet has read cleanly.
+		struct Pending {
+			Window                window;
+			std::vector<uint32_t> slots;
+			std::vector<Entry>    entries;
+		};
+
+		bool ReadStream(BitReader& in, uint32_t now, bool rotating, Pending& p) {
+			p.window.begin = in.ReadVarint();
+			p.window.end = p.window.begin + in.ReadVarint();
+			const uint32_t n = in.ReadVarint();
+			if (!in.Ok() || p.window.end > C_MAX_SLOTS || n > p.window.end - p.window.begin) return false;
+			p.slots.resize(n);
+			p.entries.resize(n);
+			uint32_t next = static_cast<uint32_t>(p.window.begin);
+			for (uint32_t k = 0; k < n; ++k) {
+				const uint32_t s = next + in.ReadVarint();
+				if (s >= p.window.end) return false;
+				next = s + 1;
+				Entry& e = p.entries[k];
+				e.clock = now;
+				e.live = in.ReadBool();
+				p.slots[k] = s;
+				if (!e.live) continue;
+				e.body.x = Format::Position(in.Read(format.PositionBits()));
+				e.body.y = Format::Position(in.Read(format.PositionBits()));
+				e.body.vx = Format::Velocity(in.Read(Format::C_VELOCITY_BITS));
+				e.body.vy = Format::Velocity(in.Read(Format::C_VELOCITY_BITS));
+				if (rotating) {
+					e.body.rotation = Format::Angle(in.Read(Format::C_ANGLE_BITS));
+					e.body.spin = Format::Spin(in.Read(Format::C_SPIN_BITS));
+				}
+				else {
+					e.body.rotation = e.body.spin = 0.f;
+				}
+				e.body.kind = static_cast<uint8_t>(in.Read(Format::C_KIND_BITS));
+			}
+			return in.Ok();
+		}
+
+		static void Commit(Window& window, std::vector<Entry>& entries, const Pending& p) {
+			window = p.window;
+			if (entries.size() < window.end) entries.resize(window.end);
+			for (size_t k = 0; k < p.slots.size(); ++k) entries[p.slots[k]] = p.entries[k];
+		}
+
+		bool At(const Window& window, const std::vector<Entry>& entries, size_t slot, uint32_t at, Body& out) const {
+			if (slot < window.begin || slot >= window.end || !entries[slot].live) return false;
+			const Entry& e = entries[slot];
+			const float t = (static_cast<float>(at) - static_cast<float>(e.clock)) * tickDt;
+			out = e.body;
+			out.x += e.body.vx * t;
+			out.y += e.body.vy * t;
+			out.rotation += e.body.spin * t;
+			return true;
+		}
+
+		Format                         format;
+		float                          tickDt;
+		std::vector<Entry>             asteroids, projectiles;
+		Window                         asteroidWindow, projectileWindow;
+		Pending                        scratchA, scratchP;
+		std::vector<Detail::ShipFrame> history;
+		uint32_t                       latest = C_NONE;
+		uint32_t                       clock = 0;
+	};
+}
+
+#endif // REPLICATION_H
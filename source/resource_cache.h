@@ -0,0 +1,129 @@
+#ifndef RESOURCE_CACHE_H
+#define RESOURCE_CACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "raylib.h"
+#include "asset_cache.h"
+#include "shader_cache.h"
+
+// --- RESOURCE CACHE ---
+// One GPU copy of each texture and shader however many users load it. The Load* functions
+// below hand out refcounted handles keyed by path: the first load goes to the loader
+// (AssetCache or ShaderCache), every later one while a handle is still alive is a lookup
+// that returns the same resource, and the last handle to go unloads it.
+// Users that set per-program state on a shader (uniform values, locs) share it with every
+// other holder of the same sources; two users that need different values load through
+// ShaderCache::Load instead and get programs of their own. Main thread only, like the GL
+// calls behind it; handles must be released before the window closes.
+namespace ResourceCache {
+	namespace Detail {
+		template<typename T>
+		struct Entry {
+			T           resource{};
+			int         refs = 0;
+			std::string key;
+		};
+
+		// Map nodes don't move, so handles point straight at their entry.
+		template<typename T>
+		inline std::unordered_map<std::string, Entry<T>>& Entries() {
+			static std::unordered_map<std::string, Entry<T>> entries;
+			return entries;
+		}
+
+		inline void Unload(const Texture2D& t) { UnloadTexture(t); }
+		inline void Unload(const Shader& s) { UnloadShader(s); }
+	}
+
+	// A share of a cached resource; empty when its load failed. Copies share too.
+	template<typename T>
+	class Handle {
+	public:
+		Handle() = default;
+
+		Handle(const Handle& other) : entry(other.entry) {
+			if (entry) ++entry->refs;
+		}
+
+		Handle(Handle&& other) noexcept : entry(std::exchange(other.entry, nullptr)) {}
+
+		Handle& operator=(Handle other) noexcept {
+			std::swap(entry, other.entry);
+			return *this;
+		}
+
+		~Handle() {
+			Release();
+		}
+
+		// Lets go early; the resource is unloaded if this was its last handle.
+		void Release() {
+			if (!entry) return;
+			if (--entry->refs == 0) {
+				Detail::Unload(entry->resource);
+				const std::string key = std::move(entry->key);  // erase would destroy it mid-lookup
+				Detail::Entries<T>().erase(key);
+			}
+			entry = nullptr;
+		}
+
+		explicit operator bool() const {
+			return entry != nullptr;
+		}
+
+		// Valid while this handle holds it. A default T when empty.
+		const T& Get() const {
+			static const T none{};
+			return entry ? entry->resource : none;
+		}
+
+		// Loads `key` with load(T&) on a miss, which returns false when it failed.
+		template<typename Fn>
+		static Handle Acquire(const std::string& key, Fn&& load) {
+			auto& entries = Detail::Entries<T>();
+			auto it = entries.find(key);
+			if (it != entries.end()) return Handle(&it->second);
+			T resource{};
+			if (!load(resource)) return Handle();
+			Detail::Entry<T>& e = entries[key];
+			e.resource = resource;
+			e.key = key;
+			return Handle(&e);
+		}
+
+	private:
+		explicit Handle(Detail::Entry<T>* e) : entry(e) {
+			++entry->refs;
+		}
+
+		Detail::Entry<T>* entry = nullptr;
+	};
+
+	using TextureHandle = Handle<Texture2D>;
+	using ShaderHandle = Handle<Shader>;
+
+	// Through AssetCache::LoadTexture, so the pixels are cooked on the first run.
+	inline TextureHandle LoadTexture(const char* fileName) {
+		return TextureHandle::Acquire(fileName, [&](Texture2D& t) {
+			t = AssetCache::LoadTexture(fileName);
+			return t.id != 0;
+		});
+	}
+
+	// Through ShaderCache::Load; either path may be nullptr for raylib's default stage. A
+	// shader that failed to build isn't kept, and the handle is empty.
+	inline ShaderHandle LoadShader(const char* vsFileName, const char* fsFileName) {
+		const std::string key = std::string(vsFileName ? vsFileName : "") + '\n' + (fsFileName ? fsFileName : "");
+		return ShaderHandle::Acquire(key, [&](Shader& s) {
+			s = ShaderCache::Load(vsFileName, fsFileName);
+			if (s.id != rlGetShaderIdDefault()) return true;
+			s = Shader{};
+			return false;
+		});
+	}
+}
+
+#endif // RESOURCE_CACHE_H
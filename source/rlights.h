@@ -9,6 +9,12 @@
 *       If not defined, the library is in header only mode and can be included in other headers 
 *       or source files without problems. But only ONE file should hold the implementation.
 *
+*   LIGHT BUFFER:
+*       Instead of UpdateLightValues() per light per shader, all lights can live in one uniform
+*       buffer (block "LightBlock", std140, binding LIGHT_BUFFER_BINDING) shared by every shader
+*       bound with BindLightBuffer(). UpdateLightBuffer() keeps a copy of what the GPU holds and
+*       only uploads runs of lights that changed, so a static scene costs no uploads at all.
+*
 *   LICENSE: zlib/libpng
 *
 *   Copyright (c) 2017-2024 Victor Fisac (@victorfisac) and Ramon Santamaria (@raysan5)
@@ -37,6 +43,7 @@
 // Defines and Macros
 //----------------------------------------------------------------------------------
 #define MAX_LIGHTS  4         // Max dynamic lights supported by shader
+#define LIGHT_BUFFER_BINDING  0     // Uniform buffer binding point used by the light buffer
 
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
@@ -76,6 +83,11 @@ extern "C" {            // Prevents name mangling of functions
 	Light CreateLight(int type, Vector3 position, Vector3 target, Color color, Shader shader);   // Create a light and get shader locations
 	void UpdateLightValues(Shader shader, Light light);         // Send light properties to shader
 
+	void InitLightBuffer(void);                                 // Create the shared light uniform buffer
+	void UnloadLightBuffer(void);                               // Delete the shared light uniform buffer
+	bool BindLightBuffer(Shader shader);                        // Point a shader's LightBlock at the buffer (false if it has none)
+	int UpdateLightBuffer(const Light *lights, int count);      // Upload changed lights, returns number of uploads made
+
 	#ifdef __cplusplus
 }
 #endif
@@ -89,9 +101,13 @@ extern "C" {            // Prevents name mangling of functions
 	*
 	************************************************************************************/
 
-#if defined(RLIGHTS_IMPLEMENTATION)
+#if defined(RLIGHTS_IMPLEMENTATION) && !defined(RLIGHTS_IMPLEMENTED)
+#define RLIGHTS_IMPLEMENTED     // Headers may include rlights.h again after the implementation
 
 #include "raylib.h"
+#include "external/glad.h"      // Uniform buffers are not exposed by rlgl
+
+#include <string.h>             // Required for: memcmp(), memcpy()
 
 //----------------------------------------------------------------------------------
 // Defines and Macros
@@ -101,13 +117,27 @@ extern "C" {            // Prevents name mangling of functions
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
-// ...
+
+// One light as laid out in LightBlock (std140: vec3 and vec4 members start on 16 bytes)
+typedef struct {
+	int enabled;
+	int type;
+	int padding0[2];
+	float position[3];
+	float padding1;
+	float target[3];
+	float padding2;
+	float color[4];
+} LightRecord;
 
 //----------------------------------------------------------------------------------
 // Global Variables Definition
 //----------------------------------------------------------------------------------
 static int lightsCount = 0;    // Current amount of created lights
 
+static unsigned int lightBuffer = 0;            // Shared light uniform buffer
+static LightRecord lightRecords[MAX_LIGHTS];    // What the buffer currently holds
+
 //----------------------------------------------------------------------------------
 // Module specific Functions Declaration
 //----------------------------------------------------------------------------------
@@ -167,4 +197,85 @@ void UpdateLightValues(Shader shader, Light light)
 	SetShaderValue(shader, light.colorLoc, color, SHADER_UNIFORM_VEC4);
 }
 
+// Create the shared light uniform buffer, all lights zeroed (disabled)
+void InitLightBuffer(void)
+{
+	memset(lightRecords, 0, sizeof(lightRecords));
+
+	glGenBuffers(1, &lightBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, lightBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(lightRecords), lightRecords, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BUFFER_BINDING, lightBuffer);
+}
+
+// Delete the shared light uniform buffer
+void UnloadLightBuffer(void)
+{
+	glDeleteBuffers(1, &lightBuffer);
+	lightBuffer = 0;
+}
+
+// Point a shader's LightBlock at the buffer binding
+// NOTE: Needed again for any program that replaces this one
+bool BindLightBuffer(Shader shader)
+{
+	unsigned int block = glGetUniformBlockIndex(shader.id, "LightBlock");
+	if (block == GL_INVALID_INDEX) return false;
+
+	glUniformBlockBinding(shader.id, block, LIGHT_BUFFER_BINDING);
+	return true;
+}
+
+// Upload the lights that differ from what the buffer holds
+// NOTE: Consecutive changed lights go up as one range, so the return value counts
+// glBufferSubData calls, not lights
+int UpdateLightBuffer(const Light *lights, int count)
+{
+	if (count > MAX_LIGHTS) count = MAX_LIGHTS;
+
+	int uploads = 0;
+	int first = -1;     // First light of the current changed run
+
+	glBindBuffer(GL_UNIFORM_BUFFER, lightBuffer);
+
+	for (int i = 0; i <= count; i++)
+	{
+		bool changed = false;
+
+		if (i < count)
+		{
+			const Light *light = &lights[i];
+			LightRecord record = { 0 };
+			record.enabled = light->enabled? 1 : 0;
+			record.type = light->type;
+			record.position[0] = light->position.x;
+			record.position[1] = light->position.y;
+			record.position[2] = light->position.z;
+			record.target[0] = light->target.x;
+			record.target[1] = light->target.y;
+			record.target[2] = light->target.z;
+			record.color[0] = (float)light->color.r/(float)255;
+			record.color[1] = (float)light->color.g/(float)255;
+			record.color[2] = (float)light->color.b/(float)255;
+			record.color[3] = (float)light->color.a/(float)255;
+
+			changed = (memcmp(&record, &lightRecords[i], sizeof(LightRecord)) != 0);
+			if (changed) memcpy(&lightRecords[i], &record, sizeof(LightRecord));
+		}
+
+		if (changed && (first < 0)) first = i;
+		else if (!changed && (first >= 0))
+		{
+			glBufferSubData(GL_UNIFORM_BUFFER, first*sizeof(LightRecord), (i - first)*sizeof(LightRecord), &lightRecords[first]);
+			uploads++;
+			first = -1;
+		}
+	}
+
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	return uploads;
+}
+
 #endif // RLIGHTS_IMPLEMENTATION
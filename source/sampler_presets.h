@@ -0,0 +1,140 @@
+#ifndef SAMPLER_PRESETS_H
+#define SAMPLER_PRESETS_H
+
+#include <algorithm>
+#include <vector>
+
+#include <raylib.h>
+#include <rlgl.h>
+#include <external/glad.h>
+
+// --- SAMPLER PRESETS ---
+// How each registered texture is filtered, decided by what it is (its Class) and a global
+// quality tier rather than by whoever loaded it. Tier 0 samples at full quality; each tier
+// above it trades sharpness for texture bandwidth: less anisotropy first, then single-level
+// mip filtering, then a positive LOD bias that reads smaller mips. The interface class
+// (atlases, glyphs) stays bilinear at every tier, since mips would bleed neighbouring
+// regions into each other and the text must stay legible. SetTier() re-applies every
+// registered texture at once, so the FrameGovernor can lower it before it lowers anything
+// the player would miss more. Textures that lack mips are given them on Register (unless
+// compressed: those keep what they came with and fall back to a non-mip filter). Only on
+// the thread that owns the GL context.
+class SamplerPresets {
+public:
+	enum class Class {
+		SURFACE,    // model and world textures, seen at grazing angles
+		EFFECT,     // particle and glow sprites, drawn small and blended
+		INTERFACE,  // atlases and glyphs drawn 1:1
+	};
+
+	struct Preset {
+		int   filter;      // RL_TEXTURE_FILTER_*, for minification
+		int   anisotropy;  // 1 = off; clamped to what the driver supports
+		float lodBias;     // in mip levels; positive reads smaller ones
+	};
+
+	static constexpr int C_TIERS = 4;
+	static constexpr int C_CLASSES = 3;
+
+	// [tier][class]
+	static constexpr Preset C_PRESETS[C_TIERS][C_CLASSES] = {
+		{ { RL_TEXTURE_FILTER_MIP_LINEAR, 16, 0.0f }, { RL_TEXTURE_FILTER_MIP_LINEAR, 1, 0.0f }, { RL_TEXTURE_FILTER_LINEAR, 1, 0.0f } },
+		{ { RL_TEXTURE_FILTER_MIP_LINEAR, 4, 0.0f }, { RL_TEXTURE_FILTER_MIP_LINEAR, 1, 0.5f }, { RL_TEXTURE_FILTER_LINEAR, 1, 0.0f } },
+		{ { RL_TEXTURE_FILTER_LINEAR_MIP_NEAREST, 1, 0.5f }, { RL_TEXTURE_FILTER_LINEAR_MIP_NEAREST, 1, 1.0f }, { RL_TEXTURE_FILTER_LINEAR, 1, 0.0f } },
+		{ { RL_TEXTURE_FILTER_LINEAR_MIP_NEAREST, 1, 1.0f }, { RL_TEXTURE_FILTER_LINEAR_MIP_NEAREST, 1, 2.0f }, { RL_TEXTURE_FILTER_LINEAR, 1, 0.0f } },
+	};
+
+	static SamplerPresets& Instance() {
+		static SamplerPresets instance;
+		return instance;
+	}
+
+	SamplerPresets(const SamplerPresets&) = delete;
+	SamplerPresets& operator=(const SamplerPresets&) = delete;
+
+	// Filters `texture` per its class from now on. A texture registered again just changes
+	// class; Forget it before unloading it.
+	void Register(const Texture2D& texture, Class kind) {
+		if (texture.id == 0) return;
+		Entry* e = Find(texture.id);
+		if (!e) {
+			entries.push_back({ texture.id, texture.width, texture.height, texture.format, texture.mipmaps, kind });
+			e = &entries.back();
+			if (e->mipmaps <= 1 && kind != Class::INTERFACE && texture.format < PIXELFORMAT_COMPRESSED_DXT1_RGB) {
+				rlGenTextureMipmaps(e->id, e->width, e->height, e->format, &e->mipmaps);
+			}
+		}
+		e->kind = kind;
+		Apply(*e);
+	}
+
+	void Forget(unsigned int id) {
+		entries.erase(std::remove_if(entries.begin(), entries.end(), [id](const Entry& e) { return e.id == id; }), entries.end());
+	}
+
+	// Clamped to [0, C_TIERS); re-filters every registered texture when it changes.
+	void SetTier(int tier_) {
+		tier_ = std::clamp(tier_, 0, C_TIERS - 1);
+		if (tier_ == tier) return;
+		tier = tier_;
+		for (const Entry& e : entries) Apply(e);
+		TraceLog(LOG_INFO, "SAMPLERS: tier %d applied to %d texture(s)", tier, static_cast<int>(entries.size()));
+	}
+
+	int Tier() const {
+		return tier;
+	}
+
+	int Registered() const {
+		return static_cast<int>(entries.size());
+	}
+
+private:
+	struct Entry {
+		unsigned int id;
+		int          width;
+		int          height;
+		int          format;
+		int          mipmaps;
+		Class        kind;
+	};
+
+	SamplerPresets() = default;
+
+	Entry* Find(unsigned int id) {
+		for (Entry& e : entries) {
+			if (e.id == id) return &e;
+		}
+		return nullptr;
+	}
+
+	// Anisotropy is set directly rather than through rlTextureParameters, which warns on
+	// every call once a level is above the driver's maximum.
+	void Apply(const Entry& e) {
+		const Preset& p = C_PRESETS[tier][static_cast<int>(e.kind)];
+		const int filter = e.mipmaps > 1 ? p.filter : RL_TEXTURE_FILTER_LINEAR;
+		rlTextureParameters(e.id, RL_TEXTURE_MIN_FILTER, filter);
+		rlTextureParameters(e.id, RL_TEXTURE_MAG_FILTER, RL_TEXTURE_FILTER_LINEAR);
+		rlTextureParameters(e.id, RL_TEXTURE_MIPMAP_BIAS_RATIO, static_cast<int>(p.lodBias * 100.0f));
+		if (MaxAnisotropy() > 1.0f) {
+			glBindTexture(GL_TEXTURE_2D, e.id);
+			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, std::min(static_cast<float>(p.anisotropy), MaxAnisotropy()));
+			glBindTexture(GL_TEXTURE_2D, 0);
+		}
+	}
+
+	// 0 without the extension. Asked once, on first use.
+	float MaxAnisotropy() {
+		if (maxAnisotropy < 0.0f) {
+			maxAnisotropy = 0.0f;
+			if (GLAD_GL_EXT_texture_filter_anisotropic || GLAD_GL_ARB_texture_filter_anisotropic) glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+		}
+		return maxAnisotropy;
+	}
+
+	std::vector<Entry> entries;
+	int                tier = 0;
+	float              maxAnisotropy = -1.0f;
+};
+
+#endif // SAMPLER_PRESETS_H
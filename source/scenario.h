@@ -0,0 +1,183 @@
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "raylib.h"
+
+// --- SCENARIO ---
+// Run-time knobs for the world that used to be compile-time constants, so scaling
+// experiments don't need a rebuild. Values come from `key=value` lines in a file
+// (`--scenario <file>`, '#' starts a comment) and/or `--<key> <value>` flags; later
+// settings win. The defaults are the normal game.
+//
+//   width, height        playfield / window size in px
+//   max-asteroids        cap for the timed spawner
+//   spawn-min, spawn-max spawner interval range in seconds
+//   score-threshold      score at which a ship gains an orbiter
+//   asteroids            asteroids scattered over the field at every (re)start
+//   projectiles          projectiles scattered over the field at every (re)start
+//   orbiters             depth of an orbiter chain attached to the player at start
+//   wave-size            asteroids per wave (0 = waves off)
+//   wave-interval        seconds between waves
+//   tick-rate            fixed simulation ticks per second; drawing interpolates between them
+//   world-width,         a streamed world of this size in px (0 = off): the playfield is one
+//   world-height         sector of it, the camera follows the player and only the sectors
+//                        around them are simulated (World::Streaming)
+//   spatial-sort         ticks between renumbering asteroids and projectiles in the order
+//                        of their position (SpatialOrder; 0 = never)
+//
+// Replays don't store the scenario, save for spatial-sort; play one back with the flags it
+// was recorded with.
+//
+// `--preset <name>` applies one of C_PRESETS, built-in settings for unattended load runs
+// with --autopilot, before any settings that follow it:
+//
+//   soak      the default field with orbiters earned at every point scored and regular
+//             waves, so the orbiter tree keeps growing over a long session
+//   saturate  thousands of asteroids and projectiles with frequent waves and a deep
+//             orbiter chain from the start, for a steady worst case
+//   expanse   a 100000 x 100000 streamed world with a busy spawner, whose asteroids
+//             pile up in the sectors the player leaves behind
+struct Scenario {
+	int    width = 1600;
+	int    height = 1600;
+	size_t maxAsteroids = 150;
+	float  spawnMin = 0.5f;
+	float  spawnMax = 3.0f;
+	int    scoreThreshold = 3;
+	size_t asteroids = 0;
+	size_t projectiles = 0;
+	int    orbiters = 0;
+	size_t waveSize = 0;
+	float  waveInterval = 10.f;
+	int    tickRate = 120;
+	int    worldWidth = 0;
+	int    worldHeight = 0;
+	int    spatialSort = 256;
+
+	// Returns false for an unknown key. A value that doesn't parse or is out of the key's
+	// range is skipped with a warning, keeping the setting as it was.
+	bool Set(const char* key, const char* value) {
+		if (!strcmp(key, "width")) SetInt(key, value, 1, width);
+		else if (!strcmp(key, "height")) SetInt(key, value, 1, height);
+		else if (!strcmp(key, "max-asteroids")) SetCount(key, value, maxAsteroids);
+		else if (!strcmp(key, "spawn-min")) SetFloat(key, value, spawnMin);
+		else if (!strcmp(key, "spawn-max")) SetFloat(key, value, spawnMax);
+		else if (!strcmp(key, "score-threshold")) SetInt(key, value, 1, scoreThreshold);
+		else if (!strcmp(key, "asteroids")) SetCount(key, value, asteroids);
+		else if (!strcmp(key, "projectiles")) SetCount(key, value, projectiles);
+		else if (!strcmp(key, "orbiters")) SetInt(key, value, 0, orbiters);
+		else if (!strcmp(key, "wave-size")) SetCount(key, value, waveSize);
+		else if (!strcmp(key, "wave-interval")) SetFloat(key, value, waveInterval);
+		else if (!strcmp(key, "tick-rate")) SetInt(key, value, 1, tickRate);
+		else if (!strcmp(key, "world-width")) SetInt(key, value, 0, worldWidth);
+		else if (!strcmp(key, "world-height")) SetInt(key, value, 0, worldHeight);
+		else if (!strcmp(key, "spatial-sort")) SetInt(key, value, 0, spatialSort);
+		else return false;
+		return true;
+	}
+
+	struct Preset {
+		const char* name;
+		const char* settings;  // `key=value` lines, as in a file
+	};
+	static constexpr Preset C_PRESETS[] = {
+		{ "soak", "score-threshold=1\nmax-asteroids=400\nspawn-min=0.2\nspawn-max=0.8\nwave-size=150\nwave-interval=6\n" },
+		{ "saturate", "asteroids=3000\nprojectiles=20000\nmax-asteroids=3000\norbiters=6\n"
+			"wave-size=500\nwave-interval=2\nscore-threshold=1\n" },
+		{ "expanse", "world-width=100000\nworld-height=100000\nmax-asteroids=600\nspawn-min=0.02\nspawn-max=0.1\n" },
+	};
+
+	// Returns false for an unknown preset.
+	bool ApplyPreset(const char* name) {
+		for (const Preset& p : C_PRESETS) {
+			if (strcmp(p.name, name)) continue;
+			const char* at = p.settings;
+			while (*at) {
+				const char* end = strchr(at, '\n');
+				const size_t n = end ? static_cast<size_t>(end - at) : strlen(at);
+				char line[256];
+				const size_t len = n < sizeof(line) - 1 ? n : sizeof(line) - 1;
+				memcpy(line, at, len);
+				line[len] = '\0';
+				ParseLine(line, p.name);
+				at += end ? n + 1 : n;
+			}
+			return true;
+		}
+		return false;
+	}
+
+	// Returns false if the file can't be read; unknown keys are skipped with a warning.
+	bool Load(const char* path) {
+		FILE* f = nullptr;
+#if defined(_MSC_VER)
+		if (fopen_s(&f, path, "rb") != 0) f = nullptr;
+#else
+		f = fopen(path, "rb");
+#endif
+		if (!f) return false;
+
+		char line[256];
+		while (fgets(line, sizeof(line), f)) ParseLine(line, path);
+		fclose(f);
+		return true;
+	}
+
+private:
+	// One `key=value` line, modified in place; `source` names it in the warning.
+	void ParseLine(char* line, const char* source) {
+		char* hash = strchr(line, '#');
+		if (hash) *hash = '\0';
+		char* eq = strchr(line, '=');
+		if (!eq) return;
+		*eq = '\0';
+		char* key = Trim(line);
+		char* value = Trim(eq + 1);
+		if (*key && !Set(key, value)) {
+			TraceLog(LOG_WARNING, "SCENARIO: unknown key '%s' in %s", key, source);
+		}
+	}
+
+	static void Reject(const char* key, const char* value) {
+		TraceLog(LOG_WARNING, "SCENARIO: rejected %s '%s', keeping the current value", key, value);
+	}
+
+	// The whole of `value` as an int of at least `min`.
+	static void SetInt(const char* key, const char* value, int min, int& out) {
+		char* end = nullptr;
+		const long v = strtol(value, &end, 10);
+		if (end == value || *end != '\0' || v < min || v > 0x7fffffff) Reject(key, value);
+		else out = static_cast<int>(v);
+	}
+
+	// A count: digits only, so "-1" isn't read as a huge size_t.
+	static void SetCount(const char* key, const char* value, size_t& out) {
+		char* end = nullptr;
+		const unsigned long long v = strtoull(value, &end, 10);
+		if (*value < '0' || *value > '9' || *end != '\0') Reject(key, value);
+		else out = static_cast<size_t>(v);
+	}
+
+	// Every float setting is a duration or a rate, so above 0.
+	static void SetFloat(const char* key, const char* value, float& out) {
+		char* end = nullptr;
+		const float v = strtof(value, &end);
+		if (end == value || *end != '\0' || !(v > 0.f)) Reject(key, value);
+		else out = v;
+	}
+
+	static char* Trim(char* s) {
+		while (*s == ' ' || *s == '\t') ++s;
+		char* end = s + strlen(s);
+		while (end > s && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r' || end[-1] == '\n')) --end;
+		*end = '\0';
+		return s;
+	}
+};
+
+#endif // SCENARIO_H
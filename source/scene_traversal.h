@@ -0,0 +1,182 @@
+#ifndef SCENE_TRAVERSAL_H
+#define SCENE_TRAVERSAL_H
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "render_queue.h"
+#include "instance_culling.h"
+
+// --- SCENE TRAVERSAL ---
+// A transform hierarchy walked into a RenderQueue, the CPU side of a frame spread over the
+// job system's threads so only the queue's draws stay on the GL thread. Nodes live in flat
+// arrays in topological order (every node after its parent, as the Fleet keeps its
+// orbiters), so propagation is one forward loop in which a parent is always final before
+// its children read it. Per frame:
+//   1. propagation, from the first node changed since the last frame: a node's world
+//      matrix (local x parent's world) is recomputed only if it or an ancestor changed, so
+//      an unchanged scene costs nothing here;
+//   2. Gather(): per drawable node, on the worker threads, its bounding sphere tested against
+//      the view's frustum and its LOD picked by distance (C_LOD_START, as InstanceCuller
+//      picks), the chosen model recorded with its world matrix;
+//   3. the queue's Flush() then generates the sort keys, in parallel too, sorts and draws.
+// Nodes are added parents first and never removed. Models must outlive the graph.
+class SceneGraph {
+public:
+	static constexpr int    C_LODS = InstanceCuller::C_LODS;
+	static constexpr float  C_LOD_START[C_LODS] = { 0.0f, 25.0f, 60.0f };
+	static constexpr size_t C_CHUNK = 64;  // drawables per job, at least
+
+	struct Stats {
+		int   nodes = 0;
+		int   drawables = 0;
+		int   recomputed = 0;  // world matrices, this frame
+		int   visible = 0;
+		int   lod[C_LODS] = {};  // visible nodes per LOD
+		float propagateMs = 0.0f;
+		float gatherMs = 0.0f;
+	};
+
+	// A group without `lods`, or a drawable with one model per LOD (lods[0] required, a missing
+	// coarser one falls back to the next finer). `sphere` bounds lods[0] in its own space:
+	// centre and radius. Returns the node's index; `parent` must already exist, or be -1.
+	int Add(int parent, const Matrix& local, const Model* const* lods = nullptr, Vector4 sphere = {}, Color tint = WHITE) {
+		const int index = static_cast<int>(parents.size());
+		parents.push_back(parent);
+		locals.push_back(local);
+		worlds.push_back((parent < 0) ? local : MatrixMultiply(local, worlds[parent]));
+		changed.push_back(0);
+		if (lods != nullptr) {
+			Drawable d;
+			d.node = index;
+			d.sphere = sphere;
+			d.tint = tint;
+			for (int l = 0; l < C_LODS; ++l) d.lods[l] = (lods[l] != nullptr) ? lods[l] : d.lods[std::max(l - 1, 0)];
+			drawables.push_back(d);
+			shown.push_back(-1);
+		}
+		return index;
+	}
+
+	// Moves a node, and with it its subtree, from the next Traverse on.
+	void SetLocal(int node, const Matrix& local) {
+		locals[node] = local;
+		changed[node] = 1;
+		firstChanged = std::min(firstChanged, node);
+	}
+
+	const Matrix& Local(int node) const {
+		return locals[node];
+	}
+
+	// As of the last Traverse (or Add).
+	const Matrix& World(int node) const {
+		return worlds[node];
+	}
+
+	// Propagates, culls and picks LODs against `viewProjection`, seen from `eye`, and
+	// records what is visible into `queue`, for a Flush() between BeginMode3D and EndMode3D.
+	void Traverse(const Matrix& viewProjection, Vector3 eye, RenderQueue& queue) {
+		using Clock = std::chrono::steady_clock;
+		const Clock::time_point start = Clock::now();
+		stats = Stats{};
+		stats.nodes = static_cast<int>(parents.size());
+		stats.drawables = static_cast<int>(drawables.size());
+		const int count = static_cast<int>(parents.size());
+		for (int i = firstChanged; i < count; ++i) {
+			const int parent = parents[i];
+			if (parent >= 0) changed[i] |= changed[parent];
+			if (!changed[i]) continue;
+			worlds[i] = (parent < 0) ? locals[i] : MatrixMultiply(locals[i], worlds[parent]);
+			++stats.recomputed;
+		}
+		// Flags are cleared only where they can have been set: at or after the first change.
+		if (firstChanged < count) std::fill(changed.begin() + firstChanged, changed.end(), 0);
+		firstChanged = count;
+		const Clock::time_point propagated = Clock::now();
+
+		float planes[6 * 4];
+		InstanceCuller::FrustumPlanes(viewProjection, planes);
+		queue.Gather(drawables.size(), C_CHUNK, [&](size_t i, RenderQueue::Recorder& recorder) {
+			const Drawable& d = drawables[i];
+			const Matrix& w = worlds[d.node];
+			const Vector3 centre = Vector3Transform({ d.sphere.x, d.sphere.y, d.sphere.z }, w);
+			const float scale = sqrtf(std::max({ w.m0 * w.m0 + w.m1 * w.m1 + w.m2 * w.m2, w.m4 * w.m4 + w.m5 * w.m5 + w.m6 * w.m6, w.m8 * w.m8 + w.m9 * w.m9 + w.m10 * w.m10 }));
+			const float radius = d.sphere.w * scale;
+			shown[i] = -1;
+			for (int p = 0; p < 6; ++p) {
+				const float* plane = &planes[p * 4];
+				if (plane[0] * centre.x + plane[1] * centre.y + plane[2] * centre.z + plane[3] < -radius) return;
+			}
+			const float distance = Vector3Distance(eye, centre);
+			int lod = C_LODS - 1;
+			while (lod > 0 && distance < C_LOD_START[lod]) --lod;
+			shown[i] = static_cast<signed char>(lod);
+			recorder.Add(*d.lods[lod], w, d.tint);
+		});
+		const Clock::time_point gathered = Clock::now();
+
+		for (signed char lod : shown) {
+			if (lod < 0) continue;
+			++stats.visible;
+			++stats.lod[lod];
+		}
+		stats.propagateMs = std::chrono::duration<float, std::milli>(propagated - start).count();
+		stats.gatherMs = std::chrono::duration<float, std::milli>(gathered - propagated).count();
+	}
+
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+private:
+	struct Drawable {
+		int          node = 0;
+		Vector4      sphere{};
+		Color        tint = WHITE;
+		const Model* lods[C_LODS] = {};
+	};
+
+	// Per node, in topological order.
+	std::vector<int>           parents;
+	std::vector<Matrix>        locals;
+	std::vector<Matrix>        worlds;
+	std::vector<unsigned char> changed;  // set by SetLocal, spread to the subtree by Traverse
+	int                        firstChanged = 0;
+
+	std::vector<Drawable>      drawables;
+	std::vector<signed char>   shown;    // per drawable, the last Traverse's LOD, -1 if culled
+	Stats                      stats;
+};
+
+// A model drawing `source`'s meshes (`cells` 0) or GenMeshSimplified copies of them, all
+// with `shader`: its materials are copies, its textures `source`'s. Free with
+// UnloadLodModel, before `source`.
+inline Model LoadLodModel(const Model& source, int cells, Shader shader) {
+	Model lod = source;
+	lod.materials = static_cast<Material*>(MemAlloc(static_cast<unsigned int>(source.materialCount * sizeof(Material))));
+	for (int m = 0; m < source.materialCount; ++m) {
+		lod.materials[m] = source.materials[m];
+		lod.materials[m].shader = shader;
+	}
+	if (cells > 0) {
+		lod.meshes = static_cast<Mesh*>(MemAlloc(static_cast<unsigned int>(source.meshCount * sizeof(Mesh))));
+		for (int m = 0; m < source.meshCount; ++m) lod.meshes[m] = GenMeshSimplified(source.meshes[m], cells);
+	}
+	return lod;
+}
+
+inline void UnloadLodModel(Model& lod, const Model& source) {
+	if (lod.meshes != source.meshes) {
+		for (int m = 0; m < lod.meshCount; ++m) UnloadMesh(lod.meshes[m]);
+		MemFree(lod.meshes);
+	}
+	MemFree(lod.materials);
+	lod = Model{};
+}
+
+#endif // SCENE_TRAVERSAL_H
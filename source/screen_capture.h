@@ -0,0 +1,245 @@
+#ifndef SCREEN_CAPTURE_H
+#define SCREEN_CAPTURE_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"  // pixel pack buffers and fences, which rlgl doesn't wrap
+#include "external/qoi.h"   // declarations only; rtextures.c has the encoder
+#include "jobs.h"
+
+// --- SCREEN READBACK ---
+// The default framebuffer read back without stalling the frame. Issue() has glReadPixels
+// write into the next of C_BUFFERS pixel pack buffers and fences it; Collect() hands every
+// readback whose fence has signalled, oldest first, to a callback with the mapped pixels:
+// RGBA8, bottom row first as GL reads them. A readback is ready a frame or two after it was
+// issued. Main (GL) thread only; the buffers need GL 3.3 (Supported()).
+class ScreenReadback {
+public:
+	static constexpr int      C_BUFFERS = 3;
+	static constexpr GLuint64 C_WAIT_NANOSECONDS = 100'000'000;  // per readback, when waited for
+
+	static bool Supported() {
+		return GLAD_GL_VERSION_3_3 != 0;
+	}
+
+	// The default framebuffer's size in pixels, as rcore's recorder reads it.
+	static void ScreenSize(int& w, int& h) {
+		const Vector2 scale = GetWindowScaleDPI();
+		w = static_cast<int>(static_cast<float>(GetRenderWidth()) * scale.x);
+		h = static_cast<int>(static_cast<float>(GetRenderHeight()) * scale.y);
+	}
+
+	// (Re)allocates the buffers for w x h, dropping any readback in flight.
+	void Resize(int w, int h) {
+		Discard();
+		width = w;
+		height = h;
+		if (pbos[0] == 0) glGenBuffers(C_BUFFERS, pbos);
+		for (GLuint pbo : pbos) {
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+			glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(FrameBytes()), nullptr, GL_STREAM_READ);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+
+	// Resizes if the screen is no longer the size of the buffers; true if it was.
+	bool Track() {
+		int w, h;
+		ScreenSize(w, h);
+		if (w == width && h == height) return false;
+		Resize(w, h);
+		return true;
+	}
+
+	void Unload() {
+		Discard();
+		if (pbos[0] != 0) glDeleteBuffers(C_BUFFERS, pbos);
+		for (GLuint& pbo : pbos) pbo = 0;
+		width = height = 0;
+	}
+
+	int Width() const {
+		return width;
+	}
+
+	int Height() const {
+		return height;
+	}
+
+	size_t FrameBytes() const {
+		return static_cast<size_t>(width) * static_cast<size_t>(height) * 4;
+	}
+
+	int Pending() const {
+		return pending;
+	}
+
+	// Reads the frame drawn so far, tagged with `stamp`; false when every buffer is still in
+	// flight. With the default framebuffer bound, before EndDrawing.
+	bool Issue(double stamp) {
+		if (pending == C_BUFFERS) return false;
+		rlDrawRenderBatchActive();
+		const int i = (first + pending) % C_BUFFERS;
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+		glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		stamps[i] = stamp;
+		++pending;
+		return true;
+	}
+
+	// ready(pixels, stamp) for each finished readback, oldest first; the pixels are only valid
+	// during the call. With `wait` every one in flight is waited for. Returns how many were
+	// lost (a wait timed out or failed, or the buffer would not map).
+	template<typename Ready>
+	int Collect(bool wait, Ready&& ready) {
+		int lost = 0;
+		while (pending > 0) {
+			GLsync& fence = fences[first];
+			const GLenum status = wait ? glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, C_WAIT_NANOSECONDS) : glClientWaitSync(fence, 0, 0);
+			if (status == GL_TIMEOUT_EXPIRED && !wait) break;
+			glDeleteSync(fence);
+			fence = nullptr;
+			if (status == GL_TIMEOUT_EXPIRED || status == GL_WAIT_FAILED) {
+				++lost;
+			}
+			else {
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[first]);
+				const void* pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(FrameBytes()), GL_MAP_READ_BIT);
+				if (pixels != nullptr) {
+					ready(static_cast<const uint8_t*>(pixels), stamps[first]);
+					glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+				}
+				else {
+					++lost;
+				}
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			}
+			first = (first + 1) % C_BUFFERS;
+			--pending;
+		}
+		return lost;
+	}
+
+private:
+	void Discard() {
+		for (GLsync& fence : fences) {
+			if (fence) glDeleteSync(fence);
+			fence = nullptr;
+		}
+		first = pending = 0;
+	}
+
+	int    width = 0, height = 0;
+	GLuint pbos[C_BUFFERS] = {};
+	GLsync fences[C_BUFFERS] = {};
+	double stamps[C_BUFFERS] = {};
+	int    first = 0, pending = 0;  // readbacks in flight, oldest at `first`
+};
+
+// --- SCREENSHOTS ---
+// F12 without the hitch of raylib's TakeScreenshot, which reads the screen back synchronously
+// and compresses the PNG on the main thread. Request() marks the frame; Capture() reads it
+// through a ScreenReadback and, once that has landed, copies it out for a JobSystem job that
+// flips it, makes it opaque (as rlReadScreenPixels does), encodes it and saves it. UseQoi()
+// writes QOI, far faster to encode than PNG, instead. The job is handed pixels, a path and
+// the format picked on the main thread, and encodes with stb and qoi directly: ExportImage
+// would pick the encoder with IsFileExtension, whose TextSplit and TextToLower buffers are
+// rtext's statics, shared with the main thread's text calls. At most C_MAX_WRITES images are being written at
+// once; further requests are dropped. Without GL 3.3, Capture() falls back to TakeScreenshot.
+class Screenshots {
+public:
+	static constexpr int C_MAX_WRITES = 4;
+
+	static Screenshots& Instance() {
+		static Screenshots instance;
+		return instance;
+	}
+
+	void UseQoi(bool on) {
+		qoi = on;
+	}
+
+	void Init() {
+		supported = ScreenReadback::Supported();
+	}
+
+	// Waits for the screenshots in flight to be read back and written.
+	void Unload() {
+		if (readback.Pending() > 0) readback.Collect(true, [this](const uint8_t* pixels, double) { Hand(pixels); });
+		readback.Unload();
+		JobSystem::Instance().Wait(writes);
+	}
+
+	void Request() {
+		++requested;
+	}
+
+	// Once per frame, after the frame is drawn and before EndDrawing, with the default
+	// framebuffer bound.
+	void Capture() {
+		if (requested == 0 && readback.Pending() == 0) return;
+		if (!supported) {
+			for (; requested > 0; --requested) TakeScreenshot(GetFileName(NextName().c_str()));  // it prefixes the directory
+			return;
+		}
+		readback.Collect(false, [this](const uint8_t* pixels, double) { Hand(pixels); });
+		if (requested == 0) return;
+		if (readback.Pending() == 0) readback.Track();
+		// A request made while every buffer is busy waits for the next frame.
+		if (readback.Issue(GetTime())) --requested;
+	}
+
+private:
+	std::string NextName() {
+		return TextFormat("%sscreenshot%03i.%s", GetApplicationDirectory(), counter++, qoi ? "qoi" : "png");
+	}
+
+	// Copies a landed readback out for a writing job.
+	void Hand(const uint8_t* pixels) {
+		if (writes.Pending() >= C_MAX_WRITES) {
+			TraceLog(LOG_WARNING, "SCREENSHOT: %i still being written, dropped", C_MAX_WRITES);
+			return;
+		}
+		Image image = { MemAlloc(static_cast<unsigned int>(readback.FrameBytes())), readback.Width(), readback.Height(), 1,
+			PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+		memcpy(image.data, pixels, readback.FrameBytes());
+		JobSystem::Instance().Run([image, path = NextName(), asQoi = qoi] { Write(image, path, asQoi); }, &writes);
+	}
+
+	// On the pool: flips, makes opaque, encodes, saves and frees the image. Nothing here
+	// touches raylib state another thread uses.
+	static void Write(Image image, const std::string& path, bool asQoi) {
+		ImageFlipVertical(&image);
+		unsigned char* rgba = static_cast<unsigned char*>(image.data);
+		const size_t bytes = static_cast<size_t>(image.width) * static_cast<size_t>(image.height) * 4;
+		for (size_t i = 3; i < bytes; i += 4) rgba[i] = 255;
+		int size = 0;
+		unsigned char* file = nullptr;
+		if (asQoi) {
+			const qoi_desc desc = { static_cast<unsigned int>(image.width), static_cast<unsigned int>(image.height), 4, QOI_SRGB };
+			file = static_cast<unsigned char*>(qoi_encode(image.data, &desc, &size));
+		}
+		else {
+			file = ExportImageToMemory(image, ".png", &size);  // compares the type with strcmp only
+		}
+		if (file != nullptr && SaveFileData(path.c_str(), file, size)) TraceLog(LOG_INFO, "SCREENSHOT: wrote %s", path.c_str());
+		else TraceLog(LOG_WARNING, "SCREENSHOT: could not write %s", path.c_str());
+		MemFree(file);
+		UnloadImage(image);
+	}
+
+	ScreenReadback readback;
+	bool           supported = false;
+	int            requested = 0;
+	int            counter = 0;
+	bool           qoi = false;
+	JobCounter     writes;  // images being written
+};
+
+#endif // SCREEN_CAPTURE_H
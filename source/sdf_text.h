@@ -0,0 +1,307 @@
+#ifndef SDF_TEXT_H
+#define SDF_TEXT_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "shader_cache.h"
+#include "external/glad.h"  // multi-draw arrays, which rlgl doesn't wrap
+
+// --- SDF TEXT ---
+// Overlay text from a signed distance field atlas, so one atlas draws crisply at any size,
+// and from cached runs, so a line that reads the same as last frame uploads nothing. The
+// atlas stores per texel the distance to the glyph's outline, C_EDGE on it, and sdf_text.fs
+// turns that into a one-pixel smoothstep whatever the scale. Load() builds it from a TTF
+// with stb_truetype's SDF (LoadFontData's FONT_SDF); LoadDefault(), for trees without one,
+// from raylib's default bitmap font, each pixel C_UPSCALE texels wide and the distance taken
+// exactly to the pixels' edges, so that font keeps its hard blocky shapes at any size.
+//
+// Between Begin() and End() each Draw() is a run, matched by its place in the frame's order
+// against last frame's run there: if text, position, size, spacing and colour are the same
+// its vertices are still in the buffer, and the run costs one (first, count) pair; otherwise
+// its quads are rebuilt into its region, grown in C_RUN_SLACK steps so a number gaining a
+// digit stays in place. End() flushes rlgl's batch and draws every run with one
+// glMultiDrawArrays. Text is single-line ASCII; other characters draw as '?'.
+class SdfText {
+public:
+	static constexpr int   C_FIRST_CHAR = 32;
+	static constexpr int   C_GLYPHS = 95;         // ASCII 32..126
+	static constexpr int   C_UPSCALE = 4;         // default font: atlas texels per font pixel
+	static constexpr int   C_SPREAD = 4;          // default font: texels of distance either side of the edge
+	static constexpr int   C_EDGE = 128;          // stored on the outline, as FONT_SDF's
+	static constexpr int   C_CAPACITY = 1 << 14;  // glyphs in the vertex buffer
+	static constexpr int   C_RUN_SLACK = 16;      // glyphs
+
+	struct Stats {
+		int runs = 0;
+		int rebuilt = 0;
+		int glyphs = 0;       // drawn
+		int uploaded = 0;     // bytes
+		int dropped = 0;      // runs that didn't fit the buffer
+	};
+
+	// A TTF or OTF rasterised at `size` pixels. False, logged, if it can't be read.
+	bool Load(const char* fileName, int size) {
+		Unload();
+		// Rasterised straight from the page cache when the file can be mapped.
+		int dataSize = 0;
+		unsigned char* data = MapFileData(fileName, &dataSize);
+		const bool mapped = data != nullptr;
+		if (!mapped) data = LoadFileData(fileName, &dataSize);
+		if (data == nullptr) return false;
+		GlyphInfo* loaded = LoadFontData(data, dataSize, size, nullptr, C_GLYPHS, FONT_SDF);
+		if (mapped) UnmapFileData(data, dataSize);
+		else UnloadFileData(data);
+		if (loaded == nullptr) {
+			TraceLog(LOG_WARNING, "SDF TEXT: %s has no glyphs", fileName);
+			return false;
+		}
+		glyphs.assign(loaded, loaded + C_GLYPHS);
+		RL_FREE(loaded);
+		baseSize = static_cast<float>(size);
+		return Build(fileName);
+	}
+
+	// From raylib's default font (so after InitWindow).
+	bool LoadDefault() {
+		Unload();
+		const Font& def = GetFontDefault();
+		if (def.glyphCount < C_GLYPHS) return false;
+		for (int i = 0; i < C_GLYPHS; ++i) glyphs.push_back(DistanceGlyph(def, i));
+		baseSize = static_cast<float>(def.baseSize * C_UPSCALE);
+		return Build("the default font");
+	}
+
+	void Unload() {
+		for (GlyphInfo& g : glyphs) UnloadImage(g.image);
+		glyphs.clear();
+		recs.clear();
+		if (texture.id) UnloadTexture(texture);
+		if (vbo) rlUnloadVertexBuffer(vbo);
+		if (vao) rlUnloadVertexArray(vao);
+		if (shader.id) UnloadShader(shader);
+		texture = {};
+		shader = {};
+		vao = vbo = 0;
+		runs.clear();
+		used = 0;
+	}
+
+	bool Ready() const {
+		return vao != 0 && texture.id != 0 && shader.id != rlGetShaderIdDefault();
+	}
+
+	void Begin() {
+		next = 0;
+		firsts.clear();
+		counts.clear();
+		stats = Stats{};
+	}
+
+	// `size` is the line's height in pixels; `spacing` the extra gap between glyphs, as
+	// DrawTextEx's.
+	void Draw(const char* text, Vector2 position, float size, float spacing, Color color) {
+		++stats.runs;
+		if (next == runs.size()) runs.emplace_back();
+		Run& run = runs[next++];
+		if (run.text != text || run.position.x != position.x || run.position.y != position.y || run.size != size ||
+			run.spacing != spacing || ColorToInt(run.color) != ColorToInt(color))
+		{
+			Layout(text, position, size, spacing, color);
+			const int needed = static_cast<int>(vertices.size());
+			if (needed > run.capacity) {
+				const int capacity = (needed / 6 + C_RUN_SLACK) * 6;
+				if (used + capacity > C_CAPACITY * 6) {
+					++stats.dropped;
+					run = Run{};
+					return;
+				}
+				run.first = used;
+				run.capacity = capacity;
+				used += capacity;
+			}
+			const int bytes = needed * static_cast<int>(sizeof(Vertex));
+			if (bytes > 0) rlUpdateVertexBuffer(vbo, vertices.data(), bytes, run.first * static_cast<int>(sizeof(Vertex)));
+			run.text = text;
+			run.position = position;
+			run.size = size;
+			run.spacing = spacing;
+			run.color = color;
+			run.count = needed;
+			++stats.rebuilt;
+			stats.uploaded += bytes;
+		}
+		if (run.count == 0) return;
+		firsts.push_back(run.first);
+		counts.push_back(run.count);
+		stats.glyphs += run.count / 6;
+	}
+
+	// Draws the frame's runs over whatever rlgl has batched so far.
+	void End() {
+		// Runs past this frame's last are gone, their regions with them; once those add up
+		// to a quarter of the buffer, every run is rebuilt into a packed one next frame.
+		runs.resize(next);
+		int live = 0;
+		for (const Run& run : runs) live += run.capacity;
+		if (used - live > C_CAPACITY * 6 / 4) {
+			runs.clear();
+			used = 0;
+		}
+		if (firsts.empty()) return;
+
+		rlDrawRenderBatchActive();
+		rlEnableShader(shader.id);
+		rlSetUniformMatrix(shader.locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection()));
+		rlActiveTextureSlot(0);
+		rlEnableTexture(texture.id);
+		rlEnableVertexArray(vao);
+		glMultiDrawArrays(GL_TRIANGLES, firsts.data(), counts.data(), static_cast<GLsizei>(firsts.size()));
+		rlDisableVertexArray();
+		rlDisableTexture();
+		rlDisableShader();
+	}
+
+	// Of the frame since Begin().
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+private:
+	struct Vertex {
+		float x, y;
+		float u, v;
+		Color color;
+	};
+
+	struct Run {
+		std::string text;
+		Vector2     position{};
+		float       size = 0.0f;
+		float       spacing = 0.0f;
+		Color       color{};
+		int         first = 0;     // in vertices
+		int         capacity = 0;
+		int         count = 0;
+	};
+
+	// Glyph i of `font` as a distance field; `font` is raylib's default: no offsets, and the
+	// advance is the glyph's width.
+	static GlyphInfo DistanceGlyph(const Font& font, int i) {
+		Image source = ImageCopy(font.glyphs[i].image);
+		ImageFormat(&source, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+		const Color* pixels = static_cast<const Color*>(source.data);
+		const int sw = source.width, sh = source.height;
+		auto solid = [&](int x, int y) {
+			return x >= 0 && y >= 0 && x < sw && y < sh && pixels[y * sw + x].a > 127;
+		};
+
+		GlyphInfo g{};
+		g.value = C_FIRST_CHAR + i;
+		g.offsetX = -C_SPREAD;
+		g.offsetY = -C_SPREAD;
+		g.advanceX = static_cast<int>(font.recs[i].width) * C_UPSCALE;
+		const int w = sw * C_UPSCALE + 2 * C_SPREAD, h = sh * C_UPSCALE + 2 * C_SPREAD;
+		g.image = GenImageColor(w, h, BLANK);
+		ImageFormat(&g.image, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+		unsigned char* out = static_cast<unsigned char*>(g.image.data);
+
+		// Distance from each texel's centre to the nearest font pixel of the other kind,
+		// measured to that pixel's square; none within reach of the spread clamps.
+		constexpr int C_REACH = C_SPREAD / C_UPSCALE + 1;
+		for (int ty = 0; ty < h; ++ty) {
+			for (int tx = 0; tx < w; ++tx) {
+				const float px = (static_cast<float>(tx - C_SPREAD) + 0.5f) / C_UPSCALE;
+				const float py = (static_cast<float>(ty - C_SPREAD) + 0.5f) / C_UPSCALE;
+				const int cx = static_cast<int>(floorf(px)), cy = static_cast<int>(floorf(py));
+				const bool inside = solid(cx, cy);
+				float nearest = static_cast<float>(C_SPREAD) / C_UPSCALE;
+				for (int y = cy - C_REACH; y <= cy + C_REACH; ++y) {
+					for (int x = cx - C_REACH; x <= cx + C_REACH; ++x) {
+						if (solid(x, y) == inside) continue;
+						const float dx = std::max({ static_cast<float>(x) - px, 0.0f, px - static_cast<float>(x + 1) });
+						const float dy = std::max({ static_cast<float>(y) - py, 0.0f, py - static_cast<float>(y + 1) });
+						nearest = std::min(nearest, sqrtf(dx * dx + dy * dy));
+					}
+				}
+				const float texels = nearest * C_UPSCALE * (inside ? 1.0f : -1.0f);
+				out[ty * w + tx] = static_cast<unsigned char>(Clamp(C_EDGE + texels * (127.0f / C_SPREAD), 0.0f, 255.0f));
+			}
+		}
+		UnloadImage(source);
+		return g;
+	}
+
+	bool Build(const char* name) {
+		Rectangle* packed = nullptr;
+		Image atlas = GenImageFontAtlas(glyphs.data(), &packed, C_GLYPHS, static_cast<int>(baseSize), 2, 1);
+		recs.assign(packed, packed + C_GLYPHS);
+		RL_FREE(packed);
+		texture = LoadTextureFromImage(atlas);
+		UnloadImage(atlas);
+		SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+
+		shader = ShaderCache::Load("../resources/shaders/glsl330/sdf_text.vs", "../resources/shaders/glsl330/sdf_text.fs");
+		vao = rlLoadVertexArray();
+		if (!vao) return false;
+		rlEnableVertexArray(vao);
+		vbo = rlLoadVertexBuffer(nullptr, C_CAPACITY * 6 * static_cast<int>(sizeof(Vertex)), true);
+		constexpr int C_STRIDE = static_cast<int>(sizeof(Vertex));
+		rlSetVertexAttribute(0, 2, RL_FLOAT, false, C_STRIDE, reinterpret_cast<void*>(offsetof(Vertex, x)));
+		rlSetVertexAttribute(1, 2, RL_FLOAT, false, C_STRIDE, reinterpret_cast<void*>(offsetof(Vertex, u)));
+		rlSetVertexAttribute(2, 4, RL_UNSIGNED_BYTE, true, C_STRIDE, reinterpret_cast<void*>(offsetof(Vertex, color)));
+		for (unsigned int a = 0; a <= 2; ++a) rlEnableVertexAttribute(a);
+		rlDisableVertexArray();
+		TraceLog(LOG_INFO, "SDF TEXT: %ix%i atlas from %s", texture.width, texture.height, name);
+		return Ready();
+	}
+
+	// Two triangles per visible glyph into `vertices`, laid out as DrawTextEx does.
+	void Layout(const char* text, Vector2 position, float size, float spacing, Color color) {
+		vertices.clear();
+		const float scale = size / baseSize;
+		const float tw = static_cast<float>(texture.width), th = static_cast<float>(texture.height);
+		float x = position.x;
+		for (const char* c = text; *c != '\0'; ++c) {
+			int index = static_cast<unsigned char>(*c) - C_FIRST_CHAR;
+			if (index < 0 || index >= C_GLYPHS) index = '?' - C_FIRST_CHAR;
+			const GlyphInfo& g = glyphs[index];
+			const Rectangle& r = recs[index];
+			if (*c != ' ') {
+				const float x0 = x + static_cast<float>(g.offsetX) * scale, y0 = position.y + static_cast<float>(g.offsetY) * scale;
+				const float x1 = x0 + r.width * scale, y1 = y0 + r.height * scale;
+				const float u0 = r.x / tw, v0 = r.y / th, u1 = (r.x + r.width) / tw, v1 = (r.y + r.height) / th;
+				vertices.insert(vertices.end(), {
+					{ x0, y0, u0, v0, color }, { x0, y1, u0, v1, color }, { x1, y1, u1, v1, color },
+					{ x0, y0, u0, v0, color }, { x1, y1, u1, v1, color }, { x1, y0, u1, v0, color } });
+			}
+			const float advance = (g.advanceX != 0) ? static_cast<float>(g.advanceX) : r.width;
+			x += advance * scale + spacing;
+		}
+	}
+
+	std::vector<GlyphInfo> glyphs;   // images kept: Load/LoadDefault own them
+	std::vector<Rectangle> recs;     // in the atlas
+	float                  baseSize = 0.0f;
+	Texture2D              texture{};
+	Shader                 shader{};
+	unsigned int           vao = 0;
+	unsigned int           vbo = 0;
+
+	std::vector<Run>       runs;     // last frame's, by draw order
+	size_t                 next = 0; // this frame's runs so far
+	int                    used = 0; // vertices handed out of the buffer
+	std::vector<Vertex>    vertices; // scratch for a rebuilt run
+	std::vector<GLint>     firsts;
+	std::vector<GLsizei>   counts;
+	Stats                  stats;
+};
+
+#endif // SDF_TEXT_H
@@ -0,0 +1,342 @@
+#ifndef SECTOR_MAP_H
+#define SECTOR_MAP_H
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "world_snapshot.h"
+
+// --- SECTOR MAP ---
+// Everything of a large world that is outside the simulated region (World's streaming
+// mode). The world is a grid of sectors, and an asteroid that leaves the region is parked
+// in the sector under it as a 14-byte Packed record instead of a field slot. Only sectors
+// holding something exist, so memory follows what is parked, not the size of the world.
+//
+// Parked asteroids fly straight on through each other, so they don't need touching every
+// tick: all records of a sector hold their state as of the sector's stamp, a record parked
+// later is stepped back to that stamp (motion is linear, so nothing is lost), and Step
+// brings each sector forward in closed form once every C_COARSE_SECONDS, moving records
+// that crossed into another sector and dropping those that left the world. One that
+// crosses into the region is offered back to the simulation.
+//
+// Positions are stored within their sector to 1/32768 of its size, over half a sector of
+// slack each side for records that drift between updates; speeds to 1/32 px/s, rotations
+// to 1/65536 of a turn and spins to 1/64 degree/s.
+class SectorMap {
+public:
+	// An asteroid, in world coordinates.
+	struct Body {
+		float   x, y;
+		float   vx, vy;
+		float   rotation, rotationSpeed;
+		uint8_t size, shape;
+	};
+
+	// A rectangle of sectors.
+	struct Region {
+		int col = 0;
+		int row = 0;
+		int cols = 0;
+		int rows = 0;
+
+		bool Contains(int c, int r) const {
+			return c >= col && c < col + cols && r >= row && r < row + rows;
+		}
+	};
+
+	// A cols x rows grid of sectorW x sectorH sectors, empty, with the clock at 0.
+	void Init(float sectorW, float sectorH, int cols, int rows) {
+		layout = { sectorW, sectorH, cols, rows };
+		Clear();
+	}
+
+	void Clear() {
+		sectors.clear();
+		order.clear();
+		parked = 0;
+		clock = 0.0;
+	}
+
+	float SectorWidth() const { return layout.sectorW; }
+	float SectorHeight() const { return layout.sectorH; }
+	int   Cols() const { return layout.cols; }
+	int   Rows() const { return layout.rows; }
+
+	// Asteroids parked, and the sectors holding them.
+	size_t Size() const { return parked; }
+	size_t Sectors() const { return sectors.size(); }
+
+	// Heap held by the records and the sector table.
+	size_t Bytes() const {
+		size_t bytes = order.capacity() * sizeof(uint32_t) + sectors.bucket_count() * sizeof(void*);
+		for (const auto& [key, s] : sectors) bytes += sizeof(s) + sizeof(key) + s.bodies.capacity() * sizeof(Packed);
+		return bytes;
+	}
+
+	// The sector under a world position; false outside the world.
+	bool SectorOf(float x, float y, int& col, int& row) const {
+		col = static_cast<int>(floorf(x / layout.sectorW));
+		row = static_cast<int>(floorf(y / layout.sectorH));
+		return col >= 0 && col < layout.cols && row >= 0 && row < layout.rows;
+	}
+
+	// Parks `b` as it is now. False, with b dropped, when it is outside the world.
+	bool Park(const Body& b) {
+		int col, row;
+		if (!SectorOf(b.x, b.y, col, row)) return false;
+		Sector& s = SectorAt(Key(col, row));
+		s.bodies.push_back(Encode(Advanced(b, static_cast<float>(s.stamp - clock)), col, row));
+		++parked;
+		return true;
+	}
+
+	// Offers every asteroid of sector (col, row), as it is now, to take(const Body&); those it
+	// refuses (returns false for) stay parked. Returns how many it took.
+	template<typename Fn>
+	size_t Unpark(int col, int row, Fn&& take) {
+		const uint32_t key = Key(col, row);
+		auto it = sectors.find(key);
+		if (it == sectors.end()) return 0;
+		Sector& s = it->second;
+		const float span = static_cast<float>(clock - s.stamp);
+		size_t keep = 0;
+		for (const Packed& p : s.bodies) {
+			const Body b = Advanced(Decode(p, col, row), span);
+			if (!take(b)) s.bodies[keep++] = Encode(b, col, row);
+		}
+		const size_t taken = s.bodies.size() - keep;
+		s.bodies.resize(keep);
+		s.stamp = clock;
+		parked -= taken;
+		if (keep == 0) Erase(key);
+		return taken;
+	}
+
+	// One tick of `dt` seconds: sectors last updated C_COARSE_SECONDS ago or more are brought
+	// up to date. An asteroid that ends up over a sector of `region` is offered to
+	// arrive(const Body&) and stays parked if refused.
+	template<typename Fn>
+	void Step(float dt, const Region& region, Fn&& arrive) {
+		clock += dt;
+		// Records moved on are parked into sectors appended to `order`, which this loop
+		// reaches too; they come up with a fresh stamp and are skipped.
+		for (size_t k = 0; k < order.size();) {
+			const uint32_t key = order[k];
+			Sector& s = sectors[key];
+			if (clock - s.stamp >= C_COARSE_SECONDS) Update(key, s, region, arrive);
+			if (s.bodies.empty()) {
+				sectors.erase(key);
+				order[k] = order.back();
+				order.pop_back();
+				continue;
+			}
+			++k;
+		}
+	}
+
+	// FNV-1a over the clock and every sector's key, stamp and packed records, in the order
+	// Step visits them, continuing from `h` (World::Checksum's running hash).
+	uint64_t Checksum(uint64_t h) const {
+		auto mix = [&h](const void* data, size_t bytes) {
+			const unsigned char* p = static_cast<const unsigned char*>(data);
+			for (size_t i = 0; i < bytes; ++i) {
+				h ^= p[i];
+				h *= 1099511628211ull;
+			}
+		};
+		mix(&clock, sizeof(clock));
+		for (uint32_t key : order) {
+			const Sector& s = sectors.at(key);
+			mix(&key, sizeof(key));
+			mix(&s.stamp, sizeof(s.stamp));
+			if (!s.bodies.empty()) mix(s.bodies.data(), s.bodies.size() * sizeof(Packed));
+		}
+		return h;
+	}
+
+	// The records and the clock as WorldSnapshot sections (tag "SECT"); alive until `out`
+	// is saved.
+	void Save(WorldSnapshot::Writer& out) const {
+		savedStamps.clear();
+		savedCounts.clear();
+		savedBodies.clear();
+		for (uint32_t key : order) {
+			const Sector& s = sectors.at(key);
+			savedStamps.push_back(s.stamp);
+			savedCounts.push_back(static_cast<uint32_t>(s.bodies.size()));
+			savedBodies.insert(savedBodies.end(), s.bodies.begin(), s.bodies.end());
+		}
+		out.AddValue(C_SNAPSHOT_TAG, 0, layout);
+		out.AddValue(C_SNAPSHOT_TAG, 1, clock);
+		out.Add(C_SNAPSHOT_TAG, 2, order);
+		out.Add(C_SNAPSHOT_TAG, 3, savedStamps);
+		out.Add(C_SNAPSHOT_TAG, 4, savedCounts);
+		out.Add(C_SNAPSHOT_TAG, 5, savedBodies);
+	}
+
+	// Replaces the records with saved ones. False, with the map empty, when the sections are
+	// missing, disagree or were saved on another grid than Init set.
+	bool Load(const WorldSnapshot::Reader& in) {
+		Clear();
+		Layout saved{};
+		std::vector<uint32_t> keys, counts;
+		std::vector<double> stamps;
+		std::vector<Packed> bodies;
+		double savedClock = 0.0;
+		bool ok = in.ReadValue(C_SNAPSHOT_TAG, 0, saved) && saved == layout && in.ReadValue(C_SNAPSHOT_TAG, 1, savedClock)
+			&& in.Read(C_SNAPSHOT_TAG, 2, keys) && in.Read(C_SNAPSHOT_TAG, 3, stamps) && in.Read(C_SNAPSHOT_TAG, 4, counts)
+			&& in.Read(C_SNAPSHOT_TAG, 5, bodies) && stamps.size() == keys.size() && counts.size() == keys.size();
+		size_t at = 0;
+		const uint64_t cells = static_cast<uint64_t>(layout.cols) * static_cast<uint64_t>(layout.rows);
+		for (size_t k = 0; ok && k < keys.size(); ++k) {
+			ok = keys[k] < cells && counts[k] > 0 && counts[k] <= bodies.size() - at && sectors.find(keys[k]) == sectors.end();
+			if (!ok) break;
+			Sector& s = SectorAt(keys[k]);
+			s.stamp = stamps[k];
+			s.bodies.assign(bodies.begin() + static_cast<std::ptrdiff_t>(at), bodies.begin() + static_cast<std::ptrdiff_t>(at + counts[k]));
+			at += counts[k];
+		}
+		if (!ok || at != bodies.size()) {
+			Clear();
+			return false;
+		}
+		parked = at;
+		clock = savedClock;
+		return true;
+	}
+
+private:
+	static constexpr double   C_COARSE_SECONDS = 0.5;
+	static constexpr float    C_POSITION_STEPS = 32768.f;  // per sector
+	static constexpr float    C_SPEED_STEPS = 32.f;        // per px/s
+	static constexpr float    C_SPIN_STEPS = 64.f;         // per degree/s
+	static constexpr uint32_t C_SNAPSHOT_TAG = WorldSnapshot::Tag("SECT");
+
+	struct Layout {
+		float sectorW = 1.f;
+		float sectorH = 1.f;
+		int   cols = 0;
+		int   rows = 0;
+
+		bool operator==(const Layout&) const = default;
+	};
+
+	struct Packed {
+		uint16_t x, y;
+		int16_t  vx, vy;
+		uint16_t rotation;
+		int16_t  rotationSpeed;
+		uint8_t  size, shape;
+	};
+	static_assert(sizeof(Packed) == 14, "parked asteroids are meant to stay small");
+
+	struct Sector {
+		std::vector<Packed> bodies;
+		double              stamp = 0.0;  // the clock the records are as of
+	};
+
+	uint32_t Key(int col, int row) const {
+		return static_cast<uint32_t>(row) * static_cast<uint32_t>(layout.cols) + static_cast<uint32_t>(col);
+	}
+
+	// Map nodes don't move, so the reference outlives later insertions.
+	Sector& SectorAt(uint32_t key) {
+		auto [it, added] = sectors.try_emplace(key);
+		if (added) {
+			it->second.stamp = clock;
+			order.push_back(key);
+		}
+		return it->second;
+	}
+
+	void Erase(uint32_t key) {
+		sectors.erase(key);
+		for (size_t k = 0; k < order.size(); ++k) {
+			if (order[k] != key) continue;
+			order[k] = order.back();
+			order.pop_back();
+			break;
+		}
+	}
+
+	template<typename Fn>
+	void Update(uint32_t key, Sector& s, const Region& region, Fn& arrive) {
+		const int col = static_cast<int>(key % static_cast<uint32_t>(layout.cols));
+		const int row = static_cast<int>(key / static_cast<uint32_t>(layout.cols));
+		const float span = static_cast<float>(clock - s.stamp);
+		s.stamp = clock;
+		size_t keep = 0;
+		const size_t n = s.bodies.size();
+		for (size_t i = 0; i < n; ++i) {
+			const Body b = Advanced(Decode(s.bodies[i], col, row), span);
+			int c, r;
+			if (!SectorOf(b.x, b.y, c, r)) {
+				--parked;
+				continue;
+			}
+			if (region.Contains(c, r) && arrive(b)) {
+				--parked;
+				continue;
+			}
+			if (c == col && r == row) {
+				s.bodies[keep++] = Encode(b, col, row);
+				continue;
+			}
+			--parked;
+			Park(b);
+		}
+		s.bodies.resize(keep);
+	}
+
+	static Body Advanced(Body b, float dt) {
+		b.x += b.vx * dt;
+		b.y += b.vy * dt;
+		b.rotation += b.rotationSpeed * dt;
+		return b;
+	}
+
+	static uint16_t Unsigned(float v) {
+		return static_cast<uint16_t>(fminf(fmaxf(roundf(v), 0.f), 65535.f));
+	}
+
+	static int16_t Signed(float v) {
+		return static_cast<int16_t>(fminf(fmaxf(roundf(v), -32768.f), 32767.f));
+	}
+
+	Packed Encode(const Body& b, int col, int row) const {
+		const float u = (b.x - static_cast<float>(col) * layout.sectorW) / layout.sectorW + 0.5f;
+		const float v = (b.y - static_cast<float>(row) * layout.sectorH) / layout.sectorH + 0.5f;
+		const float turns = b.rotation / 360.f;
+		return {
+			Unsigned(u * C_POSITION_STEPS), Unsigned(v * C_POSITION_STEPS),
+			Signed(b.vx * C_SPEED_STEPS), Signed(b.vy * C_SPEED_STEPS),
+			static_cast<uint16_t>(static_cast<int32_t>(roundf((turns - floorf(turns)) * 65536.f)) & 0xFFFF),
+			Signed(b.rotationSpeed * C_SPIN_STEPS),
+			b.size, b.shape,
+		};
+	}
+
+	Body Decode(const Packed& p, int col, int row) const {
+		return {
+			(static_cast<float>(col) + static_cast<float>(p.x) / C_POSITION_STEPS - 0.5f) * layout.sectorW,
+			(static_cast<float>(row) + static_cast<float>(p.y) / C_POSITION_STEPS - 0.5f) * layout.sectorH,
+			static_cast<float>(p.vx) / C_SPEED_STEPS, static_cast<float>(p.vy) / C_SPEED_STEPS,
+			static_cast<float>(p.rotation) * (360.f / 65536.f), static_cast<float>(p.rotationSpeed) / C_SPIN_STEPS,
+			p.size, p.shape,
+		};
+	}
+
+	Layout                               layout;
+	std::unordered_map<uint32_t, Sector> sectors;
+	std::vector<uint32_t>                order;   // occupied sectors, the order Step visits them in
+	size_t                               parked = 0;
+	double                               clock = 0.0;
+
+	mutable std::vector<double>   savedStamps;  // Save's flattened copy, read when the Writer saves
+	mutable std::vector<uint32_t> savedCounts;
+	mutable std::vector<Packed>   savedBodies;
+};
+
+#endif // SECTOR_MAP_H
@@ -0,0 +1,198 @@
+#ifndef SHADER_CACHE_H
+#define SHADER_CACHE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include <raylib.h>
+#include <rlgl.h>
+#include <external/glad.h>
+
+// --- SHADER CACHE ---
+// Drop-in replacements for LoadShader/LoadShaderFromMemory that keep every linked program
+// as a driver binary on disk. The key hashes both sources together with the GL vendor,
+// renderer and version strings, so a new driver or an edited shader simply misses. A
+// hit hands the binary straight to glProgramBinary and skips compilation altogether; if
+// the driver rejects it (or has no program binary support) the shader is compiled from
+// source as usual and the entry rewritten. rlgl marks programs retrievable before it
+// links them, which some drivers need before they will hand a binary back.
+//
+// Entry file format: Header, then the binary. One file per key in Directory().
+namespace ShaderCache {
+	struct Stats {
+		int hits = 0;
+		int misses = 0;
+	};
+
+	inline Stats& Counters() {
+		static Stats stats;
+		return stats;
+	}
+
+	inline const char* Directory() {
+		return "shader_cache";
+	}
+
+	namespace Detail {
+		struct Header {
+			char     magic[8];
+			uint64_t key;
+			uint32_t format;
+			uint32_t size;
+		};
+
+		inline constexpr char C_MAGIC[8] = { 'P', 'O', 'I', 'G', 'K', 'S', 'B', '1' };
+
+		// FNV-1a, chained over every part of the key.
+		inline uint64_t Hash(uint64_t h, const char* text) {
+			if (!text) text = "<default>";
+			for (; *text; ++text) {
+				h ^= static_cast<unsigned char>(*text);
+				h *= 1099511628211ull;
+			}
+			return h ^ 0xff;  // separates "ab"+"c" from "a"+"bc"
+		}
+
+		inline const char* GlString(GLenum name) {
+			const GLubyte* s = glGetString(name);
+			return s ? reinterpret_cast<const char*>(s) : "";
+		}
+
+		inline uint64_t Key(const char* vsCode, const char* fsCode) {
+			uint64_t h = 14695981039346656037ull;
+			h = Hash(h, vsCode);
+			h = Hash(h, fsCode);
+			h = Hash(h, GlString(GL_VENDOR));
+			h = Hash(h, GlString(GL_RENDERER));
+			return Hash(h, GlString(GL_VERSION));
+		}
+
+		inline bool Supported() {
+			return (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary) && glProgramBinary && glGetProgramBinary;
+		}
+
+		inline const char* PathOf(uint64_t key) {
+			return TextFormat("%s/%016llx.bin", Directory(), static_cast<unsigned long long>(key));
+		}
+
+		// The default locations LoadShaderFromMemory sets up, for a program linked here.
+		// Names are rlgl's defaults (RL_DEFAULT_SHADER_*_NAME_*, private to its implementation).
+		inline Shader Wrap(unsigned int id) {
+			struct Location {
+				int         index;
+				const char* name;
+				bool        attrib;
+			};
+			static constexpr Location C_LOCATIONS[] = {
+				{ SHADER_LOC_VERTEX_POSITION,   "vertexPosition",  true },
+				{ SHADER_LOC_VERTEX_TEXCOORD01, "vertexTexCoord",  true },
+				{ SHADER_LOC_VERTEX_TEXCOORD02, "vertexTexCoord2", true },
+				{ SHADER_LOC_VERTEX_NORMAL,     "vertexNormal",    true },
+				{ SHADER_LOC_VERTEX_TANGENT,    "vertexTangent",   true },
+				{ SHADER_LOC_VERTEX_COLOR,      "vertexColor",     true },
+				{ SHADER_LOC_MATRIX_MVP,        "mvp",             false },
+				{ SHADER_LOC_MATRIX_VIEW,       "matView",         false },
+				{ SHADER_LOC_MATRIX_PROJECTION, "matProjection",   false },
+				{ SHADER_LOC_MATRIX_MODEL,      "matModel",        false },
+				{ SHADER_LOC_MATRIX_NORMAL,     "matNormal",       false },
+				{ SHADER_LOC_COLOR_DIFFUSE,     "colDiffuse",      false },
+				{ SHADER_LOC_MAP_DIFFUSE,       "texture0",        false },
+				{ SHADER_LOC_MAP_SPECULAR,      "texture1",        false },
+				{ SHADER_LOC_MAP_NORMAL,        "texture2",        false },
+			};
+
+			Shader shader{};
+			shader.id = id;
+			shader.locs = static_cast<int*>(RL_CALLOC(RL_MAX_SHADER_LOCATIONS, sizeof(int)));  // UnloadShader RL_FREEs it
+			for (int i = 0; i < RL_MAX_SHADER_LOCATIONS; i++) shader.locs[i] = -1;
+			for (const Location& l : C_LOCATIONS) {
+				shader.locs[l.index] = l.attrib ? rlGetLocationAttrib(id, l.name) : rlGetLocationUniform(id, l.name);
+			}
+			return shader;
+		}
+
+		// A linked program from the entry for `key`, or 0.
+		inline unsigned int Read(uint64_t key) {
+			int bytes = 0;
+			unsigned char* data = LoadFileData(PathOf(key), &bytes);
+			if (!data) return 0;
+
+			unsigned int id = 0;
+			Header h;
+			if (bytes >= static_cast<int>(sizeof(Header))) {
+				memcpy(&h, data, sizeof(Header));
+				bool valid = memcmp(h.magic, C_MAGIC, sizeof(C_MAGIC)) == 0 && h.key == key
+					&& h.size == static_cast<uint32_t>(bytes) - sizeof(Header);
+				if (valid) {
+					id = glCreateProgram();
+					glProgramBinary(id, h.format, data + sizeof(Header), static_cast<GLsizei>(h.size));
+					GLint linked = GL_FALSE;
+					glGetProgramiv(id, GL_LINK_STATUS, &linked);
+					if (linked != GL_TRUE) {
+						glDeleteProgram(id);
+						id = 0;
+					}
+				}
+			}
+			UnloadFileData(data);
+			return id;
+		}
+
+		inline void Write(uint64_t key, unsigned int id) {
+			GLint size = 0;
+			glGetProgramiv(id, GL_PROGRAM_BINARY_LENGTH, &size);
+			if (size <= 0) return;
+
+			std::vector<unsigned char> file(sizeof(Header) + static_cast<size_t>(size));
+			GLsizei written = 0;
+			GLenum format = 0;
+			glGetProgramBinary(id, size, &written, &format, file.data() + sizeof(Header));
+			if (written <= 0) return;
+
+			Header h;
+			memcpy(h.magic, C_MAGIC, sizeof(C_MAGIC));
+			h.key = key;
+			h.format = format;
+			h.size = static_cast<uint32_t>(written);
+			memcpy(file.data(), &h, sizeof(Header));
+
+			std::error_code ignored;
+			std::filesystem::create_directories(Directory(), ignored);
+			SaveFileData(PathOf(key), file.data(), static_cast<int>(sizeof(Header) + h.size));
+		}
+	}
+
+	// LoadShaderFromMemory through the cache. Either code may be nullptr for raylib's default.
+	inline Shader LoadFromMemory(const char* vsCode, const char* fsCode) {
+		if (!Detail::Supported()) return LoadShaderFromMemory(vsCode, fsCode);
+
+		const uint64_t key = Detail::Key(vsCode, fsCode);
+		if (unsigned int id = Detail::Read(key)) {
+			++Counters().hits;
+			TraceLog(LOG_INFO, "SHADER CACHE: [ID %u] Program loaded from %s", id, Detail::PathOf(key));
+			return Detail::Wrap(id);
+		}
+
+		++Counters().misses;
+		Shader shader = LoadShaderFromMemory(vsCode, fsCode);
+		if (shader.id != rlGetShaderIdDefault()) Detail::Write(key, shader.id);
+		return shader;
+	}
+
+	// LoadShader through the cache: the files are still read every time, since their text
+	// is the key, but only a miss compiles them.
+	inline Shader Load(const char* vsFileName, const char* fsFileName) {
+		char* vsCode = vsFileName ? LoadFileText(vsFileName) : nullptr;
+		char* fsCode = fsFileName ? LoadFileText(fsFileName) : nullptr;
+		Shader shader = LoadFromMemory(vsCode, fsCode);
+		UnloadFileText(vsCode);
+		UnloadFileText(fsCode);
+		return shader;
+	}
+}
+
+#endif // SHADER_CACHE_H
@@ -0,0 +1,205 @@
+#ifndef SHADER_RELOAD_H
+#define SHADER_RELOAD_H
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <raylib.h>
+#include <rlgl.h>
+#include <external/glad.h>
+
+#include "shader_cache.h"
+
+// --- SHADER HOT RELOAD ---
+// Watches shader files and swaps in a new program when one is saved, without stalling the
+// frame that notices. Poll() only issues the compile and link; it never asks the driver
+// for a result until the result is ready, which is what would block. With
+// GL_KHR_parallel_shader_compile the driver compiles on its own threads and reports
+// GL_COMPLETION_STATUS_KHR; without it the program is given C_SETTLE_FRAMES frames, which
+// threaded drivers usually need less than, before its status is read. A program that fails
+// to link logs why and is dropped, so the running shader stays until the file is fixed.
+//
+// A swap replaces the watched Shader in place. Uniform values and locations belong to the
+// old program, so the OnSwap callback is where callers fetch locations and resend values.
+class ShaderWatcher {
+public:
+	using OnSwap = std::function<void(Shader&)>;
+
+	ShaderWatcher() = default;
+	ShaderWatcher(const ShaderWatcher&) = delete;
+	ShaderWatcher& operator=(const ShaderWatcher&) = delete;
+
+	~ShaderWatcher() {
+		for (Entry& e : entries) Abandon(e);
+	}
+
+	// `shader` must outlive the watcher. Both files are needed: raylib's default vertex
+	// shader isn't reachable from here.
+	void Watch(Shader* shader, const char* vsFileName, const char* fsFileName, OnSwap onSwap = {}) {
+		Entry e;
+		e.shader = shader;
+		e.vsFileName = vsFileName;
+		e.fsFileName = fsFileName;
+		e.vsTime = GetFileModTime(vsFileName);
+		e.fsTime = GetFileModTime(fsFileName);
+		e.onSwap = std::move(onSwap);
+		entries.push_back(std::move(e));
+		parallel = HasExtension("GL_KHR_parallel_shader_compile");
+	}
+
+	// Once per frame, on the thread that owns the GL context.
+	void Poll() {
+		for (Entry& e : entries) {
+			if (e.program) Finish(e);
+		}
+
+		double now = GetTime();
+		if (now - lastCheck < C_CHECK_SECONDS) return;
+		lastCheck = now;
+		for (Entry& e : entries) {
+			long vsTime = GetFileModTime(e.vsFileName.c_str());
+			long fsTime = GetFileModTime(e.fsFileName.c_str());
+			if (vsTime == e.vsTime && fsTime == e.fsTime) continue;
+			e.vsTime = vsTime;
+			e.fsTime = fsTime;
+			// A save while the last one is still compiling replaces it.
+			Abandon(e);
+			Start(e);
+		}
+	}
+
+	// Programs swapped in since the watcher started.
+	int Swaps() const {
+		return swaps;
+	}
+
+private:
+	static constexpr double C_CHECK_SECONDS = 0.25;
+	static constexpr int    C_SETTLE_FRAMES = 8;
+	static constexpr GLenum C_COMPLETION_STATUS_KHR = 0x91B1;  // not in raylib's glad
+
+	struct Entry {
+		Shader*      shader = nullptr;
+		std::string  vsFileName;
+		std::string  fsFileName;
+		long         vsTime = 0;
+		long         fsTime = 0;
+		OnSwap       onSwap;
+		std::string  vsCode;    // sources of the program in flight, for the cache key
+		std::string  fsCode;
+		unsigned int program = 0;
+		unsigned int vs = 0;
+		unsigned int fs = 0;
+		int          frames = 0;
+	};
+
+	static bool HasExtension(const char* name) {
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; ++i) {
+			const GLubyte* ext = glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i));
+			if (ext && strcmp(reinterpret_cast<const char*>(ext), name) == 0) return true;
+		}
+		return false;
+	}
+
+	static unsigned int Compile(GLenum type, const std::string& code) {
+		unsigned int id = glCreateShader(type);
+		const char* text = code.c_str();
+		glShaderSource(id, 1, &text, nullptr);
+		glCompileShader(id);
+		return id;
+	}
+
+	// Issues compile and link and returns straight away.
+	void Start(Entry& e) {
+		char* vsText = LoadFileText(e.vsFileName.c_str());
+		char* fsText = LoadFileText(e.fsFileName.c_str());
+		// Editors often truncate before writing; the next check sees the finished file.
+		bool ok = vsText && fsText && vsText[0] && fsText[0];
+		if (ok) {
+			e.vsCode = vsText;
+			e.fsCode = fsText;
+		}
+		UnloadFileText(vsText);
+		UnloadFileText(fsText);
+		if (!ok) return;
+
+		e.vs = Compile(GL_VERTEX_SHADER, e.vsCode);
+		e.fs = Compile(GL_FRAGMENT_SHADER, e.fsCode);
+		e.program = glCreateProgram();
+		glAttachShader(e.program, e.vs);
+		glAttachShader(e.program, e.fs);
+		// Same attribute slots rlLoadShaderProgram binds.
+		const char* attribs[] = { "vertexPosition", "vertexTexCoord", "vertexNormal", "vertexColor", "vertexTangent", "vertexTexCoord2" };
+		for (GLuint slot = 0; slot < 6; ++slot) glBindAttribLocation(e.program, slot, attribs[slot]);
+		if (glProgramParameteri) glProgramParameteri(e.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(e.program);
+		e.frames = 0;
+	}
+
+	// Swaps the program in once the driver is done with it.
+	void Finish(Entry& e) {
+		++e.frames;
+		if (parallel) {
+			GLint done = GL_FALSE;
+			glGetProgramiv(e.program, C_COMPLETION_STATUS_KHR, &done);
+			if (!done) return;
+		}
+		else if (e.frames < C_SETTLE_FRAMES) {
+			return;
+		}
+
+		GLint linked = GL_FALSE;
+		glGetProgramiv(e.program, GL_LINK_STATUS, &linked);
+		if (linked != GL_TRUE) {
+			LogFailure(e);
+			Abandon(e);
+			return;
+		}
+
+		unsigned int id = e.program;
+		glDetachShader(id, e.vs);
+		glDetachShader(id, e.fs);
+		glDeleteShader(e.vs);
+		glDeleteShader(e.fs);
+		e.program = e.vs = e.fs = 0;
+
+		ShaderCache::Detail::Write(ShaderCache::Detail::Key(e.vsCode.c_str(), e.fsCode.c_str()), id);
+		UnloadShader(*e.shader);
+		*e.shader = ShaderCache::Detail::Wrap(id);
+		++swaps;
+		TraceLog(LOG_INFO, "SHADER RELOAD: [ID %u] %s swapped in after %d frame(s)", id, e.fsFileName.c_str(), e.frames);
+		if (e.onSwap) e.onSwap(*e.shader);
+	}
+
+	static void LogFailure(const Entry& e) {
+		char log[1024];
+		for (unsigned int id : { e.vs, e.fs }) {
+			GLint compiled = GL_FALSE;
+			glGetShaderiv(id, GL_COMPILE_STATUS, &compiled);
+			if (compiled == GL_TRUE) continue;
+			glGetShaderInfoLog(id, sizeof(log), nullptr, log);
+			TraceLog(LOG_WARNING, "SHADER RELOAD: %s: %s", id == e.vs ? e.vsFileName.c_str() : e.fsFileName.c_str(), log);
+		}
+		glGetProgramInfoLog(e.program, sizeof(log), nullptr, log);
+		TraceLog(LOG_WARNING, "SHADER RELOAD: keeping the running program, link failed: %s", log);
+	}
+
+	static void Abandon(Entry& e) {
+		if (!e.program) return;
+		glDeleteShader(e.vs);
+		glDeleteShader(e.fs);
+		glDeleteProgram(e.program);
+		e.program = e.vs = e.fs = 0;
+	}
+
+	std::vector<Entry> entries;
+	bool               parallel = false;
+	double             lastCheck = 0.0;
+	int                swaps = 0;
+};
+
+#endif // SHADER_RELOAD_H
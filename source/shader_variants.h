@@ -0,0 +1,177 @@
+#ifndef SHADER_VARIANTS_H
+#define SHADER_VARIANTS_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <raylib.h>
+#include <rlgl.h>
+
+#include "shader_cache.h"
+
+// --- SHADER VARIANTS ---
+// Precompiled permutations of one shader pair instead of branching on uniforms per fragment.
+// A Features value names what a draw actually needs (which of the four lights are on and of
+// what type), its Key() picks the variant, and the variant is the same source with those
+// features as #defines after the #version line, so the compiler unrolls the light loop down
+// to the enabled lights and folds the type tests away. A variant is compiled the first time
+// it is asked for and kept; across runs ShaderCache has it as a program binary already, its
+// defines being part of the text the cache key hashes.
+//
+// A shader opts in with #ifdef on the keys and keeps its uniform branches for a plain load
+// without defines, so the same file serves both; lighting.fs does, for Main2's forward path.
+class ShaderVariants {
+public:
+	// Run on each variant as it is created: fetch locations and send the values that don't
+	// change per frame, as a ShaderWatcher callback does.
+	using OnCreate = std::function<void(Shader&)>;
+
+	struct Features {
+		static constexpr int C_MAX_LIGHTS = 4;  // MAX_LIGHTS in the shaders
+
+		uint8_t lights = 0;        // bit i: light i is enabled
+		uint8_t pointLights = 0;   // bit i: light i is a point light, else directional
+
+		void SetLight(int index, bool enabled, bool point) {
+			if (index < 0 || index >= C_MAX_LIGHTS) return;
+			const uint8_t bit = static_cast<uint8_t>(1u << index);
+			lights = static_cast<uint8_t>(enabled ? lights | bit : lights & ~bit);
+			pointLights = static_cast<uint8_t>(point ? pointLights | bit : pointLights & ~bit);
+		}
+
+		// A disabled light's type never reaches the shader, so it doesn't split variants.
+		uint32_t Key() const {
+			return static_cast<uint32_t>(lights) | static_cast<uint32_t>(pointLights & lights) << 8;
+		}
+
+		std::string Defines() const {
+			std::string text = "#define LIGHTS_ENABLED " + std::to_string(lights) + "\n";
+			text += "#define LIGHTS_POINT " + std::to_string(pointLights & lights) + "\n";
+			return text;
+		}
+	};
+
+	ShaderVariants() = default;
+	ShaderVariants(const ShaderVariants&) = delete;
+	ShaderVariants& operator=(const ShaderVariants&) = delete;
+
+	// Both files are needed; nothing is compiled until Get.
+	void Init(const char* vsFileName_, const char* fsFileName_, OnCreate onCreate_ = {}) {
+		Unload();
+		vsFileName = vsFileName_;
+		fsFileName = fsFileName_;
+		onCreate = std::move(onCreate_);
+		Read();
+	}
+
+	// The variant for `features`, compiled now if no earlier call needed it; raylib's
+	// default shader if it doesn't build. Only on the thread that owns the GL context.
+	Shader Get(const Features& features) {
+		last = features;
+		used = true;
+		const uint32_t key = features.Key();
+		auto found = variants.find(key);
+		if (found != variants.end()) return found->second;
+
+		Shader shader = Compile(features, vsCode, fsCode);
+		variants.emplace(key, shader);
+		return shader;
+	}
+
+	// Once per frame. When either file has been saved since it was read, the variant last
+	// asked for is compiled from the new text first: if it builds, every other variant is
+	// dropped and the next Get compiles from the new text; if not, the running variants and
+	// text are kept, as ShaderWatcher keeps its program, until the next save. Shaders being
+	// edited are the only ones that pay for that.
+	void Poll() {
+		if (vsFileName.empty()) return;
+		const double now = GetTime();
+		if (now - lastCheck < C_CHECK_SECONDS) return;
+		lastCheck = now;
+		if (GetFileModTime(vsFileName.c_str()) == vsTime && GetFileModTime(fsFileName.c_str()) == fsTime) return;
+
+		std::string oldVs = std::move(vsCode);
+		std::string oldFs = std::move(fsCode);
+		Read();
+		if (!used) return;
+		const Shader fresh = Compile(last, vsCode, fsCode);
+		if (fresh.id == rlGetShaderIdDefault()) {
+			TraceLog(LOG_WARNING, "SHADER VARIANTS: %s doesn't build, keeping the running variants", fsFileName.c_str());
+			vsCode = std::move(oldVs);
+			fsCode = std::move(oldFs);
+			return;
+		}
+		UnloadVariants();
+		variants.emplace(last.Key(), fresh);
+	}
+
+	int Count() const {
+		return static_cast<int>(variants.size());
+	}
+
+	// Before CloseWindow, like the shaders themselves.
+	void Unload() {
+		UnloadVariants();
+		vsCode.clear();
+		fsCode.clear();
+	}
+
+private:
+	static constexpr double C_CHECK_SECONDS = 1.0;
+
+	// GLSL wants #version before anything else, so the defines go on the line after it.
+	static std::string WithDefines(const std::string& code, const std::string& defines) {
+		if (code.rfind("#version", 0) != 0) return defines + code;
+		const size_t eol = code.find('\n');
+		if (eol == std::string::npos) return code + "\n" + defines;
+		return code.substr(0, eol + 1) + defines + code.substr(eol + 1);
+	}
+
+	// Runs onCreate on the variant unless it failed and came back as raylib's default shader,
+	// whose locations every other default draw shares.
+	Shader Compile(const Features& features, const std::string& vsText, const std::string& fsText) const {
+		const std::string defines = features.Defines();
+		const std::string vs = WithDefines(vsText, defines);
+		const std::string fs = WithDefines(fsText, defines);
+		Shader shader = ShaderCache::LoadFromMemory(vs.c_str(), fs.c_str());
+		if (shader.id == rlGetShaderIdDefault()) {
+			TraceLog(LOG_WARNING, "SHADER VARIANTS: %s key %04x failed to build", fsFileName.c_str(), features.Key());
+			return shader;
+		}
+		TraceLog(LOG_INFO, "SHADER VARIANTS: %s key %04x -> [ID %u]", fsFileName.c_str(), features.Key(), shader.id);
+		if (onCreate) onCreate(shader);
+		return shader;
+	}
+
+	void Read() {
+		vsTime = GetFileModTime(vsFileName.c_str());
+		fsTime = GetFileModTime(fsFileName.c_str());
+		char* vs = LoadFileText(vsFileName.c_str());
+		char* fs = LoadFileText(fsFileName.c_str());
+		vsCode = vs ? vs : "";
+		fsCode = fs ? fs : "";
+		UnloadFileText(vs);
+		UnloadFileText(fs);
+	}
+
+	void UnloadVariants() {
+		for (auto& entry : variants) UnloadShader(entry.second);
+		variants.clear();
+	}
+
+	std::string vsFileName, fsFileName;
+	std::string vsCode, fsCode;
+	long        vsTime = 0;
+	long        fsTime = 0;
+	double      lastCheck = 0.0;
+	OnCreate    onCreate;
+	Features    last;          // the features Get was last asked for, rebuilt first on a save
+	bool        used = false;
+
+	std::unordered_map<uint32_t, Shader> variants;
+};
+
+#endif // SHADER_VARIANTS_H
@@ -0,0 +1,86 @@
+#ifndef SIMD_VECTOR_H
+#define SIMD_VECTOR_H
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "raylib.h"
+
+// --- SIMD VECTOR KERNELS ---
+// raymath's Vector2/Vector3 operations over many vectors at once, on structure-of-arrays
+// columns (one array per component) as the fields and the culling code keep them. Like
+// simd.h's kernels they take 8 vectors per iteration with AVX2 and finish the tail with a
+// scalar loop; both do the same IEEE operations in the same order (no fused multiply-add),
+// so a vector's result doesn't depend on where it falls in the range.
+namespace Simd {
+	// Rescales each (x[i], y[i]) to length[i], or to unit length (Vector2Normalize) when
+	// `length` is null, over [begin, end). Zero vectors stay zero.
+	inline void Normalize2(float* x, float* y, const float* length, size_t begin, size_t end) {
+		size_t i = begin;
+#if defined(__AVX2__)
+		const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.f);
+		for (; i + 8 <= end; i += 8) {
+			__m256 vx = _mm256_loadu_ps(x + i);
+			__m256 vy = _mm256_loadu_ps(y + i);
+			__m256 len = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+			__m256 nonzero = _mm256_cmp_ps(len, zero, _CMP_GT_OQ);
+			__m256 target = length ? _mm256_loadu_ps(length + i) : one;
+			// Dividing by 1 where the length is 0 keeps the lane finite; the blend zeroes it.
+			__m256 scale = _mm256_blendv_ps(zero, _mm256_div_ps(target, _mm256_blendv_ps(one, len, nonzero)), nonzero);
+			_mm256_storeu_ps(x + i, _mm256_mul_ps(vx, scale));
+			_mm256_storeu_ps(y + i, _mm256_mul_ps(vy, scale));
+		}
+#endif
+		for (; i < end; ++i) {
+			float len = sqrtf(x[i] * x[i] + y[i] * y[i]);
+			float scale = len > 0.f ? (length ? length[i] : 1.f) / len : 0.f;
+			x[i] *= scale;
+			y[i] *= scale;
+		}
+	}
+
+	// inside[i] = 1 when sphere i (centre x, y, z, radius r) is on or inside all six of
+	// `planes` (InstanceCuller::FrustumPlanes: inward-facing, normalised), else 0, over
+	// [begin, end). Returns how many are inside.
+	inline size_t SpheresInFrustum(const float* planes, const float* x, const float* y, const float* z, const float* r,
+		size_t begin, size_t end, unsigned char* inside)
+	{
+		size_t i = begin;
+		size_t count = 0;
+#if defined(__AVX2__)
+		for (; i + 8 <= end; i += 8) {
+			__m256 vx = _mm256_loadu_ps(x + i);
+			__m256 vy = _mm256_loadu_ps(y + i);
+			__m256 vz = _mm256_loadu_ps(z + i);
+			__m256 lo = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(r + i));
+			__m256 in = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+			for (int p = 0; p < 6; ++p) {
+				const float* plane = &planes[p * 4];
+				__m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[0]), vx),
+					_mm256_mul_ps(_mm256_set1_ps(plane[1]), vy)), _mm256_mul_ps(_mm256_set1_ps(plane[2]), vz)), _mm256_set1_ps(plane[3]));
+				in = _mm256_and_ps(in, _mm256_cmp_ps(d, lo, _CMP_GE_OQ));
+			}
+			unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(in));
+			for (int k = 0; k < 8; ++k) inside[i + k] = static_cast<unsigned char>((mask >> k) & 1u);
+			count += static_cast<size_t>(std::popcount(mask));
+		}
+#endif
+		for (; i < end; ++i) {
+			bool in = true;
+			for (int p = 0; p < 6 && in; ++p) {
+				const float* plane = &planes[p * 4];
+				in = plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3] >= -r[i];
+			}
+			inside[i] = static_cast<unsigned char>(in);
+			count += static_cast<size_t>(in);
+		}
+		return count;
+	}
+}
+
+#endif // SIMD_VECTOR_H
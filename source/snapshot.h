@@ -0,0 +1,230 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// --- SNAPSHOT HANDOFF ---
+// Lock-free triple buffer for handing whole frames from one producer thread to one
+// consumer thread. The producer fills Back() and publishes it; the consumer picks up the
+// newest published slot with Acquire() and reads Front() for as long as it likes. Neither
+// side ever waits for the other: a slow consumer just skips frames. Slots are reused, so
+// a T built from vectors stops allocating once they are warm.
+template<typename T>
+class TripleBuffer {
+public:
+	T& Back() {
+		return slots[back];
+	}
+
+	void Publish() {
+		back = ready.exchange(back | C_FRESH, std::memory_order_acq_rel) & C_INDEX;
+	}
+
+	// Swaps in the newest published slot, if there is one. Returns false when Front() is
+	// already the latest.
+	bool Acquire() {
+		if (!(ready.load(std::memory_order_relaxed) & C_FRESH)) return false;
+		front = ready.exchange(front, std::memory_order_acq_rel) & C_INDEX;
+		return true;
+	}
+
+	const T& Front() const {
+		return slots[front];
+	}
+
+private:
+	static constexpr int C_INDEX = 3;
+	static constexpr int C_FRESH = 4;
+
+	std::array<T, 3> slots{};
+	std::atomic<int> ready{ 1 };
+	int              back = 0;
+	int              front = 2;
+};
+
+// Wait-free ring between one producer thread and one consumer thread, N (a power of two)
+// items deep. Each side owns one index and keeps a copy of the other's that it only
+// refreshes when the ring looks full (producer) or empty (consumer), so a push or pop in
+// the steady state touches no line the other thread writes but the slot itself. The two
+// indices are kept a cache line apart, and apart from the slots. Nothing here blocks; see
+// BoundedQueue.
+template<typename T, size_t N>
+class SpscQueue {
+	static_assert(N > 0 && (N & (N - 1)) == 0, "SpscQueue: N must be a power of two");
+
+public:
+	static constexpr size_t C_CACHE_LINE = 64;
+
+	// Producer: copies in as many of `items` as fit, in order, and returns how many.
+	size_t PushBatch(const T* items, size_t count) {
+		const size_t h = head.load(std::memory_order_relaxed);
+		const size_t room = Room(h, count);
+		const size_t n = count < room ? count : room;
+		for (size_t i = 0; i < n; ++i) slots[(h + i) & C_MASK] = items[i];
+		if (n > 0) head.store(h + n, std::memory_order_release);
+		return n;
+	}
+
+	bool TryPush(const T& item) {
+		return PushBatch(&item, 1) == 1;
+	}
+
+	// Moves `item` in, or leaves it alone when the ring is full.
+	bool TryPush(T&& item) {
+		const size_t h = head.load(std::memory_order_relaxed);
+		if (Room(h, 1) == 0) return false;
+		slots[h & C_MASK] = std::move(item);
+		head.store(h + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer: moves up to `max` items out, oldest first, and returns how many.
+	size_t PopBatch(T* out, size_t max) {
+		const size_t t = tail.load(std::memory_order_relaxed);
+		if (headSeen - t < max) headSeen = head.load(std::memory_order_acquire);
+		const size_t n = headSeen - t < max ? headSeen - t : max;
+		for (size_t i = 0; i < n; ++i) out[i] = std::move(slots[(t + i) & C_MASK]);
+		if (n > 0) tail.store(t + n, std::memory_order_release);
+		return n;
+	}
+
+	bool TryPop(T& out) {
+		return PopBatch(&out, 1) == 1;
+	}
+
+	// Items in the ring as either side last saw it; exact only on a thread that is both.
+	size_t Size() const {
+		return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+	}
+
+	// Only while neither side is using the ring.
+	void Clear() {
+		head.store(0, std::memory_order_relaxed);
+		tail.store(0, std::memory_order_relaxed);
+		tailSeen = headSeen = 0;
+	}
+
+private:
+	static constexpr size_t C_MASK = N - 1;
+
+	// Free slots for a push of `wanted` from `h`, looking at the consumer's tail again only
+	// if the last look doesn't leave enough.
+	size_t Room(size_t h, size_t wanted) {
+		if (N - (h - tailSeen) < wanted) tailSeen = tail.load(std::memory_order_acquire);
+		return N - (h - tailSeen);
+	}
+
+	alignas(C_CACHE_LINE) std::atomic<size_t> head{ 0 };  // next slot to fill; the producer's
+	size_t                                    tailSeen = 0;
+	alignas(C_CACHE_LINE) std::atomic<size_t> tail{ 0 };  // next slot to empty; the consumer's
+	size_t                                    headSeen = 0;
+	alignas(C_CACHE_LINE) std::array<T, N>    slots{};
+};
+
+// Bounded blocking FIFO between two threads. Push() waits while the queue is full, which
+// keeps the producer at most N items ahead; Pop() waits for an item and returns false
+// once the queue is closed and drained. An SpscQueue underneath: a side only sleeps, on an
+// atomic wait, when it has to, and a push or pop that doesn't wait takes no lock.
+template<typename T, size_t N>
+class BoundedQueue {
+public:
+	void Push(const T& item) {
+		for (;;) {
+			const uint32_t seen = pops.load(std::memory_order_acquire);
+			if (closed.load(std::memory_order_relaxed)) return;
+			if (ring.TryPush(item)) break;
+			pops.wait(seen, std::memory_order_acquire);
+		}
+		pushes.fetch_add(1, std::memory_order_release);
+		pushes.notify_one();
+	}
+
+	bool Pop(T& out) {
+		for (;;) {
+			const uint32_t seen = pushes.load(std::memory_order_acquire);
+			// Read before trying, so anything pushed before Close() is still found.
+			const bool done = closed.load(std::memory_order_acquire);
+			if (ring.TryPop(out)) break;
+			if (done) return false;
+			pushes.wait(seen, std::memory_order_acquire);
+		}
+		pops.fetch_add(1, std::memory_order_release);
+		pops.notify_one();
+		return true;
+	}
+
+	void Close() {
+		closed.store(true, std::memory_order_release);
+		pushes.fetch_add(1, std::memory_order_release);
+		pops.fetch_add(1, std::memory_order_release);
+		pushes.notify_all();
+		pops.notify_all();
+	}
+
+	// Reopens an empty queue for another session.
+	void Reset() {
+		ring.Clear();
+		closed.store(false, std::memory_order_relaxed);
+	}
+
+private:
+	SpscQueue<T, N>       ring;
+	std::atomic<uint32_t> pushes{ 0 }, pops{ 0 };  // bumped after each, what the other side sleeps on
+	std::atomic<bool>     closed{ false };
+};
+
+// Events handed from one thread to another in batches. Unlike a TripleBuffer nothing is
+// dropped when the reader falls behind: Post() appends, Take() collects everything posted
+// since the last call. Each Post() goes through an SpscQueue as one vector, and the reader
+// sends the emptied vectors back through another, so once both are warm no post allocates.
+// A writer more than C_BATCHES posts ahead holds on to the rest until there is room.
+template<typename T>
+class Mailbox {
+public:
+	static constexpr size_t C_BATCHES = 8;
+
+	// Writer: moves the items in and leaves `items` empty. An empty post still sends on
+	// what an earlier one had to hold.
+	void Post(std::vector<T>& items) {
+		if (items.empty()) {
+			if (!held.empty() && posted.TryPush(std::move(held))) held.clear();
+			return;
+		}
+		if (!held.empty()) {
+			held.insert(held.end(), items.begin(), items.end());
+			items.clear();
+			if (posted.TryPush(std::move(held))) held.clear();
+			return;
+		}
+		std::vector<T> batch;
+		recycled.TryPop(batch);
+		batch.swap(items);
+		if (!posted.TryPush(std::move(batch))) held.swap(batch);
+	}
+
+	// Reader: replaces `out` with the posted items. `out`'s storage is recycled for later posts.
+	void Take(std::vector<T>& out) {
+		out.clear();
+		const size_t n = posted.PopBatch(taken.data(), C_BATCHES);
+		for (size_t i = 0; i < n; ++i) {
+			std::vector<T>& batch = taken[i];
+			if (out.empty()) out.swap(batch);
+			else out.insert(out.end(), batch.begin(), batch.end());
+			batch.clear();
+			recycled.TryPush(std::move(batch));  // else freed when the slot is next filled
+		}
+	}
+
+private:
+	SpscQueue<std::vector<T>, C_BATCHES>   posted;
+	SpscQueue<std::vector<T>, C_BATCHES>   recycled;
+	std::vector<T>                         held;   // the writer's
+	std::array<std::vector<T>, C_BATCHES>  taken;  // the reader's
+};
+
+#endif // SNAPSHOT_H
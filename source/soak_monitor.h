@@ -0,0 +1,276 @@
+#ifndef SOAK_MONITOR_H
+#define SOAK_MONITOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "frame_times.h"
+#include "memory_tracker.h"
+#include "raylib.h"
+
+// --- SOAK MONITOR ---
+// Leak and drift detection for sessions hours long (`--soak`). Every tick's time goes into
+// a LatencyHistogram, and every interval of wall clock a Sample is taken: the heap per
+// subsystem, the allocations of the interval, the entity counts and the interval's tick
+// percentiles. Each sample is appended to a binary log as soon as it is taken, so a run
+// that dies still leaves its history. At the end Analyze() compares the first and the last
+// quarter of the samples after a warm-up and flags every series that grew monotonically
+// (each late sample above every early one, by more than the tolerance) or drifted up
+// (latency whose late mean is past the early one by the tolerance). Memory of a subsystem
+// whose entity count grows alongside isn't a leak: it is only flagged when it outgrows
+// its count.
+//
+// Log format: a LogHeader, then Samples back to back until the end of the file, both in
+// the writer's byte order. `sampleSize` and `tags` are checked before reading any further.
+class SoakMonitor {
+public:
+	struct LogHeader {
+		char     magic[8];    // C_MAGIC
+		uint32_t version;
+		uint32_t sampleSize;  // sizeof(Sample)
+		uint32_t tags;        // MemoryTracker::C_TAGS, the length of Sample::tagBytes
+		uint32_t tickRate;    // simulation ticks per second
+		double   interval;    // seconds of wall clock between samples
+	};
+
+	struct Sample {
+		double   seconds;         // wall clock since Start()
+		uint64_t ticks;           // simulated since Start()
+		uint64_t liveBytes;       // the whole heap, as MemoryTracker sees it
+		uint64_t liveBlocks;
+		uint64_t allocations;     // during the interval, every thread
+		uint64_t allocatedBytes;  // during the interval
+		uint32_t asteroids;       // live, in the simulated region
+		uint32_t parked;          // asteroids parked in sectors (streamed worlds)
+		uint32_t projectiles;
+		uint32_t ships;
+		int32_t  score;
+		float    tickP50;         // ms, over the interval's ticks
+		float    tickP99;
+		float    tickMax;
+		uint64_t tagBytes[MemoryTracker::C_TAGS];
+	};
+
+	// What the world holds when a sample is taken.
+	struct Counts {
+		size_t asteroids;
+		size_t parked;
+		size_t projectiles;
+		size_t ships;
+		int    score;
+	};
+
+	static constexpr char     C_MAGIC[8] = { 'P', 'O', 'I', 'G', 'S', 'O', 'A', 'K' };
+	static constexpr uint32_t C_VERSION = 1;
+
+	SoakMonitor() = default;
+	~SoakMonitor() {
+		if (log) fclose(log);
+	}
+
+	SoakMonitor(const SoakMonitor&) = delete;
+	SoakMonitor& operator=(const SoakMonitor&) = delete;
+
+	// Starts the clock for a soak of `seconds` and, with a `logPath`, the log. Returns false
+	// if the log can't be written; the soak then runs without one. The samples are reserved
+	// here, so the monitor's own memory stays flat for the whole run.
+	bool Start(const char* logPath, double seconds, double interval_, int tickRate) {
+		interval = interval_ > 0.0 ? interval_ : 1.0;
+		samples.clear();
+		samples.reserve(static_cast<size_t>(seconds / interval) + 2);
+		ticks.Reset();
+		tickCount = 0;
+		allocationMark = MemoryTracker::Instance().Allocations();
+		allocatedMark = MemoryTracker::Instance().AllocatedBytes();
+		start = next = std::chrono::steady_clock::now();
+		next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval));
+		if (!logPath) return true;
+
+		log = Open(logPath, "wb");
+		if (!log) return false;
+		LogHeader header{};
+		memcpy(header.magic, C_MAGIC, sizeof(C_MAGIC));
+		header.version = C_VERSION;
+		header.sampleSize = static_cast<uint32_t>(sizeof(Sample));
+		header.tags = static_cast<uint32_t>(MemoryTracker::C_TAGS);
+		header.tickRate = static_cast<uint32_t>(tickRate);
+		header.interval = interval;
+		fwrite(&header, sizeof(header), 1, log);
+		fflush(log);
+		return true;
+	}
+
+	// Every tick, with the time it took.
+	void RecordTick(double ms) {
+		ticks.Record(ms);
+		++tickCount;
+	}
+
+	double Elapsed() const {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// True once the interval since the last sample is over.
+	bool Due() const {
+		return std::chrono::steady_clock::now() >= next;
+	}
+
+	// Ends the interval: samples the heap, `counts` and the interval's ticks, logs one line
+	// and appends the sample to the log.
+	void TakeSample(const Counts& counts) {
+		const MemoryTracker& memory = MemoryTracker::Instance();
+		Sample s{};
+		s.seconds = Elapsed();
+		s.ticks = tickCount;
+		for (int t = 0; t < MemoryTracker::C_TAGS; ++t) {
+			const MemoryTracker::Stats stats = memory.Get(static_cast<MemoryTracker::Tag>(t));
+			s.tagBytes[t] = stats.liveBytes;
+			s.liveBytes += stats.liveBytes;
+			s.liveBlocks += stats.liveBlocks;
+		}
+		const uint64_t allocations = memory.Allocations();
+		const uint64_t allocated = memory.AllocatedBytes();
+		s.allocations = allocations - allocationMark;
+		s.allocatedBytes = allocated - allocatedMark;
+		allocationMark = allocations;
+		allocatedMark = allocated;
+		s.asteroids = static_cast<uint32_t>(counts.asteroids);
+		s.parked = static_cast<uint32_t>(counts.parked);
+		s.projectiles = static_cast<uint32_t>(counts.projectiles);
+		s.ships = static_cast<uint32_t>(counts.ships);
+		s.score = counts.score;
+		s.tickP50 = static_cast<float>(ticks.PercentileMs(0.50));
+		s.tickP99 = static_cast<float>(ticks.PercentileMs(0.99));
+		s.tickMax = static_cast<float>(ticks.MaxMs());
+		ticks.Reset();
+		samples.push_back(s);
+
+		TraceLog(LOG_INFO, "SOAK: %8.0f s, %10llu ticks, %8.2f MB in %7llu blocks, %6llu allocations, %5u asteroids (%u parked), "
+			"%6u projectiles, %4u ships, tick p50 %.3f ms p99 %.3f ms", s.seconds, static_cast<unsigned long long>(s.ticks),
+			static_cast<double>(s.liveBytes) / (1024.0 * 1024.0), static_cast<unsigned long long>(s.liveBlocks),
+			static_cast<unsigned long long>(s.allocations), s.asteroids, s.parked, s.projectiles, s.ships,
+			static_cast<double>(s.tickP50), static_cast<double>(s.tickP99));
+		if (log) {
+			fwrite(&s, sizeof(s), 1, log);
+			fflush(log);
+		}
+		const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(interval));
+		const auto now = std::chrono::steady_clock::now();
+		while (next <= now) next += step;
+	}
+
+	const std::vector<Sample>& Samples() const {
+		return samples;
+	}
+
+	// Logs every series that grew or drifted over the run by more than `tolerance` (a
+	// fraction) and returns how many did. Runs of fewer than C_MIN_SAMPLES samples after
+	// the warm-up are too short to tell and flag nothing.
+	int Analyze(double tolerance) const {
+		const size_t warmup = samples.size() / C_WARMUP_FRACTION;
+		const size_t n = samples.size() - warmup;
+		if (n < C_MIN_SAMPLES) {
+			TraceLog(LOG_WARNING, "SOAK: %zu samples after the warm-up, too few to judge growth (%zu needed)", n, C_MIN_SAMPLES);
+			return 0;
+		}
+		const size_t quarter = n / 4;
+		const Window early{ warmup, warmup + quarter };
+		const Window late{ samples.size() - quarter, samples.size() };
+
+		int flagged = 0;
+		auto growth = [&](const char* name, double slack, auto value, auto driver) {
+			const Range e = RangeOf(early, value), l = RangeOf(late, value);
+			if (!(l.min > e.max && l.mean - e.mean > slack && l.mean > e.mean * (1.0 + tolerance))) return;
+			const Range de = RangeOf(early, driver), dl = RangeOf(late, driver);
+			if (de.mean > 0.0 && l.mean / e.mean <= dl.mean / de.mean * (1.0 + tolerance)) return;  // grew with its entities
+			TraceLog(LOG_WARNING, "SOAK: %s grew from %.1f to %.1f (%+.0f%%), and every late sample is above every early one",
+				name, e.mean, l.mean, (l.mean / (e.mean > 0.0 ? e.mean : 1.0) - 1.0) * 100.0);
+			++flagged;
+		};
+		auto drift = [&](const char* name, double slack, auto value) {
+			const Range e = RangeOf(early, value), l = RangeOf(late, value);
+			if (!(l.mean - e.mean > slack && l.mean > e.mean * (1.0 + tolerance))) return;
+			TraceLog(LOG_WARNING, "SOAK: %s drifted from %.3f ms to %.3f ms (%+.0f%%)", name, e.mean, l.mean,
+				(l.mean / (e.mean > 0.0 ? e.mean : 1.0) - 1.0) * 100.0);
+			++flagged;
+		};
+		auto none = [](const Sample&) { return 0.0; };
+
+		growth("live bytes", C_BYTES_FLOOR, [](const Sample& s) { return static_cast<double>(s.liveBytes); }, none);
+		growth("live blocks", C_COUNT_FLOOR, [](const Sample& s) { return static_cast<double>(s.liveBlocks); }, none);
+		growth("allocations per interval", C_COUNT_FLOOR, [](const Sample& s) { return static_cast<double>(s.allocations); }, none);
+		growth("asteroids", C_COUNT_FLOOR, [](const Sample& s) { return static_cast<double>(s.asteroids) + s.parked; }, none);
+		growth("projectiles", C_COUNT_FLOOR, [](const Sample& s) { return static_cast<double>(s.projectiles); }, none);
+		growth("ships", C_COUNT_FLOOR, [](const Sample& s) { return static_cast<double>(s.ships); }, none);
+		for (int t = 0; t < MemoryTracker::C_TAGS; ++t) {
+			char name[48];
+			snprintf(name, sizeof(name), "%s bytes", MemoryTracker::NameOf(static_cast<MemoryTracker::Tag>(t)));
+			auto bytes = [t](const Sample& s) { return static_cast<double>(s.tagBytes[t]); };
+			switch (static_cast<MemoryTracker::Tag>(t)) {
+			case MemoryTracker::Tag::ASTEROIDS: growth(name, C_BYTES_FLOOR, bytes, [](const Sample& s) { return static_cast<double>(s.asteroids); }); break;
+			case MemoryTracker::Tag::SECTORS: growth(name, C_BYTES_FLOOR, bytes, [](const Sample& s) { return static_cast<double>(s.parked); }); break;
+			case MemoryTracker::Tag::PROJECTILES: growth(name, C_BYTES_FLOOR, bytes, [](const Sample& s) { return static_cast<double>(s.projectiles); }); break;
+			case MemoryTracker::Tag::SHIPS: growth(name, C_BYTES_FLOOR, bytes, [](const Sample& s) { return static_cast<double>(s.ships); }); break;
+			default: growth(name, C_BYTES_FLOOR, bytes, none); break;
+			}
+		}
+		drift("tick p50", C_LATENCY_FLOOR_MS, [](const Sample& s) { return static_cast<double>(s.tickP50); });
+		drift("tick p99", C_LATENCY_FLOOR_MS, [](const Sample& s) { return static_cast<double>(s.tickP99); });
+
+		TraceLog(flagged ? LOG_WARNING : LOG_INFO, "SOAK: %zu samples over %.0f s, %d series grew or drifted past %.0f%%",
+			samples.size(), samples.back().seconds, flagged, tolerance * 100.0);
+		return flagged;
+	}
+
+private:
+	static constexpr size_t C_WARMUP_FRACTION = 10;  // the first tenth fills the field and the containers
+	static constexpr size_t C_MIN_SAMPLES = 8;
+	static constexpr double C_BYTES_FLOOR = 64.0 * 1024.0;  // growth below these is noise
+	static constexpr double C_COUNT_FLOOR = 8.0;
+	static constexpr double C_LATENCY_FLOOR_MS = 0.05;
+
+	struct Window {
+		size_t begin, end;
+	};
+
+	struct Range {
+		double min, max, mean;
+	};
+
+	template<typename Value>
+	Range RangeOf(Window w, Value value) const {
+		Range r{ value(samples[w.begin]), value(samples[w.begin]), 0.0 };
+		for (size_t i = w.begin; i < w.end; ++i) {
+			const double v = value(samples[i]);
+			if (v < r.min) r.min = v;
+			if (v > r.max) r.max = v;
+			r.mean += v;
+		}
+		r.mean /= static_cast<double>(w.end - w.begin);
+		return r;
+	}
+
+	static FILE* Open(const char* path, const char* mode) {
+		FILE* f = nullptr;
+#if defined(_MSC_VER)
+		if (fopen_s(&f, path, mode) != 0) f = nullptr;
+#else
+		f = fopen(path, mode);
+#endif
+		return f;
+	}
+
+	std::vector<Sample> samples;
+	LatencyHistogram    ticks;
+	uint64_t            tickCount = 0;
+	uint64_t            allocationMark = 0;
+	uint64_t            allocatedMark = 0;
+	double              interval = 10.0;
+	FILE*               log = nullptr;
+	std::chrono::steady_clock::time_point start{}, next{};
+};
+
+#endif // SOAK_MONITOR_H
@@ -0,0 +1,203 @@
+#ifndef SOUND_EFFECTS_H
+#define SOUND_EFFECTS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "raylib.h"
+
+// --- SOUND EFFECTS ---
+// Shot, hit and explosion sounds for any amount of fire. Each effect's samples are loaded
+// once and played through a fixed pool of LoadSoundAlias voices, so raudio's audio thread,
+// which mixes every playing voice, never has more than C_TOTAL_VOICES to mix however many
+// ships fire. The simulation thread (or any thread) only counts events with Trigger(), a few
+// atomic adds; once a frame Update() turns each effect's count into at most one new voice,
+// no sooner than the effect's minimum gap after the last, louder the more events it stands
+// for and panned to their average position. An effect with all its voices busy steals the
+// one that started longest ago. The samples are synthesised at Init(), so nothing is read
+// from disk; without an audio device everything is a no-op.
+class SoundEffects {
+public:
+	enum class Effect { SHOT, HIT, EXPLOSION, COUNT };
+
+	static constexpr int   C_SAMPLE_RATE = 22050;
+	static constexpr int   C_MAX_VOICES = 4;  // per effect
+	static constexpr int   C_EFFECTS = static_cast<int>(Effect::COUNT);
+	static constexpr int   C_TOTAL_VOICES = C_EFFECTS * C_MAX_VOICES;
+	static constexpr float C_PITCH_SPREAD = 0.06f;  // random pitch, +-, so repeats don't drone
+
+	static SoundEffects& Instance() {
+		static SoundEffects instance;
+		return instance;
+	}
+
+	// Opens the audio device and builds the voices. Before the simulation thread starts.
+	void Init() {
+		InitAudioDevice();
+		if (!IsAudioDeviceReady()) {
+			TraceLog(LOG_WARNING, "SFX: no audio device, effects are silent");
+			return;
+		}
+		for (int e = 0; e < C_EFFECTS; ++e) {
+			const Settings& settings = C_SETTINGS[e];
+			Wave wave = Synthesize(static_cast<Effect>(e), settings.seconds);
+			source[e] = LoadSoundFromWave(wave);
+			UnloadWave(wave);
+			for (int v = 0; v < settings.voices; ++v) voices[e][v] = LoadSoundAlias(source[e]);
+		}
+		ready = true;
+		TraceLog(LOG_INFO, "SFX: %i effects, %i voices", C_EFFECTS, VoiceCount());
+	}
+
+	// After the simulation thread has stopped.
+	void Unload() {
+		if (ready) {
+			for (int e = 0; e < C_EFFECTS; ++e) {
+				for (int v = 0; v < C_SETTINGS[e].voices; ++v) {
+					StopSound(voices[e][v]);
+					UnloadSoundAlias(voices[e][v]);
+				}
+				UnloadSound(source[e]);
+			}
+			ready = false;
+		}
+		if (IsAudioDeviceReady()) CloseAudioDevice();
+	}
+
+	// Counts `count` occurrences of `effect` around stereo position `pan`, as SetSoundPan
+	// takes it: 1 left, 0.5 centre, 0 right. Any thread.
+	void Trigger(Effect effect, uint32_t count = 1, float pan = 0.5f) {
+		if (!ready || count == 0) return;
+		Pending& p = pending[static_cast<int>(effect)];
+		p.count.fetch_add(count, std::memory_order_relaxed);
+		p.pan.fetch_add(static_cast<uint64_t>(std::clamp(pan, 0.f, 1.f) * C_PAN_SCALE) * count, std::memory_order_relaxed);
+	}
+
+	// Plays what was triggered since the last call. Main thread, once a frame.
+	void Update() {
+		if (!ready) return;
+		const double now = GetTime();
+		for (int e = 0; e < C_EFFECTS; ++e) {
+			const Settings& settings = C_SETTINGS[e];
+			if (now - lastStart[e] < settings.gap) continue;  // counts keep until the gap is over
+			Pending& p = pending[e];
+			const uint32_t count = p.count.exchange(0, std::memory_order_relaxed);
+			const uint64_t panSum = p.pan.exchange(0, std::memory_order_relaxed);
+			if (count == 0) continue;
+
+			Sound& voice = voices[e][PickVoice(e, now)];
+			const float crowd = 1.f + 0.25f * log2f(static_cast<float>(count));
+			SetSoundVolume(voice, std::min(settings.volume * crowd, 1.f));
+			SetSoundPan(voice, std::min(static_cast<float>(panSum / count) / C_PAN_SCALE, 1.f));
+			SetSoundPitch(voice, 1.f + C_PITCH_SPREAD * (2.f * Random(seed) - 1.f));
+			PlaySound(voice);  // restarts a stolen voice from the top
+			lastStart[e] = now;
+			++started;
+		}
+	}
+
+	int VoiceCount() const {
+		int n = 0;
+		for (const Settings& s : C_SETTINGS) n += s.voices;
+		return n;
+	}
+
+	// Voices started since Init().
+	uint64_t Started() const {
+		return started;
+	}
+
+private:
+	struct Settings {
+		int   voices;   // at most C_MAX_VOICES
+		float gap;      // seconds between two starts of the effect
+		float volume;   // for a single event
+		float seconds;  // of samples
+	};
+	static constexpr Settings C_SETTINGS[C_EFFECTS] = {
+		{ 4, 0.045f, 0.30f, 0.12f },  // SHOT: about the 22 shots/s of the fastest weapon
+		{ 4, 0.030f, 0.45f, 0.18f },  // HIT
+		{ 3, 0.080f, 0.70f, 0.90f },  // EXPLOSION
+	};
+	static constexpr float C_PAN_SCALE = 1024.f;
+
+	struct Pending {
+		std::atomic<uint32_t> count{0};
+		std::atomic<uint64_t> pan{0};  // sum of the events' pans, in 1/C_PAN_SCALE
+	};
+
+	// A free voice, else the one that started longest ago.
+	int PickVoice(int e, double now) {
+		int oldest = 0;
+		for (int v = 0; v < C_SETTINGS[e].voices; ++v) {
+			if (!IsSoundPlaying(voices[e][v])) {
+				oldest = v;
+				break;
+			}
+			if (voiceStart[e][v] < voiceStart[e][oldest]) oldest = v;
+		}
+		voiceStart[e][oldest] = now;
+		return oldest;
+	}
+
+	// xorshift32 in [0, 1): the samples' noise and the pitch spread.
+	static float Random(uint32_t& state) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return static_cast<float>(state >> 8) / 16777216.f;
+	}
+
+	// Mono 16-bit samples for `effect`, `seconds` long.
+	static Wave Synthesize(Effect effect, float seconds) {
+		const int frames = static_cast<int>(seconds * static_cast<float>(C_SAMPLE_RATE));
+		short* samples = static_cast<short*>(MemAlloc(static_cast<unsigned int>(frames) * sizeof(short)));
+		uint32_t noise = 0x9E3779B9u;
+		float phase = 0.f, low = 0.f;
+		const float dt = 1.f / static_cast<float>(C_SAMPLE_RATE);
+		for (int i = 0; i < frames; ++i) {
+			const float t = static_cast<float>(i) * dt;
+			const float u = t / seconds;
+			const float white = 2.f * Random(noise) - 1.f;
+			float s = 0.f;
+			switch (effect) {
+			case Effect::SHOT: {
+				// A square wave sweeping down, the classic laser.
+				phase += (1400.f - 900.f * u) * dt;
+				s = (phase - floorf(phase) < 0.5f ? 0.5f : -0.5f) * expf(-6.f * u);
+				break;
+			}
+			case Effect::HIT: {
+				// A noise crack over a falling thump.
+				phase += (320.f - 200.f * u) * dt;
+				s = (0.6f * white * expf(-30.f * u) + 0.7f * sinf(2.f * PI * phase)) * expf(-5.f * u);
+				break;
+			}
+			case Effect::EXPLOSION: {
+				// Low-passed noise with a slow tail; the cutoff falls as it dies away.
+				const float k = 0.25f * (1.f - u) + 0.02f;
+				low += k * (white - low);
+				s = 1.6f * low * expf(-4.f * u) * std::min(t * 200.f, 1.f);
+				break;
+			}
+			default: break;
+			}
+			samples[i] = static_cast<short>(std::clamp(s, -1.f, 1.f) * 32767.f);
+		}
+		return Wave{ static_cast<unsigned int>(frames), C_SAMPLE_RATE, 16, 1, samples };
+	}
+
+	bool     ready = false;
+	Sound    source[C_EFFECTS] = {};
+	Sound    voices[C_EFFECTS][C_MAX_VOICES] = {};
+	double   voiceStart[C_EFFECTS][C_MAX_VOICES] = {};
+	double   lastStart[C_EFFECTS] = { -1.0, -1.0, -1.0 };  // GetTime() starts at 0
+	Pending  pending[C_EFFECTS];
+	uint32_t seed = 0x2545F491u;
+	uint64_t started = 0;
+};
+
+#endif // SOUND_EFFECTS_H
@@ -0,0 +1,102 @@
+#ifndef SPATIAL_ORDER_H
+#define SPATIAL_ORDER_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// --- SPATIAL ORDER ---
+// Renumbers entities so that ones near each other in space are near each other in memory.
+// Left alone, the fields keep asteroids and projectiles in the order they were spawned and
+// fired, and a grid cell's run of indices lands all over the columns. Sorter orders them
+// by the Z-order (Morton) code of their position, which follows space in nested squares,
+// with a stable LSD radix sort; Permute then moves a column into that order. Equal codes
+// keep their old order, so the same field always comes out the same (lockstep).
+namespace SpatialOrder {
+	// Interleaves the low 16 bits of x (even bits) and y (odd bits).
+	inline uint32_t Morton(uint32_t x, uint32_t y) {
+		auto spread = [](uint32_t v) {
+			v &= 0xffffu;
+			v = (v | (v << 8)) & 0x00ff00ffu;
+			v = (v | (v << 4)) & 0x0f0f0f0fu;
+			v = (v | (v << 2)) & 0x33333333u;
+			return (v | (v << 1)) & 0x55555555u;
+		};
+		return spread(x) | (spread(y) << 1);
+	}
+
+	// Keeps its buffers between sorts, so renumbering a field of a size seen before doesn't
+	// allocate.
+	class Sorter {
+	public:
+		// Sorts [0, n) by the Morton code of (x[i], y[i]) on a 65536 x 65536 grid over
+		// [0, width) x [0, height); points outside are clamped to its edge. Order()[k] is then
+		// the index that goes k-th.
+		void Sort(const float* x, const float* y, size_t n, float width, float height) {
+			keys.resize(n);
+			order.resize(n);
+			const float sx = C_CELLS / (width > 0.f ? width : 1.f);
+			const float sy = C_CELLS / (height > 0.f ? height : 1.f);
+			for (size_t i = 0; i < n; ++i) {
+				keys[i] = Morton(Quantize(x[i] * sx), Quantize(y[i] * sy));
+				order[i] = static_cast<uint32_t>(i);
+			}
+			RadixSort();
+		}
+
+		const std::vector<uint32_t>& Order() const {
+			return order;
+		}
+
+	private:
+		static constexpr float C_CELLS = 65536.f;
+
+		static uint32_t Quantize(float v) {
+			if (!(v > 0.f)) return 0;
+			return v < C_CELLS - 1.f ? static_cast<uint32_t>(v) : 0xffffu;
+		}
+
+		// 8 bits a pass; a pass every key agrees on is skipped.
+		void RadixSort() {
+			const size_t n = keys.size();
+			if (n < 2) return;
+			keyScratch.resize(n);
+			orderScratch.resize(n);
+			for (int shift = 0; shift < 32; shift += 8) {
+				size_t counts[256] = {};
+				for (uint32_t key : keys) ++counts[(key >> shift) & 0xFF];
+				if (counts[(keys[0] >> shift) & 0xFF] == n) continue;
+				size_t offset = 0;
+				for (size_t& c : counts) {
+					const size_t bucket = c;
+					c = offset;
+					offset += bucket;
+				}
+				for (size_t i = 0; i < n; ++i) {
+					const size_t to = counts[(keys[i] >> shift) & 0xFF]++;
+					keyScratch[to] = keys[i];
+					orderScratch[to] = order[i];
+				}
+				keys.swap(keyScratch);
+				order.swap(orderScratch);
+			}
+		}
+
+		std::vector<uint32_t> keys, keyScratch;
+		std::vector<uint32_t> order, orderScratch;
+	};
+
+	// column[k] = old column[order[k]] for k in [0, n), through `scratch`, which is sized to
+	// fit and kept for the next column.
+	template<typename T>
+	void Permute(T* column, const uint32_t* order, size_t n, std::vector<unsigned char>& scratch) {
+		static_assert(std::is_trivially_copyable_v<T>, "columns are moved as raw bytes");
+		if (scratch.size() < n * sizeof(T)) scratch.resize(n * sizeof(T));
+		unsigned char* to = scratch.data();
+		for (size_t k = 0; k < n; ++k) memcpy(to + k * sizeof(T), column + order[k], sizeof(T));
+		if (n) memcpy(column, to, n * sizeof(T));
+	}
+}
+
+#endif // SPATIAL_ORDER_H
@@ -0,0 +1,126 @@
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+#include "raylib.h"
+
+// --- STARTUP PROFILE ---
+// Time to first frame, phase by phase. Every init step from main() to the first presented
+// frame runs inside a STARTUP_SCOPE, which logs when it began and ended, in ms since the
+// process started (as close to it as static initialisation gets), and on which thread, so
+// the steps that overlap (decoding on the loader's workers while the window and GL context
+// are made) show as overlapping. FirstFrame() closes the profile; Write() saves it for
+// tracking time to first frame across builds (`--startup-report`). Any thread.
+class StartupProfile {
+public:
+	struct Phase {
+		const char* name;
+		double      beginMs;
+		double      endMs;
+		bool        mainThread;
+	};
+
+	static constexpr int C_MAX_PHASES = 32;
+
+	static StartupProfile& Instance() {
+		static StartupProfile instance;
+		return instance;
+	}
+
+	double NowMs() const {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - C_START).count();
+	}
+
+	// Phases after FirstFrame() aren't startup and aren't kept.
+	void Record(const char* name, double beginMs, double endMs) {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (done || count >= C_MAX_PHASES) return;
+		const bool onMain = std::this_thread::get_id() == mainThread;
+		phases[count++] = { name, beginMs, endMs, onMain };
+		TraceLog(LOG_INFO, "STARTUP: %-16s %8.1f -> %8.1f ms (%7.1f ms)%s", name, beginMs, endMs, endMs - beginMs, onMain ? "" : " [worker]");
+	}
+
+	// After the first frame is presented. Only the first call counts.
+	void FirstFrame() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if (done) return;
+		done = true;
+		firstFrameMs = NowMs();
+		double serial = 0.0;
+		for (int i = 0; i < count; ++i) serial += phases[i].endMs - phases[i].beginMs;
+		TraceLog(LOG_INFO, "STARTUP: first frame at %.1f ms, %.1f ms of init work in %d phases", firstFrameMs, serial, count);
+	}
+
+	// 0 until FirstFrame().
+	double FirstFrameMs() const {
+		return firstFrameMs;
+	}
+
+	// Returns false if the file can't be written.
+	bool Write(const char* path) const {
+		FILE* f = Open(path, "wb");
+		if (!f) return false;
+		std::lock_guard<std::mutex> lock(mutex);
+		fprintf(f, "{\n  \"first_frame_ms\": %.3f,\n  \"phases\": [\n", firstFrameMs);
+		for (int i = 0; i < count; ++i) {
+			const Phase& p = phases[i];
+			fprintf(f, "    { \"name\": \"%s\", \"thread\": \"%s\", \"begin\": %.3f, \"end\": %.3f }%s\n", p.name,
+				p.mainThread ? "main" : "worker", p.beginMs, p.endMs, i + 1 < count ? "," : "");
+		}
+		fputs("  ]\n}\n", f);
+		fclose(f);
+		return true;
+	}
+
+private:
+	// Taken during static initialisation, before main().
+	static inline const std::chrono::steady_clock::time_point C_START = std::chrono::steady_clock::now();
+
+	// The first call is from main(), whose thread becomes the main one.
+	StartupProfile() : mainThread(std::this_thread::get_id()) {}
+
+	static FILE* Open(const char* path, const char* mode) {
+		FILE* f = nullptr;
+#if defined(_MSC_VER)
+		if (fopen_s(&f, path, mode) != 0) f = nullptr;
+#else
+		f = fopen(path, mode);
+#endif
+		return f;
+	}
+
+	mutable std::mutex mutex;
+	std::thread::id    mainThread;
+	Phase              phases[C_MAX_PHASES]{};
+	int                count = 0;
+	bool               done = false;
+	double             firstFrameMs = 0.0;
+};
+
+// Records the enclosing block as a startup phase. `name` must outlive the profile (a
+// string literal).
+class StartupScope {
+public:
+	explicit StartupScope(const char* name_) : name(name_), beginMs(StartupProfile::Instance().NowMs()) {}
+	~StartupScope() {
+		StartupProfile& profile = StartupProfile::Instance();
+		profile.Record(name, beginMs, profile.NowMs());
+	}
+
+	StartupScope(const StartupScope&) = delete;
+	StartupScope& operator=(const StartupScope&) = delete;
+
+private:
+	const char* name;
+	double      beginMs;
+};
+
+#define STARTUP_CONCAT_(a, b) a##b
+#define STARTUP_CONCAT(a, b) STARTUP_CONCAT_(a, b)
+#define STARTUP_SCOPE(name) StartupScope STARTUP_CONCAT(startupScope_, __LINE__)(name)
+
+#endif // STARTUP_PROFILE_H
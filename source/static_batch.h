@@ -0,0 +1,148 @@
+#ifndef STATIC_BATCH_H
+#define STATIC_BATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "external/glad.h"  // a retained vertex array of our own, which rlgl only offers per mesh
+
+// --- STATIC BATCH ---
+// Immediate-mode drawing recorded once and replayed from a retained vertex array, for
+// geometry that never changes (DrawGrid and the like): the CPU stops rebuilding its
+// vertices every frame, and each replay is one draw call per texture run.
+//
+// Capture() points rlgl at a batch of its own, big enough for `maxVertices`, runs `draw`
+// and copies out what it emitted: positions (with the transform current at the time
+// baked in), texture coordinates, colours and the texture of each run, quads turned into
+// triangles. The captured drawing is also drawn, that once, as usual. `maxVertices` must
+// hold it all: past that rlgl flushes mid-capture, silently, and the start is lost.
+// Draw() replays with rlgl's default shader under the current transform, view and
+// projection, as the batch would have drawn it.
+class StaticBatch {
+public:
+	// False if `draw` emitted nothing.
+	template<typename Draw>
+	bool Capture(int maxVertices, Draw&& draw) {
+		Unload();
+		rlDrawRenderBatchActive();  // loading a batch resets rlgl's vertex count
+		rlRenderBatch batch = rlLoadRenderBatch(1, maxVertices / 4 + 1);
+		rlSetRenderBatchActive(&batch);
+		draw();
+
+		std::vector<Vertex> vertices;
+		const rlVertexBuffer& buffer = batch.vertexBuffer[0];
+		int offset = 0;
+		for (int d = 0; d < batch.drawCounter; ++d) {
+			const rlDrawCall& call = batch.draws[d];
+			if (call.vertexCount > 0) {
+				Run run{ static_cast<GLenum>((call.mode == RL_LINES) ? GL_LINES : GL_TRIANGLES), static_cast<int>(vertices.size()), 0, call.textureId };
+				if (call.mode == RL_QUADS) {
+					for (int q = 0; q + 3 < call.vertexCount; q += 4) {
+						for (int corner : { 0, 1, 2, 0, 2, 3 }) vertices.push_back(VertexAt(buffer, offset + q + corner));
+					}
+				}
+				else {
+					for (int v = 0; v < call.vertexCount; ++v) vertices.push_back(VertexAt(buffer, offset + v));
+				}
+				run.count = static_cast<int>(vertices.size()) - run.first;
+				runs.push_back(run);
+			}
+			offset += call.vertexCount + call.vertexAlignment;
+		}
+		rlSetRenderBatchActive(nullptr);  // draws the capture this once
+		rlUnloadRenderBatch(batch);
+		if (vertices.empty()) {
+			runs.clear();
+			return false;
+		}
+
+		const int* locs = rlGetShaderLocsDefault();
+		glGenVertexArrays(1, &vao);
+		glBindVertexArray(vao);
+		glGenBuffers(1, &vbo);
+		glBindBuffer(GL_ARRAY_BUFFER, vbo);
+		glBufferData(GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(vertices.size() * sizeof(Vertex)), vertices.data(), GL_STATIC_DRAW);
+		glVertexAttribPointer(locs[SHADER_LOC_VERTEX_POSITION], 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>(offsetof(Vertex, position)));
+		glVertexAttribPointer(locs[SHADER_LOC_VERTEX_TEXCOORD01], 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<const void*>(offsetof(Vertex, texcoord)));
+		glVertexAttribPointer(locs[SHADER_LOC_VERTEX_COLOR], 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), reinterpret_cast<const void*>(offsetof(Vertex, color)));
+		for (int attribute : { locs[SHADER_LOC_VERTEX_POSITION], locs[SHADER_LOC_VERTEX_TEXCOORD01], locs[SHADER_LOC_VERTEX_COLOR] }) glEnableVertexAttribArray(static_cast<GLuint>(attribute));
+		glBindVertexArray(0);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		vertexCount = static_cast<int>(vertices.size());
+		return true;
+	}
+
+	bool Captured() const {
+		return vao != 0;
+	}
+
+	void Draw() const {
+		if (vao == 0) return;
+		rlDrawRenderBatchActive();
+		const unsigned int shader = rlGetShaderIdDefault();
+		const int* locs = rlGetShaderLocsDefault();
+		rlEnableShader(shader);
+		rlSetUniformMatrix(locs[SHADER_LOC_MATRIX_MVP], MatrixMultiply(MatrixMultiply(rlGetMatrixTransform(), rlGetMatrixModelview()), rlGetMatrixProjection()));
+		const Vector4 white = { 1.0f, 1.0f, 1.0f, 1.0f };
+		rlSetUniform(locs[SHADER_LOC_COLOR_DIFFUSE], &white, SHADER_UNIFORM_VEC4, 1);
+		const int unit = 0;
+		rlSetUniform(locs[SHADER_LOC_MAP_DIFFUSE], &unit, SHADER_UNIFORM_INT, 1);
+		glBindVertexArray(vao);
+		rlActiveTextureSlot(0);
+		for (const Run& run : runs) {
+			rlEnableTexture(run.texture);
+			glDrawArrays(run.mode, run.first, run.count);
+		}
+		rlDisableTexture();
+		glBindVertexArray(0);
+		rlDisableShader();
+	}
+
+	void Unload() {
+		if (vao != 0) glDeleteVertexArrays(1, &vao);
+		if (vbo != 0) glDeleteBuffers(1, &vbo);
+		vao = vbo = 0;
+		vertexCount = 0;
+		runs.clear();
+	}
+
+	int Vertices() const {
+		return vertexCount;
+	}
+
+	// Draw calls per replay.
+	int Runs() const {
+		return static_cast<int>(runs.size());
+	}
+
+private:
+	struct Vertex {
+		Vector3 position;
+		Vector2 texcoord;
+		Color   color;
+	};
+
+	struct Run {
+		GLenum       mode;
+		int          first;
+		int          count;
+		unsigned int texture;
+	};
+
+	static Vertex VertexAt(const rlVertexBuffer& buffer, int i) {
+		const float* p = &buffer.vertices[i * 3];
+		const float* t = &buffer.texcoords[i * 2];
+		const unsigned char* c = &buffer.colors[i * 4];
+		return { { p[0], p[1], p[2] }, { t[0], t[1] }, { c[0], c[1], c[2], c[3] } };
+	}
+
+	std::vector<Run> runs;
+	unsigned int     vao = 0;
+	unsigned int     vbo = 0;
+	int              vertexCount = 0;
+};
+
+#endif // STATIC_BATCH_H
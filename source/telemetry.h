@@ -0,0 +1,191 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "raylib.h"
+
+#include "profiler.h"
+
+// --- TELEMETRY ---
+// A live feed of the session for an external dashboard, as UDP datagrams to a port on
+// localhost (`--telemetry [port]`): a TickRecord per World::Step (its time, the entity
+// counts after it, the allocations made during it) and a FrameRecord per rendered frame
+// (the profiler's phase totals, GPU time, rlgl's batch flushes and draw calls). Publishing
+// appends the record to its Channel's packet, which is sent once it holds C_RECORDS, so
+// the hot path is a copy and, every C_RECORDS ticks, one non-blocking send: under 0.1 us a
+// tick amortised, where a tick at the game's counts takes hundreds. Nothing waits on the
+// reader: a datagram the system can't take now, or that nobody is listening for, is
+// dropped and counted, and the next packet carries the count. The system only reports a
+// refusal (nothing bound to the port) on the send after the refused one, so that is when
+// it is counted, moving the earlier datagram from sent to dropped; the session's last
+// datagram stays counted as sent whatever became of it. While the stream is closed
+// publishing is one relaxed load.
+//
+// Wire format, little-endian as the structs lie in memory: a PacketHeader, then `count`
+// records of its `kind`. `sequence` counts a channel's packets, so a gap is a lost one;
+// C_VERSION changes with any record's layout.
+namespace Telemetry {
+	constexpr uint16_t C_DEFAULT_PORT = 47800;
+	constexpr uint16_t C_VERSION = 1;
+	inline constexpr char C_MAGIC[4] = { 'P', 'T', 'E', 'L' };
+
+	enum class Kind : uint8_t { TICK = 1, FRAME = 2 };
+
+	struct PacketHeader {
+		char     magic[4];
+		uint16_t version;
+		uint8_t  kind;     // Kind
+		uint8_t  count;    // records that follow
+		uint32_t sequence;
+		uint32_t dropped;  // datagrams the stream has failed to send so far
+	};
+
+	struct TickRecord {
+		uint64_t step;          // World::Step calls so far; one may be several ticks
+		uint64_t liveBytes;     // heap, after the step
+		float    ms;
+		uint32_t ticks;
+		uint32_t asteroids;
+		uint32_t projectiles;
+		uint32_t ships;
+		uint32_t sectors;       // asteroids parked in sectors, 0 unless streaming
+		uint32_t allocations;   // during the step, on every thread
+		uint32_t allocatedKb;
+		int32_t  score;
+		uint32_t reserved;
+	};
+
+	struct FrameRecord {
+		uint64_t frame;
+		float    phaseMs[Profiler::C_PHASES];  // Profiler::Phase order; FRAME is the whole frame
+		float    gpuMs;
+		uint32_t ticks;
+		uint32_t batchFlushes;
+		uint32_t batchVertices;
+		uint32_t drawCalls;
+		uint32_t shaderSwitches;
+		uint32_t uploadKb;
+	};
+
+	// The platform's sockets, in telemetry_socket.cpp: winsock2.h and raylib.h can't share a
+	// translation unit (CloseWindow, Rectangle, DrawText, ...). OpenSocket returns -1 when
+	// it fails; Send is false when the datagram wasn't taken, never blocking for it, and sets
+	// `refusedEarlier` when the system reported that the previous one was refused.
+	intptr_t OpenSocket(uint16_t port);
+	bool     Send(intptr_t socket, const void* data, size_t bytes, bool& refusedEarlier);
+	void     CloseSocket(intptr_t socket);
+
+	// The socket, shared by every channel. Open and Close from the main thread while no one
+	// publishes; Send from any.
+	class Stream {
+	public:
+		static Stream& Instance() {
+			static Stream instance;
+			return instance;
+		}
+
+		Stream(const Stream&) = delete;
+		Stream& operator=(const Stream&) = delete;
+
+		bool Open(uint16_t port_) {
+			Close();
+			socket = OpenSocket(port_);
+			if (socket < 0) {
+				TraceLog(LOG_WARNING, "TELEMETRY: could not open a socket for 127.0.0.1:%u", static_cast<unsigned>(port_));
+				return false;
+			}
+			open.store(true, std::memory_order_release);
+			TraceLog(LOG_INFO, "TELEMETRY: streaming to udp 127.0.0.1:%u", static_cast<unsigned>(port_));
+			return true;
+		}
+
+		void Close() {
+			if (!open.exchange(false, std::memory_order_acq_rel)) return;
+			CloseSocket(socket);
+			socket = -1;
+			TraceLog(LOG_INFO, "TELEMETRY: closed, %llu packets sent, %u dropped", static_cast<unsigned long long>(sent.load()), dropped.load());
+		}
+
+		static bool IsOpen() {
+			return Instance().open.load(std::memory_order_relaxed);
+		}
+
+		uint32_t Dropped() const {
+			return dropped.load(std::memory_order_relaxed);
+		}
+
+		void Send(const void* data, size_t bytes) {
+			bool refusedEarlier = false;
+			const bool taken = Telemetry::Send(socket, data, bytes, refusedEarlier);
+			if (refusedEarlier && sent.load(std::memory_order_relaxed) > 0) {
+				sent.fetch_sub(1, std::memory_order_relaxed);
+				dropped.fetch_add(1, std::memory_order_relaxed);
+			}
+			if (taken) sent.fetch_add(1, std::memory_order_relaxed);
+			else dropped.fetch_add(1, std::memory_order_relaxed);
+		}
+
+	private:
+		Stream() = default;
+		~Stream() {
+			Close();
+		}
+
+		std::atomic<bool>     open{ false };
+		std::atomic<uint64_t> sent{ 0 };
+		std::atomic<uint32_t> dropped{ 0 };
+		intptr_t              socket = -1;
+	};
+
+	// One thread's records of one kind, batched into a packet. Each publishing thread has
+	// its own channel, so nothing here locks.
+	template<typename Record, Kind K, int C_RECORDS>
+	class Channel {
+	public:
+		static_assert(C_RECORDS > 0 && C_RECORDS <= 255, "count is a byte");
+
+		void Publish(const Record& record) {
+			packet.records[count++] = record;
+			if (count == C_RECORDS) Flush();
+		}
+
+		// Sends what is batched, say as the session ends.
+		void Flush() {
+			if (count == 0) return;
+			Stream& stream = Stream::Instance();
+			memcpy(packet.header.magic, C_MAGIC, sizeof(C_MAGIC));
+			packet.header.version = C_VERSION;
+			packet.header.kind = static_cast<uint8_t>(K);
+			packet.header.count = static_cast<uint8_t>(count);
+			packet.header.sequence = sequence++;
+			packet.header.dropped = stream.Dropped();
+			if (Stream::IsOpen()) stream.Send(&packet, sizeof(PacketHeader) + sizeof(Record) * static_cast<size_t>(count));
+			count = 0;
+		}
+
+	private:
+		struct Packet {
+			PacketHeader header;
+			Record       records[C_RECORDS];
+		};
+
+		Packet   packet{};
+		int      count = 0;
+		uint32_t sequence = 0;
+	};
+
+	// A tick packet is a fifth of a second at the default 120 Hz, a frame packet about a
+	// seventh at 60 fps; either fits one datagram that the network layer won't fragment.
+	using TickChannel = Channel<TickRecord, Kind::TICK, 24>;
+	using FrameChannel = Channel<FrameRecord, Kind::FRAME, 8>;
+
+	static_assert(sizeof(PacketHeader) == 16 && sizeof(TickRecord) == 56, "the wire format is these layouts");
+	static_assert(sizeof(PacketHeader) + sizeof(TickRecord) * 24 <= 1472 && sizeof(PacketHeader) + sizeof(FrameRecord) * 8 <= 1472,
+		"a packet is one unfragmented datagram");
+}
+
+#endif // TELEMETRY_H
@@ -0,0 +1,86 @@
+// The sockets behind Telemetry::Stream (telemetry.h), kept out of Main.cpp because the
+// platform headers and raylib's can't be included together. Only the standard library and
+// the OS here; no raylib.
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Telemetry {
+	// UDP, non-blocking, connected to 127.0.0.1:port so Send needs no address and an
+	// unread port costs nothing but the dropped datagram.
+	intptr_t OpenSocket(uint16_t port) {
+		sockaddr_in to{};
+		to.sin_family = AF_INET;
+		to.sin_port = htons(port);
+		to.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+#if defined(_WIN32)
+		WSADATA wsa;
+		if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return -1;
+		SOCKET s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		u_long nonBlocking = 1;
+		if (s == INVALID_SOCKET || ioctlsocket(s, FIONBIO, &nonBlocking) != 0
+			|| connect(s, reinterpret_cast<const sockaddr*>(&to), sizeof(to)) != 0) {
+			if (s != INVALID_SOCKET) closesocket(s);
+			WSACleanup();
+			return -1;
+		}
+		return static_cast<intptr_t>(s);
+#else
+		const int s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+		if (s < 0) return -1;
+		if (fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK) != 0 || connect(s, reinterpret_cast<const sockaddr*>(&to), sizeof(to)) != 0) {
+			close(s);
+			return -1;
+		}
+		return s;
+#endif
+	}
+
+	// A connected UDP socket reports a refused datagram (nothing listening) as the error of
+	// the next send, which then sends nothing. That error belongs to the earlier datagram,
+	// so it is passed up as such and this one is sent again; the retry finds it cleared.
+	bool Send(intptr_t socket, const void* data, size_t bytes, bool& refusedEarlier) {
+		refusedEarlier = false;
+		if (socket < 0) return false;
+#if defined(_WIN32)
+		const SOCKET s = static_cast<SOCKET>(socket);
+		int n = send(s, static_cast<const char*>(data), static_cast<int>(bytes), 0);
+		if (n == SOCKET_ERROR && WSAGetLastError() == WSAECONNRESET) {
+			refusedEarlier = true;
+			n = send(s, static_cast<const char*>(data), static_cast<int>(bytes), 0);
+		}
+		return n == static_cast<int>(bytes);
+#else
+		const int s = static_cast<int>(socket);
+		ssize_t n = send(s, data, bytes, MSG_DONTWAIT | MSG_NOSIGNAL);
+		if (n < 0 && errno == ECONNREFUSED) {
+			refusedEarlier = true;
+			n = send(s, data, bytes, MSG_DONTWAIT | MSG_NOSIGNAL);
+		}
+		return n == static_cast<ssize_t>(bytes);
+#endif
+	}
+
+	void CloseSocket(intptr_t socket) {
+		if (socket < 0) return;
+#if defined(_WIN32)
+		closesocket(static_cast<SOCKET>(socket));
+		WSACleanup();
+#else
+		close(static_cast<int>(socket));
+#endif
+	}
+}
@@ -0,0 +1,239 @@
+#ifndef TEMPORAL_UPSAMPLE_H
+#define TEMPORAL_UPSAMPLE_H
+
+#include <algorithm>
+#include <cstdint>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "shader_cache.h"
+#include "external/glad.h"  // sampled depth, filtered float targets and attribute-less draws, which rlgl doesn't wrap
+
+// --- TEMPORAL UPSAMPLING ---
+// The 3D scene rendered at Scale() of the window's resolution and accumulated over frames
+// into a full-resolution history, for close to native quality at a fraction of the shading:
+//   1. BeginScene()/EndScene(): the scene, drawn as usual, into the lower-left Scale() of a
+//      window-size target, its projection jittered by a sub-pixel Halton (2, 3) offset that
+//      cycles every C_JITTER_PHASES frames;
+//   2. Resolve(): per window pixel, the current frame reconstructed from the 3x3 render
+//      samples around it (Gaussian weights by distance to their jittered centres), and the
+//      history fetched where the surface was last frame. Motion comes from the depth and the
+//      last frame's camera matrices, taken at the nearest depth of the neighbourhood so
+//      edges move with the foreground; only camera motion is tracked. The history is clamped
+//      to the neighbourhood's colour range, which rejects what disocclusion and moving
+//      objects leave behind, and blended with the current frame at C_FEEDBACK;
+//   3. Present(): the history into the current framebuffer through a light sharpen
+//      (C_SHARPNESS) that gives back what the accumulation softens.
+// Reset() (a cut, a change of scale) drops the history for one frame.
+class TemporalUpsampler {
+public:
+	static constexpr float C_MIN_SCALE = 0.5f;
+	static constexpr float C_FEEDBACK = 0.9f;    // of the history kept each frame
+	static constexpr float C_SHARPNESS = 0.25f;
+	static constexpr int   C_JITTER_PHASES = 8;
+
+	void Init(int w, int h) {
+		width = w;
+		height = h;
+		sceneFbo = rlLoadFramebuffer(width, height);
+		color = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16, 1);
+		depth = rlLoadTextureDepth(width, height, false);
+		rlFramebufferAttach(sceneFbo, color, RL_ATTACHMENT_COLOR_CHANNEL0, RL_ATTACHMENT_TEXTURE2D, 0);
+		rlFramebufferAttach(sceneFbo, depth, RL_ATTACHMENT_DEPTH, RL_ATTACHMENT_TEXTURE2D, 0);
+		if (!rlFramebufferComplete(sceneFbo)) TraceLog(LOG_WARNING, "TEMPORAL: scene framebuffer is incomplete");
+
+		resolveFbo = rlLoadFramebuffer(width, height);
+		for (unsigned int& h : history) {
+			h = rlLoadTexture(nullptr, width, height, PIXELFORMAT_UNCOMPRESSED_R16G16B16A16, 1);
+			glBindTexture(GL_TEXTURE_2D, h);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);  // reprojected fetches land between texels
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		}
+		glBindTexture(GL_TEXTURE_2D, 0);
+		rlDisableFramebuffer();
+
+		resolve = ShaderCache::Load("../resources/shaders/glsl330/hiz_reduce.vs", "../resources/shaders/glsl330/temporal_resolve.fs");
+		sharpen = ShaderCache::Load("../resources/shaders/glsl330/hiz_reduce.vs", "../resources/shaders/glsl330/temporal_sharpen.fs");
+		renderSizeLoc = GetShaderLocation(resolve, "renderSize");
+		jitterLoc = GetShaderLocation(resolve, "jitter");
+		invViewProjLoc = GetShaderLocation(resolve, "invViewProj");
+		viewProjLoc = GetShaderLocation(resolve, "viewProj");
+		prevViewProjLoc = GetShaderLocation(resolve, "prevViewProj");
+		feedbackLoc = GetShaderLocation(resolve, "feedback");
+		sharpnessLoc = GetShaderLocation(sharpen, "sharpness");
+		const int units[3] = { C_COLOR_UNIT, C_DEPTH_UNIT, C_HISTORY_UNIT };
+		SetShaderValue(resolve, GetShaderLocation(resolve, "current"), &units[0], SHADER_UNIFORM_INT);
+		SetShaderValue(resolve, GetShaderLocation(resolve, "sceneDepth"), &units[1], SHADER_UNIFORM_INT);
+		SetShaderValue(resolve, GetShaderLocation(resolve, "history"), &units[2], SHADER_UNIFORM_INT);
+		SetShaderValue(sharpen, GetShaderLocation(sharpen, "resolved"), &units[0], SHADER_UNIFORM_INT);
+		glGenVertexArrays(1, &vao);
+		Reset();
+	}
+
+	void Unload() {
+		rlUnloadFramebuffer(sceneFbo);  // takes the depth texture with it
+		rlUnloadFramebuffer(resolveFbo);
+		for (unsigned int id : { color, history[0], history[1] }) rlUnloadTexture(id);
+		glDeleteVertexArrays(1, &vao);
+		UnloadShader(resolve);
+		UnloadShader(sharpen);
+		sceneFbo = resolveFbo = color = depth = history[0] = history[1] = vao = 0;
+	}
+
+	// Share of the window's width and height rendered, C_MIN_SCALE to 1; resets the history.
+	void SetScale(float s) {
+		scale = std::clamp(s, C_MIN_SCALE, 1.0f);
+		Reset();
+	}
+
+	float Scale() const {
+		return scale;
+	}
+
+	int RenderWidth() const {
+		return std::max(1, static_cast<int>(static_cast<float>(width) * scale + 0.5f));
+	}
+
+	int RenderHeight() const {
+		return std::max(1, static_cast<int>(static_cast<float>(height) * scale + 0.5f));
+	}
+
+	void Reset() {
+		fresh = true;
+	}
+
+	// The scene goes in between, inside the BeginMode3D this makes (don't nest another).
+	void BeginScene(const Camera3D& camera, Color background) {
+		rlDrawRenderBatchActive();
+		rlEnableFramebuffer(sceneFbo);
+		rlViewport(0, 0, RenderWidth(), RenderHeight());
+		ClearBackground(background);
+		BeginMode3D(camera);
+
+		// Halton (2, 3), in render pixels about the pixel centre.
+		++frame;
+		const int phase = static_cast<int>(frame % C_JITTER_PHASES) + 1;
+		jitter = { Halton(phase, 2) - 0.5f, Halton(phase, 3) - 0.5f };
+
+		const Matrix last = viewProj;
+		const Matrix view = rlGetMatrixModelview();
+		Matrix projection = rlGetMatrixProjection();
+		viewProj = MatrixMultiply(view, projection);
+		prevViewProj = fresh ? viewProj : last;
+		// A translation applied after the projection adds w times its offset to clip x and y,
+		// so after the divide every point moves by +jitter render pixels, the offset the
+		// resolve shader takes back out.
+		projection = MatrixMultiply(projection, MatrixTranslate(jitter.x * 2.0f / static_cast<float>(RenderWidth()),
+			jitter.y * 2.0f / static_cast<float>(RenderHeight()), 0.0f));
+		rlSetMatrixProjection(projection);
+		invViewProj = MatrixInvert(MatrixMultiply(view, projection));
+	}
+
+	void EndScene() {
+		EndMode3D();
+		rlDisableFramebuffer();
+		rlViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+	}
+
+	// Accumulates this frame into the history.
+	void Resolve() {
+		rlDrawRenderBatchActive();
+		const int write = static_cast<int>(frame & 1);
+		rlEnableFramebuffer(resolveFbo);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, history[write], 0);
+		glViewport(0, 0, width, height);
+		glUseProgram(resolve.id);
+		glBindVertexArray(vao);
+		rlDisableColorBlend();
+		rlDisableDepthTest();
+		const int renderSize[2] = { RenderWidth(), RenderHeight() };
+		glUniform2iv(renderSizeLoc, 1, renderSize);
+		glUniform2f(jitterLoc, jitter.x, jitter.y);
+		glUniformMatrix4fv(invViewProjLoc, 1, GL_FALSE, MatrixToFloatV(invViewProj).v);
+		glUniformMatrix4fv(viewProjLoc, 1, GL_FALSE, MatrixToFloatV(viewProj).v);
+		glUniformMatrix4fv(prevViewProjLoc, 1, GL_FALSE, MatrixToFloatV(prevViewProj).v);
+		glUniform1f(feedbackLoc, fresh ? 0.0f : C_FEEDBACK);
+		Bind(C_HISTORY_UNIT, history[write ^ 1]);
+		Bind(C_DEPTH_UNIT, depth);
+		Bind(C_COLOR_UNIT, color);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		Bind(C_HISTORY_UNIT, 0);
+		Bind(C_DEPTH_UNIT, 0);
+		Bind(C_COLOR_UNIT, 0);
+		glBindVertexArray(0);
+		glUseProgram(0);
+		rlEnableColorBlend();
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+		rlDisableFramebuffer();
+		rlViewport(0, 0, GetRenderWidth(), GetRenderHeight());
+		resolved = history[write];
+		fresh = false;
+	}
+
+	// The sharpened history over the whole current framebuffer; no depth.
+	void Present() const {
+		rlDrawRenderBatchActive();
+		glUseProgram(sharpen.id);
+		glBindVertexArray(vao);
+		rlDisableColorBlend();
+		rlDisableDepthTest();
+		glUniform1f(sharpnessLoc, C_SHARPNESS);
+		Bind(C_COLOR_UNIT, resolved);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+		Bind(C_COLOR_UNIT, 0);
+		glBindVertexArray(0);
+		glUseProgram(0);
+		rlEnableColorBlend();
+	}
+
+private:
+	static constexpr int C_COLOR_UNIT = 0;
+	static constexpr int C_DEPTH_UNIT = 1;
+	static constexpr int C_HISTORY_UNIT = 2;
+
+	static float Halton(int index, int base) {
+		float result = 0.0f, f = 1.0f;
+		for (int i = index; i > 0; i /= base) {
+			f /= static_cast<float>(base);
+			result += f * static_cast<float>(i % base);
+		}
+		return result;
+	}
+
+	static void Bind(int unit, unsigned int texture) {
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glActiveTexture(GL_TEXTURE0);
+	}
+
+	int          width = 0;
+	int          height = 0;
+	float        scale = 0.6f;
+	unsigned int sceneFbo = 0;
+	unsigned int color = 0;
+	unsigned int depth = 0;
+	unsigned int resolveFbo = 0;
+	unsigned int history[2] = {};
+	unsigned int resolved = 0;
+	unsigned int vao = 0;
+	Shader       resolve{};
+	Shader       sharpen{};
+	int          renderSizeLoc = -1;
+	int          jitterLoc = -1;
+	int          invViewProjLoc = -1;
+	int          viewProjLoc = -1;
+	int          prevViewProjLoc = -1;
+	int          feedbackLoc = -1;
+	int          sharpnessLoc = -1;
+	Vector2      jitter{};
+	Matrix       viewProj = MatrixIdentity();
+	Matrix       prevViewProj = MatrixIdentity();
+	Matrix       invViewProj = MatrixIdentity();
+	uint64_t     frame = 0;
+	bool         fresh = true;
+};
+
+#endif // TEMPORAL_UPSAMPLE_H
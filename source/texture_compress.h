@@ -0,0 +1,481 @@
+#ifndef TEXTURE_COMPRESS_H
+#define TEXTURE_COMPRESS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"  // compressed uploads and formats raylib has no PixelFormat for
+#include "asset_cache.h"
+
+// --- BLOCK COMPRESSION ---
+// Textures cooked offline into GPU block-compressed DDS files, which upload as they are and
+// stay compressed in video memory: 4x4 texel blocks of 8 bytes (BC1) or 16 (BC3, BC5, BC7),
+// where RGBA8 takes 64.
+//   - BC1: opaque colour, two RGB565 endpoints and 2-bit indices;
+//   - BC3: colour with alpha, a BC1 colour block after a BC4 alpha block;
+//   - BC5: normal maps, BC4 blocks for X and Y; shaders rebuild Z;
+//   - BC7: colour with or without alpha, mode 6 only (one subset, RGBA endpoints with a
+//     p-bit, 4-bit indices).
+// Pick() takes the best the driver samples for a use: BC7 (ARB_texture_compression_bptc)
+// over BC1/BC3 (EXT_texture_compression_s3tc), BC5 (core GL 3.0) for normals, else nothing.
+//
+// Cook() decodes the source with its mip chain (AssetCache::LoadMipmappedImageData),
+// compresses every level and writes a DX10 DDS in the asset cache directory, keyed like the
+// cache's blobs; it does nothing if that file is already there, and is safe on worker
+// threads. CookedFile maps a cooked DDS; Upload() hands levels straight from the mapping to
+// glCompressedTexImage2D. raylib's own DDS loader stops at DXT5, hence both. The encoders go
+// for speed (principal axis endpoints, one least-squares refinement for BC1) rather than the
+// last tenth of a dB.
+namespace TextureCompress {
+	enum Codec { C_NONE, C_BC1, C_BC3, C_BC5, C_BC7 };
+	enum Usage { C_COLOR, C_COLOR_ALPHA, C_NORMAL };
+
+	inline const char* Name(Codec codec) {
+		switch (codec) {
+		case C_BC1: return "BC1";
+		case C_BC3: return "BC3";
+		case C_BC5: return "BC5";
+		case C_BC7: return "BC7";
+		default:    return "RGBA8";
+		}
+	}
+
+	// Bytes of one `width` x `height` level.
+	inline size_t LevelBytes(int width, int height, Codec codec) {
+		const size_t blocks = static_cast<size_t>((width + 3) / 4) * static_cast<size_t>((height + 3) / 4);
+		return blocks * ((codec == C_BC1) ? 8 : 16);
+	}
+
+	namespace Detail {
+		constexpr uint32_t C_VERSION = 1;  // bump when the encoders change what they write
+		constexpr uint32_t C_DXGI[5] = { 0, 71, 77, 83, 98 };  // DXGI_FORMAT_BC1/3/5/7_UNORM
+		constexpr int      C_BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		inline bool HasExtension(const char* name) {
+			GLint count = 0;
+			glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+			for (GLint i = 0; i < count; ++i) {
+				const char* ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, static_cast<GLuint>(i)));
+				if (ext != nullptr && strcmp(ext, name) == 0) return true;
+			}
+			return false;
+		}
+
+		inline GLenum InternalFormat(Codec codec) {
+			switch (codec) {
+			case C_BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+			case C_BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+			case C_BC5: return GL_COMPRESSED_RG_RGTC2;
+			default:    return GL_COMPRESSED_RGBA_BPTC_UNORM;
+			}
+		}
+
+		// Dominant direction of `count` points of `dims` channels about their mean, by power
+		// iteration on the covariance; (1, 1, ...) when they are all the same.
+		inline void PrincipalAxis(const float* points, int count, int dims, float* mean, float* axis) {
+			float cov[4][4] = {};
+			for (int d = 0; d < dims; ++d) {
+				mean[d] = 0.0f;
+				for (int i = 0; i < count; ++i) mean[d] += points[i * dims + d];
+				mean[d] /= static_cast<float>(count);
+			}
+			for (int i = 0; i < count; ++i) {
+				for (int a = 0; a < dims; ++a) {
+					for (int b = 0; b < dims; ++b) cov[a][b] += (points[i * dims + a] - mean[a]) * (points[i * dims + b] - mean[b]);
+				}
+			}
+			for (int d = 0; d < dims; ++d) axis[d] = 1.0f;
+			for (int iter = 0; iter < 8; ++iter) {
+				float next[4] = {};
+				float length = 0.0f;
+				for (int a = 0; a < dims; ++a) {
+					for (int b = 0; b < dims; ++b) next[a] += cov[a][b] * axis[b];
+					length = std::max(length, fabsf(next[a]));
+				}
+				if (length < 1e-6f) break;
+				for (int d = 0; d < dims; ++d) axis[d] = next[d] / length;
+			}
+		}
+
+		// The points' extremes along their principal axis.
+		inline void Extremes(const float* points, int count, int dims, float* lo, float* hi) {
+			float mean[4], axis[4];
+			PrincipalAxis(points, count, dims, mean, axis);
+			float norm = 0.0f;
+			for (int d = 0; d < dims; ++d) norm += axis[d] * axis[d];
+			float tMin = 0.0f, tMax = 0.0f;
+			for (int i = 0; i < count; ++i) {
+				float t = 0.0f;
+				for (int d = 0; d < dims; ++d) t += (points[i * dims + d] - mean[d]) * axis[d];
+				t /= norm;
+				tMin = std::min(tMin, t);
+				tMax = std::max(tMax, t);
+			}
+			for (int d = 0; d < dims; ++d) {
+				lo[d] = std::clamp(mean[d] + axis[d] * tMin, 0.0f, 255.0f);
+				hi[d] = std::clamp(mean[d] + axis[d] * tMax, 0.0f, 255.0f);
+			}
+		}
+
+		inline uint16_t Pack565(const float* c) {
+			const int r = static_cast<int>(c[0] * 31.0f / 255.0f + 0.5f);
+			const int g = static_cast<int>(c[1] * 63.0f / 255.0f + 0.5f);
+			const int b = static_cast<int>(c[2] * 31.0f / 255.0f + 0.5f);
+			return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		inline void Unpack565(uint16_t c, int* out) {
+			const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+			out[0] = (r << 3) | (r >> 2);
+			out[1] = (g << 2) | (g >> 4);
+			out[2] = (b << 3) | (b >> 2);
+		}
+
+		// Four-colour BC1 block for `rgb` (16 texels, 3 floats each); its squared error.
+		inline int TryBC1(const float* rgb, uint16_t c0, uint16_t c1, uint8_t* out) {
+			if (c0 < c1) std::swap(c0, c1);
+			int palette[4][3];
+			Unpack565(c0, palette[0]);
+			Unpack565(c1, palette[1]);
+			for (int k = 0; k < 3; ++k) {
+				palette[2][k] = (2 * palette[0][k] + palette[1][k]) / 3;
+				palette[3][k] = (palette[0][k] + 2 * palette[1][k]) / 3;
+			}
+			uint32_t indices = 0;
+			int error = 0;
+			for (int i = 0; i < 16; ++i) {
+				int best = 0, bestError = INT32_MAX;
+				for (int p = 0; p < ((c0 == c1) ? 1 : 4); ++p) {
+					int e = 0;
+					for (int k = 0; k < 3; ++k) {
+						const int d = static_cast<int>(rgb[i * 3 + k] + 0.5f) - palette[p][k];
+						e += d * d;
+					}
+					if (e < bestError) {
+						bestError = e;
+						best = p;
+					}
+				}
+				indices |= static_cast<uint32_t>(best) << (i * 2);
+				error += bestError;
+			}
+			out[0] = static_cast<uint8_t>(c0);
+			out[1] = static_cast<uint8_t>(c0 >> 8);
+			out[2] = static_cast<uint8_t>(c1);
+			out[3] = static_cast<uint8_t>(c1 >> 8);
+			memcpy(out + 4, &indices, 4);  // little-endian, texel 0 in the low bits
+			return error;
+		}
+
+		inline void EncodeBC1(const float* rgb, uint8_t* out) {
+			float lo[3], hi[3];
+			Extremes(rgb, 16, 3, lo, hi);
+			int error = TryBC1(rgb, Pack565(hi), Pack565(lo), out);
+			if (error == 0) return;
+
+			// Least-squares endpoints for the indices just chosen: texel i is a_i * e0 + b_i * e1.
+			static constexpr float C_WEIGHT[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+			uint32_t indices;
+			memcpy(&indices, out + 4, 4);
+			float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[3] = {}, bx[3] = {};
+			for (int i = 0; i < 16; ++i) {
+				const float a = C_WEIGHT[(indices >> (i * 2)) & 3], b = 1.0f - a;
+				aa += a * a;
+				ab += a * b;
+				bb += b * b;
+				for (int k = 0; k < 3; ++k) {
+					ax[k] += a * rgb[i * 3 + k];
+					bx[k] += b * rgb[i * 3 + k];
+				}
+			}
+			const float det = aa * bb - ab * ab;
+			if (fabsf(det) < 1e-6f) return;
+			float e0[3], e1[3];
+			for (int k = 0; k < 3; ++k) {
+				e0[k] = std::clamp((ax[k] * bb - bx[k] * ab) / det, 0.0f, 255.0f);
+				e1[k] = std::clamp((bx[k] * aa - ax[k] * ab) / det, 0.0f, 255.0f);
+			}
+			uint8_t refined[8];
+			if (TryBC1(rgb, Pack565(e0), Pack565(e1), refined) < error) memcpy(out, refined, 8);
+		}
+
+		// One channel of 16 texels, eight-value mode (a0 > a1) unless they are all equal.
+		inline void EncodeBC4(const float* values, int stride, uint8_t* out) {
+			float lo = 255.0f, hi = 0.0f;
+			for (int i = 0; i < 16; ++i) {
+				lo = std::min(lo, values[i * stride]);
+				hi = std::max(hi, values[i * stride]);
+			}
+			const int a0 = static_cast<int>(hi + 0.5f), a1 = static_cast<int>(lo + 0.5f);
+			int palette[8] = { a0, a1 };
+			for (int k = 2; k < 8; ++k) palette[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+			uint64_t indices = 0;
+			for (int i = 0; i < 16; ++i) {
+				const int v = static_cast<int>(values[i * stride] + 0.5f);
+				int best = 0;
+				for (int p = 1; p < ((a0 == a1) ? 1 : 8); ++p) {
+					if (abs(v - palette[p]) < abs(v - palette[best])) best = p;
+				}
+				indices |= static_cast<uint64_t>(best) << (i * 3);
+			}
+			out[0] = static_cast<uint8_t>(a0);
+			out[1] = static_cast<uint8_t>(a1);
+			for (int b = 0; b < 6; ++b) out[2 + b] = static_cast<uint8_t>(indices >> (b * 8));
+		}
+
+		// Appends `bits` bits of `value` at bit `at` of a 16-byte block, lowest first.
+		inline void PutBits(uint8_t* block, int& at, uint32_t value, int bits) {
+			for (int i = 0; i < bits; ++i, ++at) {
+				if ((value >> i) & 1) block[at >> 3] |= static_cast<uint8_t>(1 << (at & 7));
+			}
+		}
+
+		// BC7 mode 6 for `rgba` (16 texels, 4 floats each).
+		inline void EncodeBC7(const float* rgba, uint8_t* out) {
+			float lo[4], hi[4];
+			Extremes(rgba, 16, 4, lo, hi);
+
+			// 7 bits per channel and a p-bit per endpoint shared by its channels, the one that fits best.
+			int q[2][4], p[2], e[2][4];
+			const float* ends[2] = { lo, hi };
+			for (int n = 0; n < 2; ++n) {
+				int bestError = INT32_MAX;
+				for (int bit = 0; bit < 2; ++bit) {
+					int error = 0, qs[4];
+					for (int k = 0; k < 4; ++k) {
+						qs[k] = std::clamp(static_cast<int>((ends[n][k] - static_cast<float>(bit)) * 0.5f + 0.5f), 0, 127);
+						const int d = ((qs[k] << 1) | bit) - static_cast<int>(ends[n][k] + 0.5f);
+						error += d * d;
+					}
+					if (error >= bestError) continue;
+					bestError = error;
+					p[n] = bit;
+					for (int k = 0; k < 4; ++k) {
+						q[n][k] = qs[k];
+						e[n][k] = (qs[k] << 1) | bit;
+					}
+				}
+			}
+
+			int palette[16][4];
+			for (int i = 0; i < 16; ++i) {
+				for (int k = 0; k < 4; ++k) palette[i][k] = ((64 - C_BC7_WEIGHTS[i]) * e[0][k] + C_BC7_WEIGHTS[i] * e[1][k] + 32) >> 6;
+			}
+			int indices[16];
+			for (int i = 0; i < 16; ++i) {
+				int best = 0, bestError = INT32_MAX;
+				for (int j = 0; j < 16; ++j) {
+					int error = 0;
+					for (int k = 0; k < 4; ++k) {
+						const int d = static_cast<int>(rgba[i * 4 + k] + 0.5f) - palette[j][k];
+						error += d * d;
+					}
+					if (error < bestError) {
+						bestError = error;
+						best = j;
+					}
+				}
+				indices[i] = best;
+			}
+			// Texel 0's index has an implied top bit of 0: swap the ends if it would be set.
+			if (indices[0] & 8) {
+				std::swap(q[0], q[1]);
+				std::swap(p[0], p[1]);
+				for (int& index : indices) index = 15 - index;
+			}
+
+			memset(out, 0, 16);
+			int at = 0;
+			PutBits(out, at, 1u << 6, 7);  // mode 6
+			for (int k = 0; k < 4; ++k) {
+				PutBits(out, at, static_cast<uint32_t>(q[0][k]), 7);
+				PutBits(out, at, static_cast<uint32_t>(q[1][k]), 7);
+			}
+			PutBits(out, at, static_cast<uint32_t>(p[0]), 1);
+			PutBits(out, at, static_cast<uint32_t>(p[1]), 1);
+			PutBits(out, at, static_cast<uint32_t>(indices[0]), 3);
+			for (int i = 1; i < 16; ++i) PutBits(out, at, static_cast<uint32_t>(indices[i]), 4);
+		}
+
+		// One level of RGBA8 texels compressed; edge blocks repeat the last row and column.
+		inline void EncodeLevel(const Color* texels, int width, int height, Codec codec, uint8_t* out) {
+			const size_t blockBytes = (codec == C_BC1) ? 8 : 16;
+			for (int by = 0; by < height; by += 4) {
+				for (int bx = 0; bx < width; bx += 4) {
+					float block[16 * 4];
+					for (int i = 0; i < 16; ++i) {
+						const Color& c = texels[std::min(by + i / 4, height - 1) * width + std::min(bx + i % 4, width - 1)];
+						block[i * 4 + 0] = c.r;
+						block[i * 4 + 1] = c.g;
+						block[i * 4 + 2] = c.b;
+						block[i * 4 + 3] = c.a;
+					}
+					switch (codec) {
+					case C_BC1: {
+						float rgb[16 * 3];
+						for (int i = 0; i < 16; ++i) std::copy_n(&block[i * 4], 3, &rgb[i * 3]);
+						EncodeBC1(rgb, out);
+						break;
+					}
+					case C_BC3: {
+						float rgb[16 * 3];
+						for (int i = 0; i < 16; ++i) std::copy_n(&block[i * 4], 3, &rgb[i * 3]);
+						EncodeBC4(&block[3], 4, out);
+						EncodeBC1(rgb, out + 8);
+						break;
+					}
+					case C_BC5:
+						EncodeBC4(&block[0], 4, out);
+						EncodeBC4(&block[1], 4, out + 8);
+						break;
+					default:
+						EncodeBC7(block, out);
+						break;
+					}
+					out += blockBytes;
+				}
+			}
+		}
+
+		inline std::string PathOf(const char* fileName, Codec codec) {
+			const uint64_t key = AssetCache::Detail::Key(fileName, 0x100u | (C_VERSION << 4) | static_cast<uint32_t>(codec));
+			char name[48];
+			snprintf(name, sizeof(name), "/%016llx_%s.dds", static_cast<unsigned long long>(key), Name(codec));
+			return std::string(AssetCache::Directory()) + name;
+		}
+
+		inline bool SaveDds(const std::string& path, const std::vector<uint8_t>& levels, int width, int height, int mipmaps, Codec codec) {
+			uint32_t header[32 + 5] = {};
+			memcpy(header, "DDS ", 4);
+			header[1] = 124;                                         // header size
+			header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000; // caps, height, width, pixel format, mip count, linear size
+			header[3] = static_cast<uint32_t>(height);
+			header[4] = static_cast<uint32_t>(width);
+			header[5] = static_cast<uint32_t>(LevelBytes(width, height, codec));
+			header[7] = static_cast<uint32_t>(mipmaps);
+			header[19] = 32;                                         // pixel format size
+			header[20] = 0x4;                                        // four CC
+			memcpy(&header[21], "DX10", 4);
+			header[27] = 0x1000 | 0x400000 | 0x8;                    // texture, mipmap, complex
+			header[32] = C_DXGI[codec];
+			header[33] = 3;                                          // 2D
+			header[35] = 1;                                          // array size
+
+			std::vector<uint8_t> bytes(sizeof(header) + levels.size());
+			memcpy(bytes.data(), header, sizeof(header));
+			memcpy(bytes.data() + sizeof(header), levels.data(), levels.size());
+			std::error_code ec;
+			std::filesystem::create_directories(AssetCache::Directory(), ec);
+			return SaveFileData(path.c_str(), bytes.data(), static_cast<int>(bytes.size()));
+		}
+	}
+
+	// The codec for `usage` the current context samples, or C_NONE. Main thread, after InitWindow.
+	inline Codec Pick(Usage usage) {
+		const bool s3tc = GLAD_GL_EXT_texture_compression_s3tc != 0;
+		const bool bptc = GLAD_GL_VERSION_4_2 != 0 || Detail::HasExtension("GL_ARB_texture_compression_bptc");
+		if (usage == C_NORMAL) return GLAD_GL_VERSION_3_0 ? C_BC5 : C_NONE;
+		if (bptc) return C_BC7;
+		if (s3tc) return (usage == C_COLOR_ALPHA) ? C_BC3 : C_BC1;
+		return C_NONE;
+	}
+
+	// A cooked DDS, mapped; Valid() only if it is one of ours and holds every level it claims.
+	class CookedFile {
+	public:
+		CookedFile(const char* fileName, Codec codec) : file(Detail::PathOf(fileName, codec).c_str()) {
+			constexpr size_t C_HEADER = (32 + 5) * sizeof(uint32_t);
+			if (!file.Contains(0, C_HEADER)) return;
+			uint32_t header[32 + 5];
+			memcpy(header, file.Data(), C_HEADER);
+			if (memcmp(header, "DDS ", 4) != 0 || memcmp(&header[21], "DX10", 4) != 0 || header[32] != Detail::C_DXGI[codec]) return;
+			width = static_cast<int>(header[4]);
+			height = static_cast<int>(header[3]);
+			mipmaps = std::max(static_cast<int>(header[7]), 1);
+			size_t bytes = 0;
+			for (int l = 0; l < mipmaps; ++l) bytes += LevelBytes(std::max(width >> l, 1), std::max(height >> l, 1), codec);
+			if (width <= 0 || height <= 0 || !file.Contains(C_HEADER, bytes)) return;
+			levels = file.Data() + C_HEADER;
+		}
+
+		bool Valid() const {
+			return levels != nullptr;
+		}
+
+		// Every level, largest first, packed.
+		const unsigned char* Levels() const {
+			return levels;
+		}
+
+		int width = 0;
+		int height = 0;
+		int mipmaps = 0;
+
+	private:
+		AssetCache::Detail::MappedFile file;
+		const unsigned char*           levels = nullptr;
+	};
+
+	// Writes the cooked DDS of `fileName` for `codec` unless it is there already; false if the
+	// source can't be read or the file written. Safe on any thread; no GL.
+	inline bool Cook(const char* fileName, Codec codec) {
+		if (CookedFile(fileName, codec).Valid()) return true;
+		Image chain = AssetCache::LoadMipmappedImageData(fileName);
+		if (chain.data == nullptr || chain.format >= PIXELFORMAT_COMPRESSED_DXT1_RGB) {
+			if (chain.data != nullptr) UnloadImage(chain);
+			return false;
+		}
+		const double start = GetTime();
+		std::vector<uint8_t> levels;
+		size_t offset = 0;
+		for (int l = 0; l < chain.mipmaps; ++l) {
+			const int w = std::max(chain.width >> l, 1), h = std::max(chain.height >> l, 1);
+			Image level = { static_cast<unsigned char*>(chain.data) + offset, w, h, 1, chain.format };
+			Color* texels = LoadImageColors(level);
+			levels.resize(levels.size() + LevelBytes(w, h, codec));
+			Detail::EncodeLevel(texels, w, h, codec, levels.data() + levels.size() - LevelBytes(w, h, codec));
+			UnloadImageColors(texels);
+			offset += static_cast<size_t>(GetPixelDataSize(w, h, chain.format));
+		}
+		const std::string path = Detail::PathOf(fileName, codec);
+		const bool saved = Detail::SaveDds(path, levels, chain.width, chain.height, chain.mipmaps, codec);
+		if (saved) TraceLog(LOG_INFO, "COMPRESS: %s -> %s as %s, %i level(s), %i KB from %i KB, %.0f ms", fileName, path.c_str(), Name(codec), chain.mipmaps, static_cast<int>(levels.size() / 1024), static_cast<int>(offset / 1024), (GetTime() - start) * 1000.0);
+		UnloadImage(chain);
+		return saved;
+	}
+
+	// A texture of `mipmaps` packed levels, the first `width` x `height`. Texture2D's format
+	// can't name BC5 or BC7; they are tagged DXT5, which has the same block size.
+	inline Texture2D Upload(const unsigned char* levels, int width, int height, int mipmaps, Codec codec) {
+		Texture2D texture{};
+		texture.width = width;
+		texture.height = height;
+		texture.mipmaps = mipmaps;
+		texture.format = (codec == C_BC1) ? PIXELFORMAT_COMPRESSED_DXT1_RGB : PIXELFORMAT_COMPRESSED_DXT5_RGBA;
+		glGenTextures(1, &texture.id);
+		glBindTexture(GL_TEXTURE_2D, texture.id);
+		for (int l = 0; l < mipmaps; ++l) {
+			const int w = std::max(width >> l, 1), h = std::max(height >> l, 1);
+			const size_t bytes = LevelBytes(w, h, codec);
+			glCompressedTexImage2D(GL_TEXTURE_2D, l, Detail::InternalFormat(codec), w, h, 0, static_cast<GLsizei>(bytes), levels);
+			levels += bytes;
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmaps - 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (mipmaps > 1) ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		return texture;
+	}
+}
+
+#endif // TEXTURE_COMPRESS_H
@@ -0,0 +1,337 @@
+#ifndef TEXTURE_STREAMING_H
+#define TEXTURE_STREAMING_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "asset_cache.h"
+#include "async_loader.h"
+#include "texture_compress.h"
+
+// --- TEXTURE STREAMING ---
+// Textures whose GPU copy holds only the mip levels the screen needs, under a byte budget.
+// Load() has the loader decode the file with its whole mip chain (cooked that way, so later
+// runs just map it) and, once it arrives, uploads only the levels at most C_MIN_SIZE texels a
+// side: those stay resident for good. Each frame the caller reports how many pixels across
+// every texture covers on screen (Request, ScreenPixels); Update() turns that into the finest
+// level worth having and trims the wishes that don't fit the budget, least needed first. A
+// texture drops straight to a coarser target and climbs towards a finer one a level a frame,
+// the neediest first, within C_UPLOAD_BUDGET bytes a frame.
+// Textures unseen for C_LINGER frames drop back to their resident floor.
+//
+// GL 3.3 can't free part of a texture's levels, so a change re-creates it from the level it
+// should start at, read from the cooked blob's mapping; nothing above the floor is kept in
+// CPU memory unless the blob couldn't be written. The new texture replaces the old one in
+// every slot bound to it (Bind), so give it material maps rather than copies of the handle.
+// For a moment during a change both versions exist, one texture's worth over the budget.
+//
+// Loaded with a Usage, a texture is block-compressed when the driver samples a codec for it
+// (TextureCompress::Pick): the worker cooks the DDS the first time, and every level comes
+// from its mapping, so budget and upload bytes are compressed bytes.
+class TextureStreamer {
+public:
+	static constexpr int    C_MIN_SIZE = 64;              // texels a side always resident
+	static constexpr size_t C_UPLOAD_BUDGET = 4u << 20;   // bytes per Update()
+	static constexpr float  C_TEXELS_PER_PIXEL = 1.0f;    // texels wanted across per pixel covered
+	static constexpr int    C_LINGER = 120;               // frames an unseen texture keeps its levels
+
+	using Handle = int;
+
+	struct Stats {
+		size_t resident = 0;  // bytes on the GPU
+		size_t wanted = 0;    // bytes the screen asked for, before the budget
+		int    textures = 0;  // arrived
+		int    streamedIn = 0;
+		int    evicted = 0;
+		int    pending = 0;   // not at their target level yet
+	};
+
+	// `budget`: bytes of texture memory the streamed textures may take on the GPU.
+	void Init(size_t bytes) {
+		budget = bytes;
+		frame = 0;
+	}
+
+	// Starts loading `fileName`; until it arrives its slots keep whatever they held.
+	Handle Load(AsyncLoader& loader, const char* fileName) {
+		const Handle handle = static_cast<Handle>(entries.size());
+		entries.emplace_back();
+		entries.back().fileName = fileName;
+		loader.LoadMipmappedImage(fileName, [this, handle](Image& image) { Arrive(handle, image); });
+		return handle;
+	}
+
+	// Load() of a texture used as `usage`, block-compressed if the driver allows.
+	Handle Load(AsyncLoader& loader, const char* fileName, TextureCompress::Usage usage) {
+		const TextureCompress::Codec codec = TextureCompress::Pick(usage);
+		if (codec == TextureCompress::C_NONE) return Load(loader, fileName);
+		const Handle handle = static_cast<Handle>(entries.size());
+		entries.emplace_back();
+		entries.back().fileName = fileName;
+		entries.back().codec = codec;
+		std::string name = fileName;
+		loader.Run([name, codec] { return TextureCompress::Cook(name.c_str(), codec); }, [this, handle](bool cooked) { ArriveCooked(handle, cooked); });
+		return handle;
+	}
+
+	// How `handle` is stored on the GPU; C_NONE uncompressed.
+	TextureCompress::Codec Codec(Handle handle) const {
+		return entries[handle].codec;
+	}
+
+	// `slot` gets the texture now and every time it is re-created; it must outlive the streamer.
+	void Bind(Handle handle, Texture2D* slot) {
+		Entry& e = entries[handle];
+		e.slots.push_back(slot);
+		if (e.texture.id != 0) *slot = e.texture;
+	}
+
+	// This frame, `handle` covers `pixels` across somewhere on screen; the largest use counts.
+	void Request(Handle handle, float pixels) {
+		Entry& e = entries[handle];
+		e.pixels = std::max(e.pixels, pixels);
+		e.lastSeen = frame;
+	}
+
+	// Pixels across that a sphere covers, for Request.
+	static float ScreenPixels(const Camera3D& camera, Vector3 centre, float radius, int screenHeight) {
+		const float distance = Vector3Distance(camera.position, centre);
+		if (distance <= radius) return static_cast<float>(screenHeight);
+		return radius / (distance * tanf(camera.fovy * 0.5f * DEG2RAD)) * static_cast<float>(screenHeight);
+	}
+
+	void SetBudget(size_t bytes) {
+		budget = bytes;
+	}
+
+	size_t Budget() const {
+		return budget;
+	}
+
+	// Once a frame, on the main thread, after the frame's Requests.
+	void Update() {
+		stats = Stats{};
+		std::vector<Entry*> live;
+		for (Entry& e : entries) {
+			if (e.texture.id == 0) continue;
+			if (e.lastSeen == frame) e.wanted = e.pixels;
+			else if (frame - e.lastSeen > C_LINGER) e.wanted = 0.0f;
+			e.target = LevelFor(e, e.wanted);
+			stats.wanted += Bytes(e, e.target);
+			live.push_back(&e);
+		}
+		FitBudget(live);
+
+		size_t spent = 0;
+		// Evictions first: they free memory, and they are small.
+		for (Entry* e : live) {
+			if (e->target <= e->resident) continue;
+			spent += Recreate(*e, e->target);
+			++stats.evicted;
+		}
+		// Then one level finer for the most undersampled textures, within the upload budget.
+		std::sort(live.begin(), live.end(), [](const Entry* a, const Entry* b) { return Shortfall(*a) > Shortfall(*b); });
+		for (Entry* e : live) {
+			if (e->target >= e->resident) continue;
+			const size_t bytes = Bytes(*e, e->resident - 1);
+			if (spent > 0 && spent + bytes > C_UPLOAD_BUDGET) break;
+			spent += Recreate(*e, e->resident - 1);
+			++stats.streamedIn;
+		}
+
+		for (Entry* e : live) {
+			stats.resident += Bytes(*e, e->resident);
+			if (e->resident != e->target) ++stats.pending;
+			e->pixels = 0.0f;
+		}
+		stats.textures = static_cast<int>(live.size());
+		++frame;
+	}
+
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+	// Frees every texture; their slots are left pointing at nothing valid. Stop the loader first.
+	void Unload() {
+		for (Entry& e : entries) {
+			if (e.texture.id != 0) rlUnloadTexture(e.texture.id);
+			if (e.image.data != nullptr) UnloadImage(e.image);
+		}
+		entries.clear();
+	}
+
+private:
+	struct Entry {
+		std::string             fileName;
+		uint64_t                key = 0;         // of the cooked blob holding every level
+		TextureCompress::Codec  codec = TextureCompress::C_NONE;  // else the levels are in its DDS
+		Image                   image{};         // the whole chain, only if there is no blob
+		int                     width = 0;       // level 0
+		int                     height = 0;
+		int                     format = 0;
+		int                     mipmaps = 0;
+		std::vector<size_t>     offsets;         // of each level in the chain; one past the end last
+		int                     floor = 0;       // coarsest level resident from the start
+		int                     resident = 0;    // finest level on the GPU
+		int                     target = 0;
+		float                   pixels = 0.0f;   // requested this frame
+		float                   wanted = 0.0f;   // what the target is for
+		int64_t                 lastSeen = -C_LINGER - 1;
+		Texture2D               texture{};
+		std::vector<Texture2D*> slots;
+	};
+
+	static int LevelSize(int size, int level) {
+		return std::max(size >> level, 1);
+	}
+
+	// GPU bytes of levels `level` and down.
+	static size_t Bytes(const Entry& e, int level) {
+		return e.offsets.back() - e.offsets[level];
+	}
+
+	// The coarsest level at least `pixels` wide, never coarser than the floor.
+	static int LevelFor(const Entry& e, float pixels) {
+		const float texels = pixels * C_TEXELS_PER_PIXEL;
+		int level = e.floor;
+		while (level > 0 && static_cast<float>(std::max(LevelSize(e.width, level), LevelSize(e.height, level))) < texels) --level;
+		return level;
+	}
+
+	// Texels needed for each one resident: above 1 the texture is blurrier than the screen wants.
+	static float Shortfall(const Entry& e) {
+		return e.wanted * C_TEXELS_PER_PIXEL / static_cast<float>(std::max(LevelSize(e.width, e.resident), LevelSize(e.height, e.resident)));
+	}
+
+	// Coarsens targets until they fit: each step takes the texture whose target level is most
+	// oversampled for its screen size, so unseen ones go first.
+	void FitBudget(const std::vector<Entry*>& live) const {
+		size_t total = 0;
+		for (const Entry* e : live) total += Bytes(*e, e->target);
+		while (total > budget) {
+			Entry* coarsest = nullptr;
+			float worst = -1.0f;
+			for (Entry* e : live) {
+				if (e->target >= e->floor) continue;
+				const float texels = static_cast<float>(std::max(LevelSize(e->width, e->target), LevelSize(e->height, e->target)));
+				const float surplus = texels / std::max(e->wanted * C_TEXELS_PER_PIXEL, 1.0f);
+				if (surplus > worst) {
+					worst = surplus;
+					coarsest = e;
+				}
+			}
+			if (coarsest == nullptr) break;  // every floor together is over; nothing more to give
+			total -= Bytes(*coarsest, coarsest->target) - Bytes(*coarsest, coarsest->target + 1);
+			++coarsest->target;
+		}
+	}
+
+	void Arrive(Handle handle, Image& image) {
+		if (static_cast<size_t>(handle) >= entries.size()) {
+			if (image.data != nullptr) UnloadImage(image);
+			return;
+		}
+		Entry& e = entries[handle];
+		if (image.data == nullptr) {
+			TraceLog(LOG_WARNING, "STREAMING: %s failed to load", e.fileName.c_str());
+			return;
+		}
+		e.format = image.format;
+		Layout(e, image.width, image.height, image.mipmaps);
+
+		e.key = AssetCache::Detail::Key(e.fileName.c_str(), AssetCache::Detail::C_MIPMAPPED);
+		AssetCache::Detail::MappedFile file(AssetCache::Detail::PathOf(e.key).c_str());
+		AssetCache::Detail::TextureRecord r;
+		const bool mapped = AssetCache::Detail::TextureRecordOf(file, e.key, r) && r.size == e.offsets.back();
+		e.resident = e.mipmaps;  // nothing yet
+		Upload(e, e.floor, static_cast<const unsigned char*>(image.data));
+		if (mapped) UnloadImage(image);  // the levels above the floor come from the blob
+		else {
+			TraceLog(LOG_WARNING, "STREAMING: %s has no cooked mip chain; keeping it in CPU memory", e.fileName.c_str());
+			e.image = image;
+		}
+		image = Image{};
+	}
+
+	void ArriveCooked(Handle handle, bool cooked) {
+		if (static_cast<size_t>(handle) >= entries.size()) return;
+		Entry& e = entries[handle];
+		const TextureCompress::CookedFile file(e.fileName.c_str(), e.codec);
+		if (!cooked || !file.Valid()) {
+			TraceLog(LOG_WARNING, "STREAMING: %s failed to cook as %s", e.fileName.c_str(), TextureCompress::Name(e.codec));
+			return;
+		}
+		Layout(e, file.width, file.height, file.mipmaps);
+		e.resident = e.mipmaps;  // nothing yet
+		Upload(e, e.floor, file.Levels());
+	}
+
+	// Level sizes and the floor of a `width` x `height` chain of `mipmaps` levels.
+	static void Layout(Entry& e, int width, int height, int mipmaps) {
+		e.width = width;
+		e.height = height;
+		e.mipmaps = mipmaps;
+		e.offsets.assign(1, 0);
+		for (int l = 0; l < e.mipmaps; ++l) {
+			const int w = LevelSize(e.width, l), h = LevelSize(e.height, l);
+			const size_t bytes = (e.codec != TextureCompress::C_NONE) ? TextureCompress::LevelBytes(w, h, e.codec) : static_cast<size_t>(GetPixelDataSize(w, h, e.format));
+			e.offsets.push_back(e.offsets.back() + bytes);
+		}
+		e.floor = 0;
+		while (e.floor + 1 < e.mipmaps && std::max(LevelSize(e.width, e.floor), LevelSize(e.height, e.floor)) > C_MIN_SIZE) ++e.floor;
+	}
+
+	// Replaces the GPU copy with levels `level` and down; the bytes uploaded.
+	size_t Recreate(Entry& e, int level) {
+		if (e.codec != TextureCompress::C_NONE) {
+			const TextureCompress::CookedFile file(e.fileName.c_str(), e.codec);
+			if (file.Valid() && file.width == e.width && file.height == e.height && file.mipmaps == e.mipmaps) return Upload(e, level, file.Levels());
+			TraceLog(LOG_WARNING, "STREAMING: %s's cooked DDS is gone; staying at %ix%i", e.fileName.c_str(), e.texture.width, e.texture.height);
+			e.target = e.resident;
+			return 0;
+		}
+		if (e.image.data != nullptr) return Upload(e, level, static_cast<const unsigned char*>(e.image.data));
+		AssetCache::Detail::MappedFile file(AssetCache::Detail::PathOf(e.key).c_str());
+		AssetCache::Detail::TextureRecord r;
+		if (!AssetCache::Detail::TextureRecordOf(file, e.key, r) || r.size != e.offsets.back()) {
+			TraceLog(LOG_WARNING, "STREAMING: %s's cooked mip chain is gone; staying at %ix%i", e.fileName.c_str(), e.texture.width, e.texture.height);
+			e.target = e.resident;
+			return 0;
+		}
+		return Upload(e, level, file.Data() + r.offset);
+	}
+
+	// `chain` is every level of the texture, level 0 first.
+	size_t Upload(Entry& e, int level, const unsigned char* chain) {
+		Texture2D texture{};
+		if (e.codec != TextureCompress::C_NONE) texture = TextureCompress::Upload(chain + e.offsets[level], LevelSize(e.width, level), LevelSize(e.height, level), e.mipmaps - level, e.codec);
+		else {
+			texture.width = LevelSize(e.width, level);
+			texture.height = LevelSize(e.height, level);
+			texture.mipmaps = e.mipmaps - level;
+			texture.format = e.format;
+			texture.id = rlLoadTexture(chain + e.offsets[level], texture.width, texture.height, texture.format, texture.mipmaps);
+		}
+		if (texture.id == 0) return 0;
+		if (e.texture.id != 0) rlUnloadTexture(e.texture.id);
+		e.texture = texture;
+		e.resident = level;
+		for (Texture2D* slot : e.slots) *slot = texture;
+		return Bytes(e, level);
+	}
+
+	std::vector<Entry> entries;
+	size_t             budget = 0;
+	int64_t            frame = 0;
+	Stats              stats;
+};
+
+#endif // TEXTURE_STREAMING_H
@@ -0,0 +1,248 @@
+#ifndef TILED_LIGHTS_H
+#define TILED_LIGHTS_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "clustered_lights.h"
+#include "jobs.h"
+#include "simd.h"
+
+// --- TILED LIGHTING ---
+// Forward shading with a light list per C_TILE x C_TILE pixel tile of the screen, rebuilt
+// on the CPU every frame. A tile's frustum is bounded by four planes through the eye, and
+// those split into two independent pairs: its column's left and right planes only involve
+// view-space x and z, its row's bottom and top planes only y and z. So rather than testing
+// every light against every tile, each column and each row is tested once against all
+// lights, eight spheres per instruction (Simd::SlabMask), on the JobSystem's workers, and a
+// tile's lights are the AND of its column's and its row's bitsets. 1280 x 720 is 3600
+// tiles but only 125 columns and rows.
+//
+// The tiles span the whole depth range: without compute there is no per-tile depth bounds
+// pass, so lights behind the geometry of a tile still land in its list (ClusteredLights
+// slices depth for that). GL 3.3 has no storage buffers, so the lists travel as
+// ClusteredLights' do, in float textures read with texelFetch, but in material map slots
+// 4-6 so that both can stay attached to one material.
+class TiledLights {
+public:
+	static constexpr int C_TILE = 16;           // pixels a side
+	static constexpr int C_MAX_LIGHTS = 2048;
+	static constexpr int C_MAX_PER_TILE = 128;  // further lights in a tile are dropped
+	static constexpr int C_INDEX_WIDTH = 1024;
+	static constexpr int C_WORDS = C_MAX_LIGHTS / 64;
+
+	struct Stats {
+		int lights = 0;      // lights submitted
+		int visible = 0;     // reached at least one tile
+		int references = 0;  // light-tile pairs written
+		int busiest = 0;     // longest tile list
+		int dropped = 0;     // pairs lost to C_MAX_PER_TILE
+	};
+
+	// Sized for a target of up to `width` x `height`; a larger one shares the last column's
+	// and row's tiles out to its edge.
+	void Init(int width, int height) {
+		maxTilesX = std::max((width + C_TILE - 1) / C_TILE, 1);
+		maxTilesY = std::max((height + C_TILE - 1) / C_TILE, 1);
+		const int tiles = maxTilesX * maxTilesY;
+		indexRows = (tiles * C_MAX_PER_TILE + C_INDEX_WIDTH - 1) / C_INDEX_WIDTH;
+		lightData = rlLoadTexture(nullptr, 2 * C_MAX_LIGHTS, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+		gridData = rlLoadTexture(nullptr, maxTilesX, maxTilesY, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+		indexData = rlLoadTexture(nullptr, C_INDEX_WIDTH, indexRows, PIXELFORMAT_UNCOMPRESSED_R32, 1);
+		lightTexels.resize(2 * C_MAX_LIGHTS * 4);
+		grid.resize(static_cast<size_t>(tiles) * 4);
+		counts.resize(static_cast<size_t>(tiles));
+		indices.resize(static_cast<size_t>(indexRows) * C_INDEX_WIDTH);
+		columnBits.resize(static_cast<size_t>(maxTilesX) * C_WORDS);
+		rowBits.resize(static_cast<size_t>(maxTilesY) * C_WORDS);
+		for (std::vector<float>* column : { &viewX, &viewY, &viewZ, &radii }) column->reserve(C_MAX_LIGHTS);
+		candidates.reserve(C_MAX_LIGHTS);
+	}
+
+	void Unload() {
+		rlUnloadTexture(lightData);
+		rlUnloadTexture(gridData);
+		rlUnloadTexture(indexData);
+		lightData = gridData = indexData = 0;
+	}
+
+	// Fetches the tile uniforms and points the map slots at the tile samplers. Needed again
+	// for every program that replaces this one.
+	void Bind(Shader& shader) {
+		shader.locs[SHADER_LOC_MAP_OCCLUSION] = GetShaderLocation(shader, "tileLights");
+		shader.locs[SHADER_LOC_MAP_EMISSION] = GetShaderLocation(shader, "tileGrid");
+		shader.locs[SHADER_LOC_MAP_HEIGHT] = GetShaderLocation(shader, "tileIndices");
+		tileSizeLoc = GetShaderLocation(shader, "tileSize");
+		tileCountLoc = GetShaderLocation(shader, "tileCount");
+	}
+
+	void Attach(Material& material) const {
+		SetLightSlot(material, MATERIAL_MAP_OCCLUSION, lightData, 2 * C_MAX_LIGHTS, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+		SetLightSlot(material, MATERIAL_MAP_EMISSION, gridData, maxTilesX, maxTilesY, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32);
+		SetLightSlot(material, MATERIAL_MAP_HEIGHT, indexData, C_INDEX_WIDTH, indexRows, PIXELFORMAT_UNCOMPRESSED_R32);
+	}
+
+	void Detach(Material& material) const {
+		for (int slot : { MATERIAL_MAP_OCCLUSION, MATERIAL_MAP_EMISSION, MATERIAL_MAP_HEIGHT }) ClearLightSlot(material, slot);
+	}
+
+	// Rebuilds the tile lists for this view and uploads them. `width` and `height` are the
+	// size of the target being drawn to. Lights past C_MAX_LIGHTS are ignored.
+	void Update(const std::vector<PointLight>& lights, const Camera3D& camera, int width, int height, Shader& shader) {
+		const int n = std::min(static_cast<int>(lights.size()), C_MAX_LIGHTS);
+		const Matrix view = GetCameraMatrix(camera);
+		const float tanY = tanf(camera.fovy * DEG2RAD * 0.5f);
+		const float tanX = tanY * static_cast<float>(width) / static_cast<float>(height);
+		const int tilesX = std::min((width + C_TILE - 1) / C_TILE, maxTilesX);
+		const int tilesY = std::min((height + C_TILE - 1) / C_TILE, maxTilesY);
+		const int tiles = tilesX * tilesY;
+
+		stats = Stats{};
+		stats.lights = n;
+		for (std::vector<float>* column : { &viewX, &viewY, &viewZ, &radii }) column->clear();
+		candidates.clear();
+
+		// Lights wholly behind the near plane never reach a tile; the rest go to view space,
+		// one column per coordinate for the plane tests
+		const float nearDepth = static_cast<float>(RL_CULL_DISTANCE_NEAR);
+		for (int i = 0; i < n; ++i) {
+			const PointLight& l = lights[i];
+			float* texel = &lightTexels[i * 8];
+			texel[0] = l.position.x;
+			texel[1] = l.position.y;
+			texel[2] = l.position.z;
+			texel[3] = l.radius;
+			texel[4] = static_cast<float>(l.color.r) / 255.0f;
+			texel[5] = static_cast<float>(l.color.g) / 255.0f;
+			texel[6] = static_cast<float>(l.color.b) / 255.0f;
+			texel[7] = 0.0f;
+
+			const Vector3 v = Vector3Transform(l.position, view);
+			if (-v.z + l.radius < nearDepth) continue;
+			viewX.push_back(v.x);
+			viewY.push_back(v.y);
+			viewZ.push_back(v.z);
+			radii.push_back(l.radius);
+			candidates.push_back(i);
+		}
+		const size_t m = candidates.size();
+		const int words = static_cast<int>((m + 63) / 64);
+
+		// One line per tile column, then one per tile row. A line from pixel p0 to p1 has
+		// edges at slopes t0 < t1 (x or y over depth), so its inward plane normals in (x or
+		// y, z) are (1, t0) and (-1, -t1), normalised.
+		JobSystem::Instance().ParallelFor(static_cast<size_t>(tilesX + tilesY), 16, [&](size_t begin, size_t end) {
+			for (size_t line = begin; line < end; ++line) {
+				const bool column = line < static_cast<size_t>(tilesX);
+				const int index = column ? static_cast<int>(line) : static_cast<int>(line) - tilesX;
+				const int count = column ? tilesX : tilesY;
+				const int pixels = column ? width : height;
+				const float slope = column ? tanX : tanY;
+				const int p0 = index * C_TILE;
+				const int p1 = (index == count - 1) ? pixels : p0 + C_TILE;
+				const float t0 = (2.0f * static_cast<float>(p0) / static_cast<float>(pixels) - 1.0f) * slope;
+				const float t1 = (2.0f * static_cast<float>(p1) / static_cast<float>(pixels) - 1.0f) * slope;
+				const float s0 = 1.0f / sqrtf(1.0f + t0 * t0);
+				const float s1 = 1.0f / sqrtf(1.0f + t1 * t1);
+				uint64_t* bits = column ? &columnBits[static_cast<size_t>(index) * C_WORDS] : &rowBits[static_cast<size_t>(index) * C_WORDS];
+				Simd::SlabMask(s0, t0 * s0, -s1, -t1 * s1, column ? viewX.data() : viewY.data(), viewZ.data(), radii.data(), m, bits);
+			}
+		});
+
+		// A light in some column and some row reaches the tile where they cross
+		for (int w = 0; w < words; ++w) {
+			uint64_t inColumn = 0, inRow = 0;
+			for (int x = 0; x < tilesX; ++x) inColumn |= columnBits[static_cast<size_t>(x) * C_WORDS + w];
+			for (int y = 0; y < tilesY; ++y) inRow |= rowBits[static_cast<size_t>(y) * C_WORDS + w];
+			stats.visible += std::popcount(inColumn & inRow);
+		}
+
+		// Tiles are laid out as the grid texture is, x + y*tilesX, row 0 at the bottom
+		JobSystem::Instance().ParallelFor(static_cast<size_t>(tiles), 256, [&](size_t begin, size_t end) {
+			for (size_t t = begin; t < end; ++t) {
+				const uint64_t* column = TileColumn(static_cast<int>(t), tilesX);
+				const uint64_t* row = TileRow(static_cast<int>(t), tilesX);
+				int count = 0;
+				for (int w = 0; w < words; ++w) count += std::popcount(column[w] & row[w]);
+				counts[t] = count;
+			}
+		});
+
+		int offset = 0;
+		for (int t = 0; t < tiles; ++t) {
+			const int count = std::min(counts[t], C_MAX_PER_TILE);
+			stats.dropped += counts[t] - count;
+			stats.busiest = std::max(stats.busiest, count);
+			grid[t * 4 + 0] = static_cast<float>(offset);
+			grid[t * 4 + 1] = static_cast<float>(count);
+			offset += count;
+		}
+		stats.references = offset;
+
+		JobSystem::Instance().ParallelFor(static_cast<size_t>(tiles), 256, [&](size_t begin, size_t end) {
+			for (size_t t = begin; t < end; ++t) {
+				const uint64_t* column = TileColumn(static_cast<int>(t), tilesX);
+				const uint64_t* row = TileRow(static_cast<int>(t), tilesX);
+				float* out = &indices[static_cast<size_t>(grid[t * 4 + 0])];
+				int left = static_cast<int>(grid[t * 4 + 1]);
+				for (int w = 0; w < words && left > 0; ++w) {
+					for (uint64_t bits = column[w] & row[w]; bits && left > 0; bits &= bits - 1, --left) {
+						*out++ = static_cast<float>(candidates[static_cast<size_t>(w) * 64 + static_cast<size_t>(std::countr_zero(bits))]);
+					}
+				}
+			}
+		});
+
+		if (n > 0) rlUpdateTexture(lightData, 0, 0, 2 * n, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, lightTexels.data());
+		for (int y = 0; y < tilesY; ++y) {
+			rlUpdateTexture(gridData, 0, y, tilesX, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, &grid[static_cast<size_t>(y) * tilesX * 4]);
+		}
+		const int rows = (offset + C_INDEX_WIDTH - 1) / C_INDEX_WIDTH;
+		if (rows > 0) rlUpdateTexture(indexData, 0, 0, C_INDEX_WIDTH, rows, PIXELFORMAT_UNCOMPRESSED_R32, indices.data());
+
+		const float tileSize = static_cast<float>(C_TILE);
+		const int tileCount[2] = { tilesX, tilesY };
+		SetShaderValue(shader, tileSizeLoc, &tileSize, SHADER_UNIFORM_FLOAT);
+		SetShaderValue(shader, tileCountLoc, tileCount, SHADER_UNIFORM_IVEC2);
+	}
+
+	const Stats& LastStats() const {
+		return stats;
+	}
+
+private:
+	const uint64_t* TileColumn(int tile, int tilesX) const {
+		return &columnBits[static_cast<size_t>(tile % tilesX) * C_WORDS];
+	}
+
+	const uint64_t* TileRow(int tile, int tilesX) const {
+		return &rowBits[static_cast<size_t>(tile / tilesX) * C_WORDS];
+	}
+
+	unsigned int lightData = 0;
+	unsigned int gridData = 0;
+	unsigned int indexData = 0;
+	int          maxTilesX = 0;
+	int          maxTilesY = 0;
+	int          indexRows = 0;
+	int          tileSizeLoc = -1;
+	int          tileCountLoc = -1;
+
+	std::vector<float>    lightTexels;
+	std::vector<float>    grid;
+	std::vector<float>    indices;
+	std::vector<int>      counts;
+	std::vector<float>    viewX, viewY, viewZ, radii;
+	std::vector<int>      candidates;  // light index of each view-space column entry
+	std::vector<uint64_t> columnBits;  // C_WORDS per tile column, bit k for candidate k
+	std::vector<uint64_t> rowBits;     // and per tile row
+	Stats                 stats;
+};
+
+#endif // TILED_LIGHTS_H
@@ -0,0 +1,249 @@
+#ifndef VERTEX_COMPRESS_H
+#define VERTEX_COMPRESS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "raylib.h"
+#include "rlgl.h"
+#include "external/glad.h"  // 16-bit and half-float attribute types, which rlgl doesn't name
+
+// --- COMPACT VERTICES ---
+// An optional GPU layout for static meshes, about half the bytes of raylib's floats, which
+// lighting.vs and pbr.vs decode as they fetch it:
+//   - positions: 16-bit unsigned normalised, within the mesh's bounding cube; 8 bytes, the
+//     fourth component 0 to mark the layout (a float position reads 1 there);
+//   - normals and tangents: octahedral, two 16-bit signed normalised components each, both
+//     in the normal slot (4 bytes, 8 with a tangent). The tangent's handedness is dropped:
+//     pbr.vs rebuilds the binormal from the normal and tangent alone;
+//   - texture coordinates: half floats, 4 bytes.
+// The cube's corner and size reach the shaders as one vec4 at C_DECODE_LOCATION, a vertex
+// attribute with a divisor no draw reaches, so it is part of the mesh's vertex array and
+// needs no per-draw uniform; float meshes leave it disabled, read GL's default (0, 0, 0, 1)
+// and decode to themselves. Only the GPU copy changes: the CPU arrays stay floats, for
+// picking, baking and bounds, and Expand() re-uploads them.
+//
+// Any vertex shader that draws a compacted mesh must decode it; the depth pre-pass draws
+// through lighting.vs for that reason. Skinned and CPU-animated meshes are left as they are.
+class VertexCompression {
+public:
+	static constexpr unsigned int C_DECODE_LOCATION = 8;      // after GpuSkinning's 6 and 7
+	static constexpr int          C_CONSTANT_DIVISOR = 1 << 30;
+
+	struct Stats {
+		int meshes = 0;
+		int floatBytes = 0;    // of the compacted meshes' positions, normals, tangents, UVs
+		int compactBytes = 0;  // the same, compacted
+	};
+
+	// Re-uploads every eligible mesh of `model` compacted. False if none was.
+	bool Compact(Model& model) {
+		bool any = false;
+		for (int m = 0; m < model.meshCount; ++m) {
+			Mesh& mesh = model.meshes[m];
+			if (mesh.vaoId == 0 || mesh.vboId == nullptr || mesh.vertices == nullptr || mesh.normals == nullptr) continue;
+			if (mesh.animVertices != nullptr || mesh.boneIds != nullptr || Find(mesh.vaoId) != nullptr) continue;
+			CompactMesh(mesh);
+			any = true;
+		}
+		return any;
+	}
+
+	// Puts the model's compacted meshes back in raylib's float layout.
+	void Expand(Model& model) {
+		for (int m = 0; m < model.meshCount; ++m) {
+			Mesh& mesh = model.meshes[m];
+			const Entry* entry = Find(mesh.vaoId);
+			if (entry == nullptr) continue;
+			ExpandMesh(mesh, *entry);
+			entries.erase(entries.begin() + (entry - entries.data()));
+		}
+	}
+
+	bool IsCompact(const Mesh& mesh) const {
+		return Find(mesh.vaoId) != nullptr;
+	}
+
+	// The decode buffers only: the meshes' own buffers go with UnloadModel, whichever layout.
+	void Unload() {
+		for (const Entry& e : entries) rlUnloadVertexBuffer(e.decode);
+		entries.clear();
+	}
+
+	// Over the meshes compacted now.
+	Stats Totals() const {
+		Stats s;
+		for (const Entry& e : entries) {
+			++s.meshes;
+			s.floatBytes += e.floatBytes;
+			s.compactBytes += e.compactBytes;
+		}
+		return s;
+	}
+
+	// Octahedral encoding of a unit vector, in [-1, 1] squared: the octahedron's upper half
+	// projected straight down, the lower half folded over the diagonals.
+	static void OctEncode(Vector3 n, float& u, float& v) {
+		const float l1 = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+		u = (l1 > 0.0f) ? n.x / l1 : 0.0f;
+		v = (l1 > 0.0f) ? n.y / l1 : 0.0f;
+		if (n.z < 0.0f) {
+			const float fu = (1.0f - fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+			const float fv = (1.0f - fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+			u = fu;
+			v = fv;
+		}
+	}
+
+	// What the shaders' OctDecode returns, for checking encodings on the CPU.
+	static Vector3 OctDecode(float u, float v) {
+		Vector3 n = { u, v, 1.0f - fabsf(u) - fabsf(v) };
+		const float t = std::max(-n.z, 0.0f);
+		n.x += (n.x >= 0.0f) ? -t : t;
+		n.y += (n.y >= 0.0f) ? -t : t;
+		const float length = sqrtf(n.x * n.x + n.y * n.y + n.z * n.z);
+		return { n.x / length, n.y / length, n.z / length };
+	}
+
+	static int16_t Snorm16(float f) {
+		return static_cast<int16_t>(lroundf(std::clamp(f, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	// IEEE half, rounded to nearest even; out of range is infinity, tiny values go subnormal.
+	static uint16_t Half(float f) {
+		uint32_t x;
+		memcpy(&x, &f, sizeof(x));
+		const uint32_t sign = (x >> 16) & 0x8000u;
+		const uint32_t biased = (x >> 23) & 0xffu;
+		uint32_t mantissa = x & 0x7fffffu;
+		if (biased == 0xffu) return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+		const int exponent = static_cast<int>(biased) - 127 + 15;
+		if (exponent >= 31) return static_cast<uint16_t>(sign | 0x7c00u);
+		if (exponent <= 0) {
+			if (exponent < -10) return static_cast<uint16_t>(sign);
+			mantissa |= 0x800000u;
+			const int shift = 14 - exponent;
+			uint32_t half = mantissa >> shift;
+			const uint32_t rest = mantissa & ((1u << shift) - 1u);
+			const uint32_t halfway = 1u << (shift - 1);
+			if (rest > halfway || (rest == halfway && (half & 1u))) ++half;
+			return static_cast<uint16_t>(sign | half);
+		}
+		uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		const uint32_t rest = mantissa & 0x1fffu;
+		if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half;  // a carry rounds into the exponent, as it should
+		return static_cast<uint16_t>(sign | half);
+	}
+
+private:
+	// Where rlLoadShaderProgram binds raylib's attribute names, as UploadMesh fills them.
+	static constexpr unsigned int C_POSITION = 0;
+	static constexpr unsigned int C_TEXCOORD = 1;
+	static constexpr unsigned int C_NORMAL = 2;
+	static constexpr unsigned int C_TANGENT = 4;
+
+	struct Entry {
+		unsigned int vao = 0;
+		unsigned int decode = 0;
+		int          floatBytes = 0;
+		int          compactBytes = 0;
+	};
+
+	const Entry* Find(unsigned int vao) const {
+		for (const Entry& e : entries) {
+			if (e.vao == vao) return &e;
+		}
+		return nullptr;
+	}
+
+	// Swaps the buffer in `slot` for one holding `data`, read at `location` as given.
+	static void Replace(Mesh& mesh, int slot, const void* data, int bytes, unsigned int location, int components, int type, bool normalized) {
+		rlUnloadVertexBuffer(mesh.vboId[slot]);
+		mesh.vboId[slot] = rlLoadVertexBuffer(data, bytes, false);
+		rlEnableVertexBuffer(mesh.vboId[slot]);
+		rlSetVertexAttribute(location, components, type, normalized, 0, nullptr);
+		rlEnableVertexAttribute(location);
+	}
+
+	void CompactMesh(Mesh& mesh) {
+		const int n = mesh.vertexCount;
+		const float* p = mesh.vertices;
+		Vector3 lo = { p[0], p[1], p[2] };
+		Vector3 hi = lo;
+		for (int i = 1; i < n; ++i) {
+			lo = { std::min(lo.x, p[i * 3]), std::min(lo.y, p[i * 3 + 1]), std::min(lo.z, p[i * 3 + 2]) };
+			hi = { std::max(hi.x, p[i * 3]), std::max(hi.y, p[i * 3 + 1]), std::max(hi.z, p[i * 3 + 2]) };
+		}
+		const float size = std::max({ hi.x - lo.x, hi.y - lo.y, hi.z - lo.z, 1e-6f });
+
+		std::vector<uint16_t> positions(static_cast<size_t>(n) * 4);
+		for (int i = 0; i < n; ++i) {
+			const float q[3] = { (p[i * 3] - lo.x) / size, (p[i * 3 + 1] - lo.y) / size, (p[i * 3 + 2] - lo.z) / size };
+			for (int c = 0; c < 3; ++c) positions[i * 4 + c] = static_cast<uint16_t>(lroundf(std::clamp(q[c], 0.0f, 1.0f) * 65535.0f));
+			positions[i * 4 + 3] = 0;
+		}
+
+		const bool tangents = mesh.tangents != nullptr;
+		const int perNormal = tangents ? 4 : 2;
+		std::vector<int16_t> normals(static_cast<size_t>(n) * perNormal);
+		for (int i = 0; i < n; ++i) {
+			float u, v;
+			OctEncode({ mesh.normals[i * 3], mesh.normals[i * 3 + 1], mesh.normals[i * 3 + 2] }, u, v);
+			normals[i * perNormal] = Snorm16(u);
+			normals[i * perNormal + 1] = Snorm16(v);
+			if (!tangents) continue;
+			OctEncode({ mesh.tangents[i * 4], mesh.tangents[i * 4 + 1], mesh.tangents[i * 4 + 2] }, u, v);
+			normals[i * perNormal + 2] = Snorm16(u);
+			normals[i * perNormal + 3] = Snorm16(v);
+		}
+
+		Entry entry;
+		entry.vao = mesh.vaoId;
+		entry.floatBytes = n * static_cast<int>(sizeof(float)) * (3 + 3 + (tangents ? 4 : 0) + (mesh.texcoords ? 2 : 0));
+		entry.compactBytes = n * static_cast<int>(sizeof(uint16_t)) * (4 + perNormal + (mesh.texcoords ? 2 : 0));
+
+		rlEnableVertexArray(mesh.vaoId);
+		Replace(mesh, 0, positions.data(), n * 4 * static_cast<int>(sizeof(uint16_t)), C_POSITION, 4, GL_UNSIGNED_SHORT, true);
+		Replace(mesh, 2, normals.data(), n * perNormal * static_cast<int>(sizeof(int16_t)), C_NORMAL, perNormal, GL_SHORT, true);
+		if (mesh.texcoords != nullptr) {
+			std::vector<uint16_t> uvs(static_cast<size_t>(n) * 2);
+			for (int i = 0; i < n * 2; ++i) uvs[i] = Half(mesh.texcoords[i]);
+			Replace(mesh, 1, uvs.data(), n * 2 * static_cast<int>(sizeof(uint16_t)), C_TEXCOORD, 2, GL_HALF_FLOAT, false);
+		}
+		if (tangents) {
+			rlUnloadVertexBuffer(mesh.vboId[4]);
+			mesh.vboId[4] = 0;
+			rlDisableVertexAttribute(C_TANGENT);
+		}
+
+		const float decode[4] = { lo.x, lo.y, lo.z, size };
+		entry.decode = rlLoadVertexBuffer(decode, static_cast<int>(sizeof(decode)), false);
+		rlEnableVertexBuffer(entry.decode);
+		rlSetVertexAttribute(C_DECODE_LOCATION, 4, RL_FLOAT, false, 0, nullptr);
+		rlSetVertexAttributeDivisor(C_DECODE_LOCATION, C_CONSTANT_DIVISOR);
+		rlEnableVertexAttribute(C_DECODE_LOCATION);
+		rlDisableVertexArray();
+		rlDisableVertexBuffer();
+		entries.push_back(entry);
+	}
+
+	static void ExpandMesh(Mesh& mesh, const Entry& entry) {
+		const int n = mesh.vertexCount;
+		rlEnableVertexArray(mesh.vaoId);
+		Replace(mesh, 0, mesh.vertices, n * 3 * static_cast<int>(sizeof(float)), C_POSITION, 3, RL_FLOAT, false);
+		Replace(mesh, 2, mesh.normals, n * 3 * static_cast<int>(sizeof(float)), C_NORMAL, 3, RL_FLOAT, false);
+		if (mesh.texcoords != nullptr) Replace(mesh, 1, mesh.texcoords, n * 2 * static_cast<int>(sizeof(float)), C_TEXCOORD, 2, RL_FLOAT, false);
+		if (mesh.tangents != nullptr) Replace(mesh, 4, mesh.tangents, n * 4 * static_cast<int>(sizeof(float)), C_TANGENT, 4, RL_FLOAT, false);
+		rlDisableVertexAttribute(C_DECODE_LOCATION);
+		rlDisableVertexArray();
+		rlDisableVertexBuffer();
+		rlUnloadVertexBuffer(entry.decode);
+	}
+
+	std::vector<Entry> entries;  // per compacted mesh, by vertex array
+};
+
+#endif // VERTEX_COMPRESS_H
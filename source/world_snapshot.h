@@ -0,0 +1,207 @@
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "raylib.h"
+
+// --- WORLD SNAPSHOT ---
+// A whole simulation state in one flat file (World::Save / World::Load), so a benchmark or
+// a bug repro starts at the late-game moment it is about instead of minutes of play before
+// it. Every piece of state is a section: a tag naming its owner (AsteroidField, Fleet, ...),
+// a column index within it, and an array of trivially copyable elements. Writing copies
+// each column out as it is in memory; Reader maps the file (MapFileData) and loading is a
+// memcpy per column, so even a saturated world restores in a few milliseconds.
+//
+// File format: Header, `count` Section records, then each section's bytes, C_ALIGN-aligned.
+// A section's element size is checked on load, so a file from a build whose component
+// layouts differ is refused rather than misread; C_VERSION covers everything else.
+namespace WorldSnapshot {
+	// Four characters as a section tag, "ASTR" say.
+	constexpr uint32_t Tag(const char (&name)[5]) {
+		return static_cast<uint32_t>(static_cast<unsigned char>(name[0])) | static_cast<uint32_t>(static_cast<unsigned char>(name[1])) << 8
+			| static_cast<uint32_t>(static_cast<unsigned char>(name[2])) << 16 | static_cast<uint32_t>(static_cast<unsigned char>(name[3])) << 24;
+	}
+
+	namespace Detail {
+		constexpr uint32_t C_VERSION = 1;
+		constexpr size_t   C_ALIGN = 64;
+		inline constexpr char C_MAGIC[8] = { 'P', 'O', 'I', 'G', 'W', 'L', 'D', '1' };
+
+		struct Header {
+			char     magic[8];
+			uint32_t version;
+			uint32_t count;
+		};
+
+		struct Section {
+			uint32_t tag;
+			uint32_t column;
+			uint32_t elementSize;
+			uint32_t reserved;
+			uint64_t count;   // elements
+			uint64_t offset;  // from the start of the file
+		};
+	}
+
+	// Collects sections, then writes them in one go. Only pointers are kept: everything added
+	// must stay put until Save.
+	class Writer {
+	public:
+		template<typename T>
+		void Add(uint32_t tag, uint32_t column, const T* data, size_t count) {
+			static_assert(std::is_trivially_copyable_v<T>, "snapshot sections are copied as raw bytes");
+			pending.push_back({ { tag, column, static_cast<uint32_t>(sizeof(T)), 0, count, 0 }, data });
+		}
+
+		template<typename T>
+		void Add(uint32_t tag, uint32_t column, const std::vector<T>& values) {
+			Add(tag, column, values.data(), values.size());
+		}
+
+		template<typename T>
+		void AddValue(uint32_t tag, uint32_t column, const T& value) {
+			Add(tag, column, &value, 1);
+		}
+
+		// Returns the bytes written, or 0 when the file could not be.
+		size_t Save(const char* path) const {
+			Detail::Header header{};
+			memcpy(header.magic, Detail::C_MAGIC, sizeof(Detail::C_MAGIC));
+			header.version = Detail::C_VERSION;
+			header.count = static_cast<uint32_t>(pending.size());
+
+			std::vector<Detail::Section> sections;
+			sections.reserve(pending.size());
+			size_t end = sizeof(Detail::Header) + sizeof(Detail::Section) * pending.size();
+			for (const Pending& p : pending) {
+				Detail::Section s = p.section;
+				s.offset = Aligned(end);
+				end = static_cast<size_t>(s.offset + s.count * s.elementSize);
+				sections.push_back(s);
+			}
+
+			std::vector<unsigned char> bytes(end, 0);
+			memcpy(bytes.data(), &header, sizeof(header));
+			if (!sections.empty()) memcpy(bytes.data() + sizeof(header), sections.data(), sizeof(Detail::Section) * sections.size());
+			for (size_t i = 0; i < sections.size(); ++i) {
+				const size_t n = static_cast<size_t>(sections[i].count * sections[i].elementSize);
+				if (n) memcpy(bytes.data() + sections[i].offset, pending[i].data, n);
+			}
+			return SaveFileData(path, bytes.data(), static_cast<int>(bytes.size())) ? bytes.size() : 0;
+		}
+
+	private:
+		struct Pending {
+			Detail::Section section;
+			const void*     data;
+		};
+
+		static size_t Aligned(size_t at) {
+			return (at + Detail::C_ALIGN - 1) / Detail::C_ALIGN * Detail::C_ALIGN;
+		}
+
+		std::vector<Pending> pending;
+	};
+
+	// A mapped snapshot file. Valid() once the header and every section record check out;
+	// then Read copies sections out of the mapping.
+	class Reader {
+	public:
+		explicit Reader(const char* path) {
+			int bytes = 0;
+			data = MapFileData(path, &bytes);
+			size = data ? static_cast<size_t>(bytes) : 0;
+			valid = Check();
+		}
+
+		~Reader() {
+			UnmapFileData(data, static_cast<int>(size));
+		}
+
+		Reader(const Reader&) = delete;
+		Reader& operator=(const Reader&) = delete;
+
+		bool Valid() const {
+			return valid;
+		}
+
+		size_t Bytes() const {
+			return size;
+		}
+
+		// Replaces `out` with the section's elements. False when the file has no such section
+		// or its elements aren't Ts.
+		template<typename T>
+		bool Read(uint32_t tag, uint32_t column, std::vector<T>& out) const {
+			static_assert(std::is_trivially_copyable_v<T>, "snapshot sections are copied as raw bytes");
+			const Detail::Section* s = Find(tag, column, sizeof(T));
+			if (!s) return false;
+			out.resize(static_cast<size_t>(s->count));
+			if (s->count) memcpy(out.data(), data + s->offset, static_cast<size_t>(s->count) * sizeof(T));
+			return true;
+		}
+
+		// Copies the section into `out`, which has room for `capacity` elements, and returns
+		// the element count; -1 when it is missing, of another type or too long.
+		template<typename T>
+		int64_t Read(uint32_t tag, uint32_t column, T* out, size_t capacity) const {
+			static_assert(std::is_trivially_copyable_v<T>, "snapshot sections are copied as raw bytes");
+			const Detail::Section* s = Find(tag, column, sizeof(T));
+			if (!s || s->count > capacity) return -1;
+			if (s->count) memcpy(out, data + s->offset, static_cast<size_t>(s->count) * sizeof(T));
+			return static_cast<int64_t>(s->count);
+		}
+
+		// Elements in a section, or -1 when there is none with elements of `elementSize`.
+		int64_t Count(uint32_t tag, uint32_t column, size_t elementSize) const {
+			const Detail::Section* s = Find(tag, column, elementSize);
+			return s ? static_cast<int64_t>(s->count) : -1;
+		}
+
+		// A section holding exactly one T.
+		template<typename T>
+		bool ReadValue(uint32_t tag, uint32_t column, T& out) const {
+			return Count(tag, column, sizeof(T)) == 1 && Read(tag, column, &out, 1) == 1;
+		}
+
+	private:
+		const Detail::Section* Sections() const {
+			return reinterpret_cast<const Detail::Section*>(data + sizeof(Detail::Header));
+		}
+
+		uint32_t SectionCount() const {
+			return reinterpret_cast<const Detail::Header*>(data)->count;
+		}
+
+		bool Check() const {
+			if (!data || size < sizeof(Detail::Header)) return false;
+			const Detail::Header* h = reinterpret_cast<const Detail::Header*>(data);
+			if (memcmp(h->magic, Detail::C_MAGIC, sizeof(Detail::C_MAGIC)) != 0 || h->version != Detail::C_VERSION) return false;
+			if (h->count > (size - sizeof(Detail::Header)) / sizeof(Detail::Section)) return false;
+			for (uint32_t i = 0; i < h->count; ++i) {
+				const Detail::Section& s = Sections()[i];
+				if (s.elementSize == 0 || s.offset > size || s.count > (size - s.offset) / s.elementSize) return false;
+			}
+			return true;
+		}
+
+		const Detail::Section* Find(uint32_t tag, uint32_t column, size_t elementSize) const {
+			if (!valid) return nullptr;
+			for (uint32_t i = 0; i < SectionCount(); ++i) {
+				const Detail::Section& s = Sections()[i];
+				if (s.tag == tag && s.column == column) return s.elementSize == elementSize ? &s : nullptr;
+			}
+			return nullptr;
+		}
+
+		unsigned char* data = nullptr;
+		size_t         size = 0;
+		bool           valid = false;
+	};
+}
+
+#endif // WORLD_SNAPSHOT_H